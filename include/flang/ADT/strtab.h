@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2017, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef __SHARED_STRTAB_H__
+#define __SHARED_STRTAB_H__
+
+#include "flang/ADT/hash.h"
+#include <stddef.h>
+
+/** \file
+ * \brief Interned Strings.
+ *
+ * A string table keeps a single copy of each distinct string entered into
+ * it. The copy is NUL-terminated and is stored right after a header holding
+ * its length and hash value, so neither is computed again once the string
+ * has been interned. Interned strings stay where they are until the table is
+ * freed.
+ *
+ * Two strings interned in the same table are equal if and only if they are
+ * the same pointer, so interned strings can be compared with == and used as
+ * keys of a hashset_t or hashmap_t with hash_functions_interned, which takes
+ * the stored hash value instead of reading the characters.
+ *
+ * The strings are counted, so they may contain NUL characters.
+ */
+
+typedef struct strtab_ *strtab_t;
+
+/** \brief The header stored in front of every interned string. */
+typedef struct strtab_header_ {
+  hash_value_t hash;
+  unsigned len;
+} strtab_header_t;
+
+#define STRTAB_HEADER(s) ((const strtab_header_t *)(s)-1)
+
+/** \brief Length of an interned string. */
+#define STRTAB_LEN(s) (STRTAB_HEADER(s)->len)
+
+/** \brief Hash value of an interned string, as computed by strtab_hash(). */
+#define STRTAB_HASHVAL(s) (STRTAB_HEADER(s)->hash)
+
+/** \brief Hash value of the len characters at s.
+ *
+ * For a string without NUL characters, this is the same value as the hash
+ * function of hash_functions_strings.
+ */
+hash_value_t strtab_hash(const char *s, size_t len);
+
+/** \brief Allocate an empty string table.
+ *
+ * The returned handle should be passed to strtab_free() to deallocate the
+ * table and all of its strings.
+ */
+strtab_t strtab_alloc(void);
+
+/** \brief Free a string table and all the strings interned in it.
+ */
+void strtab_free(strtab_t);
+
+/** \brief Get the number of strings in the table.
+ */
+unsigned strtab_size(strtab_t);
+
+/** \brief Look up the len characters at s and return the interned copy, or
+ * NULL if they have not been interned.
+ */
+const char *strtab_lookup(strtab_t, const char *s, size_t len);
+
+/** \brief Return the interned copy of the len characters at s, entering
+ * them into the table first if needed.
+ */
+const char *strtab_intern(strtab_t, const char *s, size_t len);
+
+/** \brief Enter the len characters at s into the table and return the
+ * interned copy, or return NULL if they had been interned already.
+ */
+const char *strtab_insert(strtab_t, const char *s, size_t len);
+
+/** \brief Hash functions for keys that are interned strings.
+ *
+ * Keys are hashed by their stored hash value and compared by pointer, so
+ * all the keys of one hash table must be interned in the same string table.
+ */
+extern const hash_functions_t hash_functions_interned;
+
+#endif /* __SHARED_STRTAB_H__ */
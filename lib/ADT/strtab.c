@@ -0,0 +1,313 @@
+/*
+ * Copyright (c) 2017, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "flang/ADT/strtab.h"
+#include "flang/Error/pgerror.h"
+#include <stdlib.h>
+#include <string.h>
+
+#if UNIT_TESTING
+#include <stdarg.h>
+#include <setjmp.h>
+#include "cmockery.h"
+#endif /* UNIT_TESTING */
+
+/** \file
+ * \brief Interned string tables.
+ *
+ * The strings are copied into blocks which are never moved, each one behind
+ * its strtab_header_t. The index is an open addressing table of 2^n pointers
+ * to the strings, probed with the same quadratic sequence as the hash tables
+ * in hash.c. It is kept at most half full and grows by rehashing from the
+ * stored hash values, so the characters of a string are only hashed when it
+ * is looked up.
+ */
+
+/* Strings are allocated in units of a header so that every header is
+   aligned. */
+#define UNITS(len) \
+  (1 + ((len) + sizeof(strtab_header_t)) / sizeof(strtab_header_t))
+
+#define BLOCK_UNITS 4096
+#define MINSIZE 64
+
+typedef struct strtab_block_ {
+  struct strtab_block_ *next;
+  strtab_header_t data[1];
+} strtab_block_t;
+
+struct strtab_ {
+  const char **table;     /* index of interned strings, NULL when empty */
+  unsigned mask;          /* size of table minus 1 */
+  unsigned entries;       /* number of strings */
+  strtab_block_t *blocks; /* storage, most recent block first */
+  strtab_header_t *avail; /* next free unit in blocks */
+  size_t left;            /* free units at avail */
+};
+
+hash_value_t
+strtab_hash(const char *s, size_t len)
+{
+  const unsigned char *p = (const unsigned char *)s;
+  hash_accu_t hacc = HASH_ACCU_INIT;
+  size_t i;
+
+  for (i = 0; i < len; i++)
+    HASH_ACCU_ADD(hacc, p[i]);
+  HASH_ACCU_FINISH(hacc);
+  return HASH_ACCU_VALUE(hacc);
+}
+
+strtab_t
+strtab_alloc(void)
+{
+  strtab_t t = calloc(1, sizeof(struct strtab_));
+  t->mask = MINSIZE - 1;
+  t->table = calloc(MINSIZE, sizeof(const char *));
+  return t;
+}
+
+void
+strtab_free(strtab_t t)
+{
+  strtab_block_t *b, *next;
+
+  for (b = t->blocks; b; b = next) {
+    next = b->next;
+    free(b);
+  }
+  free(t->table);
+  memset(t, 0, sizeof(*t));
+  free(t);
+}
+
+unsigned
+strtab_size(strtab_t t)
+{
+  return t->entries;
+}
+
+/** \brief Search for s, return the index that terminated the search. */
+static unsigned
+search(strtab_t t, const char *s, size_t len, hash_value_t hash)
+{
+  unsigned p, step = 1;
+  const char *e;
+
+  p = hash & t->mask;
+  while ((e = t->table[p]) != NULL) {
+    if (STRTAB_HASHVAL(e) == hash && STRTAB_LEN(e) == len &&
+        memcmp(e, s, len) == 0)
+      break;
+    p = (p + step++) & t->mask;
+  }
+  return p;
+}
+
+/** \brief Double the size of the index. */
+static void
+grow(strtab_t t)
+{
+  const char **old_table = t->table;
+  unsigned n, old_size = t->mask + 1;
+
+  assert(old_size * 2 != 0, "String table full", t->entries, 4);
+  t->mask = 2 * old_size - 1;
+  t->table = calloc(2 * (size_t)old_size, sizeof(const char *));
+  for (n = 0; n < old_size; n++) {
+    const char *e = old_table[n];
+    if (e) {
+      unsigned p = STRTAB_HASHVAL(e) & t->mask, step = 1;
+      while (t->table[p])
+        p = (p + step++) & t->mask;
+      t->table[p] = e;
+    }
+  }
+  free(old_table);
+}
+
+/** \brief Copy s into the blocks and enter it at index p. */
+static const char *
+add(strtab_t t, unsigned p, const char *s, size_t len, hash_value_t hash)
+{
+  size_t units = UNITS(len);
+  strtab_header_t *h;
+  char *copy;
+
+  assert(len == (unsigned)len, "String too long for string table", 0, 4);
+  if (units > t->left) {
+    size_t n = units > BLOCK_UNITS ? units : BLOCK_UNITS;
+    strtab_block_t *b = malloc(offsetof(strtab_block_t, data) +
+                               n * sizeof(strtab_header_t));
+    b->next = t->blocks;
+    t->blocks = b;
+    t->avail = b->data;
+    t->left = n;
+  }
+  h = t->avail;
+  t->avail += units;
+  t->left -= units;
+
+  h->hash = hash;
+  h->len = len;
+  copy = (char *)(h + 1);
+  memcpy(copy, s, len);
+  copy[len] = '\0';
+
+  t->table[p] = copy;
+  t->entries++;
+  return copy;
+}
+
+const char *
+strtab_lookup(strtab_t t, const char *s, size_t len)
+{
+  return t->table[search(t, s, len, strtab_hash(s, len))];
+}
+
+/* Make room for one more string, keeping the index at most half full. */
+#define MAKE_ROOM(t)                        \
+  do {                                      \
+    if (2 * ((t)->entries + 1) > (t)->mask) \
+      grow(t);                              \
+  } while (0)
+
+const char *
+strtab_intern(strtab_t t, const char *s, size_t len)
+{
+  hash_value_t hash = strtab_hash(s, len);
+  unsigned p;
+
+  MAKE_ROOM(t);
+  p = search(t, s, len, hash);
+  if (t->table[p])
+    return t->table[p];
+  return add(t, p, s, len, hash);
+}
+
+const char *
+strtab_insert(strtab_t t, const char *s, size_t len)
+{
+  hash_value_t hash = strtab_hash(s, len);
+  unsigned p;
+
+  MAKE_ROOM(t);
+  p = search(t, s, len, hash);
+  if (t->table[p])
+    return NULL;
+  return add(t, p, s, len, hash);
+}
+
+static hash_value_t
+interned_hash(hash_key_t key)
+{
+  return STRTAB_HASHVAL((const char *)key);
+}
+
+const hash_functions_t hash_functions_interned = {interned_hash, NULL};
+
+/* Everything below is only for testing the implementation. */
+#if UNIT_TESTING
+
+#include <stdio.h>
+
+static void
+hash_funcs(void **state)
+{
+  assert_int_equal(strtab_hash("", 0), 0);
+  assert_int_equal(strtab_hash("a", 1), 0xca2e9442);
+  assert_int_equal(strtab_hash("foo", 3), 0x238678dd);
+  assert_int_equal(strtab_hash("foobar", 3), 0x238678dd);
+}
+
+static void
+basic_strtab(void **state)
+{
+  unsigned i;
+  char buf[20];
+  strtab_t t = strtab_alloc();
+  const char *foo, *x0;
+
+  assert_int_equal(strtab_size(t), 0);
+  assert_int_equal(strtab_lookup(t, "foo", 3), NULL);
+
+  foo = strtab_intern(t, "foo", 3);
+  assert_string_equal(foo, "foo");
+  assert_int_equal(STRTAB_LEN(foo), 3);
+  assert_int_equal(STRTAB_HASHVAL(foo), 0x238678dd);
+  assert_int_equal(strtab_intern(t, "foo", 3), foo);
+  assert_int_equal(strtab_lookup(t, "foox", 3), foo);
+  assert_int_equal(strtab_lookup(t, "foo", 4), NULL);
+  assert_int_equal(strtab_insert(t, "foo", 3), NULL);
+  assert_int_equal(strtab_size(t), 1);
+
+  /* Embedded NULs are part of the string. */
+  assert_int_not_equal(strtab_intern(t, "foo\0", 4), foo);
+  assert_int_equal(strtab_size(t), 2);
+
+  /* Force the index to grow several times. */
+  x0 = strtab_intern(t, "x0", 2);
+  for (i = 1; i < 10000; i++) {
+    sprintf(buf, "x%u", i);
+    assert_int_not_equal(strtab_insert(t, buf, strlen(buf)), NULL);
+  }
+  assert_int_equal(strtab_size(t), 10002);
+  assert_int_equal(strtab_lookup(t, "x0", 2), x0);
+  assert_int_equal(strtab_lookup(t, "foo", 3), foo);
+  assert_int_equal(strtab_lookup(t, "x10000", 6), NULL);
+
+  /* A string larger than a block. */
+  {
+    size_t n = BLOCK_UNITS * sizeof(strtab_header_t) * 3;
+    char *big = malloc(n);
+    memset(big, 'y', n);
+    assert_int_equal(STRTAB_LEN(strtab_intern(t, big, n)), n);
+    assert_int_equal(strtab_lookup(t, "foo", 3), foo);
+    free(big);
+  }
+
+  strtab_free(t);
+}
+
+static void
+interned_keys(void **state)
+{
+  strtab_t t = strtab_alloc();
+  hashmap_t h = hashmap_alloc(hash_functions_interned);
+  const char *a = strtab_intern(t, "a", 1), *b = strtab_intern(t, "b", 1);
+  hash_data_t datum;
+
+  hashmap_insert(h, a, (hash_data_t)1);
+  hashmap_insert(h, b, (hash_data_t)2);
+  assert_int_equal(hashmap_lookup(h, strtab_lookup(t, "b", 1), &datum), b);
+  assert_int_equal(datum, 2);
+
+  hashmap_free(h);
+  strtab_free(t);
+}
+
+int
+main()
+{
+  const UnitTest tests[] = {
+      unit_test(hash_funcs), unit_test(basic_strtab),
+      unit_test(interned_keys),
+  };
+  return run_tests(tests);
+}
+
+#endif /* UNIT_TESTING */
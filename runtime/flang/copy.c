@@ -1040,6 +1040,103 @@ sked *ENTFTN(COMM_COPY, comm_copy)(void *rb, void *sb, F90_Desc *rs,
   return I8(__fort_comm_sked)(ch, rp, sp, F90_KIND_G(ss), F90_LEN_G(ss));
 }
 
+/* Cache-oblivious transpose kernels for 4- and 8-byte elements:
+   r(i,j) = s(j,i) for an m x n result, given the element strides of
+   both dimensions of r and s.  The longer side is halved until a block
+   fits in TRANSPOSE_TILE x TRANSPOSE_TILE, so at every level of the
+   memory hierarchy some block size reads and writes whole cache lines
+   on both sides. */
+
+#define TRANSPOSE_TILE 16
+
+#define TRANSPOSE_KERNEL(NAME, T)                                              \
+  static void NAME(T *r, T *s, __INT_T m, __INT_T n, __INT_T rs0,              \
+                   __INT_T rs1, __INT_T ss0, __INT_T ss1)                      \
+  {                                                                            \
+    __INT_T i, j;                                                              \
+    while (m > TRANSPOSE_TILE || n > TRANSPOSE_TILE) {                         \
+      if (m >= n) {                                                            \
+        NAME(r, s, m / 2, n, rs0, rs1, ss0, ss1);                              \
+        r += (m / 2) * rs0;                                                    \
+        s += (m / 2) * ss1;                                                    \
+        m -= m / 2;                                                            \
+      } else {                                                                 \
+        NAME(r, s, m, n / 2, rs0, rs1, ss0, ss1);                              \
+        r += (n / 2) * rs1;                                                    \
+        s += (n / 2) * ss0;                                                    \
+        n -= n / 2;                                                            \
+      }                                                                        \
+    }                                                                          \
+    for (j = 0; j < n; ++j) {                                                  \
+      for (i = 0; i < m; ++i)                                                  \
+        r[i * rs0 + j * rs1] = s[j * ss0 + i * ss1];                           \
+    }                                                                          \
+  }
+
+TRANSPOSE_KERNEL(transpose_4, __INT4_T)
+TRANSPOSE_KERNEL(transpose_8, __INT8_T)
+
+/* locate the first element of rank 2 section d, its element strides and
+   the lowest and highest byte addresses it touches */
+
+static char *I8(transpose_layout)(char *b, F90_Desc *d, __INT_T *str,
+                                  char **lo, char **hi)
+{
+  DECL_DIM_PTRS(dd);
+  __INT_T idxv[2];
+  char *p;
+  int dx;
+
+  for (dx = 0; dx < 2; ++dx) {
+    SET_DIM_PTRS(dd, d, dx);
+    idxv[dx] = F90_DPTR_LBOUND_G(dd);
+    str[dx] = F90_DPTR_SSTRIDE_G(dd) * F90_DPTR_LSTRIDE_G(dd);
+  }
+  p = I8(__fort_local_address)(b, d, idxv);
+  if (p == NULL)
+    return NULL;
+  *lo = *hi = p;
+  for (dx = 0; dx < 2; ++dx) {
+    if (str[dx] < 0)
+      *lo += (F90_DIM_EXTENT_G(d, dx) - 1) * str[dx] * F90_LEN_G(d);
+    else
+      *hi += (F90_DIM_EXTENT_G(d, dx) - 1) * str[dx] * F90_LEN_G(d);
+  }
+  *hi += F90_LEN_G(d);
+  return p;
+}
+
+/* transpose 4- and 8-byte element matrices directly.  Returns 0 if the
+   general copy must be used. */
+
+static int I8(transpose_fast)(char *rp, char *sp, F90_Desc *rs, F90_Desc *ss)
+{
+  __INT_T rstr[2], sstr[2];
+  char *rlo, *rhi, *slo, *shi;
+  int len;
+
+  len = F90_LEN_G(rs);
+  if (F90_RANK_G(rs) != 2 || F90_RANK_G(ss) != 2 || F90_LEN_G(ss) != len ||
+      (len != 4 && len != 8) || F90_GSIZE_G(rs) <= 0 ||
+      F90_DIM_EXTENT_G(rs, 0) != F90_DIM_EXTENT_G(ss, 1) ||
+      F90_DIM_EXTENT_G(rs, 1) != F90_DIM_EXTENT_G(ss, 0))
+    return 0;
+
+  rp = I8(transpose_layout)(rp, rs, rstr, &rlo, &rhi);
+  sp = I8(transpose_layout)(sp, ss, sstr, &slo, &shi);
+  if (rp == NULL || sp == NULL || (rlo < shi && slo < rhi) ||
+      (((unsigned long)rp | (unsigned long)sp) & (len - 1)) != 0)
+    return 0;
+
+  if (len == 4)
+    transpose_4((__INT4_T *)rp, (__INT4_T *)sp, F90_DIM_EXTENT_G(rs, 0),
+                F90_DIM_EXTENT_G(rs, 1), rstr[0], rstr[1], sstr[0], sstr[1]);
+  else
+    transpose_8((__INT8_T *)rp, (__INT8_T *)sp, F90_DIM_EXTENT_G(rs, 0),
+                F90_DIM_EXTENT_G(rs, 1), rstr[0], rstr[1], sstr[0], sstr[1]);
+  return 1;
+}
+
 void ENTFTN(TRANSPOSE, transpose)(void *rb, void *sb, F90_Desc *rs,
                                   F90_Desc *ss)
 {
@@ -1061,6 +1158,8 @@ void ENTFTN(TRANSPOSE, transpose)(void *rb, void *sb, F90_Desc *rs,
 
   rp = (char *)rb + DIST_SCOFF_G(rs) * F90_LEN_G(rs);
   sp = (char *)sb + DIST_SCOFF_G(ss) * F90_LEN_G(ss);
+  if (I8(transpose_fast)(rp, sp, rs, ss))
+    return;
   ch = I8(__fort_copy)(rp, sp, rs, ss, src_axis_map);
   __fort_doit(ch);
   __fort_frechn(ch);
@@ -22,6 +22,89 @@
 
 #include "fort_vars.h"
 
+/* Block shift kernels.  When the array and the result are both
+   contiguous they are viewed as hi slabs, each holding extent vectors of
+   lo elements along the shift dimension (lo being the number of
+   elements below it).  A circular shift by k along the dimension then
+   moves runs of k*lo elements, so each slab is rotated with two block
+   copies.  These return 0 if the array or result is not contiguous and
+   the general section copies must be used. */
+
+static int I8(contig_pair)(char **rp, char **ap, F90_Desc *rs, F90_Desc *as)
+{
+  __INT_T rstr, astr;
+
+  if (F90_LEN_G(rs) != F90_LEN_G(as) || F90_GSIZE_G(rs) != F90_GSIZE_G(as))
+    return 0;
+  *rp = I8(__fort_uniform_section)(*rp + DIST_SCOFF_G(rs) * F90_LEN_G(rs), rs,
+                                   &rstr);
+  *ap = I8(__fort_uniform_section)(*ap + DIST_SCOFF_G(as) * F90_LEN_G(as), as,
+                                   &astr);
+  return *rp != NULL && *ap != NULL && rstr == 1 && astr == 1;
+}
+
+static int I8(cshifts_fast)(char *rb, char *ab, __INT_T sabs, __INT_T dim,
+                            F90_Desc *rs, F90_Desc *as)
+{
+  char *rp, *ap;
+  __INT_T extent, h, hi, lo;
+  size_t m, n;
+
+  rp = rb;
+  ap = ab;
+  if (!I8(contig_pair)(&rp, &ap, rs, as))
+    return 0;
+
+  extent = F90_DIM_EXTENT_G(as, dim - 1);
+  I8(__fort_split_shape)(as, dim, &lo, &hi);
+  m = (size_t)sabs * lo * F90_LEN_G(as);            /* bytes rotated out */
+  n = (size_t)(extent - sabs) * lo * F90_LEN_G(as); /* bytes moved down */
+  for (h = 0; h < hi; ++h) {
+    __fort_bcopy(rp, ap + m, n);
+    __fort_bcopy(rp + n, ap, m);
+    rp += m + n;
+    ap += m + n;
+  }
+  return 1;
+}
+
+/* with an array of shifts, each vector along the shift dimension is
+   rotated separately; its elements are lo apart. */
+
+static int I8(cshift_fast)(char *rb, char *ab, __INT_T *sb, __INT_T dim,
+                           F90_Desc *rs, F90_Desc *as, F90_Desc *ss)
+{
+  char *rp, *ap, *r, *a;
+  __INT_T *sp;
+  __INT_T extent, h, hi, i, lo, sabs, sstr;
+  int len;
+
+  rp = rb;
+  ap = ab;
+  if (F90_LEN_G(ss) != sizeof(__INT_T) || !I8(contig_pair)(&rp, &ap, rs, as))
+    return 0;
+
+  extent = F90_DIM_EXTENT_G(as, dim - 1);
+  I8(__fort_split_shape)(as, dim, &lo, &hi);
+  sp = I8(__fort_uniform_section)(sb + DIST_SCOFF_G(ss), ss, &sstr);
+  if (sp == NULL || extent <= 0 || F90_GSIZE_G(ss) != lo * hi)
+    return 0;
+
+  len = F90_LEN_G(as);
+  for (h = 0; h < hi; ++h) {
+    for (i = 0; i < lo; ++i) {
+      sabs = sp[(h * lo + i) * sstr] % extent;
+      if (sabs < 0)
+        sabs += extent;
+      r = rp + (h * extent * lo + i) * len;
+      a = ap + (h * extent * lo + i) * len;
+      __fort_bcopysl(r, a + sabs * lo * len, extent - sabs, lo, lo, len);
+      __fort_bcopysl(r + (extent - sabs) * lo * len, a, sabs, lo, lo, len);
+    }
+  }
+  return 1;
+}
+
 /* result = cshift(array, shift=scalar, dim) */
 
 void ENTFTN(CSHIFTS, cshifts)(void *rb,     /* result base */
@@ -70,6 +153,9 @@ void ENTFTN(CSHIFTS, cshifts)(void *rb,     /* result base */
   if (sabs < 0)
     sabs += extent;
 
+  if (I8(cshifts_fast)(rb, ab, sabs, dim, rs, as))
+    return;
+
   /* copy straight across if net shift amount is zero */
 
   if (sabs == 0) {
@@ -429,6 +515,9 @@ void ENTFTN(CSHIFT, cshift)(void *rb,     /* result base */
   }
 #endif
 
+  if (I8(cshift_fast)(rb, ab, sb, dim, rs, as, ss))
+    return;
+
   /* initialize rank 1 section descriptors */
 
   __DIST_INIT_SECTION(rc, 1, rs);
@@ -651,6 +651,66 @@ void *I8(__fort_local_address)(void *base, F90_Desc *d, __INT_T *idxv)
   return (char *)base + offset * F90_LEN_G(d);
 }
 
+/* Given section d, determine whether its elements, taken in array
+   element order, are evenly spaced in local memory.  If so, return the
+   local address of the first element and store the positive element
+   stride in *stride (1 means contiguous).  Otherwise return NULL.  The
+   base address is assumed to be adjusted for scalar subscripts. */
+
+void *I8(__fort_uniform_section)(void *base, F90_Desc *d, __INT_T *stride)
+{
+  DECL_DIM_PTRS(dd);
+  __INT_T dx, extent, n, s, str;
+  __INT_T idxv[MAXDIMS];
+
+  if (d == NULL || F90_TAG_G(d) != __DESC || F90_GSIZE_G(d) <= 0 ||
+      (F90_FLAGS_G(d) & __OFF_TEMPLATE))
+    return NULL;
+
+  str = 0;
+  n = 1;
+  for (dx = 0; dx < F90_RANK_G(d); ++dx) {
+    SET_DIM_PTRS(dd, d, dx);
+    idxv[dx] = F90_DPTR_LBOUND_G(dd);
+    extent = F90_DPTR_EXTENT_G(dd);
+    if (extent == 1)
+      continue;
+    s = F90_DPTR_SSTRIDE_G(dd) * F90_DPTR_LSTRIDE_G(dd);
+    if (str == 0)
+      str = s;
+    else if (s != str * n)
+      return NULL;
+    n *= extent;
+  }
+  if (str == 0)
+    str = 1; /* single element */
+  else if (str < 0)
+    return NULL;
+
+  *stride = str;
+  return I8(__fort_local_address)(base, d, idxv);
+}
+
+/* Split the shape of section d around dimension dim (1-based): *lo is
+   the number of elements in the dimensions below dim and *hi the number
+   in the dimensions above it. */
+
+void I8(__fort_split_shape)(F90_Desc *d, __INT_T dim, __INT_T *lo,
+                            __INT_T *hi)
+{
+  __INT_T dx, l, h;
+
+  l = h = 1;
+  for (dx = 0; dx < F90_RANK_G(d); ++dx) {
+    if (dx < dim - 1)
+      l *= F90_DIM_EXTENT_G(d, dx);
+    else if (dx > dim - 1)
+      h *= F90_DIM_EXTENT_G(d, dx);
+  }
+  *lo = l;
+  *hi = h;
+}
+
 /* Localize a global index in dimension dim of array a.  This is only
    necessary for dimensions with cyclic or block-cyclic distributions.
    It is assumed that the index is local */
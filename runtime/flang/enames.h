@@ -31,6 +31,7 @@
 #define Ftn_str_malloc f90_str_malloc
 #define Ftn_str_free f90_str_free
 #define Ftn_str_copy f90_str_copy
+#define Ftn_str_concat f90_str_concat
 #define Ftn_str_cpy1 f90_str_cpy1
 #define Ftn_str_index f90_str_index
 #define Ftn_strcmp f90_strcmp
@@ -39,6 +40,7 @@
 #define Ftn_nstrcmp f90_nstrcmp
 #define Ftn_str_malloc_klen f90_str_malloc_klen
 #define Ftn_str_copy_klen f90_str_copy_klen 
+#define Ftn_str_concat_klen f90_str_concat_klen
 #define Ftn_str_cpy1_klen f90_str_cpy1_klen
 #define Ftn_str_index_klen f90_str_index_klen
 #define Ftn_strcmp_klen f90_strcmp_klen
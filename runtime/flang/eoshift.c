@@ -22,6 +22,66 @@
 
 #include "fort_vars.h"
 
+/* fill n elements of length len at rp with copies of the element at bp,
+   doubling the filled run with each block copy */
+
+static void
+fill_run(char *rp, char *bp, size_t n, int len)
+{
+  size_t done, k;
+
+  if (n == 0)
+    return;
+  memcpy(rp, bp, len);
+  for (done = 1; done < n; done += k) {
+    k = Min(done, n - done);
+    memcpy(rp + done * len, rp, k * len);
+  }
+}
+
+/* Block kernel for a scalar shift and boundary.  When the array and the
+   result are both contiguous they are viewed as hi slabs, each holding
+   extent vectors of lo elements along the shift dimension (lo being the
+   number of elements below it).  An end-off shift by k along the
+   dimension is then one block copy and one boundary fill per slab.
+   Returns 0 if the general section code must be used. */
+
+static int I8(eoshift_fast)(char *rb, char *ab, __INT_T shift, char *bb,
+                            __INT_T dim, F90_Desc *rs, F90_Desc *as)
+{
+  char *rp, *ap;
+  __INT_T extent, h, hi, k, lo, rstr, astr;
+  size_t m, n;
+  int len;
+
+  len = F90_LEN_G(as);
+  if (F90_KIND_G(rs) == __STR || F90_LEN_G(rs) != len ||
+      F90_GSIZE_G(rs) != F90_GSIZE_G(as))
+    return 0;
+  rp = I8(__fort_uniform_section)(rb + DIST_SCOFF_G(rs) * len, rs, &rstr);
+  ap = I8(__fort_uniform_section)(ab + DIST_SCOFF_G(as) * len, as, &astr);
+  if (rp == NULL || ap == NULL || rstr != 1 || astr != 1)
+    return 0;
+
+  extent = F90_DIM_EXTENT_G(as, dim - 1);
+  I8(__fort_split_shape)(as, dim, &lo, &hi);
+  k = Min(Abs(shift), extent);
+  m = (size_t)k * lo;            /* elements filled */
+  n = (size_t)(extent - k) * lo; /* elements copied */
+  for (h = 0; h < hi; ++h) {
+    if (shift >= 0) {
+      __fort_bcopy(rp, ap + m * len, n * len);
+      fill_run(rp + n * len, bb, m, len);
+    } else {
+      fill_run(rp, bb, m, len);
+      __fort_bcopy(rp + m * len, ap, n * len);
+    }
+    rp += (m + n) * len;
+    ap += (m + n) * len;
+  }
+  return 1;
+}
+
 static void I8(eoshift_scalar)(char *rb,          /* result base */
                                char *ab,          /* array base */
                                __INT_T shift_amt, /* shift amount */
@@ -373,6 +433,9 @@ void ENTFTN(EOSHIFTSZ, eoshiftsz)(char *rb,     /* result base */
   }
 #endif
 
+  if (I8(eoshift_fast)(rb, ab, shift, bb, dim, rs, as))
+    return;
+
   /* initialize section descriptors */
 
   __DIST_INIT_SECTION(ac, F90_RANK_G(as), as);
@@ -440,6 +503,9 @@ void ENTFTN(EOSHIFTSS, eoshiftss)(char *rb,     /* result base */
   }
 #endif
 
+  if (I8(eoshift_fast)(rb, ab, shift, bb, dim, rs, as))
+    return;
+
   /* initialize section descriptors */
 
   __DIST_INIT_SECTION(ac, F90_RANK_G(as), as);
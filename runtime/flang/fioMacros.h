@@ -1338,6 +1338,11 @@ I8(__fort_local_offset)(F90_Desc *d, __INT_T *gidx);
 
 void *I8(__fort_local_address)(void *base, F90_Desc *d, __INT_T *gidx);
 
+void *I8(__fort_uniform_section)(void *base, F90_Desc *d, __INT_T *stride);
+
+void I8(__fort_split_shape)(F90_Desc *d, __INT_T dim, __INT_T *lo,
+                            __INT_T *hi);
+
 void I8(__fort_cycle_bounds)(F90_Desc *d);
 
 __INT_T
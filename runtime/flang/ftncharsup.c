@@ -104,8 +104,10 @@ Ftn_str_copy(int n, char *to, int to_len, ...)
     qq->dyn = 0;
     to_end += from_len;
     from_end = from + (from_len - 1);
-    if ((from >= to && from <= to_end) ||
-        (from_end >= to && from_end <= to_end))
+    /* a source already in its final place need not be saved */
+    if (from != to + idx2 &&
+        ((from >= to && from <= to_end) ||
+         (from_end >= to && from_end <= to_end)))
       if (from_len) {
         qq->str = _mp_malloc(from_len);
         memcpy(qq->str, from, from_len);
@@ -125,23 +127,19 @@ Ftn_str_copy(int n, char *to, int to_len, ...)
   qq = src_p;
   to_p = to;
   to_end = to + to_len; /* position after the end of the destination */
-  for (cnt = n; cnt > 0; cnt--, qq++) {
+  for (cnt = n; cnt > 0 && to_p < to_end; cnt--, qq++) {
     from = qq->str;
-    for (from_len = qq->len; from_len > 0; from_len--, from++) {
-      *to_p++ = *from;
-      if (to_p == to_end)
-        goto exit_return;
-#ifdef DEBUG
-      printf("from_char = %c\n", *from);
-#endif
-    }
+    from_len = qq->len;
+    if (from_len > to_end - to_p)
+      from_len = to_end - to_p;
+    if (from != to_p && from_len > 0)
+      memcpy(to_p, from, (size_t)from_len);
+    to_p += from_len;
   }
 
-exit_return:
-  while (to_p < to_end) { /* remember, to_end is 1 after end */
-    /* blank fill to right */
-    *to_p++ = ' ';
-  }
+  /* blank fill to right */
+  if (to_p < to_end)
+    memset(to_p, ' ', (size_t)(to_end - to_p));
 
   if (any_allocd) {
     idx2 = 0;
@@ -189,6 +187,251 @@ Ftn_str_cpy1(char *to, int to_len, char *from, int from_len)
   return;
 }
 
+/** \brief
+ * Concatenates a series of character strings directly into another,
+ * truncating or blank padding as Ftn_str_copy does.  The compiler
+ * calls this instead of Ftn_str_copy when none of the sources can
+ * overlap the destination, so the sources are never saved first.
+ */
+void
+Ftn_str_concat(int n, char *to, int to_len, ...)
+{
+  va_list ap;
+  char *from;
+  int from_len;
+
+  if (to_len <= 0)
+    return;
+  va_start(ap, to_len);
+  for (; n > 0; n--) {
+    from = va_arg(ap, char *);
+    from_len = va_arg(ap, int);
+    if (from_len <= 0)
+      continue;
+    if (from_len >= to_len) {
+      memcpy(to, from, (size_t)to_len);
+      va_end(ap);
+      return;
+    }
+    memcpy(to, from, (size_t)from_len);
+    to += from_len;
+    to_len -= from_len;
+  }
+  va_end(ap);
+  memset(to, ' ', (size_t)to_len);
+}
+
+/* ***********************************************************************/
+/** \brief
+ * Word-at-a-time scanning for runs of blanks.
+ *
+ * Blank-padded comparison and ADJUSTL/ADJUSTR spend most of their time
+ * skipping padding.  The scan loads eight characters at a time and
+ * compares them with a word of blanks; only the word holding the first
+ * nonblank character is examined bytewise.
+ */
+/* ***********************************************************************/
+
+#define BLANK_WORD 0x2020202020202020ULL
+
+/** \brief Returns the number of leading blanks in s[0 .. n-1]. */
+size_t
+__fort_blank_span(const char *s, size_t n)
+{
+  unsigned long long w;
+  size_t i;
+
+  for (i = 0; i + sizeof(w) <= n; i += sizeof(w)) {
+    memcpy(&w, s + i, sizeof(w));
+    if (w != BLANK_WORD)
+      break;
+  }
+  while (i < n && s[i] == ' ')
+    ++i;
+  return i;
+}
+
+/** \brief Returns the number of trailing blanks in s[0 .. n-1]. */
+size_t
+__fort_blank_rspan(const char *s, size_t n)
+{
+  unsigned long long w;
+  size_t i;
+
+  for (i = n; i >= sizeof(w); i -= sizeof(w)) {
+    memcpy(&w, s + i - sizeof(w), sizeof(w));
+    if (w != BLANK_WORD)
+      break;
+  }
+  while (i > 0 && s[i - 1] == ' ')
+    --i;
+  return n - i;
+}
+
+/** \brief
+ * Blank-padded comparison shared by Ftn_strcmp and Ftn_strcmp_klen.
+ *
+ * The common prefix is compared with memcmp.  The tail of the longer
+ * string is then compared against blanks; as before, its first nonblank
+ * character is compared with blank as a (signed) char.
+ */
+static int
+str_cmp(const char *a1, size_t a1_len, const char *a2, size_t a2_len)
+{
+  int ret_val;
+  size_t n;
+
+  ret_val = memcmp(a1, a2, a1_len < a2_len ? a1_len : a2_len);
+  if (ret_val != 0)
+    return ret_val < 0 ? -1 : 1;
+  if (a1_len > a2_len) {
+    n = __fort_blank_span(a1 + a2_len, a1_len - a2_len);
+    if (n == a1_len - a2_len)
+      return 0;
+    return a1[a2_len + n] > ' ' ? 1 : -1;
+  }
+  if (a2_len > a1_len) {
+    n = __fort_blank_span(a2 + a1_len, a2_len - a1_len);
+    if (n == a2_len - a1_len)
+      return 0;
+    return a2[a1_len + n] > ' ' ? -1 : 1;
+  }
+  return 0;
+}
+
+/* patterns at least this long are searched for with the Two-Way
+   algorithm */
+#define TWOWAY_MIN 16
+
+/** \brief
+ * Maximal suffix of x[0 .. m-1] for the byte order (rev == 0) or its
+ * reverse (rev != 0).  Returns the start of the suffix and sets *per to
+ * its period.  s is the best suffix so far, c a later suffix being
+ * compared with it, k the number of bytes of c that matched.
+ */
+static size_t
+twoway_maxsuf(const unsigned char *x, size_t m, int rev, size_t *per)
+{
+  size_t s = 0, c = 1, k = 0, p = 1;
+
+  while (c + k < m) {
+    unsigned char a = x[s + k], b = x[c + k];
+    if (a == b) {
+      if (++k == p) {
+        c += p;
+        k = 0;
+      }
+    } else if ((b > a) != (rev != 0)) {
+      /* c is greater; it becomes the best suffix */
+      s = c++;
+      k = 0;
+      p = 1;
+    } else {
+      /* c is smaller; all of x[s .. c+k] is one period */
+      c += k + 1;
+      k = 0;
+      p = c - s;
+    }
+  }
+  *per = p;
+  return s;
+}
+
+/** \brief
+ * Two-Way string matching (Crochemore and Perrin, JACM 38(3), 1991),
+ * linear in the length of the searched string for any pattern.
+ * h[0 .. hl-1] is searched for n[0 .. nl-1], hl >= nl > 0; returns the
+ * match or NULL.
+ *
+ * The pattern is split at a critical factorization n = u v, u =
+ * n[0 .. s-1].  Each window is compared v first, left to right, then u
+ * right to left.  A mismatch in v shifts the window past it; a match
+ * shifts it by the period p, and if the whole pattern has period p the
+ * first nl - p bytes are then known to match (mem).  A window whose last
+ * byte does not occur in the pattern is skipped whole.
+ */
+static const unsigned char *
+twoway_index(const unsigned char *h, size_t hl, const unsigned char *n,
+             size_t nl)
+{
+  size_t s, s2, p, p2, i, j, mem, mem0;
+  unsigned char inpat[256];
+
+  memset(inpat, 0, sizeof(inpat));
+  for (i = 0; i < nl; i++)
+    inpat[n[i]] = 1;
+
+  /* the later of the two maximal suffixes gives the factorization */
+  s = twoway_maxsuf(n, nl, 0, &p);
+  s2 = twoway_maxsuf(n, nl, 1, &p2);
+  if (s2 > s) {
+    s = s2;
+    p = p2;
+  }
+  if (memcmp(n, n + p, s) == 0) {
+    mem0 = nl - p;
+  } else {
+    /* u is not a suffix of v's period; no window memory, and any shift
+       up to the longer half is safe */
+    mem0 = 0;
+    p = (s > nl - s ? s : nl - s) + 1;
+  }
+
+  mem = 0;
+  for (j = 0; j <= hl - nl;) {
+    if (!inpat[h[j + nl - 1]]) {
+      j += nl;
+      mem = 0;
+      continue;
+    }
+    for (i = s > mem ? s : mem; i < nl && n[i] == h[j + i]; i++)
+      ;
+    if (i < nl) {
+      j += i - s + 1;
+      mem = 0;
+      continue;
+    }
+    for (i = s; i > mem && n[i - 1] == h[j + i - 1]; i--)
+      ;
+    if (i <= mem)
+      return h + j;
+    j += p;
+    mem = mem0;
+  }
+  return NULL;
+}
+
+/** \brief
+ * Substring search shared by Ftn_str_index and Ftn_str_index_klen;
+ * returns the 1-based position of a2 in a1 or 0.  Short patterns are
+ * located by a memchr scan for their first character and confirmed with
+ * memcmp; long ones use twoway_index.
+ */
+static size_t
+str_index(const char *a1, size_t a1_len, const char *a2, size_t a2_len)
+{
+  const char *p, *end;
+
+  if (a2_len == 0)
+    return a1_len > 0;
+  if (a2_len > a1_len)
+    return 0;
+  if (a2_len >= TWOWAY_MIN) {
+    p = (const char *)twoway_index((const unsigned char *)a1, a1_len,
+                                   (const unsigned char *)a2, a2_len);
+    return p ? p - a1 + 1 : 0;
+  }
+  end = a1 + (a1_len - a2_len) + 1;
+  for (p = a1; p < end; ++p) {
+    p = memchr(p, a2[0], end - p);
+    if (p == NULL)
+      break;
+    if (memcmp(p + 1, a2 + 1, a2_len - 1) == 0)
+      return p - a1 + 1;
+  }
+  return 0;
+}
+
 /* ***********************************************************************/
 /** \brief
  * Implements the INDEX intrinsic; is an integer function which returns the
@@ -201,25 +444,11 @@ char *a2;                           /* pointer to string being searched for */
 int a1_len;                         /* length of a1 */
 int a2_len;                         /* length of a2 */
 {
-  int idx1, idx2, match;
   if (a1_len < 0)
     a1_len = 0;
   if (a2_len < 0)
     a2_len = 0;
-  for (idx1 = 0; idx1 < a1_len; idx1++) {
-    if (a2_len > (a1_len - idx1))
-      return (0);
-    match = TRUE;
-    for (idx2 = 0; idx2 < a2_len; idx2++) {
-      if (a1[idx1 + idx2] != a2[idx2]) {
-        match = FALSE;
-        break;
-      }
-    }
-    if (match)
-      return (idx1 + 1);
-  }
-  return (0);
+  return (int)str_index(a1, a1_len, a2, a2_len);
 }
 
 /* ***********************************************************************/
@@ -239,72 +468,155 @@ char *a2;                        /* second string to be compared */
 int a1_len;                      /* length of a1 */
 int a2_len;                      /* length of a2 */
 {
-  int ret_val, idx1;
   if (a1_len < 0)
     a1_len = 0;
   if (a2_len < 0)
     a2_len = 0;
-  if (a1_len == a2_len) {
-    while (a1_len > 0) {
-      if (*a1 != *a2) {
-        if ((unsigned)(*a1) > (unsigned)(*a2))
-          return 1;
-        return -1;
-      }
-      ++a1;
-      ++a2;
-      a1_len--;
+  return str_cmp(a1, a1_len, a2, a2_len);
+}
+
+/* ***********************************************************************/
+/** \brief
+ * Per-thread arena for character temporaries.
+ *
+ * The temporaries flang2 allocates with Ftn_str_malloc live until the
+ * allocating subprogram returns, so on any one thread they are released
+ * in the reverse order of allocation.  They are therefore carved from a
+ * chunked bump arena, and Ftn_str_free simply pops the arena back to the
+ * oldest block on the list it is given.  Requests larger than
+ * STR_ARENA_MAX still come from the heap.
+ *
+ * Each block records the arena it came from (NULL for heap blocks).  A
+ * list freed on a thread other than the one that allocated it leaves the
+ * foreign blocks alone; they are reclaimed when their own thread pops
+ * below them.
+ */
+/* ***********************************************************************/
+
+#if defined(_WIN32)
+#define STR_TLS __declspec(thread)
+#else
+#define STR_TLS __thread
+#endif
+
+#define PTRSZ sizeof(char *)
+#define STR_HDR (2 * PTRSZ) /* 'next' and arena pointers */
+#define STR_CHUNK_SIZE (64 * 1024)
+#define STR_ARENA_MAX (STR_CHUNK_SIZE / 4)
+
+typedef struct str_chunk {
+  struct str_chunk *prev; /* chunk allocated before this one */
+  char *end;              /* first byte past this chunk */
+} STR_CHUNK;
+
+typedef struct {
+  STR_CHUNK *cur;   /* chunk being allocated from */
+  char *top;        /* next free byte in cur */
+  STR_CHUNK *spare; /* emptied chunk kept for reuse */
+  long live;        /* blocks not yet freed, by this thread or another */
+} STR_ARENA;
+
+/* A thread's arena is allocated on first use and never freed, so that
+   another thread freeing one of its blocks can always update it. */
+static STR_TLS STR_ARENA *str_arena;
+
+static char *
+str_arena_alloc(STR_ARENA *a, size_t nbytes)
+{
+  STR_CHUNK *c;
+  char *p;
+
+  if (a->cur == NULL || nbytes > (size_t)(a->cur->end - a->top)) {
+    c = a->spare;
+    if (c != NULL) {
+      a->spare = NULL;
+    } else {
+      c = (STR_CHUNK *)_mp_malloc(STR_CHUNK_SIZE);
+      if (c == NULL)
+        return NULL;
+      c->end = (char *)c + STR_CHUNK_SIZE;
     }
-    return 0;
+    c->prev = a->cur;
+    a->cur = c;
+    a->top = (char *)(c + 1);
   }
-  if (a1_len > a2_len) {
-    /* first compare the first a2_len characters of the strings */
-    ret_val = memcmp(a1, a2, a2_len);
-    if (ret_val != 0) {
-      if (ret_val < 0)
-        return (-1);
-      if (ret_val > 0)
-        return (1);
-    }
-    /*
-     * if the last (a1_len - a2_len) characters of a1 are blank, then the
-     * strings are equal; otherwise, compare the first non-blank char. to
-     * blank
-     */
-
-    for (idx1 = 0; idx1 < (a1_len - a2_len); idx1++) {
-      if (a1[a2_len + idx1] != ' ') {
-        if (a1[a2_len + idx1] > ' ')
-          return (1);
-        return (-1);
-      }
-    }
-    return (0);
-  } else {
-    /* a2_len > a1_len */
-    /* first compare the first a1_len characters of the strings */
-    ret_val = memcmp(a1, a2, a1_len);
-    if (ret_val != 0) {
-      if (ret_val < 0)
-        return (-1);
-      if (ret_val > 0)
-        return (1);
-    }
-    /*
-     * if the last (a2_len - a1_len) characters of a2 are blank, then the
-     * strings are equal; otherwise, compare the first non-blank char. to
-     * blank
-     */
-
-    for (idx1 = 0; idx1 < (a2_len - a1_len); idx1++) {
-      if (a2[a1_len + idx1] != ' ') {
-        if (a2[a1_len + idx1] > ' ')
-          return (-1);
-        return (1);
-      }
-    }
-    return (0);
+  p = a->top;
+  a->top += nbytes;
+  return p;
+}
+
+/** \brief Pop arena a back to p, a block allocated from a, or empty it
+ * if p is NULL. */
+static void
+str_arena_release(STR_ARENA *a, char *p)
+{
+  STR_CHUNK *c;
+
+  while ((c = a->cur) != NULL && (p <= (char *)c || p >= c->end)) {
+    a->cur = c->prev;
+    if (a->spare == NULL)
+      a->spare = c;
+    else
+      _mp_free(c);
+  }
+  a->top = p;
+}
+
+/** \brief The calling thread's arena, or NULL if it cannot be allocated.
+ *
+ * A block freed by another thread leaves a hole that the owner cannot
+ * pop past until it frees an older block; if it never does, the arena
+ * only grows.  Such blocks are counted off live instead, and the arena
+ * is emptied once none of its blocks are live.
+ */
+static STR_ARENA *
+str_arena_get(void)
+{
+  STR_ARENA *a;
+
+  a = str_arena;
+  if (a == NULL) {
+    a = (STR_ARENA *)_mp_malloc(sizeof(STR_ARENA));
+    if (a == NULL)
+      return NULL;
+    memset(a, 0, sizeof(STR_ARENA));
+    str_arena = a;
   }
+  if (a->cur != NULL && __atomic_load_n(&a->live, __ATOMIC_ACQUIRE) == 0)
+    str_arena_release(a, NULL);
+  return a;
+}
+
+/** \brief
+ * Allocate a block of size bytes of character data and link it onto the
+ * list at *hdr; returns the data address or NULL.
+ */
+static char *
+str_block_alloc(size_t size, char ***hdr)
+{
+  STR_ARENA *a;
+  char **p;
+  size_t nbytes;
+
+  /* round request to the size of a pointer & add the block header */
+  nbytes = ((size + PTRSZ - 1) / PTRSZ) * PTRSZ + STR_HDR;
+  a = NULL;
+  p = NULL;
+  if (nbytes <= STR_ARENA_MAX && (a = str_arena_get()) != NULL) {
+    p = (char **)str_arena_alloc(a, nbytes);
+    if (p != NULL)
+      __atomic_add_fetch(&a->live, 1, __ATOMIC_RELAXED);
+  }
+  if (p == NULL) {
+    a = NULL;
+    p = (char **)_mp_malloc(nbytes);
+    if (p == NULL)
+      return NULL;
+  }
+  p[0] = (char *)*hdr; /* link this block to the blocks already allocated */
+  p[1] = (char *)a;
+  *hdr = p; /* update the list pointer */
+  return (char *)(p + 2);
 }
 
 /* ***********************************************************************/
@@ -316,12 +628,13 @@ int a2_len;                      /* length of a2 */
  * the subprogram.  When the subprogram exits, all of the blocks are freed.
  * Each block of space consists of n 'words':
  * - ++  first word        - pointer to the next allocated block,
+ * - ++  second word       - arena the block came from, or NULL,
  * - ++  remaining word(s) - space for the character data.
  *
  * \param     size - number of bytes needed,
  * \param     hdr  - pointer to the compiler-created variable locating the
  *            list of allocated blocks. Ftn_str_malloc updates this  variable.
- * \returns  returns a pointer to the space after the 'next pointer'.
+ * \returns  returns a pointer to the space after the block header.
  *
  * Note that KANJI versions are unneeded since the compiler just calls
  * Ftn_str_malloc() with an adjusted length.
@@ -330,16 +643,9 @@ int a2_len;                      /* length of a2 */
 char **
 Ftn_str_malloc(int size, char ***hdr)
 {
-  int nbytes;
-  char **p, **q;
+  char *p;
 
-/*
- * round request to the size of a pointer & also accommodate a 'next'
- * pointer
- */
-#define PTRSZ sizeof(char *)
-  nbytes = ((size + PTRSZ - 1) / PTRSZ) * PTRSZ + PTRSZ;
-  p = (char **)_mp_malloc(nbytes);
+  p = str_block_alloc(size > 0 ? (size_t)size : 0, hdr);
   if (p == NULL) {
     MP_P_STDIO;
     fprintf(__io_stderr(),
@@ -347,10 +653,7 @@ Ftn_str_malloc(int size, char ***hdr)
     MP_V_STDIO;
     Ftn_exit(1);
   }
-  q = *hdr;
-  *p = (char *)q; /* link this block to the blocks already allocated */
-  *hdr = p;       /* update the list pointer */
-  return p + 1;
+  return (char **)p;
 }
 
 /* ***********************************************************************/
@@ -363,6 +666,7 @@ Ftn_str_malloc(int size, char ***hdr)
  * the subprogram.  When the subprogram exits, all of the blocks are freed.
  * Each block of space consists of n 'words':
  * - ++  first word        - pointer to the next allocated block,
+ * - ++  second word       - arena the block came from, or NULL,
  * - ++  remaining word(s) - space for the character data.
  *
  *  \param first - pointer to the compiler-created variable locating the list of
@@ -373,12 +677,31 @@ Ftn_str_malloc(int size, char ***hdr)
 void
 Ftn_str_free(char **first)
 {
+  STR_ARENA *a, *b;
   char **p, **next;
-  /* traverse the list */
-  for (p = first; p != NULL;) {
-    next = (char **)(*p);
-    _mp_free(p);
-    p = next;
+  char *low;
+  long nlow;
+
+  /* traverse the list, newest block first */
+  a = str_arena;
+  low = NULL;
+  nlow = 0;
+  for (p = first; p != NULL; p = next) {
+    next = (char **)p[0];
+    b = (STR_ARENA *)p[1];
+    if (b == NULL) {
+      _mp_free(p);
+    } else if (b == a) {
+      low = (char *)p;
+      ++nlow;
+    } else {
+      /* another thread's block; it reclaims it when its arena empties */
+      __atomic_sub_fetch(&b->live, 1, __ATOMIC_RELEASE);
+    }
+  }
+  if (low != NULL) {
+    str_arena_release(a, low);
+    __atomic_sub_fetch(&a->live, nlow, __ATOMIC_RELAXED);
   }
 }
 
@@ -460,8 +783,10 @@ Ftn_str_copy_klen(int n, char *to, _LONGLONG_T to_len, ...)
     qq->dyn = 0;
     to_end += from_len;
     from_end = from + (from_len - 1);
-    if ((from >= to && from <= to_end) ||
-        (from_end >= to && from_end <= to_end))
+    /* a source already in its final place need not be saved */
+    if (from != to + idx2 &&
+        ((from >= to && from <= to_end) ||
+         (from_end >= to && from_end <= to_end)))
       if (from_len) {
         qq->str = _mp_malloc((size_t)from_len);
         memcpy(qq->str, from, (size_t)from_len);
@@ -481,23 +806,19 @@ Ftn_str_copy_klen(int n, char *to, _LONGLONG_T to_len, ...)
   qq = src_p;
   to_p = to;
   to_end = to + to_len; /* position after the end of the destination */
-  for (cnt = n; cnt > 0; cnt--, qq++) {
+  for (cnt = n; cnt > 0 && to_p < to_end; cnt--, qq++) {
     from = qq->str;
-    for (from_len = qq->len; from_len > 0; from_len--, from++) {
-      *to_p++ = *from;
-      if (to_p == to_end)
-        goto exit_return;
-#ifdef DEBUG
-      printf("from_char = %c\n", *from);
-#endif
-    }
+    from_len = qq->len;
+    if (from_len > to_end - to_p)
+      from_len = to_end - to_p;
+    if (from != to_p && from_len > 0)
+      memcpy(to_p, from, (size_t)from_len);
+    to_p += from_len;
   }
 
-exit_return:
-  while (to_p < to_end) { /* remember, to_end is 1 after end */
-    /* blank fill to right */
-    *to_p++ = ' ';
-  }
+  /* blank fill to right */
+  if (to_p < to_end)
+    memset(to_p, ' ', (size_t)(to_end - to_p));
 
   if (any_allocd) {
     idx2 = 0;
@@ -545,6 +866,40 @@ Ftn_str_cpy1_klen(char *to, _LONGLONG_T to_len, char *from, _LONGLONG_T from_len
   return;
 }
 
+/** \brief
+ * Concatenates a series of character strings directly into another,
+ * truncating or blank padding as Ftn_str_copy_klen does.  The compiler
+ * calls this instead of Ftn_str_copy_klen when none of the sources can
+ * overlap the destination, so the sources are never saved first.
+ */
+void
+Ftn_str_concat_klen(int n, char *to, _LONGLONG_T to_len, ...)
+{
+  va_list ap;
+  char *from;
+  _LONGLONG_T from_len;
+
+  if (to_len <= 0)
+    return;
+  va_start(ap, to_len);
+  for (; n > 0; n--) {
+    from = va_arg(ap, char *);
+    from_len = va_arg(ap, _LONGLONG_T);
+    if (from_len <= 0)
+      continue;
+    if (from_len >= to_len) {
+      memcpy(to, from, (size_t)to_len);
+      va_end(ap);
+      return;
+    }
+    memcpy(to, from, (size_t)from_len);
+    to += from_len;
+    to_len -= from_len;
+  }
+  va_end(ap);
+  memset(to, ' ', (size_t)to_len);
+}
+
 /* ***********************************************************************/
 /** \brief
  * Implements the INDEX intrinsic; is an integer function which returns the
@@ -557,26 +912,11 @@ char *a2;                           /* pointer to string being searched for */
 _LONGLONG_T a1_len;                         /* length of a1 */
 _LONGLONG_T a2_len;                         /* length of a2 */
 {
-  _LONGLONG_T idx1, idx2;
-  int match;
   if (a1_len < 0)
     a1_len = 0;
   if (a2_len < 0)
     a2_len = 0;
-  for (idx1 = 0; idx1 < a1_len; idx1++) {
-    if (a2_len > (a1_len - idx1))
-      return (0);
-    match = TRUE;
-    for (idx2 = 0; idx2 < a2_len; idx2++) {
-      if (a1[idx1 + idx2] != a2[idx2]) {
-        match = FALSE;
-        break;
-      }
-    }
-    if (match)
-      return (idx1 + 1);
-  }
-  return (0);
+  return (_LONGLONG_T)str_index(a1, (size_t)a1_len, a2, (size_t)a2_len);
 }
 
 /* ***********************************************************************/
@@ -596,74 +936,11 @@ char *a2;                        /* second string to be compared */
 _LONGLONG_T a1_len;                      /* length of a1 */
 _LONGLONG_T a2_len;                      /* length of a2 */
 {
-  _LONGLONG_T idx1;
-  int ret_val;
-  
   if (a1_len < 0)
     a1_len = 0;
   if (a2_len < 0)
     a2_len = 0;
-  if (a1_len == a2_len) {
-    while (a1_len > 0) {
-      if (*a1 != *a2) {
-        if ((unsigned)(*a1) > (unsigned)(*a2))
-          return 1;
-        return -1;
-      }
-      ++a1;
-      ++a2;
-      a1_len--;
-    }
-    return 0;
-  }
-  if (a1_len > a2_len) {
-    /* first compare the first a2_len characters of the strings */
-    ret_val = memcmp(a1, a2, (size_t)a2_len);
-    if (ret_val != 0) {
-      if (ret_val < 0)
-        return (-1);
-      if (ret_val > 0)
-        return (1);
-    }
-    /*
-     * if the last (a1_len - a2_len) characters of a1 are blank, then the
-     * strings are equal; otherwise, compare the first non-blank char. to
-     * blank
-     */
-
-    for (idx1 = 0; idx1 < (a1_len - a2_len); idx1++) {
-      if (a1[a2_len + idx1] != ' ') {
-        if (a1[a2_len + idx1] > ' ')
-          return (1);
-        return (-1);
-      }
-    }
-    return (0);
-  } else {
-    /* a2_len > a1_len */
-    /* first compare the first a1_len characters of the strings */
-    ret_val = memcmp(a1, a2, (size_t)a1_len);
-    if (ret_val != 0) {
-      if (ret_val < 0)
-        return (-1);
-      if (ret_val > 0)
-        return (1);
-    }
-    /*
-     * if the last (a2_len - a1_len) characters of a2 are blank, then the
-     * strings are equal; otherwise, compare the first non-blank char. to
-     * blank
-     */
-
-    for (idx1 = 0; idx1 < (a2_len - a1_len); idx1++) {
-      if (a2[a1_len + idx1] != ' ') {
-        if (a2[a1_len + idx1] > ' ')
-          return (-1);
-        return (1);
-      }
-    }
-    return (0);
-  }
+  return str_cmp(a1, (size_t)a1_len, a2, (size_t)a2_len);
 }
 
 /* ***********************************************************************/
@@ -676,13 +953,14 @@ _LONGLONG_T a2_len;                      /* length of a2 */
  * the subprogram.  When the subprogram exits, all of the blocks are freed.
  * Each block of space consists of n 'words':
  * - ++  first word        - pointer to the next allocated block,
+ * - ++  second word       - arena the block came from, or NULL,
  * - ++  remaining word(s) - space for the character data.
  *
  * \param     size - number of bytes needed,
  * \param     hdr  - pointer to the compiler-created variable locating the
  *             list of allocated blocks. Ftn_str_malloc updates this
  *             variable.
- * \return  returns a pointer to the space after the 'next pointer'.
+ * \return  returns a pointer to the space after the block header.
  *
  * void  Ftn_str_free(char ***hdr)
  *      hdr  - pointer to the compiler-created variable locating the list of
@@ -696,16 +974,9 @@ _LONGLONG_T a2_len;                      /* length of a2 */
 char **
 Ftn_str_malloc_klen(_LONGLONG_T size, char ***hdr)
 {
-  _LONGLONG_T nbytes;
-  char **p, **q;
+  char *p;
 
-/*
- * round request to the size of a pointer & also accommodate a 'next'
- * pointer
- */
-#define PTRSZ sizeof(char *)
-  nbytes = ((size + PTRSZ - 1) / PTRSZ) * PTRSZ + PTRSZ;
-  p = (char **)_mp_malloc((size_t)nbytes);
+  p = str_block_alloc(size > 0 ? (size_t)size : 0, hdr);
   if (p == NULL) {
     MP_P_STDIO;
     fprintf(__io_stderr(),
@@ -713,8 +984,5 @@ Ftn_str_malloc_klen(_LONGLONG_T size, char ***hdr)
     MP_V_STDIO;
     Ftn_exit(1);
   }
-  q = *hdr;
-  *p = (char *)q; /* link this block to the blocks already allocated */
-  *hdr = p;       /* update the list pointer */
-  return p + 1;
+  return (char **)p;
 }
@@ -17,119 +17,95 @@
 
 #include "stdioInterf.h"
 #include "fioMacros.h"
+#include "gathscat.h"
+
+#define GV(i) gv[i]
+#define GV_VEC gv
 
 /* local gather functions */
 
 static void
 local_gather_INT1(int n, __INT1_T *dst, __INT1_T *src, int *gv)
 {
-  int i;
-  for (i = 0; i < n; ++i)
-    dst[i] = src[gv[i]];
+  GATHSCAT_LOOP(__INT1_T, n, dst, GATHSCAT_IDENT, src, GV)
 }
 
 static void
 local_gather_INT2(int n, __INT2_T *dst, __INT2_T *src, int *gv)
 {
-  int i;
-  for (i = 0; i < n; ++i)
-    dst[i] = src[gv[i]];
+  GATHSCAT_LOOP(__INT2_T, n, dst, GATHSCAT_IDENT, src, GV)
 }
 
 static void
 local_gather_INT4(int n, __INT4_T *dst, __INT4_T *src, int *gv)
 {
-  int i;
-  for (i = 0; i < n; ++i)
-    dst[i] = src[gv[i]];
+  GATHSCAT_LOOP(__INT4_T, n, dst, GATHSCAT_IDENT, src, GV)
 }
 
 static void
 local_gather_INT8(int n, __INT8_T *dst, __INT8_T *src, int *gv)
 {
-  int i;
-  for (i = 0; i < n; ++i)
-    dst[i] = src[gv[i]];
+  GATHSCAT_LOOP(__INT8_T, n, dst, GATHSCAT_IDENT, src, GV)
 }
 
 static void
 local_gather_LOG1(int n, __LOG1_T *dst, __LOG1_T *src, int *gv)
 {
-  int i;
-  for (i = 0; i < n; ++i)
-    dst[i] = src[gv[i]];
+  GATHSCAT_LOOP(__LOG1_T, n, dst, GATHSCAT_IDENT, src, GV)
 }
 
 static void
 local_gather_LOG2(int n, __LOG2_T *dst, __LOG2_T *src, int *gv)
 {
-  int i;
-  for (i = 0; i < n; ++i)
-    dst[i] = src[gv[i]];
+  GATHSCAT_LOOP(__LOG2_T, n, dst, GATHSCAT_IDENT, src, GV)
 }
 
 static void
 local_gather_LOG4(int n, __LOG4_T *dst, __LOG4_T *src, int *gv)
 {
-  int i;
-  for (i = 0; i < n; ++i)
-    dst[i] = src[gv[i]];
+  GATHSCAT_LOOP(__LOG4_T, n, dst, GATHSCAT_IDENT, src, GV)
 }
 
 static void
 local_gather_LOG8(int n, __LOG8_T *dst, __LOG8_T *src, int *gv)
 {
-  int i;
-  for (i = 0; i < n; ++i)
-    dst[i] = src[gv[i]];
+  GATHSCAT_LOOP(__LOG8_T, n, dst, GATHSCAT_IDENT, src, GV)
 }
 
 static void
 local_gather_REAL4(int n, __REAL4_T *dst, __REAL4_T *src, int *gv)
 {
-  int i;
-  for (i = 0; i < n; ++i)
-    dst[i] = src[gv[i]];
+  GATHSCAT_LOOP(__REAL4_T, n, dst, GATHSCAT_IDENT, src, GV)
 }
 
 static void
 local_gather_REAL8(int n, __REAL8_T *dst, __REAL8_T *src, int *gv)
 {
-  int i;
-  for (i = 0; i < n; ++i)
-    dst[i] = src[gv[i]];
+  GATHSCAT_LOOP(__REAL8_T, n, dst, GATHSCAT_IDENT, src, GV)
 }
 
 static void
 local_gather_REAL16(int n, __REAL16_T *dst, __REAL16_T *src, int *gv)
 {
-  int i;
-  for (i = 0; i < n; ++i)
-    dst[i] = src[gv[i]];
+  GATHSCAT_LOOP(__REAL16_T, n, dst, GATHSCAT_IDENT, src, GV)
 }
 
 static void
 local_gather_CPLX8(int n, __CPLX8_T *dst, __CPLX8_T *src, int *gv)
 {
-  int i;
-  for (i = 0; i < n; ++i)
-    dst[i] = src[gv[i]];
+  GATHSCAT_LOOP(__CPLX8_T, n, dst, GATHSCAT_IDENT, src, GV)
 }
 
 static void
 local_gather_CPLX16(int n, __CPLX16_T *dst, __CPLX16_T *src, int *gv)
 {
-  int i;
-  for (i = 0; i < n; ++i)
-    dst[i] = src[gv[i]];
+  GATHSCAT_LOOP(__CPLX16_T, n, dst, GATHSCAT_IDENT, src, GV)
 }
 
 static void
 local_gather_CPLX32(int n, __CPLX32_T *dst, __CPLX32_T *src, int *gv)
 {
-  int i;
-  for (i = 0; i < n; ++i)
-    dst[i] = src[gv[i]];
+  GATHSCAT_LOOP(__CPLX32_T, n, dst, GATHSCAT_IDENT, src, GV)
 }
 
 void (*__fort_local_gather[__NTYPES])() = {
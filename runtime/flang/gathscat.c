@@ -17,10 +17,41 @@
 
 #include "stdioInterf.h"
 #include "fioMacros.h"
+#include "gathscat.h"
+
+#define SV(i) sv[i]
+#define SV_VEC sv
+#define GV(i) gv[i]
+#define GV_VEC gv
 
 extern void (*__fort_local_scatter[__NTYPES])();
 extern void (*__fort_local_gathscat[__NTYPES])();
 
+/* vector kernels for the loops in gathscat.h */
+
+gathscat_vfn __fort_gather_vfn[2];
+gathscat_vfn __fort_scatter_vfn[2];
+int __fort_gathscat_vready;
+
+/* Choose the kernels for this processor.  AVX2 only has gathers, so a
+   plain scatter keeps the scalar loop there. */
+
+void
+__fort_gathscat_vinit(void)
+{
+#if defined(__x86_64__) && defined(__GNUC__)
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f")) {
+    __fort_gather_vfn[0] = __fort_scatter_vfn[0] = __fort_gathscat4_avx512;
+    __fort_gather_vfn[1] = __fort_scatter_vfn[1] = __fort_gathscat8_avx512;
+  } else if (__builtin_cpu_supports("avx2")) {
+    __fort_gather_vfn[0] = __fort_gather4_avx2;
+    __fort_gather_vfn[1] = __fort_gather8_avx2;
+  }
+#endif
+  __atomic_store_n(&__fort_gathscat_vready, 1, __ATOMIC_RELEASE);
+}
+
 /* local scatter functions */
 
 void
@@ -33,113 +64,85 @@ local_scatter_WRAPPER(int n, void *dst, int *sv, void *src, __INT_T kind)
 static void
 local_scatter_INT1(int n, __INT1_T *dst, int *sv, __INT1_T *src)
 {
-  int i;
-  for (i = 0; i < n; ++i)
-    dst[sv[i]] = src[i];
+  GATHSCAT_LOOP(__INT1_T, n, dst, SV, src, GATHSCAT_IDENT)
 }
 
 static void
 local_scatter_INT2(int n, __INT2_T *dst, int *sv, __INT2_T *src)
 {
-  int i;
-  for (i = 0; i < n; ++i)
-    dst[sv[i]] = src[i];
+  GATHSCAT_LOOP(__INT2_T, n, dst, SV, src, GATHSCAT_IDENT)
 }
 
 static void
 local_scatter_INT4(int n, __INT4_T *dst, int *sv, __INT4_T *src)
 {
-  int i;
-  for (i = 0; i < n; ++i)
-    dst[sv[i]] = src[i];
+  GATHSCAT_LOOP(__INT4_T, n, dst, SV, src, GATHSCAT_IDENT)
 }
 
 static void
 local_scatter_INT8(int n, __INT8_T *dst, int *sv, __INT8_T *src)
 {
-  int i;
-  for (i = 0; i < n; ++i)
-    dst[sv[i]] = src[i];
+  GATHSCAT_LOOP(__INT8_T, n, dst, SV, src, GATHSCAT_IDENT)
 }
 
 static void
 local_scatter_LOG1(int n, __LOG1_T *dst, int *sv, __LOG1_T *src)
 {
-  int i;
-  for (i = 0; i < n; ++i)
-    dst[sv[i]] = src[i];
+  GATHSCAT_LOOP(__LOG1_T, n, dst, SV, src, GATHSCAT_IDENT)
 }
 
 static void
 local_scatter_LOG2(int n, __LOG2_T *dst, int *sv, __LOG2_T *src)
 {
-  int i;
-  for (i = 0; i < n; ++i)
-    dst[sv[i]] = src[i];
+  GATHSCAT_LOOP(__LOG2_T, n, dst, SV, src, GATHSCAT_IDENT)
 }
 
 static void
 local_scatter_LOG4(int n, __LOG4_T *dst, int *sv, __LOG4_T *src)
 {
-  int i;
-  for (i = 0; i < n; ++i)
-    dst[sv[i]] = src[i];
+  GATHSCAT_LOOP(__LOG4_T, n, dst, SV, src, GATHSCAT_IDENT)
 }
 
 static void
 local_scatter_LOG8(int n, __LOG8_T *dst, int *sv, __LOG8_T *src)
 {
-  int i;
-  for (i = 0; i < n; ++i)
-    dst[sv[i]] = src[i];
+  GATHSCAT_LOOP(__LOG8_T, n, dst, SV, src, GATHSCAT_IDENT)
 }
 
 static void
 local_scatter_REAL4(int n, __REAL4_T *dst, int *sv, __REAL4_T *src)
 {
-  int i;
-  for (i = 0; i < n; ++i)
-    dst[sv[i]] = src[i];
+  GATHSCAT_LOOP(__REAL4_T, n, dst, SV, src, GATHSCAT_IDENT)
 }
 
 static void
 local_scatter_REAL8(int n, __REAL8_T *dst, int *sv, __REAL8_T *src)
 {
-  int i;
-  for (i = 0; i < n; ++i)
-    dst[sv[i]] = src[i];
+  GATHSCAT_LOOP(__REAL8_T, n, dst, SV, src, GATHSCAT_IDENT)
 }
 
 static void
 local_scatter_REAL16(int n, __REAL16_T *dst, int *sv, __REAL16_T *src)
 {
-  int i;
-  for (i = 0; i < n; ++i)
-    dst[sv[i]] = src[i];
+  GATHSCAT_LOOP(__REAL16_T, n, dst, SV, src, GATHSCAT_IDENT)
 }
 
 static void
 local_scatter_CPLX8(int n, __CPLX8_T *dst, int *sv, __CPLX8_T *src)
 {
-  int i;
-  for (i = 0; i < n; ++i)
-    dst[sv[i]] = src[i];
+  GATHSCAT_LOOP(__CPLX8_T, n, dst, SV, src, GATHSCAT_IDENT)
 }
 
 static void
 local_scatter_CPLX16(int n, __CPLX16_T *dst, int *sv, __CPLX16_T *src)
 {
-  int i;
-  for (i = 0; i < n; ++i)
-    dst[sv[i]] = src[i];
+  GATHSCAT_LOOP(__CPLX16_T, n, dst, SV, src, GATHSCAT_IDENT)
 }
 
 static void
 local_scatter_CPLX32(int n, __CPLX32_T *dst, int *sv, __CPLX32_T *src)
 {
-  int i;
-  for (i = 0; i < n; ++i)
-    dst[sv[i]] = src[i];
+  GATHSCAT_LOOP(__CPLX32_T, n, dst, SV, src, GATHSCAT_IDENT)
 }
 
 void (*__fort_local_scatter[__NTYPES])() = {
@@ -192,113 +195,85 @@ local_gathscat_WRAPPER(int n, void *dst, int *sv, void *src, int *gv,
 static void
 local_gathscat_INT1(int n, __INT1_T *dst, int *sv, __INT1_T *src, int *gv)
 {
-  int i;
-  for (i = 0; i < n; ++i)
-    dst[sv[i]] = src[gv[i]];
+  GATHSCAT_LOOP(__INT1_T, n, dst, SV, src, GV)
 }
 
 static void
 local_gathscat_INT2(int n, __INT2_T *dst, int *sv, __INT2_T *src, int *gv)
 {
-  int i;
-  for (i = 0; i < n; ++i)
-    dst[sv[i]] = src[gv[i]];
+  GATHSCAT_LOOP(__INT2_T, n, dst, SV, src, GV)
 }
 
 static void
 local_gathscat_INT4(int n, __INT4_T *dst, int *sv, __INT4_T *src, int *gv)
 {
-  int i;
-  for (i = 0; i < n; ++i)
-    dst[sv[i]] = src[gv[i]];
+  GATHSCAT_LOOP(__INT4_T, n, dst, SV, src, GV)
 }
 
 static void
 local_gathscat_INT8(int n, __INT8_T *dst, int *sv, __INT8_T *src, int *gv)
 {
-  int i;
-  for (i = 0; i < n; ++i)
-    dst[sv[i]] = src[gv[i]];
+  GATHSCAT_LOOP(__INT8_T, n, dst, SV, src, GV)
 }
 
 static void
 local_gathscat_LOG1(int n, __LOG1_T *dst, int *sv, __LOG1_T *src, int *gv)
 {
-  int i;
-  for (i = 0; i < n; ++i)
-    dst[sv[i]] = src[gv[i]];
+  GATHSCAT_LOOP(__LOG1_T, n, dst, SV, src, GV)
 }
 
 static void
 local_gathscat_LOG2(int n, __LOG2_T *dst, int *sv, __LOG2_T *src, int *gv)
 {
-  int i;
-  for (i = 0; i < n; ++i)
-    dst[sv[i]] = src[gv[i]];
+  GATHSCAT_LOOP(__LOG2_T, n, dst, SV, src, GV)
 }
 
 static void
 local_gathscat_LOG4(int n, __LOG4_T *dst, int *sv, __LOG4_T *src, int *gv)
 {
-  int i;
-  for (i = 0; i < n; ++i)
-    dst[sv[i]] = src[gv[i]];
+  GATHSCAT_LOOP(__LOG4_T, n, dst, SV, src, GV)
 }
 
 static void
 local_gathscat_LOG8(int n, __LOG8_T *dst, int *sv, __LOG8_T *src, int *gv)
 {
-  int i;
-  for (i = 0; i < n; ++i)
-    dst[sv[i]] = src[gv[i]];
+  GATHSCAT_LOOP(__LOG8_T, n, dst, SV, src, GV)
 }
 
 static void
 local_gathscat_REAL4(int n, __REAL4_T *dst, int *sv, __REAL4_T *src, int *gv)
 {
-  int i;
-  for (i = 0; i < n; ++i)
-    dst[sv[i]] = src[gv[i]];
+  GATHSCAT_LOOP(__REAL4_T, n, dst, SV, src, GV)
 }
 
 static void
 local_gathscat_REAL8(int n, __REAL8_T *dst, int *sv, __REAL8_T *src, int *gv)
 {
-  int i;
-  for (i = 0; i < n; ++i)
-    dst[sv[i]] = src[gv[i]];
+  GATHSCAT_LOOP(__REAL8_T, n, dst, SV, src, GV)
 }
 
 static void
 local_gathscat_REAL16(int n, __REAL16_T *dst, int *sv, __REAL16_T *src, int *gv)
 {
-  int i;
-  for (i = 0; i < n; ++i)
-    dst[sv[i]] = src[gv[i]];
+  GATHSCAT_LOOP(__REAL16_T, n, dst, SV, src, GV)
 }
 
 static void
 local_gathscat_CPLX8(int n, __CPLX8_T *dst, int *sv, __CPLX8_T *src, int *gv)
 {
-  int i;
-  for (i = 0; i < n; ++i)
-    dst[sv[i]] = src[gv[i]];
+  GATHSCAT_LOOP(__CPLX8_T, n, dst, SV, src, GV)
 }
 
 static void
 local_gathscat_CPLX16(int n, __CPLX16_T *dst, int *sv, __CPLX16_T *src, int *gv)
 {
-  int i;
-  for (i = 0; i < n; ++i)
-    dst[sv[i]] = src[gv[i]];
+  GATHSCAT_LOOP(__CPLX16_T, n, dst, SV, src, GV)
 }
 
 static void
 local_gathscat_CPLX32(int n, __CPLX32_T *dst, int *sv, __CPLX32_T *src, int *gv)
 {
-  int i;
-  for (i = 0; i < n; ++i)
-    dst[sv[i]] = src[gv[i]];
+  GATHSCAT_LOOP(__CPLX32_T, n, dst, SV, src, GV)
 }
 
 void (*__fort_local_gathscat[__NTYPES])() = {
@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) 2017, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/* clang-format off */
+
+/* gathscat.h - element copy loops shared by the local gather, scatter
+   and gather-scatter functions */
+
+/* Offset vectors built by __fort_gathscat often contain runs of
+   consecutive offsets, e.g. the rows of a local section.  The loop moves
+   the elements GATHSCAT_BLOCK at a time.  After each block it compares
+   the offsets GATHSCAT_RUN - 1 apart, and only if both ends match checks
+   the offsets in between; a run found that way is extended as far as it
+   goes and moved with one block copy.  The test costs little for other
+   patterns and is done while the offsets are in cache.  Other blocks of
+   4- or 8-byte elements go to the vector kernel chosen for the
+   processor, if any; otherwise their elements are moved one at a time.
+   Either way the elements GATHSCAT_AHEAD iterations ahead are
+   prefetched, which hides much of the latency of scattered accesses. */
+
+#define GATHSCAT_BLOCK 32
+#define GATHSCAT_RUN (2 * GATHSCAT_BLOCK)
+#define GATHSCAT_AHEAD 16
+
+#if defined(__GNUC__)
+#define GATHSCAT_PREFETCH(p, rw) __builtin_prefetch((p), (rw))
+#else
+#define GATHSCAT_PREFETCH(p, rw)
+#endif
+
+/* Vector kernels: dst[dx[i]] = src[sx[i]] for i = 0 .. n-1, where a
+   null dx or sx stands for the identity.  The operands must not
+   overlap. */
+
+typedef void (*gathscat_vfn)(int n, void *dst, const int *dx, const void *src,
+                             const int *sx);
+
+void __fort_gather4_avx2(int n, void *dst, const int *dx, const void *src,
+                         const int *sx);
+void __fort_gather8_avx2(int n, void *dst, const int *dx, const void *src,
+                         const int *sx);
+void __fort_gathscat4_avx512(int n, void *dst, const int *dx, const void *src,
+                             const int *sx);
+void __fort_gathscat8_avx512(int n, void *dst, const int *dx,
+                             const void *src, const int *sx);
+
+/* the kernels for 4-byte ([0]) and 8-byte ([1]) elements, set by
+   __fort_gathscat_vinit on first use; __fort_gather_vfn needs a source
+   offset vector, __fort_scatter_vfn takes a contiguous source */
+
+extern gathscat_vfn __fort_gather_vfn[2];
+extern gathscat_vfn __fort_scatter_vfn[2];
+extern int __fort_gathscat_vready;
+void __fort_gathscat_vinit(void);
+
+/* the kernel for T elements from table tab, or none */
+
+#define GATHSCAT_VFN(T, tab)                                                   \
+  (sizeof(T) != 4 && sizeof(T) != 8                                            \
+       ? (gathscat_vfn)0                                                       \
+       : (__atomic_load_n(&__fort_gathscat_vready, __ATOMIC_ACQUIRE)           \
+              ? 0                                                              \
+              : (__fort_gathscat_vinit(), 0),                                  \
+          (tab)[sizeof(T) == 8]))
+
+/* Index mappings.  An operand's offsets are given by a function-like
+   macro DX mapping the loop index to an element offset and a macro
+   DX_VEC naming its offset vector, which the vector kernels take;
+   GATHSCAT_IDENT is the mapping of a contiguous operand. */
+
+#define GATHSCAT_NONE ((int *)0)
+
+#define GATHSCAT_IDENT(i) (i)
+#define GATHSCAT_IDENT_VEC GATHSCAT_NONE
+
+/* dst[DX(i)] = src[SX(i)] for i = 0 .. n-1 */
+
+#define GATHSCAT_LOOP(T, n, dst, DX, src, SX)                                  \
+  {                                                                            \
+    gathscat_vfn vf_ = SX##_VEC ? GATHSCAT_VFN(T, __fort_gather_vfn)           \
+                                : GATHSCAT_VFN(T, __fort_scatter_vfn);         \
+    int i_, j_, k_, e_;                                                        \
+    for (i_ = 0; i_ < (n); i_ = e_) {                                          \
+      /* a block, or what is left */                                           \
+      e_ = (n) - i_ > GATHSCAT_BLOCK ? i_ + GATHSCAT_BLOCK : (n);              \
+      k_ = (n) - GATHSCAT_AHEAD < e_ ? (n) - GATHSCAT_AHEAD : e_;              \
+      if (vf_ && e_ - i_ == GATHSCAT_BLOCK) {                                  \
+        for (j_ = i_; j_ < k_; ++j_) {                                         \
+          GATHSCAT_PREFETCH((src) + SX(j_ + GATHSCAT_AHEAD), 0);               \
+          GATHSCAT_PREFETCH((dst) + DX(j_ + GATHSCAT_AHEAD), 1);               \
+        }                                                                      \
+        vf_(GATHSCAT_BLOCK, DX##_VEC ? (void *)(dst) : (void *)((dst) + i_),   \
+            DX##_VEC ? DX##_VEC + i_ : GATHSCAT_NONE,                          \
+            SX##_VEC ? (void *)(src) : (void *)((src) + i_),                   \
+            SX##_VEC ? SX##_VEC + i_ : GATHSCAT_NONE);                         \
+      } else {                                                                 \
+        for (j_ = i_; j_ < k_; ++j_) {                                         \
+          GATHSCAT_PREFETCH((src) + SX(j_ + GATHSCAT_AHEAD), 0);               \
+          GATHSCAT_PREFETCH((dst) + DX(j_ + GATHSCAT_AHEAD), 1);               \
+          (dst)[DX(j_)] = (src)[SX(j_)];                                       \
+        }                                                                      \
+        for (; j_ < e_; ++j_)                                                  \
+          (dst)[DX(j_)] = (src)[SX(j_)];                                       \
+      }                                                                        \
+      /* a run from the end of the block */                                    \
+      if ((n) - e_ < GATHSCAT_RUN ||                                           \
+          DX(e_ + GATHSCAT_RUN - 1) != DX(e_) + GATHSCAT_RUN - 1 ||            \
+          SX(e_ + GATHSCAT_RUN - 1) != SX(e_) + GATHSCAT_RUN - 1)              \
+        continue;                                                              \
+      for (j_ = e_ + 1; j_ < (n); ++j_) {                                      \
+        if (DX(j_) != DX(j_ - 1) + 1 || SX(j_) != SX(j_ - 1) + 1)              \
+          break;                                                               \
+      }                                                                        \
+      if (j_ - e_ < GATHSCAT_RUN)                                              \
+        continue;                                                              \
+      for (k_ = j_; k_ < j_ + GATHSCAT_AHEAD && k_ < (n); ++k_) {              \
+        GATHSCAT_PREFETCH((src) + SX(k_), 0);                                  \
+        GATHSCAT_PREFETCH((dst) + DX(k_), 1);                                  \
+      }                                                                        \
+      __fort_bcopy((char *)((dst) + DX(e_)), (char *)((src) + SX(e_)),         \
+                   (size_t)(j_ - e_) * sizeof(T));                             \
+      e_ = j_;                                                                 \
+    }                                                                          \
+  }
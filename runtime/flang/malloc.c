@@ -21,6 +21,7 @@
 #include <memory.h>
 
 #include "fort_vars.h"
+#include "mpnuma.h"
 
 extern void *shmalloc(size_t);
 
@@ -38,6 +39,8 @@ __fort_malloc_without_abort(size_t n)
   if (n == 0)
     return ZIP;
   p = malloc(n);
+  /* NUMA placement of large arrays, see flangrti numa.c */
+  _mp_numa_newmem(p, n);
   if (__fort_zmem && (p != NULL))
     memset(p, '\0', n);
   return p;
@@ -90,6 +93,7 @@ __fort_calloc_without_abort(size_t n)
   if (n == 0)
     return ZIP;
   p = malloc(n);
+  _mp_numa_newmem(p, n);
   if (p != NULL)
     memset(p, '\0', n);
   return p;
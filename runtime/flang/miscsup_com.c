@@ -38,6 +38,8 @@ MP_SEMAPHORE(static, sem);
 
 extern double __fort_second();
 extern long __fort_getoptn(char *, long);
+extern size_t __fort_blank_span(const char *, size_t);
+extern size_t __fort_blank_rspan(const char *, size_t);
 
 #define time(x) __fort_time(x)
 
@@ -325,16 +327,17 @@ __INT_T
 ENTF90(ADJUSTL, adjustl)
 (DCHAR(res), DCHAR(expr) DCLEN(res) DCLEN(expr))
 {
-  int i, j, elen, rlen;
+  int n, elen, rlen;
 
   elen = CLEN(expr);
   rlen = CLEN(res);
-  for (i = 0; i < elen && CADR(expr)[i] == ' '; ++i)
-    ;
-  for (j = 0; i < elen; ++i, ++j)
-    CADR(res)[j] = CADR(expr)[i];
-  for (; j < rlen; ++j)
-    CADR(res)[j] = ' ';
+  n = 0;
+  if (elen > 0) {
+    n = elen - __fort_blank_span(CADR(expr), elen);
+    memmove(CADR(res), CADR(expr) + elen - n, n);
+  }
+  if (rlen > n)
+    memset(CADR(res) + n, ' ', rlen - n);
   return elen;
 }
 
@@ -342,15 +345,14 @@ __INT_T
 ENTF90(ADJUSTR, adjustr)
 (DCHAR(res), DCHAR(expr) DCLEN(res) DCLEN(expr))
 {
-  int i, j, len;
+  int i, len;
 
   len = CLEN(expr);
-  for (i = len - 1; i >= 0 && CADR(expr)[i] == ' '; --i)
-    ;
-  for (j = len - 1; i >= 0; --i, --j)
-    CADR(res)[j] = CADR(expr)[i];
-  for (; j >= 0; --j)
-    CADR(res)[j] = ' ';
+  if (len <= 0)
+    return len;
+  i = __fort_blank_rspan(CADR(expr), len);
+  memmove(CADR(res) + i, CADR(expr), len - i);
+  memset(CADR(res), ' ', i);
   return len;
 }
 
@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2017, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/* clang-format off */
+
+/*	numa3f.c - Implements LIB3F numa_nodes, numa_place and numa_touch
+ *	subprograms, for the NUMA placement of one array:
+ *
+ *	    n = numa_nodes()
+ *	    call numa_place(a, nbytes, policy)
+ *	    call numa_touch(a, nbytes)
+ *
+ *	nbytes is INTEGER*8; policy is 0 for the default, 1 for local and
+ *	2 for interleave (see flangrti numa.c).  numa_touch keeps the
+ *	contents of a, so it may be called after a is initialized.
+ */
+
+#include "ent3f.h"
+#include "mpnuma.h"
+
+int ENT3F(NUMA_NODES, numa_nodes)(void) { return _mp_numa_nodes(); }
+
+void ENT3F(NUMA_PLACE, numa_place)(void *a, long long *nbytes, int *policy)
+{
+  if (*nbytes > 0)
+    _mp_numa_place(a, (size_t)*nbytes, *policy);
+}
+
+void ENT3F(NUMA_TOUCH, numa_touch)(void *a, long long *nbytes)
+{
+  if (*nbytes > 0)
+    _mp_numa_touch(a, (size_t)*nbytes);
+}
@@ -37,6 +37,277 @@ static int I8(next_index)(__INT_T *index, F90_Desc *s)
   return 0; /* finished */
 }
 
+/* Fast paths.  When the array, mask, result, vector and field sections
+   are all evenly spaced in local memory, PACK and UNPACK are done by
+   typed kernels that step through the sections directly instead of
+   computing the address of every element from its index vector. */
+
+static __INT8_T
+mask_bits(dtype kind)
+{
+  switch (kind) {
+  case __LOG1:
+    return GET_DIST_MASK_LOG1;
+  case __LOG2:
+    return GET_DIST_MASK_LOG2;
+  case __LOG4:
+    return GET_DIST_MASK_LOG4;
+  case __LOG8:
+    return GET_DIST_MASK_LOG8;
+  case __INT1:
+    return GET_DIST_MASK_INT1;
+  case __INT2:
+    return GET_DIST_MASK_INT2;
+  case __INT4:
+    return GET_DIST_MASK_INT4;
+  case __INT8:
+    return GET_DIST_MASK_INT8;
+  default:
+    return 0;
+  }
+}
+
+static int
+mask_value(char *mp, int mlen, __INT8_T mbits)
+{
+  switch (mlen) {
+  case 1:
+    return (*(__INT1_T *)mp & (__INT1_T)mbits) != 0;
+  case 2:
+    return (*(__INT2_T *)mp & (__INT2_T)mbits) != 0;
+  case 4:
+    return (*(__INT4_T *)mp & (__INT4_T)mbits) != 0;
+  default:
+    return (*(__INT8_T *)mp & mbits) != 0;
+  }
+}
+
+/* compress: store the n elements of a whose mask is true into r,
+   stopping once rn elements have been stored.  The store is done
+   unconditionally and the result index advances by the mask value, so
+   the typed loops have no data-dependent branches.  Returns the number
+   of elements stored. */
+
+#define COMPRESS(T, M)                                                         \
+  for (i = j = 0; i < n && j < rn; ++i) {                                      \
+    ((T *)rp)[j * rs] = ((T *)ap)[i * as];                                     \
+    j += (((M *)mp)[i * ms] & (M)mbits) != 0;                                  \
+  }                                                                            \
+  break;
+
+#define COMPRESS_MASK(T)                                                       \
+  switch (mlen) {                                                              \
+  case 1:                                                                      \
+    COMPRESS(T, __INT1_T)                                                      \
+  case 2:                                                                      \
+    COMPRESS(T, __INT2_T)                                                      \
+  case 4:                                                                      \
+    COMPRESS(T, __INT4_T)                                                      \
+  default:                                                                     \
+    COMPRESS(T, __INT8_T)                                                      \
+  }                                                                            \
+  break;
+
+static __INT_T
+compress(char *rp, __INT_T rs, char *ap, __INT_T as, char *mp, __INT_T ms,
+         int mlen, __INT8_T mbits, __INT_T n, __INT_T rn, int len)
+{
+  __INT_T i, j;
+  int k;
+
+  k = len;
+  if ((len & (len - 1)) != 0 || len > 8 ||
+      (((unsigned long)rp | (unsigned long)ap) & (len - 1)) != 0)
+    k = 0; /* odd size or misaligned */
+
+  switch (k) {
+  case 1:
+    COMPRESS_MASK(__INT1_T)
+  case 2:
+    COMPRESS_MASK(__INT2_T)
+  case 4:
+    COMPRESS_MASK(__INT4_T)
+  case 8:
+    COMPRESS_MASK(__INT8_T)
+  default:
+    for (i = j = 0; i < n && j < rn; ++i) {
+      if (mask_value(mp + i * ms * mlen, mlen, mbits)) {
+        __fort_bcopy(rp + j * rs * len, ap + i * as * len, len);
+        ++j;
+      }
+    }
+  }
+  return j;
+}
+
+/* expand: store the next element of v into r where the mask is true
+   and the corresponding element of f where it is false.  A scalar
+   field is passed with stride 0. */
+
+#define EXPAND(T, M)                                                           \
+  for (i = j = 0; i < n; ++i) {                                                \
+    if (((M *)mp)[i * ms] & (M)mbits) {                                        \
+      ((T *)rp)[i * rs] = ((T *)vp)[j * vs];                                   \
+      if (++j == vn)                                                           \
+        j = 0;                                                                 \
+    } else                                                                     \
+      ((T *)rp)[i * rs] = ((T *)fp)[i * fs];                                   \
+  }                                                                            \
+  break;
+
+#define EXPAND_MASK(T)                                                         \
+  switch (mlen) {                                                              \
+  case 1:                                                                      \
+    EXPAND(T, __INT1_T)                                                        \
+  case 2:                                                                      \
+    EXPAND(T, __INT2_T)                                                        \
+  case 4:                                                                      \
+    EXPAND(T, __INT4_T)                                                        \
+  default:                                                                     \
+    EXPAND(T, __INT8_T)                                                        \
+  }                                                                            \
+  break;
+
+static void
+expand(char *rp, __INT_T rs, char *vp, __INT_T vs, char *mp, __INT_T ms,
+       char *fp, __INT_T fs, int mlen, __INT8_T mbits, __INT_T n, __INT_T vn,
+       int len)
+{
+  __INT_T i, j;
+  int k;
+
+  k = len;
+  if ((len & (len - 1)) != 0 || len > 8 ||
+      (((unsigned long)rp | (unsigned long)vp | (unsigned long)fp) &
+       (len - 1)) != 0)
+    k = 0; /* odd size or misaligned */
+
+  switch (k) {
+  case 1:
+    EXPAND_MASK(__INT1_T)
+  case 2:
+    EXPAND_MASK(__INT2_T)
+  case 4:
+    EXPAND_MASK(__INT4_T)
+  case 8:
+    EXPAND_MASK(__INT8_T)
+  default:
+    for (i = j = 0; i < n; ++i) {
+      if (mask_value(mp + i * ms * mlen, mlen, mbits)) {
+        __fort_bcopy(rp + i * rs * len, vp + j * vs * len, len);
+        if (++j == vn)
+          j = 0;
+      } else
+        __fort_bcopy(rp + i * rs * len, fp + i * fs * len, len);
+    }
+  }
+}
+
+/* PACK with all sections evenly spaced.  The vector is optional.
+   Returns 0 if the fast path does not apply. */
+
+static int I8(pack_fast)(char *rf, void *ab, void *mb, char *vf,
+                         F90_Desc *result, F90_Desc *array, F90_Desc *mask,
+                         F90_Desc *vector)
+{
+  char *rp, *ap, *mp, *vp;
+  __INT_T rs, as, ms, vs, n, rn, vn, j;
+  __INT8_T mbits;
+  int len, mlen;
+
+  len = F90_LEN_G(result);
+  if (F90_LEN_G(array) != len || (vector && F90_LEN_G(vector) != len))
+    return 0;
+
+  rp = I8(__fort_uniform_section)(rf, result, &rs);
+  ap = I8(__fort_uniform_section)((char *)ab + DIST_SCOFF_G(array) * len,
+                                  array, &as);
+  if (rp == NULL || ap == NULL)
+    return 0;
+  vp = NULL;
+  if (vector) {
+    vp = I8(__fort_uniform_section)(vf, vector, &vs);
+    if (vp == NULL)
+      return 0;
+  }
+
+  n = F90_GSIZE_G(array);
+  rn = F90_GSIZE_G(result);
+
+  if (ISSCALAR(mask)) {
+    /* mask is true, the caller returns early otherwise */
+    j = Min(n, rn);
+    __fort_bcopysl(rp, ap, j, rs, as, len);
+  } else {
+    mlen = F90_LEN_G(mask);
+    mbits = mask_bits(F90_KIND_G(mask));
+    if (mbits == 0 || F90_GSIZE_G(mask) != n ||
+        (mlen != 1 && mlen != 2 && mlen != 4 && mlen != 8))
+      return 0;
+    mp = I8(__fort_uniform_section)((char *)mb + DIST_SCOFF_G(mask) * mlen,
+                                    mask, &ms);
+    if (mp == NULL)
+      return 0;
+    j = compress(rp, rs, ap, as, mp, ms, mlen, mbits, n, rn, len);
+  }
+
+  /* fill the remainder of the result with the corresponding vector
+     elements */
+
+  if (vp) {
+    vn = Min(rn, F90_GSIZE_G(vector));
+    if (vn > j)
+      __fort_bcopysl(rp + j * rs * len, vp + j * vs * len, vn - j, rs, vs,
+                     len);
+  }
+  return 1;
+}
+
+/* UNPACK with all sections evenly spaced.  Returns 0 if the fast path
+   does not apply. */
+
+static int I8(unpack_fast)(char *rf, void *vb, void *mb, void *fb,
+                           F90_Desc *result, F90_Desc *vector,
+                           F90_Desc *mask, F90_Desc *field)
+{
+  char *rp, *vp, *mp, *fp;
+  __INT_T rs, vs, ms, fs, n, vn;
+  __INT8_T mbits;
+  int len, mlen;
+
+  len = F90_LEN_G(result);
+  mlen = F90_LEN_G(mask);
+  mbits = mask_bits(F90_KIND_G(mask));
+  n = F90_GSIZE_G(result);
+  vn = F90_GSIZE_G(vector);
+  if (F90_LEN_G(vector) != len || mbits == 0 || F90_GSIZE_G(mask) != n ||
+      vn <= 0 || (mlen != 1 && mlen != 2 && mlen != 4 && mlen != 8))
+    return 0;
+
+  rp = I8(__fort_uniform_section)(rf, result, &rs);
+  vp = I8(__fort_uniform_section)((char *)vb + DIST_SCOFF_G(vector) * len,
+                                  vector, &vs);
+  mp = I8(__fort_uniform_section)((char *)mb + DIST_SCOFF_G(mask) * mlen,
+                                  mask, &ms);
+  if (rp == NULL || vp == NULL || mp == NULL)
+    return 0;
+
+  if (ISSCALAR(field)) {
+    fp = fb;
+    fs = 0;
+  } else {
+    if (F90_LEN_G(field) != len || F90_GSIZE_G(field) != n)
+      return 0;
+    fp = I8(__fort_uniform_section)((char *)fb + DIST_SCOFF_G(field) * len,
+                                    field, &fs);
+    if (fp == NULL)
+      return 0;
+  }
+
+  expand(rp, rs, vp, vs, mp, ms, fp, fs, mlen, mbits, n, vn, len);
+  return 1;
+}
+
 /* pack, optional vector arg present.  pack masked elements of array
    into result and fill remainder of result with corresponding
    elements of vector */
@@ -90,7 +361,13 @@ void ENTFTN(PACK, pack)(void *rb,         /* result base */
   } else
     __fort_abort("PACK: invalid mask descriptor");
 
-  more_array = more_vector = 1;
+  if (I8(pack_fast)(rf, ab, mb, vf, result, array, mask, vector))
+    return;
+
+  /* a zero-size array packs nothing; the result is all vector */
+
+  more_array = F90_GSIZE_G(array) > 0;
+  more_vector = 1;
   while (more_array & more_vector) {
 
     /* get mask value */
@@ -217,6 +494,9 @@ void ENTFTN(PACKZ, packz)(void *rb,         /* result base */
   } else
     __fort_abort("PACK: invalid mask descriptor");
 
+  if (I8(pack_fast)(rf, ab, mb, NULL, result, array, mask, NULL))
+    return;
+
   more = 1;
   while (more) {
 
@@ -329,6 +609,9 @@ void ENTFTN(UNPACK, unpack)(void *rb,         /* result base */
   } else
     __fort_abort("UNPACK: invalid field descriptor");
 
+  if (I8(unpack_fast)(rf, vb, mb, fb, result, vector, mask, field))
+    return;
+
   more = 1;
   while (more) {
 
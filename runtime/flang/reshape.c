@@ -76,6 +76,62 @@ static int I8(advance_permuted)(F90_Desc *d, __INT_T *index, int *order,
   return 0;
 }
 
+/* reshape without a permuting ORDER, where the result, SOURCE and PAD
+   are evenly spaced in local memory, is a sequence of strided block
+   copies in array element order.  Returns 0 if the fast path does not
+   apply. */
+
+static int I8(reshape_fast)(char *resb, char *srcb, char *padb, F90_Desc *resd,
+                            F90_Desc *srcd, F90_Desc *padd, int *order)
+{
+  char *rp, *sp, *pp;
+  __INT_T rs, ss, ps, k, m, n, pn;
+  int i, len;
+
+  for (i = F90_RANK_G(resd); --i >= 0;) {
+    if (order[i] != i)
+      return 0;
+  }
+
+  len = F90_LEN_G(resd);
+  rp = I8(__fort_uniform_section)(resb + DIST_SCOFF_G(resd) * len, resd, &rs);
+  if (rp == NULL)
+    return 0;
+
+  n = F90_GSIZE_G(resd);
+  m = 0;
+  sp = pp = NULL;
+  if (F90_GSIZE_G(srcd) > 0) {
+    sp = I8(__fort_uniform_section)(srcb + DIST_SCOFF_G(srcd) * len, srcd,
+                                    &ss);
+    if (sp == NULL)
+      return 0;
+    m = Min(n, F90_GSIZE_G(srcd));
+  }
+  if (m < n) {
+    /* let the general case diagnose a missing PAD */
+    if (F90_TAG_G(padd) != __DESC || F90_GSIZE_G(padd) <= 0)
+      return 0;
+    pp = I8(__fort_uniform_section)(padb + DIST_SCOFF_G(padd) * len, padd,
+                                    &ps);
+    if (pp == NULL)
+      return 0;
+  }
+
+  if (m > 0)
+    __fort_bcopysl(rp, sp, m, rs, ss, len);
+
+  /* PAD is used repeatedly in array element order */
+
+  pn = pp ? F90_GSIZE_G(padd) : 0;
+  while (m < n) {
+    k = Min(pn, n - m);
+    __fort_bcopysl(rp + m * rs * len, pp, k, rs, ps, len);
+    m += k;
+  }
+  return 1;
+}
+
 /* reshape intrinsic */
 
 void ENTFTN(RESHAPE, reshape)(char *resb,     /* result base */
@@ -159,6 +215,8 @@ void ENTFTN(RESHAPE, reshape)(char *resb,     /* result base */
 
   if (F90_GSIZE_G(resd) <= 0)
     return;
+  if (I8(reshape_fast)(resb, srcb, padb, resd, srcd, padd, order))
+    return;
   for (i = r; --i >= 0;)
     resx[i] = F90_DIM_LBOUND_G(resd, i);
   k = order[0];
@@ -20,6 +20,66 @@
 #include "stdioInterf.h"
 #include "fioMacros.h"
 
+/* spread where the source and result are evenly spaced in local
+   memory.  The source is viewed as hi columns of lo elements, lo being
+   the number of elements below the spread dimension, and each column
+   is copied ncopies times.  Returns 0 if the fast path does not
+   apply. */
+
+static int I8(spread_fast)(char *rb, char *sb, F90_Desc *rd, F90_Desc *sd,
+                           int dim, int ncopies)
+{
+  char *rp, *sp;
+  __INT_T rs, ss, h, hi, k, lo;
+  int i, len;
+
+  len = F90_LEN_G(rd);
+  if (F90_TAG_G(sd) != __DESC || F90_LEN_G(sd) != len ||
+      F90_RANK_G(sd) != F90_RANK_G(rd) - 1 || dim < 1 ||
+      dim > F90_RANK_G(rd) || ncopies <= 0)
+    return 0;
+
+  /* the result must be the source with ncopies inserted at dim; leave
+     any other shape to the general case, which diagnoses it */
+
+  for (i = 0, k = 0; i < F90_RANK_G(rd); ++i) {
+    if (F90_DIM_EXTENT_G(rd, i) !=
+        (i == dim - 1 ? ncopies : F90_DIM_EXTENT_G(sd, k++)))
+      return 0;
+  }
+
+  rp = I8(__fort_uniform_section)(rb + DIST_SCOFF_G(rd) * len, rd, &rs);
+  sp = I8(__fort_uniform_section)(sb + DIST_SCOFF_G(sd) * len, sd, &ss);
+  if (rp == NULL || sp == NULL)
+    return 0;
+
+  lo = hi = 1;
+  for (i = 0; i < F90_RANK_G(sd); ++i) {
+    if (i < dim - 1)
+      lo *= F90_DIM_EXTENT_G(sd, i);
+    else
+      hi *= F90_DIM_EXTENT_G(sd, i);
+  }
+
+  /* copy whole columns when they are long, otherwise copy each element
+     position of a column across all columns with a larger stride */
+
+  if (lo >= hi) {
+    for (h = 0; h < hi; ++h) {
+      for (k = 0; k < ncopies; ++k)
+        __fort_bcopysl(rp + (h * ncopies + k) * lo * rs * len,
+                       sp + h * lo * ss * len, lo, rs, ss, len);
+    }
+  } else {
+    for (k = 0; k < ncopies; ++k) {
+      for (i = 0; i < lo; ++i)
+        __fort_bcopysl(rp + (k * lo + i) * rs * len, sp + i * ss * len, hi,
+                       lo * ncopies * rs, lo * ss, len);
+    }
+  }
+  return 1;
+}
+
 /* spread intrinsic -- copy sections for ncopies into appropriate
    dimensions */
 
@@ -44,6 +104,9 @@ void ENTFTN(SPREAD, spread)(void *rb,           /* result base */
   dim = I8(__fort_fetch_int)(dimb, dimd);
   ncopies = I8(__fort_fetch_int)(ncopiesb, ncopiesd);
 
+  if (I8(spread_fast)(rb, sb, rd, sd, dim, ncopies))
+    return;
+
   /* form temporary descriptor with a scalar subscript in the spread
      dimension */
 
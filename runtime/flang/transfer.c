@@ -56,7 +56,8 @@ void ENTFTN(TRANSFER, transfer)(void *rb,         /* result base */
    * it fits in temp; if not, need to malloc a temp.
    */
   double temp[16]; /* sufficient for a character*128 source */
-  char *ptemp;
+  char *ptemp, *sp;
+  __INT_T sstride;
 
   result_scalar = F90_TAG_G(result) != __DESC;
   source_scalar = F90_TAG_G(source) != __DESC;
@@ -109,6 +110,24 @@ void ENTFTN(TRANSFER, transfer)(void *rb,         /* result base */
       extent = 0;
     ssize *= extent;
   }
+  /* an evenly spaced source is copied directly: whole elements with a
+     (possibly strided) block copy, then any leading part of the next
+     element */
+
+  if (ssize > 0 && rsize > 0 &&
+      F90_LEN_G(source) == *ms &&
+      (sp = I8(__fort_uniform_section)(
+           (char *)sb + DIST_SCOFF_G(source) * *ms, source, &sstride)) !=
+          NULL) {
+    size = Min(ssize, rsize);
+    k = size / *ms;
+    __fort_bcopysl(rb, sp, k, 1, sstride, *ms);
+    size -= k * *ms;
+    if (size > 0)
+      __fort_bcopy((char *)rb + k * *ms, sp + k * sstride * *ms, size);
+    return;
+  }
+
   ptemp = (char *)&temp;
   if (*ms > sizeof(temp)) {
     ptemp = __fort_malloc(*ms);
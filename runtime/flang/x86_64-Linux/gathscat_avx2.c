@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2017, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/* Gather kernels compiled with -mavx2, which gathscat.c selects on
+ * processors that have AVX2.  The source elements are fetched with
+ * hardware gathers; the destination is stored a vector at a time when it
+ * is contiguous and an element at a time otherwise.
+ */
+
+#include <immintrin.h>
+#include <stddef.h>
+#include "gathscat.h"
+
+void
+__fort_gather4_avx2(int n, void *dst, const int *dx, const void *src,
+                    const int *sx)
+{
+  int *d = dst;
+  const int *s = src;
+  int t[8];
+  int i, k;
+
+  for (i = 0; i + 8 <= n; i += 8) {
+    __m256i v = _mm256_i32gather_epi32(
+        s, _mm256_loadu_si256((const __m256i *)(sx + i)), 4);
+    if (dx == NULL) {
+      _mm256_storeu_si256((__m256i *)(d + i), v);
+    } else {
+      _mm256_storeu_si256((__m256i *)t, v);
+      for (k = 0; k < 8; ++k)
+        d[dx[i + k]] = t[k];
+    }
+  }
+  for (; i < n; ++i)
+    d[dx ? dx[i] : i] = s[sx[i]];
+}
+
+void
+__fort_gather8_avx2(int n, void *dst, const int *dx, const void *src,
+                    const int *sx)
+{
+  long long *d = dst;
+  const long long *s = src;
+  long long t[4];
+  int i, k;
+
+  for (i = 0; i + 4 <= n; i += 4) {
+    __m256i v = _mm256_i32gather_epi64(
+        s, _mm_loadu_si128((const __m128i *)(sx + i)), 8);
+    if (dx == NULL) {
+      _mm256_storeu_si256((__m256i *)(d + i), v);
+    } else {
+      _mm256_storeu_si256((__m256i *)t, v);
+      for (k = 0; k < 4; ++k)
+        d[dx[i + k]] = t[k];
+    }
+  }
+  for (; i < n; ++i)
+    d[dx ? dx[i] : i] = s[sx[i]];
+}
@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2017, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/* Gather-scatter kernels compiled with -mavx512f, which gathscat.c
+ * selects on processors that have AVX-512.  An indexed source is fetched
+ * with hardware gathers and an indexed destination stored with hardware
+ * scatters.  A scatter writes lanes with equal offsets in lane order, so
+ * the last of several elements sent to one offset is kept, as in the
+ * scalar loop.
+ */
+
+#include <immintrin.h>
+#include <stddef.h>
+#include "gathscat.h"
+
+void
+__fort_gathscat4_avx512(int n, void *dst, const int *dx, const void *src,
+                        const int *sx)
+{
+  int *d = dst;
+  const int *s = src;
+  int i;
+
+  for (i = 0; i + 16 <= n; i += 16) {
+    __m512i v;
+    if (sx != NULL)
+      v = _mm512_i32gather_epi32(_mm512_loadu_si512(sx + i), s, 4);
+    else
+      v = _mm512_loadu_si512(s + i);
+    if (dx != NULL)
+      _mm512_i32scatter_epi32(d, _mm512_loadu_si512(dx + i), v, 4);
+    else
+      _mm512_storeu_si512(d + i, v);
+  }
+  for (; i < n; ++i)
+    d[dx ? dx[i] : i] = s[sx ? sx[i] : i];
+}
+
+void
+__fort_gathscat8_avx512(int n, void *dst, const int *dx, const void *src,
+                        const int *sx)
+{
+  long long *d = dst;
+  const long long *s = src;
+  int i;
+
+  for (i = 0; i + 8 <= n; i += 8) {
+    __m512i v;
+    if (sx != NULL)
+      v = _mm512_i32gather_epi64(
+          _mm256_loadu_si256((const __m256i *)(sx + i)), s, 8);
+    else
+      v = _mm512_loadu_si512(s + i);
+    if (dx != NULL)
+      _mm512_i32scatter_epi64(
+          d, _mm256_loadu_si256((const __m256i *)(dx + i)), v, 8);
+    else
+      _mm512_storeu_si512(d + i, v);
+  }
+  for (; i < n; ++i)
+    d[dx ? dx[i] : i] = s[sx ? sx[i] : i];
+}
@@ -20,10 +20,6 @@
 void
 __c_mcopy8(long long *dest, long long *src, long cnt)
 {
-  int i;
-
-  for (i = 0; i < cnt; i++) {
-    dest[i] = src[i];
-  }
-  return;
+  if (cnt > 0)
+    __c_mcopy(dest, src, sizeof(*dest), cnt);
 }
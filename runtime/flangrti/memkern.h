@@ -0,0 +1,181 @@
+/*
+ * Copyright (c) 2017, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/* Copy and fill kernels behind __c_mcopy<n>, __c_mset<n> and __c_mzero<n>.
+ *
+ * memops.c and the memops_*.c files in the architecture directories
+ * include this file once per vector width with MK_W defined to the
+ * number of bytes in a vector.  Each inclusion defines the static kernels
+ * mk_copy<w> and mk_fill<w>, written with the generic vector extensions
+ * so that the instruction set is chosen by the flags the including file
+ * is compiled with.  The including file may define MK_STREAM(p, v) to a
+ * non-temporal store of the vector v to the aligned address p and
+ * MK_FENCE() to the fence that orders such stores before each
+ * inclusion; without them the streaming loops use ordinary stores.
+ *
+ * A kernel stores the first and the last vector of the destination with
+ * unaligned stores and everything in between with aligned ones, so only
+ * the source loads may be misaligned.  A fill takes its value as 8 bytes
+ * that repeat from the start of the destination, which covers every
+ * element size; the aligned stores use the pattern rotated to their
+ * phase.
+ */
+
+#ifndef MEMKERN_H_
+#define MEMKERN_H_
+
+#include <stddef.h>
+#include <string.h>
+
+#define MK_INLINE static inline __attribute__((always_inline))
+
+#define MK_CAT_(a, b) a##b
+#define MK_CAT(a, b) MK_CAT_(a, b)
+
+/* The 32-byte kernels in x86_64-Linux/memops_avx2.c; nt selects
+ * non-temporal stores.
+ */
+void __c_mcopy_avx2(char *dest, const char *src, size_t n, int nt);
+void __c_mfill_avx2(char *dest, const unsigned char pat[8], size_t n, int nt);
+
+#endif /* MEMKERN_H_ */
+
+/* Everything below is defined once per inclusion, for MK_W bytes. */
+
+#define MK(fn) MK_CAT(MK_CAT(mk_, fn), MK_W)
+#define MKV MK(v)
+#define MKU MK(u)
+#define MKL MK(l)
+
+typedef unsigned char MKV __attribute__((vector_size(MK_W), may_alias));
+typedef unsigned char MKU
+    __attribute__((vector_size(MK_W), aligned(1), may_alias));
+typedef unsigned long long MKL __attribute__((vector_size(MK_W)));
+
+#ifndef MK_STREAM
+#define MK_STREAM(p, v) (*(MKV *)(p) = (v))
+#define MK_FENCE()
+#endif
+
+/* the fill pattern starting at byte ph of pat */
+MK_INLINE MKV MK(pattern)(const unsigned char pat[8], size_t ph)
+{
+  unsigned long long q;
+  int sh = (ph & 7) * 8;
+
+  memcpy(&q, pat, 8);
+  if (sh) {
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    q = q << sh | q >> (64 - sh);
+#else
+    q = q >> sh | q << (64 - sh);
+#endif
+  }
+  return (MKV)((MKL){0} + q);
+}
+
+/* n < MK_W bytes */
+MK_INLINE void MK(copy_short)(char *d, const char *s, size_t n)
+{
+  size_t i;
+
+  for (i = 0; i < n; ++i)
+    d[i] = s[i];
+}
+
+static void
+MK(copy)(char *d, const char *s, size_t n, int nt)
+{
+  MKV first, last;
+  size_t i, k;
+
+  if (n < MK_W) {
+    MK(copy_short)(d, s, n);
+    return;
+  }
+  first = *(const MKU *)s;
+  last = *(const MKU *)(s + n - MK_W);
+  k = (size_t)(-(unsigned long)d & (MK_W - 1));
+  *(MKU *)d = first;
+  i = k;
+  if (nt) {
+    for (; i + 4 * MK_W <= n; i += 4 * MK_W) {
+      MK_STREAM(d + i, *(const MKU *)(s + i));
+      MK_STREAM(d + i + MK_W, *(const MKU *)(s + i + MK_W));
+      MK_STREAM(d + i + 2 * MK_W, *(const MKU *)(s + i + 2 * MK_W));
+      MK_STREAM(d + i + 3 * MK_W, *(const MKU *)(s + i + 3 * MK_W));
+    }
+    for (; i + MK_W <= n; i += MK_W)
+      MK_STREAM(d + i, *(const MKU *)(s + i));
+    MK_FENCE();
+  } else {
+    for (; i + 4 * MK_W <= n; i += 4 * MK_W) {
+      *(MKV *)(d + i) = *(const MKU *)(s + i);
+      *(MKV *)(d + i + MK_W) = *(const MKU *)(s + i + MK_W);
+      *(MKV *)(d + i + 2 * MK_W) = *(const MKU *)(s + i + 2 * MK_W);
+      *(MKV *)(d + i + 3 * MK_W) = *(const MKU *)(s + i + 3 * MK_W);
+    }
+    for (; i + MK_W <= n; i += MK_W)
+      *(MKV *)(d + i) = *(const MKU *)(s + i);
+  }
+  *(MKU *)(d + n - MK_W) = last;
+}
+
+static void
+MK(fill)(char *d, const unsigned char pat[8], size_t n, int nt)
+{
+  MKV v;
+  size_t i, k;
+
+  if (n < MK_W) {
+    for (i = 0; i < n; ++i)
+      d[i] = pat[i & 7];
+    return;
+  }
+  k = (size_t)(-(unsigned long)d & (MK_W - 1));
+  *(MKU *)d = MK(pattern)(pat, 0);
+  v = MK(pattern)(pat, k);
+  i = k;
+  if (nt) {
+    for (; i + 4 * MK_W <= n; i += 4 * MK_W) {
+      MK_STREAM(d + i, v);
+      MK_STREAM(d + i + MK_W, v);
+      MK_STREAM(d + i + 2 * MK_W, v);
+      MK_STREAM(d + i + 3 * MK_W, v);
+    }
+    for (; i + MK_W <= n; i += MK_W)
+      MK_STREAM(d + i, v);
+    MK_FENCE();
+  } else {
+    for (; i + 4 * MK_W <= n; i += 4 * MK_W) {
+      *(MKV *)(d + i) = v;
+      *(MKV *)(d + i + MK_W) = v;
+      *(MKV *)(d + i + 2 * MK_W) = v;
+      *(MKV *)(d + i + 3 * MK_W) = v;
+    }
+    for (; i + MK_W <= n; i += MK_W)
+      *(MKV *)(d + i) = v;
+  }
+  *(MKU *)(d + n - MK_W) = MK(pattern)(pat, n - MK_W);
+}
+
+#undef MK_STREAM
+#undef MK_FENCE
+#undef MKL
+#undef MKU
+#undef MKV
+#undef MK
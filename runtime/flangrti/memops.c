@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) 2017, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/* __c_mcopy and __c_mfill, which do the work of __c_mcopy<n>, __c_mset<n>
+ * and __c_mzero<n>.  They run the 16-byte kernels compiled here, or the
+ * 32-byte kernels in x86_64-Linux/memops_avx2.c on processors with AVX2.
+ * Destinations of at least half the last level cache, but at most
+ * MK_NT_MAX bytes, are written with non-temporal stores, which do not
+ * read the destination into the cache and do not evict the data the
+ * program is working on.  The cap is for processors whose last level
+ * cache is shared by many cores, and for virtual machines that report
+ * the size of the whole socket's cache to a guest with few of its cores.
+ * The environment variable F90_STREAM_MINSZ replaces the threshold with a
+ * number of bytes; a negative number turns the non-temporal stores off.
+ */
+
+#include <stdlib.h>
+#include <unistd.h>
+#include "memops.h"
+
+#if defined(__x86_64__)
+#include <emmintrin.h>
+#define MK_X86 1
+#define MK_STREAM(p, v) _mm_stream_si128((__m128i *)(p), (__m128i)(v))
+#define MK_FENCE() _mm_sfence()
+#endif
+
+#define MK_W 16
+#include "memkern.h"
+#undef MK_W
+
+#define MK_NT_DEFAULT (8L << 20) /* without a cache size from sysconf */
+#define MK_NT_MAX (16L << 20)
+
+static int mk_avx2 = -1;
+static size_t mk_nt_bytes;
+
+/* Set mk_avx2 last, so that a thread that sees it set also sees the
+ * threshold.
+ */
+static void
+mk_init(void)
+{
+  long llc;
+  char *p_env;
+  int avx2;
+
+#ifdef _SC_LEVEL3_CACHE_SIZE
+  llc = sysconf(_SC_LEVEL3_CACHE_SIZE);
+  if (llc <= 0)
+    llc = sysconf(_SC_LEVEL2_CACHE_SIZE);
+#else
+  llc = 0;
+#endif
+  llc = llc > 0 ? llc / 2 : MK_NT_DEFAULT;
+  mk_nt_bytes = llc < MK_NT_MAX ? llc : MK_NT_MAX;
+  p_env = getenv("F90_STREAM_MINSZ");
+  if (p_env != NULL) {
+    llc = atol(p_env);
+    mk_nt_bytes = llc < 0 ? (size_t)-1 : (size_t)llc;
+  }
+#ifdef MK_X86
+  __builtin_cpu_init();
+  avx2 = __builtin_cpu_supports("avx2") != 0;
+#else
+  avx2 = 0;
+#endif
+  __atomic_store_n(&mk_avx2, avx2, __ATOMIC_RELEASE);
+}
+
+/* the size from which to use non-temporal stores */
+static size_t
+mk_nt_threshold(void)
+{
+  if (__atomic_load_n(&mk_avx2, __ATOMIC_ACQUIRE) < 0)
+    mk_init();
+  return mk_nt_bytes;
+}
+
+void
+__c_mcopy(void *dest, const void *src, size_t size, long cnt)
+{
+  char *d = dest;
+  const char *s = src;
+  size_t n = size * (size_t)cnt;
+  int nt;
+
+  if (d < s + n && s < d + n) {
+    /* not valid Fortran, but give overlapping operands a defined result */
+    memmove(d, s, n);
+    return;
+  }
+  nt = n >= mk_nt_threshold();
+#ifdef MK_X86
+  if (mk_avx2) {
+    __c_mcopy_avx2(d, s, n, nt);
+    return;
+  }
+#endif
+  mk_copy16(d, s, n, nt);
+}
+
+void
+__c_mfill(void *dest, const void *elem, size_t size, long cnt)
+{
+  unsigned char pat[8];
+  size_t n = size * (size_t)cnt;
+  size_t i;
+  int nt;
+
+  for (i = 0; i < sizeof(pat); i += size)
+    memcpy(pat + i, elem, size);
+  nt = n >= mk_nt_threshold();
+#ifdef MK_X86
+  if (mk_avx2) {
+    __c_mfill_avx2(dest, pat, n, nt);
+    return;
+  }
+#endif
+  mk_fill16(dest, pat, n, nt);
+}
@@ -15,9 +15,12 @@
  *
  */
 
-/* mp-safe wrappers for malloc, etc. */
+/* mp-safe wrappers for malloc, etc.  Large allocations are placed on the
+ * NUMA nodes as F90_NUMA asks (see numa.c).
+ */
 
 #include <stdlib.h>
+#include "mpnuma.h"
 extern void _mp_p(long*);
 extern void _mp_v(long*);
 
@@ -31,6 +34,20 @@ _mp_malloc(size_t n)
   _mp_p(&sem);
   p = malloc(n);
   _mp_v(&sem);
+  _mp_numa_newmem(p, n);
+  return (p);
+}
+
+void *
+_mp_malloc_numa(size_t n, int policy)
+{
+  void *p;
+
+  _mp_p(&sem);
+  p = malloc(n);
+  _mp_v(&sem);
+  if (p != NULL)
+    _mp_numa_place(p, n, policy);
   return (p);
 }
 
@@ -42,6 +59,7 @@ _mp_calloc(size_t n, size_t t)
   _mp_p(&sem);
   p = calloc(n, t);
   _mp_v(&sem);
+  _mp_numa_newmem(p, n * t);
   return (p);
 }
 
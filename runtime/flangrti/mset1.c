@@ -20,10 +20,8 @@
 void
 __c_mset1(char *dest, int value, long cnt)
 {
-  int i;
+  char v = value;
 
-  for (i = 0; i < cnt; i++) {
-    dest[i] = value;
-  }
-  return;
+  if (cnt > 0)
+    __c_mfill(dest, &v, sizeof(v), cnt);
 }
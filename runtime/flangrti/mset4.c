@@ -20,10 +20,6 @@
 void
 __c_mset4(int *dest, int value, long cnt)
 {
-  int i;
-
-  for (i = 0; i < cnt; i++) {
-    dest[i] = value;
-  }
-  return;
+  if (cnt > 0)
+    __c_mfill(dest, &value, sizeof(value), cnt);
 }
@@ -20,10 +20,8 @@
 void
 __c_mzero2(short *dest, long cnt)
 {
-  int i;
+  short v = 0;
 
-  for (i = 0; i < cnt; i++) {
-    dest[i] = 0;
-  }
-  return;
+  if (cnt > 0)
+    __c_mfill(dest, &v, sizeof(v), cnt);
 }
@@ -15,64 +15,443 @@
  *
  */
 
-/* dummy libnuma.a routines */
+/* NUMA placement of allocated memory, and the libnuma routines that used
+ * to be dummies here.  Everything is done with the Linux mbind,
+ * set_mempolicy and get_mempolicy system calls, so there is no dependence
+ * on libnuma.  Without them, or on a machine with one memory node, there
+ * is a single node and placement does nothing.
+ *
+ * Allocations of at least F90_NUMA_MINSZ bytes (default 16 MB) made by
+ * ALLOCATE and _mp_malloc get the policy named by F90_NUMA:
+ *   interleave  pages go round robin to the memory nodes, for data that
+ *               all threads read
+ *   local       pages go to the node of the thread that first touches
+ *               them, even if the program was started under another policy
+ * If F90_NUMA_TOUCH is set to a nonzero number, such allocations are also
+ * touched right away by a few threads per node, bound to the node's CPUs,
+ * each node taking one contiguous part of the memory in node order.  Under
+ * the local or the default policy that puts each part on the node that an
+ * OpenMP static schedule with threads bound in node order will run it on,
+ * as a parallel initialization loop in the program would.  Touching reads
+ * and writes back one byte of each page, so the contents are kept.  The LIB3F
+ * routines numa_place and numa_touch (flang numa3f.c) do the same for a
+ * single array.
+ */
+
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE /* for cpu_set_t and pthread_attr_setaffinity_np */
+#endif
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "mpnuma.h"
+
+#if defined(__linux__)
+#define NUMA_LINUX 1
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+/* from linux/mempolicy.h */
+#define MPOL_DEFAULT 0
+#define MPOL_PREFERRED 1
+#define MPOL_BIND 2
+#define MPOL_INTERLEAVE 3
+#define MPOL_F_MEMS_ALLOWED (1 << 2)
+
+#define NUMA_LBITS (8 * sizeof(unsigned long))
+#define NUMA_MAXNODES 1024 /* bits in the node masks passed to the kernel */
+#define NUMA_MINSZ_DEFAULT (16L << 20)
+#define NUMA_TOUCH_PERNODE 4 /* threads touching each node's part */
+#define NUMA_TOUCH_MAX 64
+
+/* libnuma's version 1 node mask */
+#if defined(__x86_64__) || defined(__i386__)
+#define NUMA_NUM_NODES 128
+#else
+#define NUMA_NUM_NODES 2048
+#endif
+typedef struct {
+  unsigned long n[NUMA_NUM_NODES / (8 * sizeof(unsigned long))];
+} nodemask_t;
+
+static int numa_nnodes = -1;
+static unsigned long numa_mems[NUMA_MAXNODES / NUMA_LBITS];
+static int numa_maxnode;
+static int numa_policy;
+static size_t numa_minsz;
+static int numa_dotouch;
+static unsigned long numa_pgsz;
+
+/* system calls; the kernel reads maxnode - 1 bits of nmask */
+
+long
+mbind(void *start, unsigned long len, int mode, const unsigned long *nmask,
+      unsigned long maxnode, unsigned flags)
+{
+#if defined(SYS_mbind)
+  return syscall(SYS_mbind, start, len, mode, nmask, maxnode, flags);
+#else
+  errno = ENOSYS;
+  return -1;
+#endif
+}
+
+long
+set_mempolicy(int mode, const unsigned long *nmask, unsigned long maxnode)
+{
+#if defined(SYS_set_mempolicy)
+  return syscall(SYS_set_mempolicy, mode, nmask, maxnode);
+#else
+  errno = ENOSYS;
+  return -1;
+#endif
+}
+
+long
+get_mempolicy(int *mode, unsigned long *nmask, unsigned long maxnode,
+              void *addr, unsigned long flags)
+{
+#if defined(SYS_get_mempolicy)
+  return syscall(SYS_get_mempolicy, mode, nmask, maxnode, addr, flags);
+#else
+  errno = ENOSYS;
+  return -1;
+#endif
+}
+
+/* Find the memory nodes and read the environment.  Set numa_nnodes last,
+ * so that a thread that sees it set also sees the rest.
+ */
+static void
+numa_init(void)
+{
+  char *p_env;
+  int i, n;
+
+  n = 0;
+  if (get_mempolicy(NULL, numa_mems, NUMA_MAXNODES, NULL,
+                    MPOL_F_MEMS_ALLOWED) == 0) {
+    for (i = 0; i < NUMA_MAXNODES; ++i) {
+      if (numa_mems[i / NUMA_LBITS] >> (i % NUMA_LBITS) & 1) {
+        numa_maxnode = i;
+        ++n;
+      }
+    }
+  }
+  if (n == 0) {
+    memset(numa_mems, 0, sizeof(numa_mems));
+    numa_mems[0] = 1;
+    numa_maxnode = 0;
+    n = 1;
+  }
+
+  numa_policy = MP_NUMA_DEFAULT;
+  p_env = getenv("F90_NUMA");
+  if (p_env != NULL) {
+    if (strcmp(p_env, "interleave") == 0)
+      numa_policy = MP_NUMA_INTERLEAVE;
+    else if (strcmp(p_env, "local") == 0)
+      numa_policy = MP_NUMA_LOCAL;
+  }
+  numa_minsz = NUMA_MINSZ_DEFAULT;
+  p_env = getenv("F90_NUMA_MINSZ");
+  if (p_env != NULL)
+    numa_minsz = atol(p_env);
+  p_env = getenv("F90_NUMA_TOUCH");
+  numa_dotouch = p_env != NULL && atol(p_env) != 0;
+#if defined(NUMA_LINUX)
+  numa_pgsz = sysconf(_SC_PAGESIZE);
+#endif
+  if (numa_pgsz == 0)
+    numa_pgsz = 4096;
+  __atomic_store_n(&numa_nnodes, n, __ATOMIC_RELEASE);
+}
 
 int
-numa_available()
+_mp_numa_nodes(void)
 {
-  return (-1);
+  int n = __atomic_load_n(&numa_nnodes, __ATOMIC_ACQUIRE);
+
+  if (n < 0) {
+    numa_init();
+    n = numa_nnodes;
+  }
+  return n;
 }
 
 void
-nodemask_zero()
+_mp_numa_place(void *p, size_t n, int policy)
+{
+  unsigned long beg, end;
+  const unsigned long *mask = NULL;
+  unsigned long maxnode = 0;
+  int mode;
+
+  if (_mp_numa_nodes() <= 1)
+    return;
+  beg = ((unsigned long)p + numa_pgsz - 1) & ~(numa_pgsz - 1);
+  end = ((unsigned long)p + n) & ~(numa_pgsz - 1);
+  if (beg >= end)
+    return;
+  switch (policy) {
+  case MP_NUMA_LOCAL:
+    mode = MPOL_PREFERRED; /* no preferred node means the local one */
+    break;
+  case MP_NUMA_INTERLEAVE:
+    mode = MPOL_INTERLEAVE;
+    mask = numa_mems;
+    maxnode = NUMA_MAXNODES + 1;
+    break;
+  default:
+    mode = MPOL_DEFAULT;
+    break;
+  }
+  /* placement is advice: keep going if the kernel refuses it */
+  (void)mbind((void *)beg, end - beg, mode, mask, maxnode, 0);
+}
+
+typedef struct {
+  char *beg, *end;
+  int node; /* the node whose CPUs to run on, or -1 */
+} TOUCH;
+
+#if defined(NUMA_LINUX)
+/* the CPUs of a node, from its cpulist such as "0-7,16-23" */
+static int
+numa_node_cpus(int node, cpu_set_t *cpus)
 {
+  char path[64], buf[1024], *p;
+  long lo, hi;
+  FILE *f;
+  int ok;
+
+  CPU_ZERO(cpus);
+  sprintf(path, "/sys/devices/system/node/node%d/cpulist", node);
+  f = fopen(path, "r");
+  if (f == NULL)
+    return 0;
+  ok = fgets(buf, sizeof(buf), f) != NULL;
+  fclose(f);
+  if (!ok)
+    return 0;
+  for (p = buf; *p >= '0' && *p <= '9';) {
+    lo = hi = strtol(p, &p, 10);
+    if (*p == '-')
+      hi = strtol(p + 1, &p, 10);
+    for (; lo <= hi && lo < CPU_SETSIZE; ++lo)
+      CPU_SET(lo, cpus);
+    if (*p == ',')
+      ++p;
+  }
+  return CPU_COUNT(cpus) > 0;
+}
+#endif
+
+static void *
+numa_touch_part(void *arg)
+{
+  TOUCH *t = arg;
+  char *q;
+
+  /* write back what is there: the memory may already hold data */
+  for (q = t->beg; q < t->end; q += numa_pgsz)
+    *(volatile char *)q = *(volatile char *)q;
+  return NULL;
 }
 
 void
-nodemask_set()
+_mp_numa_touch(void *p, size_t n)
 {
+  TOUCH part[NUMA_TOUCH_MAX];
+  int node[NUMA_TOUCH_MAX];
+  char *beg, *end;
+  size_t npages;
+  int nodes, nthr, per, i, k;
+#if defined(NUMA_LINUX)
+  pthread_t thr[NUMA_TOUCH_MAX];
+  pthread_attr_t attr;
+  cpu_set_t cpus;
+  int started[NUMA_TOUCH_MAX];
+  long ncpu;
+#endif
+
+  if (n == 0)
+    return;
+  nodes = _mp_numa_nodes();
+  beg = (char *)((unsigned long)p & ~(numa_pgsz - 1));
+  end = (char *)p + n;
+  npages = (end - beg + numa_pgsz - 1) / numa_pgsz;
+
+  /* a few threads per node, in node order */
+  per = 1;
+#if defined(NUMA_LINUX)
+  ncpu = sysconf(_SC_NPROCESSORS_ONLN);
+  if (ncpu > nodes)
+    per = ncpu / nodes;
+#endif
+  if (per > NUMA_TOUCH_PERNODE)
+    per = NUMA_TOUCH_PERNODE;
+  if (nodes * per > NUMA_TOUCH_MAX)
+    per = NUMA_TOUCH_MAX / nodes > 0 ? NUMA_TOUCH_MAX / nodes : 1;
+  nthr = 0;
+  for (i = 0; i <= numa_maxnode && nthr + per <= NUMA_TOUCH_MAX; ++i) {
+    if (!(numa_mems[i / NUMA_LBITS] >> (i % NUMA_LBITS) & 1))
+      continue;
+    for (k = 0; k < per; ++k)
+      node[nthr++] = nodes > 1 ? i : -1;
+  }
+  if ((size_t)nthr > npages)
+    nthr = npages;
+  for (i = 0; i < nthr; ++i) {
+    part[i].beg = beg + npages * i / nthr * numa_pgsz;
+    part[i].end = beg + npages * (i + 1) / nthr * numa_pgsz;
+    if (part[i].beg < (char *)p)
+      part[i].beg = p;
+    if (part[i].end > end)
+      part[i].end = end;
+    part[i].node = node[i];
+  }
+  if (nthr <= 1) {
+    part[0].beg = p;
+    part[0].end = end;
+    numa_touch_part(&part[0]);
+    return;
+  }
+
+#if defined(NUMA_LINUX)
+  /* the calling thread does what no helper thread could be started for */
+  for (i = 0; i < nthr; ++i) {
+    started[i] = 0;
+    if (pthread_attr_init(&attr) != 0)
+      continue;
+    if (part[i].node >= 0 && numa_node_cpus(part[i].node, &cpus))
+      pthread_attr_setaffinity_np(&attr, sizeof(cpus), &cpus);
+    started[i] =
+        pthread_create(&thr[i], &attr, numa_touch_part, &part[i]) == 0;
+    pthread_attr_destroy(&attr);
+  }
+  for (i = 0; i < nthr; ++i) {
+    if (started[i])
+      pthread_join(thr[i], NULL);
+    else
+      numa_touch_part(&part[i]);
+  }
+#else
+  for (i = 0; i < nthr; ++i)
+    numa_touch_part(&part[i]);
+#endif
 }
 
 void
-numa_set_membind()
+_mp_numa_newmem(void *p, size_t n)
 {
+  _mp_numa_nodes();
+  if (p == NULL || n < numa_minsz)
+    return;
+  if (numa_policy != MP_NUMA_DEFAULT)
+    _mp_numa_place(p, n, numa_policy);
+  if (numa_dotouch)
+    _mp_numa_touch(p, n);
 }
 
+/* libnuma's routines */
+
 int
-numa_max_node()
+numa_available(void)
 {
-  return 1;
+  if (get_mempolicy(NULL, NULL, 0, NULL, 0) < 0 && errno == ENOSYS)
+    return -1;
+  return 0;
+}
+
+int
+numa_max_node(void)
+{
+  _mp_numa_nodes();
+  return numa_maxnode;
 }
 
 void
-numa_alloc_local()
+nodemask_zero(nodemask_t *mask)
 {
+  memset(mask, 0, sizeof(*mask));
 }
 
 void
-numa_set_preferred()
+nodemask_set(nodemask_t *mask, int node)
 {
+  if (node >= 0 && node < NUMA_NUM_NODES)
+    mask->n[node / NUMA_LBITS] |= 1UL << (node % NUMA_LBITS);
 }
 
 void
-numa_set_localalloc()
+numa_set_membind(const nodemask_t *mask)
 {
+  set_mempolicy(MPOL_BIND, mask->n, NUMA_NUM_NODES + 1);
 }
 
-int
-set_mempolicy()
+void
+numa_set_preferred(int node)
 {
-  return (0);
+  unsigned long mask[NUMA_MAXNODES / NUMA_LBITS];
+
+  if (node < 0 || node >= NUMA_MAXNODES) {
+    set_mempolicy(MPOL_PREFERRED, NULL, 0);
+    return;
+  }
+  memset(mask, 0, sizeof(mask));
+  mask[node / NUMA_LBITS] = 1UL << (node % NUMA_LBITS);
+  set_mempolicy(MPOL_PREFERRED, mask, NUMA_MAXNODES + 1);
 }
 
-int
-get_mempolicy()
+void
+numa_set_localalloc(void)
 {
-  return (0);
+  set_mempolicy(MPOL_PREFERRED, NULL, 0);
 }
 
-int
-mbind()
+static void *
+numa_mmap(size_t n, int policy)
+{
+#if defined(NUMA_LINUX)
+  void *p;
+
+  p = mmap(NULL, n, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1,
+           0);
+  if (p == MAP_FAILED)
+    return NULL;
+  _mp_numa_place(p, n, policy);
+  return p;
+#else
+  return malloc(n);
+#endif
+}
+
+void *
+numa_alloc_local(size_t n)
+{
+  return numa_mmap(n, MP_NUMA_LOCAL);
+}
+
+void *
+numa_alloc_interleaved(size_t n)
+{
+  return numa_mmap(n, MP_NUMA_INTERLEAVE);
+}
+
+void
+numa_free(void *p, size_t n)
 {
-  return (0);
+  if (p == NULL)
+    return;
+#if defined(NUMA_LINUX)
+  munmap(p, n);
+#else
+  free(p);
+#endif
 }
@@ -0,0 +1,606 @@
+/*
+ * Copyright (c) 2017, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/* Vector math kernels behind the __fvd_<fn>_<n> and __fvs_<fn>_<n>
+ * entry points.
+ *
+ * The vmath_*.c files in the architecture directories include this file
+ * once per vector length with VM_N defined to the number of lanes.  Each
+ * inclusion defines GCC vector types of that length and the static
+ * kernels vm_d<fn><n> (double) and vm_s<fn><n> (single), which the
+ * including file wraps in entry points with VM_ENTRIES.  The kernels are
+ * written with the generic vector extensions, so the instruction set is
+ * chosen by the flags the including file is compiled with.
+ *
+ * The double precision kernels use the fdlibm reductions and
+ * polynomials; pow evaluates log(x) in double-double arithmetic before
+ * multiplying by y.  Single precision is computed with the double
+ * kernels and rounded once.  Lanes outside the range a kernel handles
+ * (NaN, infinities, zero, negative or denormal arguments of log and pow,
+ * results of exp and pow that overflow or underflow, sin and cos of
+ * arguments above VM_TRIG_MAX) are recomputed with the scalar libm
+ * function.
+ *
+ * Maximum errors measured against the long double libm functions over
+ * 10^7 random arguments per function, in ulps of the result:
+ *
+ *            exp   log   pow   sin   cos   tanh  erf   sqrt
+ *   double   0.90  0.83  1.39  0.79  0.78  1.98  0.95  0.50
+ *   single   0.50  0.50  0.50  0.50  0.50  0.50  0.50  0.50
+ *
+ * The single precision results were correctly rounded in every sample.
+ * The FMA and non-FMA kernels stay within the same bounds, and the
+ * wider entries give the same results as the 2 and 4 lane ones.
+ * sincos has the bounds of sin and cos.
+ */
+
+#ifndef VMATH_H_
+#define VMATH_H_
+
+#include <math.h>
+
+#if defined(__FMA__) || defined(__aarch64__)
+#define VM_HAVE_FMA 1
+#endif
+
+/* The kernels are inlined into each entry point: a call between two
+ * kernels passes wide vectors outside the standard ABI, and GCC then
+ * omits the vzeroupper that keeps SSE callers from stalling.
+ */
+#define VM_INLINE static inline __attribute__((always_inline))
+
+#define VM_CAT_(a, b) a##b
+#define VM_CAT(a, b) VM_CAT_(a, b)
+
+#define VM_TRIG_MAX 1.0e5 /* larger sin and cos arguments go to libm */
+
+#define VM_SHIFT 0x1.8p52 /* adding it rounds to an integer */
+#define VM_SHIFT_BITS 0x4338000000000000LL
+#define VM_ABS_MASK 0x7fffffffffffffffLL
+#define VM_SIGN_MASK (-0x7fffffffffffffffLL - 1)
+
+#define VM_INVLN2 1.44269504088896338700e+00
+#define VM_LN2HI 6.93147180369123816490e-01 /* 0x3fe62e42, 0xfee00000 */
+#define VM_LN2LO 1.90821492927058770002e-10 /* 0x3dea39ef, 0x35793c76 */
+
+/* exp(r) = 1 + r + r*c/(2 - c) on [-ln2/2, ln2/2], fdlibm e_exp.c */
+#define VM_EP1 1.66666666666666019037e-01
+#define VM_EP2 -2.77777777770155933842e-03
+#define VM_EP3 6.61375632143793436117e-05
+#define VM_EP4 -1.65339022054652515390e-06
+#define VM_EP5 4.13813679705723846039e-08
+
+/* log(1+f) = f - f*f/2 + s*(f*f/2 + R(s*s)), fdlibm e_log.c */
+#define VM_LG1 6.666666666666735130e-01
+#define VM_LG2 3.999999999940941908e-01
+#define VM_LG3 2.857142874366239149e-01
+#define VM_LG4 2.222219843214978396e-01
+#define VM_LG5 1.818357216161805012e-01
+#define VM_LG6 1.531383769920937332e-01
+#define VM_LG7 1.479819860511658591e-01
+
+/* 2/3 in two pieces, for pow */
+#define VM_C23H 6.66666666666666629659e-01
+#define VM_C23L 3.70074341541718826264e-17
+
+/* pi/2 in pieces of 33 bits: pio2_1 + pio2_2 + pio2_3 + pio2_3t */
+#define VM_INVPIO2 6.36619772367581382433e-01
+#define VM_PIO2_1 1.57079632673412561417e+00
+#define VM_PIO2_2 6.07710050630396597660e-11
+#define VM_PIO2_3 2.02226624871116645580e-21
+#define VM_PIO2_3T 8.47842766036889956997e-32
+
+/* sin and cos on [-pi/4, pi/4], fdlibm k_sin.c and k_cos.c */
+#define VM_S1 -1.66666666666666324348e-01
+#define VM_S2 8.33333333332248946124e-03
+#define VM_S3 -1.98412698298579493134e-04
+#define VM_S4 2.75573137070700676789e-06
+#define VM_S5 -2.50507602534068634195e-08
+#define VM_S6 1.58969099521155010221e-10
+#define VM_C1 4.16666666666666019037e-02
+#define VM_C2 -1.38888888888741095749e-03
+#define VM_C3 2.48015872894767294178e-05
+#define VM_C4 -2.75573143513906633035e-07
+#define VM_C5 2.08757232129817482790e-09
+#define VM_C6 -1.13596475577881948265e-11
+
+/* Recompute lanes m of r as fn(x) or fn(x, y). */
+#define VM_FIX1(r, m, fn, x)                                                   \
+  do {                                                                         \
+    int i_;                                                                    \
+    for (i_ = 0; i_ < VM_N; ++i_)                                              \
+      if (m[i_])                                                               \
+        r[i_] = fn(x[i_]);                                                     \
+  } while (0)
+
+#define VM_FIX2(r, m, fn, x, y)                                                \
+  do {                                                                         \
+    int i_;                                                                    \
+    for (i_ = 0; i_ < VM_N; ++i_)                                              \
+      if (m[i_])                                                               \
+        r[i_] = fn(x[i_], y[i_]);                                              \
+  } while (0)
+
+/* Entry points __fv<t>_<fn>_<n><sfx> for the kernels of length n, where
+ * t is d or s.
+ */
+#define VM_V(t, n) VM_CAT(vm_v##t, n)
+#define VM_K(t, fn, n) VM_CAT(vm_##t##fn, n)
+
+#define VM_ENTRY1(t, fn, n, sfx)                                               \
+  VM_V(t, n) __fv##t##_##fn##_##n##sfx(VM_V(t, n) x)                           \
+  {                                                                            \
+    return VM_K(t, fn, n)(x);                                                  \
+  }
+
+#define VM_ENTRY2(t, fn, n, sfx)                                               \
+  VM_V(t, n) __fv##t##_##fn##_##n##sfx(VM_V(t, n) x, VM_V(t, n) y)             \
+  {                                                                            \
+    return VM_K(t, fn, n)(x, y);                                               \
+  }
+
+#define VM_ENTRYSC(t, n, sfx)                                                  \
+  void __fv##t##_sincos_##n##sfx(VM_V(t, n) x, VM_V(t, n) *s, VM_V(t, n) *c)   \
+  {                                                                            \
+    VM_K(t, sincos, n)(x, s, c);                                               \
+  }
+
+#define VM_ENTRIES(t, n, sfx)                                                  \
+  VM_ENTRY1(t, exp, n, sfx)                                                    \
+  VM_ENTRY1(t, log, n, sfx)                                                    \
+  VM_ENTRY2(t, pow, n, sfx)                                                    \
+  VM_ENTRY1(t, sin, n, sfx)                                                    \
+  VM_ENTRY1(t, cos, n, sfx)                                                    \
+  VM_ENTRYSC(t, n, sfx)                                                        \
+  VM_ENTRY1(t, tanh, n, sfx)                                                   \
+  VM_ENTRY1(t, erf, n, sfx)                                                    \
+  VM_ENTRY1(t, sqrt, n, sfx)
+
+#endif /* VMATH_H_ */
+
+/* Everything below is defined once per inclusion, for VM_N lanes. */
+
+#define VD VM_V(d, VM_N)
+#define VS VM_V(s, VM_N)
+#define VL VM_V(l, VM_N)
+#define VM(fn) VM_CAT(VM_CAT(vm_, fn), VM_N)
+
+typedef double VD __attribute__((vector_size(VM_N * 8)));
+typedef float VS __attribute__((vector_size(VM_N * 4)));
+typedef long long VL __attribute__((vector_size(VM_N * 8)));
+
+VM_INLINE VD VM(sel)(VL m, VD a, VD b)
+{
+  return (VD)((m & (VL)a) | (~m & (VL)b));
+}
+
+VM_INLINE VD VM(bc)(double c)
+{
+  return (VD){0} + c;
+}
+
+VM_INLINE int VM(any)(VL m)
+{
+  long long r;
+  int i;
+
+  r = 0;
+  for (i = 0; i < VM_N; ++i)
+    r |= m[i];
+  return r != 0;
+}
+
+VM_INLINE VD VM(abs)(VD x)
+{
+  return (VD)((VL)x & VM_ABS_MASK);
+}
+
+/* Round x, |x| < 2^51, to the nearest integer; *n gets it as an integer. */
+VM_INLINE VD VM(rint)(VD x, VL *n)
+{
+  VD t;
+
+  t = x + VM_SHIFT;
+  *n = (VL)t - VM_SHIFT_BITS;
+  return t - VM_SHIFT;
+}
+
+/* Convert integers with |n| < 2^51 to double. */
+VM_INLINE VD VM(cvt)(VL n)
+{
+  return (VD)(n + VM_SHIFT_BITS) - VM_SHIFT;
+}
+
+/* a*b = p + *e exactly. */
+VM_INLINE VD VM(twoprod)(VD a, VD b, VD *e)
+{
+  VD p;
+#ifdef VM_HAVE_FMA
+  VD r;
+  int i;
+
+  p = a * b;
+  for (i = 0; i < VM_N; ++i)
+    r[i] = __builtin_fma(a[i], b[i], -p[i]);
+  *e = r;
+#else
+  VD c, ah, al, bh, bl;
+
+  p = a * b;
+  c = 134217729.0 * a;
+  ah = c - (c - a);
+  al = a - ah;
+  c = 134217729.0 * b;
+  bh = c - (c - b);
+  bl = b - bh;
+  *e = ((ah * bh - p) + ah * bl + al * bh) + al * bl;
+#endif
+  return p;
+}
+
+/* exp(r) - 1 = r + r*c/(2 - c) with r = hi - lo reduced by k*ln2. */
+VM_INLINE VD VM(expm1r)(VD x, VL *k, VD *hi, VD *lo)
+{
+  VD kd, r, z, c;
+
+  kd = VM(rint)(x * VM_INVLN2, k);
+  *hi = x - kd * VM_LN2HI;
+  *lo = kd * VM_LN2LO;
+  r = *hi - *lo;
+  z = r * r;
+  c = r - z * (VM_EP1 +
+                  z * (VM_EP2 + z * (VM_EP3 + z * (VM_EP4 + z * VM_EP5))));
+  return (r * c) / (2.0 - c);
+}
+
+/* exp(x) for |x| <= 708.5 */
+VM_INLINE VD VM(expk)(VD x)
+{
+  VL k;
+  VD hi, lo, q;
+
+  q = VM(expm1r)(x, &k, &hi, &lo);
+  return (1.0 - ((lo - q) - hi)) * (VD)((k + 1023) << 52);
+}
+
+VM_INLINE VD VM(dexp)(VD x)
+{
+  VD r;
+  VL m;
+
+  r = VM(expk)(x);
+  m = ~(VM(abs)(x) <= 708.0);
+  if (VM(any)(m))
+    VM_FIX1(r, m, exp, x);
+  return r;
+}
+
+/* x = 2^k * (1 + f) with sqrt(2)/2 <= 1 + f < sqrt(2), for positive
+ * normal x.
+ */
+VM_INLINE VD VM(logred)(VD x, VD *kd)
+{
+  VL u;
+
+  u = (VL)x + (0x3ff0000000000000LL - 0x3fe6a09e00000000LL);
+  *kd = VM(cvt)((u >> 52) - 1023);
+  return (VD)((u & 0x000fffffffffffffLL) + 0x3fe6a09e00000000LL) - 1.0;
+}
+
+/* Lanes for which log and pow go to libm */
+VM_INLINE VL VM(logbad)(VD x)
+{
+  return ~((x >= 0x1p-1022) & (x < __builtin_inf()));
+}
+
+VM_INLINE VD VM(dlog)(VD x)
+{
+  VD kd, f, s, z, w, t1, t2, hfsq, r;
+  VL m;
+
+  f = VM(logred)(x, &kd);
+  s = f / (2.0 + f);
+  z = s * s;
+  w = z * z;
+  t1 = w * (VM_LG2 + w * (VM_LG4 + w * VM_LG6));
+  t2 = z * (VM_LG1 + w * (VM_LG3 + w * (VM_LG5 + w * VM_LG7)));
+  hfsq = 0.5 * f * f;
+  r = kd * VM_LN2HI -
+      ((hfsq - (s * (hfsq + (t1 + t2)) + kd * VM_LN2LO)) - f);
+  m = VM(logbad)(x);
+  if (VM(any)(m))
+    VM_FIX1(r, m, log, x);
+  return r;
+}
+
+/* pow(x, y) = exp(y*log(x)), where log(x) = k*ln2 + 2*atanh(s),
+ * s = f/(2 + f), is formed in double-double arithmetic: s = sh + sl,
+ * the leading term 2*s^3/3 of the atanh series is exact to about 2^-100
+ * and the rest of the series, truncated after s^25 (|s| < 0.172), and
+ * the sl terms are added to the low part.
+ */
+VM_INLINE VD VM(dpow)(VD x, VD y)
+{
+  VD kd, f, dh, dl, sh, sl, e, z, zl, s3, s3l, th, tl, t, a, b, hi, lo, lh,
+      ll, ph, pl, r;
+  VL m;
+
+  f = VM(logred)(x, &kd);
+  dh = 2.0 + f;
+  dl = f - (dh - 2.0);
+  sh = f / dh;
+  a = VM(twoprod)(sh, dh, &e);
+  sl = (((f - a) - e) - sh * dl) / dh;
+  z = VM(twoprod)(sh, sh, &zl);
+  s3 = VM(twoprod)(sh, z, &e);
+  s3l = e + sh * zl;
+  th = VM(twoprod)(s3, VM(bc)(VM_C23H), &e);
+  tl = e + (s3l * VM_C23H + s3 * VM_C23L);
+  t = 2.0 / 23 + z * (2.0 / 25);
+  t = 2.0 / 21 + z * t;
+  t = 2.0 / 19 + z * t;
+  t = 2.0 / 17 + z * t;
+  t = 2.0 / 15 + z * t;
+  t = 2.0 / 13 + z * t;
+  t = 2.0 / 11 + z * t;
+  t = 2.0 / 9 + z * t;
+  t = 2.0 / 7 + z * t;
+  t = 2.0 / 5 + z * t;
+  t = (s3 * z * t + 2.0 * sl * (1.0 + z)) + tl;
+
+  a = kd * VM_LN2HI;
+  b = 2.0 * sh;
+  hi = a + b;
+  z = hi - a;
+  lo = (a - (hi - z)) + (b - z);
+  a = hi;
+  hi = a + th;
+  z = hi - a;
+  lo = lo + ((a - (hi - z)) + (th - z));
+  lo = lo + (t + kd * VM_LN2LO);
+  lh = hi + lo;
+  ll = lo - (lh - hi);
+
+  ph = VM(twoprod)(y, lh, &e);
+  pl = e + y * ll;
+  r = VM(expk)(ph);
+  r = r + r * pl;
+  m = VM(logbad)(x) | ~(VM(abs)(y) < __builtin_inf()) |
+      ~(VM(abs)(ph) <= 708.0);
+  if (VM(any)(m))
+    VM_FIX2(r, m, pow, x, y);
+  return r;
+}
+
+/* sin(x) and cos(x); which is 1 for sin only, 2 for cos only, 3 for both. */
+VM_INLINE void VM(dsincosk)(VD x, VD *sn, VD *cs, int which)
+{
+  VD nd, t, w, e, r, y, z, v, ks, kc, hz;
+  VL n, odd, m;
+
+  /* The three iterations of fdlibm's __ieee754_rem_pio2 for medium
+   * arguments, each keeping the rounding error of its subtraction;
+   * r + y is x - n*pi/2 to about 2^-140.
+   */
+  nd = VM(rint)(x * VM_INVPIO2, &n);
+  t = x - nd * VM_PIO2_1;
+  w = nd * VM_PIO2_2;
+  r = t - w;
+  e = (t - r) - w;
+  t = r;
+  w = nd * VM_PIO2_3;
+  r = t - w;
+  e = e + ((t - r) - w);
+  w = nd * VM_PIO2_3T - e;
+  t = r;
+  r = t - w;
+  y = (t - r) - w;
+
+  z = r * r;
+  v = z * r;
+  ks = VM_S2 + z * (VM_S3 + z * (VM_S4 + z * (VM_S5 + z * VM_S6)));
+  ks = r - ((z * (0.5 * y - v * ks) - y) - v * VM_S1);
+  kc = z * (VM_C1 +
+               z * (VM_C2 +
+                       z * (VM_C3 + z * (VM_C4 + z * (VM_C5 + z * VM_C6)))));
+  hz = 0.5 * z;
+  w = 1.0 - hz;
+  kc = w + (((1.0 - w) - hz) + (z * kc - r * y));
+
+  odd = (n & 1) != 0;
+  m = ~(VM(abs)(x) <= VM_TRIG_MAX);
+  if (which & 1) {
+    *sn = (VD)((VL)VM(sel)(odd, kc, ks) ^ ((n & 2) << 62));
+    if (VM(any)(m))
+      VM_FIX1((*sn), m, sin, x);
+  }
+  if (which & 2) {
+    *cs = (VD)((VL)VM(sel)(odd, ks, kc) ^ (((n + 1) & 2) << 62));
+    if (VM(any)(m))
+      VM_FIX1((*cs), m, cos, x);
+  }
+}
+
+VM_INLINE VD VM(dsin)(VD x)
+{
+  VD s;
+
+  VM(dsincosk)(x, &s, 0, 1);
+  return s;
+}
+
+VM_INLINE VD VM(dcos)(VD x)
+{
+  VD c;
+
+  VM(dsincosk)(x, 0, &c, 2);
+  return c;
+}
+
+VM_INLINE void VM(dsincos)(VD x, VD *s, VD *c)
+{
+  VM(dsincosk)(x, s, c, 3);
+}
+
+/* tanh(x) = e/(e + 2), e = expm1(2|x|); tanh is 1 in double above 22. */
+VM_INLINE VD VM(dtanh)(VD x)
+{
+  VD a, hi, lo, q, e, s;
+  VL k;
+
+  a = VM(abs)(x);
+  a = VM(sel)(a > 22.0, VM(bc)(22.0), a);
+  q = VM(expm1r)(2.0 * a, &k, &hi, &lo);
+  e = hi - (lo - q);
+  s = (VD)((k + 1023) << 52);
+  e = s * e + (s - 1.0);
+  /* divide by e + 2 kept in two pieces */
+  hi = e + 2.0;
+  lo = hi - e;
+  lo = (e - (hi - lo)) + (2.0 - lo);
+  q = e / hi;
+  e = q - q * (lo / hi);
+  return (VD)((VL)e | ((VL)x & VM_SIGN_MASK));
+}
+
+/* erf as in s_erf.c: a rational approximation on [0, 0.84375), one
+ * around 1 on [0.84375, 1.25) and 1 - exp(-x*x - 0.5625 + R/S)/x above,
+ * where |x| is clamped to 6.  The lanes evaluate all three.
+ */
+VM_INLINE VD VM(derf)(VD x)
+{
+  VD a, z, r, s, y, p, q, e;
+  VL big;
+
+  a = VM(abs)(x);
+
+  z = a * a;
+  r = 1.28379167095512558561e-01 +
+      z * (-3.25042107247001499370e-01 +
+              z * (-2.84817495755985104766e-02 +
+                      z * (-5.77027029648944159157e-03 +
+                              z * -2.37630166566501626084e-05)));
+  s = 1.0 + z * (3.97917223959155352819e-01 +
+                    z * (6.50222499887672944485e-02 +
+                            z * (5.08130628187576562776e-03 +
+                                    z * (1.32494738004321644526e-04 +
+                                            z * -3.96022827877536812320e-06))));
+  y = a + a * (r / s);
+
+  s = a - 1.0;
+  p = -2.36211856075265944077e-03 +
+      s * (4.14856118683748331666e-01 +
+              s * (-3.72207876035701323847e-01 +
+                      s * (3.18346619901161753674e-01 +
+                              s * (-1.10894694282396677476e-01 +
+                                      s * (3.54783043256182359371e-02 +
+                                              s * -2.16637559486879084300e-03)))));
+  q = 1.0 +
+      s * (1.06420880400844228286e-01 +
+              s * (5.40397917702171048937e-01 +
+                      s * (7.18286544141962662868e-02 +
+                              s * (1.26171219808761642112e-01 +
+                                      s * (1.36370839120290507362e-02 +
+                                              s * 1.19844998467991074170e-02)))));
+  p = 8.45062911510467529297e-01 + p / q;
+  y = VM(sel)(a < 0.84375, y, p);
+
+  a = VM(sel)(a > 6.0, VM(bc)(6.0), a);
+  s = 1.0 / (a * a);
+  big = a >= 0x1.6db6ep+1; /* 1/0.35 */
+#define VM_ERFC(ra, rb) VM(sel)(big, VM(bc)(rb), VM(bc)(ra))
+  p = VM_ERFC(-9.81432934416914548592e+00, 0.0);
+  p = VM_ERFC(-8.12874355063065934246e+01, -4.83519191608651397019e+02) + s * p;
+  p = VM_ERFC(-1.84605092906711035994e+02, -1.02509513161107724954e+03) + s * p;
+  p = VM_ERFC(-1.62396669462573470355e+02, -6.37566443368389627722e+02) + s * p;
+  p = VM_ERFC(-6.23753324503260060396e+01, -1.60636384855821916062e+02) + s * p;
+  p = VM_ERFC(-1.05586262253232909814e+01, -1.77579549177547519889e+01) + s * p;
+  p = VM_ERFC(-6.93858572707181764372e-01, -7.99283237680523006574e-01) + s * p;
+  p = VM_ERFC(-9.86494403484714822705e-03, -9.86494292470009928597e-03) + s * p;
+  q = VM_ERFC(-6.04244152148580987438e-02, 0.0);
+  q = VM_ERFC(6.57024977031928170135e+00, -2.24409524465858183362e+01) + s * q;
+  q = VM_ERFC(1.08635005541779435134e+02, 4.74528541206955367215e+02) + s * q;
+  q = VM_ERFC(4.29008140027567833386e+02, 2.55305040643316442583e+03) + s * q;
+  q = VM_ERFC(6.45387271733267880336e+02, 3.19985821950859553908e+03) + s * q;
+  q = VM_ERFC(4.34565877475229228821e+02, 1.53672958608443695994e+03) + s * q;
+  q = VM_ERFC(1.37657754143519042600e+02, 3.25792512996573918826e+02) + s * q;
+  q = VM_ERFC(1.96512716674392571292e+01, 3.03380607434824582924e+01) + s * q;
+#undef VM_ERFC
+  q = 1.0 + s * q;
+  z = (VD)((VL)a & 0xffffffff00000000LL);
+  e = VM(expk)(-z * z - 0.5625) * VM(expk)((z - a) * (z + a) + p / q);
+  e = 1.0 - e / a;
+  y = VM(sel)(VM(abs)(x) < 1.25, y, e);
+  return (VD)((VL)y | ((VL)x & VM_SIGN_MASK));
+}
+
+VM_INLINE VD VM(dsqrt)(VD x)
+{
+  VD r;
+  int i;
+
+  for (i = 0; i < VM_N; ++i)
+    r[i] = __builtin_sqrt(x[i]);
+  return r;
+}
+
+/* Single precision: widen, evaluate in double and round once. */
+#define VM_SFN1(fn)                                                            \
+  VM_INLINE VS VM(s##fn)(VS x)                                             \
+  {                                                                            \
+    return __builtin_convertvector(VM(d##fn)(__builtin_convertvector(x, VD)),  \
+                                   VS);                                        \
+  }
+
+VM_SFN1(exp)
+VM_SFN1(log)
+VM_SFN1(sin)
+VM_SFN1(cos)
+VM_SFN1(tanh)
+VM_SFN1(erf)
+#undef VM_SFN1
+
+VM_INLINE VS VM(spow)(VS x, VS y)
+{
+  return __builtin_convertvector(
+      VM(dpow)(__builtin_convertvector(x, VD), __builtin_convertvector(y, VD)),
+      VS);
+}
+
+VM_INLINE void VM(ssincos)(VS x, VS *s, VS *c)
+{
+  VD ds, dc;
+
+  VM(dsincos)(__builtin_convertvector(x, VD), &ds, &dc);
+  *s = __builtin_convertvector(ds, VS);
+  *c = __builtin_convertvector(dc, VS);
+}
+
+VM_INLINE VS VM(ssqrt)(VS x)
+{
+  VS r;
+  int i;
+
+  for (i = 0; i < VM_N; ++i)
+    r[i] = __builtin_sqrtf(x[i]);
+  return r;
+}
+
+#undef VD
+#undef VS
+#undef VL
+#undef VM
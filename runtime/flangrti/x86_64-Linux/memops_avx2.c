@@ -0,0 +1,40 @@
+/*
+ * Copyright (c) 2017, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/* Copy and fill kernels compiled with -mavx2, which memops.c selects on
+ * processors that have AVX2.
+ */
+
+#include <immintrin.h>
+
+#define MK_STREAM(p, v) _mm256_stream_si256((__m256i *)(p), (__m256i)(v))
+#define MK_FENCE() _mm_sfence()
+#define MK_W 32
+#include "memkern.h"
+#undef MK_W
+
+void
+__c_mcopy_avx2(char *dest, const char *src, size_t n, int nt)
+{
+  mk_copy32(dest, src, n, nt);
+}
+
+void
+__c_mfill_avx2(char *dest, const unsigned char pat[8], size_t n, int nt)
+{
+  mk_fill32(dest, pat, n, nt);
+}
@@ -0,0 +1,36 @@
+/*
+ * Copyright (c) 2017, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/* Vector math kernels compiled with -mavx2 -mfma: the 256-bit entry
+ * points __fvd_<fn>_4 and __fvs_<fn>_8, and the 128-bit kernels that
+ * vmath_sse2.c selects on processors that have AVX2 and FMA.
+ */
+
+#define VM_N 2
+#include "vmath.h"
+#undef VM_N
+#define VM_N 4
+#include "vmath.h"
+#undef VM_N
+#define VM_N 8
+#include "vmath.h"
+#undef VM_N
+
+VM_ENTRIES(d, 2, _fma)
+VM_ENTRIES(s, 4, _fma)
+VM_ENTRIES(d, 4, )
+VM_ENTRIES(s, 8, )
@@ -0,0 +1,30 @@
+/*
+ * Copyright (c) 2017, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/* Vector math kernels compiled with -mavx512f -mfma: the 512-bit entry
+ * points __fvd_<fn>_8 and __fvs_<fn>_16.
+ */
+
+#define VM_N 8
+#include "vmath.h"
+#undef VM_N
+#define VM_N 16
+#include "vmath.h"
+#undef VM_N
+
+VM_ENTRIES(d, 8, )
+VM_ENTRIES(s, 16, )
@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2017, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/* 128-bit vector math entry points: __fvd_<fn>_2 and __fvs_<fn>_4.
+ * They run the SSE2 kernels compiled here, or the FMA kernels in
+ * vmath_avx2.c on processors with AVX2 and FMA.
+ */
+
+#define VM_N 2
+#include "vmath.h"
+#undef VM_N
+#define VM_N 4
+#include "vmath.h"
+#undef VM_N
+
+static int vm_fma = -1;
+
+static int
+vm_use_fma(void)
+{
+  if (vm_fma < 0) {
+    __builtin_cpu_init();
+    vm_fma = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+  }
+  return vm_fma;
+}
+
+#define VM_PICK1(t, fn, n)                                                     \
+  extern VM_V(t, n) __fv##t##_##fn##_##n##_fma(VM_V(t, n));                    \
+  VM_V(t, n) __fv##t##_##fn##_##n(VM_V(t, n) x)                                \
+  {                                                                            \
+    if (vm_use_fma())                                                          \
+      return __fv##t##_##fn##_##n##_fma(x);                                    \
+    return VM_K(t, fn, n)(x);                                                  \
+  }
+
+#define VM_PICK2(t, fn, n)                                                     \
+  extern VM_V(t, n) __fv##t##_##fn##_##n##_fma(VM_V(t, n), VM_V(t, n));        \
+  VM_V(t, n) __fv##t##_##fn##_##n(VM_V(t, n) x, VM_V(t, n) y)                  \
+  {                                                                            \
+    if (vm_use_fma())                                                          \
+      return __fv##t##_##fn##_##n##_fma(x, y);                                 \
+    return VM_K(t, fn, n)(x, y);                                               \
+  }
+
+#define VM_PICKSC(t, n)                                                        \
+  extern void __fv##t##_sincos_##n##_fma(VM_V(t, n), VM_V(t, n) *,             \
+                                         VM_V(t, n) *);                        \
+  void __fv##t##_sincos_##n(VM_V(t, n) x, VM_V(t, n) *s, VM_V(t, n) *c)        \
+  {                                                                            \
+    if (vm_use_fma())                                                          \
+      __fv##t##_sincos_##n##_fma(x, s, c);                                     \
+    else                                                                       \
+      VM_K(t, sincos, n)(x, s, c);                                             \
+  }
+
+#define VM_PICKS(t, n)                                                         \
+  VM_PICK1(t, exp, n)                                                          \
+  VM_PICK1(t, log, n)                                                          \
+  VM_PICK2(t, pow, n)                                                          \
+  VM_PICK1(t, sin, n)                                                          \
+  VM_PICK1(t, cos, n)                                                          \
+  VM_PICKSC(t, n)                                                              \
+  VM_PICK1(t, tanh, n)                                                         \
+  VM_PICK1(t, erf, n)
+
+VM_PICKS(d, 2)
+VM_PICKS(s, 4)
+
+/* sqrt is one instruction either way. */
+VM_ENTRY1(d, sqrt, 2, )
+VM_ENTRY1(s, sqrt, 4, )
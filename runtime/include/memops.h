@@ -19,6 +19,8 @@
  * \brief Various memory operations
  */
 
+#include <stddef.h>
+
 void __c_mcopy1(char *dest, char *src, long cnt);
 void __c_mcopy2(short *dest, short *src, long cnt);
 void __c_mcopy4(int *dest, int *src, long cnt);
@@ -33,3 +35,10 @@ void __c_mzero1(char *dest, long cnt);
 void __c_mzero2(short *dest, long cnt);
 void __c_mzero4(int *dest, long cnt);
 void __c_mzero8(long long *dest, long cnt);
+
+/* Copy or fill cnt elements of size bytes each, cnt > 0; the fill value
+ * is the size bytes at elem.  The kernels are chosen for the processor
+ * and use non-temporal stores for large destinations (see memops.c).
+ */
+void __c_mcopy(void *dest, const void *src, size_t size, long cnt);
+void __c_mfill(void *dest, const void *elem, size_t size, long cnt);
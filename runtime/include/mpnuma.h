@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2017, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/** \file
+ * \brief NUMA placement of allocated memory (flangrti numa.c)
+ */
+
+#include <stddef.h>
+
+/* placement policies; F90_NUMA selects one for all large allocations */
+#define MP_NUMA_DEFAULT 0    /* the process's policy, normally first touch */
+#define MP_NUMA_LOCAL 1      /* the node of the thread that touches a page */
+#define MP_NUMA_INTERLEAVE 2 /* round robin over the memory nodes */
+
+/** \brief Number of memory nodes the process may use, 1 without NUMA */
+int _mp_numa_nodes(void);
+
+/** \brief Give the whole pages in [p, p + n) the placement policy */
+void _mp_numa_place(void *p, size_t n, int policy);
+
+/** \brief Touch the pages in [p, p + n) in parallel, one contiguous part per
+ * node in node order; each page has one byte read and written back, so the
+ * contents of the memory are kept.
+ */
+void _mp_numa_touch(void *p, size_t n);
+
+/** \brief Place and touch memory just allocated, as F90_NUMA,
+ * F90_NUMA_MINSZ and F90_NUMA_TOUCH ask.
+ */
+void _mp_numa_newmem(void *p, size_t n);
+
+/** \brief _mp_malloc with a placement policy, whatever the size */
+void *_mp_malloc_numa(size_t n, int policy);
@@ -0,0 +1,95 @@
+!
+! Copyright (c) 2017, NVIDIA CORPORATION.  All rights reserved.
+!
+! Licensed under the Apache License, Version 2.0 (the "License");
+! you may not use this file except in compliance with the License.
+! You may obtain a copy of the License at
+!
+!     http://www.apache.org/licenses/LICENSE-2.0
+!
+! Unless required by applicable law or agreed to in writing, software
+! distributed under the License is distributed on an "AS IS" BASIS,
+! WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+! See the License for the specific language governing permissions and
+! limitations under the License.
+!
+
+! RUN: %clang -c %S/check.c -o %t1
+! RUN: %flang -c -I%S -lm %s -o %t2
+! RUN: %flang -I%S -lm %t2 %t1 -o %t3
+! RUN: %t3 | tee %t4 &&  grep '  10 tests completed. 10 tests PASSED. 0 tests failed.' %t4
+
+! Character assignments whose right-hand side overlaps the left-hand side,
+! through the same variable, a pointer, EQUIVALENCE or reallocation.
+! Each result is 1 if the assignment gave the value computed from a copy
+! of the operands.
+
+program p
+  implicit none
+  integer, parameter :: n = 10
+  integer rslts(n), expect(n)
+  character(10) s, u
+  character(12), target :: t
+  character(:), pointer :: q1, q2
+  character(6), pointer :: q6
+  character(8) e1, e2
+  equivalence (e1, e2)
+  character(:), allocatable :: c
+  integer, external :: ival
+
+  expect = 1
+
+  s = 'abcdefghij'
+  s = s(2:) // s
+  rslts(1) = merge(1, 0, s == 'bcdefghija')
+
+  s = 'abcdefghij'
+  s = '<' // s(1:ival(4)) // s
+  rslts(2) = merge(1, 0, s == '<abcdabcde')
+
+  s = 'abcdefghij'
+  s(3:10) = s(1:ival(4)) // s(1:ival(4))
+  rslts(3) = merge(1, 0, s == 'ababcdabcd')
+
+  t = 'abcdefghijkl'
+  q1 => t(3:8)
+  t = q1 // q1
+  rslts(4) = merge(1, 0, t == 'cdefghcdefgh')
+
+  t = 'abcdefghijkl'
+  q1 => t(1:6)
+  q2 => t(3:8)
+  q1 = q2 // 'xy'
+  rslts(5) = merge(1, 0, t == 'cdefghghijkl')
+
+  t = 'abcdefghijkl'
+  q6 => t(5:10)
+  q6 = t(1:ival(3)) // t
+  rslts(6) = merge(1, 0, t == 'abcdabcabckl')
+
+  t = 'abcdefghijkl'
+  q1 => t(2:12)
+  t = 'z' // q1
+  rslts(7) = merge(1, 0, t == 'zbcdefghijkl')
+
+  e1 = 'abcdefgh'
+  e1 = 'x' // e2
+  rslts(8) = merge(1, 0, e2 == 'xabcdefg')
+
+  c = 'abcdef'
+  c = c(ival(3):) // c
+  rslts(9) = merge(1, 0, c == 'cdefabcdef')
+
+  u = 'abcdefghij'
+  s = u
+  s = s(ival(6):) // s(1:ival(5))
+  rslts(10) = merge(1, 0, s == 'fghijabcde')
+
+  call check(rslts, expect, n)
+
+end program
+
+integer function ival(i)
+  integer i
+  ival = i
+end function
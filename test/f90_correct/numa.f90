@@ -0,0 +1,63 @@
+!
+! Copyright (c) 2017, NVIDIA CORPORATION.  All rights reserved.
+!
+! Licensed under the Apache License, Version 2.0 (the "License");
+! you may not use this file except in compliance with the License.
+! You may obtain a copy of the License at
+!
+!     http://www.apache.org/licenses/LICENSE-2.0
+!
+! Unless required by applicable law or agreed to in writing, software
+! distributed under the License is distributed on an "AS IS" BASIS,
+! WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+! See the License for the specific language governing permissions and
+! limitations under the License.
+!
+
+
+! RUN: %clang -c %S/check.c -o %t1
+! RUN: %flang -c -I%S -lm %s -o %t2
+! RUN: %flang -I%S -lm %t2 %t1 -o %t3
+! RUN: %t3 | tee %t4 &&  grep '  4 tests completed. 4 tests PASSED. 0 tests failed.' %t4
+
+! The NUMA routines of the runtime must reach the kernel: get_mempolicy
+! with MPOL_F_MEMS_ALLOWED succeeds, numa_available says so, and
+! numa_nodes counts the nodes of the mask it returns.  numa_touch keeps
+! the contents of the array it touches.
+
+program p
+  implicit none
+  interface
+    integer(8) function get_mempolicy(mode, nmask, maxnode, addr, flags) &
+        bind(c)
+      integer(4) :: mode
+      integer(8) :: nmask(*)
+      integer(8), value :: maxnode, addr, flags
+    end function
+    integer(4) function numa_available() bind(c)
+    end function
+  end interface
+  integer(8), parameter :: mpol_f_mems_allowed = 4
+  integer, parameter :: n = 4
+  integer rslts(n), expect(n), mode, i
+  integer(8) :: mask(16)
+  integer(8) :: nbytes
+  real(8), allocatable :: a(:)
+  integer, external :: numa_nodes
+
+  mask = 0
+  rslts(1) = get_mempolicy(mode, mask, 1025_8, 0_8, mpol_f_mems_allowed)
+  rslts(2) = numa_available()
+  rslts(3) = sum(popcnt(mask)) - numa_nodes()
+
+  allocate(a(1000000))
+  do i = 1, size(a)
+    a(i) = i
+  end do
+  nbytes = 8 * size(a)
+  call numa_touch(a, nbytes)
+  rslts(4) = count(a /= (/(real(i, 8), i = 1, size(a))/))
+
+  expect = 0
+  call check(rslts, expect, n)
+end program
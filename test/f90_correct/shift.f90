@@ -0,0 +1,289 @@
+!
+! Copyright (c) 2017, NVIDIA CORPORATION.  All rights reserved.
+!
+! Licensed under the Apache License, Version 2.0 (the "License");
+! you may not use this file except in compliance with the License.
+! You may obtain a copy of the License at
+!
+!     http://www.apache.org/licenses/LICENSE-2.0
+!
+! Unless required by applicable law or agreed to in writing, software
+! distributed under the License is distributed on an "AS IS" BASIS,
+! WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+! See the License for the specific language governing permissions and
+! limitations under the License.
+!
+
+! RUN: %clang -c %S/check.c -o %t1
+! RUN: %flang -c -I%S -lm %s -o %t2
+! RUN: %flang -I%S -lm %t2 %t1 -o %t3
+! RUN: %t3 | tee %t4 &&  grep '  24 tests completed. 24 tests PASSED. 0 tests failed.' %t4
+
+! CSHIFT, EOSHIFT and TRANSPOSE of contiguous arrays, which take the block
+! copy paths of the runtime, and of non-contiguous sections, which take
+! the general paths, with positive and negative shifts and shifts of at
+! least the extent.  SHIFT and DIM are not constants so that the runtime
+! is called.  Each result is the number of elements that differ from the
+! value computed element by element.
+
+program p
+  implicit none
+  integer, parameter :: n = 24
+  integer rslts(n), expect(n)
+  integer a(7, 5, 3), r(7, 5, 3), x(7, 5, 3), sh(5, 3), sv(7, 3)
+  integer t(9, 4), tt(4, 9)
+  real(8) d(6, 5), dt(5, 6)
+  character(2) c(6, 4), cr(6, 4)
+  integer i, j, k, l, e, bd
+  integer, external :: ival
+
+  do k = 1, 3
+    do j = 1, 5
+      do i = 1, 7
+        a(i, j, k) = 100 * i + 10 * j + k
+      end do
+    end do
+  end do
+  do j = 1, 4
+    do i = 1, 9
+      t(i, j) = 10 * i + j
+    end do
+  end do
+  do j = 1, 5
+    do i = 1, 6
+      d(i, j) = i + 0.25d0 * j
+    end do
+  end do
+  do j = 1, 4
+    do i = 1, 6
+      c(i, j) = achar(64 + i) // achar(96 + j)
+    end do
+  end do
+  do k = 1, 3
+    do j = 1, 5
+      sh(j, k) = 3 * j - 2 * k - 4
+    end do
+    do i = 1, 7
+      sv(i, k) = i - 2 * k
+    end do
+  end do
+  bd = -1
+  expect = 0
+
+  ! CSHIFT by a scalar: each dimension, negative, zero and at least the
+  ! extent, then non-contiguous sections
+
+  r = cshift(a, ival(2), ival(1))
+  rslts(1) = ncsh(r, a, 2, 1)
+  r = cshift(a, ival(-3), ival(2))
+  rslts(2) = ncsh(r, a, -3, 2)
+  r = cshift(a, ival(7), ival(3))
+  rslts(3) = ncsh(r, a, 7, 3)
+  r = cshift(a, ival(-16), ival(1))
+  rslts(4) = ncsh(r, a, -16, 1)
+  r = cshift(a, ival(0), ival(2))
+  rslts(5) = ncsh(r, a, 0, 2)
+
+  r = 0
+  r(1:4, :, :) = cshift(a(1:7:2, :, :), ival(5), ival(1))
+  rslts(6) = 0
+  do k = 1, 3
+    do j = 1, 5
+      do i = 1, 4
+        if (r(i, j, k) /= a(2 * mod(i, 4) + 1, j, k)) &
+          rslts(6) = rslts(6) + 1
+      end do
+    end do
+  end do
+
+  r = 0
+  r(2:6, :, :) = cshift(a(2:6, :, :), ival(-4), ival(2))
+  rslts(7) = 0
+  do k = 1, 3
+    do j = 1, 5
+      do i = 2, 6
+        if (r(i, j, k) /= a(i, modulo(j - 4 - 1, 5) + 1, k)) &
+          rslts(7) = rslts(7) + 1
+      end do
+    end do
+  end do
+
+  ! CSHIFT by an array: along the first and second dimensions, shifts
+  ! beyond the extent in both directions, and a non-contiguous array
+
+  r = cshift(a, sh, ival(1))
+  rslts(8) = 0
+  do k = 1, 3
+    do j = 1, 5
+      do i = 1, 7
+        if (r(i, j, k) /= a(modulo(i + sh(j, k) - 1, 7) + 1, j, k)) &
+          rslts(8) = rslts(8) + 1
+      end do
+    end do
+  end do
+
+  r = cshift(a, sv, ival(2))
+  rslts(9) = 0
+  do k = 1, 3
+    do j = 1, 5
+      do i = 1, 7
+        if (r(i, j, k) /= a(i, modulo(j + sv(i, k) - 1, 5) + 1, k)) &
+          rslts(9) = rslts(9) + 1
+      end do
+    end do
+  end do
+
+  r = 0
+  r(1:5, :, :) = cshift(a(3:7, :, :), sh, ival(1))
+  rslts(10) = 0
+  do k = 1, 3
+    do j = 1, 5
+      do i = 1, 5
+        if (r(i, j, k) /= a(modulo(i + sh(j, k) - 1, 5) + 3, j, k)) &
+          rslts(10) = rslts(10) + 1
+      end do
+    end do
+  end do
+
+  ! EOSHIFT by a scalar with a scalar BOUNDARY: each dimension, negative,
+  ! at least the extent in both directions, default boundary
+
+  r = eoshift(a, ival(2), bd, ival(1))
+  rslts(11) = neosh(r, a, 2, 1, -1)
+  r = eoshift(a, ival(-3), bd, ival(2))
+  rslts(12) = neosh(r, a, -3, 2, -1)
+  r = eoshift(a, ival(3), bd, ival(3))
+  rslts(13) = neosh(r, a, 3, 3, -1)
+  r = eoshift(a, ival(-9), bd, ival(1))
+  rslts(14) = neosh(r, a, -9, 1, -1)
+  r = eoshift(a, ival(5), dim = ival(2))
+  rslts(15) = neosh(r, a, 5, 2, 0)
+
+  cr = eoshift(c, ival(-2), 'zz', ival(2))
+  rslts(16) = 0
+  do j = 1, 4
+    do i = 1, 6
+      if (j > 2) then
+        if (cr(i, j) /= c(i, j - 2)) rslts(16) = rslts(16) + 1
+      else
+        if (cr(i, j) /= 'zz') rslts(16) = rslts(16) + 1
+      end if
+    end do
+  end do
+
+  ! EOSHIFT of non-contiguous sections
+
+  r = 0
+  r(1:4, :, :) = eoshift(a(1:7:2, :, :), ival(1), bd, ival(1))
+  rslts(17) = 0
+  do k = 1, 3
+    do j = 1, 5
+      do i = 1, 4
+        e = -1
+        if (i < 4) e = a(2 * i + 1, j, k)
+        if (r(i, j, k) /= e) rslts(17) = rslts(17) + 1
+      end do
+    end do
+  end do
+
+  r = 0
+  r(1:6, 1:4, :) = eoshift(a(2:7, 2:5, :), ival(-2), bd, ival(2))
+  rslts(18) = 0
+  do k = 1, 3
+    do j = 1, 4
+      do i = 1, 6
+        e = -1
+        if (j > 2) e = a(i + 1, j - 1, k)
+        if (r(i, j, k) /= e) rslts(18) = rslts(18) + 1
+      end do
+    end do
+  end do
+
+  ! TRANSPOSE: 4-byte, 8-byte and 2-byte elements, non-contiguous and
+  ! negative-stride sources
+
+  tt = transpose(t)
+  rslts(19) = count(tt /= reshape((/((t(i, j), i = 1, 9), j = 1, 4)/), &
+                                  (/4, 9/), order = (/2, 1/)))
+  dt = transpose(d)
+  rslts(20) = 0
+  do j = 1, 6
+    do i = 1, 5
+      if (dt(i, j) /= d(j, i)) rslts(20) = rslts(20) + 1
+    end do
+  end do
+
+  tt = 0
+  tt(1:4, 1:4) = transpose(t(2:8:2, :))
+  rslts(21) = 0
+  do j = 1, 4
+    do i = 1, 4
+      if (tt(i, j) /= t(2 * j, i)) rslts(21) = rslts(21) + 1
+    end do
+  end do
+
+  tt = transpose(t(9:1:-1, 4:1:-1))
+  rslts(22) = 0
+  do j = 1, 9
+    do i = 1, 4
+      if (tt(i, j) /= t(10 - j, 5 - i)) rslts(22) = rslts(22) + 1
+    end do
+  end do
+
+  ! in-place: the result overlaps the source
+
+  x = a
+  x = cshift(x, ival(3), ival(1))
+  rslts(23) = ncsh(x, a, 3, 1)
+  x = a
+  x = eoshift(x, ival(-2), bd, ival(3))
+  rslts(24) = neosh(x, a, -2, 3, -1)
+
+  call check(rslts, expect, n)
+
+contains
+
+  ! element i of y along dimension dm must be element i + s of x, taken
+  ! circularly
+  integer function ncsh(y, x, s, dm)
+    integer y(:, :, :), x(:, :, :), s, dm
+    integer i, j, k, ix(3)
+    ncsh = 0
+    do k = 1, size(y, 3)
+      do j = 1, size(y, 2)
+        do i = 1, size(y, 1)
+          ix = (/i, j, k/)
+          ix(dm) = modulo(ix(dm) + s - 1, size(x, dm)) + 1
+          if (y(i, j, k) /= x(ix(1), ix(2), ix(3))) ncsh = ncsh + 1
+        end do
+      end do
+    end do
+  end function
+
+  ! as ncsh, end-off, with boundary bnd shifted in
+  integer function neosh(y, x, s, dm, bnd)
+    integer y(:, :, :), x(:, :, :), s, dm, bnd
+    integer i, j, k, e, ix(3)
+    neosh = 0
+    do k = 1, size(y, 3)
+      do j = 1, size(y, 2)
+        do i = 1, size(y, 1)
+          ix = (/i, j, k/)
+          ix(dm) = ix(dm) + s
+          if (ix(dm) >= 1 .and. ix(dm) <= size(x, dm)) then
+            e = x(ix(1), ix(2), ix(3))
+          else
+            e = bnd
+          end if
+          if (y(i, j, k) /= e) neosh = neosh + 1
+        end do
+      end do
+    end do
+  end function
+
+end program
+
+integer function ival(i)
+  integer i
+  ival = i
+end function
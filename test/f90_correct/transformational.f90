@@ -0,0 +1,302 @@
+!
+! Copyright (c) 2017, NVIDIA CORPORATION.  All rights reserved.
+!
+! Licensed under the Apache License, Version 2.0 (the "License");
+! you may not use this file except in compliance with the License.
+! You may obtain a copy of the License at
+!
+!     http://www.apache.org/licenses/LICENSE-2.0
+!
+! Unless required by applicable law or agreed to in writing, software
+! distributed under the License is distributed on an "AS IS" BASIS,
+! WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+! See the License for the specific language governing permissions and
+! limitations under the License.
+!
+
+! RUN: %clang -c %S/check.c -o %t1
+! RUN: %flang -c -I%S -lm %s -o %t2
+! RUN: %flang -I%S -lm %t2 %t1 -o %t3
+! RUN: %t3 | tee %t4 &&  grep '  30 tests completed. 30 tests PASSED. 0 tests failed.' %t4
+
+! PACK, UNPACK, RESHAPE, SPREAD and TRANSFER of contiguous and evenly
+! spaced sections, which take the block-copy paths of the runtime, and of
+! negative-stride, unevenly spaced and zero-size ones, which take the
+! general paths.  The intrinsics are applied to the sections directly so
+! that the runtime sees their strides.  Each result is the number of
+! elements that differ from the value computed element by element.
+
+program p
+  implicit none
+  integer, parameter :: n = 30
+  integer rslts(n), expect(n)
+  integer a(48), b(6, 8), v(48), r(48), ref(48), idx(48), i, j, k, nt
+  integer y3(4, 3, 2), y2(5, 6), yo(6, 8), yt(96), z(3), w(2)
+  integer, allocatable :: s3(:, :, :)
+  logical m(48), m2(6, 8)
+  logical(1) m1(48)
+  real(8) d(48), dr(48)
+  character(3) c(48), cr(48)
+  integer(2) h(48), hr(48)
+  integer, external :: ival
+
+  do i = 1, 48
+    a(i) = i * 7
+    v(i) = -i
+    d(i) = i + 0.5d0
+    c(i) = achar(64 + mod(i, 26)) // achar(97 + mod(i, 26)) // '#'
+    h(i) = 1000 - i
+    m(i) = mod(i, 3) /= 0
+    m1(i) = mod(i, 4) == 1
+  end do
+  do j = 1, 8
+    do i = 1, 6
+      b(i, j) = 100 * i + j
+      m2(i, j) = mod(i + j, 2) == 0
+    end do
+  end do
+  expect = 0
+
+  ! PACK: contiguous, strided array and result, negative stride, VECTOR,
+  ! scalar MASK, 8-byte and 3-byte elements, 2-D uneven section, zero size
+
+  call trues(m, idx, nt)
+  r = 0
+  r(1:nt) = pack(a, m)
+  rslts(1) = count(r(1:nt) /= a(idx(1:nt)))
+
+  call trues(m(2:48:2), idx, nt)
+  r = 0
+  r(1:nt) = pack(a(1:48:2), m(2:48:2))
+  rslts(2) = count(r(1:nt) /= a(2 * idx(1:nt) - 1))
+  r = 0
+  r(1:2 * nt - 1:2) = pack(a(1:48:2), m(2:48:2))
+  rslts(3) = count(r(1:2 * nt - 1:2) /= a(2 * idx(1:nt) - 1))
+
+  call trues(m, idx, nt)
+  r(1:nt) = pack(a(48:1:-1), m)
+  rslts(4) = count(r(1:nt) /= a(49 - idx(1:nt)))
+
+  call trues(m(11:48), idx, nt)
+  r = pack(a(3:40), m(11:48), v)
+  rslts(5) = count(r(1:nt) /= a(2 + idx(1:nt))) + count(r(nt + 1:) /= v(nt + 1:))
+
+  r = 0
+  r(1:15) = pack(a(1:10), ival(1) == 1, v(1:45:3))
+  rslts(6) = count(r(1:10) /= a(1:10)) + count(r(11:15) /= v(31:43:3))
+
+  call trues(logical(m1(2:48:3)), idx, nt)
+  dr(1:nt) = pack(d(2:48:3), m1(2:48:3))
+  rslts(7) = count(dr(1:nt) /= d(3 * idx(1:nt) - 1))
+
+  call trues(m(1:47:2), idx, nt)
+  cr(1:nt) = pack(c(1:47:2), m(1:47:2))
+  rslts(8) = count(cr(1:nt) /= c(2 * idx(1:nt) - 1))
+
+  nt = 0
+  do j = 1, 8, 2
+    do i = 2, 5
+      if (m2(i, j)) then
+        nt = nt + 1
+        ref(nt) = b(i, j)
+      end if
+    end do
+  end do
+  r(1:nt) = pack(b(2:5, 1:8:2), m2(2:5, 1:8:2))
+  rslts(9) = count(r(1:nt) /= ref(1:nt))
+
+  r(1:5) = pack(a(1:0), m(1:0), v(1:5))
+  rslts(10) = count(r(1:5) /= v(1:5))
+
+  ! UNPACK: contiguous, strided and negative-stride FIELD, scalar FIELD,
+  ! 2-byte elements, zero-size VECTOR
+
+  call refunpack(v, m, a, ref)
+  r = unpack(v, m, a)
+  rslts(11) = count(r /= ref)
+
+  call refunpack(v(1:48:2), m(1:48:2), a(48:1:-2), ref)
+  r(1:24) = unpack(v(1:48:2), m(1:48:2), a(48:1:-2))
+  rslts(12) = count(r(1:24) /= ref(1:24))
+
+  call refunpack(v(2:48:2), m(1:48:2), a(1:48:2), ref)
+  r(1:24) = unpack(v(2:48:2), m(1:48:2), a(1:48:2))
+  rslts(13) = count(r(1:24) /= ref(1:24))
+
+  call refunpack(v(5:48), m(5:48), (/(-99, i = 1, 44)/), ref)
+  r(1:44) = unpack(v(5:48), m(5:48), -99)
+  rslts(14) = count(r(1:44) /= ref(1:44))
+
+  k = 0
+  do i = 1, 12
+    if (m1(4 * i - 2)) then
+      k = k + 1
+      ref(i) = h(4 * k - 3)
+    else
+      ref(i) = 7
+    end if
+  end do
+  hr(1:12) = unpack(h(1:40:4), m1(2:48:4), 7_2)
+  rslts(15) = count(hr(1:12) /= ref(1:12))
+
+  r(1:10) = unpack(v(1:0), m(1:10) .and. ival(0) == 1, a(1:10))
+  rslts(16) = count(r(1:10) /= a(1:10))
+
+  ! RESHAPE: contiguous, strided, negative stride, PAD, zero-size SOURCE,
+  ! ORDER
+
+  y3 = reshape(a(1:24), (/4, 3, 2/))
+  rslts(17) = ncmp3(y3, a(1:24))
+  y3 = reshape(a(1:48:2), (/4, 3, 2/))
+  rslts(18) = ncmp3(y3, a(1:48:2))
+  y3 = reshape(a(48:1:-1), (/4, 3, 2/))
+  rslts(19) = ncmp3(y3, a(48:1:-1))
+
+  y2 = reshape(a(1:20:2), (/5, 6/), v(1:12))
+  rslts(20) = ncmp2(y2, a(1:20:2), v(1:12))
+  y2 = reshape(a(1:0), (/5, 6/), v(1:7:3))
+  rslts(21) = ncmp2(y2, a(1:0), v(1:7:3))
+
+  yo = reshape(a, (/6, 8/), order = (/2, 1/))
+  rslts(22) = 0
+  do j = 1, 8
+    do i = 1, 6
+      if (yo(i, j) /= a(j + 8 * (i - 1))) rslts(22) = rslts(22) + 1
+    end do
+  end do
+
+  ! SPREAD: DIM is not a constant so that the runtime is called; whole
+  ! array along each dimension, negative stride, NCOPIES of zero
+
+  allocate(s3(3, 6, 8))
+  s3 = spread(b, ival(1), 3)
+  rslts(23) = nspread(s3, b, 1)
+  deallocate(s3)
+  allocate(s3(6, 8, 2))
+  s3 = spread(b, ival(3), 2)
+  rslts(24) = nspread(s3, b, 3)
+  deallocate(s3)
+  allocate(s3(6, 2, 8))
+  s3 = spread(b(6:1:-1, :), ival(2), 2)
+  rslts(25) = nspread(s3, b(6:1:-1, :), 2)
+  deallocate(s3)
+  allocate(s3(6, 0, 8))
+  s3 = spread(b, ival(2), 0)
+  rslts(26) = size(s3)
+
+  ! TRANSFER: contiguous and strided sources, partial last element,
+  ! zero-size source
+
+  yt = transfer(d, yt)
+  rslts(27) = 0
+  do i = 1, 48
+    w = transfer(d(i), w)
+    if (yt(2 * i - 1) /= w(1) .or. yt(2 * i) /= w(2)) &
+      rslts(27) = rslts(27) + 1
+  end do
+
+  yt(1:20) = transfer(d(1:48:5), yt, 20)
+  rslts(28) = 0
+  do i = 1, 10
+    w = transfer(d(5 * i - 4), w)
+    if (yt(2 * i - 1) /= w(1) .or. yt(2 * i) /= w(2)) &
+      rslts(28) = rslts(28) + 1
+  end do
+
+  z = transfer(d(2:48:2), z, 3)
+  w = transfer(d(2), w)
+  rslts(29) = count(z(1:2) /= w)
+  w = transfer(d(4), w)
+  if (z(3) /= w(1)) rslts(29) = rslts(29) + 1
+
+  rslts(30) = size(transfer(d(1:0), w))
+
+  call check(rslts, expect, n)
+
+contains
+
+  ! positions of the true elements of mk
+  subroutine trues(mk, pos, np)
+    logical mk(:)
+    integer pos(:), np, i
+    np = 0
+    do i = 1, size(mk)
+      if (mk(i)) then
+        np = np + 1
+        pos(np) = i
+      end if
+    end do
+  end subroutine
+
+  subroutine refunpack(vec, mk, f, y)
+    integer vec(:), f(:), y(:)
+    logical mk(:)
+    integer i, j
+    j = 0
+    do i = 1, size(mk)
+      if (mk(i)) then
+        j = j + 1
+        y(i) = vec(j)
+      else
+        y(i) = f(i)
+      end if
+    end do
+  end subroutine
+
+  integer function ncmp3(y, x)
+    integer y(:, :, :), x(:)
+    integer i, j, k
+    ncmp3 = 0
+    do k = 1, size(y, 3)
+      do j = 1, size(y, 2)
+        do i = 1, size(y, 1)
+          if (y(i, j, k) /= x(i + size(y, 1) * (j - 1 + size(y, 2) * (k - 1)))) &
+            ncmp3 = ncmp3 + 1
+        end do
+      end do
+    end do
+  end function
+
+  integer function ncmp2(y, x, pd)
+    integer y(:, :), x(:), pd(:)
+    integer i, j, l, e
+    ncmp2 = 0
+    do j = 1, size(y, 2)
+      do i = 1, size(y, 1)
+        l = i + size(y, 1) * (j - 1)
+        if (l <= size(x)) then
+          e = x(l)
+        else
+          e = pd(mod(l - size(x) - 1, size(pd)) + 1)
+        end if
+        if (y(i, j) /= e) ncmp2 = ncmp2 + 1
+      end do
+    end do
+  end function
+
+  integer function nspread(y, x, sdim)
+    integer y(:, :, :), x(:, :), sdim
+    integer i, j, k
+    nspread = 0
+    do k = 1, size(y, 3)
+      do j = 1, size(y, 2)
+        do i = 1, size(y, 1)
+          select case (sdim)
+          case (1)
+            if (y(i, j, k) /= x(j, k)) nspread = nspread + 1
+          case (2)
+            if (y(i, j, k) /= x(i, k)) nspread = nspread + 1
+          case default
+            if (y(i, j, k) /= x(i, j)) nspread = nspread + 1
+          end select
+        end do
+      end do
+    end do
+  end function
+
+end program
+
+integer function ival(i)
+  integer i
+  ival = i
+end function
@@ -0,0 +1,77 @@
+!
+! Copyright (c) 2017, NVIDIA CORPORATION.  All rights reserved.
+!
+! Licensed under the Apache License, Version 2.0 (the "License");
+! you may not use this file except in compliance with the License.
+! You may obtain a copy of the License at
+!
+!     http://www.apache.org/licenses/LICENSE-2.0
+!
+! Unless required by applicable law or agreed to in writing, software
+! distributed under the License is distributed on an "AS IS" BASIS,
+! WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+! See the License for the specific language governing permissions and
+! limitations under the License.
+!
+
+! The bitcode written with -Mx,216,2 must disassemble to the same module
+! as the LLVM assembly written by default.
+
+! REQUIRES: llvm-dis
+! RUN: %flang -S -emit-llvm %s -o %t.ll
+! RUN: %flang -S -emit-llvm -Mx,216,2 %s -o %t.bc
+! RUN: llvm-as < %t.ll | llvm-dis > %t.ref.ll
+! RUN: llvm-dis < %t.bc > %t.dis.ll
+! RUN: diff %t.ref.ll %t.dis.ll
+! RUN: %flang -S -emit-llvm -g -Mx,216,2 %s -o %t.g.bc
+! RUN: llvm-dis < %t.g.bc | FileCheck %s
+
+! CHECK: define void @bcsum_
+! CHECK: !llvm.dbg.cu
+! CHECK: !DICompileUnit(language: DW_LANG_Fortran90
+! CHECK: !DISubprogram(name: "bcsum"
+! CHECK: !DILocalVariable(name: "n"
+
+module bcmod
+  type point
+    real(8) :: x, y
+    character(len=8) :: tag
+  end type
+  integer, parameter :: big = 2147483647
+  complex(8) :: zc = (1.5d0, -2.5d0)
+  type(point) :: origin = point(0.0d0, 0.0d0, 'origin')
+contains
+  function dist(p) result(d)
+    type(point), intent(in) :: p
+    real(8) :: d
+    d = sqrt((p%x - origin%x)**2 + (p%y - origin%y)**2)
+  end function
+end module
+
+subroutine bcsum(a, n, s, k)
+  use bcmod
+  implicit none
+  integer :: n, k, i
+  real(8) :: a(n), s
+  integer(8) :: m
+  common /bcblk/ m
+  type(point) :: p
+  s = 0.0d0
+  do i = 1, n
+    select case (mod(i, 4))
+    case (0)
+      s = s + a(i)
+    case (1, 2)
+      s = s - a(i) * real(zc)
+    case default
+      s = max(s, a(i))
+    end select
+  end do
+  p%x = s
+  p%y = aimag(zc)
+  p%tag = 'result'
+  if (dist(p) > 1.0d3 .and. k < big) then
+    m = m + int(k, 8) * 1099511627776_8
+  end if
+  write(*, '(a, f10.3)') trim(p%tag), s
+end subroutine
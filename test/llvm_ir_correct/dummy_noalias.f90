@@ -0,0 +1,45 @@
+!
+! Copyright (c) 2017, NVIDIA CORPORATION.  All rights reserved.
+!
+! Licensed under the Apache License, Version 2.0 (the "License");
+! you may not use this file except in compliance with the License.
+! You may obtain a copy of the License at
+!
+!     http://www.apache.org/licenses/LICENSE-2.0
+!
+! Unless required by applicable law or agreed to in writing, software
+! distributed under the License is distributed on an "AS IS" BASIS,
+! WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+! See the License for the specific language governing permissions and
+! limitations under the License.
+!
+
+! Dummy arguments that cannot be referenced through another name are
+! passed to LLVM as noalias parameters.
+
+! RUN: %flang -O2 -S -emit-llvm %s -o - | FileCheck %s
+! RUN: %flang -O2 -S -emit-llvm -Mx,222,1 %s -o - | FileCheck %s --check-prefix=OFF
+
+! CHECK: define void @axpy_(i64* noalias %n, i64* noalias %a, i64* noalias %x, i64* noalias %y)
+! OFF: define void @axpy_(i64* %n, i64* %a, i64* %x, i64* %y)
+subroutine axpy(n, a, x, y)
+  integer :: n, i
+  real(8) :: a, x(n), y(n)
+  do i = 1, n
+    y(i) = y(i) + a * x(i)
+  end do
+end subroutine
+
+! CHECK: define void @attrs_(i64* %p$p, i64* %t, i64* %v, i64* %s, i64* noalias %z, i64* noalias %c, i32 %_V_w.arg, i64* %al$p, i64* %p$sd, i64* %z$sd, i64* %al$sd, i32 %.U0001.arg)
+subroutine attrs(p, t, v, s, z, c, w, al)
+  real(8), pointer :: p(:)
+  real(8), target :: t(10)
+  real(8), volatile :: v
+  real(8), asynchronous :: s
+  real(8) :: z(:)
+  character(*) :: c
+  integer, value :: w
+  real(8), allocatable :: al(:)
+  p(1) = t(1) + v + s + z(1) + w + al(1)
+  c = 'x'
+end subroutine
@@ -0,0 +1,64 @@
+!
+! Copyright (c) 2017, NVIDIA CORPORATION.  All rights reserved.
+!
+! Licensed under the Apache License, Version 2.0 (the "License");
+! you may not use this file except in compliance with the License.
+! You may obtain a copy of the License at
+!
+!     http://www.apache.org/licenses/LICENSE-2.0
+!
+! Unless required by applicable law or agreed to in writing, software
+! distributed under the License is distributed on an "AS IS" BASIS,
+! WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+! See the License for the specific language governing permissions and
+! limitations under the License.
+!
+
+
+! Calls of the scalar math routines that have an entry in the vector math
+! library carry a vector-function-abi-variant attribute naming the
+! __fvd_/__fvs_ entries, so that the LLVM loop vectorizer can widen them.
+
+! The innermost loop of a masked array assignment or of one that calls a
+! math intrinsic is lowered to short vector code: a loop over whole
+! vectors, with the mask computed once and applied by a select to each
+! assignment, and a scalar remainder loop.
+
+! RUN: %flang -O2 -S -emit-llvm %s -o - | FileCheck %s
+
+! CHECK-LABEL: define void @wsqrt_
+! CHECK: load <4 x double>, <4 x double>* {{.*}}, align 8
+! CHECK: fcmp {{.*}}ogt <4 x double>
+! CHECK: @llvm.sqrt.v4f64
+! CHECK: select <4 x i1>
+! CHECK: store <4 x double> {{.*}}, align 8
+! CHECK-LABEL: define void @vexp_
+! CHECK: call {{.*}}<2 x double> @__fvd_exp_2{{ ?}}(<2 x double>
+! CHECK: store <2 x double>
+! CHECK-LABEL: define void @wtwo_
+! CHECK: fcmp {{.*}}ogt <4 x double>
+! CHECK: select <4 x i1> [[MASK:%[0-9]+]],
+! CHECK: store <4 x double>
+! CHECK-NOT: fcmp {{.*}}<4 x double>
+! CHECK: select <4 x i1> [[MASK]],
+! CHECK: store <4 x double>
+subroutine wsqrt(n, a, b)
+  integer :: n
+  real(8) :: a(n), b(n)
+  where (a > 0.0d0) b = sqrt(a)
+end subroutine
+
+subroutine vexp(n, a, b)
+  integer :: n
+  real(8) :: a(n), b(n)
+  b = exp(a) + 1.0d0
+end subroutine
+
+subroutine wtwo(n, a, b, c)
+  integer :: n
+  real(8) :: a(n), b(n), c(n)
+  where (a > 0.0d0)
+    b = sqrt(a)
+    c = 2.0d0 * a
+  end where
+end subroutine
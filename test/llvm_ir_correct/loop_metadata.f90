@@ -0,0 +1,108 @@
+!
+! Copyright (c) 2017, NVIDIA CORPORATION.  All rights reserved.
+!
+! Licensed under the Apache License, Version 2.0 (the "License");
+! you may not use this file except in compliance with the License.
+! You may obtain a copy of the License at
+!
+!     http://www.apache.org/licenses/LICENSE-2.0
+!
+! Unless required by applicable law or agreed to in writing, software
+! distributed under the License is distributed on an "AS IS" BASIS,
+! WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+! See the License for the specific language governing permissions and
+! limitations under the License.
+!
+
+! Loop directives and OpenMP SIMD are passed to LLVM as !llvm.loop metadata
+! on the branch that closes the loop.
+
+! RUN: %flang -O2 -fopenmp -S -emit-llvm %s -o - | FileCheck %s
+! RUN: %flang -O2 -fopenmp -S -emit-llvm -Mx,219,4 %s -o - | FileCheck %s --check-prefix=OFF
+! RUN: %flang -O2 -fopenmp -S -emit-llvm -Mx,249,40 %s -o - | FileCheck %s --check-prefix=V4
+! RUN: %flang -O2 -fopenmp -S -emit-llvm -Mx,249,90 %s -o - | FileCheck %s --check-prefix=V9
+
+! V4-LABEL: define void @ivdep_
+! V4: store double {{.*}}, !llvm.mem.parallel_loop_access !
+! V9-LABEL: define void @ivdep_
+! V9: store double {{.*}}, !llvm.access.group [[GRP:![0-9]+]]
+! V9: br i1 {{.*}}, !llvm.loop [[LOOP:![0-9]+]]
+! V9-DAG: [[LOOP]] = distinct !{ [[LOOP]]{{.*}}, [[PAR:![0-9]+]]
+! V9-DAG: [[PAR]] = !{ !"llvm.loop.parallel_accesses", [[GRP]] }
+
+! CHECK-LABEL: define void @ivdep_
+! CHECK: store double {{.*}}, !llvm.{{mem.parallel_loop_access|access.group}} !
+! CHECK: br i1 {{.*}}, !llvm.loop [[IVDEP:![0-9]+]]
+subroutine ivdep(a, ix, n)
+  integer :: n, i, ix(n)
+  real(8) :: a(n)
+!dir$ ivdep
+  do i = 1, n
+    a(ix(i)) = a(ix(i)) + 1
+  end do
+end subroutine
+
+! The inner loop does not get the directive of the outer loop.
+! CHECK-LABEL: define void @unroll_
+! CHECK-NOT: !llvm.loop
+! CHECK: br i1 {{.*}}, !llvm.loop [[UNROLL:![0-9]+]]
+! CHECK-NOT: !llvm.loop
+! CHECK: ret void
+subroutine unroll(b, n)
+  integer :: n, i, j
+  real(8) :: b(n, n)
+!dir$ unroll = n:4
+  do j = 1, n
+    do i = 1, n
+      b(i, j) = b(i, j) * 2
+    end do
+  end do
+end subroutine
+
+! CHECK-LABEL: define void @novector_
+! CHECK: br i1 {{.*}}, !llvm.loop [[NOVEC:![0-9]+]]
+subroutine novector(a, n)
+  integer :: n, i
+  real(8) :: a(n)
+!dir$ novector
+  do i = 2, n
+    a(i) = a(i - 1) * 2
+  end do
+end subroutine
+
+! CHECK-LABEL: define void @nounroll_
+! CHECK: br i1 {{.*}}, !llvm.loop [[NOUNROLL:![0-9]+]]
+subroutine nounroll(a, n)
+  integer :: n, i
+  real(8) :: a(n)
+!dir$ nounroll
+  do i = 1, n
+    a(i) = a(i) + 1
+  end do
+end subroutine
+
+! CHECK-LABEL: define void @simd_
+! CHECK: store double {{.*}}, !llvm.{{mem.parallel_loop_access|access.group}} !
+! CHECK: br i1 {{.*}}, !llvm.loop [[SIMD:![0-9]+]]
+subroutine simd(a, b, n)
+  integer :: n, i
+  real(8) :: a(n), b(n)
+!$omp simd
+  do i = 1, n
+    a(i) = a(i) + b(i)
+  end do
+end subroutine
+
+! CHECK-DAG: [[IVDEP]] = distinct !{ [[IVDEP]]{{.*}} }
+! CHECK-DAG: [[UNROLL]] = distinct !{ [[UNROLL]], [[COUNT:![0-9]+]] }
+! CHECK-DAG: [[COUNT]] = !{ !"llvm.loop.unroll.count", i32 4 }
+! CHECK-DAG: [[NOVEC]] = distinct !{ [[NOVEC]], [[WIDTH:![0-9]+]] }
+! CHECK-DAG: [[WIDTH]] = !{ !"llvm.loop.vectorize.width", i32 1 }
+! CHECK-DAG: [[NOUNROLL]] = distinct !{ [[NOUNROLL]], [[DISABLE:![0-9]+]] }
+! CHECK-DAG: [[DISABLE]] = !{ !"llvm.loop.unroll.disable" }
+! CHECK-DAG: [[SIMD]] = distinct !{ [[SIMD]], [[ENABLE:![0-9]+]]
+! CHECK-DAG: [[ENABLE]] = !{ !"llvm.loop.vectorize.enable", i1 1 }
+
+! OFF-NOT: !llvm.loop
+! OFF-NOT: parallel_loop_access
+! OFF-NOT: access.group
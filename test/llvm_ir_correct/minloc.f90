@@ -0,0 +1,55 @@
+!
+! Copyright (c) 2017, NVIDIA CORPORATION.  All rights reserved.
+!
+! Licensed under the Apache License, Version 2.0 (the "License");
+! you may not use this file except in compliance with the License.
+! You may obtain a copy of the License at
+!
+!     http://www.apache.org/licenses/LICENSE-2.0
+!
+! Unless required by applicable law or agreed to in writing, software
+! distributed under the License is distributed on an "AS IS" BASIS,
+! WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+! See the License for the specific language governing permissions and
+! limitations under the License.
+!
+
+
+
+
+! MINLOC and MAXLOC of a rank-1 array or section without MASK are inlined
+! to a loop that keeps the best value and its position, like SUM, MAXVAL,
+! DOT_PRODUCT and COUNT, instead of calling the fort_minloc/fort_maxloc
+! runtime routines.
+
+! RUN: %flang -O2 -S -emit-llvm %s -o - | FileCheck %s
+
+! CHECK-LABEL: define void @mloc_
+! CHECK-NOT: call
+! CHECK: store double 0x7FEFFFFFFFFFFFFF
+! CHECK: fcmp {{.*}}olt double
+! CHECK: ret void
+! CHECK-LABEL: define void @mlocd_
+! CHECK-NOT: call
+! CHECK: icmp sgt i32
+! CHECK: ret void
+! CHECK-LABEL: define void @sred_
+! CHECK-NOT: call
+! CHECK: ret void
+subroutine mloc(n, x, l)
+  integer :: n, l(1)
+  real(8) :: x(n)
+  l = minloc(x)
+end subroutine
+
+subroutine mlocd(n, x, k)
+  integer :: n, k
+  integer :: x(n)
+  k = maxloc(x(2:n:3), 1)
+end subroutine
+
+subroutine sred(n, x, y, s)
+  integer :: n
+  real :: x(n), y(n), s
+  s = sum(x) + maxval(y) + dot_product(x, y) + count(x > 0.0)
+end subroutine
@@ -0,0 +1,82 @@
+!
+! Copyright (c) 2017, NVIDIA CORPORATION.  All rights reserved.
+!
+! Licensed under the Apache License, Version 2.0 (the "License");
+! you may not use this file except in compliance with the License.
+! You may obtain a copy of the License at
+!
+!     http://www.apache.org/licenses/LICENSE-2.0
+!
+! Unless required by applicable law or agreed to in writing, software
+! distributed under the License is distributed on an "AS IS" BASIS,
+! WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+! See the License for the specific language governing permissions and
+! limitations under the License.
+!
+
+
+! Parallel code generation: with -Mx,217,2 two worker processes generate
+! the routine groups and flang2 merges their output.  The merged module
+! must be valid and hold the same code as a serial compilation, up to the
+! numbers in label, local, .BSS and .STATICS names, which the workers
+! count separately, the metadata ids and the order of the declarations.
+
+! RUN: %flang -mp -S -emit-llvm %s -o %t.ser.ll
+! RUN: %flang -mp -S -emit-llvm -Mx,217,2 %s -o %t.par.ll
+! RUN: llvm-as < %t.par.ll | llvm-dis > %t.par.dis.ll
+! RUN: llvm-as < %t.ser.ll | llvm-dis > %t.ser.dis.ll
+! RUN: sed -e 's/\(BSS\|STATICS\|L\.LB\|\.V\)[0-9]*/\1N/g' -e 's/![0-9][0-9]*/!N/g' -e '/^!/d' -e 's/ *;.*//' %t.ser.dis.ll | sort > %t.ser.txt
+! RUN: sed -e 's/\(BSS\|STATICS\|L\.LB\|\.V\)[0-9]*/\1N/g' -e 's/![0-9][0-9]*/!N/g' -e '/^!/d' -e 's/ *;.*//' %t.par.dis.ll | sort > %t.par.txt
+! RUN: diff %t.ser.txt %t.par.txt
+! RUN: FileCheck %s < %t.par.dis.ll
+
+! CHECK-DAG: define void @s1_(
+! CHECK-DAG: define internal void @s1_inner(
+! CHECK-DAG: define void @s2_(
+! CHECK-DAG: define internal void @{{[a-z0-9_]+}}F1L{{[0-9]+}}_(
+! CHECK-DAG: define signext i32 @f3_(
+! CHECK-DAG: define void @MAIN_(
+
+module m
+  integer :: g(10) = 5
+end module
+
+subroutine s1(a, n)
+  integer n
+  real a(n)
+  real, save :: t(4) = (/1., 2., 3., 4./)
+  a(1:4) = a(1:4) + t
+  call inner
+contains
+  subroutine inner
+    a(n) = 0
+  end subroutine
+end subroutine
+
+subroutine s2(a, n)
+  integer n
+  real a(n)
+  integer i
+  !$omp parallel do
+  do i = 1, n
+    a(i) = a(i) * 2
+  end do
+end subroutine
+
+function f3(c)
+  character(*) c
+  integer f3
+  f3 = index(c, 'abc') + len_trim(c)
+end function
+
+program p
+  use m
+  real a(10)
+  integer f3, k(3)
+  common /cb/ a
+  a = 1
+  call s1(a, 10)
+  call s2(a, 10)
+  k = g(1:3)
+  print *, f3('xxabc  '), a(1), k
+end program
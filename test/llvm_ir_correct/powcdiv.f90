@@ -0,0 +1,51 @@
+!
+! Copyright (c) 2017, NVIDIA CORPORATION.  All rights reserved.
+!
+! Licensed under the Apache License, Version 2.0 (the "License");
+! you may not use this file except in compliance with the License.
+! You may obtain a copy of the License at
+!
+!     http://www.apache.org/licenses/LICENSE-2.0
+!
+! Unless required by applicable law or agreed to in writing, software
+! distributed under the License is distributed on an "AS IS" BASIS,
+! WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+! See the License for the specific language governing permissions and
+! limitations under the License.
+!
+
+
+
+! Powers with a constant exponent are expanded to multiplies along the
+! shortest addition chain (x**15 = x**3 * x**12: five multiplies), and
+! complex division is expanded inline instead of calling __mth_i_cdiv.
+
+! RUN: %flang -O2 -S -emit-llvm %s -o - | FileCheck %s
+
+! CHECK-LABEL: define void @pow15_
+! CHECK-NOT: call
+! CHECK-COUNT-5: fmul
+! CHECK-NOT: fmul
+! CHECK: ret void
+! CHECK-LABEL: define void @ipow13_
+! CHECK-NOT: __mth_i_ipowi
+! CHECK: mul
+! CHECK: ret void
+! CHECK-LABEL: define void @cdivs_
+! CHECK-NOT: __mth_i_cdiv
+! CHECK: fdiv
+! CHECK: ret void
+subroutine pow15(x, y)
+  real(8) :: x, y
+  y = x ** 15
+end subroutine
+
+subroutine ipow13(i, j)
+  integer :: i, j
+  j = i ** 13
+end subroutine
+
+subroutine cdivs(a, b, c)
+  complex :: a, b, c
+  c = a / b
+end subroutine
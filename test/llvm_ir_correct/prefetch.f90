@@ -0,0 +1,39 @@
+!
+! Copyright (c) 2017, NVIDIA CORPORATION.  All rights reserved.
+!
+! Licensed under the Apache License, Version 2.0 (the "License");
+! you may not use this file except in compliance with the License.
+! You may obtain a copy of the License at
+!
+!     http://www.apache.org/licenses/LICENSE-2.0
+!
+! Unless required by applicable law or agreed to in writing, software
+! distributed under the License is distributed on an "AS IS" BASIS,
+! WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+! See the License for the specific language governing permissions and
+! limitations under the License.
+!
+
+! PREFETCH directives are passed to LLVM as calls to llvm.prefetch.  An
+! object stored in the loop is prefetched for writing, a hint sets the
+! locality, and a distance prefetches the element that many iterations
+! ahead.
+
+! RUN: %flang -O2 -S -emit-llvm %s -o - | FileCheck %s
+
+! CHECK-LABEL: define void @stream_
+! a(i + 32) is 248 + 8 * i bytes into a
+! CHECK: getelementptr i8, i8* {{%[0-9]+}}, i64 248
+! CHECK: call void @llvm.prefetch (i8* {{%[0-9]+}}, i32 0, i32 1, i32 1)
+! CHECK: call void @llvm.prefetch (i8* {{%[0-9]+}}, i32 0, i32 0, i32 1)
+! CHECK: call void @llvm.prefetch (i8* {{%[0-9]+}}, i32 1, i32 3, i32 1)
+! CHECK: declare void @llvm.prefetch(i8*, i32, i32, i32)
+subroutine stream(n, a, b, c)
+  integer :: n, i
+  real(8) :: a(n), b(n), c(n)
+  do i = 1, n, 2
+!dir$ prefetch a(i):1:16, b(i):0
+!dir$ prefetch c(i)
+    c(i) = a(i) + b(i)
+  end do
+end subroutine
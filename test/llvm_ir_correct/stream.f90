@@ -0,0 +1,70 @@
+!
+! Copyright (c) 2017, NVIDIA CORPORATION.  All rights reserved.
+!
+! Licensed under the Apache License, Version 2.0 (the "License");
+! you may not use this file except in compliance with the License.
+! You may obtain a copy of the License at
+!
+!     http://www.apache.org/licenses/LICENSE-2.0
+!
+! Unless required by applicable law or agreed to in writing, software
+! distributed under the License is distributed on an "AS IS" BASIS,
+! WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+! See the License for the specific language governing permissions and
+! limitations under the License.
+!
+
+
+
+
+
+! The STREAM directive asks for non-temporal stores in the array
+! assignment that follows it.  The loop is lowered to short vectors and
+! its vector stores are marked !nontemporal; with -Mx,226,2 so are the
+! stores to arrays of at least 16 MB.
+
+! RUN: %flang -O2 -S -emit-llvm %s -o - | FileCheck %s
+! RUN: %flang -O2 -S -emit-llvm -Mx,226,2 %s -o - | FileCheck %s --check-prefix=SIZE
+
+! CHECK-LABEL: define void @zero_
+! CHECK: store <4 x double> {{.*}}, !nontemporal
+! CHECK-LABEL: define void @copy_
+! CHECK-NOT: !nontemporal
+! CHECK-LABEL: define void @triad_
+! CHECK: store <4 x double> {{.*}}, !nontemporal
+! CHECK-LABEL: define void @big_
+! CHECK-NOT: !nontemporal
+! CHECK: ret void
+
+! SIZE-LABEL: define void @copy_
+! SIZE-NOT: !nontemporal
+! SIZE-LABEL: define void @triad_
+! SIZE-LABEL: define void @big_
+! SIZE: store <4 x double> {{.*}}, !nontemporal
+subroutine zero(n, a)
+  integer :: n
+  real(8) :: a(n)
+!dir$ stream
+  a = 0.0d0
+end subroutine
+
+subroutine copy(n, a, b)
+  integer :: n
+  real(8) :: a(n), b(n)
+  a = b
+end subroutine
+
+subroutine triad(n, m, a, b, c, s)
+  integer :: n, m, j
+  real(8) :: a(n, m), b(n, m), c(n, m), s
+  do j = 1, m
+!dir$ stream
+    a(:, j) = b(:, j) + s * c(:, j)
+  end do
+end subroutine
+
+subroutine big(b)
+  real(8) :: a(4000000), b(4000000)
+  common /c/ a
+  a = b
+end subroutine
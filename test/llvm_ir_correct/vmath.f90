@@ -0,0 +1,46 @@
+!
+! Copyright (c) 2017, NVIDIA CORPORATION.  All rights reserved.
+!
+! Licensed under the Apache License, Version 2.0 (the "License");
+! you may not use this file except in compliance with the License.
+! You may obtain a copy of the License at
+!
+!     http://www.apache.org/licenses/LICENSE-2.0
+!
+! Unless required by applicable law or agreed to in writing, software
+! distributed under the License is distributed on an "AS IS" BASIS,
+! WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+! See the License for the specific language governing permissions and
+! limitations under the License.
+!
+
+
+! Calls of the scalar math routines that have an entry in the vector math
+! library carry a vector-function-abi-variant attribute naming the
+! __fvd_/__fvs_ entries, so that the LLVM loop vectorizer can widen them.
+! The vector entries are declared and kept in llvm.compiler.used.
+
+! RUN: %flang -O2 -S -emit-llvm -Mx,249,90 %s -o - | FileCheck %s
+
+! CHECK-LABEL: define void @vexp_
+! CHECK: call fast double {{.*}}exp{{.*}}"vector-function-abi-variant"="_ZGV_LLVM_N2v_{{[_a-z0-9]+}}exp(__fvd_exp_2)
+! CHECK-LABEL: define void @vpow_
+! CHECK: call fast float {{.*}}pow{{.*}}"vector-function-abi-variant"="_ZGV_LLVM_N4vv_{{[_a-z0-9]+}}pow(__fvs_pow_4)
+! CHECK-DAG: declare <2 x double> @__fvd_exp_2(<2 x double>)
+! CHECK-DAG: declare <4 x float> @__fvs_pow_4(<4 x float>, <4 x float>)
+! CHECK: @llvm.compiler.used = appending global {{.*}}@__fvd_exp_2
+subroutine vexp(n, a, b)
+  integer :: n, i
+  real(8) :: a(n), b(n)
+  do i = 1, n
+    b(i) = exp(a(i))
+  end do
+end subroutine
+
+subroutine vpow(n, a, b)
+  integer :: n, i
+  real(4) :: a(n), b(n)
+  do i = 1, n
+    b(i) = a(i) ** b(i)
+  end do
+end subroutine
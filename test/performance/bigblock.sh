@@ -0,0 +1,46 @@
+#!/bin/sh
+#
+# Copyright (c) 2017, NVIDIA CORPORATION.  All rights reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+
+# Compile-time benchmark for routines made of one huge basic block, as
+# produced by code generators.  Each statement stores one array element
+# and loads elements and scalars that earlier statements also loaded, so
+# the block exercises the load and expression CSE of flang2's LLVM
+# code generation.  The time includes the whole compilation to LLVM IR.
+#
+# usage: sh bigblock.sh [statements ...]
+# The compiler is taken from $FLANG (default flang).
+
+FLANG=${FLANG:-flang}
+tmp=${TMPDIR:-/tmp}/bigblock.$$
+trap 'rm -f $tmp.f90 $tmp.ll' 0
+
+for n in ${*:-1000 2000 4000 8000}; do
+  awk -v n=$n 'BEGIN {
+    print "subroutine bigblock(a, b, c, s, t)"
+    print "  implicit none"
+    print "  real(8) :: a(*), b(*), c(*), s, t"
+    for (i = 1; i <= n; i++)
+      printf "  a(%d) = b(%d) * s + b(%d) * t + c(%d)\n", i, i, i + 1, i
+    print "end subroutine"
+  }' > $tmp.f90
+  t0=$(date +%s%N)
+  $FLANG -O2 -S -emit-llvm $tmp.f90 -o $tmp.ll || exit 1
+  t1=$(date +%s%N)
+  awk -v n=$n -v ns=$((t1 - t0)) 'BEGIN {
+    printf "bigblock  %10d %12.3f ms %10.3f us/stmt\n", n, ns / 1.0e6, ns / 1.0e3 / n
+  }'
+done
@@ -0,0 +1,58 @@
+#!/bin/sh
+#
+# Copyright (c) 2017, NVIDIA CORPORATION.  All rights reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+# Compile-time benchmark for the import of very large modules.  A module
+# with n variables, n/2 named constants and n/8 derived types is compiled
+# first; the time is that of a second file whose 40 routines each USE it,
+# so every routine enters all of the module's symbols and looks up a few
+# of them.  This exercises the symbol table and AST hash tables of flang1.
+#
+# usage: sh bigmod.sh [n ...]
+# The compiler is taken from $FLANG (default flang).
+
+FLANG=${FLANG:-flang}
+tmp=${TMPDIR:-/tmp}/bigmod.$$
+trap 'rm -rf $tmp.d' 0
+mkdir $tmp.d || exit 1
+
+for n in ${*:-10000 20000 40000}; do
+  awk -v n=$n 'BEGIN {
+    print "module bigmod_m\n  implicit none"
+    for (k = 1; k <= n / 8; k++)
+      printf "  type t%d\n    integer :: i\n    real(8) :: x, y(%d)\n  end type\n", k, k % 7 + 1
+    for (k = 1; k <= n / 2; k++)
+      printf "  integer, parameter :: p%d = %d\n", k, k
+    for (k = 1; k <= n; k++)
+      printf "  real(8) :: v%d(%d)\n", k, k % 5 + 1
+    print "end module"
+  }' > $tmp.d/bigmod_m.f90
+  awk -v n=$n 'BEGIN {
+    for (k = 1; k <= 40; k++) {
+      printf "subroutine use%d(s)\n  use bigmod_m\n  implicit none\n", k
+      printf "  real(8) :: s\n  type(t%d) :: a\n", k * 3 % (n / 8) + 1
+      printf "  a%%x = s + p%d\n", k * 11 % (n / 2) + 1
+      printf "  v%d(1) = a%%x * v%d(1)\n", k * 97 % n + 1, k * 89 % n + 1
+      print "end subroutine"
+    }
+  }' > $tmp.d/use.f90
+  (cd $tmp.d && $FLANG -O2 -S -emit-llvm bigmod_m.f90 -o bigmod_m.ll) || exit 1
+  t0=$(date +%s%N)
+  (cd $tmp.d && $FLANG -O2 -S -emit-llvm use.f90 -o use.ll) || exit 1
+  t1=$(date +%s%N)
+  awk -v n=$n -v ns=$((t1 - t0)) 'BEGIN {
+    printf "bigmod    %10d %12.3f ms %10.3f ms/use\n", n, ns / 1.0e6, ns / 1.0e6 / 40
+  }'
+done
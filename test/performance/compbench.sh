@@ -0,0 +1,237 @@
+#!/bin/sh
+#
+# Copyright (c) 2017, NVIDIA CORPORATION.  All rights reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+# Compile-time regression suite for flang1 and flang2.  Each workload
+# generates synthetic sources whose size grows with the scale factor and
+# compiles them at -O2 with the timing report of both compilers enabled
+# (-Mx,0,1):
+#
+#   bigroutine  one routine with many loops, conditionals and statements
+#   moddag      a chain of 24 modules, each using the two before it, with
+#               routines using the last one; the depth does not grow with
+#               the scale because the time to import such a DAG currently
+#               doubles with every two levels
+#   data        a module of large initialized arrays and DATA statements
+#   contained   a host routine with many contained procedures that refer
+#               to its variables and to each other
+#   omp         routines made of many OpenMP parallel loops, reductions,
+#               sections and tasks (-fopenmp)
+#
+# The results are written to standard output, one measurement per line:
+#
+#   <workload> <metric> <value>
+#
+# where the metrics are wall_ms (for all the compilations of the
+# workload), flang1.<phase>_ms and flang2.<phase>_ms (summed over the
+# compilations; the phases are those of the timing report) and
+# flang1.rss_kb and flang2.rss_kb (the largest peak RSS).  With -b, the
+# results are compared with a previous output of this script instead, and
+# each line gets the baseline value and the relative change:
+#
+#   <workload> <metric> <value> <baseline> <change>%
+#
+# usage: sh compbench.sh [-s scale] [-b baseline] [workload ...]
+# The compiler is taken from $FLANG (default flang).
+
+FLANG=${FLANG:-flang}
+scale=1
+base=
+while getopts s:b: opt; do
+  case $opt in
+  s) scale=$OPTARG ;;
+  b) base=$OPTARG ;;
+  *) echo "usage: sh compbench.sh [-s scale] [-b baseline] [workload ...]" >&2
+     exit 2 ;;
+  esac
+done
+shift $((OPTIND - 1))
+if [ -n "$base" ] && [ ! -r "$base" ]; then
+  echo "compbench: cannot read $base" >&2
+  exit 2
+fi
+
+tmp=${TMPDIR:-/tmp}/compbench.$$
+trap 'rm -rf $tmp.d $tmp.out' 0
+mkdir $tmp.d || exit 1
+
+# gen_<workload> writes the sources into the current directory and the
+# names of the files to compile, in order, to standard output.
+
+gen_bigroutine() {
+  awk -v n=$((scale * 1000)) 'BEGIN {
+    print "subroutine big(a, b, c, x, m)\n  implicit none"
+    print "  integer :: m, i, j\n  real(8) :: a(m), b(m), c(m, 8), x, s"
+    for (k = 1; k <= n; k++) {
+      if (k % 4 == 0) {
+        printf "  do i = 1, m\n    a(i) = a(i) * %d.5d0 + b(i) * c(i, %d)\n", k, k % 8 + 1
+        printf "  end do\n"
+      } else if (k % 4 == 1) {
+        printf "  if (x > %d.0d0) then\n    b(%d) = b(%d) + x\n", k, k % 97 + 1, k % 89 + 1
+        printf "  else\n    b(%d) = b(%d) - a(%d)\n  end if\n", k % 83 + 1, k % 79 + 1, k % 73 + 1
+      } else if (k % 4 == 2) {
+        printf "  s = 0\n  do j = 1, 8\n    do i = 1, m\n"
+        printf "      s = s + c(i, j) * a(i) - %d.0d0\n    end do\n  end do\n", k
+        printf "  x = x + s\n"
+      } else {
+        printf "  a(%d) = b(%d) * x + c(%d, %d) / (a(%d) + 1)\n", k % 71 + 1, k % 67 + 1, k % 61 + 1, k % 8 + 1, k % 59 + 1
+      }
+    }
+    print "end subroutine"
+  }' > bigroutine.f90
+  echo bigroutine.f90
+}
+
+gen_moddag() {
+  awk -v n=24 -v w=$((scale * 50)) -v u=$((scale * 20)) 'BEGIN {
+    for (d = 1; d <= n; d++) {
+      f = sprintf("dag%d.f90", d)
+      printf "module dag%d\n", d > f
+      if (d > 1)
+        printf "  use dag%d\n", d - 1 > f
+      if (d > 2)
+        printf "  use dag%d\n", d - 2 > f
+      printf "  implicit none\n" > f
+      printf "  type t%d\n    integer :: i\n    real(8) :: v(%d)\n  end type\n", d, d % 5 + 1 > f
+      for (k = 1; k <= w; k++)
+        printf "  real(8) :: x%d_%d(%d)\n", d, k, k % 7 + 1 > f
+      printf "  interface g%d\n    module procedure f%d, h%d\n  end interface\n", d, d, d > f
+      printf "contains\n" > f
+      printf "  real(8) function f%d(a)\n    real(8) :: a\n    f%d = a + x%d_1(1)\n  end function\n", d, d, d > f
+      printf "  integer function h%d(a)\n    integer :: a\n    h%d = a + %d\n  end function\n", d, d, d > f
+      printf "end module\n" > f
+      close(f)
+      print f
+    }
+    f = "dagmain.f90"
+    for (k = 1; k <= u; k++) {
+      printf "subroutine dagu%d(s)\n  use dag%d\n  implicit none\n  real(8) :: s\n", k, n > f
+      printf "  type(t%d) :: a\n", (k * 7) % n + 1 > f
+      printf "  a%%v(1) = g%d(s) + x%d_%d(1)\n", (k * 3) % n + 1, (k * 11) % n + 1, k % w + 1 > f
+      printf "  s = a%%v(1)\nend subroutine\n" > f
+    }
+    close(f)
+    print f
+  }'
+}
+
+gen_data() {
+  awk -v n=$((scale * 20000)) 'BEGIN {
+    print "module tables\n  implicit none"
+    printf "  real(8) :: r(%d) = [ &\n", n
+    for (k = 1; k <= n; k++)
+      printf "    %d.25d0%s\n", k, k < n ? ", &" : " ]"
+    printf "  integer :: iv(%d)\n", n
+    printf "  character(len=8) :: names(%d)\n", n / 10
+    for (k = 1; k <= n; k += 10)
+      printf "  data iv(%d:%d) / %d, %d, %d, %d, %d, %d, %d, %d, %d, %d /\n", k, k + 9, k, -k, k * 3, k + 7, k % 13, k / 3, 7, 0, k, 1
+    for (k = 1; k <= n / 10; k++)
+      printf "  data names(%d) / \"n%07d\" /\n", k, k
+    print "end module"
+  }' > data.f90
+  echo data.f90
+}
+
+gen_contained() {
+  awk -v n=$((scale * 300)) 'BEGIN {
+    print "subroutine host(a, m)\n  implicit none"
+    print "  integer :: m, cnt\n  real(8) :: a(m), tot"
+    print "  tot = 0\n  cnt = 0"
+    for (k = 1; k <= n; k += 10)
+      printf "  call c%d(%d.0d0)\n", k, k
+    print "contains"
+    for (k = 1; k <= n; k++) {
+      printf "  subroutine c%d(x)\n    real(8) :: x\n    integer :: i\n", k
+      printf "    do i = 1, m\n      a(i) = a(i) + x * %d\n    end do\n", k
+      printf "    tot = tot + a(%d)\n    cnt = cnt + 1\n", k % 50 + 1
+      if (k < n)
+        printf "    if (tot < 0) call c%d(x + 1)\n", k + 1
+      print "  end subroutine"
+    }
+    print "end subroutine"
+  }' > contained.f90
+  echo contained.f90
+}
+
+gen_omp() {
+  awk -v n=$((scale * 200)) 'BEGIN {
+    for (r = 1; r <= n; r++) {
+      printf "subroutine omp%d(a, b, m, s)\n  implicit none\n", r
+      print "  integer :: m, i, j\n  real(8) :: a(m), b(m), s, t"
+      for (k = 1; k <= 5; k++) {
+        printf "!$omp parallel do private(t) reduction(+:s)\n"
+        printf "  do i = 1, m\n    t = a(i) * %d.0d0 + b(i)\n    s = s + t\n  end do\n", k
+      }
+      print "!$omp parallel\n!$omp sections"
+      printf "!$omp section\n  a(1) = s\n!$omp section\n  b(1) = s * %d\n", r
+      print "!$omp end sections"
+      print "!$omp do schedule(dynamic)\n  do j = 1, m\n    b(j) = b(j) + a(j)\n  end do\n!$omp end do"
+      print "!$omp single\n!$omp task firstprivate(s)\n  a(m) = s\n!$omp end task\n!$omp end single"
+      print "!$omp end parallel"
+      print "end subroutine"
+    }
+  }' > omp.f90
+  echo omp.f90
+}
+
+# Compile the files listed on the standard input and print the results.
+run() {
+  w=$1
+  shift
+  opts="$*"
+  : > $tmp.d/$w.err
+  t0=$(date +%s%N)
+  while read f; do
+    (cd $tmp.d && $FLANG -O2 $opts -Mx,0,1 -S -emit-llvm $f -o ${f%.f90}.ll) \
+      2>> $tmp.d/$w.err || { cat $tmp.d/$w.err >&2; exit 1; }
+  done
+  t1=$(date +%s%N)
+  awk -v w=$w -v ns=$((t1 - t0)) '
+    # flang1 writes its report first, then flang2
+    /Timing stats:/ { ++report; tool = report % 2 ? "flang1" : "flang2"; next }
+    /Total time/ { next }
+    / millisecs / { t[tool "." $1 "_ms"] += $2; next }
+    /Peak RSS/ { k = tool ".rss_kb"; if ($3 > t[k]) t[k] = $3; next }
+    END {
+      printf "%s wall_ms %d\n", w, ns / 1.0e6
+      for (k in t)
+        printf "%s %s %d\n", w, k, t[k]
+    }' $tmp.d/$w.err | sort -k2,2
+}
+
+for w in ${*:-bigroutine moddag data contained omp}; do
+  case $w in
+  bigroutine | moddag | data | contained) opts= ;;
+  omp) opts=-fopenmp ;;
+  *) echo "compbench: unknown workload $w" >&2; exit 2 ;;
+  esac
+  (cd $tmp.d && gen_$w) | run $w $opts || exit 1
+done > $tmp.out
+
+if [ -z "$base" ]; then
+  cat $tmp.out
+else
+  awk '
+    NR == FNR { b[$1 " " $2] = $3; next }
+    {
+      k = $1 " " $2
+      if (!(k in b))
+        printf "%s %s %d - -\n", $1, $2, $3
+      else if (b[k] == 0)
+        printf "%s %s %d %d -\n", $1, $2, $3, b[k]
+      else
+        printf "%s %s %d %d %+.1f%%\n", $1, $2, $3, b[k], 100.0 * ($3 - b[k]) / b[k]
+    }' $base $tmp.out
+fi
@@ -0,0 +1,114 @@
+!
+! Copyright (c) 2017, NVIDIA CORPORATION.  All rights reserved.
+!
+! Licensed under the Apache License, Version 2.0 (the "License");
+! you may not use this file except in compliance with the License.
+! You may obtain a copy of the License at
+!
+!     http://www.apache.org/licenses/LICENSE-2.0
+!
+! Unless required by applicable law or agreed to in writing, software
+! distributed under the License is distributed on an "AS IS" BASIS,
+! WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+! See the License for the specific language governing permissions and
+! limitations under the License.
+!
+
+! Benchmark for building character strings: concatenations passed as
+! arguments (run-time temporaries), concatenations stored into a fixed
+! length variable, and a deferred-length string grown one piece at a time.
+
+module concat_util
+contains
+  subroutine consume(s, h)
+    character(*) :: s
+    integer :: h
+    h = h + len(s) + ichar(s(1:1))
+  end subroutine
+end module
+
+program concat
+  use concat_util
+  implicit none
+  integer, parameter :: n = 1000000
+  character(len=32) :: key, val
+  character(len=80) :: line
+  character(len=:), allocatable :: s
+  integer(8) :: t0, t1, rate
+  integer :: i, h
+
+  key = 'keyword'
+  val = 'value'
+  h = 0
+  call system_clock(t0, rate)
+
+  call system_clock(t0)
+  do i = 1, n
+    call consume(trim(key) // ' = ' // trim(val), h)
+  end do
+  call system_clock(t1)
+  call report('temp concat arg     ', n, t1 - t0, rate, 1)
+
+  call system_clock(t0)
+  call build(key, val, n, h)
+  call system_clock(t1)
+  call report('runtime temp arg    ', n, t1 - t0, rate, 1)
+
+  call system_clock(t0)
+  do i = 1, n
+    line = trim(key) // ' = ' // trim(val) // ';'
+    h = h + ichar(line(i/n+1:i/n+1))
+  end do
+  call system_clock(t1)
+  call report('concat to fixed lhs ', n, t1 - t0, rate, 1)
+
+  call system_clock(t0)
+  do i = 1, n
+    line = key(1:7) // ' = ' // val(1:5)
+    h = h + ichar(line(1:1))
+  end do
+  call system_clock(t1)
+  call report('substring concat    ', n, t1 - t0, rate, 1)
+
+  call system_clock(t0)
+  s = ''
+  do i = 1, n / 100
+    s = s // trim(val)
+  end do
+  call system_clock(t1)
+  h = h + len(s)
+  call report('grow deferred length', n / 100, t1 - t0, rate, 1)
+
+  print *, 'checksum', h
+end program
+
+! The temporaries for concatenations passed to an external procedure are
+! allocated by the runtime and released when the caller returns.
+
+subroutine build(key, val, n, h)
+  implicit none
+  character(*) :: key, val
+  integer :: n, h, i
+  do i = 1, n
+    call consume_ext(key(1:len_trim(key)) // ' = ' // val(1:len_trim(val)), h)
+  end do
+end subroutine
+
+subroutine consume_ext(s, h)
+  implicit none
+  character(*) :: s
+  integer :: h
+  h = h + len(s) + ichar(s(1:1))
+end subroutine
+
+subroutine report(what, n, ticks, rate, reps)
+  implicit none
+  character(*) :: what
+  integer :: n, reps
+  integer(8) :: ticks, rate
+  real(8) :: t
+
+  t = dble(ticks) / dble(rate) / reps
+  write(*, '(a, i10, f12.3, a, f10.3, a)') what, n, t * 1.0d3, ' ms', &
+      t * 1.0d9 / n, ' ns/elem'
+end subroutine
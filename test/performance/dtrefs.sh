@@ -0,0 +1,53 @@
+#!/bin/sh
+#
+# Copyright (c) 2017, NVIDIA CORPORATION.  All rights reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+# Compile-time benchmark for routines with many distinct references to
+# derived-type components and array elements.  Every statement names
+# new elements of nested components, so the names (NME) table and the
+# ILI hash tables of flang2 grow with the routine.  The time includes the
+# whole compilation to LLVM IR.
+#
+# usage: sh dtrefs.sh [statements ...]
+# The compiler is taken from $FLANG (default flang).
+
+FLANG=${FLANG:-flang}
+tmp=${TMPDIR:-/tmp}/dtrefs.$$
+trap 'rm -rf $tmp.d' 0
+mkdir $tmp.d || exit 1
+
+for n in ${*:-2500 5000 10000 20000}; do
+  awk -v n=$n 'BEGIN {
+    print "module dtrefs_m\n  implicit none"
+    print "  type t2\n    real(8) :: c(8), d(8)\n  end type"
+    printf "  type t1\n    type(t2) :: b(8)\n    real(8) :: v(%d), w(%d)\n  end type\n", n + 3, n + 3
+    print "end module"
+    print "subroutine dtrefs(x, y, z, s)\n  use dtrefs_m\n  implicit none"
+    print "  type(t1) :: x, y, z(4)\n  real(8) :: s"
+    for (k = 1; k <= n; k++) {
+      if (k % 2)
+        printf "  x%%v(%d) = y%%w(%d) + z(%d)%%v(%d) * s\n", k, k + 1, k % 4 + 1, k + 2
+      else
+        printf "  x%%b(%d)%%c(%d) = y%%b(%d)%%d(%d) + z(%d)%%w(%d)\n", k % 8 + 1, int(k / 8) % 8 + 1, int(k / 64) % 8 + 1, k % 8 + 1, k % 4 + 1, k
+    }
+    print "end subroutine"
+  }' > $tmp.d/dtrefs.f90
+  t0=$(date +%s%N)
+  (cd $tmp.d && $FLANG -O2 -S -emit-llvm dtrefs.f90 -o dtrefs.ll) || exit 1
+  t1=$(date +%s%N)
+  awk -v n=$n -v ns=$((t1 - t0)) 'BEGIN {
+    printf "dtrefs    %10d %12.3f ms %10.3f us/stmt\n", n, ns / 1.0e6, ns / 1.0e3 / n
+  }'
+done
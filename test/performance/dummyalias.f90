@@ -0,0 +1,139 @@
+!
+! Copyright (c) 2017, NVIDIA CORPORATION.  All rights reserved.
+!
+! Licensed under the Apache License, Version 2.0 (the "License");
+! you may not use this file except in compliance with the License.
+! You may obtain a copy of the License at
+!
+!     http://www.apache.org/licenses/LICENSE-2.0
+!
+! Unless required by applicable law or agreed to in writing, software
+! distributed under the License is distributed on an "AS IS" BASIS,
+! WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+! See the License for the specific language governing permissions and
+! limitations under the License.
+!
+
+! Benchmark for loops over dummy arguments, which flang2 marks noalias
+! when the dummies cannot be referenced through another name: AXPY, a
+! five-point stencil, a triad whose scalar is reloaded around a call, and
+! a sweep that calls a small kernel LLVM can inline.  Compare a build with
+! -Mx,222,1, which leaves the dummies unmarked; at -O1 flang2 emits no
+! TBAA metadata, so the difference is largest there.
+
+program dummyalias
+  implicit none
+  integer, parameter :: n = 4096, m = 512, reps = 20000
+  real(8), allocatable :: x(:), y(:), z(:), a(:, :), b(:, :)
+  integer(8) :: t0, t1, rate
+  integer :: k
+  real(8) :: s
+
+  allocate(x(n), y(n), z(n), a(m, m), b(m, m))
+  x = 1.0d0
+  y = 2.0d0
+  z = 0.5d0
+  a = 1.0d0
+  b = 0.0d0
+  call system_clock(t0, rate)
+
+  call system_clock(t0)
+  do k = 1, reps
+    call axpy(n, 1.0d-6, x, y)
+  end do
+  call system_clock(t1)
+  call report('axpy                ', n, t1 - t0, rate, reps)
+
+  call system_clock(t0)
+  do k = 1, reps / 200
+    call stencil(m, a, b)
+  end do
+  call system_clock(t1)
+  call report('5-point stencil     ', m * m, t1 - t0, rate, reps / 200)
+
+  call system_clock(t0)
+  do k = 1, reps / 10
+    call triad(n, 1.0d-6, x, y, z)
+  end do
+  call system_clock(t1)
+  call report('triad with call     ', n, t1 - t0, rate, reps / 10)
+
+  call system_clock(t0)
+  do k = 1, reps / 10
+    call sweep(n, x, y, z)
+  end do
+  call system_clock(t1)
+  call report('inlined kernel      ', n, t1 - t0, rate, reps / 10)
+
+  s = sum(y) + sum(z) + sum(b)
+  print *, 'checksum', s
+end program
+
+subroutine axpy(n, a, x, y)
+  implicit none
+  integer :: n, i
+  real(8) :: a, x(n), y(n)
+  do i = 1, n
+    y(i) = y(i) + a * x(i)
+  end do
+end subroutine
+
+subroutine stencil(n, a, b)
+  implicit none
+  integer :: n, i, j
+  real(8) :: a(n, n), b(n, n)
+  do j = 2, n - 1
+    do i = 2, n - 1
+      b(i, j) = 0.25d0 * (a(i - 1, j) + a(i + 1, j) + a(i, j - 1) + a(i, j + 1))
+    end do
+  end do
+end subroutine
+
+! Only the noalias dummy a can be kept in a register across the call.
+
+subroutine triad(n, a, x, y, z)
+  implicit none
+  integer :: n, i
+  real(8) :: a, x(n), y(n), z(n)
+  do i = 1, n
+    z(i) = x(i) + a * y(i)
+    if (z(i) < 0) call tick(i)
+  end do
+end subroutine
+
+subroutine tick(i)
+  implicit none
+  integer :: i
+  print *, 'negative at', i
+end subroutine
+
+! LLVM keeps the noalias information of update when it inlines it here.
+
+subroutine sweep(n, x, y, z)
+  implicit none
+  integer :: n
+  real(8) :: x(n), y(n), z(n)
+  call update(n, x, z)
+  call update(n, y, z)
+end subroutine
+
+subroutine update(n, u, v)
+  implicit none
+  integer :: n, i
+  real(8) :: u(n), v(n)
+  do i = 1, n
+    v(i) = 0.5d0 * (v(i) + u(i))
+  end do
+end subroutine
+
+subroutine report(what, n, ticks, rate, reps)
+  implicit none
+  character(*) :: what
+  integer :: n, reps
+  integer(8) :: ticks, rate
+  real(8) :: t
+
+  t = dble(ticks) / dble(rate) / reps
+  write(*, '(a, i10, f12.3, a, f10.3, a)') what, n, t * 1.0d3, ' ms', &
+      t * 1.0d9 / n, ' ns/elem'
+end subroutine
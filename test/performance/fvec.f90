@@ -0,0 +1,149 @@
+!
+! Copyright (c) 2017, NVIDIA CORPORATION.  All rights reserved.
+!
+! Licensed under the Apache License, Version 2.0 (the "License");
+! you may not use this file except in compliance with the License.
+! You may obtain a copy of the License at
+!
+!     http://www.apache.org/licenses/LICENSE-2.0
+!
+! Unless required by applicable law or agreed to in writing, software
+! distributed under the License is distributed on an "AS IS" BASIS,
+! WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+! See the License for the specific language governing permissions and
+! limitations under the License.
+!
+
+
+
+! Benchmark for array assignments that flang1 lowers to short vector code:
+! a masked square root, a MERGE, exp and an AXPY, in double and single
+! precision over arrays that fit in the L2 cache.  Compile a second time
+! with -Mx,224,1 to time the scalar loops for comparison.  Plain
+! arithmetic such as the AXPY is only lowered to vectors with -Mx,224,2;
+! by default it is left to the LLVM loop vectorizer.
+
+program fvec
+  implicit none
+  integer, parameter :: n = 4096, reps = 4000
+  real(8) :: x(n), y(n), z(n)
+  real(4) :: xs(n), ys(n), zs(n)
+  integer(8) :: t0, t1, rate
+  integer :: i, k
+  real(8) :: s
+
+  do i = 1, n
+    x(i) = sin(i * 0.37d0)
+    y(i) = 1.0d0 + i * 1.0d-4
+  end do
+  xs = real(x, 4)
+  ys = real(y, 4)
+  z = 0.0d0
+  zs = 0.0
+  s = 0.0d0
+  call system_clock(t0, rate)
+
+  call system_clock(t0)
+  do k = 1, reps
+    call dwsqrt(n, x, z)
+  end do
+  call system_clock(t1)
+  call report('where sqrt, real(8) ', n, t1 - t0, rate, reps)
+  s = s + sum(z)
+
+  call system_clock(t0)
+  do k = 1, reps
+    call swsqrt(n, xs, zs)
+  end do
+  call system_clock(t1)
+  call report('where sqrt, real(4) ', n, t1 - t0, rate, reps)
+  s = s + sum(zs)
+
+  call system_clock(t0)
+  do k = 1, reps
+    call dmerge(n, x, y, z)
+  end do
+  call system_clock(t1)
+  call report('merge, real(8)      ', n, t1 - t0, rate, reps)
+  s = s + sum(z)
+
+  call system_clock(t0)
+  do k = 1, reps
+    call dexpa(n, x, z)
+  end do
+  call system_clock(t1)
+  call report('exp, real(8)        ', n, t1 - t0, rate, reps)
+  s = s + sum(z)
+
+  call system_clock(t0)
+  do k = 1, reps
+    call sexpa(n, xs, zs)
+  end do
+  call system_clock(t1)
+  call report('exp, real(4)        ', n, t1 - t0, rate, reps)
+  s = s + sum(zs)
+
+  call system_clock(t0)
+  do k = 1, reps
+    call daxpy(n, 1.0d-6, x, y)
+  end do
+  call system_clock(t1)
+  call report('axpy, real(8)       ', n, t1 - t0, rate, reps)
+  s = s + sum(y)
+
+  print *, 'checksum', s
+end program
+
+subroutine dwsqrt(n, x, z)
+  implicit none
+  integer :: n
+  real(8) :: x(n), z(n)
+  where (x > 0.0d0) z = sqrt(x)
+end subroutine
+
+subroutine swsqrt(n, x, z)
+  implicit none
+  integer :: n
+  real(4) :: x(n), z(n)
+  where (x > 0.0) z = sqrt(x)
+end subroutine
+
+subroutine dmerge(n, x, y, z)
+  implicit none
+  integer :: n
+  real(8) :: x(n), y(n), z(n)
+  z = merge(x, y, x > 0.0d0)
+end subroutine
+
+subroutine dexpa(n, x, z)
+  implicit none
+  integer :: n
+  real(8) :: x(n), z(n)
+  z = exp(x)
+end subroutine
+
+subroutine sexpa(n, x, z)
+  implicit none
+  integer :: n
+  real(4) :: x(n), z(n)
+  z = exp(x)
+end subroutine
+
+subroutine daxpy(n, a, x, y)
+  implicit none
+  integer :: n
+  real(8) :: a, x(n), y(n)
+  y = y + a * x
+end subroutine
+
+subroutine report(what, n, ticks, rate, reps)
+  implicit none
+  character(*) :: what
+  integer :: n, reps
+  integer(8) :: ticks, rate
+  real(8) :: t
+
+  t = dble(ticks) / dble(rate) / reps
+  write(*, '(a, i10, f12.3, a, f10.3, a)') what, n, t * 1.0d3, ' ms', &
+      t * 1.0d9 / n, ' ns/elem'
+end subroutine
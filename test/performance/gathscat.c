@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2017, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/* Benchmark for the runtime's local gather-scatter copy loops, which
+   execute the element transfers of vector-subscript schedules.  Each
+   index pattern is timed through local_gathscat_WRAPPER and through a
+   plain indexed loop; the two results are also compared.  Link against
+   libflang:
+
+     cc -O2 gathscat.c -o gathscat -lflang -lflangrti -lm
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define KIND_REAL8 28 /* __REAL8 in the runtime's type codes */
+
+extern void local_gathscat_WRAPPER(int n, void *dst, int *sv, void *src,
+                                   int *gv, int kind);
+
+static double
+seconds(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1.0e-9;
+}
+
+static void
+plain(int n, double *dst, int *sv, double *src, int *gv)
+{
+  int i;
+  for (i = 0; i < n; ++i)
+    dst[sv[i]] = src[gv[i]];
+}
+
+/* fill v with a permutation of 0 .. n-1 made of runs of length run;
+   run == 1 gives a random permutation, run == n the identity */
+
+static void
+make_index(int *v, int n, int run)
+{
+  int nb = n / run, i, j, t;
+  int *blk = malloc(nb * sizeof(int));
+
+  for (i = 0; i < nb; ++i)
+    blk[i] = i;
+  for (i = nb - 1; i > 0; --i) {
+    j = rand() % (i + 1);
+    t = blk[i];
+    blk[i] = blk[j];
+    blk[j] = t;
+  }
+  for (i = 0; i < nb; ++i)
+    for (j = 0; j < run; ++j)
+      v[i * run + j] = blk[i] * run + j;
+  free(blk);
+}
+
+int
+main(void)
+{
+  enum { N = 1 << 22, REPS = 10 };
+  static const int runs[] = {1, 4, 32, 1024, N};
+  double *src = malloc(N * sizeof(double));
+  double *d1 = malloc(N * sizeof(double));
+  double *d2 = malloc(N * sizeof(double));
+  int *sv = malloc(N * sizeof(int));
+  int *gv = malloc(N * sizeof(int));
+  double t0, t1, t2;
+  int i, k, r;
+
+  for (i = 0; i < N; ++i)
+    src[i] = i;
+  srand(1);
+  for (r = 0; r < sizeof(runs) / sizeof(runs[0]); ++r) {
+    make_index(sv, N, runs[r]);
+    make_index(gv, N, runs[r]);
+    t0 = seconds();
+    for (k = 0; k < REPS; ++k)
+      plain(N, d1, sv, src, gv);
+    t1 = seconds();
+    for (k = 0; k < REPS; ++k)
+      local_gathscat_WRAPPER(N, d2, sv, src, gv, KIND_REAL8);
+    t2 = seconds();
+    printf("run %8d  loop %8.3f ms  runtime %8.3f ms  %s\n", runs[r],
+           (t1 - t0) * 1.0e3 / REPS, (t2 - t1) * 1.0e3 / REPS,
+           memcmp(d1, d2, N * sizeof(double)) ? "MISMATCH" : "ok");
+  }
+  return 0;
+}
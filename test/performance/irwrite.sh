@@ -0,0 +1,68 @@
+#!/bin/sh
+#
+# Copyright (c) 2017, NVIDIA CORPORATION.  All rights reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+
+# Compile-time benchmark for writing large LLVM IR modules.  The "data"
+# module has 40 modules' worth of initialized integer, real and double
+# precision arrays, so flang2 spends its time writing initializers; the
+# "code" module has many routines of straight-line code, so it writes
+# long runs of instructions with their constants, temporaries and !dbg
+# and !tbaa references.  Each is compiled with and without -g.  The
+# size of the .ll file is printed with the time.
+#
+# usage: sh irwrite.sh [elements ...]
+# The elements are the length of each initialized array; the code module
+# grows with them.  The compiler is taken from $FLANG (default flang).
+
+FLANG=${FLANG:-flang}
+tmp=${TMPDIR:-/tmp}/irwrite.$$
+trap 'rm -rf $tmp.d $tmp.ll' 0
+mkdir $tmp.d || exit 1
+
+for n in ${*:-5000 20000}; do
+  awk -v n=$n 'BEGIN {
+    for (k = 1; k <= 40; k++) {
+      printf "module irw%d\n  implicit none\n  integer, private :: i\n", k
+      printf "  real(8) :: d%d(%d) = [(real(i, 8) / 7.0d0, i = 1, %d)]\n", k, n, n
+      printf "  integer :: n%d(%d) = [(i * 37, i = 1, %d)]\n", k, n, n
+      printf "  real :: r%d(%d) = [(real(i) / 3.0, i = 1, %d)]\n", k, n, n
+      print "end module"
+    }
+  }' > $tmp.d/data.f90
+  awk -v n=$n 'BEGIN {
+    m = 200
+    for (k = 1; k <= n / m; k++) {
+      printf "subroutine irw%d(a, b, c, s, t)\n  implicit none\n", k
+      print "  real(8) :: a(*), b(*), c(*), s, t"
+      print "  integer :: i"
+      for (j = 1; j <= m; j++)
+        printf "  a(%d) = b(%d) * s + b(%d) * %d.5d0 + c(%d)\n", j, j, j + 1, j, j
+      printf "  do i = 1, %d\n    a(i) = a(i) + sqrt(b(i)) * c(i + 1)\n", m
+      print "  end do"
+      print "end subroutine"
+    }
+  }' > $tmp.d/code.f90
+  for src in data code; do
+    for g in "" -g; do
+      t0=$(date +%s%N)
+      (cd $tmp.d && $FLANG -O2 $g -S -emit-llvm $src.f90 -o $tmp.ll) || exit 1
+      t1=$(date +%s%N)
+      awk -v n=$n -v w="$src$g" -v ns=$((t1 - t0)) -v sz=$(wc -c < $tmp.ll) 'BEGIN {
+        printf "irwrite %-7s %8d %12.3f ms %10.1f MB\n", w, n, ns / 1.0e6, sz / 1.0e6
+      }'
+    done
+  done
+done
@@ -0,0 +1,56 @@
+#!/bin/sh
+#
+# Copyright (c) 2017, NVIDIA CORPORATION.  All rights reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+
+# Compile-time benchmark for loops made of many small conditional blocks,
+# each defining a scalar and an array element.  The flowgraph has a node
+# and a def or two per statement, so the run exercises the live variable
+# and reaching definition analysis of flang1's optimizer.  The time
+# includes the whole compilation to LLVM IR.
+#
+# usage: sh manybranch.sh [statements ...]
+# The compiler is taken from $FLANG (default flang).
+
+FLANG=${FLANG:-flang}
+tmp=${TMPDIR:-/tmp}/manybranch.$$
+trap 'rm -f $tmp.f90 $tmp.ll' 0
+
+for n in ${*:-1000 2000 4000 8000}; do
+  awk -v n=$n 'BEGIN {
+    nv = 2000
+    print "subroutine manybranch(a, m, k)"
+    print "  implicit none"
+    print "  integer :: m, k, i"
+    print "  real(8) :: a(m)"
+    for (j = 1; j <= nv; j++)
+      printf "  real(8) :: x%d\n", j
+    print "  do i = 1, m"
+    for (s = 1; s <= n; s++) {
+      j = (s * 7) % nv + 1
+      printf "  if (m > %d) then\n", s
+      printf "    x%d = k * %d\n    a(%d) = x%d\n", j, s, s, j
+      print "  end if"
+    }
+    print "  end do"
+    print "end subroutine"
+  }' > $tmp.f90
+  t0=$(date +%s%N)
+  $FLANG -O2 -S -emit-llvm $tmp.f90 -o $tmp.ll || exit 1
+  t1=$(date +%s%N)
+  awk -v n=$n -v ns=$((t1 - t0)) 'BEGIN {
+    printf "manybranch %10d %12.3f ms %10.3f us/stmt\n", n, ns / 1.0e6, ns / 1.0e3 / n
+  }'
+done
@@ -0,0 +1,53 @@
+#!/bin/sh
+#
+# Copyright (c) 2017, NVIDIA CORPORATION.  All rights reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+# Compile-time benchmark for files that reference very many global
+# names.  Each of 50 routines calls n/10 external procedures out of n and
+# uses n/50 common blocks, so flang2 enters n procedure names and n/50
+# common block names as global symbols and looks each one up again in
+# every routine that refers to it.  This exercises the global and
+# per-routine name tables of flang2's LLVM writer.
+#
+# usage: sh manyext.sh [n ...]
+# The compiler is taken from $FLANG (default flang).
+
+FLANG=${FLANG:-flang}
+tmp=${TMPDIR:-/tmp}/manyext.$$
+trap 'rm -rf $tmp.d' 0
+mkdir $tmp.d || exit 1
+
+for n in ${*:-5000 10000 20000}; do
+  awk -v n=$n 'BEGIN {
+    for (r = 0; r < 50; r++) {
+      printf "subroutine r%d(x)\n  real(8) :: x\n", r
+      for (k = 0; k < n / 50; k++) {
+        c = (r * 7 + k) % (n / 50)
+        printf "  common /c%d/ a%d\n  real(8) :: a%d\n", c, c, c
+      }
+      for (k = 0; k < n / 10; k++)
+        printf "  call e%d(x)\n", (r * 131 + k * 5) % n
+      for (k = 0; k < n / 50; k++)
+        printf "  x = x + a%d\n", (r * 7 + k) % (n / 50)
+      print "end subroutine"
+    }
+  }' > $tmp.d/manyext.f90
+  t0=$(date +%s%N)
+  (cd $tmp.d && $FLANG -O2 -S -emit-llvm manyext.f90 -o manyext.ll) || exit 1
+  t1=$(date +%s%N)
+  awk -v n=$n -v ns=$((t1 - t0)) 'BEGIN {
+    printf "manyext   %10d %12.3f ms\n", n, ns / 1.0e6
+  }'
+done
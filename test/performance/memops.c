@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2017, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/* Bandwidth benchmark for the runtime's __c_mcopy8, __c_mset8 and
+   __c_mzero8, which the compiler calls for array assignment and
+   initialization, against a plain element loop (the old implementation)
+   and the C library's memcpy and memset.  Sizes run from 1 KB, which fits
+   in the L1 cache, to 256 MB, where the non-temporal stores take over.
+   Link against libflangrti:
+
+     cc -O2 memops.c -o memops -lflangrti -lm
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+extern void __c_mcopy8(long long *dest, long long *src, long cnt);
+extern void __c_mset8(long long *dest, long long value, long cnt);
+extern void __c_mzero8(long long *dest, long cnt);
+
+static double
+seconds(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1.0e-9;
+}
+
+/* the old element loops, kept from being turned into library calls */
+
+static void __attribute__((noinline,
+                           optimize("no-tree-loop-distribute-patterns")))
+loop_copy(long long *dest, long long *src, long cnt)
+{
+  long i;
+  for (i = 0; i < cnt; i++)
+    dest[i] = src[i];
+}
+
+static void __attribute__((noinline,
+                           optimize("no-tree-loop-distribute-patterns")))
+loop_set(long long *dest, long long value, long cnt)
+{
+  long i;
+  for (i = 0; i < cnt; i++)
+    dest[i] = value;
+}
+
+int
+main(void)
+{
+  enum { MAXBYTES = 256 << 20 };
+  long long *a = malloc(MAXBYTES), *b = malloc(MAXBYTES);
+  long bytes, cnt, reps, r;
+  double t, bw[6];
+  int k;
+
+  memset(a, 1, MAXBYTES);
+  memset(b, 2, MAXBYTES);
+  printf("%10s %10s %10s %10s %10s %10s %10s   (GB/s, bytes written)\n",
+         "bytes", "mcopy8", "loop", "memcpy", "mset8", "loop", "memset");
+  for (bytes = 1024; bytes <= MAXBYTES; bytes *= 4) {
+    cnt = bytes / 8;
+    reps = (1L << 30) / bytes;
+    if (reps < 4)
+      reps = 4;
+    for (k = 0; k < 6; ++k) {
+      t = seconds();
+      for (r = 0; r < reps; ++r) {
+        switch (k) {
+        case 0:
+          __c_mcopy8(a, b, cnt);
+          break;
+        case 1:
+          loop_copy(a, b, cnt);
+          break;
+        case 2:
+          memcpy(a, b, bytes);
+          break;
+        case 3:
+          __c_mset8(a, r, cnt);
+          break;
+        case 4:
+          loop_set(a, r, cnt);
+          break;
+        case 5:
+          memset(a, (int)r, bytes);
+          break;
+        }
+        __asm__ __volatile__("" : : "r"(a) : "memory");
+      }
+      bw[k] = (double)bytes * reps / (seconds() - t) * 1.0e-9;
+    }
+    printf("%10ld %10.2f %10.2f %10.2f %10.2f %10.2f %10.2f\n", bytes, bw[0],
+           bw[1], bw[2], bw[3], bw[4], bw[5]);
+  }
+  __c_mzero8(a, MAXBYTES / 8);
+  printf("checksum %lld\n", a[MAXBYTES / 8 - 1] + b[0]);
+  free(a);
+  free(b);
+  return 0;
+}
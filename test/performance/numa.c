@@ -0,0 +1,214 @@
+/*
+ * Copyright (c) 2017, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+
+/* Memory bandwidth of a parallel triad on arrays placed on the NUMA nodes
+   in four ways, through the placement routines in libflangrti:
+     first touch    one thread initializes, so every page lands on its node
+                    (what a large ALLOCATE gets by default)
+     touch          _mp_numa_touch first, so each node holds the part of
+                    the arrays its threads work on (F90_NUMA_TOUCH=1)
+     interleave     _mp_numa_place round robin (F90_NUMA=interleave)
+     local + touch  both (F90_NUMA=local F90_NUMA_TOUCH=1)
+   The triad runs on one thread per CPU, bound to the CPUs of the nodes in
+   node order like OMP_PROC_BIND=close, each on a contiguous block.  The
+   pages per node are counted with get_mempolicy.  On a machine with one
+   memory node all placements are the same, and the program says so and
+   measures what the placement costs.  Link against libflangrti:
+
+     cc -O2 numa.c -o numa -lflangrti -lpthread -lm
+ */
+
+#define _GNU_SOURCE
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define MP_NUMA_LOCAL 1
+#define MP_NUMA_INTERLEAVE 2
+#define MPOL_F_NODE (1 << 0)
+#define MPOL_F_ADDR (1 << 1)
+#define MAXTHR 256
+#define MAXNODES 64
+
+extern int _mp_numa_nodes(void);
+extern void _mp_numa_place(void *p, size_t n, int policy);
+extern void _mp_numa_touch(void *p, size_t n);
+extern long get_mempolicy(int *mode, unsigned long *nmask,
+                          unsigned long maxnode, void *addr,
+                          unsigned long flags);
+
+static long n;
+static int nthr;
+static double *a, *b, *c;
+static pthread_barrier_t bar;
+
+static double
+seconds(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1.0e-9;
+}
+
+/* bind the calling thread to the CPUs of a node */
+static void
+bind_node(int node)
+{
+  char path[64], buf[1024], *p;
+  cpu_set_t cpus;
+  long lo, hi;
+  FILE *f;
+
+  sprintf(path, "/sys/devices/system/node/node%d/cpulist", node);
+  if ((f = fopen(path, "r")) == NULL)
+    return;
+  p = fgets(buf, sizeof(buf), f);
+  fclose(f);
+  if (p == NULL)
+    return;
+  CPU_ZERO(&cpus);
+  while (*p >= '0' && *p <= '9') {
+    lo = hi = strtol(p, &p, 10);
+    if (*p == '-')
+      hi = strtol(p + 1, &p, 10);
+    for (; lo <= hi && lo < CPU_SETSIZE; ++lo)
+      CPU_SET(lo, &cpus);
+    if (*p == ',')
+      ++p;
+  }
+  pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+}
+
+static void *
+triad(void *arg)
+{
+  long t = (long)arg;
+  long lo = n * t / nthr, hi = n * (t + 1) / nthr, i;
+  int r;
+
+  bind_node(t * _mp_numa_nodes() / nthr);
+  pthread_barrier_wait(&bar);
+  for (r = 0; r < 10; ++r) {
+    for (i = lo; i < hi; ++i)
+      a[i] = b[i] + 3.0 * c[i];
+    pthread_barrier_wait(&bar);
+  }
+  return NULL;
+}
+
+/* the triad's bandwidth in GB/s, counting 3 arrays per iteration */
+static double
+run(void)
+{
+  pthread_t thr[MAXTHR];
+  double t;
+  long i;
+
+  pthread_barrier_init(&bar, NULL, nthr + 1);
+  for (i = 0; i < nthr; ++i)
+    pthread_create(&thr[i], NULL, triad, (void *)i);
+  pthread_barrier_wait(&bar);
+  t = seconds();
+  for (i = 0; i < 10; ++i)
+    pthread_barrier_wait(&bar);
+  t = seconds() - t;
+  for (i = 0; i < nthr; ++i)
+    pthread_join(thr[i], NULL);
+  pthread_barrier_destroy(&bar);
+  return 3.0 * sizeof(double) * n * 10 / t * 1.0e-9;
+}
+
+/* the percentage of the pages of x on each node, as text */
+static char *
+spread(double *x, char *out)
+{
+  long cnt[MAXNODES] = {0}, pg = sysconf(_SC_PAGESIZE), i, tot = 0;
+  int node, k;
+  char *p = out;
+
+  for (i = 0; i < n * (long)sizeof(double); i += 64 * pg) {
+    if (get_mempolicy(&node, NULL, 0, (char *)x + i, MPOL_F_NODE | MPOL_F_ADDR)
+            == 0 && node >= 0 && node < MAXNODES) {
+      ++cnt[node];
+      ++tot;
+    }
+  }
+  *p = '\0';
+  for (k = 0; k < MAXNODES && tot; ++k)
+    if (cnt[k])
+      p += sprintf(p, " %d:%ld%%", k, cnt[k] * 100 / tot);
+  return out;
+}
+
+int
+main(int argc, char **argv)
+{
+  static const char *name[] = {"first touch", "touch", "interleave",
+                               "local + touch"};
+  size_t bytes;
+  double init, bw;
+  char where[512];
+  int nodes, k;
+
+  n = (argc > 1 ? atol(argv[1]) : 64L << 20) / sizeof(double);
+  bytes = n * sizeof(double);
+  nthr = sysconf(_SC_NPROCESSORS_ONLN);
+  if (nthr > MAXTHR)
+    nthr = MAXTHR;
+  nodes = _mp_numa_nodes();
+  printf("%d memory node%s, %d threads, 3 arrays of %ld MB\n", nodes,
+         nodes > 1 ? "s" : "", nthr, (long)(bytes >> 20));
+  if (nodes == 1)
+    printf("one node: the placements only differ in what they cost\n");
+  printf("%-14s %10s %10s   %s\n", "placement", "init ms", "GB/s",
+         "pages of a per node");
+  for (k = 0; k < 4; ++k) {
+    a = aligned_alloc(4096, bytes);
+    b = aligned_alloc(4096, bytes);
+    c = aligned_alloc(4096, bytes);
+    if (a == NULL || b == NULL || c == NULL) {
+      fprintf(stderr, "out of memory\n");
+      return 1;
+    }
+    init = seconds();
+    if (k == 2 || k == 3) {
+      _mp_numa_place(a, bytes, k == 2 ? MP_NUMA_INTERLEAVE : MP_NUMA_LOCAL);
+      _mp_numa_place(b, bytes, k == 2 ? MP_NUMA_INTERLEAVE : MP_NUMA_LOCAL);
+      _mp_numa_place(c, bytes, k == 2 ? MP_NUMA_INTERLEAVE : MP_NUMA_LOCAL);
+    }
+    if (k == 1 || k == 3) {
+      _mp_numa_touch(a, bytes);
+      _mp_numa_touch(b, bytes);
+      _mp_numa_touch(c, bytes);
+    }
+    memset(b, 0, bytes);
+    memset(c, 0, bytes);
+    memset(a, 0, bytes);
+    init = (seconds() - init) * 1.0e3;
+    bw = run();
+    printf("%-14s %10.1f %10.2f  %s\n", name[k], init, bw, spread(a, where));
+    free(a);
+    free(b);
+    free(c);
+  }
+  return 0;
+}
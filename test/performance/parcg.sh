@@ -0,0 +1,58 @@
+#!/bin/sh
+#
+# Copyright (c) 2017, NVIDIA CORPORATION.  All rights reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+
+# Compile-time benchmark for parallel code generation in flang2
+# (-Mx,217,n).  One source file holds a module and many routines with
+# loops and straight-line code, and is compiled with 1, 2, 4 and 8
+# workers.  The wall time is printed with the size of the .ll file, which
+# should not depend on the number of workers; the speedup is bounded by
+# the number of CPUs.
+#
+# usage: sh parcg.sh [routines ...]
+# The compiler is taken from $FLANG (default flang).
+
+FLANG=${FLANG:-flang}
+tmp=${TMPDIR:-/tmp}/parcg.$$
+trap 'rm -rf $tmp.d $tmp.ll' 0
+mkdir $tmp.d || exit 1
+
+for n in ${*:-200 1000}; do
+  awk -v n=$n 'BEGIN {
+    print "module pcg\n  implicit none\n  real(8) :: w(1000)\n  integer :: calls = 0\nend module"
+    for (k = 1; k <= n; k++) {
+      printf "subroutine pcg%d(a, b, m)\n  use pcg\n  implicit none\n", k
+      print "  integer :: m, i, j"
+      print "  real(8) :: a(m, m), b(m), s"
+      print "  s = 0"
+      print "  do j = 1, m\n    do i = 1, m"
+      printf "      a(i, j) = a(i, j) * %d.5d0 + b(i) * w(j)\n", k
+      print "      s = s + a(i, j)\n    end do\n  end do"
+      for (j = 1; j <= 40; j++)
+        printf "  b(%d) = b(%d) + s * %d.0d0 - w(%d)\n", j, j + 1, j, j
+      print "  calls = calls + 1"
+      print "end subroutine"
+    }
+  }' > $tmp.d/code.f90
+  for w in 1 2 4 8; do
+    t0=$(date +%s%N)
+    (cd $tmp.d && $FLANG -O2 -Mx,217,$w -S -emit-llvm code.f90 -o $tmp.ll) || exit 1
+    t1=$(date +%s%N)
+    awk -v n=$n -v w=$w -v ns=$((t1 - t0)) -v sz=$(wc -c < $tmp.ll) 'BEGIN {
+      printf "parcg %6d routines %2d workers %12.3f ms %10.1f MB\n", n, w, ns / 1.0e6, sz / 1.0e6
+    }'
+  done
+done
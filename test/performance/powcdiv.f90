@@ -0,0 +1,146 @@
+!
+! Copyright (c) 2017, NVIDIA CORPORATION.  All rights reserved.
+!
+! Licensed under the Apache License, Version 2.0 (the "License");
+! you may not use this file except in compliance with the License.
+! You may obtain a copy of the License at
+!
+!     http://www.apache.org/licenses/LICENSE-2.0
+!
+! Unless required by applicable law or agreed to in writing, software
+! distributed under the License is distributed on an "AS IS" BASIS,
+! WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+! See the License for the specific language governing permissions and
+! limitations under the License.
+!
+
+
+
+! Benchmark for powers with a constant integer exponent and for complex
+! division: x**13 and x**(-3) in double precision, i**13 in integer, and
+! complex division in single and double precision, over arrays that fit
+! in the L2 cache.  By default flang2 expands the powers to multiplies and
+! the division inline; compile a second time with -Mx,124,0x200 (powers)
+! or -Mx,225,1 (division) to time the runtime calls for comparison.
+
+program powcdiv
+  implicit none
+  integer, parameter :: n = 4096, reps = 4000
+  real(8) :: x(n), y(n)
+  integer :: ia(n), ib(n)
+  complex :: a(n), b(n), c(n)
+  complex(8) :: za(n), zb(n), zc(n)
+  integer(8) :: t0, t1, rate
+  integer :: i, k
+  real(8) :: s
+
+  do i = 1, n
+    x(i) = 0.9d0 + i * 5.0d-5
+    ia(i) = mod(i, 7) - 3
+    a(i) = cmplx(sin(i * 0.1), cos(i * 0.3))
+    b(i) = cmplx(1.0 + mod(i, 5), 0.5 - mod(i, 3))
+  end do
+  za = a
+  zb = b
+  s = 0.0d0
+  call system_clock(t0, rate)
+
+  call system_clock(t0)
+  do k = 1, reps
+    call dpow13(n, x, y)
+  end do
+  call system_clock(t1)
+  call report('x**13, real(8)      ', n, t1 - t0, rate, reps)
+  s = s + sum(y)
+
+  call system_clock(t0)
+  do k = 1, reps
+    call dpowm3(n, x, y)
+  end do
+  call system_clock(t1)
+  call report('x**(-3), real(8)    ', n, t1 - t0, rate, reps)
+  s = s + sum(y)
+
+  call system_clock(t0)
+  do k = 1, reps
+    call ipow13(n, ia, ib)
+  end do
+  call system_clock(t1)
+  call report('i**13, integer      ', n, t1 - t0, rate, reps)
+  s = s + sum(ib)
+
+  call system_clock(t0)
+  do k = 1, reps
+    call cdivl(n, a, b, c)
+  end do
+  call system_clock(t1)
+  call report('a/b, complex(4)     ', n, t1 - t0, rate, reps)
+  s = s + real(sum(c))
+
+  call system_clock(t0)
+  do k = 1, reps
+    call zdivl(n, za, zb, zc)
+  end do
+  call system_clock(t1)
+  call report('a/b, complex(8)     ', n, t1 - t0, rate, reps)
+  s = s + real(sum(zc))
+
+  print *, 'checksum', s
+end program
+
+subroutine dpow13(n, x, y)
+  implicit none
+  integer :: n, i
+  real(8) :: x(n), y(n)
+  do i = 1, n
+    y(i) = x(i) ** 13
+  end do
+end subroutine
+
+subroutine dpowm3(n, x, y)
+  implicit none
+  integer :: n, i
+  real(8) :: x(n), y(n)
+  do i = 1, n
+    y(i) = x(i) ** (-3)
+  end do
+end subroutine
+
+subroutine ipow13(n, ia, ib)
+  implicit none
+  integer :: n, i
+  integer :: ia(n), ib(n)
+  do i = 1, n
+    ib(i) = ia(i) ** 13
+  end do
+end subroutine
+
+subroutine cdivl(n, a, b, c)
+  implicit none
+  integer :: n, i
+  complex :: a(n), b(n), c(n)
+  do i = 1, n
+    c(i) = a(i) / b(i)
+  end do
+end subroutine
+
+subroutine zdivl(n, a, b, c)
+  implicit none
+  integer :: n, i
+  complex(8) :: a(n), b(n), c(n)
+  do i = 1, n
+    c(i) = a(i) / b(i)
+  end do
+end subroutine
+
+subroutine report(what, n, ticks, rate, reps)
+  implicit none
+  character(*) :: what
+  integer :: n, reps
+  integer(8) :: ticks, rate
+  real(8) :: t
+
+  t = dble(ticks) / dble(rate) / reps
+  write(*, '(a, i10, f12.3, a, f10.3, a)') what, n, t * 1.0d3, ' ms', &
+      t * 1.0d9 / n, ' ns/elem'
+end subroutine
@@ -0,0 +1,156 @@
+!
+! Copyright (c) 2017, NVIDIA CORPORATION.  All rights reserved.
+!
+! Licensed under the Apache License, Version 2.0 (the "License");
+! you may not use this file except in compliance with the License.
+! You may obtain a copy of the License at
+!
+!     http://www.apache.org/licenses/LICENSE-2.0
+!
+! Unless required by applicable law or agreed to in writing, software
+! distributed under the License is distributed on an "AS IS" BASIS,
+! WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+! See the License for the specific language governing permissions and
+! limitations under the License.
+!
+
+! Benchmark for PREFETCH directives with a distance on streaming kernels
+! whose arrays are much larger than the caches: a triad, a sum and a copy,
+! each without and with prefetching 64 iterations ahead.  Loads are
+! prefetched into all cache levels; the stored arrays are prefetched for
+! writing.  A loop containing a prefetch is not vectorized by LLVM, so the
+! directive can make a loop that is already vectorized slower.
+
+program prefetch
+  implicit none
+  integer, parameter :: n = 2**24, reps = 10
+  real(8), allocatable :: x(:), y(:), z(:)
+  integer(8) :: t0, t1, rate
+  integer :: k
+  real(8) :: s, s1
+
+  allocate(x(n), y(n), z(n))
+  x = 1.0d0
+  y = 2.0d0
+  z = 0.5d0
+  s = 0.0d0
+  call system_clock(t0, rate)
+
+  call system_clock(t0)
+  do k = 1, reps
+    call triad(n, 1.0d-6, x, y, z)
+  end do
+  call system_clock(t1)
+  call report('triad               ', n, t1 - t0, rate, reps)
+
+  call system_clock(t0)
+  do k = 1, reps
+    call triadp(n, 1.0d-6, x, y, z)
+  end do
+  call system_clock(t1)
+  call report('triad, prefetch     ', n, t1 - t0, rate, reps)
+
+  call system_clock(t0)
+  do k = 1, reps
+    call asum(n, x, y, s1)
+    s = s + s1
+  end do
+  call system_clock(t1)
+  call report('sum                 ', n, t1 - t0, rate, reps)
+
+  call system_clock(t0)
+  do k = 1, reps
+    call asump(n, x, y, s1)
+    s = s + s1
+  end do
+  call system_clock(t1)
+  call report('sum, prefetch       ', n, t1 - t0, rate, reps)
+
+  call system_clock(t0)
+  do k = 1, reps
+    call copy(n, x, z)
+  end do
+  call system_clock(t1)
+  call report('copy                ', n, t1 - t0, rate, reps)
+
+  call system_clock(t0)
+  do k = 1, reps
+    call copyp(n, x, z)
+  end do
+  call system_clock(t1)
+  call report('copy, prefetch      ', n, t1 - t0, rate, reps)
+
+  s = s + sum(z)
+  print *, 'checksum', s
+end program
+
+subroutine triad(n, a, x, y, z)
+  implicit none
+  integer :: n, i
+  real(8) :: a, x(n), y(n), z(n)
+  do i = 1, n
+    z(i) = x(i) + a * y(i)
+  end do
+end subroutine
+
+subroutine triadp(n, a, x, y, z)
+  implicit none
+  integer :: n, i
+  real(8) :: a, x(n), y(n), z(n)
+  do i = 1, n
+!dir$ prefetch x(i):3:64, y(i):3:64, z(i):3:64
+    z(i) = x(i) + a * y(i)
+  end do
+end subroutine
+
+subroutine asum(n, x, y, s)
+  implicit none
+  integer :: n, i
+  real(8) :: x(n), y(n), s
+  s = 0.0d0
+  do i = 1, n
+    s = s + x(i) * y(i)
+  end do
+end subroutine
+
+subroutine asump(n, x, y, s)
+  implicit none
+  integer :: n, i
+  real(8) :: x(n), y(n), s
+  s = 0.0d0
+  do i = 1, n
+!dir$ prefetch x(i):3:64, y(i):3:64
+    s = s + x(i) * y(i)
+  end do
+end subroutine
+
+subroutine copy(n, x, z)
+  implicit none
+  integer :: n, i
+  real(8) :: x(n), z(n)
+  do i = 1, n
+    z(i) = x(i)
+  end do
+end subroutine
+
+subroutine copyp(n, x, z)
+  implicit none
+  integer :: n, i
+  real(8) :: x(n), z(n)
+  do i = 1, n
+!dir$ prefetch x(i):3:64, z(i):3:64
+    z(i) = x(i)
+  end do
+end subroutine
+
+subroutine report(what, n, ticks, rate, reps)
+  implicit none
+  character(*) :: what
+  integer :: n, reps
+  integer(8) :: ticks, rate
+  real(8) :: t
+
+  t = dble(ticks) / dble(rate) / reps
+  write(*, '(a, i10, f12.3, a, f10.3, a)') what, n, t * 1.0d3, ' ms', &
+      t * 1.0d9 / n, ' ns/elem'
+end subroutine
@@ -0,0 +1,129 @@
+!
+! Copyright (c) 2017, NVIDIA CORPORATION.  All rights reserved.
+!
+! Licensed under the Apache License, Version 2.0 (the "License");
+! you may not use this file except in compliance with the License.
+! You may obtain a copy of the License at
+!
+!     http://www.apache.org/licenses/LICENSE-2.0
+!
+! Unless required by applicable law or agreed to in writing, software
+! distributed under the License is distributed on an "AS IS" BASIS,
+! WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+! See the License for the specific language governing permissions and
+! limitations under the License.
+!
+
+! Benchmark for CSHIFT, EOSHIFT and TRANSPOSE.  Each operation is timed on
+! a whole contiguous array and on an equally sized section of a larger
+! array.  The compiler usually expands TRANSPOSE inline, so those lines
+! measure generated code rather than the runtime routine.
+
+program shift_transpose
+  implicit none
+  integer, parameter :: n1 = 100, n2 = 100, n3 = 100, nt = 1000, reps = 10
+  real(8), allocatable :: a(:,:,:), r(:,:,:), w(:,:,:), rw(:,:,:)
+  real(8), allocatable :: m8(:,:), t8(:,:), mw8(:,:), tw8(:,:)
+  real(4), allocatable :: m4(:,:), t4(:,:)
+  integer(8) :: t0, t1, rate
+  integer :: i, j, k, d
+  real(8) :: chk
+  character(len=20) :: what
+
+  allocate(a(n1,n2,n3), r(n1,n2,n3), w(n1+1,n2,n3), rw(n1+1,n2,n3))
+  allocate(m8(nt,nt), t8(nt,nt), mw8(nt+1,nt), tw8(nt+1,nt))
+  allocate(m4(nt,nt), t4(nt,nt))
+  do k = 1, n3
+    do j = 1, n2
+      do i = 1, n1
+        a(i,j,k) = i + 1000*j + 1000000*k
+      end do
+    end do
+  end do
+  w(1:n1,:,:) = a
+  do j = 1, nt
+    do i = 1, nt
+      m8(i,j) = i - j
+    end do
+  end do
+  mw8(1:nt,:) = m8
+  m4 = m8
+  chk = 0.0d0
+  call system_clock(t0, rate)
+
+  do d = 1, 3
+    call system_clock(t0)
+    do k = 1, reps
+      r = cshift(a, 7, d)
+    end do
+    call system_clock(t1)
+    chk = chk + r(1,1,1)
+    write(what, '(a, i1, a)') 'cshift   dim=', d, ' cont'
+    call report(what, n1*n2*n3, t1 - t0, rate, reps)
+
+    call system_clock(t0)
+    do k = 1, reps
+      rw(1:n1,:,:) = cshift(w(1:n1,:,:), 7, d)
+    end do
+    call system_clock(t1)
+    chk = chk + rw(1,1,1)
+    write(what, '(a, i1, a)') 'cshift   dim=', d, ' sect'
+    call report(what, n1*n2*n3, t1 - t0, rate, reps)
+
+    call system_clock(t0)
+    do k = 1, reps
+      r = eoshift(a, -7, 0.0d0, d)
+    end do
+    call system_clock(t1)
+    chk = chk + r(n1,n2,n3)
+    write(what, '(a, i1, a)') 'eoshift  dim=', d, ' cont'
+    call report(what, n1*n2*n3, t1 - t0, rate, reps)
+
+    call system_clock(t0)
+    do k = 1, reps
+      rw(1:n1,:,:) = eoshift(w(1:n1,:,:), -7, 0.0d0, d)
+    end do
+    call system_clock(t1)
+    chk = chk + rw(n1,n2,n3)
+    write(what, '(a, i1, a)') 'eoshift  dim=', d, ' sect'
+    call report(what, n1*n2*n3, t1 - t0, rate, reps)
+  end do
+
+  call system_clock(t0)
+  do k = 1, reps
+    t8 = transpose(m8)
+  end do
+  call system_clock(t1)
+  chk = chk + t8(nt,1)
+  call report('transpose r8 cont   ', nt*nt, t1 - t0, rate, reps)
+
+  call system_clock(t0)
+  do k = 1, reps
+    tw8(1:nt,:) = transpose(mw8(1:nt,:))
+  end do
+  call system_clock(t1)
+  chk = chk + tw8(nt,1)
+  call report('transpose r8 sect   ', nt*nt, t1 - t0, rate, reps)
+
+  call system_clock(t0)
+  do k = 1, reps
+    t4 = transpose(m4)
+  end do
+  call system_clock(t1)
+  chk = chk + t4(nt,1)
+  call report('transpose r4 cont   ', nt*nt, t1 - t0, rate, reps)
+
+  print *, 'checksum', chk
+end program
+
+subroutine report(what, n, ticks, rate, reps)
+  implicit none
+  character(*) :: what
+  integer :: n, reps
+  integer(8) :: ticks, rate
+  real(8) :: t
+
+  t = dble(ticks) / dble(rate) / reps
+  write(*, '(a, i10, f12.3, a, f10.3, a)') what, n, t * 1.0d3, ' ms', &
+      t * 1.0d9 / n, ' ns/elem'
+end subroutine
@@ -0,0 +1,128 @@
+!
+! Copyright (c) 2017, NVIDIA CORPORATION.  All rights reserved.
+!
+! Licensed under the Apache License, Version 2.0 (the "License");
+! you may not use this file except in compliance with the License.
+! You may obtain a copy of the License at
+!
+!     http://www.apache.org/licenses/LICENSE-2.0
+!
+! Unless required by applicable law or agreed to in writing, software
+! distributed under the License is distributed on an "AS IS" BASIS,
+! WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+! See the License for the specific language governing permissions and
+! limitations under the License.
+!
+
+
+
+
+! Benchmark for reductions of short vectors: SUM, MAXVAL, DOT_PRODUCT,
+! COUNT and MINLOC of 10 to 100 elements, called often enough that the
+! per-call overhead of a runtime reduction would dominate.  flang1
+! expands these inline; compile a second time with -Mx,47,0x80 to call
+! the runtime for comparison.
+
+program shortred
+  implicit none
+  integer, parameter :: nmax = 100, reps = 2000000
+  integer, parameter :: lens(4) = (/ 10, 25, 50, 100 /)
+  real(8) :: x(nmax), y(nmax)
+  integer(8) :: t0, t1, rate
+  integer :: i, j, k, n
+  real(8) :: s
+
+  do i = 1, nmax
+    x(i) = sin(i * 0.7d0)
+    y(i) = cos(i * 0.3d0)
+  end do
+  s = 0.0d0
+  call system_clock(t0, rate)
+
+  do j = 1, size(lens)
+    n = lens(j)
+    call system_clock(t0)
+    do k = 1, reps
+      s = s + rsum(n, x)
+    end do
+    call system_clock(t1)
+    call report('sum                 ', n, t1 - t0, rate, reps)
+
+    call system_clock(t0)
+    do k = 1, reps
+      s = s + rmaxval(n, x)
+    end do
+    call system_clock(t1)
+    call report('maxval              ', n, t1 - t0, rate, reps)
+
+    call system_clock(t0)
+    do k = 1, reps
+      s = s + rdot(n, x, y)
+    end do
+    call system_clock(t1)
+    call report('dot_product         ', n, t1 - t0, rate, reps)
+
+    call system_clock(t0)
+    do k = 1, reps
+      s = s + rcount(n, x)
+    end do
+    call system_clock(t1)
+    call report('count               ', n, t1 - t0, rate, reps)
+
+    call system_clock(t0)
+    do k = 1, reps
+      s = s + rminloc(n, x)
+    end do
+    call system_clock(t1)
+    call report('minloc              ', n, t1 - t0, rate, reps)
+  end do
+
+  print *, 'checksum', s
+
+contains
+
+  real(8) function rsum(n, x)
+    integer :: n
+    real(8) :: x(n)
+    rsum = sum(x)
+  end function
+
+  real(8) function rmaxval(n, x)
+    integer :: n
+    real(8) :: x(n)
+    rmaxval = maxval(x)
+  end function
+
+  real(8) function rdot(n, x, y)
+    integer :: n
+    real(8) :: x(n), y(n)
+    rdot = dot_product(x, y)
+  end function
+
+  real(8) function rcount(n, x)
+    integer :: n
+    real(8) :: x(n)
+    rcount = count(x > 0.0d0)
+  end function
+
+  real(8) function rminloc(n, x)
+    integer :: n
+    real(8) :: x(n)
+    integer :: l(1)
+    l = minloc(x)
+    rminloc = l(1)
+  end function
+
+end program
+
+subroutine report(what, n, ticks, rate, reps)
+  implicit none
+  character(*) :: what
+  integer :: n, reps
+  integer(8) :: ticks, rate
+  real(8) :: t
+
+  t = dble(ticks) / dble(rate) / reps
+  write(*, '(a, i10, f12.3, a, f10.3, a)') what, n, t * 1.0d6, ' us', &
+      t * 1.0d9 / n, ' ns/elem'
+end subroutine
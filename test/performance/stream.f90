@@ -0,0 +1,157 @@
+!
+! Copyright (c) 2017, NVIDIA CORPORATION.  All rights reserved.
+!
+! Licensed under the Apache License, Version 2.0 (the "License");
+! you may not use this file except in compliance with the License.
+! You may obtain a copy of the License at
+!
+!     http://www.apache.org/licenses/LICENSE-2.0
+!
+! Unless required by applicable law or agreed to in writing, software
+! distributed under the License is distributed on an "AS IS" BASIS,
+! WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+! See the License for the specific language governing permissions and
+! limitations under the License.
+!
+
+
+! Benchmark for the STREAM directive, which makes the vector stores of an
+! array assignment non-temporal: a fill, a copy and a triad over arrays
+! much larger than the caches, each without and with the directive, and
+! the triad again on arrays that fit in the cache, where streaming the
+! result to memory is a loss.  The bandwidth counts the bytes the kernel
+! reads and writes, not the extra read of a destination that is written
+! through the cache.
+
+program stream
+  implicit none
+  integer, parameter :: n = 2**24, nsmall = 2**12, reps = 10
+  real(8), allocatable :: x(:), y(:), z(:)
+  integer(8) :: t0, t1, rate
+  integer :: k
+  real(8) :: s
+
+  allocate(x(n), y(n), z(n))
+  x = 1.0d0
+  y = 2.0d0
+  z = 0.5d0
+  call system_clock(t0, rate)
+
+  call system_clock(t0)
+  do k = 1, reps
+    call fill(n, z)
+  end do
+  call system_clock(t1)
+  call report('fill                ', n, 8, t1 - t0, rate, reps)
+
+  call system_clock(t0)
+  do k = 1, reps
+    call fills(n, z)
+  end do
+  call system_clock(t1)
+  call report('fill, stream        ', n, 8, t1 - t0, rate, reps)
+
+  call system_clock(t0)
+  do k = 1, reps
+    call copy(n, x, z)
+  end do
+  call system_clock(t1)
+  call report('copy                ', n, 16, t1 - t0, rate, reps)
+
+  call system_clock(t0)
+  do k = 1, reps
+    call copys(n, x, z)
+  end do
+  call system_clock(t1)
+  call report('copy, stream        ', n, 16, t1 - t0, rate, reps)
+
+  call system_clock(t0)
+  do k = 1, reps
+    call triad(n, 1.0d-6, x, y, z)
+  end do
+  call system_clock(t1)
+  call report('triad               ', n, 24, t1 - t0, rate, reps)
+
+  call system_clock(t0)
+  do k = 1, reps
+    call triads(n, 1.0d-6, x, y, z)
+  end do
+  call system_clock(t1)
+  call report('triad, stream       ', n, 24, t1 - t0, rate, reps)
+
+  call system_clock(t0)
+  do k = 1, reps * (n / nsmall)
+    call triad(nsmall, 1.0d-6, x, y, z)
+  end do
+  call system_clock(t1)
+  call report('triad, cached       ', nsmall, 24, t1 - t0, rate, &
+      reps * (n / nsmall))
+
+  call system_clock(t0)
+  do k = 1, reps * (n / nsmall)
+    call triads(nsmall, 1.0d-6, x, y, z)
+  end do
+  call system_clock(t1)
+  call report('triad, cached stream', nsmall, 24, t1 - t0, rate, &
+      reps * (n / nsmall))
+
+  s = sum(z)
+  print *, 'checksum', s
+end program
+
+subroutine fill(n, z)
+  implicit none
+  integer :: n
+  real(8) :: z(n)
+  z = 0.0d0
+end subroutine
+
+subroutine fills(n, z)
+  implicit none
+  integer :: n
+  real(8) :: z(n)
+!dir$ stream
+  z = 0.0d0
+end subroutine
+
+subroutine copy(n, x, z)
+  implicit none
+  integer :: n
+  real(8) :: x(n), z(n)
+  z = x
+end subroutine
+
+subroutine copys(n, x, z)
+  implicit none
+  integer :: n
+  real(8) :: x(n), z(n)
+!dir$ stream
+  z = x
+end subroutine
+
+subroutine triad(n, a, x, y, z)
+  implicit none
+  integer :: n
+  real(8) :: a, x(n), y(n), z(n)
+  z = x + a * y
+end subroutine
+
+subroutine triads(n, a, x, y, z)
+  implicit none
+  integer :: n
+  real(8) :: a, x(n), y(n), z(n)
+!dir$ stream
+  z = x + a * y
+end subroutine
+
+subroutine report(what, n, bytes, ticks, rate, reps)
+  implicit none
+  character(*) :: what
+  integer :: n, bytes, reps
+  integer(8) :: ticks, rate
+  real(8) :: t
+
+  t = dble(ticks) / dble(rate) / reps
+  write(*, '(a, i10, f12.3, a, f10.3, a)') what, n, t * 1.0d3, ' ms', &
+      dble(bytes) * n / t * 1.0d-9, ' GB/s'
+end subroutine
@@ -0,0 +1,108 @@
+!
+! Copyright (c) 2017, NVIDIA CORPORATION.  All rights reserved.
+!
+! Licensed under the Apache License, Version 2.0 (the "License");
+! you may not use this file except in compliance with the License.
+! You may obtain a copy of the License at
+!
+!     http://www.apache.org/licenses/LICENSE-2.0
+!
+! Unless required by applicable law or agreed to in writing, software
+! distributed under the License is distributed on an "AS IS" BASIS,
+! WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+! See the License for the specific language governing permissions and
+! limitations under the License.
+!
+
+! Benchmark for blank-padded character comparison, INDEX, ADJUSTL and
+! ADJUSTR on CHARACTER*256 records holding short keywords, the pattern
+! seen when parsing keyword input files.
+
+program strings
+  implicit none
+  integer, parameter :: n = 100000, reps = 20
+  character(len=256), allocatable :: rec(:), adj(:)
+  character(len=16) :: key
+  character(len=40) :: long
+  integer(8) :: t0, t1, rate
+  integer :: i, k, hits, pos
+  real(8) :: chk
+
+  allocate(rec(n), adj(n))
+  do i = 1, n
+    write(rec(i), '(a, i0, a, i0)') '  keyword_', mod(i, 97), ' = value_', i
+  end do
+  rec(n/2) = repeat('ab', 60) // 'abc_terminal_pattern_for_index_search'
+  long = 'abc_terminal_pattern_for_index_search'
+  key = 'keyword_42'
+  chk = 0.0d0
+  call system_clock(t0, rate)
+
+  call system_clock(t0)
+  hits = 0
+  do k = 1, reps
+    do i = 1, n
+      if (rec(i) == rec(n - i + 1)) hits = hits + 1
+    end do
+  end do
+  call system_clock(t1)
+  chk = chk + hits
+  call report('compare  equal len  ', n, t1 - t0, rate, reps)
+
+  call system_clock(t0)
+  hits = 0
+  do k = 1, reps
+    do i = 1, n
+      if (adjustl(rec(i)) == key) hits = hits + 1
+    end do
+  end do
+  call system_clock(t1)
+  chk = chk + hits
+  call report('adjustl + compare   ', n, t1 - t0, rate, reps)
+
+  call system_clock(t0)
+  do k = 1, reps
+    do i = 1, n
+      adj(i) = adjustr(rec(i))
+    end do
+  end do
+  call system_clock(t1)
+  chk = chk + ichar(adj(n)(256:256))
+  call report('adjustr             ', n, t1 - t0, rate, reps)
+
+  call system_clock(t0)
+  pos = 0
+  do k = 1, reps
+    do i = 1, n
+      pos = pos + index(rec(i), '= value')
+    end do
+  end do
+  call system_clock(t1)
+  chk = chk + pos
+  call report('index   short       ', n, t1 - t0, rate, reps)
+
+  call system_clock(t0)
+  pos = 0
+  do k = 1, reps
+    do i = 1, n
+      pos = pos + index(rec(i), trim(long))
+    end do
+  end do
+  call system_clock(t1)
+  chk = chk + pos
+  call report('index   long        ', n, t1 - t0, rate, reps)
+
+  print *, 'checksum', chk
+end program
+
+subroutine report(what, n, ticks, rate, reps)
+  implicit none
+  character(*) :: what
+  integer :: n, reps
+  integer(8) :: ticks, rate
+  real(8) :: t
+
+  t = dble(ticks) / dble(rate) / reps
+  write(*, '(a, i10, f12.3, a, f10.3, a)') what, n, t * 1.0d3, ' ms', &
+      t * 1.0d9 / n, ' ns/elem'
+end subroutine
@@ -0,0 +1,132 @@
+!
+! Copyright (c) 2017, NVIDIA CORPORATION.  All rights reserved.
+!
+! Licensed under the Apache License, Version 2.0 (the "License");
+! you may not use this file except in compliance with the License.
+! You may obtain a copy of the License at
+!
+!     http://www.apache.org/licenses/LICENSE-2.0
+!
+! Unless required by applicable law or agreed to in writing, software
+! distributed under the License is distributed on an "AS IS" BASIS,
+! WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+! See the License for the specific language governing permissions and
+! limitations under the License.
+!
+
+! Benchmark for the PACK, UNPACK, RESHAPE, SPREAD and TRANSFER runtime
+! routines on contiguous and strided (every other element) arguments.
+
+program transformational
+  implicit none
+  integer, parameter :: n = 1000000, reps = 20
+  real(8), allocatable :: a(:), b(:), v(:), a2(:,:), s2(:,:)
+  real(4), allocatable :: r4(:)
+  logical, allocatable :: m(:)
+  integer(8) :: t0, t1, rate
+  integer :: i, k
+  real(8) :: chk
+
+  allocate(a(2*n), b(2*n), v(n), a2(1000, n/1000), s2(n/1000, 4))
+  allocate(r4(4*n), m(2*n))
+  do i = 1, 2*n
+    a(i) = i
+  end do
+  m = mod(int(a), 3) /= 0
+  v = -1.0d0
+  chk = 0.0d0
+
+  call system_clock(t0, rate)
+  do k = 1, reps
+    b(1:n) = pack(a(1:n), m(1:n), v)
+  end do
+  call system_clock(t1)
+  chk = chk + b(n)
+  call report('pack      contiguous', n, t1 - t0, rate, reps)
+
+  call system_clock(t0)
+  do k = 1, reps
+    b(1:n) = pack(a(1:2*n:2), m(1:2*n:2), v)
+  end do
+  call system_clock(t1)
+  chk = chk + b(n)
+  call report('pack      strided   ', n, t1 - t0, rate, reps)
+
+  call system_clock(t0)
+  do k = 1, reps
+    b(1:n) = unpack(v, m(1:n), a(1:n))
+  end do
+  call system_clock(t1)
+  chk = chk + b(n)
+  call report('unpack    contiguous', n, t1 - t0, rate, reps)
+
+  call system_clock(t0)
+  do k = 1, reps
+    b(1:2*n:2) = unpack(v, m(1:2*n:2), 0.0d0)
+  end do
+  call system_clock(t1)
+  chk = chk + b(2*n-1)
+  call report('unpack    strided   ', n, t1 - t0, rate, reps)
+
+  call system_clock(t0)
+  do k = 1, reps
+    a2 = reshape(a(1:n), (/1000, n/1000/))
+  end do
+  call system_clock(t1)
+  chk = chk + a2(1000, n/1000)
+  call report('reshape   contiguous', n, t1 - t0, rate, reps)
+
+  call system_clock(t0)
+  do k = 1, reps
+    a2 = reshape(a(1:2*n:2), (/1000, n/1000/))
+  end do
+  call system_clock(t1)
+  chk = chk + a2(1000, n/1000)
+  call report('reshape   strided   ', n, t1 - t0, rate, reps)
+
+  call system_clock(t0)
+  do k = 1, reps
+    s2 = spread(a(1:n/1000), 2, 4)
+  end do
+  call system_clock(t1)
+  chk = chk + s2(1, 4)
+  call report('spread    dim=2     ', 4*(n/1000), t1 - t0, rate, reps)
+
+  call system_clock(t0)
+  do k = 1, reps
+    a2(1:4, :) = spread(a(1:n/1000), 1, 4)
+  end do
+  call system_clock(t1)
+  chk = chk + a2(4, 1)
+  call report('spread    dim=1     ', 4*(n/1000), t1 - t0, rate, reps)
+
+  call system_clock(t0)
+  do k = 1, reps
+    r4(1:2*n) = transfer(a(1:n), r4(1:1))
+  end do
+  call system_clock(t1)
+  chk = chk + r4(1)
+  call report('transfer  contiguous', n, t1 - t0, rate, reps)
+
+  call system_clock(t0)
+  do k = 1, reps
+    r4(1:2*n) = transfer(a(1:2*n:2), r4(1:1))
+  end do
+  call system_clock(t1)
+  chk = chk + r4(1)
+  call report('transfer  strided   ', n, t1 - t0, rate, reps)
+
+  print *, 'checksum', chk
+end program
+
+subroutine report(what, n, ticks, rate, reps)
+  implicit none
+  character(*) :: what
+  integer :: n, reps
+  integer(8) :: ticks, rate
+  real(8) :: t
+
+  t = dble(ticks) / dble(rate) / reps
+  write(*, '(a, i10, f12.3, a, f10.3, a)') what, n, t * 1.0d3, ' ms', &
+      t * 1.0d9 / n, ' ns/elem'
+end subroutine
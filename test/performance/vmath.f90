@@ -0,0 +1,208 @@
+!
+! Copyright (c) 2017, NVIDIA CORPORATION.  All rights reserved.
+!
+! Licensed under the Apache License, Version 2.0 (the "License");
+! you may not use this file except in compliance with the License.
+! You may obtain a copy of the License at
+!
+!     http://www.apache.org/licenses/LICENSE-2.0
+!
+! Unless required by applicable law or agreed to in writing, software
+! distributed under the License is distributed on an "AS IS" BASIS,
+! WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+! See the License for the specific language governing permissions and
+! limitations under the License.
+!
+
+
+! Benchmark for loops calling the elemental math intrinsics that the
+! vector math library covers: exp, log, x**y, sin, cos and tanh in double
+! and single precision over arrays that fit in the L2 cache.  Each loop is
+! vectorized to the __fvd_/__fvs_ entries by default; compile a second
+! time with -Mx,223,1 to time the scalar calls for comparison.
+
+program vmath
+  implicit none
+  integer, parameter :: n = 4096, reps = 2000
+  real(8) :: x(n), y(n), z(n)
+  real(4) :: xs(n), ys(n), zs(n)
+  integer(8) :: t0, t1, rate
+  integer :: i, k
+  real(8) :: s
+
+  do i = 1, n
+    x(i) = 0.5d0 + i * 1.0d-3
+    y(i) = 1.3d0
+  end do
+  xs = real(x, 4)
+  ys = real(y, 4)
+  s = 0.0d0
+  call system_clock(t0, rate)
+
+  call system_clock(t0)
+  do k = 1, reps
+    call dexpl(n, x, z)
+  end do
+  call system_clock(t1)
+  call report('exp, real(8)        ', n, t1 - t0, rate, reps)
+  s = s + z(n)
+
+  call system_clock(t0)
+  do k = 1, reps
+    call dlogl(n, x, z)
+  end do
+  call system_clock(t1)
+  call report('log, real(8)        ', n, t1 - t0, rate, reps)
+  s = s + z(n)
+
+  call system_clock(t0)
+  do k = 1, reps
+    call dpowl(n, x, y, z)
+  end do
+  call system_clock(t1)
+  call report('x**y, real(8)       ', n, t1 - t0, rate, reps)
+  s = s + z(n)
+
+  call system_clock(t0)
+  do k = 1, reps
+    call dsinl(n, x, z)
+  end do
+  call system_clock(t1)
+  call report('sin, real(8)        ', n, t1 - t0, rate, reps)
+  s = s + z(n)
+
+  call system_clock(t0)
+  do k = 1, reps
+    call dcosl(n, x, z)
+  end do
+  call system_clock(t1)
+  call report('cos, real(8)        ', n, t1 - t0, rate, reps)
+  s = s + z(n)
+
+  call system_clock(t0)
+  do k = 1, reps
+    call dtanhl(n, x, z)
+  end do
+  call system_clock(t1)
+  call report('tanh, real(8)       ', n, t1 - t0, rate, reps)
+  s = s + z(n)
+
+  call system_clock(t0)
+  do k = 1, reps
+    call sexpl(n, xs, zs)
+  end do
+  call system_clock(t1)
+  call report('exp, real(4)        ', n, t1 - t0, rate, reps)
+  s = s + zs(n)
+
+  call system_clock(t0)
+  do k = 1, reps
+    call spowl(n, xs, ys, zs)
+  end do
+  call system_clock(t1)
+  call report('x**y, real(4)       ', n, t1 - t0, rate, reps)
+  s = s + zs(n)
+
+  call system_clock(t0)
+  do k = 1, reps
+    call ssinl(n, xs, zs)
+  end do
+  call system_clock(t1)
+  call report('sin, real(4)        ', n, t1 - t0, rate, reps)
+  s = s + zs(n)
+
+  print *, 'checksum', s
+end program
+
+subroutine dexpl(n, x, z)
+  implicit none
+  integer :: n, i
+  real(8) :: x(n), z(n)
+  do i = 1, n
+    z(i) = exp(x(i))
+  end do
+end subroutine
+
+subroutine dlogl(n, x, z)
+  implicit none
+  integer :: n, i
+  real(8) :: x(n), z(n)
+  do i = 1, n
+    z(i) = log(x(i))
+  end do
+end subroutine
+
+subroutine dpowl(n, x, y, z)
+  implicit none
+  integer :: n, i
+  real(8) :: x(n), y(n), z(n)
+  do i = 1, n
+    z(i) = x(i) ** y(i)
+  end do
+end subroutine
+
+subroutine dsinl(n, x, z)
+  implicit none
+  integer :: n, i
+  real(8) :: x(n), z(n)
+  do i = 1, n
+    z(i) = sin(x(i))
+  end do
+end subroutine
+
+subroutine dcosl(n, x, z)
+  implicit none
+  integer :: n, i
+  real(8) :: x(n), z(n)
+  do i = 1, n
+    z(i) = cos(x(i))
+  end do
+end subroutine
+
+subroutine dtanhl(n, x, z)
+  implicit none
+  integer :: n, i
+  real(8) :: x(n), z(n)
+  do i = 1, n
+    z(i) = tanh(x(i))
+  end do
+end subroutine
+
+subroutine sexpl(n, x, z)
+  implicit none
+  integer :: n, i
+  real(4) :: x(n), z(n)
+  do i = 1, n
+    z(i) = exp(x(i))
+  end do
+end subroutine
+
+subroutine spowl(n, x, y, z)
+  implicit none
+  integer :: n, i
+  real(4) :: x(n), y(n), z(n)
+  do i = 1, n
+    z(i) = x(i) ** y(i)
+  end do
+end subroutine
+
+subroutine ssinl(n, x, z)
+  implicit none
+  integer :: n, i
+  real(4) :: x(n), z(n)
+  do i = 1, n
+    z(i) = sin(x(i))
+  end do
+end subroutine
+
+subroutine report(what, n, ticks, rate, reps)
+  implicit none
+  character(*) :: what
+  integer :: n, reps
+  integer(8) :: ticks, rate
+  real(8) :: t
+
+  t = dble(ticks) / dble(rate) / reps
+  write(*, '(a, i10, f12.3, a, f10.3, a)') what, n, t * 1.0d3, ' ms', &
+      t * 1.0d9 / n, ' ns/elem'
+end subroutine
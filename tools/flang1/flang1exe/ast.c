@@ -42,6 +42,7 @@
 #include "rte.h"
 #include "extern.h"
 #include "rtlRtns.h"
+#include "flang/ADT/hash.h"
 
 static int reduce_iadd(int, INT);
 static int reduce_i8add(int, int);
@@ -76,11 +77,18 @@ ast_init(void)
   if (astb.size <= 0) {
     astb.size = 1000;
     NEW(astb.base, AST, astb.size);
+    NEW(astb.hshv, int, astb.size);
 #if DEBUG
     assert(astb.base, "ast_init: no room for AST", astb.size, 4);
+    assert(astb.hshv, "ast_init: no room for AST", astb.size, 4);
 #endif
   }
-  BZERO(astb.hshtb, int, HSHSZ + 1);
+  if (astb.hshsz != HSHSZ) {
+    FREE(astb.hshtb);
+    astb.hshsz = HSHSZ;
+    NEW(astb.hshtb, int, astb.hshsz);
+  }
+  BZERO(astb.hshtb, int, astb.hshsz);
   astb.avl = 2; /* need non-zero ast# to terminate ast_traverse() */
 
   if (astb.asd.size <= 0) {
@@ -244,8 +252,13 @@ ast_fini(void)
 {
   if (astb.base) {
     FREE(astb.base);
+    FREE(astb.hshv);
     astb.avl = astb.size = 0;
   }
+  if (astb.hshtb) {
+    FREE(astb.hshtb);
+    astb.hshsz = 0;
+  }
   if (astb.asd.base) {
     FREE(astb.asd.base);
     astb.asd.avl = astb.asd.size = 0;
@@ -275,9 +288,11 @@ ast_fini(void)
 int
 new_node(int type)
 {
-  int nd;
+  int nd, size;
 
   nd = astb.avl++;
+  size = astb.size;
+  NEED(astb.avl, astb.hshv, int, size, astb.size + 1000);
   NEED(astb.avl, astb.base, AST, astb.size, astb.size + 1000);
   if (nd > MAXAST || astb.base == NULL)
     errfatal(7);
@@ -286,10 +301,15 @@ new_node(int type)
   return nd;
 }
 
-#define ADD_NODE(nd, a, hashval)       \
-  (nd) = new_node(a);                  \
-  A_HSHLKP((nd), astb.hshtb[hashval]); \
-  astb.hshtb[hashval] = (nd)
+#define HSHTB(hashval) astb.hshtb[(hashval) & (astb.hshsz - 1)]
+
+#define ADD_NODE(nd, a, hashval)   \
+  (nd) = new_node(a);              \
+  A_HSHLKP((nd), HSHTB(hashval));  \
+  HSHTB(hashval) = (nd);           \
+  astb.hshv[nd] = (hashval);       \
+  if (astb.avl > astb.hshsz)       \
+    grow_ast_hash()
 
 /* not used
 #define HSH_0(a) hash_val(a, -1, -1, -1, -1)
@@ -302,20 +322,52 @@ new_node(int type)
 static INT
 hash_val(int a, int hw3, int hw4, int hw5, int hw6)
 {
-  INT hashval;
+  hash_accu_t hacc = HASH_ACCU_INIT;
+
+  HASH_ACCU_ADD(hacc, a);
+  HASH_ACCU_ADD(hacc, hw3);
+  HASH_ACCU_ADD(hacc, hw4);
+  HASH_ACCU_ADD(hacc, hw5);
+  HASH_ACCU_ADD(hacc, hw6);
+  HASH_ACCU_FINISH(hacc);
+  return HASH_ACCU_VALUE(hacc) & 0x7fffffff;
+}
+
+/* Double the number of buckets in astb.hshtb, splitting each chain in two
+ * without changing the order of the ASTs in it. */
+static void
+grow_ast_hash(void)
+{
+  int *tb;
+  int n, i;
 
-  hashval = a;
-  if (hw3 > 0)
-    hashval ^= hw3 >> 4;
-  if (hw4 > 0)
-    hashval ^= hw4 << 8;
-  if (hw5 > 0)
-    hashval ^= hw5 >> 8;
-  if (hw6 > 0)
-    hashval ^= hw6 << 16;
-  hashval &= 0x7fffffff;
-  hashval %= HSHSZ;
-  return hashval;
+  n = astb.hshsz;
+  NEW(tb, int, 2 * n);
+#if DEBUG
+  assert(tb, "grow_ast_hash: no room for hshtb", 2 * n, 4);
+#endif
+  for (i = 0; i < n; ++i) {
+    int nd, next, hi;
+    int tail[2];
+    tb[i] = tb[i + n] = 0;
+    tail[0] = tail[1] = 0;
+    for (nd = astb.hshtb[i]; nd != 0; nd = next) {
+      next = A_HSHLKG(nd);
+      hi = (astb.hshv[nd] & n) != 0;
+      if (tail[hi])
+        A_HSHLKP(tail[hi], nd);
+      else
+        tb[i + hi * n] = nd;
+      tail[hi] = nd;
+    }
+    if (tail[0])
+      A_HSHLKP(tail[0], 0);
+    if (tail[1])
+      A_HSHLKP(tail[1], 0);
+  }
+  FREE(astb.hshtb);
+  astb.hshtb = tb;
+  astb.hshsz = 2 * n;
 }
 
 /* hash an ast with dtype & sptr (A_ID, A_CNST, A_LABEL) */
@@ -326,7 +378,7 @@ hash_sym(int a, DTYPE dtype, int sptr)
   int nd;
 
   hashval = HSH_2(a, dtype, sptr);
-  for (nd = astb.hshtb[hashval]; nd != 0; nd = A_HSHLKG(nd)) {
+  for (nd = HSHTB(hashval); nd != 0; nd = A_HSHLKG(nd)) {
     if (a == A_TYPEG(nd) && dtype == A_DTYPEG(nd) && sptr == A_SPTRG(nd))
       return nd;
   }
@@ -345,7 +397,7 @@ hash_unop(int a, DTYPE dtype, int lop, int optype)
   int nd;
 
   hashval = HSH_3(a, dtype, lop, optype);
-  for (nd = astb.hshtb[hashval]; nd != 0; nd = A_HSHLKG(nd)) {
+  for (nd = HSHTB(hashval); nd != 0; nd = A_HSHLKG(nd)) {
     if (a == A_TYPEG(nd) && dtype == A_DTYPEG(nd) && lop == A_LOPG(nd) &&
         optype == A_OPTYPEG(nd))
       return nd;
@@ -365,7 +417,7 @@ hash_binop(int a, DTYPE dtype, int lop, int optype, int rop)
   int nd;
 
   hashval = HSH_4(a, dtype, lop, optype, rop);
-  for (nd = astb.hshtb[hashval]; nd != 0; nd = A_HSHLKG(nd)) {
+  for (nd = HSHTB(hashval); nd != 0; nd = A_HSHLKG(nd)) {
     if (a == A_TYPEG(nd) && dtype == A_DTYPEG(nd) && lop == A_LOPG(nd) &&
         optype == A_OPTYPEG(nd) && rop == A_ROPG(nd))
       return nd;
@@ -386,7 +438,7 @@ hash_paren(int a, DTYPE dtype, int lop)
   int nd;
 
   hashval = HSH_2(a, dtype, lop);
-  for (nd = astb.hshtb[hashval]; nd != 0; nd = A_HSHLKG(nd)) {
+  for (nd = HSHTB(hashval); nd != 0; nd = A_HSHLKG(nd)) {
     if (a == A_TYPEG(nd) && dtype == A_DTYPEG(nd) && lop == A_LOPG(nd))
       return nd;
   }
@@ -404,7 +456,7 @@ hash_conv(int a, DTYPE dtype, int lop, int shd)
   int nd;
 
   hashval = HSH_3(a, dtype, lop, shd);
-  for (nd = astb.hshtb[hashval]; nd != 0; nd = A_HSHLKG(nd)) {
+  for (nd = HSHTB(hashval); nd != 0; nd = A_HSHLKG(nd)) {
     if (a == A_TYPEG(nd) && dtype == A_DTYPEG(nd) && lop == A_LOPG(nd) &&
         (!shd || shd == A_SHAPEG(nd)))
       return nd;
@@ -423,7 +475,7 @@ hash_subscr(int a, DTYPE dtype, int lop, int asd)
   int nd;
 
   hashval = HSH_3(a, dtype, lop, asd);
-  for (nd = astb.hshtb[hashval]; nd != 0; nd = A_HSHLKG(nd)) {
+  for (nd = HSHTB(hashval); nd != 0; nd = A_HSHLKG(nd)) {
     if (a == A_TYPEG(nd) && dtype == A_DTYPEG(nd) && lop == A_LOPG(nd) &&
         asd == A_ASDG(nd))
       return nd;
@@ -443,7 +495,7 @@ hash_mem(int a, DTYPE dtype, int parent, int mem)
   int nd;
 
   hashval = HSH_3(a, dtype, parent, mem);
-  for (nd = astb.hshtb[hashval]; nd != 0; nd = A_HSHLKG(nd)) {
+  for (nd = HSHTB(hashval); nd != 0; nd = A_HSHLKG(nd)) {
     if (a == A_TYPEG(nd) && dtype == A_DTYPEG(nd) && parent == A_PARENTG(nd) &&
         mem == A_MEMG(nd))
       return nd;
@@ -463,7 +515,7 @@ hash_cmplxc(int a, DTYPE dtype, int lop, int rop)
   int nd;
 
   hashval = HSH_3(a, dtype, lop, rop);
-  for (nd = astb.hshtb[hashval]; nd != 0; nd = A_HSHLKG(nd)) {
+  for (nd = HSHTB(hashval); nd != 0; nd = A_HSHLKG(nd)) {
     if (a == A_TYPEG(nd) && dtype == A_DTYPEG(nd) && lop == A_LOPG(nd) &&
         rop == A_ROPG(nd))
       return nd;
@@ -483,7 +535,7 @@ hash_triple(int a, int lb, int ub, int stride)
   int nd;
 
   hashval = HSH_3(a, lb, ub, stride);
-  for (nd = astb.hshtb[hashval]; nd != 0; nd = A_HSHLKG(nd)) {
+  for (nd = HSHTB(hashval); nd != 0; nd = A_HSHLKG(nd)) {
     if (a == A_TYPEG(nd) && lb == A_LBDG(nd) && ub == A_UPBDG(nd) &&
         stride == A_STRIDEG(nd))
       return nd;
@@ -503,7 +555,7 @@ hash_substr(int a, DTYPE dtype, int lop, int left, int right)
   int nd;
 
   hashval = HSH_4(a, dtype, lop, left, right);
-  for (nd = astb.hshtb[hashval]; nd != 0; nd = A_HSHLKG(nd)) {
+  for (nd = HSHTB(hashval); nd != 0; nd = A_HSHLKG(nd)) {
     if (a == A_TYPEG(nd) && dtype == A_DTYPEG(nd) && lop == A_LOPG(nd) &&
         left == A_LEFTG(nd) && right == A_RIGHTG(nd))
       return nd;
@@ -6642,7 +6694,7 @@ dump_ast(void)
   fprintf(gbl.dbgfil, "\n");
   if (DBGBIT(4, 512)) {
     fprintf(gbl.dbgfil, "HashIndex  First\n");
-    for (i = 0; i <= HSHSZ; i++)
+    for (i = 0; i < astb.hshsz; i++)
       if (astb.hshtb[i])
         fprintf(gbl.dbgfil, "  %5d    %5d\n", i, (int)astb.hshtb[i]);
   }
@@ -7023,9 +7075,16 @@ void rw_ast_state(RW_ROUTINE, RW_FILE)
 {
   int nw;
 
-  RW_FD(astb.hshtb, astb.hshtb, 1);
+  nw = astb.hshsz;
+  RW_SCALAR(astb.hshsz);
+  if (ISREAD() && astb.hshsz != nw) {
+    FREE(astb.hshtb);
+    NEW(astb.hshtb, int, astb.hshsz);
+  }
+  RW_FD(astb.hshtb, int, astb.hshsz);
   RW_SCALAR(astb.avl);
   RW_FD(astb.base, AST, astb.avl);
+  RW_FD(astb.hshv, int, astb.avl);
 
   RW_FD(astb.asd.hash, astb.asd.hash, 1);
   RW_SCALAR(astb.asd.avl);
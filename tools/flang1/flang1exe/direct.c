@@ -208,13 +208,29 @@ direct_loop_enter(void)
     if (flg.genilm) {
       NEEDB(direct.lpg.avail, svdir.stgb, SVDIR, svdir.size,
             direct.lpg.avail + 8);
+      /* flang2 rebuilds the set from the routine's, so record the
+       * difference from the routine's beginning state, which includes any
+       * routine-scoped directive seen since. */
       diff_dir(&svdir.stgb[direct.lpg.avail - 1],
-               &direct.lpg.stgb[direct.lpg.avail - 1].dirset, &direct.loop);
+               &direct.lpg.stgb[direct.lpg.avail - 1].dirset,
+               &direct.rou_begin);
     }
   }
 
 }
 
+/** \brief The next loop is an OpenMP SIMD loop
+ *
+ * Give the loop a set of loop pragmas, as if it had a directive, which marks
+ * its iterations as independent for flang2.
+ */
+void
+direct_loop_simd(void)
+{
+  direct.loop.x[219] |= 0x2;
+  direct.loop_flag = TRUE;
+}
+
 /** \brief Re-initialize the loop structure
  *
  * Must be called after the end of a loop is processed by semant for which
@@ -163,6 +163,7 @@ void direct_init(void); /* direct.c */
 int direct_import(FILE *);
 void direct_rou_end(void);
 void direct_loop_enter(void);
+void direct_loop_simd(void);
 void direct_loop_end(int, int);
 void direct_rou_load(int);
 void direct_rou_setopt(int, int);
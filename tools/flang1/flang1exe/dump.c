@@ -2031,7 +2031,6 @@ dumpnme(int n)
   putnzint("inlarr", NME_INLARR(n));
   putnsym("sym", NME_SYM(n));
   putnzint("nm", NME_NM(n));
-  putnzint("hshlnk", NME_HSHLNK(n));
   putnzint("rfptr", NME_RFPTR(n));
   putnzint("cnst", NME_CNST(n));
   putnzint("sub", NME_SUB(n));
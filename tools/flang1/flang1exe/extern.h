@@ -26,6 +26,7 @@ void distributed_scalar(int);              /* transfrm.c */
 void convert_forall(void);                 /* outconv.c */
 int conv_forall(int std);                  /* outconv.c */
 void forall_dependency_analyze(void);      /* outconv.c */
+void vect_array_loops(void);               /* outconv.c */
 int gen_islocal_index(int, int, int, int); /* func.c */
 /* commgen.c */
 int gen_localize_index(int, int, int, int); /* commgen.c */
@@ -47,7 +47,7 @@ static int new_storeitem(int nme);
 
 static void localflow(void);
 static void lflow_of_block(void);
-static void clean_names(STL *stl);
+static void clean_names(STL *stl, int upto);
 static void build_ud(int tree);
 static void build_do_init(int tree);
 static void dump_global(LOGICAL inout);
@@ -119,6 +119,7 @@ static void live_var_init(void);
 static void live_var_end(void);
 static void live_var(void);
 static void lv_print(BV *);
+static void build_rdfo(void);
 static void uninit_var_init(void);
 static void uninit_var_end(void);
 static void uninit_var(void);
@@ -550,10 +551,13 @@ localflow(void)
 static void
 lflow_of_block(void)
 {
+  int first_store;
+
   if (FG_DFN(cur_fg) == -1)
     return;
   cur_lp = FG_LOOP(cur_fg);
   cur_stl = LP_STL(cur_lp);
+  first_store = cur_stl->store;
   if (cur_lp)
     /* apply loop-scoped pragmas available for this loop */
     open_pragma((int)FG_LINENO(LP_HEAD(cur_lp)));
@@ -628,16 +632,21 @@ lflow_of_block(void)
   }
 
   FG_FDEF(cur_fg) = DEF_LNEXT(0);
-  clean_names(cur_stl);
+  clean_names(cur_stl, first_store);
 
 }
 
+/*
+ * Clear the NME_STL fields set for the stores added to stl by the current
+ * node; the list's items up to upto, its head before the node was
+ * processed, were cleared by the earlier nodes.
+ */
 static void
-clean_names(STL *stl)
+clean_names(STL *stl, int upto)
 {
   int store;
 
-  for (store = stl->store; store; store = STORE_NEXT(store))
+  for (store = stl->store; store && store != upto; store = STORE_NEXT(store))
     NME_STL(STORE_NM(store)) = 0;
 }
 
@@ -1955,53 +1964,72 @@ live_var_end(void)
    the loops in the function.
 
    Algorithm:
-      for each node v in the flowgraph in reverse depth first order {
+      build reverse-depth-first-order; the nodes are visited in the
+      reverse of that order, so that a node is visited after its
+      successors except across retreating edges.  Nodes which aren't
+      reached from the entry follow.
+      for each node v in the flowgraph {
          LIN(v)  = LUSE(v);
          LOUT(v) = 0;
-         add v to queue;
+         pending(v) = v is reached from the entry;
       }
-      do {
-         remove node v from queue;
-         new_out = 0;
-         new_out U= LIN(s), for each successor s of v;
-         if (new_out != LOUT(v)) {
-            LOUT(v) = new_out;
-            LIN(v)  = (LOUT(v) - LDEF(v)) U LUSE(v);
-            for each predecessor s of v {
-               if (s is not in queue)
-                  add s to queue;
+      top = 1
+      while (top <= opt.num_nodes) {
+         pos = top
+         top = opt.num_nodes + 1
+         for (; pos <= opt.num_nodes; ++pos) {
+            v = node at pos;
+            if (!pending(v))
+               continue;
+            pending(v) = 0;
+            new_out = 0;
+            new_out U= LIN(s), for each successor s of v;
+            if (new_out != LOUT(v)) {
+               LOUT(v) = new_out;
+               LIN(v)  = (LOUT(v) - LDEF(v)) U LUSE(v);
+               for each predecessor p of v {
+                  pending(p) = 1;
+                  if (pos(p) <= pos && pos(p) < top)
+                     top = pos(p);
+               }
             }
          }
-      }  while (first of queue != last of queue);
+      }
 */
 static void
 live_var(void)
 {
-  Q_ITEM *f_q, *l_q, *q;
   BV *new_out, *bv;
   PSI_P p;
-  int i, v, def, bih;
+  int i, v, pos, top;
+  int *order; /* order[pos] is the node visited at pos */
+  int *posn;  /* posn[v] is the position of node v */
 
-  l_q = GET_Q_ITEM(f_q); /* a queue is empty when the first and */
-  l_q->next = Q_NULL;    /* and last entries locate the same    */
-                         /* item                                */
+  build_rdfo();
+  NEW(order, int, 2 * (opt.num_nodes + 1));
+  posn = order + opt.num_nodes + 1;
+  for (i = 1; i <= opt.dfn; i++) {
+    v = RDFOVTX_NODE(opt.dfn + 1 - i);
+    order[i] = v;
+    posn[v] = i;
+    FG_INQ(v) = 1;
+  }
+  for (v = 1; v <= opt.num_nodes; v++)
+    if (FG_RDFO(v) <= 0) {
+      order[i] = v;
+      posn[v] = i++;
+      FG_INQ(v) = 0;
+    }
 
   /*
-   * scan the flow graph nodes in reverse depth first order and define
-   * lin(fg) to luse(fg) and lout(fg) to the empty set (done by zeroing
-   * out the entire area at allocation.
-   * Also, the queue of all the nodes is created.
+   * define lin(fg) to luse(fg) and lout(fg) to the empty set (done by
+   * zeroing out the entire area at allocation.
    */
   for (i = opt.dfn; i >= 1; i--) {
     v = VTX_NODE(i);
 
     bv_copy(LIN(v), LUSE(v), lv.bv_len);
     /* LOUT(v) <- 0; has been init'd to 0 */
-
-    l_q->next = GET_Q_ITEM(q);
-    l_q = q;
-    l_q->info = v;
-    FG_INQ(v) = 1;
 #if DEBUG
     if (OPTDBG(29, 1)) {
       fprintf(gbl.dbgfil, "LUSE(%5d):", v);
@@ -2015,51 +2043,57 @@ live_var(void)
    * do the flow equations
    */
   new_out = lv.stg_base;
-  do {
-    f_q = f_q->next; /* get next item from queue */
-    v = f_q->info;   /* and remove it from the queue */
-    FG_INQ(v) = 0;
+  top = 1;
+  while (top <= opt.num_nodes) {
+    pos = top;
+    top = opt.num_nodes + 1;
+    for (; pos <= opt.num_nodes; ++pos) {
+      v = order[pos];
+      if (!FG_INQ(v))
+        continue;
+      FG_INQ(v) = 0;
 
-    /* do the union of the LIN sets for the successor of v  */
+      /* do the union of the LIN sets for the successor of v  */
 
-    bv_zero(new_out, lv.bv_len);
-    for (p = FG_SUCC(v); p != PSI_P_NULL; p = PSI_NEXT(p))
-      bv_union(new_out, LIN(PSI_NODE(p)), lv.bv_len);
+      bv_zero(new_out, lv.bv_len);
+      for (p = FG_SUCC(v); p != PSI_P_NULL; p = PSI_NEXT(p))
+        bv_union(new_out, LIN(PSI_NODE(p)), lv.bv_len);
 
-    /*
-     * this value becomes OUT(v) only if it is different than the current
-     * OUT(v)
-     */
-    if (bv_notequal(new_out, bv = LOUT(v), lv.bv_len)) {
+      /*
+       * this value becomes OUT(v) only if it is different than the current
+       * OUT(v)
+       */
+      if (bv_notequal(new_out, bv = LOUT(v), lv.bv_len)) {
 
-      /* LOUT(v) = new_out  */
+        /* LOUT(v) = new_out  */
 
-      bv_copy(bv, new_out, lv.bv_len);
+        bv_copy(bv, new_out, lv.bv_len);
 
-      /* LIN(v) = LOUT(v) - LDEF(v) U LUSE(v)  */
+        /* LIN(v) = LOUT(v) - LDEF(v) U LUSE(v)  */
 
-      bv_sub(new_out, LDEF(v), lv.bv_len);
-      bv_union(new_out, LUSE(v), lv.bv_len);
-      bv_copy(LIN(v), new_out, lv.bv_len);
+        bv_sub(new_out, LDEF(v), lv.bv_len);
+        bv_union(new_out, LUSE(v), lv.bv_len);
+        bv_copy(LIN(v), new_out, lv.bv_len);
 #if DEBUG
-      if (OPTDBG(29, 1)) {
-        fprintf(gbl.dbgfil, "LIN (%5d):", v);
-        lv_print(LIN(v));
-        fprintf(gbl.dbgfil, "LOUT(%5d):", v);
-        lv_print(LOUT(v));
-      }
+        if (OPTDBG(29, 1)) {
+          fprintf(gbl.dbgfil, "LIN (%5d):", v);
+          lv_print(LIN(v));
+          fprintf(gbl.dbgfil, "LOUT(%5d):", v);
+          lv_print(LOUT(v));
+        }
 #endif
 
-      for (p = FG_PRED(v); p != PSI_P_NULL; p = PSI_NEXT(p))
-        if (!FG_INQ(i = PSI_NODE(p))) {
-          l_q->next = GET_Q_ITEM(q);
-          l_q = q;
-          l_q->info = i;
+        for (p = FG_PRED(v); p != PSI_P_NULL; p = PSI_NEXT(p)) {
+          i = PSI_NODE(p);
           FG_INQ(i) = 1;
+          if (posn[i] <= pos && posn[i] < top)
+            top = posn[i];
         }
+      }
     }
-  } while (f_q != l_q);
+  }
 
+  FREE(order);
   freearea(Q_AREA);
 
 #if DEBUG
@@ -2083,7 +2117,8 @@ live_var(void)
 static void
 lv_print(BV *bv)
 {
-  int i, j, w;
+  int i, j;
+  BV w;
   int maxlen;
 
   maxlen = lv.n;
@@ -2326,7 +2361,7 @@ uninit_var_end(void)
 }
 
 LOGICAL
-is_initialized(int *bv, int nme)
+is_initialized(BV *bv, int nme)
 {
   if (nme > lv.n || !is_optsym(nme))
     return TRUE;
@@ -2335,9 +2370,10 @@ is_initialized(int *bv, int nme)
 
 #if DEBUG
 static int
-bv_count(int *bv)
+bv_count(BV *bv)
 {
-  int i, w, count;
+  int i, count;
+  BV w;
   count = 0;
   w = *bv++;
   for (i = 1; i <= opt.ndefs; ++i) {
@@ -2397,7 +2433,7 @@ _rdfo(int v)
 } /* _rdfo */
 
 static void
-build_rdfo()
+build_rdfo(void)
 {
   int v;
   for (v = 0; v <= opt.num_nodes; ++v) {
@@ -2410,43 +2446,114 @@ build_rdfo()
     interr("more DFN nodes than RDFO nodes", 0, 4);
 } /* build_rdfo */
 
+static int
+addr_cmp(const void *a, const void *b)
+{
+  int d1 = *(const int *)a;
+  int d2 = *(const int *)b;
+
+  if (DEF_ADDR(d1) != DEF_ADDR(d2))
+    return DEF_ADDR(d1) < DEF_ADDR(d2) ? -1 : 1;
+  return d1 - d2;
+}
+
+/*
+ * Group the defs of each names entry by their addresses:  the defs with
+ * the same names entry and address as def are (*grp)[(*first)[def]] ..
+ * (*grp)[(*last)[def] - 1].  The KILL set of a node is found from these
+ * groups rather than by searching all of the defs of a names entry, which
+ * is quadratic in the number of defs of, e.g., an array.
+ */
+static void
+group_defs(int **grp, int **first, int **last)
+{
+  int nme, def, n, i, j;
+  int *g, *f, *l;
+
+  NEW(g, int, opt.ndefs + 1);
+  NEW(f, int, opt.ndefs + 1);
+  NEW(l, int, opt.ndefs + 1);
+  BZERO(f, int, opt.ndefs + 1);
+  BZERO(l, int, opt.ndefs + 1);
+  n = 0;
+  for (nme = 1; nme < (int)nmeb.stg_avail; nme++) {
+    i = n;
+    for (def = NME_DEF(nme); def; def = DEF_NEXT(def))
+      g[n++] = def;
+    if (n - i > 1)
+      qsort(g + i, n - i, sizeof(int), addr_cmp);
+    for (; i < n; i = j) {
+      for (j = i + 1; j < n && DEF_ADDR(g[j]) == DEF_ADDR(g[i]); j++)
+        ;
+      for (def = i; def < j; def++) {
+        f[g[def]] = i;
+        l[g[def]] = j;
+      }
+    }
+  }
+  *grp = g;
+  *first = f;
+  *last = l;
+}
+
 /*  definition analysis  */
 
 /*
    Algorithm:
-      for each node v in the flowgraph in depth first order {
+      build reverse-depth-first-order
+      for each node v in the flowgraph in reverse depth first order {
          IN(v) = 0;
          OUT(v) = GEN(v);
+         KILL(v) = defs in other nodes of the names entries in GEN(v);
+         pending(v) = 1;
       }
-      build reverse-depth-first-order
       top = 1
-      do{
-        changed = 0
-        oldtop = top
+      while (top <= opt.dfn) {
+        dfo = top
         top = opt.dfn+1
-        do dfo = oldtop to opt.dfn{
+        for (; dfo <= opt.dfn; ++dfo) {
          v = RDFOVTX_NODE(dfo)
+         if (!pending(v))
+            continue;
+         pending(v) = 0;
          IN(v) = 0;
          IN(v) U= OUT(p), for each predecessor p of v;
          new_out = (IN(v) - KILL(v)) U GEN(v);
          if( new_out != OUT(v) ){
             OUT(v) = new_out
             for each successor s of v {
-               if( FG_DFN(s) < top && FG_DFN(s) < dfo ){
-                top = FG_DFN(s)
-                changed = 1
-               }
+               pending(s) = 1;
+               if( FG_RDFO(s) <= dfo && FG_RDFO(s) < top )
+                top = FG_RDFO(s)
             }
          }
         }
-      }while(changed)
+      }
+
+   Only the nodes whose predecessors' OUT sets changed are reevaluated;
+   a retreating edge starts another sweep from its target.
+   A KILL set doesn't change during the iteration, so it's computed once.
+   Most KILL sets are small compared to the number of defs; such a set is
+   kept as a list of the defs, which are removed one at a time.  A larger
+   set is kept as a bit vector and is subtracted a BV unit at a time.
 */
 static void
 reaching_defs(void)
 {
   BV *bv, *new_out;
   PSI_P p, s;
-  int i, v, def, bih, top, oldtop, changed, dfo, iter;
+  int i, k, v, def, bih, top, dfo, iter;
+  int *kill_list;  /* defs of the sparse KILL sets */
+  int kill_avail;
+  int kill_size;
+  BV *kill_bv;     /* dense KILL sets */
+  int kill_bv_avail;
+  int kill_bv_size;
+  int *kill_first; /* per node: offset of its KILL set */
+  int *kill_cnt;   /* per node: # defs in list, -1 if a bit vector */
+  int *same_addr;  /* defs grouped by names entry and address */
+  int *same_first; /* per def: first and last + 1 position in same_addr */
+  int *same_last;  /*   of the defs with the same names entry and address */
 
   /*
    * calculate the size (d) in units of BV required for each flow graph's
@@ -2475,14 +2582,26 @@ reaching_defs(void)
     assert(*(opt.def_setb.stg_base + i) == 0, "gflow: bv not zero", i, 3);
 #endif
 
+  NEW(kill_first, int, opt.num_nodes + 1);
+  NEW(kill_cnt, int, opt.num_nodes + 1);
+  kill_size = opt.ndefs + 1;
+  NEW(kill_list, int, kill_size);
+  kill_avail = 0;
+  kill_bv_size = def_bv_len * 4;
+  NEW(kill_bv, BV, kill_bv_size);
+  kill_bv_avail = 0;
+  group_defs(&same_addr, &same_first, &same_last);
+
   /*
-   * go through all the flow graph nodes in depth first order and define
-   * in(fg) to empty (done by zeroing out the entire area at allocation.
-   * out(fg) is set to the definitions in fg which reach the end of the
-   * node (gen flag).  Also, the queue of all the nodes is created.
+   * go through all the flow graph nodes in reverse depth first order and
+   * define in(fg) to empty (done by zeroing out the entire area at
+   * allocation.  out(fg) is set to the definitions in fg which reach the
+   * end of the node (gen flag), and kill(fg) is computed.  All of the
+   * nodes are initially pending.
    */
   for (i = 1; i <= opt.dfn; i++) {
     v = RDFOVTX_NODE(i);
+    FG_INQ(v) = 1;
 
     FG_IN(v) = opt.def_setb.stg_base + opt.def_setb.stg_avail;
     opt.def_setb.stg_avail += def_bv_len;
@@ -2492,12 +2611,46 @@ reaching_defs(void)
 
     /* OUT(v) = GEN(v) */
 
+#if DEBUG
+    if (OPTDBG(9, 64))
+      fprintf(gbl.dbgfil, "KILL(%5d):", v);
+#endif
+    kill_first[v] = kill_avail;
     def = FG_FDEF(v);
     while (def) {
-      if (DEF_GEN(def))
+      if (DEF_GEN(def)) {
+        /* since def is in GEN(v), find the other defs defining
+         * the same names entry.  These defs are in KILL(v). */
+        if (DEF_PRECISE(def) && !DEF_ARG(def))
+          for (k = same_first[def]; k < same_last[def]; k++)
+            if (DEF_FG(same_addr[k]) != v) {
+              NEED(kill_avail + 1, kill_list, int, kill_size, kill_size * 2);
+              kill_list[kill_avail++] = same_addr[k];
+#if DEBUG
+              if (OPTDBG(9, 64))
+                fprintf(gbl.dbgfil, " %d", same_addr[k]);
+#endif
+            }
         bv_set(bv, def);
+      }
       def = DEF_LNEXT(def);
     }
+#if DEBUG
+    if (OPTDBG(9, 64))
+      fprintf(gbl.dbgfil, "\n");
+#endif
+    kill_cnt[v] = kill_avail - kill_first[v];
+    if (kill_cnt[v] > def_bv_len) {
+      /* dense; replace the list with a bit vector */
+      NEED(kill_bv_avail + def_bv_len, kill_bv, BV, kill_bv_size,
+           kill_bv_size * 2 + def_bv_len);
+      bv_zero(kill_bv + kill_bv_avail, def_bv_len);
+      while (kill_avail > kill_first[v])
+        bv_set(kill_bv + kill_bv_avail, kill_list[--kill_avail]);
+      kill_first[v] = kill_bv_avail;
+      kill_cnt[v] = -1;
+      kill_bv_avail += def_bv_len;
+    }
     /*
      * if a call occurs in this block, then the GEN set contains
      * "call def"
@@ -2529,50 +2682,42 @@ reaching_defs(void)
    */
   top = 1;
   iter = 0;
-  do {
+  while (top <= opt.dfn) {
     ++iter;
-    changed = 0;
-    oldtop = top;
+    dfo = top;
     top = opt.dfn + 1;
-    for (dfo = oldtop; dfo <= opt.dfn; ++dfo) {
-      /* do the union of the OUT sets for the predecessors of v  */
+    for (; dfo <= opt.dfn; ++dfo) {
       v = RDFOVTX_NODE(dfo);
+      if (!FG_INQ(v))
+        continue;
+      FG_INQ(v) = 0;
+
+      /* do the union of the OUT sets for the predecessors of v  */
       bv = FG_IN(v);
-      bv_zero(bv, def_bv_len);
-      for (p = FG_PRED(v); p != PSI_P_NULL; p = PSI_NEXT(p))
-        bv_union(bv, FG_OUT(PSI_NODE(p)), def_bv_len);
+      p = FG_PRED(v);
+      if (p == PSI_P_NULL)
+        bv_zero(bv, def_bv_len);
+      else {
+        bv_copy(bv, FG_OUT(PSI_NODE(p)), def_bv_len);
+        for (p = PSI_NEXT(p); p != PSI_P_NULL; p = PSI_NEXT(p))
+          bv_union(bv, FG_OUT(PSI_NODE(p)), def_bv_len);
+      }
 
       /* new_out = IN(v)  */
       bv_copy(new_out, bv, def_bv_len);
 
-/* new_out = IN(v) - KILL(v) U GEN(v)  */
-/* go through the definitions in GEN(v)  */
-#if DEBUG
-      if (OPTDBG(9, 64))
-        fprintf(gbl.dbgfil, " defs killed:");
-#endif
+      /* new_out = IN(v) - KILL(v) U GEN(v)  */
+      if (kill_cnt[v] < 0)
+        bv_sub(new_out, kill_bv + kill_first[v], def_bv_len);
+      else
+        for (k = kill_first[v]; k < kill_first[v] + kill_cnt[v]; ++k)
+          bv_off(new_out, kill_list[k]); /* OUT(v) -= KILL(v) */
       def = FG_FDEF(v);
       while (def) {
-        if (DEF_GEN(def)) {
-          /* since def is in GEN(v), find the other defs defining
-           * the same names entry.  These defs are in KILL(v). */
-          if (DEF_PRECISE(def) && !DEF_ARG(def))
-            for (i = NME_DEF(DEF_NM(def)); i; i = DEF_NEXT(i))
-              if (DEF_FG(i) != v && DEF_ADDR(def) == DEF_ADDR(i)) {
-                bv_off(new_out, i); /* OUT(v) -= KILL(v) */
-#if DEBUG
-                if (OPTDBG(9, 64))
-                  fprintf(gbl.dbgfil, " %d", i);
-#endif
-              }
+        if (DEF_GEN(def))
           bv_set(new_out, def); /* OUT(v) U= GEN(v) */
-        }
         def = DEF_LNEXT(def);
       }
-#if DEBUG
-      if (OPTDBG(9, 64))
-        fprintf(gbl.dbgfil, "\n");
-#endif
       /*
        * if a call occurs in this block, "call def" is added to
        * OUT(v)
@@ -2619,16 +2764,26 @@ reaching_defs(void)
         for (s = FG_SUCC(v); s != PSI_P_NULL; s = PSI_NEXT(s)) {
           int ss, o;
           ss = PSI_NODE(s);
+          FG_INQ(ss) = 1;
           o = FG_RDFO(ss);
-          if (o < dfo && o < top) {
+          if (o <= dfo && o < top)
             top = o;
-            changed = 1;
-          }
         }
       }
     }
-  } while (changed);
+  }
+#if DEBUG
+  if (DBGBIT(9, 0x1000000))
+    fprintf(gbl.dbgfil, "reaching_defs: %d sweeps\n", iter);
+#endif
 
+  FREE(same_addr);
+  FREE(same_first);
+  FREE(same_last);
+  FREE(kill_first);
+  FREE(kill_cnt);
+  FREE(kill_list);
+  FREE(kill_bv);
   freearea(Q_AREA);
 
 }
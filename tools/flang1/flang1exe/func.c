@@ -70,6 +70,7 @@ static int reshape(int, int, int);
 static int _reshape(int, DTYPE, int);
 
 static int inline_reduction_f90(int ast, int dest, int lc, LOGICAL *doremove);
+static int inline_minmaxloc(int ast, int dest, int lc, LOGICAL *doremove);
 static int inline_reduction_craft(int, int, int);
 
 static void move_alloc_type(int, int, int);
@@ -5639,6 +5640,161 @@ inline_small_matmul(int ast, int dest)
   return arraydest;
 } /* inline_small_matmul */
 
+/* add a statement generated for an inlined intrinsic before stdnext */
+static void
+add_inline_stmt(int ast, int stdnext)
+{
+  int std;
+
+  std = add_stmt_before(ast, stdnext);
+  STD_LINENO(std) = STD_LINENO(stdnext);
+  STD_LOCAL(std) = 1;
+  STD_PAR(std) = STD_PAR(stdnext);
+  STD_TASK(std) = STD_TASK(stdnext);
+  STD_ACCEL(std) = STD_ACCEL(stdnext);
+  STD_KERNEL(std) = STD_KERNEL(stdnext);
+}
+
+/*
+ *  l = minloc(a)   or   i = minloc(a, 1)
+ *  where a is a rank-1 array or section of integer or real type and there
+ *  is no MASK, inline to
+ *   v = huge(a) ; k = 0 ; j = 0
+ *   do i$a = lb, ub, st
+ *     j = j + 1
+ *     if (a(i$a) .lt. v .or. k .eq. 0 .and. a(i$a) .eq. v) then
+ *       v = a(i$a) ; k = j
+ *     endif
+ *   enddo
+ *  which is the runtime's loop: the first minimum, or 0 if a is empty or
+ *  all NaN.  With DIM, return k; otherwise store k to the one element of
+ *  dest, or, if dest is zero, leave the call to the runtime.
+ */
+static int
+inline_minmaxloc(int ast, int dest, int lc, LOGICAL *doremove)
+{
+  int args, srcarray, astdim, dtyperes, dtypeval;
+  int home, forall, list, triple, elem, sptr;
+  int asttmp, asttmpval, asttmpcnt, destelem, dovar, lb, st, cond, tie;
+  int newast;
+  int stdnext, asd, i, n, dtypeidx;
+  int subs[MAXSUBS];
+
+  args = A_ARGSG(ast);
+  srcarray = ARGT_ARG(args, 0);
+  astdim = ARGT_ARG(args, 1);
+  dtyperes = DDTG(A_DTYPEG(ast));
+  dtypeval = DDTG(A_DTYPEG(srcarray));
+  if (ARGT_ARG(args, 2) || arg_gbl.inforall)
+    return ast;
+  if (astdim &&
+      (A_TYPEG(astdim) != A_CNST || get_int_cval(A_SPTRG(astdim)) != 1))
+    return ast;
+  if (!DT_ISINT(dtypeval) && !DT_ISREAL(dtypeval))
+    return ast;
+  if (A_TYPEG(srcarray) != A_ID && A_TYPEG(srcarray) != A_SUBSCR)
+    return ast;
+  if (!A_SHAPEG(srcarray) || SHD_NDIM(A_SHAPEG(srcarray)) != 1 ||
+      contains_any_call(srcarray))
+    return ast;
+
+  destelem = 0;
+  if (!astdim) {
+    /* the one element of the result array */
+    if (!dest || contains_any_call(dest))
+      return ast;
+    if (A_TYPEG(dest) == A_ID) {
+      if (!A_SHAPEG(dest) || SHD_NDIM(A_SHAPEG(dest)) != 1)
+        return ast;
+      subs[0] = check_member(dest, SHD_LWB(A_SHAPEG(dest), 0));
+      destelem = mk_subscr(dest, subs, 1, DDTG(A_DTYPEG(dest)));
+    } else if (A_TYPEG(dest) == A_SUBSCR) {
+      asd = A_ASDG(dest);
+      n = ASD_NDIM(asd);
+      for (i = 0; i < n; ++i) {
+        subs[i] = ASD_SUBS(asd, i);
+        if (A_TYPEG(subs[i]) == A_TRIPLE) {
+          if (!A_LBDG(subs[i]))
+            return ast;
+          subs[i] = A_LBDG(subs[i]);
+        }
+      }
+      destelem = mk_subscr(A_LOPG(dest), subs, n, DDTG(A_DTYPEG(dest)));
+    } else {
+      return ast;
+    }
+  }
+
+  home = convert_subscript(srcarray);
+  sptr = sptr_of_subscript(home);
+  forall = make_forall(A_SHAPEG(home), home, 0, lc + 1);
+  elem = normalize_forall(forall, home, 0);
+  list = A_LISTG(forall);
+  triple = ASTLI_TRIPLE(list);
+  dovar = mk_id(ASTLI_SPTR(list));
+  dtypeidx = A_DTYPEG(dovar);
+  lb = A_LBDG(triple);
+  st = A_STRIDEG(triple);
+  if (!st)
+    st = astb.i1;
+  stdnext = arg_gbl.std;
+
+  asttmp = mk_id(sym_get_scalar(SYMNAME(sptr), "r", dtyperes));
+  asttmpval = mk_id(sym_get_scalar(SYMNAME(sptr), "vr", dtypeval));
+  asttmpcnt = mk_id(sym_get_scalar(SYMNAME(sptr), "j", dtypeidx));
+  if (A_OPTYPEG(ast) == I_MINLOC)
+    newast = mk_largest_val(dtypeval);
+  else
+    newast = mk_smallest_val(dtypeval);
+  add_inline_stmt(mk_assn_stmt(asttmpval, newast, dtypeval), stdnext);
+  add_inline_stmt(mk_assn_stmt(asttmp, mk_cval(0, dtyperes), dtyperes),
+                  stdnext);
+  add_inline_stmt(mk_assn_stmt(asttmpcnt, mk_cval(0, dtypeidx), dtypeidx),
+                  stdnext);
+
+  newast = mk_stmt(A_DO, 0);
+  A_DOVARP(newast, dovar);
+  A_M1P(newast, lb);
+  A_M2P(newast, A_UPBDG(triple));
+  A_M3P(newast, st);
+  A_M4P(newast, 0);
+  add_inline_stmt(newast, stdnext);
+  /* count the elements rather than divide by the stride */
+  newast = mk_binop(OP_ADD, asttmpcnt, mk_cval(1, dtypeidx), dtypeidx);
+  add_inline_stmt(mk_assn_stmt(asttmpcnt, newast, dtypeidx), stdnext);
+
+  cond = mk_binop(A_OPTYPEG(ast) == I_MINLOC ? OP_LT : OP_GT, elem, asttmpval,
+                  DT_LOG);
+  tie = mk_binop(OP_LAND,
+                 mk_binop(OP_EQ, asttmp, mk_cval(0, dtyperes), DT_LOG),
+                 mk_binop(OP_EQ, elem, asttmpval, DT_LOG), DT_LOG);
+  newast = mk_stmt(A_IFTHEN, 0);
+  A_IFEXPRP(newast, mk_binop(OP_LOR, cond, tie, DT_LOG));
+  add_inline_stmt(newast, stdnext);
+  add_inline_stmt(mk_assn_stmt(asttmpval, elem, dtypeval), stdnext);
+  add_inline_stmt(
+      mk_assn_stmt(asttmp, mk_convert(asttmpcnt, dtyperes), dtyperes),
+      stdnext);
+  add_inline_stmt(mk_stmt(A_ENDIF, 0), stdnext);
+  add_inline_stmt(mk_stmt(A_ENDDO, 0), stdnext);
+
+  ccff_info(MSGOPT, "OPT022", 1, STD_LINENO(stdnext),
+            "%reduction reduction inlined", "reduction=%s",
+            SYMNAME(A_SPTRG(A_LOPG(ast))), NULL);
+  if (astdim) {
+    if (doremove)
+      *doremove = FALSE;
+    return asttmp;
+  }
+  add_inline_stmt(
+      mk_assn_stmt(destelem, mk_convert(asttmp, A_DTYPEG(destelem)),
+                   A_DTYPEG(destelem)),
+      stdnext);
+  if (doremove)
+    *doremove = TRUE;
+  return dest;
+}
+
 static int
 inline_reduction_f90(int ast, int dest, int lc, LOGICAL *doremove)
 {
@@ -5712,19 +5868,7 @@ inline_reduction_f90(int ast, int dest, int lc, LOGICAL *doremove)
     break;
   case I_MAXLOC:
   case I_MINLOC:
-      return ast;
-    /* simple cases only */
-    if (dest) {
-      if (A_TYPEG(dest) == A_SUBSCR) {
-        shape = A_SHAPEG(dest);
-        if (SHD_NDIM(shape) != 1 || SHD_LWB(shape, 0) != SHD_UPB(shape, 0))
-          return ast;
-      } else if (A_TYPEG(dest) != A_ID)
-        return ast;
-    }
-    if (doremove)
-      *doremove = TRUE;
-    break;
+    return inline_minmaxloc(ast, dest, lc, doremove);
   case I_MATMUL:
   case I_MATMUL_TRANSPOSE:
     if (doremove)
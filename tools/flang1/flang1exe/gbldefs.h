@@ -247,8 +247,6 @@ void export_public_module(int module, int exceptlist); /* exterf.c */
 void export_inline(FILE *export_fd, char *export_name,
                    char *file_name); /* exterf.c */
 
-LOGICAL is_initialized(int *bv, int nme); /* flow.c */
-
 int IPA_isnoconflict(int sptr); /* main.c */
 void reinit(void);              /* main.c */
 
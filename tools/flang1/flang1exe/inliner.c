@@ -1179,109 +1179,20 @@ removeautolist(int listhead, int oldsymavl)
 static void
 remove_inlined_symbols(int oldsymavl)
 {
-  int sptr, hashval, len;
-  char *np;
-  INT V[4];
+  int sptr;
   for (sptr = stb.symavl - 1; sptr >= oldsymavl; --sptr) {
-    hashval = -1;
-    switch (STYPEG(sptr)) {
-    case ST_CONST:
-      switch (DTY(DTYPEG(sptr))) {
-      case TY_BINT:
-      case TY_SINT:
-      case TY_INT:
-      case TY_BLOG:
-      case TY_SLOG:
-      case TY_LOG:
-      case TY_WORD:
-      case TY_REAL:
-      case TY_DWORD:
-      case TY_DBLE:
-      case TY_CMPLX:
-      case TY_INT8:
-      case TY_LOG8:
-        V[0] = CONVAL1G(sptr);
-        V[1] = CONVAL2G(sptr);
-        hashval = HASH_CON(V);
-        if (hashval < 0)
-          hashval = -hashval;
-        break;
-      case TY_QUAD:
-      case TY_DCMPLX:
-      case TY_QCMPLX:
-      case TY_HOLL:
-      case TY_NCHAR:
-        V[0] = CONVAL1G(0);
-        V[1] = CONVAL2G(0);
-        V[2] = CONVAL3G(0);
-        V[3] = CONVAL4G(0);
-        hashval = HASH_CON(V);
-        if (hashval < 0)
-          hashval = -hashval;
-        break;
-      case TY_CHAR:
-        np = stb.n_base + CONVAL1G(sptr);
-        HASH_ID(hashval, np, strlen(np));
-        if (hashval < 0)
-          hashval = -hashval;
-        break;
-      default:
-        interr("remove_inlined_symbols: unknown constant datatype", 0, 4);
-        return;
-      }
-      break;
-    case ST_UNKNOWN:
-    case ST_IDENT:
-    case ST_LABEL:
-    case ST_STAG:
-    case ST_MEMBER:
-    case ST_VAR:
-    case ST_ARRAY:
-    case ST_DESCRIPTOR:
-    case ST_STRUCT:
-    case ST_UNION:
-    case ST_CMBLK:
-    case ST_NML:
-    case ST_ENTRY:
-    case ST_PROC:
-    case ST_STFUNC:
-    case ST_PARAM:
-    case ST_INTRIN:
-    case ST_GENERIC:
-    case ST_USERGENERIC:
-    case ST_PD:
-    case ST_PLIST:
-    case ST_ARRDSC:
-    case ST_ALIAS:
-    case ST_MODULE:
-    case ST_TYPEDEF:
-    case ST_OPERATOR:
-    case ST_MODPROC:
-    case ST_CONSTRUCT:
-    case ST_CRAY:
-      np = SYMNAME(sptr);
-      if (np) {
-        len = strlen(np);
-        HASH_ID(hashval, np, len);
-        if (hashval < 0)
-          hashval = -hashval;
-      }
-      break;
-    default:;
-    }
-    if (hashval >= 0) {
-      int s, ps;
-      for (s = stb.hashtb[hashval], ps = 0; s; s = HASHLKG(s)) {
-        if (s == sptr) {
-          if (ps) {
-            HASHLKP(ps, HASHLKG(s));
-          } else {
-            stb.hashtb[hashval] = HASHLKG(s);
-          }
-          break;
+    /* stb.hashv is the code sptr was linked with, or 0 if it never was */
+    int s, ps;
+    for (s = HASHTB(stb.hashv[sptr]), ps = 0; s; s = HASHLKG(s)) {
+      if (s == sptr) {
+        if (ps) {
+          HASHLKP(ps, HASHLKG(s));
+        } else {
+          HASHTB(stb.hashv[sptr]) = HASHLKG(s);
         }
-        ps = s;
+        break;
       }
+      ps = s;
     }
   }
 
@@ -242,10 +242,11 @@ static struct {  /* table of asts read from mod file   */
   int sz;
 } astz;
 
-/* hash size is 1024 entries = 2^10, so HASHMASK has 10 lower-order bits on */
+/* astzhash starts with 1024 = 2^10 entries and doubles when there are
+ * more ASTs than entries; the hash is the low-order bits of the old ast */
 #define ASTZHASHSIZE 1024
-#define ASTZHASHMASK 0x03ff
-static int astzhash[ASTZHASHSIZE];
+static int *astzhash;
+static int astzhashsz;
 
 static struct {/* table of stds read from file */
   STDITEM *base;
@@ -287,10 +288,14 @@ static SYMITEM *symbol_list; /* list of symbols read from mod file  */
 static ALNITEM *align_list;  /* list of align descrs read from mod file */
 static DSTITEM *dist_list;   /* list of dist descrs read from mod file */
 
-#define SYMHASHSIZE 521
-static SYMITEM *symhash[SYMHASHSIZE];
-#define DTHASHSIZE 521
-static int dthash[DTHASHSIZE];
+/* like astzhash, symhash and dthash are powers of 2 that double when
+ * they hold more entries than buckets */
+#define SYMHASHSIZE 1024
+static SYMITEM **symhash;
+static int symhashsz, symhashcnt;
+#define DTHASHSIZE 1024
+static int *dthash;
+static int dthashsz, dthashcnt;
 
 #define BUFF_LEN 4096
 static char *buff = NULL;
@@ -367,6 +372,8 @@ import_fini(void)
   FREE(imported_modules.list);
   imported_modules.avail = 0;
   imported_modules.size = 0;
+  FREE(symhash);
+  symhashsz = 0;
 } /* import_fini */
 
 static void
@@ -1650,37 +1657,14 @@ find_nmptr(char *symname)
   int hash, hptr, len;
   len = strlen(symname);
   HASH_ID(hash, symname, len);
-  for (hptr = stb.hashtb[hash]; hptr; hptr = HASHLKG(hptr)) {
-    if (strcmp(SYMNAME(hptr), symname) == 0) {
+  for (hptr = HASHTB(hash); hptr; hptr = HASHLKG(hptr)) {
+    if (stb.hashv[hptr] == hash && strcmp(SYMNAME(hptr), symname) == 0) {
       return NMPTRG(hptr);
     }
   }
   return putsname(symname, len);
 } /* find_nmptr */
 
-/** \brief Find a nmptr index for this name, then link this symbol into
- * the stb.hashtb hash links.
- */
-static void
-hash_link_name(int sptr, char *symname)
-{
-  int hash, hptr, len, nmptr;
-  len = strlen(symname);
-  HASH_ID(hash, symname, len);
-  nmptr = 0;
-  for (hptr = stb.hashtb[hash]; hptr; hptr = HASHLKG(hptr)) {
-    if (strcmp(SYMNAME(hptr), symname) == 0) {
-      nmptr = NMPTRG(hptr);
-      break;
-    }
-  }
-  if (!nmptr)
-    nmptr = putsname(symname, len);
-  NMPTRP(sptr, nmptr);
-  HASHLKP(sptr, stb.hashtb[hash]);
-  stb.hashtb[hash] = sptr;
-} /* hash_link_name */
-
 static int
 find_member_name(char *symname, int stype, int scopesym, int offset)
 {
@@ -1688,6 +1672,8 @@ find_member_name(char *symname, int stype, int scopesym, int offset)
   int hash, len;
   int dtype = 0;
 
+  len = strlen(symname);
+  HASH_ID(hash, symname, len);
   base = CMEMFG(scopesym);
 
   if (STYPEG(scopesym) == ST_TYPEDEF) {
@@ -1700,10 +1686,9 @@ find_member_name(char *symname, int stype, int scopesym, int offset)
 
   if (base == 0 || scopesym == gbl.currmod || offset < 0) {
     /* check hash table */
-    len = strlen(symname);
-    HASH_ID(hash, symname, len);
-    for (sptr = stb.hashtb[hash]; sptr; sptr = HASHLKG(sptr)) {
-      if (STYPEG(sptr) == stype && strcmp(SYMNAME(sptr), symname) == 0) {
+    for (sptr = HASHTB(hash); sptr; sptr = HASHLKG(sptr)) {
+      if (stb.hashv[sptr] == hash && STYPEG(sptr) == stype &&
+          strcmp(SYMNAME(sptr), symname) == 0) {
         int scope;
         for (scope = SCOPEG(sptr); scope; scope = SCOPEG(scope)) {
           if (dtype && (!CLASSG(sptr) && !VTABLEG(sptr))) {
@@ -1760,10 +1745,9 @@ find_member_name(char *symname, int stype, int scopesym, int offset)
     }
   }
   /* check hash table */
-  len = strlen(symname);
-  HASH_ID(hash, symname, len);
-  for (sptr = stb.hashtb[hash]; sptr; sptr = HASHLKG(sptr)) {
-    if (STYPEG(sptr) == stype && strcmp(SYMNAME(sptr), symname) == 0) {
+  for (sptr = HASHTB(hash); sptr; sptr = HASHLKG(sptr)) {
+    if (stb.hashv[sptr] == hash && STYPEG(sptr) == stype &&
+        strcmp(SYMNAME(sptr), symname) == 0) {
       int scope;
       for (scope = SCOPEG(sptr); scope; scope = SCOPEG(scope)) {
         if (scope == scopesym)
@@ -1784,20 +1768,56 @@ static int module_base = 0; /* base symbol for modules */
 static void
 inithash(void)
 {
-  int i;
-  for (i = 0; i < SYMHASHSIZE; ++i) {
-    symhash[i] = NULL;
-  }
-  for (i = 0; i < DTHASHSIZE; ++i) {
-    dthash[i] = 0;
-  }
+  /* symhash outlives import() since new_symbol() is also used to fix
+   * up the host append list; it is freed by import_fini() */
+  if (symhashsz != SYMHASHSIZE) {
+    FREE(symhash);
+    symhashsz = SYMHASHSIZE;
+    NEW(symhash, SYMITEM *, symhashsz);
+  }
+  symhashcnt = 0;
+  BZERO(symhash, SYMITEM *, symhashsz);
+  dthashsz = DTHASHSIZE;
+  dthashcnt = 0;
+  NEW(dthash, int, dthashsz);
+  BZERO(dthash, int, dthashsz);
 } /* inithash */
 
+/* Double symhash; each chain is split in two in its original order. */
+static void
+growhash(void)
+{
+  SYMITEM **tb, **tail[2];
+  SYMITEM *ps, *next;
+  int i, n;
+
+  n = symhashsz;
+  NEW(tb, SYMITEM *, 2 * n);
+  for (i = 0; i < n; ++i) {
+    tail[0] = &tb[i];
+    tail[1] = &tb[i + n];
+    for (ps = symhash[i]; ps; ps = next) {
+      int hi = (ps->sptr & n) != 0;
+      next = ps->hashnext;
+      *tail[hi] = ps;
+      tail[hi] = &ps->hashnext;
+    }
+    *tail[0] = NULL;
+    *tail[1] = NULL;
+  }
+  FREE(symhash);
+  symhash = tb;
+  symhashsz = 2 * n;
+} /* growhash */
+
 static void
 inserthash(int sptr, SYMITEM *ps)
 {
   int h;
-  h = sptr % SYMHASHSIZE;
+  /* grow first: the caller may not have filled in ps->sptr yet */
+  if (++symhashcnt > symhashsz)
+    growhash();
+  h = sptr & (symhashsz - 1);
   ps->hashnext = symhash[h];
   symhash[h] = ps;
 } /* inserthash */
@@ -1807,7 +1827,9 @@ findhash(int sptr)
 {
   int h;
   SYMITEM *ps;
-  h = sptr % SYMHASHSIZE;
+  if (symhash == NULL)
+    return NULL;
+  h = sptr & (symhashsz - 1);
   for (ps = symhash[h]; ps; ps = ps->hashnext) {
     if (ps->sptr == sptr)
       return ps;
@@ -1815,13 +1837,47 @@ findhash(int sptr)
   return NULL;
 } /* findhash */
 
+/* Double dthash; each chain is split in two in its original order. */
+static void
+growdthash(void)
+{
+  int *tb;
+  int i, n, d, next, hi;
+  int tail[2];
+
+  n = dthashsz;
+  NEW(tb, int, 2 * n);
+  for (i = 0; i < n; ++i) {
+    tb[i] = tb[i + n] = 0;
+    tail[0] = tail[1] = 0;
+    for (d = dthash[i]; d; d = next) {
+      next = dtz.base[d - 1].hashnext;
+      hi = (dtz.base[d - 1].id & n) != 0;
+      if (tail[hi])
+        dtz.base[tail[hi] - 1].hashnext = d;
+      else
+        tb[i + hi * n] = d;
+      tail[hi] = d;
+    }
+    if (tail[0])
+      dtz.base[tail[0] - 1].hashnext = 0;
+    if (tail[1])
+      dtz.base[tail[1] - 1].hashnext = 0;
+  }
+  FREE(dthash);
+  dthash = tb;
+  dthashsz = 2 * n;
+} /* growdthash */
+
 static void
 insertdthash(int old_dt, int d)
 {
   int h;
-  h = old_dt % DTHASHSIZE;
+  h = old_dt & (dthashsz - 1);
   dtz.base[d].hashnext = dthash[h];
   dthash[h] = d + 1; /* offset hash links by one, since zero is legal */
+  if (++dthashcnt > dthashsz)
+    growdthash();
 } /* insertdthash */
 
 static DITEM *
@@ -1829,7 +1885,7 @@ finddthash(int old_dt)
 {
   int h;
   int d;
-  h = old_dt % SYMHASHSIZE;
+  h = old_dt & (dthashsz - 1);
   for (d = dthash[h]; d; d = dtz.base[d - 1].hashnext) {
     DITEM *pd;
     pd = dtz.base + (d - 1);
@@ -1839,6 +1895,38 @@ finddthash(int old_dt)
   return NULL;
 } /* finddthash */
 
+/* Double astzhash; each chain is split in two in its original order. */
+static void
+growastzhash(void)
+{
+  int *tb;
+  int i, n, s, next, hi;
+  int tail[2];
+
+  n = astzhashsz;
+  NEW(tb, int, 2 * n);
+  for (i = 0; i < n; ++i) {
+    tb[i] = tb[i + n] = 0;
+    tail[0] = tail[1] = 0;
+    for (s = astzhash[i]; s; s = next) {
+      next = astz.base[s - 1].link;
+      hi = (astz.base[s - 1].old_ast & n) != 0;
+      if (tail[hi])
+        astz.base[tail[hi] - 1].link = s;
+      else
+        tb[i + hi * n] = s;
+      tail[hi] = s;
+    }
+    if (tail[0])
+      astz.base[tail[0] - 1].link = 0;
+    if (tail[1])
+      astz.base[tail[1] - 1].link = 0;
+  }
+  FREE(astzhash);
+  astzhash = tb;
+  astzhashsz = 2 * n;
+} /* growastzhash */
+
 static int original_symavl = 0;
 static unsigned A_IDSTR_mask = (1 << 5); /* A_IDSTR is AST bit flag f5 */
 static LOGICAL any_ptr_constant = FALSE;
@@ -1934,7 +2022,9 @@ import(lzhandle *fdlz)
   astz.sz = 64;
   NEW(astz.base, ASTITEM, astz.sz);
   astz.avl = 0;
-  BZERO(astzhash, int, ASTZHASHSIZE);
+  astzhashsz = ASTZHASHSIZE;
+  NEW(astzhash, int, astzhashsz);
+  BZERO(astzhash, int, astzhashsz);
 
   stdz.sz = 64;
   NEW(stdz.base, STDITEM, stdz.sz);
@@ -2026,9 +2116,11 @@ import(lzhandle *fdlz)
         sptr = getsymbol(idname);
         pa->a.w4 = sptr;
       }
-      hash = pa->old_ast & ASTZHASHMASK;
+      hash = pa->old_ast & (astzhashsz - 1);
       pa->link = astzhash[hash];
       astzhash[hash] = astz.avl;
+      if (astz.avl > astzhashsz)
+        growastzhash();
       if (!first_ast) {
         if (astb.firstuast == 12 && pa->old_ast < 12) {
           /* older versions of the compiler reserved ASTs numbered
@@ -3000,6 +3092,8 @@ exit_loop:
     new_stds();
 
 exit_import:
+  FREE(dthash);
+  FREE(astzhash);
   FREE(dtz.base);
   FREE(flz.base);
   FREE(ovz.base);
@@ -4789,7 +4883,7 @@ new_ast(int old_ast)
   int hash, s;
 
 get_new:
-  hash = old_ast & ASTZHASHMASK;
+  hash = old_ast & (astzhashsz - 1);
   for (s = astzhash[hash]; s; s = pa->link) {
     pa = astz.base + (s - 1);
     if (pa->old_ast == old_ast)
@@ -47,6 +47,14 @@ int lower_line;
 int lower_disable_ptr_chk = 0;
 int lower_disable_subscr_chk = 0;
 
+/* the STD_VECT loop being lowered; see vect_array_loops() */
+static struct {
+  int dovar; /* A_ID of its DO variable, 0 outside such a loop */
+  int nelem; /* array elements per vector */
+  int dtype; /* data type of its assignments */
+  int mask;  /* FVCMP ILM of the enclosing IF-THEN's condition, or 0 */
+} vloop;
+
 #define VarBase 0
 #define SourceBase 1
 #define TargetBase 2
@@ -2081,6 +2089,18 @@ lower_do_stmt(int std, int ast, int lineno, int label)
     lower_push(doinc);
     lower_push(schedtype);
     lower_push(STKDO);
+    if (STD_VECT(std)) {
+      /* the body is lowered to FV ILMs up to the ENDDO */
+      int s;
+      vloop.dovar = lop;
+      vloop.nelem = get_int_cval(A_SPTRG(doincast));
+      vloop.dtype = 0;
+      vloop.mask = 0;
+      for (s = STD_NEXT(std); s && !vloop.dtype; s = STD_NEXT(s)) {
+        if (A_TYPEG(STD_AST(s)) == A_ASN)
+          vloop.dtype = A_DTYPEG(A_DESTG(STD_AST(s)));
+      }
+    }
   } else if (A_ORDEREDG(ast) || A_SCHED_TYPEG(ast) == DI_SCH_DYNAMIC ||
              A_SCHED_TYPEG(ast) == DI_SCH_GUIDED ||
              A_SCHED_TYPEG(ast) == DI_SCH_RUNTIME ||
@@ -2664,6 +2684,252 @@ lower_enddo_stmt(int lineno, int label, int std, int ispdo)
 
 } /* lower_enddo_stmt */
 
+/* Return PF_WRITE if the object prefetched by the PREFETCH statement std
+ * is assigned anywhere in the innermost loop containing the statement,
+ * so that the cache line is fetched for writing.
+ */
+static int
+prefetch_write(int std)
+{
+  int sptr, s, depth, write;
+
+  sptr = sym_of_ast(A_LOPG(STD_AST(std)));
+  write = 0;
+  depth = 0;
+  for (s = STD_NEXT(std); s; s = STD_NEXT(s)) {
+    int ast = STD_AST(s);
+    if (A_TYPEG(ast) == A_DO || A_TYPEG(ast) == A_DOWHILE) {
+      ++depth;
+    } else if (A_TYPEG(ast) == A_ENDDO) {
+      if (--depth < 0)
+        break;
+    } else if (A_TYPEG(ast) == A_ASN && sym_of_ast(A_DESTG(ast)) == sptr) {
+      write = PF_WRITE;
+    }
+  }
+  if (!s)
+    return 0; /* not in a loop */
+  depth = 0;
+  for (s = STD_PREV(std); s && !write; s = STD_PREV(s)) {
+    int ast = STD_AST(s);
+    if (A_TYPEG(ast) == A_ENDDO) {
+      ++depth;
+    } else if (A_TYPEG(ast) == A_DO || A_TYPEG(ast) == A_DOWHILE) {
+      if (--depth < 0)
+        break;
+    } else if (A_TYPEG(ast) == A_ASN && sym_of_ast(A_DESTG(ast)) == sptr) {
+      write = PF_WRITE;
+    }
+  }
+  return write;
+}
+
+/* does the expression depend on the DO variable of the vector loop */
+static LOGICAL
+lower_vect_varies(int ast)
+{
+  int asd, argt, i;
+
+  switch (A_TYPEG(ast)) {
+  case A_ID:
+    return ast == vloop.dovar;
+  case A_PAREN:
+  case A_CONV:
+  case A_UNOP:
+    return lower_vect_varies(A_LOPG(ast));
+  case A_BINOP:
+    return lower_vect_varies(A_LOPG(ast)) || lower_vect_varies(A_ROPG(ast));
+  case A_SUBSCR:
+    asd = A_ASDG(ast);
+    for (i = 0; i < ASD_NDIM(asd); ++i) {
+      if (lower_vect_varies(ASD_SUBS(asd, i)))
+        return TRUE;
+    }
+    return FALSE;
+  case A_INTR:
+    argt = A_ARGSG(ast);
+    for (i = 0; i < A_ARGCNTG(ast); ++i) {
+      if (lower_vect_varies(ARGT_ARG(argt, i)))
+        return TRUE;
+    }
+    return FALSE;
+  default:
+    return FALSE;
+  }
+}
+
+static int lower_vect_mask(int ast, int dtype);
+
+/* lower an expression of the vector loop to FV ILMs */
+static int
+lower_vect_expr(int ast, int dtype)
+{
+  int ilm, rilm, argt, n;
+  char *opc;
+
+  if (!lower_vect_varies(ast)) {
+    /* the same value in every element */
+    lower_expression(ast);
+    ilm = lower_conv(ast, dtype);
+    return plower("oidn", "FVSPLAT", ilm, dtype, vloop.nelem);
+  }
+  switch (A_TYPEG(ast)) {
+  case A_SUBSCR:
+    lower_expression(ast);
+    return plower("oidn", "FVLD", lower_base(ast), dtype, vloop.nelem);
+  case A_PAREN:
+    return lower_vect_expr(A_LOPG(ast), dtype);
+  case A_UNOP:
+    ilm = lower_vect_expr(A_LOPG(ast), dtype);
+    if (A_OPTYPEG(ast) == OP_NEG)
+      ilm = plower("oi", "FVNEG", ilm);
+    return ilm;
+  case A_BINOP:
+    ilm = lower_vect_expr(A_LOPG(ast), dtype);
+    if ((A_OPTYPEG(ast) == OP_XTOI || A_OPTYPEG(ast) == OP_XTOX) &&
+        DT_ISINT(A_DTYPEG(A_ROPG(ast)))) {
+      rilm = ilm;
+      for (n = CONVAL2G(A_SPTRG(A_ALIASG(A_ROPG(ast)))); n > 1; --n)
+        rilm = plower("oii", "FVMUL", rilm, ilm);
+      return rilm;
+    }
+    rilm = lower_vect_expr(A_ROPG(ast), dtype);
+    switch (A_OPTYPEG(ast)) {
+    case OP_ADD:
+      opc = "FVADD";
+      break;
+    case OP_SUB:
+      opc = "FVSUB";
+      break;
+    case OP_MUL:
+      opc = "FVMUL";
+      break;
+    case OP_DIV:
+      opc = "FVDIV";
+      break;
+    case OP_XTOI:
+    case OP_XTOX:
+      opc = "FVPOW";
+      break;
+    default:
+      ast_error("unexpected vector operator", ast);
+      return ilm;
+    }
+    return plower("oii", opc, ilm, rilm);
+  case A_INTR:
+    argt = A_ARGSG(ast);
+    ilm = lower_vect_expr(ARGT_ARG(argt, 0), dtype);
+    switch (A_OPTYPEG(ast)) {
+    case I_SQRT:
+    case I_DSQRT:
+      return plower("oi", "FVSQRT", ilm);
+    case I_EXP:
+    case I_DEXP:
+      return plower("oi", "FVEXP", ilm);
+    case I_LOG:
+    case I_ALOG:
+    case I_DLOG:
+      return plower("oi", "FVLOG", ilm);
+    case I_SIN:
+    case I_DSIN:
+      return plower("oi", "FVSIN", ilm);
+    case I_COS:
+    case I_DCOS:
+      return plower("oi", "FVCOS", ilm);
+    case I_TANH:
+    case I_DTANH:
+      return plower("oi", "FVTANH", ilm);
+    case I_ABS:
+    case I_DABS:
+      return plower("oi", "FVABS", ilm);
+    case I_MAX:
+    case I_AMAX1:
+    case I_DMAX1:
+      rilm = lower_vect_expr(ARGT_ARG(argt, 1), dtype);
+      return plower("oii", "FVMAX", ilm, rilm);
+    case I_MIN:
+    case I_AMIN1:
+    case I_DMIN1:
+      rilm = lower_vect_expr(ARGT_ARG(argt, 1), dtype);
+      return plower("oii", "FVMIN", ilm, rilm);
+    case I_MERGE:
+      rilm = lower_vect_expr(ARGT_ARG(argt, 1), dtype);
+      return plower("oiii", "FVMERGE", ilm, rilm,
+                    lower_vect_mask(ARGT_ARG(argt, 2), dtype));
+    }
+    break;
+  }
+  ast_error("unexpected vector expression", ast);
+  return plower("oidn", "FVSPLAT", lower_null(), dtype, vloop.nelem);
+}
+
+/* lower a comparison of the vector loop to an FVCMP */
+static int
+lower_vect_mask(int ast, int dtype)
+{
+  int lilm, rilm, cc;
+
+  if (A_TYPEG(ast) == A_PAREN)
+    return lower_vect_mask(A_LOPG(ast), dtype);
+  switch (A_OPTYPEG(ast)) {
+  case OP_EQ:
+    cc = 1;
+    break;
+  case OP_NE:
+    cc = 2;
+    break;
+  case OP_LT:
+    cc = 3;
+    break;
+  case OP_GE:
+    cc = 4;
+    break;
+  case OP_LE:
+    cc = 5;
+    break;
+  case OP_GT:
+    cc = 6;
+    break;
+  default:
+    ast_error("unexpected vector mask", ast);
+    cc = 1;
+    break;
+  }
+  lilm = lower_vect_expr(A_LOPG(ast), dtype);
+  rilm = lower_vect_expr(A_ROPG(ast), dtype);
+  return plower("oiin", "FVCMP", lilm, rilm, cc);
+}
+
+/*
+ * assignment in the vector loop: a(i:i+n-1) = ...
+ * Under an IF-THEN, the assignment goes in the ILM block that the IF-THEN
+ * started, so that it can use the mask computed there.
+ */
+static void
+lower_vect_asn(int std, int ast, int lineno, int label)
+{
+  int dest = A_DESTG(ast);
+  int dtype = A_DTYPEG(dest);
+  int lilm, rilm, oilm;
+
+  if (vloop.mask)
+    lower_reinit();
+  else
+    lower_start_stmt(lineno, label, TRUE, std);
+  lower_expression(dest);
+  lilm = lower_base(dest);
+  lower_reinit();
+  rilm = lower_vect_expr(A_SRCG(ast), dtype);
+  if (vloop.mask) {
+    /* where the mask is false, store the old elements back */
+    oilm = plower("oidn", "FVLD", lilm, dtype, vloop.nelem);
+    rilm = plower("oiii", "FVMERGE", rilm, oilm, vloop.mask);
+  }
+  plower("oii", "FVST", lilm, rilm);
+  if (!vloop.mask)
+    lower_end_stmt(std);
+}
+
 void
 lower_stmt(int std, int ast, int lineno, int label)
 {
@@ -3438,6 +3704,10 @@ lower_stmt(int std, int ast, int lineno, int label)
     break;
 
   case A_ASN:
+    if (vloop.dovar) {
+      lower_vect_asn(std, ast, lineno, label);
+      break;
+    }
     lower_start_stmt(lineno, label, TRUE, std);
     dest = A_DESTG(ast);
     lower_expression(dest);
@@ -4178,6 +4448,13 @@ lower_stmt(int std, int ast, int lineno, int label)
     break;
 
   case A_IFTHEN:
+    if (vloop.dovar) {
+      /* the condition masks each assignment up to the ENDIF; it is
+       * computed once, before any of them stores; see lower_vect_asn() */
+      lower_start_stmt(lineno, label, TRUE, std);
+      vloop.mask = lower_vect_mask(A_IFEXPRG(ast), vloop.dtype);
+      break;
+    }
     lower_start_stmt(lineno, label, TRUE, std);
     iflab.thenlabel = 0;
     iflab.elselabel = lower_lab();
@@ -4233,6 +4510,11 @@ lower_stmt(int std, int ast, int lineno, int label)
     break;
 
   case A_ENDIF:
+    if (vloop.dovar) {
+      lower_end_stmt(std);
+      vloop.mask = 0;
+      break;
+    }
     lower_start_stmt(lineno, label, TRUE, std);
     lower_check_stack(STKIF);
     iflab.endlabel = lower_pop();
@@ -4290,6 +4572,7 @@ lower_stmt(int std, int ast, int lineno, int label)
     break;
 
   case A_ENDDO:
+    vloop.dovar = 0;
     lower_enddo_stmt(lineno, label, std, 0);
     break;
   case A_MP_ENDPDO:
@@ -4938,7 +5221,7 @@ lower_stmt(int std, int ast, int lineno, int label)
     lower_start_stmt(lineno, label, TRUE, std);
     lower_expression(A_LOPG(ast));
     ilm = lower_base(A_LOPG(ast));
-    plower("oin", "PREFETCH", ilm, A_OPTYPEG(ast));
+    plower("oin", "PREFETCH", ilm, A_OPTYPEG(ast) | prefetch_write(std));
     lower_end_stmt(std);
     break;
   case A_PRAGMA:
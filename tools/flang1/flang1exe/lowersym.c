@@ -1801,7 +1801,7 @@ check_additional_common(int newcom)
 
   /* look through all symbols on that hash list, look for another
    * common block of the same name with VISIT bit set */
-  for (link = stb.hashtb[hash]; link; link = HASHLKG(link)) {
+  for (link = HASHTB(hash); link; link = HASHLKG(link)) {
     if (link != newcom && NMPTRG(link) == NMPTRG(newcom) &&
         STYPEG(link) == ST_CMBLK && VISITG(link))
       break;
@@ -3137,7 +3137,7 @@ find_nmptr(char *symname, int len)
 {
   int hash, hptr;
   HASH_ID(hash, symname, len);
-  for (hptr = stb.hashtb[hash]; hptr; hptr = HASHLKG(hptr)) {
+  for (hptr = HASHTB(hash); hptr; hptr = HASHLKG(hptr)) {
     if (strcmp(SYMNAME(hptr), symname) == 0) {
       return NMPTRG(hptr);
     }
@@ -3638,6 +3638,7 @@ lower_symbol(int sptr)
     putbit("task", 0);
 #endif
     putbit("volatile", VOLG(sptr));
+    putbit("asynchronous", ASYNCG(sptr));
     if (sc == SC_DUMMY || sc == SC_BASED ||
         (CLASSG(sptr) && stype == ST_DESCRIPTOR)) {
       putval("address", 0);
@@ -24,6 +24,7 @@
 #include "error.h"
 #if !defined(TARGET_WIN)
 #include <unistd.h>
+#include <sys/resource.h>
 #endif
 #include <time.h>
 #include "global.h"
@@ -54,6 +55,7 @@
 /* static prototypes */
 
 static void reptime(void);
+static void repmem(FILE *);
 static void add_debuglist(char *phasearg, char *dumparg);
 static void do_debug(char *phase);
 static void cleanup(void);
@@ -73,8 +75,8 @@ static action_map_t *phase_dump_map;
 #if DEBUG
 static int debugfunconly = -1;
 #endif
-static char *who[] = {"init",     "parser",   "bblock", "vectorize", "optimize",
-                      "schedule", "assemble", "xref",   "unroll"};
+static char *who[] = {"init",  "parser", "bblock", "transform", "optimize",
+                      "lower", "xref",   "finish"};
 #define _N_WHO (sizeof(who) / sizeof(char *))
 static INT xtimes[_N_WHO];
 static LOGICAL postprocessing = TRUE;
@@ -262,6 +264,7 @@ main(int argc, char *argv[])
           DUMP("inliner");
           TR1("- after inliner");
         }
+        xtimes[2] += getcpu();
 
         if (flg.opt >= 2 && XBIT(50, 0x40)) {
           unconditional_branches();
@@ -340,6 +343,7 @@ main(int argc, char *argv[])
           TR1("- after convert_output");
           DUMP("convert-output");
         }
+        xtimes[3] += getcpu();
         if (XBIT(70, 0x400) || XBIT(47, 0x400000)
                 ) {
           optimize(1);
@@ -370,11 +374,16 @@ main(int argc, char *argv[])
           DUMP("optimize");
           TR1("- after optimize");
         }
+        if (flg.opt >= 2 && !XBIT(224, 0x1)) {
+          vect_array_loops();
+          DUMP("vect-array-loops");
+        }
 
         direct_rou_end();
         if (flg.opt >= 2 && XBIT(53, 2)) {
           fini_points_to_all();
         }
+        xtimes[4] += getcpu();
       } else { /* gbl.rutype == RU_BDATA */
         direct_rou_load(gbl.currsub);
         merge_commons();
@@ -396,6 +405,7 @@ main(int argc, char *argv[])
           DUMP("transform");
           TR1("- after transform");
         }
+        xtimes[3] += getcpu();
       }
 #if DEBUG
       if (XBIT(57, 0x100)) {
@@ -416,6 +426,7 @@ main(int argc, char *argv[])
       if (gbl.rutype != RU_BDATA && flg.opt >= 2 && XBIT(53, 2)) {
         fini_pstride_analysis();
       }
+      xtimes[5] += getcpu();
 #if DEBUG
       if (DBGBIT(5, 4))
         symdmp(gbl.dbgfil, DBGBIT(5, 8));
@@ -430,7 +441,7 @@ main(int argc, char *argv[])
 
     if (flg.xref) {
       xref(); /* write cross reference map */
-      xtimes[7] += getcpu();
+      xtimes[6] += getcpu();
     }
   skip_compile:
     (void)summary(FALSE, FALSE);
@@ -1126,6 +1137,7 @@ reptime(void)
   int prct;
   int tmp;
 
+  xtimes[7] += getcpu();
   total = 0;
   for (i = 0; i < _N_WHO; i++)
     total += xtimes[i];
@@ -1156,6 +1168,8 @@ reptime(void)
     list_line(buf);
   } else if (gbl.dbgfil)
     fprintf(gbl.dbgfil, "%s\n", buf);
+  if (gbl.dbgfil)
+    repmem(gbl.dbgfil);
 
 xbitcheck:
   if (!XBIT(0, 1))
@@ -1173,6 +1187,21 @@ xbitcheck:
   }
   sprintf(buf, "    Total time %15d millisecs", total);
   fprintf(stderr, "%s\n", buf);
+  repmem(stderr);
+}
+
+/* Write the peak memory use to out, for the -time report. */
+static void
+repmem(FILE *out)
+{
+#if !defined(TARGET_WIN)
+  struct rusage ru;
+
+  if (getrusage(RUSAGE_SELF, &ru) == 0) {
+    fprintf(out, "  Memory stats:\n");
+    fprintf(out, "    Peak RSS   %12ld KB\n", (long)ru.ru_maxrss);
+  }
+#endif
 }
 
 static void
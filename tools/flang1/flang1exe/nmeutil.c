@@ -24,6 +24,7 @@
 #include "error.h"
 #include "symtab.h"
 #include "nme.h"
+#include "flang/ADT/hash.h"
 #include "expand.h"
 
 static LOGICAL found_rpct(int rpct_nme1, int rpct_nme2);
@@ -38,12 +39,109 @@ static LOGICAL found_rpct(int rpct_nme1, int rpct_nme2);
 #define asrt(c)
 #endif
 
-#define NMEHSZ 1217
 #define MAXNME 67108864
 
-static int nmehsh[NMEHSZ];
-static int ptehsh[NMEHSZ];
-static int rpcthsh[NMEHSZ];
+/* The NME, PTE and RPCT hash tables are sets of table indices, open
+ * addressed and growing with the tables (see flang/ADT/hash.h).  A search
+ * fills in the probe entry of a table and looks up the index PROBE.
+ */
+#define PROBE -2
+#define NMEP(k) \
+  (HKEY2INT(k) == PROBE ? &nme_probe : nmeb.stg_base + HKEY2INT(k))
+#define PTEP(k) \
+  (HKEY2INT(k) == PROBE ? &pte_probe : nmeb.pte.stg_base + HKEY2INT(k))
+#define RPCTP(k) \
+  (HKEY2INT(k) == PROBE ? &rpct_probe : nmeb.rpct.stg_base + HKEY2INT(k))
+
+static NME nme_probe;
+static PTE pte_probe;
+static RPCT rpct_probe;
+static hashset_t nmehsh, ptehsh, rpcthsh;
+
+static hash_value_t
+nme_hash(hash_key_t key)
+{
+  const NME *p = NMEP(key);
+  hash_accu_t hacc = HASH_ACCU_INIT;
+
+  HASH_ACCU_ADD(hacc, p->type);
+  HASH_ACCU_ADD(hacc, p->sym);
+  HASH_ACCU_ADD(hacc, p->nm);
+  HASH_ACCU_ADD(hacc, p->cnst);
+  HASH_ACCU_ADD(hacc, p->sub);
+  HASH_ACCU_ADD(hacc, p->pte);
+  HASH_ACCU_ADD(hacc, p->rpct_loop);
+  HASH_ACCU_FINISH(hacc);
+  return HASH_ACCU_VALUE(hacc);
+}
+
+static int
+nme_equals(hash_key_t a, hash_key_t b)
+{
+  const NME *p = NMEP(a), *q = NMEP(b);
+
+  return p->type == q->type && p->inlarr == q->inlarr && p->sym == q->sym &&
+         p->nm == q->nm && p->cnst == q->cnst && p->sub == q->sub &&
+         p->pte == q->pte && p->rpct_loop == q->rpct_loop;
+}
+
+static const hash_functions_t nme_hash_functions = {nme_hash, nme_equals};
+
+static hash_value_t
+pte_hash(hash_key_t key)
+{
+  const PTE *p = PTEP(key);
+  hash_accu_t hacc = HASH_ACCU_INIT;
+
+  HASH_ACCU_ADD(hacc, p->type);
+  HASH_ACCU_ADD(hacc, p->sym);
+  HASH_ACCU_ADD(hacc, p->val);
+  HASH_ACCU_ADD(hacc, p->next);
+  HASH_ACCU_FINISH(hacc);
+  return HASH_ACCU_VALUE(hacc);
+}
+
+static int
+pte_equals(hash_key_t a, hash_key_t b)
+{
+  const PTE *p = PTEP(a), *q = PTEP(b);
+
+  return p->type == q->type && p->sym == q->sym && p->val == q->val &&
+         p->next == q->next;
+}
+
+static const hash_functions_t pte_hash_functions = {pte_hash, pte_equals};
+
+static hash_value_t
+rpct_hash(hash_key_t key)
+{
+  const RPCT *p = RPCTP(key);
+  hash_accu_t hacc = HASH_ACCU_INIT;
+
+  HASH_ACCU_ADD(hacc, p->nme1);
+  HASH_ACCU_ADD(hacc, p->nme2);
+  HASH_ACCU_FINISH(hacc);
+  return HASH_ACCU_VALUE(hacc);
+}
+
+static int
+rpct_equals(hash_key_t a, hash_key_t b)
+{
+  const RPCT *p = RPCTP(a), *q = RPCTP(b);
+
+  return p->nme1 == q->nme1 && p->nme2 == q->nme2;
+}
+
+static const hash_functions_t rpct_hash_functions = {rpct_hash, rpct_equals};
+
+/* Return the index equal to the probe entry in hash set h, or 0. */
+static int
+find_probe(hashset_t h)
+{
+  hash_key_t key = hashset_lookup(h, INT2HKEY(PROBE));
+
+  return key ? HKEY2INT(key) : 0;
+}
 
 /** \brief Query whether the given nme is a PRE temp. */
 LOGICAL
@@ -65,9 +163,6 @@ is_presym(int nme)
 void
 nme_init(void)
 {
-  int i;
-  static int firstcall = 1;
-
   STG_ALLOC(nmeb, NME, 128);
   nmeb.stg_avail = 2; /* 0, NME_UNK; 1, NME_VOL */
   STG_CLEAR_ALL(nmeb);
@@ -77,14 +172,14 @@ nme_init(void)
   NME_TYPE(NME_VOL) = NT_UNK;
   NME_SYM(NME_VOL) = 1;
 
-  if (firstcall)
-    firstcall = 0;
-  else {
-    for (i = 0; i < NMEHSZ; i++) {
-      nmehsh[i] = 0;
-      ptehsh[i] = 0;
-      rpcthsh[i] = 0;
-    }
+  if (nmehsh) {
+    hashset_clear(nmehsh);
+    hashset_clear(ptehsh);
+    hashset_clear(rpcthsh);
+  } else {
+    nmehsh = hashset_alloc(nme_hash_functions);
+    ptehsh = hashset_alloc(pte_hash_functions);
+    rpcthsh = hashset_alloc(rpct_hash_functions);
   }
 
   STG_ALLOC(nmeb.pte, PTE, 128);
@@ -104,6 +199,13 @@ nme_end(void)
   STG_DELETE(nmeb.pte);
 
   STG_DELETE(nmeb.rpct);
+
+  if (nmehsh) {
+    hashset_free(nmehsh);
+    hashset_free(ptehsh);
+    hashset_free(rpcthsh);
+    nmehsh = ptehsh = rpcthsh = NULL;
+  }
 } /* nme_end */
 
 /*
@@ -169,7 +271,7 @@ find_parent_member(int nmex, DTYPE dt, int sym)
 int
 add_arrnme(NT_KIND type, SPTR insym, int nm, ISZ_T cnst, int sub, LOGICAL inlarr)
 {
-  int val, i;
+  int i;
   DTYPE nmdt;
   int sym;
 
@@ -321,18 +423,16 @@ add_arrnme(NT_KIND type, SPTR insym, int nm, ISZ_T cnst, int sub, LOGICAL inlarr
     return (NME_UNK);
   }
 
-  /* compute the hash index for this NME  */
-  val = (int)((type ^ sym ^ nm ^ sub) & 0x7fff) % NMEHSZ;
-
-  /* search the hash links for this NME  */
-  for (i = nmehsh[val]; i != 0; i = NME_HSHLNK(i))
-    if (NME_TYPE(i) == type && NME_INLARR(i) == inlarr && NME_SYM(i) == sym &&
-        NME_NM(i) == nm && NME_CNST(i) == cnst && NME_SUB(i) == sub &&
-#ifdef NME_PTE
-        NME_PTE(i) == 0 &&
-#endif
-        NME_RPCT_LOOP(i) == 0)
-      return (i); /* F O U N D  */
+  /* search the hash set for this NME  */
+  BZERO(&nme_probe, NME, 1);
+  nme_probe.type = type;
+  nme_probe.inlarr = inlarr;
+  nme_probe.sym = sym;
+  nme_probe.nm = nm;
+  nme_probe.cnst = cnst;
+  nme_probe.sub = sub;
+  if ((i = find_probe(nmehsh)) != 0)
+    return (i); /* F O U N D  */
 
   /*
    * N O T   F O U N D -- if no more storage is available, try to get more
@@ -342,7 +442,7 @@ add_arrnme(NT_KIND type, SPTR insym, int nm, ISZ_T cnst, int sub, LOGICAL inlarr
   if (i > MAXNME)
     error(7, 4, 0, CNULL, CNULL);
   /*
-   * NEW ENTRY - add the nme to the nme area and to its hash chain
+   * NEW ENTRY - add the nme to the nme area and to the hash set
    */
   if (EXPDBG(10, 256))
     fprintf(gbl.dbgfil,
@@ -354,31 +454,24 @@ add_arrnme(NT_KIND type, SPTR insym, int nm, ISZ_T cnst, int sub, LOGICAL inlarr
   NME_SYM(i) = sym;
   NME_NM(i) = nm;
   NME_CNST(i) = cnst;
-  NME_HSHLNK(i) = nmehsh[val];
   NME_SUB(i) = sub;
-  nmehsh[val] = i;
+  hashset_insert(nmehsh, INT2HKEY(i));
   return (i);
 }
 
 int
 lookupnme(NT_KIND type, int insym, int nm, ISZ_T cnst)
 {
-  int i, val, sub = 0, sym = insym;
-  LOGICAL inlarr = FALSE;
+  int sym = insym;
   if (insym < 0)
     sym = NME_NULL;
 
-  val = (int)((type ^ sym ^ nm ^ sub) & 0x7fff) % NMEHSZ;
-  for (i = nmehsh[val]; i != 0; i = NME_HSHLNK(i)) {
-    if (NME_TYPE(i) == type && NME_INLARR(i) == inlarr && NME_SYM(i) == sym &&
-        NME_NM(i) == nm && NME_CNST(i) == cnst && NME_SUB(i) == sub &&
-#ifdef NME_PTE
-        NME_PTE(i) == 0 &&
-#endif
-        NME_RPCT_LOOP(i) == 0)
-      return (i); /* F O U N D  */
-  }
-  return 0;
+  BZERO(&nme_probe, NME, 1);
+  nme_probe.type = type;
+  nme_probe.sym = sym;
+  nme_probe.nm = nm;
+  nme_probe.cnst = cnst;
+  return find_probe(nmehsh);
 } /* lookupnme */
 
 /** \brief Add a new nme based on this nme with a new PTE list; otherwise all
@@ -390,18 +483,12 @@ add_nme_with_pte(int nm, int ptex)
 #ifndef NME_PTE
   return nm;
 #else
-  int val, i;
-
-  val =
-      (int)((NME_TYPE(nm) ^ NME_SYM(nm) ^ NME_NM(nm) ^ NME_SYM(nm)) & 0x7fff) %
-      NMEHSZ;
-  for (i = nmehsh[val]; i > 0; i = NME_HSHLNK(i)) {
-    if (NME_TYPE(i) == NME_TYPE(nm) && NME_INLARR(i) == NME_INLARR(nm) &&
-        NME_SYM(i) == NME_SYM(nm) && NME_NM(i) == NME_NM(nm) &&
-        NME_CNST(i) == NME_CNST(nm) && NME_SUB(i) == NME_SUB(nm) &&
-        NME_RPCT_LOOP(i) == NME_RPCT_LOOP(nm) && NME_PTE(i) == ptex)
-      return (i); /* F O U N D  */
-  }
+  int i;
+
+  BCOPY(&nme_probe, nmeb.stg_base + nm, NME, 1);
+  nme_probe.pte = ptex;
+  if ((i = find_probe(nmehsh)) != 0)
+    return (i); /* F O U N D  */
   i = STG_NEXT(nmeb);
   if (i > MAXNME)
     error(7, 4, 0, CNULL, CNULL);
@@ -411,8 +498,7 @@ add_nme_with_pte(int nm, int ptex)
   BCOPY(nmeb.stg_base + i, nmeb.stg_base + nm, NME, 1);
   NME_BASE(i) = nm;
   NME_PTE(i) = ptex;
-  NME_HSHLNK(i) = nmehsh[val];
-  nmehsh[val] = i;
+  hashset_insert(nmehsh, INT2HKEY(i));
   return i;
 #endif
 } /* add_nme_with_pte */
@@ -434,44 +520,25 @@ add_nme_with_pte(int nm, int ptex)
 int
 add_rpct_nme(int orig_nme, int rpct_loop)
 {
-  int hashval, rpct_nme;
+  int rpct_nme;
 
   asrt(NME_RPCT_LOOP(orig_nme) == 0 && rpct_loop > 0);
 
-  /* Compute the hash index for 'orig_nme' and 'rpct_nme' (they both
-   * have the same hash index).
-   */
-  hashval = (int)((NME_TYPE(orig_nme) ^ NME_SYM(orig_nme) ^ NME_NM(orig_nme) ^
-                   NME_SUB(orig_nme)) &
-                  0x7fff) %
-            NMEHSZ;
-
 #if DEBUG
-  /* Search the nme hash links for this NME.  If it already exists
+  /* Search the nme hash set for this NME.  If it already exists
    * we return it and generate an 'asrt()' error message, since this
    * shouldn't happen.
    */
-  for (rpct_nme = nmehsh[hashval]; rpct_nme; rpct_nme = NME_HSHLNK(rpct_nme)) {
-    if (NME_TYPE(rpct_nme) == NME_TYPE(orig_nme) &&
-        NME_INLARR(rpct_nme) == NME_INLARR(orig_nme) &&
-        NME_SYM(rpct_nme) == NME_SYM(orig_nme) &&
-        NME_NM(rpct_nme) == NME_NM(orig_nme) &&
-        NME_CNST(rpct_nme) == NME_CNST(orig_nme) &&
-        NME_SUB(rpct_nme) == NME_SUB(orig_nme) &&
-#ifdef NME_PTE
-        NME_PTE(rpct_nme) == NME_PTE(orig_nme) &&
-#endif
-        NME_RPCT_LOOP(rpct_nme) == rpct_loop) {
-      /* Found.
-       */
-      asrt(FALSE); /* we don't expect it to be found! */
-      return rpct_nme;
-    }
+  BCOPY(&nme_probe, nmeb.stg_base + orig_nme, NME, 1);
+  nme_probe.rpct_loop = rpct_loop;
+  if ((rpct_nme = find_probe(nmehsh)) != 0) {
+    asrt(FALSE); /* we don't expect it to be found! */
+    return rpct_nme;
   }
 #endif
 
-  /* Not found, so create and initialise a new nme, and link it info
-   * its hash chain.  If necessary get more storage.
+  /* Not found, so create and initialise a new nme, and add it to
+   * the hash set.  If necessary get more storage.
    */
   rpct_nme = STG_NEXT(nmeb);
 
@@ -486,8 +553,7 @@ add_rpct_nme(int orig_nme, int rpct_loop)
   BCOPY(nmeb.stg_base + rpct_nme, nmeb.stg_base + orig_nme, NME, 1);
 
   NME_RPCT_LOOP(rpct_nme) = rpct_loop;
-  NME_HSHLNK(rpct_nme) = nmehsh[hashval];
-  nmehsh[hashval] = rpct_nme;
+  hashset_insert(nmehsh, INT2HKEY(rpct_nme));
 
   return rpct_nme;
 
@@ -773,21 +839,20 @@ found:
 int
 addpte(int type, SPTR sptr, int val, int next)
 {
-  int hshval, p;
-  hshval = (int)((type ^ sptr ^ val ^ next) & 0x7fff) % NMEHSZ;
-  for (p = ptehsh[hshval]; p > 0; p = PTE_HSHLNK(p)) {
-    if (PTE_TYPE(p) == type && PTE_SPTR(p) == sptr && PTE_VAL(p) == val &&
-        PTE_NEXT(p) == next) {
-      return p;
-    }
-  }
+  int p;
+
+  pte_probe.type = type;
+  pte_probe.sym = sptr;
+  pte_probe.val = val;
+  pte_probe.next = next;
+  if ((p = find_probe(ptehsh)) != 0)
+    return p;
   p = STG_NEXT(nmeb.pte);
   PTE_TYPE(p) = type;
   PTE_SPTR(p) = sptr;
   PTE_VAL(p) = val;
   PTE_NEXT(p) = next;
-  PTE_HSHLNK(p) = ptehsh[hshval];
-  ptehsh[hshval] = p;
+  hashset_insert(ptehsh, INT2HKEY(p));
   return p;
 } /* addpte */
 
@@ -805,7 +870,7 @@ addpte(int type, SPTR sptr, int val, int next)
 void
 add_rpct(int rpct_nme1, int rpct_nme2)
 {
-  int hashval, rpct;
+  int rpct;
 
   asrt(rpct_nme1 != rpct_nme2 && NME_RPCT_LOOP(rpct_nme1) &&
        NME_RPCT_LOOP(rpct_nme2) == NME_RPCT_LOOP(rpct_nme1));
@@ -822,31 +887,24 @@ add_rpct(int rpct_nme1, int rpct_nme2)
     rpct_nme2 = tmp;
   }
 
-  /* Compute the hash index for this RPCT record.
-   */
-  hashval = (int)((rpct_nme1 ^ rpct_nme2) & 0x7fff) % NMEHSZ;
-
 #if DEBUG
-  /* Search the RPCT hash links for this RPCT.  If it already exists
+  /* Search the RPCT hash set for this RPCT.  If it already exists
    * we generate an 'asrt()' error message, since this shouldn't happen.
    */
-  for (rpct = rpcthsh[hashval]; rpct; rpct = RPCT_HSHLNK(rpct)) {
-    if (RPCT_NME1(rpct) == rpct_nme1 && RPCT_NME2(rpct) == rpct_nme2) {
-      /* Found.
-       */
-      asrt(FALSE); /* we don't expect it to be found! */
-      return;
-    }
+  rpct_probe.nme1 = rpct_nme1;
+  rpct_probe.nme2 = rpct_nme2;
+  if (find_probe(rpcthsh)) {
+    asrt(FALSE); /* we don't expect it to be found! */
+    return;
   }
 #endif
 
-  /* Create and initialise a new RPCT record and link it into its hash chain.
+  /* Create and initialise a new RPCT record and add it to the hash set.
    */
   rpct = STG_NEXT(nmeb.rpct);
   RPCT_NME1(rpct) = rpct_nme1;
   RPCT_NME2(rpct) = rpct_nme2;
-  RPCT_HSHLNK(rpct) = rpcthsh[hashval];
-  rpcthsh[hashval] = rpct;
+  hashset_insert(rpcthsh, INT2HKEY(rpct));
 
 } /* end add_rpct( int rpct_nme1, int rpct_nme2 ) */
 
@@ -860,8 +918,6 @@ add_rpct(int rpct_nme1, int rpct_nme2)
 static LOGICAL
 found_rpct(int rpct_nme1, int rpct_nme2)
 {
-  int hashval, rpct;
-
   asrt(rpct_nme1 != rpct_nme2 && NME_RPCT_LOOP(rpct_nme1) &&
        NME_RPCT_LOOP(rpct_nme2) == NME_RPCT_LOOP(rpct_nme1));
 
@@ -876,19 +932,11 @@ found_rpct(int rpct_nme1, int rpct_nme2)
     rpct_nme2 = tmp;
   }
 
-  /* Compute the hash index for this RPCT record.
+  /* Search the RPCT hash set for this RPCT.
    */
-  hashval = (int)((rpct_nme1 ^ rpct_nme2) & 0x7fff) % NMEHSZ;
-
-  /* Search the RPCT hash links for this RPCT.
-   */
-  for (rpct = rpcthsh[hashval]; rpct; rpct = RPCT_HSHLNK(rpct)) {
-    if (RPCT_NME1(rpct) == rpct_nme1 && RPCT_NME2(rpct) == rpct_nme2) {
-      return TRUE; /* found */
-    }
-  }
-
-  return FALSE; /* not found */
+  rpct_probe.nme1 = rpct_nme1;
+  rpct_probe.nme2 = rpct_nme2;
+  return find_probe(rpcthsh) != 0;
 
 } /* end found_rpct( int rpct_nme1, int rpct_nme2 ) */
 
@@ -986,8 +1034,8 @@ __dmpnme(FILE *f, int i, int flag)
   if (!flag)
     fprintf(ff, "%5u   ", i);
   else
-    fprintf(ff, "%5u   rfptr %d sub %d hshlk %d f6 %d inlarr %d\n\t", i,
-            NME_RFPTR(i), NME_SUB(i), NME_HSHLNK(i), NME_DEF(i), NME_INLARR(i));
+    fprintf(ff, "%5u   rfptr %d sub %d f6 %d inlarr %d\n\t", i, NME_RFPTR(i),
+            NME_SUB(i), NME_DEF(i), NME_INLARR(i));
   switch (NME_TYPE(i)) {
   case NT_VAR:
     j = NME_SYM(i);
@@ -1050,7 +1098,7 @@ __dmpnme(FILE *f, int i, int flag)
 void
 dmpnmeall(int flag)
 {
-  int i, j;
+  int i;
   int tmp;
 
   fprintf(gbl.dbgfil, "\n\n***** NME Area Dump *****\n\n");
@@ -1059,21 +1107,18 @@ dmpnmeall(int flag)
   }
 
   if ((flg.dbg[10] & 8) != 0) {
-    fprintf(gbl.dbgfil, "\n\n***** NME Hash Table *****\n");
-    for (i = 0; i < NMEHSZ; i++)
-      if ((j = nmehsh[i]) != 0) {
+    fprintf(gbl.dbgfil, "\n\n***** NME Hash Set, %u entries *****\n",
+            hashset_size(nmehsh));
+    tmp = 0;
+    for (i = 2; i < nmeb.stg_avail; i++) {
+      fprintf(gbl.dbgfil, " %5d:%08x", i, nme_hash(INT2HKEY(i)));
+      if ((++tmp) == 6) {
         tmp = 0;
-        fprintf(gbl.dbgfil, "%3d.", i);
-        for (; j != 0; j = NME_HSHLNK(j)) {
-          fprintf(gbl.dbgfil, " %5u^", j);
-          if ((++tmp) == 6) {
-            tmp = 0;
-            fprintf(gbl.dbgfil, "\n    ");
-          }
-        }
-        if (tmp != 0)
-          fprintf(gbl.dbgfil, "    \n");
+        fprintf(gbl.dbgfil, "\n");
       }
+    }
+    if (tmp != 0)
+      fprintf(gbl.dbgfil, "\n");
   }
 }
 
@@ -1212,44 +1257,11 @@ __dumpnme(FILE *f, int opn)
 void
 PrintTopNMEHash(void)
 {
-  int h, s, t, nmex;
-  int topten[TOP], toptensize[TOP];
-  if (nmeb.stg_base == NULL)
+  if (nmeb.stg_base == NULL || nmehsh == NULL)
     return;
-  for (s = 0; s < TOP; ++s) {
-    topten[s] = 0;
-    toptensize[s] = 0;
-  }
-  for (h = 0; h < NMEHSZ; ++h) {
-    s = 0;
-    for (nmex = nmehsh[h]; nmex > 0; nmex = NME_HSHLNK(nmex))
-      ++s;
-    if (s) {
-      for (t = 0; t < TOP; ++t) {
-        if (s == toptensize[t]) {
-          ++topten[t];
-          break;
-        } else if (s > toptensize[t]) {
-          /* move the others */
-          int tt;
-          for (tt = TOP - 1; tt > t; --tt) {
-            toptensize[tt] = toptensize[tt - 1];
-            topten[tt] = topten[tt - 1];
-          }
-          toptensize[t] = s;
-          topten[t] = 1;
-          break;
-        }
-      }
-    }
-  }
-  fprintf(gbl.dbgfil, "Function %d = %s\nTop %d NME Hash Table Entries\n %d "
-                      "NME entries, Hash Size %d, Average Length %d\n",
-          gbl.func_count, GBL_CURRFUNC ? SYMNAME(GBL_CURRFUNC) : "", TOP,
-          nmeb.stg_avail - 1, NMEHSZ, (nmeb.stg_avail - 1 + NMEHSZ) / NMEHSZ);
-  for (s = 0; s < TOP; ++s) {
-    fprintf(gbl.dbgfil, " [%2d] %d * %d\n", s + 1, toptensize[s], topten[s]);
-  }
+  fprintf(gbl.dbgfil, "Function %d = %s\n %d NME entries, %u in the hash set\n",
+          gbl.func_count, GBL_CURRFUNC ? SYMNAME(GBL_CURRFUNC) : "",
+          nmeb.stg_avail - 1, hashset_size(nmehsh));
 } /* PrintTopNMEHash */
 
 void
@@ -1261,7 +1273,7 @@ PrintTopHash(void)
     topten[s] = 0;
     toptensize[s] = 0;
   }
-  for (h = 0; h < HASHSIZE + 1; ++h) {
+  for (h = 0; h < stb.hashsz; ++h) {
     s = 0;
     for (sptr = stb.hashtb[h]; sptr > NOSYM; sptr = HASHLKG(sptr))
       ++s;
@@ -1287,7 +1299,8 @@ PrintTopHash(void)
   fprintf(gbl.dbgfil, "Function %d = %s\nTop %d Symbol Hash Table Entries\n %d "
                       "symbols, Hash Size %d, Average length %d:\n",
           gbl.func_count, GBL_CURRFUNC ? SYMNAME(GBL_CURRFUNC) : "", TOP,
-          stb.symavl - 1, HASHSIZE + 1, (stb.symavl - 1 + HASHSIZE) / HASHSIZE);
+          stb.symavl - 1, stb.hashsz,
+          (stb.symavl - 1 + stb.hashsz) / stb.hashsz);
   for (s = 0; s < TOP; ++s) {
     fprintf(gbl.dbgfil, " [%2d] %d * %d\n", s + 1, toptensize[s], topten[s]);
   }
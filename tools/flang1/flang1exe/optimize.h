@@ -129,7 +129,10 @@ typedef struct PSI_TAG {
 
 #define BITS_PER_BYTE 8
 
-typedef int BV;
+/* A set is a sequence of 64-bit units, so that the set operations go a
+ * machine word at a time.
+ */
+typedef BIGUINT64 BV;
 typedef struct {
   BV *stg_base;
   int stg_avail;
@@ -761,6 +764,7 @@ void flow_end(void);
 int update_stl(int, int);
 LOGICAL is_live_in(int, int);
 LOGICAL is_live_out(int, int);
+LOGICAL is_initialized(BV *, int);
 void delete_stores(void);
 void use_before_def(void);
 void add_new_uses(int, int, int, int);
@@ -783,15 +787,15 @@ void compute_last_values(int, int);
 void end_loop_count(void);
 
 /*****  optutil.c *****/
-void bv_zero(int *, int);
-void bv_copy(int *, int *, int);
-void bv_union(int *, int *, int);
-void bv_sub(int *, int *, int);
-void bv_set(int *, int);
-void bv_off(int *, int);
-LOGICAL bv_notequal(int *, int *, int);
-LOGICAL bv_mem(int *, int);
-void bv_print(int *, int);
+void bv_zero(BV *, int);
+void bv_copy(BV *, BV *, int);
+void bv_union(BV *, BV *, int);
+void bv_sub(BV *, BV *, int);
+void bv_set(BV *, int);
+void bv_off(BV *, int);
+LOGICAL bv_notequal(BV *, BV *, int);
+LOGICAL bv_mem(BV *, int);
+void bv_print(BV *, int);
 int get_otemp(void);
 LOGICAL is_optsym(int);
 LOGICAL is_sym_optsafe(int, int);
@@ -86,7 +86,8 @@ int basesym_of(int);
       w = (i-1) / #bits in a BV unit
       r = (i-1) % #bits in a BV unit
    then the rth bit in the wth BV unit represents the set membership
-   for i.
+   for i.  The routines operating on whole sets are simple loops over
+   the BV units, which the compiler can unroll or vectorize.
 
    Bit vector support routines:
       bv_zero   -  a = 0
@@ -148,7 +149,7 @@ bv_set(BV *a, int elem)
 
   w = (elem - 1) / BV_BITS;
   r = (elem - 1) - w * BV_BITS;
-  *(a + w) |= 1 << r;
+  *(a + w) |= (BV)1 << r;
 }
 
 void
@@ -158,7 +159,7 @@ bv_off(BV *a, int elem)
 
   w = (elem - 1) / BV_BITS;
   r = (elem - 1) - w * BV_BITS;
-  *(a + w) &= (BV) ~(1 << r);
+  *(a + w) &= ~((BV)1 << r);
 }
 
 LOGICAL
@@ -180,7 +181,7 @@ bv_mem(BV *a, int elem)
 #endif
   w = (elem - 1) / BV_BITS;
   r = (elem - 1) - w * BV_BITS;
-  if (*(a + w) & (BV)(1 << r))
+  if (*(a + w) & ((BV)1 << r))
     return (TRUE);
   return (FALSE);
 }
@@ -188,7 +189,8 @@ bv_mem(BV *a, int elem)
 void
 bv_print(BV *bv, int maxlen)
 {
-  int i, j, w;
+  int i, j;
+  BV w;
 
   j = 0;
   w = *bv++;
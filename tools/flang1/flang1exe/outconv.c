@@ -3392,6 +3392,7 @@ conv_forall(int std)
   int lhs_sptr, lhs_ast;
   int doifstmt, ifexpr, zero;
   int stride, tmp_ifexpr;
+  int innerstd;
 
   stdnext = STD_NEXT(std);
   if (no_effect_forall(std))
@@ -3518,6 +3519,7 @@ conv_forall(int std)
   triplet_list = A_LISTG(forall);
 
   cnt = 0;
+  innerstd = 0;
   for (; triplet_list; triplet_list = ASTLI_NEXT(triplet_list)) {
     int dovar, tstd;
     ldim = 0;
@@ -3557,9 +3559,13 @@ conv_forall(int std)
     if (doifstmt && !XBIT(34, 0x8000000)) {
       STD_ZTRIP(tstd) = 1;
     }
+    innerstd = tstd;
 
     cnt++;
   }
+  /* innermost loop of an array assignment; see vect_array_loops() */
+  if (innerstd && A_ARRASNG(forall) && flg.opt >= 2 && !XBIT(224, 0x1))
+    STD_VECT(innerstd) = 1;
 
   add_mask_calls(cnt, forall, stdnext);
 
@@ -6195,3 +6201,436 @@ sectfloat(void)
   optshrd_end();
   flg.x[6] = savex; /* disable flow graph changes here */
 } /* sectfloat */
+
+/* ------------------------------------------------------------------ */
+/*   Short vector array assignment loops                              */
+/* ------------------------------------------------------------------ */
+
+#define VECT_BYTES 32      /* bytes in a short vector */
+#define VECT_MATH_BYTES 16 /* ... when calling the vector math library */
+#define VECT_MAXARR 32     /* array references tracked per loop */
+
+static struct {
+  int dovar;    /* A_ID of the DO variable */
+  int ty;       /* TY_REAL or TY_DBLE, the type of every assignment */
+  LOGICAL math; /* calls a vector math library routine */
+  LOGICAL gain; /* has a mask or an intrinsic call */
+  int narr;
+  struct {
+    int sptr;
+    int ast; /* A_SUBSCR */
+    LOGICAL written;
+  } arr[VECT_MAXARR];
+} vect;
+
+static LOGICAL vect_expr(int ast);
+
+/* record an array element reference; the array must not be aliased */
+static LOGICAL
+vect_array(int ast, LOGICAL written)
+{
+  int lop = A_LOPG(ast);
+  int sptr;
+
+  if (A_TYPEG(lop) != A_ID)
+    return FALSE;
+  sptr = A_SPTRG(lop);
+  if (STYPEG(sptr) != ST_ARRAY || POINTERG(sptr) || SOCPTRG(sptr) ||
+      VOLG(sptr) || (ASSUMSHPG(sptr) && !CONTIGATTRG(sptr)) ||
+      (MIDNUMG(sptr) && !ALLOCATTRG(sptr)))
+    return FALSE;
+  if (vect.narr >= VECT_MAXARR)
+    return FALSE;
+  vect.arr[vect.narr].sptr = sptr;
+  vect.arr[vect.narr].ast = ast;
+  vect.arr[vect.narr].written = written;
+  ++vect.narr;
+  return TRUE;
+}
+
+/* scalar expression that does not change in the loop */
+static LOGICAL
+vect_invar(int ast)
+{
+  int sptr, asd, i;
+
+  switch (A_TYPEG(ast)) {
+  case A_CNST:
+    return TRUE;
+  case A_ID:
+    sptr = A_SPTRG(ast);
+    return ast != vect.dovar && STYPEG(sptr) == ST_VAR && !VOLG(sptr) &&
+           !POINTERG(sptr) && DT_ISNUMERIC(DTYPEG(sptr));
+  case A_PAREN:
+  case A_CONV:
+    return vect_invar(A_LOPG(ast));
+  case A_UNOP:
+    if (A_OPTYPEG(ast) != OP_NEG && A_OPTYPEG(ast) != OP_ADD)
+      return FALSE;
+    return vect_invar(A_LOPG(ast));
+  case A_BINOP:
+    switch (A_OPTYPEG(ast)) {
+    case OP_ADD:
+    case OP_SUB:
+    case OP_MUL:
+    case OP_DIV:
+    case OP_XTOI:
+    case OP_XTOX:
+      return vect_invar(A_LOPG(ast)) && vect_invar(A_ROPG(ast));
+    }
+    return FALSE;
+  case A_SUBSCR:
+    asd = A_ASDG(ast);
+    for (i = 0; i < ASD_NDIM(asd); ++i) {
+      if (!vect_invar(ASD_SUBS(asd, i)))
+        return FALSE;
+    }
+    return vect_array(ast, FALSE);
+  }
+  return FALSE;
+}
+
+/* element reference whose first subscript is the DO variable +/- constant */
+static LOGICAL
+vect_subscr(int ast, LOGICAL written)
+{
+  int asd = A_ASDG(ast);
+  int sub = ASD_SUBS(asd, 0);
+  int i;
+
+  if (sub != vect.dovar) {
+    if (A_TYPEG(sub) != A_BINOP ||
+        (A_OPTYPEG(sub) != OP_ADD && A_OPTYPEG(sub) != OP_SUB))
+      return FALSE;
+    if (!(A_LOPG(sub) == vect.dovar && A_TYPEG(A_ROPG(sub)) == A_CNST) &&
+        !(A_OPTYPEG(sub) == OP_ADD && A_ROPG(sub) == vect.dovar &&
+          A_TYPEG(A_LOPG(sub)) == A_CNST))
+      return FALSE;
+  }
+  for (i = 1; i < ASD_NDIM(asd); ++i) {
+    if (!vect_invar(ASD_SUBS(asd, i)))
+      return FALSE;
+  }
+  return vect_array(ast, written);
+}
+
+static LOGICAL
+vect_mask(int ast)
+{
+  switch (A_TYPEG(ast)) {
+  case A_PAREN:
+    return vect_mask(A_LOPG(ast));
+  case A_BINOP:
+    switch (A_OPTYPEG(ast)) {
+    case OP_EQ:
+    case OP_NE:
+    case OP_LT:
+    case OP_GE:
+    case OP_LE:
+    case OP_GT:
+      return vect_expr(A_LOPG(ast)) && vect_expr(A_ROPG(ast));
+    }
+  }
+  return FALSE;
+}
+
+static LOGICAL
+vect_expr(int ast)
+{
+  int argt, rop;
+
+  if (DTY(A_DTYPEG(ast)) != vect.ty)
+    return FALSE;
+  if (!contains_ast(ast, vect.dovar))
+    return vect_invar(ast);
+  switch (A_TYPEG(ast)) {
+  case A_SUBSCR:
+    return vect_subscr(ast, FALSE);
+  case A_PAREN:
+    return vect_expr(A_LOPG(ast));
+  case A_UNOP:
+    if (A_OPTYPEG(ast) != OP_NEG && A_OPTYPEG(ast) != OP_ADD)
+      return FALSE;
+    return vect_expr(A_LOPG(ast));
+  case A_BINOP:
+    switch (A_OPTYPEG(ast)) {
+    case OP_ADD:
+    case OP_SUB:
+    case OP_MUL:
+    case OP_DIV:
+      return vect_expr(A_LOPG(ast)) && vect_expr(A_ROPG(ast));
+    case OP_XTOI:
+    case OP_XTOX:
+      /* as in the scalar lowering, the exponent type decides */
+      rop = A_ROPG(ast);
+      if (DTY(A_DTYPEG(rop)) == vect.ty) {
+        vect.math = vect.gain = TRUE;
+        return vect_expr(A_LOPG(ast)) && vect_expr(rop);
+      }
+      /* small constant integer powers become multiplies */
+      rop = A_ALIASG(rop);
+      if (!rop || DTY(A_DTYPEG(rop)) != TY_INT || flg.ieee ||
+          XBIT(124, 0x200) || CONVAL2G(A_SPTRG(rop)) < 1 ||
+          CONVAL2G(A_SPTRG(rop)) > 4)
+        return FALSE;
+      return vect_expr(A_LOPG(ast));
+    }
+    return FALSE;
+  case A_INTR:
+    argt = A_ARGSG(ast);
+    switch (A_OPTYPEG(ast)) {
+    case I_EXP:
+    case I_DEXP:
+    case I_LOG:
+    case I_ALOG:
+    case I_DLOG:
+    case I_SIN:
+    case I_DSIN:
+    case I_COS:
+    case I_DCOS:
+    case I_TANH:
+    case I_DTANH:
+      vect.math = TRUE;
+      /* fall through */
+    case I_SQRT:
+    case I_DSQRT:
+      vect.gain = TRUE;
+      /* fall through */
+    case I_ABS:
+    case I_DABS:
+      return A_ARGCNTG(ast) == 1 && vect_expr(ARGT_ARG(argt, 0));
+    case I_MAX:
+    case I_AMAX1:
+    case I_DMAX1:
+    case I_MIN:
+    case I_AMIN1:
+    case I_DMIN1:
+      return A_ARGCNTG(ast) == 2 && vect_expr(ARGT_ARG(argt, 0)) &&
+             vect_expr(ARGT_ARG(argt, 1));
+    case I_MERGE:
+      /* like the scalar lowering, ignore any argument after the mask */
+      return A_ARGCNTG(ast) >= 3 && vect_expr(ARGT_ARG(argt, 0)) &&
+             vect_expr(ARGT_ARG(argt, 1)) && vect_mask(ARGT_ARG(argt, 2));
+    }
+    return FALSE;
+  }
+  return FALSE;
+}
+
+/*
+ * Are the vector stores of the loop at std to be non-temporal (see
+ * stream_store() in flang2)?  flang2 streams only vector stores, so such a
+ * loop is worth lowering to FV ILMs even when LLVM would vectorize it.
+ */
+static LOGICAL
+vect_stream(int std)
+{
+  LOGICAL stream = FALSE;
+  ISZ_T minsz;
+  int i, dtype, numelm;
+
+  open_pragma(STD_LINENO(std));
+  if (XBIT(19, 0x40)) {
+    /* nostream */
+  } else if (XBIT(226, 0x1)) {
+    stream = TRUE;
+  } else if (XBIT(226, 0x2)) {
+    minsz = flg.x[227] > 0 ? (ISZ_T)flg.x[227] << 10 : (ISZ_T)16 << 20;
+    for (i = 0; i < vect.narr && !stream; ++i) {
+      if (!vect.arr[i].written)
+        continue;
+      dtype = DTYPEG(vect.arr[i].sptr);
+      numelm = ADD_NUMELM(dtype);
+      if (numelm && A_TYPEG(numelm) == A_CNST &&
+          get_isz_cval(A_SPTRG(numelm)) * size_of(DDTG(dtype)) >= minsz)
+        stream = TRUE;
+    }
+  }
+  close_pragma();
+  return stream;
+}
+
+/*
+ * Return the ENDDO of the DO at std if its body can be lowered to FV ILMs:
+ * stride one assignments of a single REAL type, optionally under one
+ * IF-THEN whose condition is a comparison.  An array that is assigned may
+ * only be referenced with the subscript of the assignment, so that each
+ * vector element depends only on the same element of the arrays.
+ */
+static int
+vect_loop(int std)
+{
+  int ast = STD_AST(std);
+  int mask = 0;
+  int nasn = 0;
+  int s, a, dest, i, j;
+
+  vect.dovar = A_DOVARG(ast);
+  vect.ty = 0;
+  vect.math = FALSE;
+  vect.gain = FALSE;
+  vect.narr = 0;
+  if (A_TYPEG(vect.dovar) != A_ID || !DT_ISINT(A_DTYPEG(vect.dovar)))
+    return 0;
+  if (A_M3G(ast) && A_M3G(ast) != astb.i1 && A_M3G(ast) != astb.bnd.one)
+    return 0;
+  if (STD_ACCEL(std) || STD_KERNEL(std) || contains_call(A_M2G(ast)))
+    return 0;
+
+  for (s = STD_NEXT(std); s; s = STD_NEXT(s)) {
+    a = STD_AST(s);
+    if (A_TYPEG(a) == A_ASN) {
+      vect.ty = DTY(A_DTYPEG(A_DESTG(a)));
+      break;
+    }
+    if (A_TYPEG(a) == A_ENDDO)
+      break;
+  }
+  if (vect.ty != TY_REAL && vect.ty != TY_DBLE)
+    return 0;
+
+  for (s = STD_NEXT(std); s; s = STD_NEXT(s)) {
+    if (STD_LABEL(s))
+      return 0;
+    a = STD_AST(s);
+    switch (A_TYPEG(a)) {
+    case A_CONTINUE:
+    case A_COMMENT:
+      break;
+    case A_IFTHEN:
+      /* masked off elements are computed too; not with FP traps */
+      if (mask || XBIT(24, 0x1f9) || !vect_mask(A_IFEXPRG(a)))
+        return 0;
+      mask = A_IFEXPRG(a);
+      vect.gain = TRUE;
+      break;
+    case A_ENDIF:
+      if (!mask)
+        return 0;
+      mask = 0;
+      break;
+    case A_ASN:
+      dest = A_DESTG(a);
+      if (A_TYPEG(dest) != A_SUBSCR || DTY(A_DTYPEG(dest)) != vect.ty ||
+          !vect_subscr(dest, TRUE) || !vect_expr(A_SRCG(a)))
+        return 0;
+      ++nasn;
+      break;
+    case A_ENDDO:
+      /* LLVM vectorizes plain arithmetic loops at least as well */
+      if (mask || !nasn ||
+          (!vect.gain && !XBIT(224, 0x2) && !vect_stream(std)))
+        return 0;
+      for (i = 0; i < vect.narr; ++i) {
+        if (!vect.arr[i].written)
+          continue;
+        for (j = 0; j < vect.narr; ++j) {
+          if (vect.arr[j].sptr == vect.arr[i].sptr &&
+              vect.arr[j].ast != vect.arr[i].ast)
+            return 0;
+        }
+      }
+      return s;
+    default:
+      return 0;
+    }
+  }
+  return 0;
+}
+
+/* add a copy of statement ast before std, with the attributes of stdfrom */
+static int
+vect_copy_stmt(int ast, int std, int stdfrom)
+{
+  int newstd = add_stmt_before(ast, std);
+
+  STD_LINENO(newstd) = STD_LINENO(stdfrom);
+  STD_FINDEX(newstd) = STD_FINDEX(stdfrom);
+  STD_FLAGS(newstd) = STD_FLAGS(stdfrom);
+  return newstd;
+}
+
+/*
+ * Split the loop into a vector loop that covers as many whole vectors as
+ * fit, and the original loop, which finishes the remaining elements:
+ *   do i = lb, ub - (n-1), n     ! STD_VECT, lowered to FV ILMs
+ *     ...
+ *   enddo
+ *   do i = i, ub
+ *     ...
+ *   enddo
+ */
+static void
+vect_split(int std, int stdend)
+{
+  int ast = STD_AST(std);
+  int ub = A_M2G(ast);
+  int dtype = A_DTYPEG(ub);
+  int nelem = (vect.math ? VECT_MATH_BYTES : VECT_BYTES) /
+              (vect.ty == TY_DBLE ? 8 : 4);
+  int newast, newstd, newend, s, a;
+
+  newast = mk_stmt(A_DO, 0);
+  A_DOVARP(newast, vect.dovar);
+  A_M1P(newast, A_M1G(ast));
+  A_M2P(newast, mk_binop(OP_SUB, ub, mk_isz_cval(nelem - 1, dtype), dtype));
+  A_M3P(newast, mk_isz_cval(nelem, dtype));
+  newstd = vect_copy_stmt(newast, std, std);
+  for (s = STD_NEXT(std); s != stdend; s = STD_NEXT(s)) {
+    a = STD_AST(s);
+    switch (A_TYPEG(a)) {
+    case A_ASN:
+      newast = mk_assn_stmt(A_DESTG(a), A_SRCG(a), A_DTYPEG(a));
+      break;
+    case A_IFTHEN:
+      newast = mk_stmt(A_IFTHEN, 0);
+      A_IFEXPRP(newast, A_IFEXPRG(a));
+      break;
+    case A_ENDIF:
+      newast = mk_stmt(A_ENDIF, 0);
+      break;
+    default:
+      continue;
+    }
+    vect_copy_stmt(newast, std, s);
+  }
+  newend = vect_copy_stmt(mk_stmt(A_ENDDO, 0), std, stdend);
+
+  /* either loop may now have no iterations where the original had some,
+   * so neither can skip the zero-trip test (DOBEGNZ) */
+  A_M1P(ast, vect.dovar);
+  A_M4P(ast, 0);
+  STD_VECT(std) = 0;
+  STD_ZTRIP(std) = STD_ZTRIP(stdend) = 0;
+  STD_ZTRIP(newstd) = STD_ZTRIP(newend) = 0;
+  ccff_info(MSGVECT, "VEC001", gbl.findex, STD_LINENO(std),
+            "Array assignment vectorized, %width elements per vector",
+            "width=%d", nelem, NULL);
+}
+
+/** \brief Vectorize the innermost loops of array assignments.
+ *
+ * conv_forall() sets STD_VECT on the innermost DO of each array assignment
+ * and WHERE; keep it only on loops that vect_loop() accepts, after
+ * splitting off their remainder.  lower_stmt() then lowers the body of a
+ * STD_VECT loop to FV ILMs, a whole short vector at a time.
+ */
+void
+vect_array_loops(void)
+{
+  int std, stdnext, stdend;
+
+  for (std = STD_FIRST; std; std = stdnext) {
+    stdnext = STD_NEXT(std);
+    if (!STD_VECT(std))
+      continue;
+    STD_VECT(std) = 0;
+    if (A_TYPEG(STD_AST(std)) != A_DO)
+      continue;
+    stdend = vect_loop(std);
+    if (stdend) {
+      STD_VECT(std) = 1;
+      vect_split(std, stdend);
+    }
+  }
+}
@@ -490,9 +490,9 @@ static struct c table[] = {
     {"smallvect", SW_SMALLVECT, TRUE, S_LOOP, S_LOOP | S_ROUTINE | S_GLOBAL},
     {"split", SW_SPLIT, TRUE, S_LOOP, S_LOOP | S_ROUTINE | S_GLOBAL},
     {"sse", SW_SSE, TRUE, S_LOOP, S_LOOP | S_ROUTINE | S_GLOBAL},
-    {"suj", SW_SUJ, TRUE, S_LOOP, S_LOOP | S_ROUTINE | S_GLOBAL},
     {"stream", SW_STREAM, TRUE, S_LOOP, S_LOOP | S_ROUTINE | S_GLOBAL},
     {"stripsize", SW_STRIPSZ, TRUE, S_LOOP, S_LOOP | S_ROUTINE | S_GLOBAL},
+    {"suj", SW_SUJ, TRUE, S_LOOP, S_LOOP | S_ROUTINE | S_GLOBAL},
     {"swpipe", SW_SWPIPE, TRUE, S_LOOP, S_LOOP | S_ROUTINE | S_GLOBAL},
     {"tp", SW_TP, FALSE, S_ROUTINE, S_ROUTINE | S_GLOBAL},
     {"transform", SW_TRANSFORM, TRUE, S_LOOP, S_LOOP | S_ROUTINE | S_GLOBAL},
@@ -641,16 +641,23 @@ do_sw(void)
     break;
 
   case SW_STREAM:
-    if (no_specified)
+    /* stream also asks for non-temporal vector stores */
+    if (no_specified) {
       bset(DIR_OFFSET(currdir, x[19]), 0x40);
-    else
+      bclr(DIR_OFFSET(currdir, x[226]), 0x1);
+    } else {
       bclr(DIR_OFFSET(currdir, x[19]), 0x40);
+      bset(DIR_OFFSET(currdir, x[226]), 0x1);
+    }
     break;
   case SW_VECTOR:
-    if (no_specified)
+    if (no_specified) {
       bset(DIR_OFFSET(currdir, x[19]), 0x18); /* notransform | norecog */
-    else
+      bclr(DIR_OFFSET(currdir, x[219]), 0x1);
+    } else {
       bclr(DIR_OFFSET(currdir, x[19]), 0x18);
+      bset(DIR_OFFSET(currdir, x[219]), 0x1); /* llvm.loop.vectorize */
+    }
     break;
   case SW_VINTR:
     if (no_specified)
@@ -1267,10 +1274,13 @@ do_sw(void)
     break;
   case SW_SSE:
   case SW_SIMD:
-    if (no_specified)
+    if (no_specified) {
       bset(DIR_OFFSET(currdir, x[19]), 0x400);
-    else
+      bclr(DIR_OFFSET(currdir, x[219]), 0x1);
+    } else {
       bclr(DIR_OFFSET(currdir, x[19]), 0x400);
+      bset(DIR_OFFSET(currdir, x[219]), 0x1);
+    }
     break;
   case SW_NOINLINE:
     /*
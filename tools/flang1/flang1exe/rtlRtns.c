@@ -377,6 +377,8 @@ FtnRteRtn ftnRtlRtns[] = {
     {"spacingx", "", FALSE, ""},
     {"stop", "", FALSE, ""},
     {"stop08", "", FALSE, ""},
+    {"str_concat", "", FALSE, ""},
+    {"str_concat_klen", "", FALSE, ""},
     {"str_copy", "", FALSE, ""},
     {"str_copy_klen", "", FALSE, ""},
     {"str_cpy1", "", FALSE, ""},
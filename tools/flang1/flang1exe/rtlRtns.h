@@ -377,6 +377,8 @@ typedef enum {
   RTE_spacingx,
   RTE_stop,
   RTE_stop08,
+  RTE_str_concat,
+  RTE_str_concat_klen,
   RTE_str_copy,
   RTE_str_copy_klen,
   RTE_str_cpy1,
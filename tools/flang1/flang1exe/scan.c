@@ -2021,6 +2021,11 @@ check_pragma(char *beg)
       return CT_FIXED;
     return CT_PRAGMA;
   }
+  if (len == 8) {
+    if (ic_strncmp(beg, "prefetch") == 0)
+      return CT_PPRAGMA;
+    return CT_PRAGMA;
+  }
   if (len == 10) {
     if (ic_strncmp(beg, "distribute") == 0) {
       beg += 10;
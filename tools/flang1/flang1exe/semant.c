@@ -12928,7 +12928,8 @@ decr_ident_use(int ident, int proc)
   if (sem.which_pass || !dirty_ident_base || gbl.internal <= 1) {
     return;
   }
-  HASH_STR(hashval, SYMNAME(ident), strlen(SYMNAME(ident)))
+  HASH_STR(hashval, SYMNAME(ident), strlen(SYMNAME(ident)));
+  hashval &= HASHSIZE - 1;
   for (curr = ident_base[hashval]; curr; curr = curr->next) {
     if (strcmp(curr->ident, SYMNAME(ident)) == 0) {
       for (curr_proc = curr->proc_list; curr_proc;
@@ -12954,6 +12955,7 @@ defer_ident_list(int ident, int proc)
     proc = SCOPEG(ident);
   }
   HASH_STR(hashval, SYMNAME(ident), strlen(SYMNAME(ident)));
+  hashval &= HASHSIZE - 1;
   for (curr = ident_base[hashval]; curr; curr = curr->next) {
     if (strcmp(curr->ident, SYMNAME(ident)) != 0)
       continue;
@@ -12999,6 +13001,7 @@ internal_proc_has_ident(int ident, int proc)
     return 0;
 
   HASH_STR(hashval, SYMNAME(ident), strlen(SYMNAME(ident)));
+  hashval &= HASHSIZE - 1;
   for (curr = ident_base[hashval]; curr; curr = curr->next) {
     if (strcmp(curr->ident, SYMNAME(ident)) == 0) {
       for (curr_proc = curr->proc_list; curr_proc;
@@ -13213,7 +13216,7 @@ fix_proc_ptr_dummy_args()
       int len = strlen(symname);
       int hash, hptr;
       HASH_ID(hash, symname, len);
-      for (hptr = stb.hashtb[hash]; hptr; hptr = HASHLKG(hptr)) {
+      for (hptr = HASHTB(hash); hptr; hptr = HASHLKG(hptr)) {
         if (is_procedure_ptr(hptr) && strcmp(symname, SYMNAME(hptr)) == 0) {
           if (hptr != sptr && test_scope(hptr) >= 0) {
             DTYPE d1 = DTYPEG(sptr);
@@ -13358,7 +13361,7 @@ _do_iface(int iface_state, int i)
     symname = SYMNAME(iface);
     len = strlen(symname);
     HASH_ID(hash, symname, len);
-    for (hptr = stb.hashtb[hash]; hptr; hptr = HASHLKG(hptr)) {
+    for (hptr = HASHTB(hash); hptr; hptr = HASHLKG(hptr)) {
       if (STYPEG(hptr) == ST_PROC && strcmp(symname, SYMNAME(hptr)) == 0) {
         alt_iface = hptr;
         if (alt_iface && (scope = test_scope(alt_iface))) {
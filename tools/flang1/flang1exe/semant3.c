@@ -50,6 +50,7 @@ static int do_label;
 static int named_construct;
 static int last_std;
 
+static void add_prefetch(SST *, SST *, SST *);
 static void add_nullify(int);
 static void check_do_term();
 static int gen_logical_if_expr(SST *);
@@ -110,6 +111,7 @@ semant3(int rednum, SST *top)
   int rhs_ast;
   int o_ast;
   int mold_or_src;
+  LOGICAL simd;
   FtnRtlEnum rtlRtn;
 
   TYPE_LIST *types, *prev, *curr;
@@ -2860,8 +2862,10 @@ semant3(int rednum, SST *top)
       add_stmt(east);
       --sem.expect_cuf_do;
     }
+    simd = FALSE;
     if (sem.expect_do) {
       sem.expect_do = FALSE;
+      simd = DI_ISSIMD(sem.doif_depth);
       ast = do_lastval(doinfo);
       if (1) {
         /* only distribute the work if in the outermost
@@ -2887,6 +2891,7 @@ semant3(int rednum, SST *top)
        */
       ast = do_lastval(doinfo);
       sem.expect_simdloop = FALSE;
+      simd = TRUE;
       sem.collapse_depth = sem.collapse;
       if (sem.collapse_depth < 2) {
         sem.collapse_depth = 0;
@@ -2906,6 +2911,8 @@ semant3(int rednum, SST *top)
     DI_DO_AST(doif) = ast;
     DI_DOINFO(doif) = doinfo;
     DI_NAME(doif) = named_construct;
+    if (simd)
+      direct_loop_simd();
     direct_loop_enter();
     SST_ASTP(LHS, ast);
     break;
@@ -4965,16 +4972,9 @@ semant3(int rednum, SST *top)
   /* ------------------------------------------------------------------
    */
   /*
-   *	<pragma stmt> ::= PREFETCH <var ref list> |
+   *	<pragma stmt> ::= PREFETCH <prefetch list> |
    */
   case PRAGMA_STMT1:
-    for (itemp = SST_BEGG(RHS(2)); itemp != ITEM_END; itemp = itemp->next) {
-      mklvalue(itemp->t.stkp, 3);
-      ast = mk_stmt(A_PREFETCH, 0);
-      A_LOPP(ast, SST_ASTG(itemp->t.stkp));
-      A_OPTYPEP(ast, 0);
-      (void)add_stmt(ast);
-    }
     SST_ASTP(LHS, 0);
     break;
   /*
@@ -5001,6 +5001,40 @@ semant3(int rednum, SST *top)
      */
     break;
 
+  /* ------------------------------------------------------------------
+   */
+  /*
+   *	<prefetch list> ::= <prefetch list> , <prefetch item> |
+   */
+  case PREFETCH_LIST1:
+    break;
+  /*
+   *	<prefetch list> ::= <prefetch item>
+   */
+  case PREFETCH_LIST2:
+    break;
+
+  /* ------------------------------------------------------------------
+   */
+  /*
+   *	<prefetch item> ::= <var ref> |
+   */
+  case PREFETCH_ITEM1:
+    add_prefetch(RHS(1), NULL, NULL);
+    break;
+  /*
+   *	<prefetch item> ::= <var ref> : <expression> |
+   */
+  case PREFETCH_ITEM2:
+    add_prefetch(RHS(1), RHS(3), NULL);
+    break;
+  /*
+   *	<prefetch item> ::= <var ref> : <expression> : <expression>
+   */
+  case PREFETCH_ITEM3:
+    add_prefetch(RHS(1), RHS(3), RHS(5));
+    break;
+
   /* ------------------------------------------------------------------
    */
   default:
@@ -5008,6 +5042,89 @@ semant3(int rednum, SST *top)
   }
 }
 
+static LOGICAL
+prefetch_load(int ast, int *found)
+{
+  if (A_TYPEG(ast) == A_SUBSCR || A_TYPEG(ast) == A_FUNC) {
+    *found = TRUE;
+    return TRUE;
+  }
+  return FALSE;
+}
+
+/* A PREFETCH distance is applied only to an element of a named array whose
+ * subscripts do not load from memory: the subscripts of an element that
+ * many iterations ahead are evaluated even if that element does not exist.
+ */
+static LOGICAL
+prefetch_ahead_ok(int obj)
+{
+  int asd, i;
+  int found = FALSE;
+
+  if (A_TYPEG(obj) != A_SUBSCR || A_TYPEG(A_LOPG(obj)) != A_ID)
+    return FALSE;
+  asd = A_ASDG(obj);
+  for (i = 0; i < ASD_NDIM(asd) && !found; ++i)
+    ast_traverse(ASD_SUBS(asd, i), prefetch_load, NULL, &found);
+  return !found;
+}
+
+/* Add a PREFETCH statement for the <var ref> ref.  hint, if present, is
+ * the locality, 0 (none) to 3 (keep in all cache levels); dist, if present,
+ * asks for the object as it will be referenced dist iterations ahead of
+ * the innermost enclosing DO loop.
+ */
+static void
+add_prefetch(SST *ref, SST *hint, SST *dist)
+{
+  int ast, obj, flag, doif, dtype, iv, ofst;
+  INT val;
+
+  mklvalue(ref, 3);
+  obj = SST_ASTG(ref);
+  flag = 0;
+  if (hint) {
+    val = chkcon(hint, DT_INT4, TRUE);
+    if (val < 0 || val > PF_HINT_MASK)
+      error(155, 2, gbl.lineno, "PREFETCH hint must be 0, 1, 2 or 3",
+            "- hint ignored");
+    else
+      flag = PF_HINT | val;
+  }
+  if (dist) {
+    for (doif = sem.doif_depth; doif > 0; --doif)
+      if (DI_ID(doif) == DI_DO && DI_DOINFO(doif))
+        break;
+    if (doif <= 0) {
+      error(155, 2, gbl.lineno,
+            "PREFETCH distance outside of a DO loop is ignored", CNULL);
+    } else if (!prefetch_ahead_ok(obj)) {
+      error(155, 2, gbl.lineno, "PREFETCH distance is ignored for",
+            "an object other than an element of a named array");
+    } else {
+      /* replace the index variable with iv + dist * step */
+      iv = mk_id(DI_DOINFO(doif)->index_var);
+      dtype = A_DTYPEG(iv);
+      chk_scalartyp(dist, dtype, FALSE);
+      ofst = mk_binop(OP_MUL, SST_ASTG(dist), DI_DOINFO(doif)->step_expr,
+                      dtype);
+      ast_visit(1, 1);
+      ast_replace(iv, mk_binop(OP_ADD, iv, ofst, dtype));
+      ast = ast_rewrite(obj);
+      ast_unvisit();
+      if (ast == obj)
+        error(155, 2, gbl.lineno, "PREFETCH distance is ignored for",
+              "an object that does not depend on the DO variable");
+      obj = ast;
+    }
+  }
+  ast = mk_stmt(A_PREFETCH, 0);
+  A_LOPP(ast, obj);
+  A_OPTYPEP(ast, flag);
+  (void)add_stmt(ast);
+}
+
 static void
 add_nullify(int sptr)
 {
@@ -5116,7 +5233,7 @@ find_non_tbp(char *symname)
   int paramct, dpdsc, dtype2, arg;
   len = strlen(symname);
   HASH_ID(hash, symname, len);
-  for (hptr = stb.hashtb[hash]; hptr; hptr = HASHLKG(hptr)) {
+  for (hptr = HASHTB(hash); hptr; hptr = HASHLKG(hptr)) {
     if (STYPEG(hptr) == ST_PROC && strcmp(SYMNAME(hptr), symname) == 0 &&
         !CLASSG(hptr)) {
       return hptr;
@@ -2900,7 +2900,7 @@ find_by_name_stype_arg(char *symname, int stype, int scope, int dtype, int inv,
   int paramct, dpdsc, dtype2, arg;
   len = strlen(symname);
   HASH_ID(hash, symname, len);
-  for (hptr = stb.hashtb[hash]; hptr; hptr = HASHLKG(hptr)) {
+  for (hptr = HASHTB(hash); hptr; hptr = HASHLKG(hptr)) {
     if (STYPEG(hptr) == stype && strcmp(SYMNAME(hptr), symname) == 0) {
       if (scope == 0 || scope == SCOPEG(hptr)) {
         if (!inv)
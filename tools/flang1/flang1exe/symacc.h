@@ -67,19 +67,16 @@ extern "C" {
    defined or there exist alternative definitions for these values
    somewhere.  This needs to be unified and cleaned.  */
 
-/* hashtab stuff */
-#define HASHSIZE 9973
-#define HASH_CON(p) ((p[0] ^ p[1]) % HASHSIZE)
-#define HASH_ID(hv, p, len)                            \
-  hv = p[(len)-1] | (*p << 16) | (p[(len) >> 1] << 8); \
-  if ((int)(len) > 3)                                  \
-    hv ^= (p[1] << 4);                                 \
-  hv %= HASHSIZE;
-#define HASH_STR(hv, p, len)     \
-  if (len) {                     \
-    /*hv =*/HASH_ID(hv, p, len); \
-  } else                         \
-    hv = 0;
+/* hashtab stuff: stb.hashtb has stb.hashsz buckets, a power of 2 that
+   starts at HASHSIZE and doubles when the number of symbols exceeds it.
+   The HASH_ macros compute a full hash code which HASHTB() reduces to a
+   bucket, so a code stays valid across growth; stb.hashv[] holds the
+   code each linked symbol was entered with. */
+#define HASHSIZE 4096
+#define HASHTB(hv) stb.hashtb[(hv) & (stb.hashsz - 1)]
+#define HASH_CON(p) hash_sym_con(p)
+#define HASH_ID(hv, p, len) hv = hash_sym_name(p, len);
+#define HASH_STR(hv, p, len) hv = hash_sym_name(p, len);
 
 /* limits */
 #define MAX_NMPTR 134217728
@@ -88,15 +85,19 @@ extern "C" {
 void realloc_sym_storage();
 
 /* symbol creation macros */
-#define NEWSYM(sptr)         \
-  sptr = (SPTR)stb.symavl++; \
-  if (sptr >= stb.s_size)    \
-    realloc_sym_storage();   \
-  BZERO(&stb.s_base[sptr], char, sizeof(SYM))
+#define NEWSYM(sptr)                           \
+  sptr = (SPTR)stb.symavl++;                   \
+  if (sptr >= stb.s_size)                      \
+    realloc_sym_storage();                     \
+  BZERO(&stb.s_base[sptr], char, sizeof(SYM)); \
+  stb.hashv[sptr] = 0
 
-#define LINKSYM(sptr, hashval)        \
-  HASHLKP(sptr, stb.hashtb[hashval]); \
-  stb.hashtb[hashval] = sptr
+#define LINKSYM(sptr, hashval)   \
+  HASHLKP(sptr, HASHTB(hashval)); \
+  HASHTB(hashval) = sptr;         \
+  stb.hashv[sptr] = hashval;      \
+  if (stb.symavl > stb.hashsz)    \
+    grow_sym_hash()
 
 #define ADDSYM(sptr, hashval) \
   NEWSYM(sptr);               \
@@ -184,7 +185,9 @@ typedef struct {
   int dt_size;
   int dt_avail;
   int curr_scope;
-  SPTR hashtb[HASHSIZE + 1];
+  SPTR *hashtb;
+  int hashsz;
+  INT *hashv; /* hash code of each linked symbol */
   SPTR firstusym, firstosym;
   INDEX_BY(SYM, SPTR) s_base;
   int s_size;
@@ -242,6 +245,9 @@ typedef enum IS_MODE {
 } IS_MODE;
 
 void sym_init_first(void);
+INT hash_sym_name(const char *, int);
+INT hash_sym_con(const INT *);
+void grow_sym_hash(void);
 SPTR lookupsym(const char *, int);
 SPTR lookupsymbol(const char *);
 SPTR lookupsymf(const char *, ...);
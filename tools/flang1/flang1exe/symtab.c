@@ -150,6 +150,16 @@ sym_init(void)
   stb.namavl = INIT_NAMES_SIZE;
 
   BCOPY(stb.hashtb, init_hashtb, int, HASHSIZE);
+  for (i = 0; i < HASHSIZE; i++) {
+    int s;
+    for (s = stb.hashtb[i]; s; s = HASHLKG(s)) {
+      HASH_ID(stb.hashv[s], SYMNAME(s), strlen(SYMNAME(s)));
+#if DEBUG
+      assert((stb.hashv[s] & (HASHSIZE - 1)) == i, "sym_init:bad init_hashtb",
+             s, 4);
+#endif
+    }
+  }
 
   if (XBIT(124, 0x10)) {
     /* -i8 */
@@ -538,7 +548,7 @@ SPTR
 getcon(INT *value, DTYPE dtype)
 {
   int sptr;    /* symbol table pointer */
-  int hashval; /* index into hashtb */
+  int hashval; /* hash code for hashtb */
 
   /*
    * First loop thru the appropriate hash link list to see if this constant
@@ -548,7 +558,7 @@ getcon(INT *value, DTYPE dtype)
   hashval = HASH_CON(value);
   if (hashval < 0)
     hashval = -hashval;
-  for (sptr = stb.hashtb[hashval]; sptr != 0; sptr = HASHLKG(sptr)) {
+  for (sptr = HASHTB(hashval); sptr != 0; sptr = HASHLKG(sptr)) {
     if (DTY(dtype) == TY_QUAD) {
       if (DTYPEG(sptr) != dtype || STYPEG(sptr) != ST_CONST ||
           CONVAL1G(sptr) != value[0] || CONVAL2G(sptr) != value[1] ||
@@ -587,7 +597,7 @@ int
 hashcon(INT *value, int dtype, int sptr)
 {
   int sptr1;   /* symbol table pointer */
-  int hashval; /* index into hashtb */
+  int hashval; /* hash code for hashtb */
 
   /*
    * First loop thru the appropriate hash link list to see if this constant
@@ -597,7 +607,7 @@ hashcon(INT *value, int dtype, int sptr)
   hashval = HASH_CON(value);
   if (hashval < 0)
     hashval = -hashval;
-  for (sptr1 = stb.hashtb[hashval]; sptr1 != 0; sptr1 = HASHLKG(sptr1)) {
+  for (sptr1 = HASHTB(hashval); sptr1 != 0; sptr1 = HASHLKG(sptr1)) {
 
     if (sptr1 == sptr)
       return (sptr);
@@ -605,8 +615,7 @@ hashcon(INT *value, int dtype, int sptr)
 
   /* sptr not found.  */
 
-  HASHLKP(sptr, stb.hashtb[hashval]);
-  stb.hashtb[hashval] = sptr;
+  LINKSYM(sptr, hashval);
 
   return (sptr);
 }
@@ -626,7 +635,7 @@ get_acon3(SPTR sym, ISZ_T off, DTYPE dtype)
 {
   INT value[2];
   int sptr;    /* symbol table pointer */
-  int hashval; /* index into stb.hashtb */
+  int hashval; /* hash code for stb.hashtb */
 
   /*
    * First loop thru the appropriate hash link list to see if this constant
@@ -638,7 +647,7 @@ get_acon3(SPTR sym, ISZ_T off, DTYPE dtype)
   hashval = HASH_CON(value);
   if (hashval < 0)
     hashval = -hashval;
-  for (sptr = stb.hashtb[hashval]; sptr != 0; sptr = HASHLKG(sptr)) {
+  for (sptr = HASHTB(hashval); sptr != 0; sptr = HASHLKG(sptr)) {
     if (DTYPEG(sptr) != dtype || STYPEG(sptr) != ST_CONST ||
         CONVAL1G(sptr) != sym || ACONOFFG(sptr) != off)
       continue;
@@ -739,7 +748,7 @@ int
 getstring(char *value, int length)
 {
   int sptr;    /* symbol table pointer */
-  int hashval; /* index into hashtb */
+  int hashval; /* hash code for hashtb */
   char *np;    /* pointer to string characters */
   char *p;
   int i, clen;
@@ -752,8 +761,8 @@ getstring(char *value, int length)
   /* Ensure hash value is positive.  '\nnn' can cause negative hash values */
   if (hashval < 0)
     hashval = -hashval;
-  for (sptr = stb.hashtb[hashval]; sptr != 0; sptr = HASHLKG(sptr)) {
-    if (STYPEG(sptr) != ST_CONST)
+  for (sptr = HASHTB(hashval); sptr != 0; sptr = HASHLKG(sptr)) {
+    if (stb.hashv[sptr] != hashval || STYPEG(sptr) != ST_CONST)
       continue;
     i = DTYPEG(sptr);
     if (DTY(i) == TY_CHAR) {
@@ -2064,14 +2073,15 @@ insert_sym(int first)
   i = strlen(np);
   HASH_ID(hashval, np, i);
   HASHLKP(sptr, first);
-  if (stb.hashtb[hashval] == first)
-    stb.hashtb[hashval] = sptr;
+  if (HASHTB(hashval) == first)
+    HASHTB(hashval) = sptr;
   else {
     /* scan hash list to find immed. predecessor of first: */
-    for (i = stb.hashtb[hashval]; (j = HASHLKG(i)) != first; i = j)
+    for (i = HASHTB(hashval); (j = HASHLKG(i)) != first; i = j)
       assert(j != 0, "insert_sym: bad hash", first, 4);
     HASHLKP(i, sptr);
   }
+  stb.hashv[sptr] = hashval;
 
   SYMLKP(sptr, NOSYM); /* installsym for ftn also sets SYMLK */
   setimplicit(sptr);
@@ -2098,8 +2108,7 @@ insert_sym_first(int first)
   np = SYMNAME(first);
   i = strlen(np);
   HASH_ID(hashval, np, i);
-  HASHLKP(sptr, stb.hashtb[hashval]);
-  stb.hashtb[hashval] = sptr;
+  LINKSYM(sptr, hashval);
   SYMLKP(sptr, NOSYM); /* installsym for ftn also sets SYMLK */
   setimplicit(sptr);
   if (gbl.internal > 1)
@@ -2182,7 +2191,7 @@ pop_sym(int sptr)
   name = SYMNAME(sptr);
   l = strlen(name);
   HASH_ID(hashval, name, l);
-  for (s = stb.hashtb[hashval], j = 0; s; s = HASHLKG(s)) {
+  for (s = HASHTB(hashval), j = 0; s; s = HASHLKG(s)) {
     if (s == sptr) {
 #if DEBUG
       if (DBGBIT(5, 1024))
@@ -2191,7 +2200,7 @@ pop_sym(int sptr)
       if (j)
         HASHLKP(j, HASHLKG(sptr));
       else
-        stb.hashtb[hashval] = HASHLKG(sptr);
+        HASHTB(hashval) = HASHLKG(sptr);
       break;
     }
     j = s;
@@ -2217,8 +2226,7 @@ push_sym(int sptr)
   name = SYMNAME(sptr);
   l = strlen(name);
   HASH_ID(hashval, name, l);
-  HASHLKP(sptr, stb.hashtb[hashval]);
-  stb.hashtb[hashval] = sptr;
+  LINKSYM(sptr, hashval);
 } /* push_sym */
 
 /** create a function ST item given a name */
@@ -2527,8 +2535,9 @@ cmp_interfaces(int sym1, int sym2, int flag)
     symname = SYMNAME(sym1);
     len = strlen(symname);
     HASH_ID(hash, symname, len);
-    for (hptr = stb.hashtb[hash]; hptr; hptr = HASHLKG(hptr)) {
-      if (STYPEG(hptr) == ST_PROC && strcmp(symname, SYMNAME(hptr)) == 0) {
+    for (hptr = HASHTB(hash); hptr; hptr = HASHLKG(hptr)) {
+      if (stb.hashv[hptr] == hash && STYPEG(hptr) == ST_PROC &&
+          strcmp(symname, SYMNAME(hptr)) == 0) {
         alt_iface = hptr;
         if (alt_iface && (scope = test_scope(alt_iface))) {
           if (scope <= test_scope(sym1)) {
@@ -2546,8 +2555,9 @@ cmp_interfaces(int sym1, int sym2, int flag)
     symname = SYMNAME(sym2);
     len = strlen(symname);
     HASH_ID(hash, symname, len);
-    for (hptr = stb.hashtb[hash]; hptr; hptr = HASHLKG(hptr)) {
-      if (STYPEG(hptr) == ST_PROC && strcmp(symname, SYMNAME(hptr)) == 0) {
+    for (hptr = HASHTB(hash); hptr; hptr = HASHLKG(hptr)) {
+      if (stb.hashv[hptr] == hash && STYPEG(hptr) == ST_PROC &&
+          strcmp(symname, SYMNAME(hptr)) == 0) {
         alt_iface = hptr;
         if (alt_iface && (scope = test_scope(alt_iface))) {
           if (scope <= test_scope(sym2)) {
@@ -2759,7 +2769,9 @@ mangle_name(char *basename, char *purpose)
   for (i = 0;;) {
     length = strlen(name);
     HASH_ID(hashval, name, length);
-    for (sptr = stb.hashtb[hashval]; sptr != 0; sptr = HASHLKG(sptr)) {
+    for (sptr = HASHTB(hashval); sptr != 0; sptr = HASHLKG(sptr)) {
+      if (stb.hashv[sptr] != hashval)
+        continue;
       if (IGNOREG(sptr) && stb.curr_scope == SCOPEG(sptr))
         continue;
       if (strcmp(name, SYMNAME(sptr)) == 0)
@@ -2815,8 +2827,9 @@ mangle_name_dt(char *basename, char *purpose, int encldtype)
   for (i = 0;;) {
     length = strlen(name);
     HASH_ID(hashval, name, length);
-    for (sptr = stb.hashtb[hashval]; sptr != 0; sptr = HASHLKG(sptr)) {
-      if (STYPEG(sptr) != ST_MEMBER || ENCLDTYPEG(sptr) != encldtype)
+    for (sptr = HASHTB(hashval); sptr != 0; sptr = HASHLKG(sptr)) {
+      if (stb.hashv[sptr] != hashval || STYPEG(sptr) != ST_MEMBER ||
+          ENCLDTYPEG(sptr) != encldtype)
         continue; /* no clash */
       if (strcmp(name, SYMNAME(sptr)) == 0)
         break;
@@ -2882,8 +2895,12 @@ change_predefineds(int stype, LOGICAL remove)
         STYPEP(s, ST_PD);
   } else {
     for (s = first; s <= last; s++)
-      if (STYPEG(s) == ST_PD)
+      if (STYPEG(s) == ST_PD) {
+        /* the hash link may have changed since the table grew */
+        SPTR hashlk = HASHLKG(s);
         BCOPY(stb.s_base + s, init_sym + s, SYM, 1);
+        HASHLKP(s, hashlk);
+      }
   }
 }
 
@@ -2899,10 +2916,17 @@ void rw_sym_state(RW_ROUTINE, RW_FILE)
 {
   int nw;
 
-  RW_FD(stb.hashtb, stb.hashtb, 1);
+  nw = stb.hashsz;
+  RW_SCALAR(stb.hashsz);
+  if (ISREAD() && stb.hashsz != nw) {
+    FREE(stb.hashtb);
+    NEW(stb.hashtb, SPTR, stb.hashsz);
+  }
+  RW_FD(stb.hashtb, SPTR, stb.hashsz);
   RW_SCALAR(stb.firstusym);
   RW_SCALAR(stb.symavl);
   RW_FD(stb.s_base, SYM, stb.symavl);
+  RW_FD(stb.hashv, INT, stb.symavl);
 
   RW_SCALAR(stb.namavl);
   RW_FD(stb.n_base, char, stb.namavl);
@@ -2946,7 +2970,10 @@ void
 symtab_fini(void)
 {
   FREE(stb.s_base);
+  FREE(stb.hashv);
   stb.s_size = 0;
+  FREE(stb.hashtb);
+  stb.hashsz = 0;
   FREE(stb.n_base);
   stb.n_size = 0;
   FREE(stb.dt_base);
@@ -3532,7 +3532,7 @@ first_hash(int sptr)
   HASH_ID(hashval, name, len);
   if (hashval < 0)
     hashval = -hashval;
-  return stb.hashtb[hashval];
+  return HASHTB(hashval);
 } /* first_hash */
 
 LOGICAL
@@ -3590,14 +3590,14 @@ get_next_hash_link(int sptr, int task)
   HASH_ID(hash, symname, len);
   if (task == 0) {
     /* init visit flag for all symbols with same name as sptr */
-    for (hptr = stb.hashtb[hash]; hptr; hptr = HASHLKG(hptr)) {
+    for (hptr = HASHTB(hash); hptr; hptr = HASHLKG(hptr)) {
       if (STYPEG(hptr) == STYPEG(sptr) && strcmp(symname, SYMNAME(hptr)) == 0) {
         VISITP(hptr, 0);
       }
     }
   } else if (task == 1) {
     VISITP(sptr, 1);
-    for (hptr = stb.hashtb[hash]; hptr; hptr = HASHLKG(hptr)) {
+    for (hptr = HASHTB(hash); hptr; hptr = HASHLKG(hptr)) {
       if (hptr != sptr && !VISITG(hptr) && STYPEG(hptr) == STYPEG(sptr) &&
           strcmp(symname, SYMNAME(hptr)) == 0) {
         return hptr;
@@ -3605,7 +3605,7 @@ get_next_hash_link(int sptr, int task)
     }
   } else if (task == 2) {
     VISITP(sptr, 1);
-    for (hptr = stb.hashtb[hash]; hptr; hptr = HASHLKG(hptr)) {
+    for (hptr = HASHTB(hash); hptr; hptr = HASHLKG(hptr)) {
       if (hptr != sptr && !VISITG(hptr) &&
           strcmp(symname, SYMNAME(hptr)) == 0) {
         return hptr;
@@ -3638,7 +3638,7 @@ findByNameStypeScope(char *symname, int stype, int scope)
   int hash, hptr, len;
   len = strlen(symname);
   HASH_ID(hash, symname, len);
-  for (hptr = stb.hashtb[hash]; hptr; hptr = HASHLKG(hptr)) {
+  for (hptr = HASHTB(hash); hptr; hptr = HASHLKG(hptr)) {
     if ((stype == 0 || STYPEG(hptr) == stype) &&
         strcmp(SYMNAME(hptr), symname) == 0) {
       if (scope == 0 || (scope == -1 && test_scope(hptr) > 0) ||
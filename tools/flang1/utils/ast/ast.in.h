@@ -81,6 +81,13 @@
 #define OP_DERIVED 32
 #define OP_BYVAL 33
 
+/* A_OPTYPE of a PREFETCH statement, passed unchanged as the flag operand
+ * of ILM PREFETCH.
+ */
+#define PF_HINT_MASK 0x3 /* locality, as _MM_HINT_*: 0 = NTA .. 3 = T0 */
+#define PF_HINT 0x4      /* the locality was given in the directive */
+#define PF_WRITE 0x8     /* the object is also stored in the loop */
+
 /* AST attributes: for fast AST checking -- astb.attr is a table indexed
  * by A_<type>
  */
@@ -199,6 +206,7 @@ typedef struct {
 	    unsigned  atomic:1;  /* stmt belongs to an atomic */
 
 	    unsigned  ztrip:1;   /* stmt marked for array assignment */
+	    unsigned  vect:1;    /* DO of an array assignment, lower to FV ILMs */
 	}  bits;
     }  flags;
 } STD;
@@ -240,12 +248,15 @@ typedef struct {
 #define STD_KERNEL(i)  astb.std.base[i].flags.bits.kernel
 #define STD_ZTRIP(i)   astb.std.base[i].flags.bits.ztrip
 #define STD_ATOMIC(i)  astb.std.base[i].flags.bits.atomic
+#define STD_VECT(i)    astb.std.base[i].flags.bits.vect
 
 
 /*=================================================================*/
 
-/* hash table stuff */
-#define HSHSZ 503
+/* hash table stuff: astb.hshtb has astb.hshsz buckets, a power of 2
+   that starts at HSHSZ and doubles when the number of ASTs exceeds it;
+   astb.hshv[] holds the hash code of each hashed AST. */
+#define HSHSZ 1024
 
 /* limits */
 #define MAXAST   67108864
@@ -283,8 +294,10 @@ typedef struct {
 typedef struct {
     char   *atypes[AST_MAX + 1];
     int     attr[AST_MAX + 1];
-    int     hshtb[HSHSZ + 1];
+    int    *hshtb;
+    int     hshsz;
     AST    *base;
+    int    *hshv;
     int     size;
     int     avl;
     int     firstuast;
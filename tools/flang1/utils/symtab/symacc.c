@@ -45,6 +45,7 @@
 #else
 #include "symtab.h"
 #endif
+#include "flang/ADT/hash.h"
 #include <stdarg.h>
 
 #ifndef STANDARD_MAXIDLEN
@@ -54,8 +55,6 @@
 void
 sym_init_first(void)
 {
-  int i;
-
   int sizeof_SYM = sizeof(SYM) / sizeof(INT);
 #if defined(PGHPF)
   assert(sizeof_SYM == 44, "bad SYM size", sizeof_SYM, 4);
@@ -68,6 +67,8 @@ sym_init_first(void)
     NEW(stb.s_base, SYM, stb.s_size);
     BZERO(stb.s_base, SYM, stb.s_size);
     assert(stb.s_base, "sym_init: no room for symtab", stb.s_size, 4);
+    NEW(stb.hashv, INT, stb.s_size);
+    assert(stb.hashv, "sym_init: no room for hashv", stb.s_size, 4);
 #if defined(PGHPF) && !defined(PGF90)
     stb.n_size = 7011;
 #else
@@ -91,8 +92,14 @@ sym_init_first(void)
   stb.symavl = 1;
   stb.namavl = 1;
   stb.wrdavl = 0;
-  for (i = 0; i <= HASHSIZE; i++)
-    stb.hashtb[i] = 0;
+  if (stb.hashsz != HASHSIZE) {
+    /* start every program unit with the initial table size */
+    FREE(stb.hashtb);
+    stb.hashsz = HASHSIZE;
+    NEW(stb.hashtb, SPTR, stb.hashsz);
+    assert(stb.hashtb, "sym_init: no room for hashtb", stb.hashsz, 4);
+  }
+  BZERO(stb.hashtb, SPTR, stb.hashsz);
 
 #ifndef INIT
 #ifdef PGHPF
@@ -118,6 +125,7 @@ realloc_sym_storage()
   symini_errfatal(7);
 #else
   unsigned n;
+  int size;
   DEBUG_ASSERT(stb.symavl > stb.s_size,
                "realloc_sym_storage: call only if necessary");
   if (stb.symavl > SPTR_MAX + 1 || stb.s_base == NULL)
@@ -128,11 +136,81 @@ realloc_sym_storage()
   n = 2u * stb.s_size;
   if (n > SPTR_MAX + 1)
     n = SPTR_MAX + 1;
+  size = stb.s_size;
+  NEED(stb.symavl, stb.hashv, INT, size, n);
   NEED(stb.symavl, stb.s_base, SYM, stb.s_size, n);
   DEBUG_ASSERT(stb.symavl <= stb.s_size, "realloc_sym_storage: internal error");
 #endif
 }
 
+/** \brief Hash code of a symbol name or character string for HASH_ID and
+    HASH_STR: the Jenkins one-at-a-time hash over all of its characters.
+
+    This is strtab_hash() with the sign bit cleared; it is computed here
+    because not every program built from this file links the ADT library.
+    Since stb.hashv[] keeps the full code of each linked symbol, lookups by
+    name compare it before comparing any characters.
+ */
+INT
+hash_sym_name(const char *p, int len)
+{
+  hash_accu_t hacc = HASH_ACCU_INIT;
+  int i;
+
+  for (i = 0; i < len; ++i)
+    HASH_ACCU_ADD(hacc, (unsigned char)p[i]);
+  HASH_ACCU_FINISH(hacc);
+  return HASH_ACCU_VALUE(hacc) & 0x7fffffff;
+}
+
+/** \brief Hash code of the first two words of a constant for HASH_CON.
+ */
+INT
+hash_sym_con(const INT *p)
+{
+  hash_accu_t hacc = HASH_ACCU_INIT;
+
+  HASH_ACCU_ADD(hacc, p[0]);
+  HASH_ACCU_ADD(hacc, p[1]);
+  HASH_ACCU_FINISH(hacc);
+  return HASH_ACCU_VALUE(hacc) & 0x7fffffff;
+}
+
+/** \brief Double the number of buckets in stb.hashtb.
+
+    Bucket i of a table of n buckets splits into buckets i and i + n of
+    the new one.  The symbols keep their relative order within each
+    chain, so the most recently entered symbol of a name is still found
+    first, which the scoping code (pushsym/popsym) relies on.
+ */
+void
+grow_sym_hash(void)
+{
+  SPTR *tb;
+  int n, i;
+
+  n = stb.hashsz;
+  NEW(tb, SPTR, 2 * n);
+  assert(tb, "grow_sym_hash: no room for hashtb", 2 * n, 4);
+  for (i = 0; i < n; ++i) {
+    SPTR sptr, next;
+    SPTR *tail[2];
+    tail[0] = &tb[i];
+    tail[1] = &tb[i + n];
+    for (sptr = stb.hashtb[i]; sptr; sptr = next) {
+      int hi = (stb.hashv[sptr] & n) != 0;
+      next = HASHLKG(sptr);
+      *tail[hi] = sptr;
+      tail[hi] = &stb.s_base[sptr].hashlk;
+    }
+    *tail[0] = SPTR_NULL;
+    *tail[1] = SPTR_NULL;
+  }
+  FREE(stb.hashtb);
+  stb.hashtb = tb;
+  stb.hashsz = 2 * n;
+}
+
 /**
    \brief Look up symbol with indicated name.
 
@@ -146,7 +224,7 @@ lookupsym(const char *name, int olength)
 {
   int length;
   SPTR sptr;     /* pointer to symbol table entry */
-  INT hashval;   /* index into hashtb. */
+  INT hashval;   /* hash code for hashtb */
   char *np, *sp; /* pointer to symbol name characters */
 
   /*
@@ -159,7 +237,9 @@ lookupsym(const char *name, int olength)
     length = MAXIDLEN;
   }
   HASH_ID(hashval, name, length);
-  for (sptr = stb.hashtb[hashval]; sptr != 0; sptr = HASHLKG(sptr)) {
+  for (sptr = HASHTB(hashval); sptr != 0; sptr = HASHLKG(sptr)) {
+    if (stb.hashv[sptr] != hashval)
+      continue;
 #if defined(PGHPF) && !defined(INIT)
     if (HIDDENG(sptr))
       continue;
@@ -246,7 +326,7 @@ installsym_ex(const char *name, int olength, IS_MODE mode)
 {
   int length;
   SPTR sptr;     /* pointer to symbol table entry */
-  INT hashval;   /* index into hashtb. */
+  INT hashval;   /* hash code for hashtb */
   char *np, *sp; /* pointer to symbol name characters */
   bool toolong;
   int i, nmptr;
@@ -280,10 +360,13 @@ installsym_ex(const char *name, int olength, IS_MODE mode)
     int prev;
     HASH_ID(hashval, name, length);
     prev = 0;
-    for (sptr = stb.hashtb[hashval]; sptr != 0;
+    for (sptr = HASHTB(hashval); sptr != 0;
          prev = sptr, sptr = HASHLKG(sptr)) {
       const char *sname;
-      int np = NMPTRG(sptr);
+      int np;
+      if (stb.hashv[sptr] != hashval)
+        continue;
+      np = NMPTRG(sptr);
       if (np + length >= stb.namavl)
         continue;
       sname = stb.n_base + np;
@@ -274,9 +274,9 @@ private:
     if (length > MAXIDLEN) {
       length = MAXIDLEN;
     }
-    INT hashval; /* index into hashtb. */
+    INT hashval; /* hash code for hashtb */
     HASH_ID(hashval, name.c_str(), length);
-    for (SPTR sptr = stb.hashtb[hashval]; sptr; sptr = HASHLKG(sptr)) {
+    for (SPTR sptr = HASHTB(hashval); sptr; sptr = HASHLKG(sptr)) {
       if (name == SYMNAME(sptr))
         return sptr;
     }
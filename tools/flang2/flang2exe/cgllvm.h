@@ -60,7 +60,8 @@ OPERAND *gen_address_operand(int, int, bool, LL_Type *, MSZ);
 DTYPE msz_dtype(MSZ msz);
 #endif
 const char *char_type(int dtype, int sptr);
-void update_external_function_declarations(char *, unsigned int);
+void update_external_function_declarations(const char *, LL_Type *,
+                                          unsigned int);
 
 extern LL_Module *cpu_llvm_module;
 
@@ -131,7 +132,8 @@ int strict_match(LL_Type *, LL_Type *);
 void process_formal_arguments(LL_ABI_Info *);
 void write_external_function_declarations(int);
 
-void update_external_function_declarations(char *, unsigned int);
+void update_external_function_declarations(const char *, LL_Type *,
+                                          unsigned int);
 
 int get_return_type(int);
 #ifdef TARGET_LLVM_X8664
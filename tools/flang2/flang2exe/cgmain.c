@@ -42,6 +42,7 @@
 #include "expand.h"
 #include "outliner.h"
 #include "cgllvm.h"
+#include "direct.h"
 #if defined(SOCPTRG)
 #include "soc.h"
 #endif
@@ -215,6 +216,14 @@ static int addr_func_ptrs;
 static STMT_Type curr_stmt_type;
 static int *idxstack = NULL;
 
+/* The vector math routines of the runtime declared in this module, the
+   operands of @llvm.compiler.used (see vmath_declare()). */
+static struct vmath_use {
+  char *name;    /* with the leading '@' */
+  LL_Type *type; /* function type */
+} *vmath_used;
+static int vmath_nused;
+
 static struct ret_tag {
   /** If ILI uses a hidden pointer argument to return a struct, this is it. */
   int sret_sptr;
@@ -276,6 +285,64 @@ static GBL_LIST *Globals;
 static GBL_LIST *recorded_Globals;
 static INSTR_LIST *Instructions;
 static CSED_ITEM *csedList;
+static hashmap_t csedIndex; /* ilix -> CSED_ITEM* for the items of csedList */
+
+/* Loops with directives.  When the routine has sets of loop pragmas, the
+ * labels of the blocks that begin at the DO statement of such a loop are
+ * entered into loopHeads as they are emitted.  A later branch to one of them
+ * closes the loop, and gets the !llvm.loop metadata made from the pragmas.
+ */
+static hashmap_t loopHeads; /* label sptr -> its I_NONE instruction */
+static bool loop_md_enabled;
+
+/* Index of the instructions of the current EBB, used by the CSE searches of
+ * find_load_cse(), ad_csed_instr() and make_bitcast() in place of walking the
+ * instruction list back to the start of the block each time.  Instructions
+ * are numbered in the order they are added, from 0 at the STARTEBB
+ * instruction, and are entered lazily when a search is next made.  The maps
+ * give the number of the latest instruction with a given property; a search
+ * succeeds if that instruction is not older than the latest instruction the
+ * corresponding walk would have stopped at.
+ */
+typedef struct {
+  int seq; /**< instruction number */
+  int nme; /**< names entry written */
+} EBB_WRITE;
+
+typedef struct {
+  int low;      /**< writes after this instruction have been checked */
+  int upto;     /**< number of writes checked */
+  int conflict; /**< latest conflicting write after low, or -1 */
+} EBB_CLEAN;
+
+static struct {
+  INSTR_LIST *start;       /**< first instruction of the EBB, or NULL */
+  INSTR_LIST *last;        /**< last instruction entered in the index */
+  INSTR_LIST **instrs;     /**< instruction number -> instruction */
+  hash_value_t *op_hash;   /**< instruction number -> hash for by_ops */
+  hash_value_t *cast_hash; /**< instruction number -> hash for by_cast */
+  int ninstrs;
+  int instrs_size;
+  EBB_WRITE *writes; /**< stores and atomics that may conflict with loads */
+  int nwrites;
+  int writes_size;
+  EBB_CLEAN *clean; /**< conflict checks done for each loaded names entry */
+  int nclean;
+  int clean_size;
+  int ld_barrier;   /**< latest instruction no load may move above */
+  int op_barrier;   /**< latest instruction ending ad_csed_instr()'s walk */
+  int cast_barrier; /**< latest instruction ending make_bitcast()'s walk */
+  hashmap_t by_ilix; /**< instr->ilix -> latest instruction */
+  hashmap_t by_addr; /**< store address ili -> latest store */
+  hashmap_t by_nme;  /**< store names entry -> latest store */
+  hashmap_t by_load; /**< load names entry -> index in clean */
+  hashset_t by_ops;  /**< opcode and operands -> latest instruction */
+  hashset_t by_cast; /**< bitcast operand and type -> latest bitcast */
+} ebb_idx;
+
+/* Keys are offset by one since a zero ilix or names entry cannot be used as
+   a hash key. */
+#define EBB_KEY(k) INT2HKEY((k) + 1)
 
 typedef struct TmpsMap {
   unsigned size;
@@ -296,6 +363,7 @@ static OPERAND *gen_call_llvm_intrinsic(const char *, OPERAND *, LL_Type *,
                                         INSTR_LIST *, int);
 static OPERAND *gen_llvm_atomicrmw_instruction(int, int, OPERAND *, DTYPE);
 static void gen_llvm_fence_instruction(int ilix);
+static void gen_llvm_prefetch(int ilix);
 static const char *get_atomicrmw_opname(LL_InstrListFlags);
 static const char *get_atomic_memory_order_name(int);
 static void insert_llvm_memcpy(int, int, OPERAND *, OPERAND *, int, int, int);
@@ -343,6 +411,8 @@ static void remove_from_csed_list(int);
 static void set_csed_operand(OPERAND **, OPERAND *);
 static OPERAND **get_csed_operand(int ilix);
 static void build_csed_list(int);
+static void ebb_idx_reset(INSTR_LIST *);
+static bool can_move_load_up_over_fence(INSTR_LIST *);
 static OPERAND *gen_base_addr_operand(int, LL_Type *);
 static OPERAND *gen_comp_operand(OPERAND *, ILI_OP, int, int, int, int, int);
 static OPERAND *gen_optext_comp_operand(OPERAND *, ILI_OP, int, int, int, int,
@@ -371,6 +441,7 @@ static void add_external_function_declaration(EXFUNC_LIST *);
 static LOGICAL repeats_in_binary(union xx_u);
 static bool zerojump(ILI_OP);
 static bool exprjump(ILI_OP);
+static void add_loop_metadata(INSTR_LIST *, SPTR);
 static OPERAND *gen_resized_vect(OPERAND *, int, int);
 static bool is_blockaddr_store(int, int, int);
 static int process_blockaddr_sptr(int, int);
@@ -451,8 +522,7 @@ get_llvm_sname(int sptr)
     p = SYMNAME(sptr);
     if (p == NULL)
       return "";
-    SNAME(sptr) = (char *)getitem(LLVM_LONGTERM_AREA, strlen(p) + 1);
-    p = strcpy(SNAME(sptr), p);
+    p = SNAME(sptr) = ll_intern_name(p);
     return p;
   }
   if (*p == '@')
@@ -797,6 +867,12 @@ restartConcur:
 
   /* inititalize the definition lists per routine */
   csedList = NULL;
+  if (hashmap_size(csedIndex))
+    hashmap_clear(csedIndex);
+  if (hashmap_size(loopHeads))
+    hashmap_clear(loopHeads);
+  loop_md_enabled = direct.lpg.avail > 1 && !XBIT(219, 0x4);
+  ebb_idx_reset(NULL);
   memset(&ret_info, 0, sizeof(ret_info));
   llvm_info.curr_func = NULL;
 
@@ -1021,6 +1097,9 @@ restartConcur:
         }
       } else if (opc == IL_FENCE) {
         gen_llvm_fence_instruction(ilix);
+      } else if (opc == IL_PREFETCH || opc == IL_PREFETCHNTA ||
+                 opc == IL_PREFETCHT0 || opc == IL_PREFETCHW) {
+        gen_llvm_prefetch(ilix);
       } else {
         /* may be a return; otherwise mostly ignored */
         /* However, need to keep track of FREE* ili, to match them
@@ -1149,6 +1228,9 @@ restartConcur:
     print_entry_subroutine(cpu_llvm_module);
   ll_destroy_function(llvm_info.curr_func);
   llvm_info.curr_func = NULL;
+  Instructions = NULL;
+  csedList = NULL;
+  freearea(LLVM_ROUTINE_AREA);
 
   assem_data();
   assem_end();
@@ -1520,9 +1602,8 @@ char *cc_as_str[] = {CALLCONV};
 static void
 print_dbg_line_no_comma(LL_MDRef md)
 {
-  char buf[32];
-  snprintf(buf, 32, " !dbg !%u", LL_MDREF_value(md));
-  print_token(buf);
+  print_token(" !dbg !");
+  ll_putu(llvm_file(), LL_MDREF_value(md));
 }
 
 static void
@@ -1575,6 +1656,167 @@ maybe_fixup_x86_abi_return(LL_Type *sig)
 }
 #endif
 
+/* Scalar math routines that the loop vectorizer may replace with the
+   runtime's vector routines (runtime/flangrti/vmath.h).  sqrt is left out:
+   LLVM vectorizes llvm.sqrt itself. */
+static const char *vmath_roots[] = {"exp", "log", "pow", "sin",
+                                    "cos", "tanh", "erf", NULL};
+
+/**
+   \brief Root name and precision of a scalar math routine
+
+   Recognizes the names made in iliutil.c: __mth_i_[d]root,
+   __fmth_i_[d]root and __[fgpr][s]{s,d}_root[_suffix].  Returns NULL if
+   \p name is not one of them or the root has no vector version.
+ */
+static const char *
+vmath_scalar_root(const char *name, int *typec)
+{
+  const char *p;
+  int i, n;
+
+  if (strncmp(name, "__mth_i_", 8) == 0 || strncmp(name, "__fmth_i_", 9) == 0) {
+    p = name[2] == 'f' ? name + 9 : name + 8;
+    *typec = 's';
+    if (*p == 'd') {
+      *typec = 'd';
+      ++p;
+    }
+  } else if (name[0] == '_' && name[1] == '_' && name[2] &&
+             strchr("fgpr", name[2])) {
+    p = name + 3;
+    if (p[0] == 's' && (p[1] == 's' || p[1] == 'd') && p[2] == '_') {
+      *typec = p[1];
+      p += 3;
+    } else if ((p[0] == 's' || p[0] == 'd') && p[1] == '_') {
+      *typec = p[0];
+      p += 2;
+    } else {
+      return NULL;
+    }
+  } else {
+    return NULL;
+  }
+  for (i = 0; vmath_roots[i]; ++i) {
+    n = strlen(vmath_roots[i]);
+    if (strncmp(p, vmath_roots[i], n) == 0 && (p[n] == '\0' || p[n] == '_'))
+      return vmath_roots[i];
+  }
+  return NULL;
+}
+
+/**
+   \brief Declare all vector math routines the target can call
+
+   They are declared together, and kept until the loop vectorizer runs by
+   listing them in \c \@llvm.compiler.used, so that every module that uses
+   one has the same declarations.
+ */
+static void
+vmath_declare(void)
+{
+  static const int lanes[] = {2, 4, 8, 16, 0};
+  /* at most one entry per root, element type and lane count */
+  static const int max_used =
+      (sizeof(vmath_roots) / sizeof(vmath_roots[0]) - 1) * 2 *
+      (sizeof(lanes) / sizeof(lanes[0]) - 1);
+  char decl[256];
+  const char *name;
+  LL_FnProto *proto;
+  LL_Type *args[3];
+  LL_Type *fty;
+  int i, t, l, nargs;
+
+  if (vmath_used)
+    return;
+  vmath_used = (struct vmath_use *)getitem(
+      LLVM_LONGTERM_AREA, max_used * sizeof(struct vmath_use));
+  for (i = 0; vmath_roots[i]; ++i) {
+    nargs = strcmp(vmath_roots[i], "pow") == 0 ? 2 : 1;
+    for (t = 0; t < 2; ++t) {
+      for (l = 0; lanes[l]; ++l) {
+        name = vmath_name(vmath_roots[i], t ? 'd' : 's', lanes[l]);
+        if (!name)
+          continue;
+        args[0] = args[1] = args[2] = make_vector_lltype(
+            lanes[l], make_lltype_from_dtype(t ? DT_DBLE : DT_FLOAT));
+        fty = ll_create_function_type(cpu_llvm_module, args, nargs, FALSE);
+        snprintf(decl, sizeof(decl), "@%s", name);
+        proto = ll_proto_add(name, NULL);
+        if (!proto->abi && !proto->intrinsic_decl_str) {
+          ll_proto_set_intrinsic_type(name, decl, fty, TRUE);
+          snprintf(decl, sizeof(decl),
+                   "declare %s @%s(%s%s%s) nounwind readnone", args[0]->str,
+                   name, args[1]->str, nargs == 2 ? ", " : "",
+                   nargs == 2 ? args[2]->str : "");
+          ll_proto_set_intrinsic(name, decl);
+        }
+        assert(vmath_nused < max_used, "vmath_declare: too many routines",
+               vmath_nused, ERR_Fatal);
+        vmath_used[vmath_nused].name = ll_intern_namef("@%s", name);
+        vmath_used[vmath_nused++].type = fty;
+      }
+    }
+  }
+}
+
+/**
+   \brief Get the vector variants of a call to a scalar math routine
+
+   Lists the runtime's vector routines for the callee, the value of the
+   "vector-function-abi-variant" attribute that lets the loop vectorizer
+   vectorize loops that call it, or returns NULL.  Not done with -Kieee or
+   -x 223 0x1.
+ */
+static const char *
+vmath_variants(OPERAND *callee)
+{
+  static const int lanes[] = {2, 4, 8, 16, 0};
+  static char buf[1024];
+  const char *root, *vname;
+  OPERAND *arg;
+  int typec, nargs, i, n;
+
+  if (flg.ieee || XBIT(223, 0x1) ||
+      !ll_feature_vector_function_abi_variant(&cpu_llvm_module->ir))
+    return NULL;
+  if (!callee->string || callee->string[0] != '@' ||
+      !(root = vmath_scalar_root(callee->string + 1, &typec)))
+    return NULL;
+  nargs = 0;
+  for (arg = callee->next; arg; arg = arg->next)
+    ++nargs;
+  if (nargs != (strcmp(root, "pow") == 0 ? 2 : 1))
+    return NULL;
+  n = 0;
+  for (i = 0; lanes[i]; ++i) {
+    vname = vmath_name(root, typec, lanes[i]);
+    if (vname && n + strlen(callee->string) + 64 < sizeof(buf))
+      n += sprintf(buf + n, "%s_ZGV_LLVM_N%d%s_%s(%s)", n ? "," : "",
+                   lanes[i], nargs == 2 ? "vv" : "v", callee->string + 1,
+                   vname);
+  }
+  if (!n)
+    return NULL;
+  vmath_declare();
+  return buf;
+}
+
+/**
+   \brief Write the vector variants of a call to a scalar math routine
+ */
+static void
+write_vmath_variants(OPERAND *callee)
+{
+  const char *variants = vmath_variants(callee);
+
+  if (!variants)
+    return;
+  print_token(" \"vector-function-abi-variant\"=\"");
+  print_token(variants);
+  print_token("\"");
+}
+
 /**
  * \brief write \c I_CALL instruction
  * \param curr_instr  pointer to current instruction instance
@@ -1693,6 +1935,8 @@ write_I_CALL(INSTR_LIST *curr_instr, LOGICAL emit_func_signature_for_call)
     write_operands(call_op->next, 0);
     /* if no arguments, write out the parens */
     print_token(")");
+  if (simple_callee && call_op->ot_type == OT_VAR)
+    write_vmath_variants(call_op);
   if (callRequiresTrunc) {
     print_dbg_line(curr_instr->dbg_line_op);
     print_token("\n\t");
@@ -1714,6 +1958,112 @@ write_I_CALL(INSTR_LIST *curr_instr, LOGICAL emit_func_signature_for_call)
   return dbg_line_op_written;
 } /* write_I_CALL */
 
+/**
+ * \brief Encode an \c I_CALL instruction, the counterpart of write_I_CALL()
+ * \return 1 if the debug location was added, 0 otherwise
+ */
+static int
+encode_I_CALL(INSTR_LIST *curr_instr, LOGICAL emit_func_signature_for_call)
+{
+  LL_Type *return_type = curr_instr->ll_type;
+  OPERAND *call_op = curr_instr->operands;
+  OPERAND *arg;
+  LOGICAL callRequiresTrunc = FALSE;
+  LOGICAL simple_callee = TRUE;
+  LL_Type *callee_type = call_op->ll_type;
+  const char *variants;
+  char callRequiresTruncName[32];
+  BCVal callee;
+  unsigned idx;
+  int ty, res = -1;
+
+#if defined(PGFTN) && defined(TARGET_LLVM_X8664)
+  if (return_type->data_type == LL_I16) {
+    callRequiresTrunc = !XBIT(183, 0x400000);
+  }
+#endif
+  if (ll_type_is_pointer_to_function(callee_type)) {
+    callee_type = callee_type->sub_types[0];
+    if (callee_type->flags & LL_TYPE_IS_VARARGS_FUNC)
+      simple_callee = FALSE;
+    if (ll_type_is_pointer_to_function(return_type))
+      simple_callee = FALSE;
+  }
+
+  if (return_type->data_type != LL_VOID) {
+    if (callRequiresTrunc)
+      snprintf(callRequiresTruncName, 32, "%%call.%d", expr_id);
+    else
+      res = tmp_number(curr_instr->tmps);
+  }
+  if (simple_callee) {
+    /* the function type follows from the arguments */
+    ty = ll_bc_type(callRequiresTrunc ? make_lltype_from_dtype(DT_INT)
+                                      : return_type);
+  } else {
+    LL_Type *sig =
+        emit_func_signature_for_call ? callee_type : call_op->ll_type;
+    if (callRequiresTrunc)
+      sig = fixup_x86_abi_return(sig);
+    ty = ll_bc_type(sig);
+  }
+  if (call_op->ot_type == OT_CALL || call_op->ot_type == OT_DEF) {
+    if (!strncmp(call_op->string, "asm ", 4))
+      interr("bitcode output: inline assembly is not supported", 0,
+             ERR_Fatal);
+    callee = ll_bc_global(call_op->string, ll_bc_ptr_type(ty));
+  } else {
+    callee = encode_operand(call_op, 0);
+  }
+
+  ll_bc_inst(BC_CALL, ty);
+  if ((!flg.ieee || XBIT(216, 1)) && (curr_instr->flags & FAST_MATH_FLAG))
+    ll_bc_inst_fmf(BC_FAST);
+  if (curr_instr->flags & CALLCONV_MASK)
+    ll_bc_inst_cc((curr_instr->flags & CALLCONV_MASK) >> CALLCONV_SHIFT);
+  if (curr_instr->flags & FAST_CALL)
+    ll_bc_inst_cc(LL_CallConv_Fast);
+  ll_bc_operand(callee);
+  for (arg = call_op->next, idx = 1; arg; arg = arg->next, idx++) {
+    ll_bc_operand(encode_operand(arg, 0));
+    if (arg->ot_type == OT_VAR || arg->ot_type == OT_TMP) {
+      if (arg->flags & OPF_SRET_TYPE)
+        ll_bc_attr(idx, "sret");
+      if (arg->flags & OPF_SRARG_TYPE)
+        ll_bc_attr(idx, "byval");
+    }
+  }
+  if (simple_callee && call_op->ot_type == OT_VAR &&
+      (variants = vmath_variants(call_op)))
+    ll_bc_attr_str(BC_ATTR_FN, "vector-function-abi-variant", variants);
+  if (callRequiresTrunc)
+    ll_bc_result(callRequiresTruncName);
+  else if (res >= 0)
+    ll_bc_result_num(res);
+  ll_bc_end_inst();
+
+  if (callRequiresTrunc) {
+    if (!LL_MDREF_IS_NULL(curr_instr->dbg_line_op))
+      ll_bc_inst_dbg(curr_instr->dbg_line_op);
+    res = tmp_number(curr_instr->tmps);
+    ll_bc_inst(BC_CAST, ll_bc_int_type(16));
+    ll_bc_inst_sub(BC_TRUNC);
+    ll_bc_operand(ll_bc_local(callRequiresTruncName, ll_bc_int_type(32)));
+    ll_bc_result_num(res);
+    ll_bc_end_inst();
+  }
+  if (cpu_llvm_module->debug_info &&
+      ll_feature_subprogram_not_in_cu(&cpu_llvm_module->ir) &&
+      LL_MDREF_IS_NULL(curr_instr->dbg_line_op)) {
+    /* we must add a !dbg location in this case */
+    const LL_MDRef linemd = lldbg_cons_line(cpu_llvm_module->debug_info);
+    if (!LL_MDREF_IS_NULL(linemd))
+      ll_bc_inst_dbg(linemd);
+    return TRUE;
+  }
+  return FALSE;
+} /* encode_I_CALL */
+
 /**
    \brief Create the root and omnipotent pointer nodes of the TBAA tree
 
@@ -1928,6 +2278,163 @@ write_tbaa_metadata(LL_Module *mod, int ilix, OPERAND *opnd, int isVol)
   }
 }
 
+/**
+   \brief Make a loop property node, <tt>!{!"name", value}</tt>
+ */
+static LL_MDRef
+loop_property(LL_Module *module, const char *name, LL_MDRef value)
+{
+  LL_MDRef a[2];
+
+  a[0] = ll_get_md_string(module, name);
+  a[1] = value;
+  return ll_get_md_node(module, LL_PlainMDNode, a,
+                        LL_MDREF_IS_NULL(value) ? 1 : 2);
+}
+
+/**
+   \brief Attach the metadata of a loop with directives to its latch
+   \param latch  the branch instruction just added
+   \param label  the label the branch jumps to
+
+   Nothing is done unless the branch goes back to the head of a loop with a
+   set of loop pragmas.  The pragmas are translated as follows:
+
+   \li NOVECTOR, NOSIMD: llvm.loop.vectorize.width 1
+   \li VECTOR, SIMD, OpenMP SIMD: llvm.loop.vectorize.enable
+   \li NOUNROLL: llvm.loop.unroll.disable
+   \li UNROLL=n:v, UNROLL=c:v: llvm.loop.unroll.count v
+   \li IVDEP, OpenMP SIMD: the loads and stores of the loop are marked as
+   parallel accesses.  An access already marked for an inner loop keeps that
+   mark, so only the innermost of nested parallel loops is known to be
+   parallel.
+ */
+static void
+add_loop_metadata(INSTR_LIST *latch, SPTR label)
+{
+  LL_Module *module = cpu_llvm_module;
+  hash_data_t data;
+  INSTR_LIST *instr;
+  DIRSET *dirset;
+  LL_MDRef props[5], access = LL_MDREF_INITIALIZER(0, 0);
+  unsigned n = 1;
+  int count;
+  bool parallel;
+
+  if (!hashmap_erase(loopHeads, INT2HKEY(label), &data))
+    return;
+  dirset =
+      &direct.lpg.stgb[find_loop_lpprg(BIH_LINENO(ILIBLKG(label)))].dirset;
+
+  if ((dirset->x[19] & 0x18) == 0x18 || (dirset->x[19] & 0x400))
+    props[n++] = loop_property(module, "llvm.loop.vectorize.width",
+                               ll_get_md_i32(module, 1));
+  else if (dirset->x[219] & 0x3)
+    props[n++] =
+        loop_property(module, "llvm.loop.vectorize.enable", ll_get_md_i1(1));
+
+  /* The unroll counts of the routine are the defaults for all loops. */
+  if ((dirset->x[11] & 0x3) == 0x3)
+    props[n++] = loop_property(module, "llvm.loop.unroll.disable",
+                               LL_MDREF_INITIALIZER(0, 0));
+  else if ((count = dirset->x[10]) != direct.rou_begin.x[10] ||
+           (count = dirset->x[9]) != direct.rou_begin.x[9])
+    props[n++] = loop_property(module, "llvm.loop.unroll.count",
+                               ll_get_md_i32(module, count));
+
+  parallel = !dirset->depchk || (dirset->x[219] & 0x2);
+  if (parallel && ll_feature_access_groups(&module->ir)) {
+    access = ll_create_distinct_md_node(module, LL_PlainMDNode, props, 0);
+    props[n++] = loop_property(module, "llvm.loop.parallel_accesses", access);
+  }
+  if (n == 1 && !parallel)
+    return;
+
+  /* The loop identifier is a distinct node whose first element is itself. */
+  props[0] = LL_MDREF_INITIALIZER(0, 0);
+  latch->loop_md = ll_create_distinct_md_node(module, LL_PlainMDNode, props, n);
+  ll_update_md_node(module, latch->loop_md, 0, latch->loop_md);
+
+  if (parallel) {
+    if (LL_MDREF_IS_NULL(access))
+      access = latch->loop_md;
+    for (instr = (INSTR_LIST *)data; instr != latch; instr = instr->next) {
+      if ((instr->i_name == I_LOAD || instr->i_name == I_STORE) &&
+          LL_MDREF_IS_NULL(instr->loop_md))
+        instr->loop_md = access;
+    }
+  }
+}
+
+/**
+   \brief Should a vector store be non-temporal?
+   \param nme   the names entry of the store
+   \param line  the source line of the store
+
+   Yes if the pragmas that apply to the line include STREAM (XBIT(226, 0x1))
+   and not NOSTREAM, or, with XBIT(226, 0x2), if it stores to an array whose
+   constant size is at least XBIT 227 KB (default 16 MB).  Scalar stores are
+   never marked: LLVM does not vectorize a loop with a non-temporal store
+   that is not aligned to the vector, and x86 has no non-temporal scalar
+   floating point store, so the loop would only get slower.
+ */
+static bool
+stream_store(int nme, int line)
+{
+  DIRSET *dirset = find_dirset(line);
+  int sptr, numelm;
+  DTYPE dtype;
+  ISZ_T minsz;
+
+  if (dirset->x[19] & 0x40)
+    return false;
+  if (dirset->x[226] & 0x1)
+    return true;
+  if (!(dirset->x[226] & 0x2) || !(sptr = basesym_of(nme)))
+    return false;
+  dtype = DTYPEG(sptr);
+  if (DTY(dtype) != TY_ARRAY || DTY(dtype + 2) == 0)
+    return false;
+  numelm = AD_NUMELM(AD_DPTR(dtype));
+  if (!numelm || STYPEG(numelm) != ST_CONST)
+    return false;
+  minsz = dirset->x[227] > 0 ? (ISZ_T)dirset->x[227] << 10 : (ISZ_T)16 << 20;
+  return ad_val_of(numelm) * size_of(DTY(dtype + 1)) >= minsz;
+}
+
+/**
+   \brief Write the <tt>!nontemporal</tt> metadata of a store, if any
+ */
+static void
+write_nontemporal_metadata(LL_Module *module, INSTR_LIST *instr)
+{
+  LL_MDRef one;
+
+  if (!(instr->flags & NONTEMPORAL_FLAG))
+    return;
+  one = ll_get_md_i32(module, 1);
+  print_token(", !nontemporal ");
+  write_mdref(gbl.asmfil, module,
+              ll_get_md_node(module, LL_PlainMDNode, &one, 1), 1);
+}
+
+/**
+   \brief Write the loop metadata of an instruction, if any
+ */
+static void
+write_loop_metadata(LL_Module *module, INSTR_LIST *instr)
+{
+  if (LL_MDREF_IS_NULL(instr->loop_md))
+    return;
+  if (instr->i_name == I_BR)
+    print_token(", !llvm.loop ");
+  else if (ll_feature_access_groups(&module->ir))
+    print_token(", !llvm.access.group ");
+  else
+    print_token(", !llvm.mem.parallel_loop_access ");
+  write_mdref(gbl.asmfil, module, instr->loop_md, 1);
+}
+
 /**
    \brief Test for improperly constructed instruction streams
    \param insn   The instruction under the cursor
@@ -1988,10 +2495,8 @@ write_memory_order_and_alignment(INSTR_LIST *instrs)
    * log2(bytes). */
   align = LDST_BYTEALIGN(instrs->flags);
   if (align) {
-    char align_token[4];
     print_token(", align ");
-    sprintf(align_token, "%d", align);
-    print_token(align_token);
+    ll_putu(llvm_file(), align);
   }
 }
 
@@ -2338,6 +2843,7 @@ write_instructions(LL_Module *module)
 
         write_tbaa_metadata(module, instrs->ilix, instrs->operands,
                             instrs->flags & VOLATILE_FLAG);
+        write_loop_metadata(module, instrs);
         break;
       case I_STORE:
         p = instrs->operands;
@@ -2358,6 +2864,8 @@ write_instructions(LL_Module *module)
 
         write_tbaa_metadata(module, instrs->ilix, instrs->operands->next,
                             instrs->flags & VOLATILE_FLAG);
+        write_nontemporal_metadata(module, instrs);
+        write_loop_metadata(module, instrs);
         break;
       case I_BR:
         if (!INSTR_PREV(instrs) || ((INSTR_PREV(instrs)->i_name != I_RET) &&
@@ -2368,6 +2876,7 @@ write_instructions(LL_Module *module)
           print_token(llvm_instr_names[i_name]);
           print_space(1);
           write_operands(instrs->operands, 0);
+          write_loop_metadata(module, instrs);
         }
         break;
       case I_INDBR:
@@ -2640,7 +3149,7 @@ make_instr(LL_InstrName instr_name)
 {
   INSTR_LIST *iptr;
 
-  iptr = (INSTR_LIST *)getitem(LLVM_LONGTERM_AREA, sizeof(INSTR_LIST));
+  iptr = GETITEM(LLVM_ROUTINE_AREA, INSTR_LIST);
   memset(iptr, 0, sizeof(INSTR_LIST));
   iptr->i_name = instr_name;
   if (flg.debug || XBIT(120, 0x1000)) {
@@ -2676,47 +3185,367 @@ gen_instr(LL_InstrName instr_name, TMPS *tmps, LL_Type *ll_type,
   return iptr;
 }
 
+static void
+ebb_map(hashmap_t map, int key, int seq)
+{
+  hash_data_t data = INT2HKEY(seq);
+  hashmap_replace(map, EBB_KEY(key), &data);
+}
+
+static int
+ebb_find(hashmap_t map, int key)
+{
+  hash_data_t data;
+
+  if (hashmap_lookup(map, EBB_KEY(key), &data))
+    return HKEY2INT(data);
+  return -1;
+}
+
+/* Hash an operand as compared by same_op(); return false for operands that
+   never compare equal. */
+static bool
+ebb_hash_op(hash_accu_t *hacc, OPERAND *op)
+{
+  HASH_ACCU_ADD(*hacc, op->ot_type);
+  switch (op->ot_type) {
+  case OT_TMP:
+    HASH_ACCU_ADD(*hacc, (unsigned long)op->tmps);
+    return true;
+  case OT_VAR:
+    HASH_ACCU_ADD(*hacc, op->val.sptr);
+    return true;
+  case OT_CONSTVAL:
+    HASH_ACCU_ADD(*hacc, op->val.conval[0]);
+    HASH_ACCU_ADD(*hacc, op->val.conval[1]);
+    return true;
+  default:
+    return false;
+  }
+}
+
+/* Key of an instruction as matched by ad_csed_instr(): the opcode and the
+   list of operands. */
+static bool
+ebb_ops_key(INSTR_LIST *instr, hash_value_t *hash)
+{
+  hash_accu_t hacc = HASH_ACCU_INIT;
+  OPERAND *op;
+
+  HASH_ACCU_ADD(hacc, instr->i_name);
+  for (op = instr->operands; op; op = op->next) {
+    if (!ebb_hash_op(&hacc, op))
+      return false;
+  }
+  HASH_ACCU_FINISH(hacc);
+  *hash = HASH_ACCU_VALUE(hacc);
+  return true;
+}
+
+/* Key of a bitcast as matched by make_bitcast(): the operand and the result
+   type. */
+static bool
+ebb_cast_key(INSTR_LIST *instr, hash_value_t *hash)
+{
+  hash_accu_t hacc = HASH_ACCU_INIT;
+
+  if (!instr->operands || !ebb_hash_op(&hacc, instr->operands))
+    return false;
+  HASH_ACCU_ADD(hacc, (unsigned long)instr->ll_type);
+  HASH_ACCU_FINISH(hacc);
+  *hash = HASH_ACCU_VALUE(hacc);
+  return true;
+}
+
+/* The by_ops and by_cast keys are instruction numbers.  The hash values are
+   computed when an instruction is entered so that the tables stay consistent
+   if an operand list is modified later; equality always looks at the
+   current operands. */
+
+static hash_value_t
+ebb_ops_hash(hash_key_t key)
+{
+  return ebb_idx.op_hash[HKEY2INT(key) - 1];
+}
+
+static int
+ebb_ops_equals(hash_key_t key1, hash_key_t key2)
+{
+  INSTR_LIST *i1 = ebb_idx.instrs[HKEY2INT(key1) - 1];
+  INSTR_LIST *i2 = ebb_idx.instrs[HKEY2INT(key2) - 1];
+  OPERAND *op1, *op2;
+
+  if (i1->i_name != i2->i_name)
+    return 0;
+  for (op1 = i1->operands, op2 = i2->operands; op1 && op2;
+       op1 = op1->next, op2 = op2->next) {
+    if (!same_op(op1, op2))
+      return 0;
+  }
+  return op1 == NULL && op2 == NULL;
+}
+
+static hash_value_t
+ebb_cast_hash(hash_key_t key)
+{
+  return ebb_idx.cast_hash[HKEY2INT(key) - 1];
+}
+
+static int
+ebb_cast_equals(hash_key_t key1, hash_key_t key2)
+{
+  INSTR_LIST *i1 = ebb_idx.instrs[HKEY2INT(key1) - 1];
+  INSTR_LIST *i2 = ebb_idx.instrs[HKEY2INT(key2) - 1];
+
+  return strict_match(i1->ll_type, i2->ll_type) &&
+         same_op(i1->operands, i2->operands);
+}
+
+static const hash_functions_t ebb_ops_functions = {ebb_ops_hash,
+                                                   ebb_ops_equals};
+static const hash_functions_t ebb_cast_functions = {ebb_cast_hash,
+                                                    ebb_cast_equals};
+
+/** Start a new EBB index at instruction \p start, or at the start of the
+    routine if \p start is NULL. */
+static void
+ebb_idx_reset(INSTR_LIST *start)
+{
+  ebb_idx.start = start;
+  ebb_idx.last = NULL;
+  ebb_idx.ninstrs = 0;
+  ebb_idx.nwrites = 0;
+  ebb_idx.nclean = 0;
+  ebb_idx.ld_barrier = -1;
+  ebb_idx.op_barrier = -1;
+  ebb_idx.cast_barrier = -1;
+  if (hashmap_size(ebb_idx.by_ilix))
+    hashmap_clear(ebb_idx.by_ilix);
+  if (hashmap_size(ebb_idx.by_addr))
+    hashmap_clear(ebb_idx.by_addr);
+  if (hashmap_size(ebb_idx.by_nme))
+    hashmap_clear(ebb_idx.by_nme);
+  if (hashmap_size(ebb_idx.by_load))
+    hashmap_clear(ebb_idx.by_load);
+  if (hashset_size(ebb_idx.by_ops))
+    hashset_clear(ebb_idx.by_ops);
+  if (hashset_size(ebb_idx.by_cast))
+    hashset_clear(ebb_idx.by_cast);
+}
+
+/* Make room for the instruction number following the last one; it is also
+   used as the key of a search. */
+static int
+ebb_idx_slot(void)
+{
+  int seq = ebb_idx.ninstrs;
+
+  if (seq >= ebb_idx.instrs_size) {
+    int size = ebb_idx.instrs_size + 1024;
+    ebb_idx.instrs = (INSTR_LIST **)sccrelal(
+        (char *)ebb_idx.instrs, (UINT)(size * sizeof(INSTR_LIST *)));
+    ebb_idx.op_hash = (hash_value_t *)sccrelal(
+        (char *)ebb_idx.op_hash, (UINT)(size * sizeof(hash_value_t)));
+    ebb_idx.cast_hash = (hash_value_t *)sccrelal(
+        (char *)ebb_idx.cast_hash, (UINT)(size * sizeof(hash_value_t)));
+    ebb_idx.instrs_size = size;
+  }
+  return seq;
+}
+
+static void
+ebb_write(int seq, int nme)
+{
+  int n = ebb_idx.nwrites++;
+
+  NEED(ebb_idx.nwrites, ebb_idx.writes, EBB_WRITE, ebb_idx.writes_size,
+       ebb_idx.writes_size + 256);
+  ebb_idx.writes[n].seq = seq;
+  ebb_idx.writes[n].nme = nme;
+}
+
+/** Enter \p instr in the index.  The cases mirror those of the walks the
+    index replaces. */
+static void
+ebb_idx_enter(INSTR_LIST *instr)
+{
+  int seq = ebb_idx_slot();
+  hash_value_t hash;
+
+  ebb_idx.ninstrs++;
+  ebb_idx.instrs[seq] = instr;
+  if (instr->ilix)
+    ebb_map(ebb_idx.by_ilix, instr->ilix, seq);
+  if (ebb_ops_key(instr, &hash)) {
+    ebb_idx.op_hash[seq] = hash;
+    hashset_replace(ebb_idx.by_ops, INT2HKEY(seq + 1));
+  }
+
+  switch (instr->i_name) {
+  case I_LOAD:
+  case I_CMPXCHG:
+  case I_ATOMICRMW:
+  case I_FENCE:
+    if (!can_move_load_up_over_fence(instr))
+      ebb_idx.ld_barrier = seq;
+    else if (instr->i_name != I_LOAD)
+      ebb_write(seq, ILI_OPND(instr->ilix, 3));
+    break;
+  case I_STORE:
+    if (instr->ilix)
+      ebb_map(ebb_idx.by_nme, ILI_OPND(instr->ilix, 3), seq);
+    if (instr->ilix == 0 || IL_TYPE(ILI_OPC(instr->ilix)) != ILTY_STORE) {
+      ebb_idx.ld_barrier = seq;
+    } else {
+      ebb_map(ebb_idx.by_addr, ILI_OPND(instr->ilix, 2), seq);
+      ebb_write(seq, ILI_OPND(instr->ilix, 3));
+    }
+    break;
+  case I_SW:
+    ebb_idx.op_barrier = seq;
+    break;
+  case I_INVOKE:
+  case I_CALL:
+    if (!(instr->flags & FAST_CALL))
+      ebb_idx.ld_barrier = seq;
+    ebb_idx.op_barrier = seq;
+    break;
+  case I_NONE:
+  case I_BR:
+  case I_INDBR:
+    if (!ENABLE_ENHANCED_CSE_OPT) {
+      ebb_idx.ld_barrier = seq;
+      ebb_idx.op_barrier = seq;
+    }
+    ebb_idx.cast_barrier = seq;
+    break;
+  case I_BITCAST:
+    if (ebb_cast_key(instr, &hash)) {
+      ebb_idx.cast_hash[seq] = hash;
+      hashset_replace(ebb_idx.by_cast, INT2HKEY(seq + 1));
+    }
+    break;
+  default:
+    break;
+  }
+}
+
+/** Enter the instructions added since the index was last used. */
+static void
+ebb_idx_sync(void)
+{
+  INSTR_LIST *instr;
+
+  if (ebb_idx.last)
+    instr = ebb_idx.last->next;
+  else
+    instr = ebb_idx.start ? ebb_idx.start : Instructions;
+  for (; instr; instr = instr->next) {
+    ebb_idx_enter(instr);
+    ebb_idx.last = instr;
+  }
+}
+
+/** Find the latest instruction in the EBB with opcode \p instr_name and
+    operands \p operands, which ad_csed_instr() may reuse. */
+static INSTR_LIST *
+ebb_find_ops(LL_InstrName instr_name, OPERAND *operands)
+{
+  INSTR_LIST probe;
+  hash_key_t key;
+  int seq;
+
+  ebb_idx_sync();
+  probe.i_name = instr_name;
+  probe.operands = operands;
+  seq = ebb_idx_slot();
+  if (!ebb_ops_key(&probe, &ebb_idx.op_hash[seq]))
+    return NULL;
+  ebb_idx.instrs[seq] = &probe;
+  key = hashset_lookup(ebb_idx.by_ops, INT2HKEY(seq + 1));
+  if (key == NULL || HKEY2INT(key) - 1 < ebb_idx.op_barrier)
+    return NULL;
+  return ebb_idx.instrs[HKEY2INT(key) - 1];
+}
+
+/** Find the latest bitcast of \p cast_op to \p rslt_type in the EBB. */
+static INSTR_LIST *
+ebb_find_cast(OPERAND *cast_op, LL_Type *rslt_type)
+{
+  INSTR_LIST probe;
+  hash_key_t key;
+  int seq;
+
+  ebb_idx_sync();
+  probe.ll_type = rslt_type;
+  probe.operands = cast_op;
+  seq = ebb_idx_slot();
+  if (!ebb_cast_key(&probe, &ebb_idx.cast_hash[seq]))
+    return NULL;
+  ebb_idx.instrs[seq] = &probe;
+  key = hashset_lookup(ebb_idx.by_cast, INT2HKEY(seq + 1));
+  if (key == NULL || HKEY2INT(key) - 1 < ebb_idx.cast_barrier)
+    return NULL;
+  return ebb_idx.instrs[HKEY2INT(key) - 1];
+}
+
+/** Return true if a store to \p nme may change what a load from \p ld_nme
+    reads. */
+static bool
+ebb_load_conflict(int ld_nme, int nme)
+{
+  int c = enhanced_conflict(ld_nme, nme);
+  return c == SAME || (flg.depchk && c != NOCONFLICT);
+}
+
+/** Return true if a write following instruction \p seq conflicts with a
+    load from \p ld_nme.  The result of each search is kept, so that repeated
+    searches for the same names entry only look at the writes added since. */
+static bool
+ebb_written_after(int ld_nme, int seq)
+{
+  EBB_CLEAN *clean;
+  int i, n;
+
+  n = ebb_find(ebb_idx.by_load, ld_nme);
+  if (n < 0) {
+    n = ebb_idx.nclean++;
+    NEED(ebb_idx.nclean, ebb_idx.clean, EBB_CLEAN, ebb_idx.clean_size,
+         ebb_idx.clean_size + 256);
+    ebb_map(ebb_idx.by_load, ld_nme, n);
+    ebb_idx.clean[n].low = ebb_idx.ninstrs;
+  }
+  clean = &ebb_idx.clean[n];
+  if (seq < clean->low) {
+    /* the latest conflicting write is the first one found going back */
+    clean->low = seq;
+    clean->conflict = -1;
+    for (i = ebb_idx.nwrites - 1; i >= 0 && ebb_idx.writes[i].seq > seq; --i) {
+      if (ebb_load_conflict(ld_nme, ebb_idx.writes[i].nme)) {
+        clean->conflict = ebb_idx.writes[i].seq;
+        break;
+      }
+    }
+  } else {
+    for (i = clean->upto; i < ebb_idx.nwrites; ++i) {
+      if (ebb_load_conflict(ld_nme, ebb_idx.writes[i].nme))
+        clean->conflict = ebb_idx.writes[i].seq;
+    }
+  }
+  clean->upto = ebb_idx.nwrites;
+  return clean->conflict > seq;
+}
+
 static OPERAND *
 ad_csed_instr(LL_InstrName instr_name, int ilix, LL_Type *ll_type,
               OPERAND *operands, LL_InstrListFlags flags, bool do_cse)
 {
-  OPERAND *operand, *new_op;
+  OPERAND *operand;
   INSTR_LIST *instr;
   if (do_cse && ENABLE_CSE_OPT && !new_ebb) {
-    instr = llvm_info.last_instr;
-    while (instr) {
-      if (instr->i_name == instr_name) {
-        operand = instr->operands;
-        new_op = operands;
-        while (operand && new_op) {
-          if (!same_op(operand, new_op))
-            break;
-          operand = operand->next;
-          new_op = new_op->next;
-        }
-        if (operand == NULL && new_op == NULL)
-          return make_tmp_op(instr->ll_type, instr->tmps);
-      }
-      switch (instr->i_name) {
-      case I_SW:
-      case I_INVOKE:
-      case I_CALL:
-        instr = NULL;
-        break;
-      case I_BR:
-      case I_INDBR:
-      case I_NONE:
-        if (!ENABLE_ENHANCED_CSE_OPT) {
-          instr = NULL;
-          break;
-        }
-      default:
-        if (instr->flags & STARTEBB)
-          instr = NULL;
-        else
-          instr = instr->prev;
-      }
-    }
+    instr = ebb_find_ops(instr_name, operands);
+    if (instr)
+      return make_tmp_op(instr->ll_type, instr->tmps);
   }
   operand = make_tmp_op(ll_type, make_tmps());
   instr = gen_instr(instr_name, operand->tmps, ll_type, operands);
@@ -2754,6 +3583,7 @@ ad_instr(int ilix, INSTR_LIST *instr)
   if (new_ebb) {
     instr->flags |= STARTEBB;
     new_ebb = FALSE;
+    ebb_idx_reset(instr);
   }
 }
 
@@ -2887,6 +3717,11 @@ make_stmt(STMT_Type stmt_type, int ilix, LOGICAL deletable, int next_bih_label,
     process_sptr(sptr);
     Curr_Instr = gen_instr(I_NONE, NULL, NULL, make_label_op(sptr));
     ad_instr(ilix, Curr_Instr);
+    if (loop_md_enabled && ILIBLKG(sptr) &&
+        find_loop_lpprg(BIH_LINENO(ILIBLKG(sptr)))) {
+      hash_data_t head = Curr_Instr;
+      hashmap_replace(loopHeads, INT2HKEY(sptr), &head);
+    }
 
     break;
   }
@@ -2920,6 +3755,8 @@ make_stmt(STMT_Type stmt_type, int ilix, LOGICAL deletable, int next_bih_label,
         process_sptr(sptr);
         Curr_Instr = gen_instr(I_BR, NULL, NULL, make_target_op(sptr));
         ad_instr(ilix, Curr_Instr);
+        if (loop_md_enabled)
+          add_loop_metadata(Curr_Instr, sptr);
       }
     } else if (exprjump(opc) || zerojump(opc)) /* cond or zero jump */
     {
@@ -2963,6 +3800,8 @@ make_stmt(STMT_Type stmt_type, int ilix, LOGICAL deletable, int next_bih_label,
       first_label->next = second_label;
       Curr_Instr->operands->next = first_label;
       ad_instr(ilix, Curr_Instr);
+      if (loop_md_enabled)
+        add_loop_metadata(Curr_Instr, sptr);
       /* now add the label instruction */
       if (!next_bih_label)
         make_stmt(STMT_LABEL, sptr_lab, FALSE, 0, ilt);
@@ -3071,9 +3910,14 @@ make_stmt(STMT_Type stmt_type, int ilix, LOGICAL deletable, int next_bih_label,
           }
           if (int_llt)
             op1 = make_bitcast(op1, int_llt);
-          /* Clear alignment bits ==> alignment = 1 byte. */
-          if (ILI_OPC(ilix) == IL_VSTU)
+          /* Unaligned: only the element alignment is known. */
+          if (ILI_OPC(ilix) == IL_VSTU) {
             store_flags &= ~LDST_LOGALIGN_MASK;
+            store_flags |= ldst_instr_flags_from_dtype(DTY(vect_dtype + 1)) &
+                           LDST_LOGALIGN_MASK;
+          }
+          if (ilt && stream_store(nme, ILT_LINENO(ilt)))
+            store_flags |= NONTEMPORAL_FLAG;
         } else if (is_blockaddr_store(ilix, rhs_ili, lhs_ili)) {
           return;
         } else if (ILI_OPC(ilix) == IL_STSCMPLX) {
@@ -3140,10 +3984,9 @@ OPERAND *
 gen_va_start(int ilix)
 {
   OPERAND *call_op, *arg_op;
-  char *va_start_name, *gname;
+  char *va_start_name;
   int arg;
   static LOGICAL va_start_defined = FALSE;
-  EXFUNC_LIST *exfunc;
   LL_Type *expected_type;
 
   DBGTRACEIN1(" called with ilix %d\n", ilix)
@@ -3151,8 +3994,7 @@ gen_va_start(int ilix)
   call_op = make_operand();
   call_op->ot_type = OT_CALL;
   call_op->ll_type = make_void_lltype();
-  va_start_name = (char *)getitem(LLVM_LONGTERM_AREA, 17);
-  sprintf(va_start_name, "@llvm.va_start");
+  va_start_name = ll_intern_name("@llvm.va_start");
   call_op->string = va_start_name;
   arg = ILI_OPND(ilix, 2);
   assert(arg && is_argili_opcode(ILI_OPC(arg)), "gen_va_start(): bad argument",
@@ -3162,14 +4004,14 @@ gen_va_start(int ilix)
   call_op->next = arg_op;
   /* add prototype if needed */
   if (!va_start_defined) {
+    LL_Type *args[2];
+
     va_start_defined = TRUE;
-    gname = (char *)getitem(LLVM_LONGTERM_AREA, strlen(va_start_name) + 35);
-    sprintf(gname, "declare void %s(i8*)", va_start_name);
-    exfunc = (EXFUNC_LIST *)getitem(LLVM_LONGTERM_AREA, sizeof(EXFUNC_LIST));
-    memset(exfunc, 0, sizeof(EXFUNC_LIST));
-    exfunc->func_def = gname;
-    exfunc->flags |= EXF_INTRINSIC;
-    add_external_function_declaration(exfunc);
+    args[0] = make_void_lltype();
+    args[1] = make_ptr_lltype(make_int_lltype(8));
+    update_external_function_declarations(
+        va_start_name, ll_create_function_type(cpu_llvm_module, args, 1, FALSE),
+        EXF_INTRINSIC);
   }
 
   DBGTRACEOUT1(" returns operand %p", call_op)
@@ -3329,10 +4171,9 @@ OPERAND *
 gen_va_end(int ilix)
 {
   OPERAND *call_op, *arg_op;
-  char *va_end_name, *gname;
+  char *va_end_name;
   int arg;
   static LOGICAL va_end_defined = FALSE;
-  EXFUNC_LIST *exfunc;
   LL_Type *expected_type;
 
   DBGTRACEIN1(" called with ilix %d\n", ilix)
@@ -3340,8 +4181,7 @@ gen_va_end(int ilix)
   call_op = make_operand();
   call_op->ot_type = OT_CALL;
   call_op->ll_type = make_void_lltype();
-  va_end_name = (char *)getitem(LLVM_LONGTERM_AREA, 17);
-  sprintf(va_end_name, "@llvm.va_end");
+  va_end_name = ll_intern_name("@llvm.va_end");
   call_op->string = va_end_name;
   arg = ILI_OPND(ilix, 2);
   assert(arg && is_argili_opcode(ILI_OPC(arg)), "gen_va_end(): bad argument",
@@ -3351,14 +4191,14 @@ gen_va_end(int ilix)
   call_op->next = arg_op;
   /* add prototype if needed */
   if (!va_end_defined) {
+    LL_Type *args[2];
+
     va_end_defined = TRUE;
-    gname = (char *)getitem(LLVM_LONGTERM_AREA, strlen(va_end_name) + 35);
-    sprintf(gname, "declare void %s(i8*)", va_end_name);
-    exfunc = (EXFUNC_LIST *)getitem(LLVM_LONGTERM_AREA, sizeof(EXFUNC_LIST));
-    memset(exfunc, 0, sizeof(EXFUNC_LIST));
-    exfunc->func_def = gname;
-    exfunc->flags |= EXF_INTRINSIC;
-    add_external_function_declaration(exfunc);
+    args[0] = make_void_lltype();
+    args[1] = make_ptr_lltype(make_int_lltype(8));
+    update_external_function_declarations(
+        va_end_name, ll_create_function_type(cpu_llvm_module, args, 1, FALSE),
+        EXF_INTRINSIC);
   }
 
   DBGTRACEOUT1(" returns operand %p", call_op)
@@ -3378,8 +4218,7 @@ gen_call_to_builtin(int ilix, char *fname, OPERAND *params,
 
   DBGTRACEIN1(" for ilix %d\n", ilix)
 
-  intrinsic_name = (char *)getitem(LLVM_LONGTERM_AREA, strlen(fname) + 1);
-  strcpy(intrinsic_name, fname);
+  intrinsic_name = ll_intern_name(fname);
   operand = make_tmp_op(return_ll_type, make_tmps());
   if (!Call_Instr)
     Curr_Instr = make_instr(i_name);
@@ -3485,16 +4324,16 @@ void
 insert_llvm_memset(int ilix, int size, OPERAND *dest_op, int len, int value,
                    int align, int is_volatile)
 {
-  EXFUNC_LIST *exfunc;
   OPERAND *call_op;
   static LOGICAL memset_defined = FALSE;
-  char *memset_name, *gname;
+  char *memset_name;
+  char buf[32];
   INSTR_LIST *Curr_Instr;
 
   DBGTRACEIN("")
 
-  memset_name = (char *)getitem(LLVM_LONGTERM_AREA, 22);
-  sprintf(memset_name, "@llvm.memset.p0i8.i%d", size);
+  sprintf(buf, "@llvm.memset.p0i8.i%d", size);
+  memset_name = ll_intern_name(buf);
   Curr_Instr = make_instr(I_CALL);
   Curr_Instr->flags |= CALL_INTRINSIC_FLAG;
   Curr_Instr->operands = call_op = make_operand();
@@ -3514,14 +4353,18 @@ insert_llvm_memset(int ilix, int size, OPERAND *dest_op, int len, int value,
   ad_instr(ilix, Curr_Instr);
   /* add global define of llvm.memset to external function list, if needed */
   if (!memset_defined) {
+    LL_Type *args[6];
+
     memset_defined = TRUE;
-    gname = (char *)getitem(LLVM_LONGTERM_AREA, strlen(memset_name) + 45);
-    sprintf(gname, "declare void %s(i8*, i8, i%d, i32, i1)", memset_name, size);
-    exfunc = (EXFUNC_LIST *)getitem(LLVM_LONGTERM_AREA, sizeof(EXFUNC_LIST));
-    memset(exfunc, 0, sizeof(EXFUNC_LIST));
-    exfunc->func_def = gname;
-    exfunc->flags |= EXF_INTRINSIC;
-    add_external_function_declaration(exfunc);
+    args[0] = make_void_lltype();
+    args[1] = make_ptr_lltype(make_int_lltype(8));
+    args[2] = make_int_lltype(8);
+    args[3] = make_int_lltype(size);
+    args[4] = make_int_lltype(32);
+    args[5] = make_int_lltype(1);
+    update_external_function_declarations(
+        memset_name, ll_create_function_type(cpu_llvm_module, args, 5, FALSE),
+        EXF_INTRINSIC);
   }
   DBGTRACEOUT("")
 } /* insert_llvm_memset */
@@ -3530,16 +4373,16 @@ void
 insert_llvm_memcpy(int ilix, int size, OPERAND *dest_op, OPERAND *src_op,
                    int len, int align, int is_volatile)
 {
-  EXFUNC_LIST *exfunc;
   OPERAND *call_op;
   static LOGICAL memcpy_defined = FALSE;
-  char *memcpy_name, *gname;
+  char *memcpy_name;
+  char buf[32];
   INSTR_LIST *Curr_Instr;
 
   DBGTRACEIN("")
 
-  memcpy_name = (char *)getitem(LLVM_LONGTERM_AREA, 27);
-  sprintf(memcpy_name, "@llvm.memcpy.p0i8.p0i8.i%d", size);
+  sprintf(buf, "@llvm.memcpy.p0i8.p0i8.i%d", size);
+  memcpy_name = ll_intern_name(buf);
   Curr_Instr = make_instr(I_CALL);
   Curr_Instr->flags |= CALL_INTRINSIC_FLAG;
   Curr_Instr->operands = call_op = make_operand();
@@ -3557,15 +4400,17 @@ insert_llvm_memcpy(int ilix, int size, OPERAND *dest_op, OPERAND *src_op,
   ad_instr(ilix, Curr_Instr);
   /* add global define of llvm.memcpy to external function list, if needed */
   if (!memcpy_defined) {
+    LL_Type *args[6];
+
     memcpy_defined = TRUE;
-    gname = (char *)getitem(LLVM_LONGTERM_AREA, strlen(memcpy_name) + 49);
-    sprintf(gname, "declare void %s(i8*, i8*, i%d, i32, i1)", memcpy_name,
-            size);
-    exfunc = (EXFUNC_LIST *)getitem(LLVM_LONGTERM_AREA, sizeof(EXFUNC_LIST));
-    memset(exfunc, 0, sizeof(EXFUNC_LIST));
-    exfunc->func_def = gname;
-    exfunc->flags |= EXF_INTRINSIC;
-    add_external_function_declaration(exfunc);
+    args[0] = make_void_lltype();
+    args[1] = args[2] = make_ptr_lltype(make_int_lltype(8));
+    args[3] = make_int_lltype(size);
+    args[4] = make_int_lltype(32);
+    args[5] = make_int_lltype(1);
+    update_external_function_declarations(
+        memcpy_name, ll_create_function_type(cpu_llvm_module, args, 5, FALSE),
+        EXF_INTRINSIC);
   }
 
   DBGTRACEOUT("")
@@ -3581,10 +4426,8 @@ static void
 insert_llvm_dbg_declare(LL_MDRef mdnode, int sptr, LL_Type *llTy,
                         OPERAND *exprMDOp)
 {
-  EXFUNC_LIST *exfunc;
   OPERAND *call_op;
   static LOGICAL dbg_declare_defined = FALSE;
-  char *gname;
   INSTR_LIST *Curr_Instr;
 
   Curr_Instr = make_instr(I_CALL);
@@ -3613,17 +4456,21 @@ insert_llvm_dbg_declare(LL_MDRef mdnode, int sptr, LL_Type *llTy,
   /* add global define of llvm.dbg.declare to external function list, if needed
    */
   if (!dbg_declare_defined) {
+    LL_Type *args[4];
+
     dbg_declare_defined = TRUE;
-    if (ll_feature_dbg_declare_needs_expression_md(&cpu_llvm_module->ir)) {
-      gname = "declare void @llvm.dbg.declare(metadata, metadata, metadata)";
-    } else {
-      gname = "declare void @llvm.dbg.declare(metadata, metadata)";
-    }
-    exfunc = (EXFUNC_LIST *)getitem(LLVM_LONGTERM_AREA, sizeof(EXFUNC_LIST));
-    memset(exfunc, 0, sizeof(EXFUNC_LIST));
-    exfunc->func_def = gname;
-    exfunc->flags |= EXF_INTRINSIC;
-    add_external_function_declaration(exfunc);
+    args[0] = make_void_lltype();
+    args[1] = args[2] = args[3] =
+        ll_create_basic_type(cpu_llvm_module, LL_METADATA, 0);
+    update_external_function_declarations(
+        "@llvm.dbg.declare",
+        ll_create_function_type(
+            cpu_llvm_module, args,
+            ll_feature_dbg_declare_needs_expression_md(&cpu_llvm_module->ir)
+                ? 3
+                : 2,
+            FALSE),
+        EXF_INTRINSIC);
   }
 }
 
@@ -3944,6 +4791,52 @@ gen_minmax_expr(int ilix, OPERAND *op1, OPERAND *op2)
   return operand;
 }
 
+/* VBLEND mask t f: the mask is a VCMP, so compare straight to a vector of i1
+   and select from it rather than going through the sign-extended mask.
+   A mask with CSE uses keeps that vector of i1 as its cse'd operand, so
+   the blends of the later statements select from the same compare. */
+static OPERAND *
+gen_vblend_expr(int ilix)
+{
+  int cmp_ili = ILI_OPND(ilix, 1);
+  DTYPE dtype = ILI_OPND(ilix, 4);
+  LL_Type *llt = make_lltype_from_dtype(dtype);
+  OPERAND *operand, *cmp_op, **csed_operand;
+  INSTR_LIST *Curr_Instr;
+
+  DBGTRACEIN2(" ilix: %d(%s)", ilix, IL_NAME(ILI_OPC(ilix)))
+
+  while (ILI_OPC(cmp_ili) == IL_CSE)
+    cmp_ili = ILI_OPND(cmp_ili, 1);
+  assert(ILI_OPC(cmp_ili) == IL_VCMP, "gen_vblend_expr(): mask not a VCMP",
+         cmp_ili, 4);
+  csed_operand = get_csed_operand(cmp_ili);
+  if (csed_operand && *csed_operand && ILI_COUNT(cmp_ili)) {
+    cmp_op = gen_copy_op(*csed_operand);
+  } else {
+    if (IEEE_CMP)
+      float_jmp = TRUE;
+    cmp_op = gen_optext_comp_operand(make_operand(), IL_VCMP,
+                                     ILI_OPND(cmp_ili, 1), ILI_OPND(cmp_ili, 2),
+                                     ILI_OPND(cmp_ili, 3), CMP_FLT, I_FCMP, 0,
+                                     cmp_ili);
+    float_jmp = FALSE;
+    if (csed_operand) {
+      set_csed_operand(csed_operand, cmp_op);
+      ILI_COUNT(cmp_ili)++;
+    }
+  }
+  cmp_op->next = gen_llvm_expr(ILI_OPND(ilix, 2), llt);
+  cmp_op->next->next = gen_llvm_expr(ILI_OPND(ilix, 3), llt);
+  operand = make_tmp_op(llt, make_tmps());
+  Curr_Instr = gen_instr(I_SELECT, operand->tmps, operand->ll_type, cmp_op);
+  ad_instr(ilix, Curr_Instr);
+
+  DBGTRACEOUT1(" returns operand %p", operand)
+
+  return operand;
+}
+
 static OPERAND *
 gen_select_expr(int ilix)
 {
@@ -4208,14 +5101,16 @@ insertLLVMDbgValue(OPERAND *load, LL_MDRef mdnode, SPTR sptr, LL_Type *type)
   INSTR_LIST *callInsn = make_instr(I_CALL);
 
   if (!defined) {
-    EXFUNC_LIST *exfunc;
-    char *gname =
-      "declare void @llvm.dbg.value(metadata, i64, metadata, metadata)";
-    exfunc = (EXFUNC_LIST *)getitem(LLVM_LONGTERM_AREA, sizeof(EXFUNC_LIST));
-    memset(exfunc, 0, sizeof(EXFUNC_LIST));
-    exfunc->func_def = gname;
-    exfunc->flags |= EXF_INTRINSIC;
-    add_external_function_declaration(exfunc);
+    LL_Type *args[5];
+
+    args[0] = make_void_lltype();
+    args[1] = args[3] = args[4] =
+        ll_create_basic_type(cpu_llvm_module, LL_METADATA, 0);
+    args[2] = make_int_lltype(64);
+    update_external_function_declarations(
+        "@llvm.dbg.value",
+        ll_create_function_type(cpu_llvm_module, args, 4, FALSE),
+        EXF_INTRINSIC);
     defined = true;
   }
 
@@ -5050,28 +5945,12 @@ make_bitcast(OPERAND *cast_op, LL_Type *rslt_type)
   DBGDUMPLLTYPE("cast_op type ", cast_op->ll_type)
 
   if (ENABLE_CSE_OPT) {
-    instr = llvm_info.last_instr;
-    while (instr) {
-      switch (instr->i_name) {
-      case I_BR:
-      case I_INDBR:
-      case I_NONE:
-        instr = NULL;
-        break;
-      case I_BITCAST:
-        if (same_op(cast_op, instr->operands) &&
-            strict_match(rslt_type, instr->ll_type)) {
-          operand = make_tmp_op(rslt_type, instr->tmps);
-          DBGTRACEOUT1(" returns CSE'd operand %p\n", operand)
+    instr = ebb_find_cast(cast_op, rslt_type);
+    if (instr) {
+      operand = make_tmp_op(rslt_type, instr->tmps);
+      DBGTRACEOUT1(" returns CSE'd operand %p\n", operand)
 
-          return operand;
-        }
-      default:
-        if (instr->flags & STARTEBB)
-          instr = NULL;
-        else
-          instr = instr->prev;
-      }
+      return operand;
     }
   }
   Curr_Instr = gen_instr(I_BITCAST, new_tmps = make_tmps(), rslt_type, cast_op);
@@ -5359,10 +6238,11 @@ can_move_load_up_over_fence(INSTR_LIST *instr)
 static OPERAND *
 find_load_cse(int ilix, OPERAND *load_op, LL_Type *llt)
 {
-  INSTR_LIST *instr, *del_store_instr, *last_instr;
+  INSTR_LIST *instr, *del_store_instr;
   int del_store_flags;
   int ld_nme;
-  int c;
+  int lo, seq, st_seq;
+  bool from_store;
 
   if (new_ebb || (!ilix) || (IL_TYPE(ILI_OPC(ilix)) != ILTY_LOAD))
     return NULL;
@@ -5371,10 +6251,12 @@ find_load_cse(int ilix, OPERAND *load_op, LL_Type *llt)
   if (ld_nme == NME_VOL) /* don't optimize a VOLATILE load */
     return NULL;
 
+  ebb_idx_sync();
+
   /* If there is a deletable store to 'ld_nme', 'del_store_li', set
    * its 'deletable' flag to FALSE.  We do this because 'ld_ili'
    * loads from that address, so we mustn't delete the preceding
-   * store to it.  However, if the following LILI scan reaches
+   * store to it.  However, if the following search reaches
    * 'del_store_li', *and* we return the expression that is stored
    * by 'del_store_li', then we restore its 'deletable' flag, since
    * in that case the store *can* be deleted.
@@ -5383,81 +6265,42 @@ find_load_cse(int ilix, OPERAND *load_op, LL_Type *llt)
    * undeletable
    */
   del_store_instr = NULL;
-  last_instr = NULL;
-  for (instr = llvm_info.last_instr; instr; instr = instr->prev) {
-    if (instr->i_name == I_STORE) {
-      if (instr->ilix) {
-        if (ld_nme == ILI_OPND(instr->ilix, 3)) {
-          del_store_instr = instr;
-          del_store_flags = del_store_instr->flags;
-          del_store_instr->flags &= ~DELETABLE;
-          break;
-        }
-      }
-    }
-    if (instr->flags & STARTEBB) {
-      if (instr->i_name != I_NONE)
-        last_instr = instr;
-      else
-        last_instr = instr->prev;
-      break;
-    }
-  }
+  lo = (ebb_idx.start && ebb_idx.start->i_name != I_NONE) ? 1 : 0;
+  seq = ebb_find(ebb_idx.by_nme, ld_nme);
+  if (seq >= 0) {
+    del_store_instr = ebb_idx.instrs[seq];
+    del_store_flags = del_store_instr->flags;
+    del_store_instr->flags &= ~DELETABLE;
+    /* the search cannot go above a store to the same name */
+    lo = seq;
+  }
+
+  /* The value is available from the latest instruction computing 'ilix' or
+   * the latest store to its address, whichever comes last, provided no
+   * barrier or conflicting write follows it.
+   */
+  seq = ebb_find(ebb_idx.by_ilix, ilix);
+  st_seq = ebb_find(ebb_idx.by_addr, ILI_OPND(ilix, 1));
+  from_store = st_seq > seq;
+  if (from_store)
+    seq = st_seq;
+  if (seq < lo || seq < ebb_idx.ld_barrier || ebb_written_after(ld_nme, seq))
+    return NULL;
 
-  for (instr = llvm_info.last_instr; instr != last_instr; instr = instr->prev) {
-    if (instr->ilix == ilix) {
-      if (!same_op(instr->operands, load_op))
-        return NULL;
-      return make_tmp_op(instr->ll_type, instr->tmps);
-    }
-    switch (instr->i_name) {
-    case I_LOAD:
-    case I_CMPXCHG:
-    case I_ATOMICRMW:
-    case I_FENCE:
-      DEBUG_ASSERT(instr->ilix != 0 || instr->i_name == I_LOAD,
-                   "missing ilix for I_CMPXCHG, I_ATOMICRMW, or I_FENCE");
-      if (!can_move_load_up_over_fence(instr))
-        return NULL;
-      if (instr->i_name == I_LOAD)
-        break;
-      goto check_conflict;
-    case I_STORE:
-      if (instr->ilix == 0)
-        return NULL;
-      if (IL_TYPE(ILI_OPC(instr->ilix)) != ILTY_STORE)
-        return NULL;
-      if (ILI_OPND(ilix, 1) == ILI_OPND(instr->ilix, 2)) {
-        /* Maybe revisited to add conversion op */
-        if (match_types(instr->operands->ll_type, llt) != MATCH_OK)
-          return NULL;
-        if (!same_op(instr->operands->next, load_op))
-          return NULL;
-        if (instr == del_store_instr)
-          instr->flags = del_store_flags;
-        return gen_copy_op(instr->operands);
-      }
-    check_conflict:
-      c = enhanced_conflict(ld_nme, ILI_OPND(instr->ilix, 3));
-      if (c == SAME || (flg.depchk && c != NOCONFLICT))
-        return NULL;
-      break;
-    case I_INVOKE:
-    case I_CALL:
-      if (!(instr->flags & FAST_CALL))
-        return NULL;
-      break;
-    case I_NONE:
-    case I_BR:
-    case I_INDBR:
-      if (!ENABLE_ENHANCED_CSE_OPT)
-        return NULL;
-    default:
-      break;
-    }
+  instr = ebb_idx.instrs[seq];
+  if (!from_store) {
+    if (!same_op(instr->operands, load_op))
+      return NULL;
+    return make_tmp_op(instr->ll_type, instr->tmps);
   }
-
-  return NULL;
+  /* Maybe revisited to add conversion op */
+  if (match_types(instr->operands->ll_type, llt) != MATCH_OK)
+    return NULL;
+  if (!same_op(instr->operands->next, load_op))
+    return NULL;
+  if (instr == del_store_instr)
+    instr->flags = del_store_flags;
+  return gen_copy_op(instr->operands);
 }
 
 /**
@@ -6476,6 +7319,37 @@ gen_llvm_fence_instruction(int ilix)
   ad_instr(0, fence);
 }
 
+/**
+   \brief Generate a call to \c llvm.prefetch for a prefetch ILI
+
+   PREFETCHW asks for the line to be written, PREFETCHNTA for a line with
+   no temporal locality, and the other opcodes for a line kept in all
+   cache levels.  A locality given in the PREFETCH directive, passed in the
+   'stc' operand, takes precedence over the one implied by the opcode.
+ */
+static void
+gen_llvm_prefetch(int ilix)
+{
+  int flags = ILI_OPND(ilix, 2);
+  int rw = ILI_OPC(ilix) == IL_PREFETCHW;
+  int locality = ILI_OPC(ilix) == IL_PREFETCHNTA ? 0 : 3;
+  OPERAND *args;
+  INSTR_LIST *call;
+
+  if (flags & PF_HINT)
+    locality = flags & PF_HINT_MASK;
+  args = gen_llvm_expr(ILI_OPND(ilix, 1), make_lltype_from_dtype(DT_CPTR));
+  args->next = make_constval32_op(rw);
+  args->next->next = make_constval32_op(locality);
+  args->next->next->next = make_constval32_op(1); /* data cache */
+  call = make_instr(I_CALL);
+  call->flags |= CALL_INTRINSIC_FLAG;
+  call->ll_type = make_void_lltype();
+  call->operands =
+      get_intrinsic_call_ops("@llvm.prefetch", call->ll_type, args);
+  ad_instr(ilix, call);
+}
+
 static OPERAND *
 gen_llvm_cmpxchg(int ilix)
 {
@@ -6768,8 +7642,9 @@ gen_llvm_expr(int ilix, LL_Type *expected_type)
     operand = gen_address_operand(ld_ili, nme_ili, false,
                                   (int_llt ? int_llt : llt), -1);
     if (ll_type_is_mem_seq(operand->ll_type)) {
+      /* unaligned: only the element alignment is known */
       operand = make_load(ilix, operand, operand->ll_type->sub_types[0], -2,
-                          /* unaligned */ 0);
+                          ldst_instr_flags_from_dtype(DTY(vect_dtype + 1)));
       if (int_llt != NULL) {
         if (expected_type == NULL ||
             !strict_match(operand->ll_type, int_llt->sub_types[0]))
@@ -7226,6 +8101,29 @@ gen_llvm_expr(int ilix, LL_Type *expected_type)
     ad_instr(ilix, instr1);
     operand = op1;
   } break;
+  case IL_VCMP: {
+    OPERAND *op1;
+    INSTR_LIST *instr1;
+    LL_Type *viTy;
+    dtype = ILI_OPND(ilix, 4); /* get the vector dtype */
+    assert(TY_ISVECT(DTY(dtype)), "gen_llvm_expr(): expected vect type",
+           DTY(dtype), 4);
+    viTy = make_lltype_from_dtype(ili_get_vect_type(ilix));
+    if (IEEE_CMP)
+      float_jmp = TRUE;
+    operand = gen_optext_comp_operand(operand, opc, ILI_OPND(ilix, 1),
+                                      ILI_OPND(ilix, 2), ILI_OPND(ilix, 3),
+                                      CMP_FLT, I_FCMP, 0, ilix);
+    float_jmp = FALSE;
+    /* sext i1 to the integer element width */
+    op1 = make_tmp_op(viTy, make_tmps());
+    instr1 = gen_instr(I_SEXT, op1->tmps, viTy, operand);
+    ad_instr(ilix, instr1);
+    operand = op1;
+  } break;
+  case IL_VBLEND:
+    operand = gen_vblend_expr(ilix);
+    break;
   case IL_KCMPZ:
     lhs_ili = ILI_OPND(ilix, 1);
     rhs_ili = ad_kconi(0);
@@ -8238,9 +9136,9 @@ gen_optext_comp_operand(OPERAND *operand, ILI_OP opc, int lhs_ili, int rhs_ili,
   operand->tmps = make_tmps();
 
   operand->ll_type = make_int_lltype(1);
-  if (opc == IL_VCMPNEQ) {
+  if (opc == IL_VCMPNEQ || opc == IL_VCMP) {
     assert(ilix, "gen_optext_comp_operand(): missing ilix", 0, 4);
-    dtype = ILI_OPND(ilix, 3);
+    dtype = ILI_OPND(ilix, opc == IL_VCMP ? 4 : 3);
     vsize = DTY(dtype + 2);
     op_type = operand->ll_type;
     operand->ll_type = make_vector_lltype(vsize, op_type);
@@ -8251,7 +9149,7 @@ gen_optext_comp_operand(OPERAND *operand, ILI_OP opc, int lhs_ili, int rhs_ili,
       gen_instr(itype, operand->tmps, operand->ll_type, make_operand());
   Curr_Instr->operands->ot_type = OT_CC;
   Curr_Instr->operands->val.cc = pgi_to_llvm_cc(cc_ili, cc_type);
-  if (opc == IL_VCMPNEQ)
+  if (opc == IL_VCMPNEQ || opc == IL_VCMP)
     Curr_Instr->operands->ll_type = expected_type =
         make_lltype_from_dtype(dtype);
   else
@@ -8341,6 +9239,16 @@ gen_switch(int ilix)
   return instr;
 }
 
+static CSED_ITEM *
+find_csed_item(int ilix)
+{
+  hash_data_t csed;
+
+  if (hashmap_lookup(csedIndex, INT2HKEY(ilix), &csed))
+    return (CSED_ITEM *)csed;
+  return NULL;
+}
+
 static int
 add_to_cselist(int ilix)
 {
@@ -8351,17 +9259,16 @@ add_to_cselist(int ilix)
 
   DBGTRACE1("#adding to cse list ilix %d", ilix)
 
-  for (csed = csedList; csed; csed = csed->next) {
-    if (ilix == csed->ilix) {
-      DBGTRACE2("#ilix %d already in cse list, count %d", ilix, ILI_COUNT(ilix))
-      return 1;
-    }
+  if ((csed = find_csed_item(ilix)) != NULL) {
+    DBGTRACE2("#ilix %d already in cse list, count %d", ilix, ILI_COUNT(ilix))
+    return 1;
   }
-  csed = (CSED_ITEM *)getitem(LLVM_LONGTERM_AREA, sizeof(CSED_ITEM));
+  csed = GETITEM(LLVM_ROUTINE_AREA, CSED_ITEM);
   memset(csed, 0, sizeof(CSED_ITEM));
   csed->ilix = ilix;
   csed->next = csedList;
   csedList = csed;
+  hashmap_insert(csedIndex, INT2HKEY(ilix), csed);
   build_csed_list(ilix);
 
   return 0;
@@ -8405,14 +9312,12 @@ remove_from_csed_list(int ili)
   CSED_ITEM *csed;
 
   opc = ILI_OPC(ili);
-  for (csed = csedList; csed; csed = csed->next) {
-    if (is_cseili_opcode(ILI_OPC(ili)))
-      return;
-    if (ili == csed->ilix) {
-      DBGTRACE1("#remove_from_csed_list ilix(%d)", ili)
-      ILI_COUNT(ili) = 0;
-      csed->operand = NULL;
-    }
+  if (csedList != NULL && is_cseili_opcode(opc))
+    return;
+  if ((csed = find_csed_item(ili)) != NULL) {
+    DBGTRACE1("#remove_from_csed_list ilix(%d)", ili)
+    ILI_COUNT(ili) = 0;
+    csed->operand = NULL;
   }
 
   noprs = ilis[opc].oprs;
@@ -8429,21 +9334,19 @@ get_csed_operand(int ilix)
 
   if (ILI_ALT(ilix))
     ilix = ILI_ALT(ilix);
-  for (csed = csedList; csed; csed = csed->next) {
-    if (ilix == csed->ilix) {
-      OPERAND *p = csed->operand;
-
-      if (p != NULL) {
-        int sptr = p->val.sptr;
-        DBGTRACE3(
-            "#get_csed_operand for ilix %d, operand found %p, with type (%s)",
-            ilix, p, OTNAMEG(p))
-        DBGDUMPLLTYPE("cse'd operand type ", p->ll_type)
-      } else {
-        DBGTRACE1("#get_csed_operand for ilix %d, operand found is null", ilix);
-      }
-      return &csed->operand;
+  if ((csed = find_csed_item(ilix)) != NULL) {
+    OPERAND *p = csed->operand;
+
+    if (p != NULL) {
+      int sptr = p->val.sptr;
+      DBGTRACE3(
+          "#get_csed_operand for ilix %d, operand found %p, with type (%s)",
+          ilix, p, OTNAMEG(p))
+      DBGDUMPLLTYPE("cse'd operand type ", p->ll_type)
+    } else {
+      DBGTRACE1("#get_csed_operand for ilix %d, operand found is null", ilix);
     }
+    return &csed->operand;
   }
 
   DBGTRACE1("#get_csed_operand for ilix %d not found", ilix)
@@ -8459,7 +9362,7 @@ build_csed_list(int ilix)
 
   opc = ILI_OPC(ilix);
 
-  if (is_cseili_opcode(opc)) {
+  if (is_cseili_opcode(opc) || opc == IL_CSE) {
     int csed_ilix = ILI_OPND(ilix, 1);
     if (ILI_ALT(csed_ilix))
       csed_ilix = ILI_ALT(csed_ilix);
@@ -8603,17 +9506,33 @@ check_global_define(GBL_LIST *cgl)
   return FALSE;
 } /* check_global_define */
 
+/**
+   \brief Declare the intrinsic \p name of type \p func_type
+
+   The name should include the leading '@'; the pointer is kept.
+ */
 void
-update_external_function_declarations(char *decl, unsigned int flags)
+update_external_function_declarations(const char *name, LL_Type *func_type,
+                                      unsigned int flags)
 {
   EXFUNC_LIST *efl;
   char *gname;
+  int i;
 
-  gname = (char *)getitem(LLVM_LONGTERM_AREA, strlen(decl) + 1);
-  strcpy(gname, decl);
+  gname = (char *)getitem(LLVM_LONGTERM_AREA,
+                          strlen(name) + strlen(func_type->str) + 16);
+  sprintf(gname, "declare %s %s(", func_type->sub_types[0]->str, name);
+  for (i = 1; i < func_type->sub_elements; i++) {
+    if (i > 1)
+      strcat(gname, ", ");
+    strcat(gname, func_type->sub_types[i]->str);
+  }
+  strcat(gname, ")");
   efl = (EXFUNC_LIST *)getitem(LLVM_LONGTERM_AREA, sizeof(EXFUNC_LIST));
   memset(efl, 0, sizeof(EXFUNC_LIST));
   efl->func_def = gname;
+  efl->func_name = name;
+  efl->func_type = func_type;
   efl->flags |= flags;
   add_external_function_declaration(efl);
 }
@@ -8627,8 +9546,11 @@ add_external_function_declaration(EXFUNC_LIST *exfunc)
     LL_ABI_Info *abi =
         ll_abi_for_func_sptr(cpu_llvm_module, sptr, DTYPEG(sptr));
     ll_proto_add_sptr(sptr, abi);
-    if (exfunc->flags & EXF_INTRINSIC)
+    if (exfunc->flags & EXF_INTRINSIC) {
       ll_proto_set_intrinsic(ll_proto_key(sptr), exfunc->func_def);
+      ll_proto_set_intrinsic_type(ll_proto_key(sptr), exfunc->func_name,
+                                  exfunc->func_type, FALSE);
+    }
 #ifdef WEAKG
     if (WEAKG(sptr))
       ll_proto_set_weak(ll_proto_key(sptr), TRUE);
@@ -8638,6 +9560,8 @@ add_external_function_declaration(EXFUNC_LIST *exfunc)
            "Invalid external function descriptor", 0, 4);
     ll_proto_add(exfunc->func_def, NULL);
     ll_proto_set_intrinsic(exfunc->func_def, exfunc->func_def);
+    ll_proto_set_intrinsic_type(exfunc->func_def, exfunc->func_name,
+                                exfunc->func_type, FALSE);
 // get_intrin_ag(exfunc->func_def);
   }
 } /* add_external_function_declaration */
@@ -8664,20 +9588,10 @@ get_intrinsic(const char *name, LL_Type *func_type)
            "Intrinsic already declared with different signature", 0, 4);
   } else {
     /* First time we see this intrinsic. */
-    int i;
-    char *decl = (char *)getitem(LLVM_LONGTERM_AREA,
-                                 strlen(name) + strlen(func_type->str) + 50);
     if (!strncmp(name, "asm ", 4)) {
       /* do nothing - CALL asm() */
     } else {
-      sprintf(decl, "declare %s %s(", func_type->sub_types[0]->str, name);
-      for (i = 1; i < func_type->sub_elements; i++) {
-        if (i > 1)
-          strcat(decl, ", ");
-        strcat(decl, func_type->sub_types[i]->str);
-      }
-      strcat(decl, ")");
-      update_external_function_declarations(decl, EXF_INTRINSIC);
+      update_external_function_declarations(name, func_type, EXF_INTRINSIC);
       hashmap_insert(llvm_info.declared_intrinsics, name, func_type);
     }
   }
@@ -8893,8 +9807,7 @@ static int count = 0;
 static char *
 set_global_sname(int sptr, const char *name)
 {
-  SNAME(sptr) = (char *)getitem(LLVM_LONGTERM_AREA, strlen(name) + 2);
-  sprintf(SNAME(sptr), "@%s", name);
+  SNAME(sptr) = ll_intern_namef("@%s", name);
   return SNAME(sptr);
 }
 
@@ -8906,8 +9819,7 @@ set_global_sname(int sptr, const char *name)
 static char *
 set_numbered_global_sname(int sptr, const char *name)
 {
-  SNAME(sptr) = (char *)getitem(LLVM_LONGTERM_AREA, strlen(name) + 12);
-  sprintf(SNAME(sptr), "@%s.%d", name, sptr);
+  SNAME(sptr) = ll_intern_namef("@%s.%d", name, sptr);
   return SNAME(sptr);
 }
 
@@ -8918,8 +9830,7 @@ set_numbered_global_sname(int sptr, const char *name)
 static char *
 set_local_sname(int sptr, const char *name)
 {
-  SNAME(sptr) = (char *)getitem(LLVM_LONGTERM_AREA, strlen(name) + 2);
-  sprintf(SNAME(sptr), "%%%s", name);
+  SNAME(sptr) = ll_intern_namef("%%%s", name);
   return SNAME(sptr);
 }
 
@@ -9120,14 +10031,12 @@ process_blockaddr_sptr(int sptr, int label)
 
   if (SNAME(gl_sptr) == NULL) {
     LL_Type* ttype;
-    char *sname, *gname, *retc, *labelName;
+    char *gname, *retc, *labelName;
     GBL_LIST *gitem = (GBL_LIST *)getitem(LLVM_LONGTERM_AREA, sizeof(GBL_LIST));
     memset(gitem, 0, sizeof(GBL_LIST));
     gitem->sptr = gl_sptr;
 
-    sname = (char *)getitem(LLVM_LONGTERM_AREA, strlen(SYMNAME(gl_sptr)));
-    sprintf(sname, "@%s", SYMNAME(gl_sptr));
-    SNAME(gl_sptr) = sname;
+    SNAME(gl_sptr) = ll_intern_namef("@%s", SYMNAME(gl_sptr));
     ttype = make_lltype_sz4v3_from_sptr(gl_sptr);
     LLTYPE(gl_sptr) = ttype;
 
@@ -9196,8 +10105,16 @@ process_extern_function_sptr(int sptr)
   memset(exfunc, 0, sizeof(EXFUNC_LIST));
   exfunc->sptr = sptr;
   if (pgi_init_call(sptr)) {
+    LL_Type *args[3];
+
     gname = (char *)getitem(LLVM_LONGTERM_AREA, 34);
     sprintf(gname, "declare void @__c_bzero(i32, i8*)");
+    args[0] = make_void_lltype();
+    args[1] = make_int_lltype(32);
+    args[2] = make_ptr_lltype(make_int_lltype(8));
+    exfunc->func_name = "@__c_bzero";
+    exfunc->func_type =
+        ll_create_function_type(cpu_llvm_module, args, 2, FALSE);
     exfunc->flags |= EXF_INTRINSIC;
   } else {
     const int dTy =
@@ -9555,9 +10472,7 @@ process_auto_sptr(int sptr)
 static void
 process_label_sptr_c(SPTR sptr)
 {
-  const char *name = get_llvm_name(sptr);
-  SNAME(sptr) = (char *)getitem(LLVM_LONGTERM_AREA, strlen(name) + 1);
-  strcpy(SNAME(sptr), name);
+  SNAME(sptr) = ll_intern_name(get_llvm_name(sptr));
 }
 
 /**
@@ -10614,23 +11529,24 @@ _exit_gen_base_addr_operand:
   return operand;
 }
 
-void
-print_tmp_name(TMPS *t)
+/**
+   \brief Number of the temporary t, or of a fresh unnamed one if t is NULL
+ */
+int
+tmp_number(TMPS *t)
 {
-  char tmp[10];
-  int idx = 0;
-
-  if (!t) {
-    idx = ++expr_id;
-    sprintf(tmp, "%%%d", idx - 1);
-    print_token(tmp);
-    return;
-  }
-
+  if (!t)
+    return ++expr_id - 1;
   if (!t->id)
     t->id = ++expr_id;
-  sprintf(tmp, "%%%d", t->id - 1);
-  print_token(tmp);
+  return t->id - 1;
+}
+
+void
+print_tmp_name(TMPS *t)
+{
+  LL_PUTC('%', llvm_file());
+  ll_putu(llvm_file(), tmp_number(t));
 }
 
 static LOGICAL
@@ -10956,6 +11872,24 @@ write_external_function_declarations(int first_time)
   if (first_time)
     print_nl();
   ll_proto_iterate(write_extern_fndecl);
+  if (vmath_nused) {
+    char buf[32];
+    int i;
+
+    sprintf(buf, "%d", vmath_nused);
+    print_token("@llvm.compiler.used = appending global [");
+    print_token(buf);
+    print_token(" x i8*] [");
+    for (i = 0; i < vmath_nused; ++i) {
+      print_token(i ? ", i8* bitcast (" : "i8* bitcast (");
+      print_token(vmath_used[i].type->str);
+      print_token("* ");
+      print_token(vmath_used[i].name);
+      print_token(" to i8*)");
+    }
+    print_token("], section \"llvm.metadata\"");
+    print_nl();
+  }
   DBGTRACEOUT("");
 } /* write_external_function_declarations */
 
@@ -11202,6 +12136,31 @@ print_arg_attributes(LL_ABI_ArgInfo *arg)
     print_token(" inreg");
 }
 
+/**
+   \brief Can formal argument \p arg of the routine being defined be noalias?
+
+   Fortran does not allow a dummy argument that the routine modifies to be
+   referenced through any other name while the routine runs, so the
+   address passed for it is the only way the routine reaches its storage.
+   This does not hold for POINTER and TARGET dummies (those that do not
+   have NOCONFLICT set), VOLATILE and ASYNCHRONOUS dummies, descriptors and
+   the arguments of outlined routines.  -x 222 0x1 disables this.
+ */
+static bool
+formal_is_noalias(LL_ABI_ArgInfo *arg)
+{
+  SPTR sptr = arg->sptr;
+
+  if (XBIT(222, 0x1) || gbl.outlined || !sptr)
+    return false;
+  if (arg->kind == LL_ARG_BYVAL || arg->type->data_type != LL_PTR)
+    return false;
+  if (SCG(sptr) != SC_DUMMY || !NOCONFLICTG(sptr) || POINTERG(sptr))
+    return false;
+  return !VOLG(sptr) && !ASYNCG(sptr) && !DESCARRAYG(sptr) &&
+         !PASSBYVALG(sptr);
+}
+
 /**
  * \brief Print the signature of func_sptr, omitting the leading define/declare,
  * ending after the function attributes.
@@ -11268,6 +12227,8 @@ print_function_signature(int func_sptr, const char *fn_name, LL_ABI_Info *abi,
 
     print_token(arg->type->str);
     print_arg_attributes(arg);
+    if (print_arg_names && formal_is_noalias(arg))
+      print_token(" noalias");
 
     if (print_arg_names && arg->sptr) {
       int key;
@@ -11475,6 +12436,15 @@ cg_llvm_init(void)
 
   llvm_info.homed_args = hashmap_alloc(hash_functions_direct);
 
+  csedIndex = hashmap_alloc(hash_functions_direct);
+  loopHeads = hashmap_alloc(hash_functions_direct);
+  ebb_idx.by_ilix = hashmap_alloc(hash_functions_direct);
+  ebb_idx.by_addr = hashmap_alloc(hash_functions_direct);
+  ebb_idx.by_nme = hashmap_alloc(hash_functions_direct);
+  ebb_idx.by_load = hashmap_alloc(hash_functions_direct);
+  ebb_idx.by_ops = hashset_alloc(ebb_ops_functions);
+  ebb_idx.by_cast = hashset_alloc(ebb_cast_functions);
+
 #if DEBUG
   ll_dfile = gbl.dbgfil ? gbl.dbgfil : stderr;
 #endif
@@ -11528,13 +12498,15 @@ cg_llvm_init(void)
 /**
    \brief Process the end of the file (Fortran)
 
-   Dumps the metadata for the Module.
+   Dumps the metadata for the Module.  When bitcode is written, the
+   metadata is encoded from the module by ll_write_bitcode() instead.
  */
 void
 cg_llvm_end(void)
 {
   write_function_attributes();
-  ll_write_metadata(llvm_file(), cpu_llvm_module);
+  if (!XBIT(216, 0x2))
+    ll_write_metadata(llvm_file(), cpu_llvm_module);
 }
 
 /**
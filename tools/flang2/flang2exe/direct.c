@@ -24,6 +24,7 @@
 #include "global.h"
 #include "symtab.h"
 #include "direct.h"
+#include "outliner.h"
 
 #if DEBUG
 static void dmp_dirset(DIRSET *);
@@ -128,7 +129,10 @@ direct_rou_end(void)
 {
   int i;
 /* CPLUS also needs to save routine's structure: */
-  direct.lpg.avail = 1;
+  /* the routines outlined from this one come next and share its loop
+   * pragmas */
+  if (!ll_has_more_outlined())
+    direct.lpg.avail = 1;
 
   direct.rou = direct.gbl;
   direct.loop = direct.gbl;
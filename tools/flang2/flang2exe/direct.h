@@ -112,6 +112,8 @@ void push_lpprg(int);
 
 void ili_lpprg_init(void); /* ilidir.c */
 void open_pragma(int);
+int find_loop_lpprg(int);
+DIRSET *find_dirset(int);
 void close_pragma(void);
 void push_pragma(int);
 void pop_pragma(void);
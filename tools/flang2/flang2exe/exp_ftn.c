@@ -121,6 +121,69 @@ double_is_small_int(int ilix)
   }
   return ret_ili;
 }
+/* real and imaginary parts of the complex value computed by an ILM */
+static void
+cmplx_parts(int ilm, int dbl, int *re, int *im)
+{
+  int ilix;
+
+  if (ILM_RESTYPE(ilm) == ILM_ISCMPLX || ILM_RESTYPE(ilm) == ILM_ISDCMPLX) {
+    *re = ILM_RRESULT(ilm);
+    *im = ILM_IRESULT(ilm);
+    return;
+  }
+  ilix = ILM_RESULT(ilm);
+  *re = ad1ili(dbl ? IL_DCMPLX2REAL : IL_SCMPLX2REAL, ilix);
+  *im = ad1ili(dbl ? IL_DCMPLX2IMAG : IL_SCMPLX2IMAG, ilix);
+}
+
+/*
+ * Inline complex division by Smith's method.  The formulas are the ones
+ * __mth_i_cdiv and __mth_i_cddiv use: divide through by the larger of the
+ * magnitudes of the divisor's parts so that |b|**2 is never formed.  The
+ * two cases are selected rather than branched to, so that the division can
+ * be vectorized:
+ *   c = |br| <= |bi|
+ *   p, q = c ? (bi, br) : (br, bi);  u, v = c ? (ai, ar) : (ar, ai)
+ *   r = q / p;  d = 1 / (p * (1 + r*r))
+ *   re = (u + v*r) * d;  t = (v - u*r) * d;  im = c ? -t : t
+ * Not used with -Kieee or -Mx,225,1, which call the runtime routines.
+ */
+static void
+exp_smith_div(ILM *ilmp, int curilm, int dbl)
+{
+  ILI_OP mul = dbl ? IL_DMUL : IL_FMUL;
+  ILI_OP add = dbl ? IL_DADD : IL_FADD;
+  ILI_OP sel = dbl ? IL_DSELECT : IL_FSELECT;
+  int one = ad1ili(dbl ? IL_DCON : IL_FCON, dbl ? stb.dbl1 : stb.flt1);
+  int ar, ai, br, bi;
+  int c, p, q, u, v, r, d, re, im;
+
+  cmplx_parts(ILM_OPND(ilmp, 1), dbl, &ar, &ai);
+  cmplx_parts(ILM_OPND(ilmp, 2), dbl, &br, &bi);
+  c = ad3ili(dbl ? IL_DCMP : IL_FCMP, ad1ili(dbl ? IL_DABS : IL_FABS, br),
+             ad1ili(dbl ? IL_DABS : IL_FABS, bi), CC_LE);
+  /* a SELECT yields its second operand when the condition is false */
+  p = ad3ili(sel, c, br, bi);
+  q = ad3ili(sel, c, bi, br);
+  u = ad3ili(sel, c, ar, ai);
+  v = ad3ili(sel, c, ai, ar);
+  r = ad2ili(dbl ? IL_DDIV : IL_FDIV, q, p);
+  d = ad2ili(add, one, ad2ili(mul, r, r));
+  d = ad2ili(dbl ? IL_DDIV : IL_FDIV, one, ad2ili(mul, p, d));
+  re = ad2ili(mul, ad2ili(add, u, ad2ili(mul, v, r)), d);
+  im = ad2ili(mul, ad2ili(dbl ? IL_DSUB : IL_FSUB, v, ad2ili(mul, u, r)), d);
+  im = ad3ili(sel, c, im, ad1ili(dbl ? IL_DNEG : IL_FNEG, im));
+  if (XBIT(70, 0x40000000)) {
+    ILM_RESULT(curilm) =
+        ad2ili(dbl ? IL_DPDP2DCMPLX : IL_SPSP2SCMPLX, re, im);
+    return;
+  }
+  ILM_RRESULT(curilm) = re;
+  ILM_IRESULT(curilm) = im;
+  ILM_RESTYPE(curilm) = dbl ? ILM_ISDCMPLX : ILM_ISCMPLX;
+}
+
 void
 exp_ac(ILM_OP opc, ILM *ilmp, int curilm)
 {
@@ -567,6 +630,10 @@ exp_ac(ILM_OP opc, ILM *ilmp, int curilm)
   case IM_CDIV:
     {
       if (XBIT(70, 0x40000000)) {
+        if (!flg.ieee && !XBIT(225, 0x1)) {
+          exp_smith_div(ilmp, curilm, 0);
+          return;
+        }
         exp_qjsr("__mth_i_cdiv", DT_CMPLX, ilmp, curilm);
         return;
       } else {
@@ -580,6 +647,10 @@ exp_ac(ILM_OP opc, ILM *ilmp, int curilm)
           tmp = exp_mac((int)ILM_OPC(ilmp), ilmp, curilm);
           return;
         }
+        if (!flg.ieee && !XBIT(225, 0x1)) {
+          exp_smith_div(ilmp, curilm, 0);
+          return;
+        }
         exp_qjsr("__mth_i_cdiv", DT_CMPLX, ilmp, curilm);
       }
     }
@@ -587,6 +658,10 @@ exp_ac(ILM_OP opc, ILM *ilmp, int curilm)
   case IM_CDDIV:
     {
       if (XBIT(70, 0x40000000)) {
+        if (!flg.ieee && !XBIT(225, 0x1)) {
+          exp_smith_div(ilmp, curilm, 1);
+          return;
+        }
         exp_qjsr("__mth_i_cddiv", DT_DCMPLX, ilmp, curilm);
         return;
       } else {
@@ -600,6 +675,10 @@ exp_ac(ILM_OP opc, ILM *ilmp, int curilm)
           tmp = exp_mac((int)ILM_OPC(ilmp), ilmp, curilm);
           return;
         }
+        if (!flg.ieee && !XBIT(225, 0x1)) {
+          exp_smith_div(ilmp, curilm, 1);
+          return;
+        }
         exp_qjsr("__mth_i_cddiv", DT_DCMPLX, ilmp, curilm);
       }
     }
@@ -3849,7 +3928,15 @@ exp_misc(ILM_OP opc, ILM *ilmp, int curilm)
   case IM_PREFETCH:
     ilix = ILI_OF(ILM_OPND(ilmp, 1)); /* address */
     nme = NME_OF(ILM_OPND(ilmp, 1));
-    if (XBIT(39, 0x4000) && TEST_MACH(MACH_AMD_HAMMER)) {
+    tmp = ILM_OPND(ilmp, 2); /* PF_ flags */
+    if (tmp & PF_WRITE) {
+      ilix = ad3ili(IL_PREFETCHW, ilix, tmp, nme);
+    } else if (tmp & PF_HINT) {
+      if ((tmp & PF_HINT_MASK) == 0)
+        ilix = ad3ili(IL_PREFETCHNTA, ilix, tmp, nme);
+      else
+        ilix = ad3ili(IL_PREFETCHT0, ilix, tmp, nme);
+    } else if (XBIT(39, 0x4000) && TEST_MACH(MACH_AMD_HAMMER)) {
       ilix = ad3ili(IL_PREFETCHT0, ilix, 0, nme);
     } else if (TEST_MACH(MACH_AMD_HAMMER)) {
       ilix = ad3ili(IL_PREFETCHNTA, ilix, 0, NME_UNK);
@@ -15,6 +15,20 @@
  *
  */
 
+/** \file
+ * \brief Expander for the short vector (FV) ILMs.
+ *
+ * The front end lowers the body of an eligible array assignment loop to
+ * FV ILMs, each of which operates on a few consecutive array elements at
+ * a time (see vect_array_loops() in flang1).  eval_ilm() evaluates the
+ * operands of an IM_VEC ILM as usual and hands it to eval_fvec(), which
+ * builds the TY_VECT ILI (VLDU, VADD, ..., VBLEND, VSTU) that cgmain
+ * writes as LLVM vector instructions.  The vector data type comes from
+ * the leaves (FVLD, FVSPLAT), which carry the element type and the number
+ * of elements; every other FV ILM takes it from its first operand.
+ */
+
+#define EXPANDER_DECLARE_INTERNAL
 #include "gbldefs.h"
 #include "error.h"
 #include "global.h"
@@ -26,26 +40,186 @@
 #include "ili.h"
 #include "expand.h"
 #include "machar.h"
+#include "nme.h"
 
-extern void eval_ilm();
+static struct {
+  int nvstores; /* FVST ILMs expanded in the current function */
+} fvecb;
 
 void
-init_fvec()
+init_fvec(void)
 {
+  fvecb.nvstores = 0;
 }
+
 void
-fin_fvec()
+fin_fvec(void)
+{
+  if (EXPDBG(8, 2) && fvecb.nvstores)
+    fprintf(gbl.dbgfil, "%s: %d short vector stores\n", SYMNAME(gbl.currsub),
+            fvecb.nvstores);
+}
+
+/*
+ * names entry for a vector access starting at the element described by
+ * nme: an element of the same array with an unknown subscript, so that it
+ * conflicts with every element the vector covers.
+ */
+static int
+fvec_nme(int nme)
+{
+  int base = nme;
+  int sub = 0;
+
+  if (NME_TYPE(nme) == NT_ARR) {
+    base = NME_NM(nme);
+    sub = NME_SUB(nme);
+  }
+  if (!sub)
+    sub = ad_icon(0);
+  return add_arrnme(NT_ARR, -1, base, (INT)0, sub, NME_INLARR(nme));
+}
+
+/* ILI of a scalar operand with the given dtype, as a register value */
+static int
+fvec_scalar(int ilix, DTYPE dtype)
 {
+  if (DTY(dtype) == TY_FLOAT && IL_RES(ILI_OPC(ilix)) != ILIA_SP)
+    interr("eval_fvec: REAL*4 scalar expected", ilix, ERR_Severe);
+  if (DTY(dtype) == TY_DBLE && IL_RES(ILI_OPC(ilix)) != ILIA_DP)
+    interr("eval_fvec: REAL*8 scalar expected", ilix, ERR_Severe);
+  return ilix;
 }
 
-void eval_fvec(ilmx) int ilmx;
+static DTYPE
+fvec_dtype(int ilix)
 {
-  int opc;
+  DTYPE vdt = ili_get_vect_type(ilix);
 
-  opc = ILM_OPC((ILM *)(ilmb.ilm_base + ilmx));
-  if (IM_VEC(opc)) {
-    interr("eval_fvec: vector not impl", ilmx, 3);
-  } else {
+  if (!vdt)
+    interr("eval_fvec: vector operand expected", ilix, ERR_Severe);
+  return vdt;
+}
+
+void
+eval_fvec(int ilmx)
+{
+  ILM *ilmp = (ILM *)(ilmb.ilm_base + ilmx);
+  ILM_OP opc = ILM_OPC(ilmp);
+  int op1, op2, op3, nme, ilix;
+  DTYPE vdt;
+  ILI_OP iliop;
+
+  if (!IM_VEC(opc)) {
     eval_ilm(ilmx);
+    return;
+  }
+  op1 = ILM_OPND(ilmp, 1);
+  switch (opc) {
+  case IM_FVLD:
+    vdt = get_vector_type(ILM_OPND(ilmp, 2), ILM_OPND(ilmp, 3));
+    nme = fvec_nme(NME_OF(op1));
+    ilix = ad3ili(IL_VLDU, ILI_OF(op1), nme, vdt);
+    ADDRCAND(ilix, nme);
+    break;
+
+  case IM_FVST:
+    op2 = ILM_OPND(ilmp, 2);
+    vdt = fvec_dtype(ILI_OF(op2));
+    nme = fvec_nme(NME_OF(op1));
+    ilix = ad4ili(IL_VSTU, ILI_OF(op2), ILI_OF(op1), nme, vdt);
+    ADDRCAND(ilix, nme);
+    set_assn(nme);
+    chk_block(ilix);
+    ILM_BLOCK(ilmx) = expb.curbih;
+    ++fvecb.nvstores;
+    break;
+
+  case IM_FVSPLAT:
+    vdt = get_vector_type(ILM_OPND(ilmp, 2), ILM_OPND(ilmp, 3));
+    ilix = ad2ili(IL_VCVTS, fvec_scalar(ILI_OF(op1), ILM_OPND(ilmp, 2)), vdt);
+    break;
+
+  case IM_FVNEG:
+    iliop = IL_VNEG;
+    goto unary;
+  case IM_FVABS:
+    iliop = IL_VABS;
+    goto unary;
+  case IM_FVSQRT:
+    iliop = IL_VSQRT;
+    goto unary;
+  case IM_FVEXP:
+    iliop = IL_VEXP;
+    goto unary;
+  case IM_FVLOG:
+    iliop = IL_VLOG;
+    goto unary;
+  case IM_FVSIN:
+    iliop = IL_VSIN;
+    goto unary;
+  case IM_FVCOS:
+    iliop = IL_VCOS;
+    goto unary;
+  case IM_FVTANH:
+    iliop = IL_VTANH;
+  unary:
+    /* addarth() turns the transcendental ones into vector math calls */
+    vdt = fvec_dtype(ILI_OF(op1));
+    ilix = ad2ili(iliop, ILI_OF(op1), vdt);
+    break;
+
+  case IM_FVADD:
+    iliop = IL_VADD;
+    goto binary;
+  case IM_FVSUB:
+    iliop = IL_VSUB;
+    goto binary;
+  case IM_FVMUL:
+    iliop = IL_VMUL;
+    goto binary;
+  case IM_FVDIV:
+    iliop = IL_VDIV;
+    goto binary;
+  case IM_FVMIN:
+    iliop = IL_VMIN;
+    goto binary;
+  case IM_FVMAX:
+    iliop = IL_VMAX;
+    goto binary;
+  case IM_FVPOW:
+    iliop = IL_VPOW;
+  binary:
+    op2 = ILM_OPND(ilmp, 2);
+    vdt = fvec_dtype(ILI_OF(op1));
+    if (fvec_dtype(ILI_OF(op2)) != vdt)
+      interr("eval_fvec: operand vector types differ", ilmx, ERR_Severe);
+    ilix = ad3ili(iliop, ILI_OF(op1), ILI_OF(op2), vdt);
+    break;
+
+  case IM_FVCMP:
+    op2 = ILM_OPND(ilmp, 2);
+    vdt = fvec_dtype(ILI_OF(op1));
+    if (ILM_OPND(ilmp, 3) < CC_EQ || ILM_OPND(ilmp, 3) > CC_GT)
+      interr("eval_fvec: bad FVCMP relation", ilmx, ERR_Severe);
+    ilix = ad4ili(IL_VCMP, ILI_OF(op1), ILI_OF(op2), ILM_OPND(ilmp, 3), vdt);
+    break;
+
+  case IM_FVMERGE:
+    op2 = ILM_OPND(ilmp, 2);
+    op3 = ILM_OPND(ilmp, 3);
+    vdt = fvec_dtype(ILI_OF(op1));
+    ilix = ad4ili(IL_VBLEND, ILI_OF(op3), ILI_OF(op1), ILI_OF(op2), vdt);
+    /* the mask of an IF-THEN is shared by the FVMERGEs of all its
+     * assignments; the later ones use the value computed before the first
+     * store instead of comparing again */
+    if (ILI_OPC(ILI_OF(op3)) != IL_CSE)
+      ILM_RESULT(op3) = ad_cse(ILI_OF(op3));
+    break;
+
+  default:
+    interr("eval_fvec: vector ILM not cased", opc, ERR_Severe);
+    return;
   }
+  ILM_RESULT(ilmx) = ilix;
 }
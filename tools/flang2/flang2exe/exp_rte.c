@@ -41,8 +41,10 @@
 #include "rtlRtns.h"
 
 static int exp_strx(int, STRDESC *, STRDESC *);
-static int exp_strcpy(STRDESC *, STRDESC *);
+static int exp_strcpy(STRDESC *, STRDESC *, LOGICAL);
 static LOGICAL strovlp(STRDESC *, STRDESC *);
+static LOGICAL catovlp(STRDESC *, STRDESC *);
+static LOGICAL stralias(int);
 static STRDESC *getstr(int);
 static STRDESC *getstrconst(char *, int);
 static STRDESC *storechartmp(STRDESC *str, int mxlenili, int clenili);
@@ -4411,7 +4413,7 @@ exp_fstring(ILM_OP opc, ILM *ilmp, int curilm)
     }
   bldfcall:
     /* build function call */
-    ili1 = exp_strcpy(str1, str2);
+    ili1 = exp_strcpy(str1, str2, FALSE);
     iltb.callfg = 1;
     chk_block(ili1);
     return;
@@ -4660,8 +4662,13 @@ from_addr_and_length(STRDESC *s, ainfo_t *ainfo_ptr)
   arg_ar(getstraddr(s), ainfo_ptr, 0);
 }
 
+/*
+ * Store the string or concatenation str2 into str1.  nolap is TRUE if str1
+ * is known not to overlap any part of str2, e.g. a freshly allocated
+ * temporary.
+ */
 static int
-exp_strcpy(STRDESC *str1, STRDESC *str2)
+exp_strcpy(STRDESC *str1, STRDESC *str2, LOGICAL nolap)
 {
   int sym;
   STRDESC *s;
@@ -4669,19 +4676,22 @@ exp_strcpy(STRDESC *str1, STRDESC *str2)
   int ili1;
   static ainfo_t ainfo;
   char *str_copy_nm;
+  char *str_concat_nm;
   char *nstr_copy_nm;
   if (CHARLEN_64BIT) {
     str_copy_nm = mkRteRtnNm(RTE_str_copy_klen);
+    str_concat_nm = mkRteRtnNm(RTE_str_concat_klen);
     nstr_copy_nm = mkRteRtnNm(RTE_nstr_copy_klen);
   } else {
     str_copy_nm = mkRteRtnNm(RTE_str_copy);
+    str_concat_nm = mkRteRtnNm(RTE_str_concat);
     nstr_copy_nm = mkRteRtnNm(RTE_nstr_copy);
   }
 
   init_ainfo(&ainfo);
 
   if (str1->dtype == TY_CHAR) {
-    if (!strovlp(str1, str2)) {
+    if ((nolap && str2->next == NULL) || !strovlp(str1, str2)) {
 /*
  * single source, no overlap
  */
@@ -4751,6 +4761,9 @@ exp_strcpy(STRDESC *str1, STRDESC *str2)
 
   if (str1->dtype == TY_NCHAR)
     sym = frte_func(mkfunc, nstr_copy_nm);
+  else if (nolap || !catovlp(str1, str2))
+    /* concatenate directly into str1, no need to save the pieces */
+    sym = frte_func(mkfunc, str_concat_nm);
   else
     sym = frte_func(mkfunc, str_copy_nm);
   VARARGP(sym, 1);
@@ -4899,11 +4912,45 @@ strovlp(STRDESC *lhs, STRDESC *rhs)
   lsym = CONVAL1G(lhs->aval);
   if (lsym == 0)
     return TRUE;
-  if (lsym != rsym) /* lhs & rhs variables must be different */
+  if (lsym != rsym && !stralias(lsym) && !stralias(rsym))
+    /* different variables, neither of which can be associated with other
+     * storage */
     return FALSE;
   return TRUE;
 }
 
+/*
+ * Can variable sym share storage with another variable: a pointer or its
+ * pointee, a variable whose address is taken (e.g. a TARGET), or a dummy
+ * argument?
+ */
+static LOGICAL
+stralias(int sym)
+{
+  if (POINTERG(sym) || ADDRTKNG(sym) || SOCPTRG(sym))
+    return TRUE;
+  if (SCG(sym) == SC_DUMMY || SCG(sym) == SC_BASED)
+    return TRUE;
+  return FALSE;
+}
+
+/*
+ * Like strovlp, but for each piece of the concatenation rhs.
+ */
+static LOGICAL
+catovlp(STRDESC *lhs, STRDESC *rhs)
+{
+  STRDESC piece;
+
+  for (; rhs != NULL; rhs = rhs->next) {
+    piece = *rhs;
+    piece.next = NULL;
+    if (strovlp(lhs, &piece))
+      return TRUE;
+  }
+  return FALSE;
+}
+
 static char *
 getcharconst(STRDESC *str)
 {
@@ -5199,9 +5246,9 @@ storechartmp(STRDESC *str, int mxlenili, int clenili)
     chk_block(ilix);
     return (item);
   }
-  /* generate call to store str into item */
+  /* generate call to store str into item; the new temp cannot overlap it */
   iltb.callfg = 1;
-  chk_block(exp_strcpy(item, str));
+  chk_block(exp_strcpy(item, str, TRUE));
   return (item);
 }
 
@@ -148,6 +148,7 @@ exp_init()
   }
   expb.sc = SC_AUTO; /* default storage class for expander-created temps */
   exp_smp_init();
+  init_fvec();
   expb.clobber_ir = expb.clobber_pr = 0;
 }
 
@@ -406,6 +407,7 @@ expand(void)
   }
   share_proc_ili = TRUE;
   exp_smp_fini();
+  fin_fvec();
   fihb.nextftag = fihb.currftag = 0;
 
   if (!XBIT(120, 0x4000000)) {
@@ -507,6 +509,11 @@ eval_ilm(int ilmx)
     fprintf(gbl.dbgfil, "ilm %s, index %d, lineno %d\n", ilms[opcx].name, ilmx,
             gbl.lineno);
 
+  if (IM_VEC(opcx)) {
+    /* short vector ILM from an array assignment loop */
+    eval_fvec(ilmx);
+    return;
+  }
   if (!IM_SPEC(opcx))
   {
     /* expand the macro definition */
@@ -282,6 +282,7 @@ SPTR frte_func(SPTR (*)(const char *), const char *);
 void put_funccount(void);
 void replace_by_zero(ILM_OP opc, ILM *ilmp, int curilm);
 void replace_by_one(ILM_OP opc, ILM *ilmp, int curilm);
+void set_assn(int);
 int expand_narrowing(int ilix, DTYPE dtype);
 #define expand_throw_point(ilix, dtype, ili_st) \
   (DEBUG_ASSERT(0, "throw points supported only for C++"), (ilix))
@@ -296,6 +297,13 @@ void ref_threadprivate_var(int, int *, int *, int);
 int getThreadPrivateTp(int);
 void ds_init(void);
 
+/* exp_fvec.c */
+#ifdef EXPANDER_DECLARE_INTERNAL
+void init_fvec(void);
+void fin_fvec(void);
+void eval_fvec(int);
+#endif /* EXPANDER_DECLARE_INTERNAL */
+
 /* expsmp.c */
 #ifdef EXPANDER_DECLARE_INTERNAL
 void exp_smp_init(void);
@@ -167,6 +167,13 @@ extern char *getitem(int, int); /* from salloc.c: */
 #define GETITEM(area, type) (type *) getitem(area, sizeof(type))
 #define GETITEMS(area, type, n) (type *) getitem(area, (n) * sizeof(type))
 extern void freearea(int);
+typedef struct {
+  void *chunk;
+  size_t avail;
+} AREA_MARK; /* a reset point in a getitem area */
+extern AREA_MARK area_mark(int);
+extern void area_release(int, AREA_MARK);
+extern void area_report(FILE *);
 extern int put_getitem_p(void *);
 extern void *get_getitem_p(int);
 extern void free_getitem_p(void);
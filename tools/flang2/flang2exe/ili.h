@@ -364,6 +364,14 @@ typedef enum CC_RELATION {
 #define SUF_i64x2 0x1000 /*   "   "   "    "    "    "    */
 #define SUF_i64x4 0x2000 /*   "   "   "    "    "    "    */
 
+/* The following flags are used in the 'stc' operand of the PREFETCH ILM
+ * and of the PREFETCH ILIs; they match flang1's A_OPTYPE of a PREFETCH
+ * statement.
+ */
+#define PF_HINT_MASK 0x3 /* locality, as _MM_HINT_*: 0 = NTA .. 3 = T0 */
+#define PF_HINT 0x4      /* the locality was given in the directive */
+#define PF_WRITE 0x8     /* the object is also stored in the loop */
+
 /*
  * Memory reference size/type codes.
  *
@@ -519,6 +527,7 @@ int gencallargs(void);
 char *gnr_math(char *, int, int, char *, int);
 char *fast_math(char *, int, int, char *);
 char *relaxed_math(char *, int, int, char *);
+char *vmath_name(const char *, int, int);
 int mkfunc_avx(char *, int);
 void rm_smove(void);
 
@@ -146,6 +146,47 @@ find_lpprg(int line)
   return match;
 }
 
+/** \brief Find the set of loop pragmas of the loop whose DO statement is at a
+ * line number.
+ *
+ * Unlike find_lpprg(), only a set which begins at the line matches, so the
+ * loops nested in a loop with pragmas do not get its set.  Returns 0 if the
+ * loop has no set.
+ */
+int
+find_loop_lpprg(int line)
+{
+  int i;
+  LPPRG *lpprg;
+
+  if (first == 0 || line == 0)
+    return 0;
+
+  for (i = first; i < direct.lpg.avail; i++) {
+    lpprg = direct.lpg.stgb + i;
+    if (lpprg->beg_line < 0 || lpprg->beg_line > line)
+      break;
+    if (lpprg->beg_line == line)
+      return i;
+  }
+  return 0;
+}
+
+/** \brief Return the set of pragmas which applies to a line number: the set
+ * of the innermost loop with pragmas that encloses the line, or the
+ * routine's set.
+ */
+DIRSET *
+find_dirset(int line)
+{
+  int match;
+
+  match = find_lpprg(line);
+  if (match)
+    return &direct.lpg.stgb[match].dirset;
+  return &direct.rou_begin;
+}
+
 #define STK_SZ 128
 
 static int stk[STK_SZ]; /* should be dynamic ? */
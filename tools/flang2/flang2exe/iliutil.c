@@ -39,6 +39,7 @@
 #include "llassem.h"
 #include "llmputil.h"
 #include "verify.h"
+#include "flang/ADT/hash.h"
 #if DEBUG
 #include "nme.h"
 #endif
@@ -113,10 +114,62 @@ int access_swtab_case_label(int, int *, int, int);
 /*		local data			*/
 
 #define ILTABSZ 5
-#define ILHSHSZ 173
+#define ILHSHSZ 256 /* initial number of buckets; a power of 2 */
 #define MAXILIS 67108864
 
-static int ilhsh[ILTABSZ][ILHSHSZ];
+/* The ILI hash tables, one for each number of operands.  The buckets are
+ * chained through ILI_HSHLNK, and a table doubles when it holds more than
+ * two ILI per bucket.
+ */
+static struct {
+  int *bucket;
+  int size;  /* number of buckets */
+  int count; /* number of ILI in the table */
+} ilhsh[ILTABSZ];
+
+static int
+ili_hash(int opc, int noprs, const int *opnd)
+{
+  int i;
+  hash_accu_t hacc = HASH_ACCU_INIT;
+
+  HASH_ACCU_ADD(hacc, opc);
+  for (i = 0; i < noprs; i++)
+    HASH_ACCU_ADD(hacc, opnd[i]);
+  HASH_ACCU_FINISH(hacc);
+  return HASH_ACCU_VALUE(hacc);
+}
+
+/* Double the number of buckets of a hash table and rehash its ILI,
+ * keeping the order of each chain.
+ */
+static void
+grow_ili_hash(int tab)
+{
+  int *old = ilhsh[tab].bucket;
+  int oldsize = ilhsh[tab].size;
+  int size = 2 * oldsize;
+  int **tail, i, p, next, indx;
+
+  NEW(ilhsh[tab].bucket, int, size);
+  BZERO(ilhsh[tab].bucket, int, size);
+  NEW(tail, int *, size);
+  for (i = 0; i < size; i++)
+    tail[i] = &ilhsh[tab].bucket[i];
+  ilhsh[tab].size = size;
+  for (i = 0; i < oldsize; i++) {
+    for (p = old[i]; p != 0; p = next) {
+      next = ILI_HSHLNK(p);
+      indx = ili_hash(ILI_OPC(p), ilis[ILI_OPC(p)].oprs,
+                      &ILI_OPND(p, 1)) & (size - 1);
+      ILI_HSHLNK(p) = 0;
+      *tail[indx] = p;
+      tail[indx] = &ILI_HSHLNK(p);
+    }
+  }
+  FREE(tail);
+  FREE(old);
+}
 
 /* free list */
 static int free_list = 0;
@@ -131,23 +184,21 @@ static int nfree_list = 0;
 void
 ili_init(void)
 {
-  int *p, cnt;
-  static int firstcall = 1;
+  int i;
 
   EXP_ALLOC(ilib, ILI, 2048);
   BZERO(&ilib.stg_base[0], ILI, 1);
   ilib.stg_avail = 1;
-  cnt = ILHSHSZ * ILTABSZ;
   free_list = 0;
   nfree_list = 0;
 
-  if (firstcall)
-    firstcall = 0;
-  else {
-    p = (int *)ilhsh;
-    do {
-      *p++ = 0;
-    } while (--cnt > 0);
+  for (i = 0; i < ILTABSZ; i++) {
+    if (ilhsh[i].bucket == NULL) {
+      NEW(ilhsh[i].bucket, int, ILHSHSZ);
+      ilhsh[i].size = ILHSHSZ;
+    }
+    BZERO(ilhsh[i].bucket, int, ilhsh[i].size);
+    ilhsh[i].count = 0;
   }
   /* reserve ili index 1 to be the NULL ili.  done so that a traversal
    * which uses the ILI_VISIT field as a thread can use an ili (#1) to
@@ -712,6 +763,44 @@ gnr_math(char *root, int widthc, int typec, char *oldname, int masked)
 #endif
 }
 
+/*
+ * vector math library of the runtime (runtime/flangrti/vmath.h):
+ *    __fv[sd]_BASE_L
+ *   [sd]   - single/double
+ *   [L]    - vector length; 128-bit vectors, and 256-bit and 512-bit
+ *            vectors when the target has AVX2 or AVX-512F
+ * Returns NULL if the library has no such routine or -x 223 0x1 is set.
+ */
+char *
+vmath_name(const char *root, int typec, int vlen)
+{
+  static char bf[32];
+  static const char *roots[] = {"exp", "log", "pow", "sin", "cos", "sincos",
+                                "tanh", "erf", "sqrt", NULL};
+  int i, bytes;
+
+  if (XBIT(223, 0x1))
+    return NULL;
+  for (i = 0; roots[i]; ++i)
+    if (strcmp(root, roots[i]) == 0)
+      break;
+  if (!roots[i] || (typec != 's' && typec != 'd'))
+    return NULL;
+  bytes = vlen * (typec == 'd' ? 8 : 4);
+#if defined(TARGET_X8664)
+  if (bytes != 16 && !(bytes == 32 && TEST_FEATURE(FEATURE_AVX2)) &&
+      !(bytes == 64 && TEST_FEATURE(FEATURE_AVX512F)))
+    return NULL;
+#elif defined(TARGET_LLVM_ARM)
+  if (bytes != 16)
+    return NULL;
+#else
+  return NULL;
+#endif
+  sprintf(bf, "__fv%c_%s_%d", typec, root, vlen);
+  return bf;
+}
+
 static char *
 vect_math(MTH_FN fn, char *root, int nargs, int vdt, int vopc, 
           int vdt1, int vdt2)
@@ -730,7 +819,12 @@ vect_math(MTH_FN fn, char *root, int nargs, int vdt, int vopc,
     interr("vect_math: dtype is not vector", vdt, 3);
     vdt = get_vector_type(DT_DBLE, 2);
   }
-  if (XBIT_NEW_MATH_NAMES && fn != MTH_mod) {
+  typec = DTY(DTY(vdt + 1)) == TY_DBLE ? 'd' : 's';
+  if (!flg.ieee &&
+      (DTY(DTY(vdt + 1)) == TY_FLOAT || DTY(DTY(vdt + 1)) == TY_DBLE) &&
+      (func_name = vmath_name(root, typec, DTY(vdt + 2))) != NULL) {
+    ; /* the runtime's own vector routine */
+  } else if (XBIT_NEW_MATH_NAMES && fn != MTH_mod) {
     /*
      * DTY(vdt+1) -- res_dt
      * DTY(vdt+2) -- vect_len
@@ -5800,6 +5894,14 @@ printf( "iliutil.c: case IL_KISHFT:\n");
       res.numi[1] = _ipowi(con1v2, con2v2);
       goto add_icon;
     }
+/* largest constant exponent expanded to multiplies by _xpowi() */
+#define __MAXPOW 64
+    if (ncons == 2 && !XBIT(124, 0x200) && con2v2 >= 0 &&
+        con2v2 <= __MAXPOW) {
+      if (con2v2 == 0)
+        return ad_icon(1);
+      return _xpowi(op1, con2v2, IL_IMUL);
+    }
     if (ncons == 1 && con1v2 == 2) {
       tmp1 = ad_icon(1);
       tmp1 = ad2ili(IL_LSHIFT, tmp1, op2);
@@ -5818,6 +5920,12 @@ printf( "iliutil.c: case IL_KISHFT:\n");
 
 #ifdef IL_KPOWI
   case IL_KPOWI:
+    if (ncons >= 2 && !XBIT(124, 0x200) && con2v2 >= 0 &&
+        con2v2 <= __MAXPOW) {
+      if (con2v2 == 0)
+        return ad_kconi(1);
+      return _xpowi(op1, con2v2, IL_KMUL);
+    }
     if (ncons == 1 && con1v1 == 0 && con1v2 == 2) {
       tmp1 = ad_kcon(0, 1);
       tmp1 = ad2ili(IL_KLSHIFT, tmp1, op2);
@@ -5843,6 +5951,12 @@ printf( "iliutil.c: case IL_KISHFT:\n");
 
 #ifdef IL_KPOWK
   case IL_KPOWK:
+    if (ncons >= 2 && !XBIT(124, 0x200) && con2v1 == 0 && con2v2 >= 0 &&
+        con2v2 <= __MAXPOW) {
+      if (con2v2 == 0)
+        return ad_kconi(1);
+      return _xpowi(op1, con2v2, IL_KMUL);
+    }
     if (ncons == 1 && con1v1 == 0 && con1v2 == 2) {
       tmp1 = ad_kcon(0, 1);
       tmp1 = ad2ili(IL_KLSHIFT, tmp1, ad1ili(IL_KIMV, op2));
@@ -5867,7 +5981,6 @@ printf( "iliutil.c: case IL_KISHFT:\n");
 #endif
 
   case IL_FPOWI:
-#define __MAXPOW 10
     if (!flg.ieee && ncons >= 2 && !XBIT(124, 0x200)) {
       if (con2v2 == 1)
         return op1;
@@ -5875,6 +5988,11 @@ printf( "iliutil.c: case IL_KISHFT:\n");
         ilix = _xpowi(op1, con2v2, IL_FMUL);
         return ilix;
       }
+      if (con2v2 < 0 && con2v2 >= -__MAXPOW) {
+        /* x ** -n -> 1 / x ** n, as the runtime computes it */
+        ilix = _xpowi(op1, -con2v2, IL_FMUL);
+        return ad2ili(IL_FDIV, ad1ili(IL_FCON, stb.flt1), ilix);
+      }
     }
     if (XBIT_NEW_MATH_NAMES) {
       fname = make_math(MTH_powi, &funcsptr, 1, FALSE,
@@ -6006,6 +6124,11 @@ printf( "iliutil.c: case IL_KISHFT:\n");
         ilix = _xpowi(op1, con2v2, IL_DMUL);
         return ilix;
       }
+      if (con2v2 < 0 && con2v2 >= -__MAXPOW) {
+        /* x ** -n -> 1 / x ** n, as the runtime computes it */
+        ilix = _xpowi(op1, -con2v2, IL_DMUL);
+        return ad2ili(IL_DDIV, ad1ili(IL_DCON, stb.dbl1), ilix);
+      }
     }
     if (XBIT_NEW_MATH_NAMES) {
       fname = make_math(MTH_powi, &funcsptr, 1, FALSE,
@@ -6305,6 +6428,8 @@ printf( "iliutil.c: case IL_KISHFT:\n");
   case IL_VRCP:
   case IL_VRSQRT:
   case IL_VCMPNEQ:
+  case IL_VCMP:
+  case IL_VBLEND:
   case IL_VFMA1:
   case IL_VFMA2:
   case IL_VFMA3:
@@ -8044,15 +8169,10 @@ get_ili(ILI *ilip)
 {
   int i, p;
   ILI_OP opc;
-  int noprs, val, indx, tab;
-  val = opc = ilip->opc;
+  int noprs, indx, tab;
+  opc = ilip->opc;
   noprs = ilis[opc].oprs;
 
-  /* compute the hash index for this ILI  */
-
-  for (i = 0; i < noprs; i++)
-    val ^= (ilip->opnd[i] >> (i * 4));
-  indx = val % ILHSHSZ;
   /*
    * calculate which hash table to use which is based on the number of
    * operands
@@ -8060,9 +8180,14 @@ get_ili(ILI *ilip)
 
   assert(noprs <= ILTABSZ, "get_ili: noprs > ILTABSZ", opc, 3);
   tab = (noprs == 0) ? 0 : noprs - 1;
+
+  /* compute the hash index for this ILI  */
+
+  indx = ili_hash(opc, noprs, ilip->opnd) & (ilhsh[tab].size - 1);
+
   /* search the hash links for this ILI  */
 
-  for (p = ilhsh[tab][indx]; p != 0; p = ILI_HSHLNK(p)) {
+  for (p = ilhsh[tab].bucket[indx]; p != 0; p = ILI_HSHLNK(p)) {
     if (opc == ILI_OPC(p)) {
       for (i = 1; i <= noprs; i++)
         if (ilip->opnd[i - 1] != ILI_OPND(p, i))
@@ -8110,8 +8235,10 @@ get_ili(ILI *ilip)
   }
 #endif
 
-  ILI_HSHLNK(p) = ilhsh[tab][indx];
-  ilhsh[tab][indx] = p;
+  ILI_HSHLNK(p) = ilhsh[tab].bucket[indx];
+  ilhsh[tab].bucket[indx] = p;
+  if (++ilhsh[tab].count > 2 * ilhsh[tab].size)
+    grow_ili_hash(tab);
 /*
  * Initialize nonzero fields of the ili - (here and in new_ili()).
  */
@@ -8239,14 +8366,15 @@ void garbage_collect(void (*mark_function)())
    * marked reachable, putting the freed ili on the linked list.
    */
   for (i = 0; i < ILTABSZ; ++i)
-    for (j = 0; j < ILHSHSZ; ++j) {
+    for (j = 0; j < ilhsh[i].size; ++j) {
       q = 0;
-      for (p = ilhsh[i][j]; p != 0;) {
+      for (p = ilhsh[i].bucket[j]; p != 0;) {
         if (ILI_VISIT(p) == GARB_UNREACHABLE) {
           /* unreachable */
           ILI_VISIT(p) = GARB_COLLECTED;
+          --ilhsh[i].count;
           if (q == 0)
-            ilhsh[i][j] = ILI_HSHLNK(p);
+            ilhsh[i].bucket[j] = ILI_HSHLNK(p);
           else
             ILI_HSHLNK(q) = ILI_HSHLNK(p);
           t = p;
@@ -9795,8 +9923,8 @@ dmpili(void)
   if (DBGBIT(10, 1))
     for (i = 0; i < ILTABSZ; i++) {
       fprintf(gbl.dbgfil, "\n\n***** ILI Hash Table%2d *****\n", i);
-      for (j = 0; j < ILHSHSZ; j++)
-        if ((opn = ilhsh[i][j]) != 0) {
+      for (j = 0; j < ilhsh[i].size; j++)
+        if ((opn = ilhsh[i].bucket[j]) != 0) {
           tmp = 0;
           fprintf(gbl.dbgfil, "%3d.", j);
           for (; opn != 0; opn = ILI_HSHLNK(opn)) {
@@ -11261,8 +11389,15 @@ ili_get_vect_type(int ilix)
   case IL_VDPOWIS:
   case IL_VATAN2:
     return ILI_OPND(ilix, 3);
+  case IL_VCMP: {
+    /* the mask has integer elements as wide as the compared ones */
+    DTYPE dt = ILI_OPND(ilix, 4);
+    return get_vector_type(size_of(DTY(dt + 1)) == 8 ? DT_INT8 : DT_INT,
+                           DTY(dt + 2));
+  }
   case IL_VST:
   case IL_VSTU:
+  case IL_VBLEND:
   case IL_VFMA1:
   case IL_VFMA2:
   case IL_VFMA3:
@@ -11372,8 +11507,46 @@ _ipowi(int x, int i)
   }
 }
 
-/** Raising an operand to a constant power >= 1.  generate ILI which maximize
- * cse's (i.e., generate a balanced tree).
+/* Knuth's power tree: powtree[n] is the parent p of n in the tree, and n - p
+ * is on the path from the root 1 to p.  The path to n is a shortest
+ * addition chain for every n <= 76.
+ */
+static unsigned char powtree[__MAXPOW + 1];
+
+static void
+init_powtree(void)
+{
+  int level[__MAXPOW + 1], next[__MAXPOW + 1], path[__MAXPOW + 1];
+  int nlevel, nnext, npath, i, j, k, m;
+
+  level[0] = 1;
+  nlevel = 1;
+  powtree[1] = 1;
+  while (nlevel) {
+    nnext = 0;
+    for (i = 0; i < nlevel; ++i) {
+      /* the path from the root to level[i], root first */
+      npath = 0;
+      for (k = level[i]; k != 1; k = powtree[k])
+        path[npath++] = k;
+      path[npath++] = 1;
+      for (j = npath - 1; j >= 0; --j) {
+        m = level[i] + path[j];
+        if (m <= __MAXPOW && !powtree[m]) {
+          powtree[m] = level[i];
+          next[nnext++] = m;
+        }
+      }
+    }
+    for (i = 0; i < nnext; ++i)
+      level[i] = next[i];
+    nlevel = nnext;
+  }
+}
+
+/** Raising an operand to a constant power, 1 <= pwr <= __MAXPOW, with the
+ * fewest multiplies: the ILI follow the power tree's addition chain for
+ * pwr, and ILI sharing makes every power on the chain a single multiply.
  *
  * - opn -- operand (ILI) raised to power 'pwd'
  * -  pwr -- power (constant)
@@ -11382,33 +11555,14 @@ _ipowi(int x, int i)
 static int
 _xpowi(int opn, int pwr, ILI_OP opc)
 {
-  int res;
-  int p2; /* largest power of 2 such that 2**p2 <= opn**pwr */
-  int n;
-
-  if (pwr >= 2) {
-    p2 = 0;
-    n = pwr;
-    while ((n >>= 1) > 0)
-      p2++;
+  int p;
 
-    n = 1 << p2; /* 2**p2 */
-    res = opn;
-    /* generate a balanced multiply tree whose height is p2 */
-    while (p2-- > 0)
-      res = ad2ili(opc, res, res);
-
-    /* residual */
-    n = pwr - n;
-    if (n > 0) {
-      int right;
-      right = _xpowi(opn, n, opc);
-      res = ad2ili(opc, res, right);
-    }
-
-    return res;
-  }
-  return opn;
+  if (pwr <= 1)
+    return opn;
+  if (!powtree[1])
+    init_powtree();
+  p = powtree[pwr];
+  return ad2ili(opc, _xpowi(opn, p, opc), _xpowi(opn, pwr - p, opc));
 }
 
 #if defined(TARGET_X8664) || defined(TARGET_POWER) || defined(TARGET_ARM64)
@@ -0,0 +1,3617 @@
+/*
+ * Copyright (c) 2017, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/** \file
+ * \brief Write the LLVM module as bitcode
+ *
+ * With XBIT(216, 0x2) flang2 writes an LLVM bitcode file instead of LLVM
+ * assembly, so that the tools run after flang2 do not have to parse the IR
+ * text again.
+ *
+ * Every writer of cgmain.c, llassem.c and the other modules that prints a
+ * part of the module has an encode_* counterpart that enters the same
+ * types, constants, globals and instructions here through the ll_bc_*
+ * functions of ll_bitcode.h, while the routines are compiled.  The model
+ * is compact: interned types and constants, globals in the order of their
+ * definitions, and the instructions of the function bodies with their
+ * operands.  The metadata stays in the LL_Module; at the end of the file
+ * ll_write_bitcode() encodes the model together with the metadata nodes.
+ *
+ * The encoding is the LLVM 4.0 bitcode format: module version 1 (relative
+ * value ids, names in value symbol tables), unabbreviated records only.
+ * Later LLVM releases read this format as well.
+ */
+
+#include "gbldefs.h"
+#include "error.h"
+#include "global.h"
+#include "ll_structure.h"
+#include "ll_bitcode.h"
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+/*
+ * Bitstream
+ */
+
+/* block ids */
+#define BLK_MODULE 8
+#define BLK_PARAMATTR 9
+#define BLK_PARAMATTR_GROUP 10
+#define BLK_CONSTANTS 11
+#define BLK_FUNCTION 12
+#define BLK_IDENTIFICATION 13
+#define BLK_VALUE_SYMTAB 14
+#define BLK_METADATA 15
+#define BLK_METADATA_ATTACHMENT 16
+#define BLK_TYPE 17
+#define BLK_METADATA_KIND 22
+
+/* abbreviation ids */
+#define ABBR_END_BLOCK 0
+#define ABBR_ENTER_SUBBLOCK 1
+#define ABBR_UNABBREV_RECORD 3
+
+#define ABBR_WIDTH 3
+#define MAX_BLOCK_DEPTH 8
+
+static struct {
+  unsigned char *buf;
+  int len, size;
+  BIGUINT64 cur; /* bits not yet in buf, low bit first */
+  int nbits;
+  int width;     /* abbreviation id width of the current block */
+  int depth;
+  int blkpos[MAX_BLOCK_DEPTH];
+  int blkwidth[MAX_BLOCK_DEPTH];
+} bs;
+
+/* operands of the record being built */
+static BIGUINT64 *rec;
+static int nrec, rec_size;
+
+static void
+bs_word(unsigned w)
+{
+  NEED(bs.len + 4, bs.buf, unsigned char, bs.size, bs.size * 2 + 65536);
+  bs.buf[bs.len] = w;
+  bs.buf[bs.len + 1] = w >> 8;
+  bs.buf[bs.len + 2] = w >> 16;
+  bs.buf[bs.len + 3] = w >> 24;
+  bs.len += 4;
+}
+
+static void
+bs_emit(unsigned val, int n)
+{
+  bs.cur |= (BIGUINT64)val << bs.nbits;
+  bs.nbits += n;
+  if (bs.nbits >= 32) {
+    bs_word((unsigned)bs.cur);
+    bs.cur >>= 32;
+    bs.nbits -= 32;
+  }
+}
+
+static void
+bs_vbr(BIGUINT64 val, int n)
+{
+  BIGUINT64 hi = (BIGUINT64)1 << (n - 1);
+
+  while (val >= hi) {
+    bs_emit((unsigned)((val & (hi - 1)) | hi), n);
+    val >>= n - 1;
+  }
+  bs_emit((unsigned)val, n);
+}
+
+static void
+bs_align32(void)
+{
+  if (bs.nbits) {
+    bs_word((unsigned)bs.cur);
+    bs.cur = 0;
+    bs.nbits = 0;
+  }
+}
+
+static void
+bs_enter(int id)
+{
+  bs_emit(ABBR_ENTER_SUBBLOCK, bs.width);
+  bs_vbr(id, 8);
+  bs_vbr(ABBR_WIDTH, 4);
+  bs_align32();
+  assert(bs.depth < MAX_BLOCK_DEPTH, "bs_enter: blocks nested too deep", id,
+         ERR_Fatal);
+  bs.blkpos[bs.depth] = bs.len;
+  bs.blkwidth[bs.depth] = bs.width;
+  bs.depth++;
+  bs_word(0); /* block length, patched by bs_exit */
+  bs.width = ABBR_WIDTH;
+}
+
+static void
+bs_exit(void)
+{
+  int pos;
+  unsigned words;
+
+  bs_emit(ABBR_END_BLOCK, bs.width);
+  bs_align32();
+  pos = bs.blkpos[--bs.depth];
+  words = (bs.len - pos - 4) / 4;
+  bs.buf[pos] = words;
+  bs.buf[pos + 1] = words >> 8;
+  bs.buf[pos + 2] = words >> 16;
+  bs.buf[pos + 3] = words >> 24;
+  bs.width = bs.blkwidth[bs.depth];
+}
+
+static void
+rec_push(BIGUINT64 v)
+{
+  NEED(nrec + 1, rec, BIGUINT64, rec_size, rec_size * 2 + 64);
+  rec[nrec++] = v;
+}
+
+/* push a signed value in sign-rotated form */
+static void
+rec_push_signed(BIGINT64 v)
+{
+  if (v >= 0)
+    rec_push((BIGUINT64)v << 1);
+  else
+    rec_push(((BIGUINT64)-v << 1) | 1);
+}
+
+static void
+rec_push_chars(const char *s, int len)
+{
+  int i;
+
+  for (i = 0; i < len; i++)
+    rec_push((unsigned char)s[i]);
+}
+
+/* Write the pending operands as an unabbreviated record */
+static void
+rec_emit(int code)
+{
+  int i;
+
+  bs_emit(ABBR_UNABBREV_RECORD, bs.width);
+  bs_vbr(code, 6);
+  bs_vbr(nrec, 6);
+  for (i = 0; i < nrec; i++)
+    bs_vbr(rec[i], 6);
+  nrec = 0;
+}
+
+/*
+ * In-memory form of the module
+ */
+
+typedef enum BCTypeKind {
+  BT_VOID,
+  BT_HALF,
+  BT_FLOAT,
+  BT_DOUBLE,
+  BT_X86_FP80,
+  BT_FP128,
+  BT_PPC_FP128,
+  BT_LABEL,
+  BT_METADATA,
+  BT_INT,
+  BT_PTR,
+  BT_ARRAY,
+  BT_VECTOR,
+  BT_STRUCT,
+  BT_NAMED,
+  BT_FUNC
+} BCTypeKind;
+
+/* A type.  Pointers, arrays and vectors have their element type in sub;
+   structs and function types have n element types in tpool[sub ...], the
+   return type first for functions. */
+typedef struct BCType {
+  unsigned char kind;
+  unsigned char packed;
+  unsigned char vararg;
+  unsigned char state; /* named structs: 0 undefined, 1 opaque, 2 body */
+  unsigned n;          /* int width, address space, element count */
+  BIGUINT64 count;     /* array and vector length */
+  int sub;
+  const char *name;
+  int id;              /* position in the bitcode type table */
+} BCType;
+
+typedef enum BCValKind {
+  V_NONE,
+  V_GLOBAL, /* idx into globals */
+  V_CONST,  /* idx into consts */
+  V_LOCAL,  /* idx into slots: argument or instruction result */
+  V_BB,     /* idx into slots: basic block */
+  V_MD,     /* idx is the metadata node number, !1 is 1 */
+  V_MDVAL,  /* idx into mdvals: constant or global used as metadata */
+  V_LMD,    /* idx into lmds: function-local value used as metadata */
+  V_IMM     /* idx is an immediate operand */
+} BCValKind;
+
+typedef enum BCConstKind {
+  C_INT,
+  C_WIDE,
+  C_FP,
+  C_NULL,
+  C_UNDEF,
+  C_AGG,
+  C_STR,
+  C_CAST,
+  C_GEP,
+  C_BLOCKADDR
+} BCConstKind;
+
+/* A constant.  Aggregates and expressions have n operands in
+   vpool[sub ...]; strings have n bytes at str, the address of a block has
+   its label there. */
+typedef struct BCConst {
+  unsigned char kind;
+  unsigned char opc;   /* cast opcode, inbounds */
+  int type;
+  int n;
+  int sub;
+  int srcty; /* source element type of getelementptr */
+  const char *str;
+  BIGUINT64 v[2];
+  int id;
+} BCConst;
+
+typedef enum BCGlobalKind { G_UNDEF, G_VAR, G_FUNC, G_ALIAS } BCGlobalKind;
+
+typedef struct BCGlobal {
+  const char *name;
+  unsigned char kind;
+  unsigned char linkage;
+  unsigned char isconst;
+  unsigned char tls;
+  unsigned char unnamed;
+  unsigned char visibility;
+  unsigned char dll;
+  unsigned char extinit;
+  int type; /* value type of variables and aliases, function type */
+  int addrspace;
+  int align;
+  int section;
+  int cc;
+  int attrs; /* attribute spec, then attribute list id */
+  int ptrty; /* type of the global as a value */
+  BCVal init; /* initializer or aliasee */
+  int body;   /* index into funcs, -1 for a declaration */
+  int att, natt; /* metadata attachments in gatts */
+  int id;
+} BCGlobal;
+
+typedef enum BCSlotKind { SL_USED, SL_BBUSED, SL_VAL, SL_BB } BCSlotKind;
+
+/* A local name: argument, instruction result or basic block */
+typedef struct BCSlot {
+  const char *name; /* NULL for numbered values */
+  unsigned char kind;
+  int id; /* value id, or basic block number */
+} BCSlot;
+
+typedef struct BCInst {
+  unsigned char op;
+  unsigned char sub;   /* opcode, predicate, atomicrmw operation */
+  unsigned char flags; /* BC_ flags, or wrap/exact flags of binops */
+  unsigned char fmf;   /* fast-math flags */
+  unsigned char align; /* log2(alignment) + 1, 0 if unspecified */
+  unsigned char ord;   /* atomic ordering */
+  unsigned char ord2;  /* cmpxchg failure ordering */
+  int ty;   /* result type, allocated type, explicit type */
+  int res;  /* result slot, -1 if none */
+  int op0, nop; /* operands in opool */
+  int dbg;      /* !dbg metadata node number, 0 if none */
+  int attrs;    /* call attributes */
+  int cc;
+  int value;    /* produces a value */
+} BCInst;
+
+typedef struct BCFunc {
+  int g;
+  int slot0, nslots;
+  int nargs; /* the arguments are the first nargs slots */
+  int inst0, ninst;
+  int nbb;
+  int lmd0, nlmd;
+  int att0, natt;
+} BCFunc;
+
+/* metadata attachment */
+typedef struct BCAtt {
+  int inst; /* instruction index, -1 for the function */
+  int kind;
+  int node;
+} BCAtt;
+
+/* attribute */
+#define AK_ENUM 0
+#define AK_INT 1
+#define AK_STR 3
+#define AK_STRVAL 4
+
+typedef struct BCAttr {
+  unsigned idx; /* BC_ATTR_FN, 0 for the return value, i for parameter i */
+  unsigned char kind;
+  unsigned id;
+  BIGUINT64 val;
+  const char *key, *value;
+} BCAttr;
+
+/* the attributes written with a function or call */
+typedef struct BCAttrSpec {
+  int a0, na;
+} BCAttrSpec;
+
+/* attribute group: the attributes of one index */
+typedef struct BCAttrGrp {
+  unsigned idx;
+  int a0, na; /* in sattrs */
+} BCAttrGrp;
+
+/* attribute list: the groups of a function or call */
+typedef struct BCAttrList {
+  int g0, ng; /* in lgrps */
+} BCAttrList;
+
+#define DEFINE_ARRAY(T, name)                                                  \
+  static T *name;                                                              \
+  static int n##name, name##_size
+
+DEFINE_ARRAY(BCType, types);
+DEFINE_ARRAY(int, tpool);
+DEFINE_ARRAY(BCConst, consts);
+DEFINE_ARRAY(BCVal, vpool);
+DEFINE_ARRAY(BCVal, opool);  /* instruction operands */
+DEFINE_ARRAY(BCGlobal, globals);
+DEFINE_ARRAY(BCFunc, funcs);
+DEFINE_ARRAY(BCSlot, slots);
+DEFINE_ARRAY(BCInst, insts);
+DEFINE_ARRAY(BCAtt, atts);   /* of instructions */
+DEFINE_ARRAY(BCAtt, gatts);  /* of globals and functions */
+DEFINE_ARRAY(BCVal, mdvals);
+DEFINE_ARRAY(BCVal, lmds);
+DEFINE_ARRAY(BCAttr, attrs);
+DEFINE_ARRAY(BCAttrSpec, specs);
+DEFINE_ARRAY(BCAttr, sattrs);
+DEFINE_ARRAY(BCAttr, rattrs);   /* attributes being resolved */
+DEFINE_ARRAY(BCAttrGrp, grps);
+DEFINE_ARRAY(int, lgrps);
+DEFINE_ARRAY(BCAttrList, lists);
+DEFINE_ARRAY(int, tstk);     /* type operands being collected */
+DEFINE_ARRAY(BCVal, vstk);   /* value operands being collected */
+DEFINE_ARRAY(const char *, sections);
+DEFINE_ARRAY(const char *, mdkinds);
+DEFINE_ARRAY(int, numslot);  /* %n -> slot in the current function */
+DEFINE_ARRAY(int, mdval_of_const);
+DEFINE_ARRAY(int, mdval_of_global);
+DEFINE_ARRAY(int, mdval_of_llconst);
+DEFINE_ARRAY(int, torder);   /* types in bitcode order */
+DEFINE_ARRAY(int, gorder);   /* globals in the order of definition */
+DEFINE_ARRAY(unsigned char, dbytes); /* bytes of the data member being built */
+
+#define GROW(n, name, T)                                                       \
+  NEED((n), name, T, name##_size, (n) + name##_size + 256)
+
+static hashmap_t type_map;   /* structural types */
+static hashmap_t tname_map;  /* named structs */
+static hashmap_t const_map;
+static hashmap_t gname_map;
+static hashmap_t lname_map;  /* locals of the current function */
+static hashmap_t mdkind_map;
+
+static int cur_func = -1;
+static bool bb_open;         /* the current function has an open block */
+static int attr_a0;          /* attributes of the next function or call */
+static int num_next;         /* next number for an unnamed local */
+static int max_numslot;
+
+static int t_void, t_label, t_metadata, t_i1, t_i8, t_i32, t_i64;
+
+/*
+ * String storage
+ */
+
+typedef struct BCChunk {
+  struct BCChunk *next;
+} BCChunk;
+
+#define CHUNK_SIZE 65536
+
+static BCChunk *chunks;
+static char *chunk_avail;
+static int chunk_left;
+
+static char *
+bc_strdup(const char *s, int len)
+{
+  char *p;
+
+  if (len + 1 > chunk_left) {
+    int sz = len + 1 > CHUNK_SIZE ? len + 1 : CHUNK_SIZE;
+    BCChunk *c = (BCChunk *)malloc(sizeof(BCChunk) + sz);
+    if (c == NULL)
+      interr("bitcode writer: out of memory", sz, ERR_Fatal);
+    c->next = chunks;
+    chunks = c;
+    chunk_avail = (char *)(c + 1);
+    chunk_left = sz;
+  }
+  p = chunk_avail;
+  memcpy(p, s, len);
+  p[len] = '\0';
+  chunk_avail += len + 1;
+  chunk_left -= len + 1;
+  return p;
+}
+
+static void
+bc_error(const char *msg, const char *name)
+{
+  char buf[300];
+
+  snprintf(buf, sizeof(buf), "bitcode writer: %s%s%.200s", msg,
+           name ? ": " : "", name ? name : "");
+  interr(buf, cur_func, ERR_Fatal);
+}
+
+static int
+hexval(char c)
+{
+  if (c >= '0' && c <= '9')
+    return c - '0';
+  if (c >= 'a' && c <= 'f')
+    return c - 'a' + 10;
+  if (c >= 'A' && c <= 'F')
+    return c - 'A' + 10;
+  return -1;
+}
+
+/* A global, local or type name without the leading @ or %; the quotes
+   and \xx escapes of a quoted name are removed. */
+static const char *
+plain_name(const char *name)
+{
+  static char *buf;
+  static int buf_size;
+  const char *p;
+  int n;
+
+  if (*name == '@' || *name == '%')
+    name++;
+  if (*name != '"')
+    return name;
+  n = strlen(name);
+  NEED(n, buf, char, buf_size, n + 64);
+  for (p = name + 1, n = 0; *p && *p != '"'; p++) {
+    if (*p == '\\' && hexval(p[1]) >= 0 && hexval(p[2]) >= 0) {
+      buf[n++] = hexval(p[1]) * 16 + hexval(p[2]);
+      p += 2;
+    } else {
+      buf[n++] = *p;
+    }
+  }
+  buf[n] = '\0';
+  return buf;
+}
+
+static int
+log2_align(BIGUINT64 a)
+{
+  int l = 0;
+
+  if (a == 0)
+    return 0;
+  while (((BIGUINT64)1 << l) < a)
+    l++;
+  return l + 1;
+}
+
+/*
+ * Types
+ */
+
+static hash_value_t
+type_hash(hash_key_t key)
+{
+  const BCType *t = &types[HKEY2INT(key) - 1];
+  hash_value_t h = t->kind * 131 + t->n * 31 + (hash_value_t)t->count +
+                   t->packed * 7 + t->vararg * 3;
+  unsigned i;
+
+  if (t->kind == BT_STRUCT || t->kind == BT_FUNC) {
+    for (i = 0; i < t->n + (t->kind == BT_FUNC); i++)
+      h = h * 31 + tpool[t->sub + i];
+  } else {
+    h = h * 31 + t->sub;
+  }
+  return h;
+}
+
+static int
+type_equals(hash_key_t a, hash_key_t b)
+{
+  const BCType *s = &types[HKEY2INT(a) - 1];
+  const BCType *t = &types[HKEY2INT(b) - 1];
+
+  if (s->kind != t->kind || s->n != t->n || s->count != t->count ||
+      s->packed != t->packed || s->vararg != t->vararg)
+    return 0;
+  if (s->kind == BT_STRUCT || s->kind == BT_FUNC)
+    return memcmp(&tpool[s->sub], &tpool[t->sub],
+                  (s->n + (s->kind == BT_FUNC)) * sizeof(int)) == 0;
+  return s->sub == t->sub;
+}
+
+static const hash_functions_t type_hash_functions = {type_hash, type_equals};
+
+/* Intern the type in types[ntypes], whose element list, if any, was just
+   added at the end of tpool starting at elts. */
+static int
+intern_type(int elts)
+{
+  hash_key_t found;
+  hash_data_t data;
+
+  found = hashmap_lookup(type_map, INT2HKEY(ntypes + 1), &data);
+  if (found) {
+    if (elts >= 0)
+      ntpool = elts;
+    return HKEY2INT(found) - 1;
+  }
+  hashmap_insert(type_map, INT2HKEY(ntypes + 1), INT2HKEY(ntypes + 1));
+  return ntypes++;
+}
+
+static BCType *
+new_type(BCTypeKind kind)
+{
+  BCType *t;
+
+  GROW(ntypes + 1, types, BCType);
+  t = &types[ntypes];
+  memset(t, 0, sizeof(*t));
+  t->kind = kind;
+  t->id = -1;
+  return t;
+}
+
+static int
+simple_type(BCTypeKind kind, unsigned n)
+{
+  BCType *t = new_type(kind);
+  t->n = n;
+  return intern_type(-1);
+}
+
+static int
+ptr_type(int elt, unsigned addrspace)
+{
+  BCType *t = new_type(BT_PTR);
+  t->sub = elt;
+  t->n = addrspace;
+  return intern_type(-1);
+}
+
+static int
+seq_type(BCTypeKind kind, BIGUINT64 count, int elt)
+{
+  BCType *t = new_type(kind);
+  t->sub = elt;
+  t->count = count;
+  return intern_type(-1);
+}
+
+/* Struct or function type from the n types in tstk[base ...] */
+static int
+list_type(BCTypeKind kind, int base, int n, int packed, int vararg)
+{
+  BCType *t;
+  int i, elts = ntpool;
+
+  GROW(ntpool + n, tpool, int);
+  for (i = 0; i < n; i++)
+    tpool[ntpool++] = tstk[base + i];
+  t = new_type(kind);
+  t->sub = elts;
+  t->n = kind == BT_FUNC ? n - 1 : n;
+  t->packed = packed;
+  t->vararg = vararg;
+  return intern_type(elts);
+}
+
+static void
+tstk_push(int t)
+{
+  GROW(ntstk + 1, tstk, int);
+  tstk[ntstk++] = t;
+}
+
+static int
+func_type(int ret, int base, int n, int vararg)
+{
+  int i, t;
+
+  tstk_push(ret);
+  for (i = 0; i < n; i++)
+    tstk_push(tstk[base + i]);
+  t = list_type(BT_FUNC, ntstk - n - 1, n + 1, 0, vararg);
+  ntstk -= n + 1;
+  return t;
+}
+
+static int
+named_type(const char *name)
+{
+  hash_data_t data;
+  BCType *t;
+
+  if (hashmap_lookup(tname_map, name, &data))
+    return HKEY2INT(data) - 1;
+  t = new_type(BT_NAMED);
+  t->name = bc_strdup(name, strlen(name));
+  t->sub = -1;
+  hashmap_insert(tname_map, t->name, INT2HKEY(ntypes + 1));
+  return ntypes++;
+}
+
+static int
+func_ret(int fty)
+{
+  return tpool[types[fty].sub];
+}
+
+/*
+ * Constants
+ */
+
+static hash_value_t
+const_hash(hash_key_t key)
+{
+  const BCConst *c = &consts[HKEY2INT(key) - 1];
+  hash_value_t h = c->kind * 131 + c->type * 31 + c->opc * 7 +
+                   (hash_value_t)c->v[0] * 17 + (hash_value_t)(c->v[0] >> 32) +
+                   (hash_value_t)c->v[1] + c->srcty;
+  int i;
+
+  if (c->kind == C_STR) {
+    for (i = 0; i < c->n; i++)
+      h = h * 31 + (unsigned char)c->str[i];
+  } else {
+    for (i = 0; i < c->n; i++)
+      h = h * 31 + vpool[c->sub + i].kind * 7 + vpool[c->sub + i].idx;
+  }
+  if (c->kind == C_BLOCKADDR)
+    h = h * 31 + hash_functions_strings.hash(c->str);
+  return h;
+}
+
+static int
+const_equals(hash_key_t a, hash_key_t b)
+{
+  const BCConst *c = &consts[HKEY2INT(a) - 1];
+  const BCConst *d = &consts[HKEY2INT(b) - 1];
+  int i;
+
+  if (c->kind != d->kind || c->type != d->type || c->opc != d->opc ||
+      c->v[0] != d->v[0] || c->v[1] != d->v[1] ||
+      c->n != d->n || c->srcty != d->srcty)
+    return 0;
+  if (c->kind == C_STR)
+    return memcmp(c->str, d->str, c->n) == 0;
+  if (c->kind == C_BLOCKADDR && strcmp(c->str, d->str))
+    return 0;
+  for (i = 0; i < c->n; i++) {
+    const BCVal *u = &vpool[c->sub + i], *v = &vpool[d->sub + i];
+    if (u->kind != v->kind || u->idx != v->idx || u->ty != v->ty)
+      return 0;
+  }
+  return 1;
+}
+
+static const hash_functions_t const_hash_functions = {const_hash,
+                                                       const_equals};
+
+static BCConst *
+new_const(BCConstKind kind, int type)
+{
+  BCConst *c;
+
+  GROW(nconsts + 1, consts, BCConst);
+  c = &consts[nconsts];
+  memset(c, 0, sizeof(*c));
+  c->kind = kind;
+  c->type = type;
+  c->sub = nvpool;
+  c->id = -1;
+  return c;
+}
+
+/* Intern consts[nconsts], whose operands, if any, were just added at the
+   end of vpool.  A string or label is copied if the constant is new. */
+static BCVal
+intern_const(void)
+{
+  BCVal v;
+  hash_key_t found;
+  hash_data_t data;
+
+  v.kind = V_CONST;
+  v.ty = consts[nconsts].type;
+  found = hashmap_lookup(const_map, INT2HKEY(nconsts + 1), &data);
+  if (found) {
+    nvpool = consts[nconsts].sub;
+    v.idx = HKEY2INT(found) - 1;
+    return v;
+  }
+  if (consts[nconsts].kind == C_STR)
+    consts[nconsts].str = bc_strdup(consts[nconsts].str, consts[nconsts].n);
+  else if (consts[nconsts].kind == C_BLOCKADDR)
+    consts[nconsts].str =
+        bc_strdup(consts[nconsts].str, strlen(consts[nconsts].str));
+  hashmap_insert(const_map, INT2HKEY(nconsts + 1), INT2HKEY(nconsts + 1));
+  v.idx = nconsts++;
+  return v;
+}
+
+static BCVal
+int_const(int ty, BIGINT64 val)
+{
+  BCConst *c = new_const(C_INT, ty);
+  unsigned w = types[ty].n;
+
+  if (w < 64) /* keep the value sign extended from its width */
+    val = (BIGINT64)((BIGUINT64)val << (64 - w)) >> (64 - w);
+  c->v[0] = val;
+  return intern_const();
+}
+
+static BCVal
+simple_const(BCConstKind kind, int ty)
+{
+  new_const(kind, ty);
+  return intern_const();
+}
+
+static void
+vstk_push(BCVal v)
+{
+  GROW(nvstk + 1, vstk, BCVal);
+  vstk[nvstk++] = v;
+}
+
+/* Constant expression or aggregate with the operands in vstk[base ...] */
+static BCVal
+operand_const(BCConstKind kind, int ty, int base, int opc, int srcty)
+{
+  int i, n = nvstk - base;
+  BCConst *c;
+
+  GROW(nvpool + n, vpool, BCVal);
+  c = new_const(kind, ty);
+  for (i = 0; i < n; i++)
+    vpool[nvpool++] = vstk[base + i];
+  c->n = n;
+  c->opc = opc;
+  c->srcty = srcty;
+  nvstk = base;
+  return intern_const();
+}
+
+/*
+ * Globals and locals
+ */
+
+static int
+global_ref(const char *name)
+{
+  hash_data_t data;
+  BCGlobal *g;
+
+  if (hashmap_lookup(gname_map, name, &data))
+    return HKEY2INT(data) - 1;
+  GROW(nglobals + 1, globals, BCGlobal);
+  g = &globals[nglobals];
+  memset(g, 0, sizeof(*g));
+  g->name = bc_strdup(name, strlen(name));
+  g->kind = G_UNDEF;
+  g->body = -1;
+  g->id = -1;
+  hashmap_insert(gname_map, g->name, INT2HKEY(nglobals + 1));
+  return nglobals++;
+}
+
+static int
+new_slot(const char *name, BCSlotKind kind)
+{
+  BCSlot *s;
+
+  GROW(nslots + 1, slots, BCSlot);
+  s = &slots[nslots];
+  s->name = name;
+  s->kind = kind;
+  s->id = -1;
+  return nslots++;
+}
+
+/* Find or create the slot of the numbered local %n */
+static int
+num_slot(int n, BCSlotKind kind)
+{
+  GROW(n + 1, numslot, int);
+  while (max_numslot <= n)
+    numslot[max_numslot++] = -1;
+  if (numslot[n] < 0)
+    numslot[n] = new_slot(NULL, kind);
+  return numslot[n];
+}
+
+/* Find or create the slot of a named local */
+static int
+name_slot(const char *name, BCSlotKind kind)
+{
+  hash_data_t data;
+  int slot;
+
+  if (hashmap_lookup(lname_map, name, &data))
+    return HKEY2INT(data) - 1;
+  slot = new_slot(bc_strdup(name, strlen(name)), kind);
+  hashmap_insert(lname_map, slots[slot].name, INT2HKEY(slot + 1));
+  return slot;
+}
+
+/* The definition of a local: the slot of the name, or of the number n if
+   name is NULL, or of the next number if n is negative. */
+static int
+define_local(const char *name, int n, BCSlotKind kind)
+{
+  BCSlotKind use = kind == SL_BB ? SL_BBUSED : SL_USED;
+  int slot;
+
+  if (name == NULL) {
+    if (n < 0)
+      n = num_next;
+    slot = num_slot(n, use);
+    num_next = n + 1;
+  } else {
+    slot = name_slot(name, use);
+  }
+  if (slots[slot].kind != use)
+    bc_error(slots[slot].kind == SL_VAL || slots[slot].kind == SL_BB
+                 ? "local defined twice"
+                 : "label used as a value",
+             name);
+  slots[slot].kind = kind;
+  return slot;
+}
+
+static int
+mdval_for(BCVal v)
+{
+  int *map, i;
+
+  if (v.kind == V_GLOBAL) {
+    GROW(v.idx + 1, mdval_of_global, int);
+    while (nmdval_of_global <= v.idx)
+      mdval_of_global[nmdval_of_global++] = -1;
+    map = &mdval_of_global[v.idx];
+  } else {
+    GROW(v.idx + 1, mdval_of_const, int);
+    while (nmdval_of_const <= v.idx)
+      mdval_of_const[nmdval_of_const++] = -1;
+    map = &mdval_of_const[v.idx];
+  }
+  if (*map < 0) {
+    GROW(nmdvals + 1, mdvals, BCVal);
+    mdvals[nmdvals] = v;
+    *map = nmdvals++;
+  }
+  i = *map;
+  return i;
+}
+
+/*
+ * Attributes
+ */
+
+static const struct {
+  const char *name;
+  unsigned char id;
+  unsigned char arg; /* 1: integer argument, 2: argument in parentheses */
+} attr_names[] = {{"align", 1, 1},
+                  {"alwaysinline", 2, 0},
+                  {"byval", 3, 0},
+                  {"inlinehint", 4, 0},
+                  {"inreg", 5, 0},
+                  {"minsize", 6, 0},
+                  {"naked", 7, 0},
+                  {"nest", 8, 0},
+                  {"noalias", 9, 0},
+                  {"nobuiltin", 10, 0},
+                  {"nocapture", 11, 0},
+                  {"noduplicate", 12, 0},
+                  {"noimplicitfloat", 13, 0},
+                  {"noinline", 14, 0},
+                  {"nonlazybind", 15, 0},
+                  {"noredzone", 16, 0},
+                  {"noreturn", 17, 0},
+                  {"nounwind", 18, 0},
+                  {"optsize", 19, 0},
+                  {"readnone", 20, 0},
+                  {"readonly", 21, 0},
+                  {"returned", 22, 0},
+                  {"returns_twice", 23, 0},
+                  {"signext", 24, 0},
+                  {"alignstack", 25, 2},
+                  {"ssp", 26, 0},
+                  {"sspreq", 27, 0},
+                  {"sspstrong", 28, 0},
+                  {"sret", 29, 0},
+                  {"sanitize_address", 30, 0},
+                  {"sanitize_thread", 31, 0},
+                  {"sanitize_memory", 32, 0},
+                  {"uwtable", 33, 0},
+                  {"zeroext", 34, 0},
+                  {"builtin", 35, 0},
+                  {"cold", 36, 0},
+                  {"optnone", 37, 0},
+                  {"inalloca", 38, 0},
+                  {"nonnull", 39, 0},
+                  {"jumptable", 40, 0},
+                  {"dereferenceable", 41, 2},
+                  {"dereferenceable_or_null", 42, 2},
+                  {"convergent", 43, 0},
+                  {"safestack", 44, 0},
+                  {"argmemonly", 45, 0},
+                  {"swiftself", 46, 0},
+                  {"swifterror", 47, 0},
+                  {"norecurse", 48, 0},
+                  {"inaccessiblememonly", 49, 0},
+                  {"inaccessiblemem_or_argmemonly", 50, 0},
+                  {"writeonly", 52, 0},
+                  {NULL, 0, 0}};
+
+static void
+add_attr(unsigned idx, unsigned char kind, unsigned id, BIGUINT64 val,
+         const char *key, const char *value)
+{
+  BCAttr *a;
+
+  GROW(nattrs + 1, attrs, BCAttr);
+  a = &attrs[nattrs++];
+  a->idx = idx;
+  a->kind = kind;
+  a->id = id;
+  a->val = val;
+  a->key = key;
+  a->value = value;
+}
+
+/* Close the attribute spec started at attrs[a0]; -1 if it is empty */
+static int
+end_attr_spec(int a0)
+{
+  if (nattrs == a0)
+    return -1;
+  GROW(nspecs + 1, specs, BCAttrSpec);
+  specs[nspecs].a0 = a0;
+  specs[nspecs].na = nattrs - a0;
+  return nspecs++;
+}
+
+/*
+ * Metadata kinds
+ */
+
+static const char *const fixed_md_kinds[] = {"dbg",
+                                             "tbaa",
+                                             "prof",
+                                             "fpmath",
+                                             "range",
+                                             "tbaa.struct",
+                                             "invariant.load",
+                                             "alias.scope",
+                                             "noalias",
+                                             "nontemporal",
+                                             "llvm.mem.parallel_loop_access",
+                                             "nonnull",
+                                             "dereferenceable",
+                                             "dereferenceable_or_null",
+                                             "make.implicit",
+                                             "unpredictable",
+                                             "invariant.group",
+                                             "align",
+                                             "llvm.loop",
+                                             "type",
+                                             "section_prefix",
+                                             "absolute_symbol",
+                                             NULL};
+
+static int
+md_kind(const char *name)
+{
+  hash_data_t data;
+
+  if (hashmap_lookup(mdkind_map, name, &data))
+    return HKEY2INT(data) - 1;
+  name = bc_strdup(name, strlen(name));
+  GROW(nmdkinds + 1, mdkinds, const char *);
+  mdkinds[nmdkinds] = name;
+  hashmap_insert(mdkind_map, name, INT2HKEY(nmdkinds + 1));
+  return nmdkinds++;
+}
+
+static int
+section_index(const char *name)
+{
+  int i;
+
+  for (i = 0; i < nsections; i++)
+    if (strcmp(sections[i], name) == 0)
+      return i + 1;
+  GROW(nsections + 1, sections, const char *);
+  sections[nsections++] = bc_strdup(name, strlen(name));
+  return nsections;
+}
+
+/*
+ * Function bodies
+ */
+
+static BCInst *
+new_inst(BCOp op, int ty)
+{
+  BCInst *i;
+
+  GROW(ninsts + 1, insts, BCInst);
+  i = &insts[ninsts++];
+  memset(i, 0, sizeof(*i));
+  i->op = op;
+  i->ty = ty;
+  i->res = -1;
+  i->op0 = nopool;
+  i->attrs = -1;
+  return i;
+}
+
+static void
+inst_operand(BCVal v)
+{
+  GROW(nopool + 1, opool, BCVal);
+  opool[nopool++] = v;
+  insts[ninsts - 1].nop++;
+}
+static void
+inst_imm(BIGUINT64 v)
+{
+  BCVal x;
+  x.kind = V_IMM;
+  x.ty = -1;
+  x.idx = (int)v;
+  inst_operand(x);
+}
+
+static void
+start_function(BCFunc *f)
+{
+  hashmap_clear(lname_map);
+  max_numslot = 0;
+  num_next = 0;
+  f->slot0 = nslots;
+  f->inst0 = ninsts;
+  f->lmd0 = nlmds;
+  f->att0 = natts;
+}
+
+/*
+ * Building the module
+ */
+
+bool
+ll_bitcode_output(void)
+{
+  return XBIT(216, 0x2) != 0;
+}
+
+/* Types */
+
+int
+ll_bc_type(LL_Type *type)
+{
+  int i, n, base, ret;
+
+  switch (type->data_type) {
+  case LL_VOID:
+    return t_void;
+  case LL_LABEL:
+    return t_label;
+  case LL_METADATA:
+    return t_metadata;
+  case LL_I1:
+  case LL_I8:
+  case LL_I16:
+  case LL_I24:
+  case LL_I32:
+  case LL_I40:
+  case LL_I48:
+  case LL_I56:
+  case LL_I64:
+  case LL_I128:
+  case LL_I256:
+    return simple_type(BT_INT, ll_type_int_bits(type));
+  case LL_HALF:
+    return simple_type(BT_HALF, 0);
+  case LL_FLOAT:
+    return simple_type(BT_FLOAT, 0);
+  case LL_DOUBLE:
+    return simple_type(BT_DOUBLE, 0);
+  case LL_FP128:
+    return simple_type(BT_FP128, 0);
+  case LL_X86_FP80:
+    return simple_type(BT_X86_FP80, 0);
+  case LL_PPC_FP128:
+    return simple_type(BT_PPC_FP128, 0);
+  case LL_PTR:
+    return ptr_type(ll_bc_type((LL_Type *)type->sub_types[0]),
+                    type->sub_types[0]->addrspace);
+  case LL_ARRAY:
+  case LL_VECTOR:
+    return seq_type(type->data_type == LL_ARRAY ? BT_ARRAY : BT_VECTOR,
+                    type->sub_elements,
+                    ll_bc_type((LL_Type *)type->sub_types[0]));
+  case LL_STRUCT:
+    if ((type->flags & LL_TYPE_IS_NAMED_STRUCT) || type->str[0] == '%')
+      return named_type(plain_name(type->str));
+    base = ntstk;
+    for (i = 0; i < (int)type->sub_elements; i++)
+      tstk_push(ll_bc_type((LL_Type *)type->sub_types[i]));
+    n = list_type(BT_STRUCT, base, ntstk - base,
+                  (type->flags & LL_TYPE_IS_PACKED_STRUCT) != 0, 0);
+    ntstk = base;
+    return n;
+  case LL_FUNCTION:
+    ret = ll_bc_type((LL_Type *)type->sub_types[0]);
+    base = ntstk;
+    for (i = 1; i < (int)type->sub_elements; i++)
+      tstk_push(ll_bc_type((LL_Type *)type->sub_types[i]));
+    n = func_type(ret, base, ntstk - base,
+                  (type->flags & LL_TYPE_IS_VARARGS_FUNC) != 0);
+    ntstk = base;
+    return n;
+  default:
+    bc_error("unsupported type", type->str);
+  }
+  return t_void;
+}
+
+int
+ll_bc_void_type(void)
+{
+  return t_void;
+}
+
+int
+ll_bc_int_type(unsigned bits)
+{
+  return simple_type(BT_INT, bits);
+}
+
+int
+ll_bc_ptr_type(int elt)
+{
+  return ptr_type(elt, 0);
+}
+
+int
+ll_bc_array_type(BIGUINT64 count, int elt)
+{
+  return seq_type(BT_ARRAY, count, elt);
+}
+
+int
+ll_bc_struct_type(const int *elts, int n, bool packed)
+{
+  int i, t, base = ntstk;
+
+  for (i = 0; i < n; i++)
+    tstk_push(elts[i]);
+  t = list_type(BT_STRUCT, base, n, packed, 0);
+  ntstk = base;
+  return t;
+}
+
+int
+ll_bc_func_type(int ret, const int *params, int n, bool vararg)
+{
+  int i, t, base = ntstk;
+
+  for (i = 0; i < n; i++)
+    tstk_push(params[i]);
+  t = func_type(ret, base, n, vararg);
+  ntstk = base;
+  return t;
+}
+
+int
+ll_bc_named_type(const char *name)
+{
+  return named_type(plain_name(name));
+}
+
+void
+ll_bc_type_body(int named, int body)
+{
+  if (types[named].state == 2)
+    bc_error("type defined twice", types[named].name);
+  if (body < 0) {
+    types[named].state = 1;
+    return;
+  }
+  types[named].sub = body;
+  types[named].state = 2;
+}
+
+/* The element type of a pointer, array or vector type */
+int
+ll_bc_elem_type(int ty)
+{
+  return types[ty].sub;
+}
+
+/* Constants */
+
+BCVal
+ll_bc_int(int ty, BIGINT64 val)
+{
+  if (types[ty].n > 64)
+    return ll_bc_wide_int(ty, val, val < 0 ? ~(BIGUINT64)0 : 0);
+  return int_const(ty, val);
+}
+
+BCVal
+ll_bc_wide_int(int ty, BIGUINT64 lo, BIGUINT64 hi)
+{
+  BCConst *c;
+
+  if (types[ty].n <= 64)
+    return int_const(ty, lo);
+  c = new_const(C_WIDE, ty);
+  c->v[0] = lo;
+  c->v[1] = hi;
+  return intern_const();
+}
+
+/* A floating point constant from its bits; lo holds the low 64 bits, hi
+   the rest. */
+BCVal
+ll_bc_fp(int ty, BIGUINT64 lo, BIGUINT64 hi)
+{
+  BCConst *c = new_const(C_FP, ty);
+
+  c->v[0] = lo;
+  c->v[1] = hi;
+  return intern_const();
+}
+
+BCVal
+ll_bc_double(int ty, double d)
+{
+  BIGUINT64 bits = 0;
+  float f;
+
+  if (types[ty].kind == BT_FLOAT) {
+    unsigned w;
+    f = (float)d;
+    memcpy(&w, &f, sizeof(w));
+    bits = w;
+  } else if (types[ty].kind == BT_DOUBLE) {
+    memcpy(&bits, &d, sizeof(bits));
+  } else {
+    bc_error("unsupported floating point constant", NULL);
+  }
+  return ll_bc_fp(ty, bits, 0);
+}
+
+BCVal
+ll_bc_null(int ty)
+{
+  return simple_const(C_NULL, ty);
+}
+
+BCVal
+ll_bc_undef(int ty)
+{
+  return simple_const(C_UNDEF, ty);
+}
+
+BCVal
+ll_bc_string(int ty, const char *s, int len)
+{
+  BCConst *c = new_const(C_STR, ty);
+
+  c->str = s;
+  c->n = len;
+  return intern_const();
+}
+
+BCVal
+ll_bc_aggregate(int ty, const BCVal *elts, int n)
+{
+  int i, base = nvstk;
+
+  for (i = 0; i < n; i++)
+    vstk_push(elts[i]);
+  return operand_const(C_AGG, ty, base, 0, -1);
+}
+
+BCVal
+ll_bc_cast_const(unsigned opc, BCVal v, int ty)
+{
+  int base = nvstk;
+
+  vstk_push(v);
+  return operand_const(C_CAST, ty, base, opc, -1);
+}
+
+/* getelementptr of the pointer base to an element of type srcty; the type
+   of the result is computed from the indices. */
+BCVal
+ll_bc_gep_const(int srcty, BCVal base, const BCVal *idx, int n,
+                bool inbounds)
+{
+  int i, t = srcty, vbase = nvstk;
+
+  for (i = 1; i < n; i++) {
+    if (types[t].kind == BT_NAMED) {
+      if (types[t].state != 2)
+        bc_error("getelementptr into an opaque type", types[t].name);
+      t = types[t].sub;
+    }
+    if (types[t].kind == BT_STRUCT) {
+      if (idx[i].kind != V_CONST || consts[idx[i].idx].kind != C_INT ||
+          consts[idx[i].idx].v[0] >= types[t].n)
+        bc_error("bad struct index in getelementptr", NULL);
+      t = tpool[types[t].sub + consts[idx[i].idx].v[0]];
+    } else {
+      t = types[t].sub;
+    }
+  }
+  vstk_push(base);
+  for (i = 0; i < n; i++)
+    vstk_push(idx[i]);
+  return operand_const(C_GEP, ptr_type(t, types[base.ty].n), vbase, inbounds,
+                       srcty);
+}
+
+BCVal
+ll_bc_blockaddress(BCVal fn, const char *label)
+{
+  BCConst *c;
+
+  GROW(nvpool + 1, vpool, BCVal);
+  c = new_const(C_BLOCKADDR, ptr_type(t_i8, 0));
+  vpool[nvpool++] = fn;
+  c->n = 1;
+  c->str = plain_name(label);
+  return intern_const();
+}
+
+/* The data constant being built: its members are in vstk[data_base ...];
+   the open byte member has the bytes in dbytes followed by data_zeros zero
+   bytes. */
+static int data_base;
+static BIGINT64 data_zeros;
+static bool data_run;
+
+void
+ll_bc_data_begin(void)
+{
+  data_base = nvstk;
+  ndbytes = 0;
+  data_zeros = 0;
+  data_run = false;
+}
+
+/* Close the open byte member */
+void
+ll_bc_data_member(void)
+{
+  int ty;
+
+  if (!data_run)
+    return;
+  if (ndbytes == 0) {
+    vstk_push(ll_bc_null(seq_type(BT_ARRAY, data_zeros, t_i8)));
+  } else {
+    GROW(ndbytes + data_zeros, dbytes, unsigned char);
+    memset(&dbytes[ndbytes], 0, data_zeros);
+    ndbytes += data_zeros;
+    ty = seq_type(BT_ARRAY, ndbytes, t_i8);
+    vstk_push(ll_bc_string(ty, (const char *)dbytes, ndbytes));
+  }
+  ndbytes = 0;
+  data_zeros = 0;
+  data_run = false;
+}
+
+void
+ll_bc_data_byte(unsigned byte)
+{
+  data_run = true;
+  if ((byte & 0xff) == 0) {
+    data_zeros++;
+    return;
+  }
+  GROW(ndbytes + data_zeros + 1, dbytes, unsigned char);
+  memset(&dbytes[ndbytes], 0, data_zeros);
+  ndbytes += data_zeros;
+  data_zeros = 0;
+  dbytes[ndbytes++] = byte;
+}
+
+/* n bytes of val, least significant first */
+void
+ll_bc_data_bytes(BIGUINT64 val, int n)
+{
+  for (; n > 0; n--, val >>= 8)
+    ll_bc_data_byte((unsigned)(val & 0xff));
+}
+
+void
+ll_bc_data_zeros(BIGINT64 n)
+{
+  if (n > 0) {
+    data_zeros += n;
+    data_run = true;
+  }
+}
+
+void
+ll_bc_data_ptr(BCVal ptr)
+{
+  ll_bc_data_member();
+  vstk_push(ptr);
+}
+
+/* The packed struct of the members; its type is the named struct named if
+   that is not negative, whose body is set if it has none. */
+BCVal
+ll_bc_data_end(int named)
+{
+  int i, body, base = ntstk;
+
+  ll_bc_data_member();
+  for (i = data_base; i < nvstk; i++)
+    tstk_push(vstk[i].ty);
+  body = list_type(BT_STRUCT, base, ntstk - base, 1, 0);
+  ntstk = base;
+  if (named < 0)
+    return operand_const(C_AGG, body, data_base, 0, -1);
+  if (types[named].state != 2)
+    ll_bc_type_body(named, body);
+  else if (types[named].sub != body)
+    bc_error("initializer does not match the type", types[named].name);
+  return operand_const(C_AGG, named, data_base, 0, -1);
+}
+
+/* Globals */
+
+BCVal
+ll_bc_global(const char *name, int ptrty)
+{
+  BCVal v;
+
+  v.kind = V_GLOBAL;
+  v.idx = global_ref(plain_name(name));
+  v.ty = ptrty >= 0 ? ptrty : globals[v.idx].ptrty;
+  if (v.ty < 0)
+    bc_error("type of a global not known", name);
+  return v;
+}
+
+bool
+ll_bc_global_defined(const char *name)
+{
+  hash_data_t data;
+
+  return hashmap_lookup(gname_map, plain_name(name), &data) &&
+         globals[HKEY2INT(data) - 1].kind != G_UNDEF;
+}
+
+static int
+define_global(const char *name, BCGlobalKind kind, int ty, int linkage)
+{
+  int g = global_ref(plain_name(name));
+
+  if (globals[g].kind != G_UNDEF)
+    bc_error("global defined twice", name);
+  globals[g].kind = kind;
+  globals[g].type = ty;
+  globals[g].linkage = linkage;
+  globals[g].ptrty = ptr_type(ty, 0);
+  GROW(ngorder + 1, gorder, int);
+  gorder[ngorder++] = g;
+  return g;
+}
+
+int
+ll_bc_global_var(const char *name, int ty, int linkage, bool isconst)
+{
+  int g = define_global(name, G_VAR, ty, linkage);
+
+  globals[g].isconst = isconst;
+  return g;
+}
+
+void
+ll_bc_global_init(int g, BCVal init)
+{
+  globals[g].init = init;
+}
+
+void
+ll_bc_global_align(int g, unsigned bytes)
+{
+  globals[g].align = bytes;
+}
+
+void
+ll_bc_global_section(int g, const char *section)
+{
+  globals[g].section = section_index(section);
+}
+
+void
+ll_bc_global_tls(int g)
+{
+  globals[g].tls = 1; /* general dynamic */
+}
+
+/* Attach metadata to a global; the attachments of a global are added
+   together. */
+void
+ll_bc_global_md(int g, const char *kind, LL_MDRef md)
+{
+  BCGlobal *gp = &globals[g];
+
+  if (gp->natt == 0)
+    gp->att = ngatts;
+  else if (gp->att + gp->natt != ngatts)
+    bc_error("metadata attachments of a global not together", gp->name);
+  GROW(ngatts + 1, gatts, BCAtt);
+  gatts[ngatts].inst = -1;
+  gatts[ngatts].kind = md_kind(kind);
+  gatts[ngatts].node = LL_MDREF_value(md);
+  ngatts++;
+  gp->natt++;
+}
+
+int
+ll_bc_alias(const char *name, int ty, BCVal aliasee, int linkage)
+{
+  int g = define_global(name, G_ALIAS, ty, linkage);
+
+  globals[g].init = aliasee;
+  return g;
+}
+
+/* Functions */
+
+static int
+find_attr(const char *name)
+{
+  int i;
+
+  for (i = 0; attr_names[i].name; i++)
+    if (strcmp(attr_names[i].name, name) == 0)
+      return i;
+  bc_error("unsupported attribute", name);
+  return 0;
+}
+
+void
+ll_bc_attr(unsigned idx, const char *name)
+{
+  int i = find_attr(name);
+
+  if (attr_names[i].arg)
+    bc_error("attribute needs a value", name);
+  add_attr(idx, AK_ENUM, attr_names[i].id, 0, NULL, NULL);
+}
+
+void
+ll_bc_attr_int(unsigned idx, const char *name, BIGUINT64 val)
+{
+  int i = find_attr(name);
+
+  if (!attr_names[i].arg)
+    bc_error("attribute takes no value", name);
+  add_attr(idx, AK_INT, attr_names[i].id, val, NULL, NULL);
+}
+
+void
+ll_bc_attr_str(unsigned idx, const char *key, const char *value)
+{
+  key = bc_strdup(key, strlen(key));
+  if (value)
+    value = bc_strdup(value, strlen(value));
+  add_attr(idx, value ? AK_STRVAL : AK_STR, 0, 0, key, value);
+}
+
+int
+ll_bc_declare(const char *name, int fty, int linkage)
+{
+  int g = define_global(name, G_FUNC, fty, linkage);
+
+  globals[g].body = -1;
+  globals[g].attrs = end_attr_spec(attr_a0);
+  attr_a0 = nattrs;
+  return g;
+}
+
+int
+ll_bc_define(const char *name, int fty, int linkage)
+{
+  int g = ll_bc_declare(name, fty, linkage);
+  BCFunc *f;
+
+  if (cur_func >= 0)
+    bc_error("function definitions nested", name);
+  GROW(nfuncs + 1, funcs, BCFunc);
+  f = &funcs[nfuncs];
+  memset(f, 0, sizeof(*f));
+  f->g = g;
+  start_function(f);
+  globals[g].body = nfuncs;
+  cur_func = nfuncs++;
+  bb_open = false;
+  return g;
+}
+
+void
+ll_bc_function_cc(int g, unsigned cc)
+{
+  globals[g].cc = cc;
+}
+
+void
+ll_bc_param(const char *name)
+{
+  BCFunc *f = &funcs[cur_func];
+  int slot;
+
+  slot = define_local(name ? plain_name(name) : NULL, -1, SL_VAL);
+  if (slot != f->slot0 + f->nargs || ninsts != f->inst0)
+    bc_error("parameter after the start of the body",
+             globals[f->g].name);
+  f->nargs++;
+}
+
+void
+ll_bc_end_function(void)
+{
+  BCFunc *f = &funcs[cur_func];
+
+  if ((unsigned)f->nargs != types[globals[f->g].type].n)
+    bc_error("wrong number of parameters", globals[f->g].name);
+  f->nslots = nslots - f->slot0;
+  f->ninst = ninsts - f->inst0;
+  f->nlmd = nlmds - f->lmd0;
+  f->natt = natts - f->att0;
+  cur_func = -1;
+  bb_open = false;
+}
+
+/* Values of the function being defined */
+
+BCVal
+ll_bc_local(const char *name, int ty)
+{
+  BCVal v;
+
+  v.kind = V_LOCAL;
+  v.ty = ty;
+  v.idx = name_slot(plain_name(name), SL_USED);
+  return v;
+}
+
+BCVal
+ll_bc_local_num(int n, int ty)
+{
+  BCVal v;
+
+  v.kind = V_LOCAL;
+  v.ty = ty;
+  v.idx = num_slot(n, SL_USED);
+  return v;
+}
+
+BCVal
+ll_bc_label(const char *name)
+{
+  BCVal v;
+
+  v.kind = V_BB;
+  v.ty = t_label;
+  v.idx = name_slot(plain_name(name), SL_BBUSED);
+  return v;
+}
+
+/* Start the basic block name */
+void
+ll_bc_block(const char *name)
+{
+  int slot = define_local(plain_name(name), 0, SL_BB);
+
+  slots[slot].id = funcs[cur_func].nbb++;
+  bb_open = true;
+}
+
+/* Metadata operands */
+
+BCVal
+ll_bc_md(LL_MDRef md)
+{
+  BCVal v;
+
+  if (LL_MDREF_kind(md) != MDRef_Node || LL_MDREF_value(md) == 0)
+    bc_error("metadata operand is not a node", NULL);
+  v.kind = V_MD;
+  v.ty = t_metadata;
+  v.idx = LL_MDREF_value(md);
+  return v;
+}
+
+BCVal
+ll_bc_md_value(BCVal v)
+{
+  BCVal md;
+
+  md.ty = t_metadata;
+  if (v.kind == V_LOCAL) {
+    GROW(nlmds + 1, lmds, BCVal);
+    lmds[nlmds] = v;
+    md.kind = V_LMD;
+    md.idx = nlmds++;
+  } else {
+    md.kind = V_MDVAL;
+    md.idx = mdval_for(v);
+  }
+  return md;
+}
+
+static const char *const fcmp_names[] = {
+    "false", "oeq", "ogt", "oge", "olt", "ole", "one", "ord",
+    "uno",   "ueq", "ugt", "uge", "ult", "ule", "une", "true", NULL};
+
+static const char *const icmp_names[] = {"eq",  "ne",  "ugt", "uge", "ult",
+                                         "ule", "sgt", "sge", "slt", "sle",
+                                         NULL};
+
+/* The predicate of an fcmp or icmp */
+unsigned
+ll_bc_predicate(const char *name, bool fp)
+{
+  const char *const *names = fp ? fcmp_names : icmp_names;
+  unsigned i;
+
+  for (i = 0; names[i]; i++)
+    if (strcmp(names[i], name) == 0)
+      return fp ? i : 32 + i;
+  bc_error("unknown predicate", name);
+  return 0;
+}
+
+/* Instructions */
+
+void
+ll_bc_inst(BCOp op, int ty)
+{
+  int slot;
+
+  if (cur_func < 0)
+    bc_error("instruction outside of a function", NULL);
+  if (!bb_open) {
+    slot = define_local(NULL, -1, SL_BB);
+    slots[slot].id = funcs[cur_func].nbb++;
+    bb_open = true;
+  }
+  new_inst(op, ty);
+}
+
+void
+ll_bc_inst_sub(unsigned sub)
+{
+  insts[ninsts - 1].sub = sub;
+}
+
+void
+ll_bc_inst_flags(unsigned flags)
+{
+  insts[ninsts - 1].flags |= flags;
+}
+
+void
+ll_bc_inst_fmf(unsigned fmf)
+{
+  insts[ninsts - 1].fmf |= fmf;
+}
+
+void
+ll_bc_inst_align(unsigned bytes)
+{
+  insts[ninsts - 1].align = log2_align(bytes);
+}
+
+void
+ll_bc_inst_order(unsigned ord, unsigned fail)
+{
+  insts[ninsts - 1].ord = ord;
+  insts[ninsts - 1].ord2 = fail;
+}
+
+void
+ll_bc_inst_cc(unsigned cc)
+{
+  insts[ninsts - 1].cc = cc;
+}
+
+void
+ll_bc_inst_md(const char *kind, LL_MDRef md)
+{
+  GROW(natts + 1, atts, BCAtt);
+  atts[natts].inst = ninsts - 1;
+  atts[natts].kind = md_kind(kind);
+  atts[natts].node = LL_MDREF_value(md);
+  natts++;
+}
+
+void
+ll_bc_inst_dbg(LL_MDRef md)
+{
+  insts[ninsts - 1].dbg = LL_MDREF_value(md);
+}
+
+void
+ll_bc_operand(BCVal v)
+{
+  inst_operand(v);
+}
+
+void
+ll_bc_imm(unsigned imm)
+{
+  inst_imm(imm);
+}
+
+void
+ll_bc_result(const char *name)
+{
+  insts[ninsts - 1].res = define_local(plain_name(name), 0, SL_VAL);
+}
+
+void
+ll_bc_result_num(int n)
+{
+  insts[ninsts - 1].res = define_local(NULL, n, SL_VAL);
+}
+
+void
+ll_bc_end_inst(void)
+{
+  BCInst *in = &insts[ninsts - 1];
+  int i, base, fty;
+
+  switch (in->op) {
+  case BC_RET:
+  case BC_BR:
+  case BC_SWITCH:
+  case BC_INDBR:
+  case BC_UNREACH:
+    bb_open = false;
+    /* fall through */
+  case BC_STORE:
+  case BC_FENCE:
+    in->value = 0;
+    break;
+  case BC_ALLOCA:
+    if (in->nop == 0)
+      inst_operand(int_const(t_i32, 1));
+    in->value = 1;
+    break;
+  case BC_CALL:
+    fty = in->ty;
+    if (types[fty].kind == BT_PTR)
+      fty = types[fty].sub;
+    if (types[fty].kind != BT_FUNC) {
+      base = ntstk;
+      for (i = 1; i < in->nop; i++)
+        tstk_push(opool[in->op0 + i].ty);
+      fty = func_type(fty, base, ntstk - base, 0);
+      ntstk = base;
+    }
+    in->ty = fty;
+    opool[in->op0].ty = ptr_type(fty, 0);
+    in->attrs = end_attr_spec(attr_a0);
+    attr_a0 = nattrs;
+    in->value = types[func_ret(fty)].kind != BT_VOID;
+    break;
+  default:
+    in->value = 1;
+    break;
+  }
+  if (in->value && in->res < 0)
+    in->res = define_local(NULL, -1, SL_VAL);
+  else if (!in->value && in->res >= 0)
+    bc_error("result of an instruction without a value",
+             slots[in->res].name);
+}
+/*
+ * Attribute sets
+ */
+
+static int
+attr_cmp(const void *a, const void *b)
+{
+  const BCAttr *x = (const BCAttr *)a, *y = (const BCAttr *)b;
+
+  if (x->idx != y->idx)
+    return x->idx < y->idx ? -1 : 1;
+  if (x->kind != y->kind)
+    return x->kind < y->kind ? -1 : 1;
+  if (x->kind == AK_ENUM || x->kind == AK_INT)
+    return (int)x->id - (int)y->id;
+  return strcmp(x->key, y->key);
+}
+
+static bool
+attr_equal(const BCAttr *x, const BCAttr *y)
+{
+  if (x->idx != y->idx || x->kind != y->kind || x->id != y->id ||
+      x->val != y->val)
+    return false;
+  if (x->kind == AK_STR || x->kind == AK_STRVAL) {
+    if (strcmp(x->key, y->key))
+      return false;
+    if (x->kind == AK_STRVAL && strcmp(x->value, y->value))
+      return false;
+  }
+  return true;
+}
+
+static int
+intern_group(unsigned idx, const BCAttr *a, int na)
+{
+  int i, j;
+
+  for (i = 0; i < ngrps; i++) {
+    if (grps[i].idx != idx || grps[i].na != na)
+      continue;
+    for (j = 0; j < na; j++)
+      if (!attr_equal(&sattrs[grps[i].a0 + j], &a[j]))
+        break;
+    if (j == na)
+      return i;
+  }
+  GROW(nsattrs + na, sattrs, BCAttr);
+  memcpy(&sattrs[nsattrs], a, na * sizeof(BCAttr));
+  GROW(ngrps + 1, grps, BCAttrGrp);
+  grps[ngrps].idx = idx;
+  grps[ngrps].a0 = nsattrs;
+  grps[ngrps].na = na;
+  nsattrs += na;
+  return ngrps++;
+}
+
+static void
+copy_attr(const BCAttr *a)
+{
+  GROW(nrattrs + 1, rattrs, BCAttr);
+  rattrs[nrattrs++] = *a;
+}
+
+/* Resolve an attribute spec into an attribute list; returns the list id
+   (1-based), 0 if there are no attributes. */
+static int
+resolve_attrs(int spec)
+{
+  int i, j, l0 = nlgrps;
+
+  if (spec < 0)
+    return 0;
+  nrattrs = 0;
+  for (i = 0; i < specs[spec].na; i++)
+    copy_attr(&attrs[specs[spec].a0 + i]);
+  if (nrattrs == 0)
+    return 0;
+  qsort(rattrs, nrattrs, sizeof(BCAttr), attr_cmp);
+  for (i = j = 0; i < nrattrs; i++)
+    if (j == 0 || !attr_equal(&rattrs[i], &rattrs[j - 1]))
+      rattrs[j++] = rattrs[i];
+  nrattrs = j;
+
+  /* one group per index */
+  for (i = 0; i < nrattrs; i = j) {
+    for (j = i; j < nrattrs && rattrs[j].idx == rattrs[i].idx; j++)
+      ;
+    GROW(nlgrps + 1, lgrps, int);
+    lgrps[nlgrps++] = intern_group(rattrs[i].idx, &rattrs[i], j - i);
+  }
+  for (i = 0; i < nlists; i++) {
+    if (lists[i].ng == nlgrps - l0 &&
+        memcmp(&lgrps[lists[i].g0], &lgrps[l0],
+               (nlgrps - l0) * sizeof(int)) == 0) {
+      nlgrps = l0;
+      return i + 1;
+    }
+  }
+  GROW(nlists + 1, lists, BCAttrList);
+  lists[nlists].g0 = l0;
+  lists[nlists].ng = nlgrps - l0;
+  return ++nlists;
+}
+
+/*
+ * Metadata
+ */
+
+/* record codes of the METADATA block */
+#define MD_STRING_OLD 1
+#define MD_VALUE 2
+#define MD_NODE 3
+#define MD_NAME 4
+#define MD_DISTINCT_NODE 5
+#define MD_KIND 6
+#define MD_LOCATION 7
+#define MD_NAMED_NODE 10
+#define MD_ATTACHMENT 11
+#define MD_SUBRANGE 13
+#define MD_ENUMERATOR 14
+#define MD_BASIC_TYPE 15
+#define MD_FILE 16
+#define MD_DERIVED_TYPE 17
+#define MD_COMPOSITE_TYPE 18
+#define MD_SUBROUTINE_TYPE 19
+#define MD_COMPILE_UNIT 20
+#define MD_SUBPROGRAM 21
+#define MD_LEXICAL_BLOCK 22
+#define MD_LEXICAL_BLOCK_FILE 23
+#define MD_NAMESPACE 24
+#define MD_GLOBAL_VAR 27
+#define MD_LOCAL_VAR 28
+#define MD_EXPRESSION 29
+#define MD_GLOBAL_DECL_ATTACHMENT 36
+#define MD_GLOBAL_VAR_EXPR 37
+
+static LLVMModuleRef bc_module;
+static unsigned md_nstrings, md_nvalues, md_nnodes;
+
+/* Metadata id of node !n, plus one; 0 for null */
+#define MD_NODE_ID(n) ((n) ? md_nstrings + md_nvalues + (n) : 0)
+
+static LL_MDRef
+md_elem(const LL_MDNode *node, unsigned i)
+{
+  return i < node->num_elems ? node->elem[i] : LL_MDREF_ctor(MDRef_Node, 0);
+}
+
+/* Nodes that ll_write_metadata() writes as plain !{...} tuples */
+static bool
+md_is_plain(const LL_MDNode *node)
+{
+  switch (node->mdclass) {
+  case LL_PlainMDNode:
+  case LL_DITemplateTypeParameter:
+  case LL_DITemplateValueParameter:
+  case LL_DIObjCProperty:
+  case LL_DIImportedEntity:
+    return true;
+  case LL_DIFile:
+    return LL_MDREF_kind(node->elem[0]) != MDRef_String;
+  default:
+    return false;
+  }
+}
+
+static BCVal
+md_small_int(LL_MDRef ref)
+{
+  switch (LL_MDREF_kind(ref)) {
+  case MDRef_SmallInt1:
+    return int_const(t_i1, LL_MDREF_value(ref));
+  case MDRef_SmallInt32:
+    return int_const(t_i32, LL_MDREF_value(ref));
+  default:
+    return int_const(t_i64, LL_MDREF_value(ref));
+  }
+}
+
+/* The metadata value for module->constants[idx] */
+static int
+md_llconst(unsigned idx)
+{
+  const LL_Value *c = bc_module->constants[idx];
+  LL_Type *type = c->type_struct;
+  BCVal v;
+
+  GROW((int)idx + 1, mdval_of_llconst, int);
+  while (nmdval_of_llconst <= (int)idx)
+    mdval_of_llconst[nmdval_of_llconst++] = -1;
+  if (mdval_of_llconst[idx] < 0) {
+    if (type->data_type >= LL_I1 && type->data_type <= LL_I256) {
+      if (strcmp(c->data, "true") == 0)
+        v = ll_bc_int(ll_bc_type(type), 1);
+      else if (strcmp(c->data, "false") == 0)
+        v = ll_bc_int(ll_bc_type(type), 0);
+      else
+        v = ll_bc_int(ll_bc_type(type), strtoll(c->data, NULL, 10));
+    } else if (type->data_type == LL_PTR && c->data[0] == '@') {
+      v = ll_bc_global(c->data, ll_bc_type(type));
+    } else {
+      bc_error("unsupported metadata constant", c->data);
+    }
+    mdval_of_llconst[idx] = mdval_for(v);
+  }
+  return mdval_of_llconst[idx];
+}
+
+/* Enter the constants and small integers of plain nodes as metadata
+   values. */
+static void
+collect_md_values(void)
+{
+  unsigned i, j;
+
+  for (i = 0; i < bc_module->mdnodes_count; i++) {
+    const LL_MDNode *node = bc_module->mdnodes[i];
+    if (!md_is_plain(node))
+      continue;
+    for (j = 0; j < node->num_elems; j++) {
+      LL_MDRef ref = node->elem[j];
+      switch (LL_MDREF_kind(ref)) {
+      case MDRef_Constant:
+        md_llconst(LL_MDREF_value(ref));
+        break;
+      case MDRef_SmallInt1:
+      case MDRef_SmallInt32:
+      case MDRef_SmallInt64:
+        mdval_for(md_small_int(ref));
+        break;
+      }
+    }
+  }
+}
+
+/* Metadata id of an element of a plain node, plus one; 0 for null */
+static unsigned
+md_ref_id(LL_MDRef ref)
+{
+  unsigned v = LL_MDREF_value(ref);
+
+  switch (LL_MDREF_kind(ref)) {
+  case MDRef_Node:
+    return MD_NODE_ID(v);
+  case MDRef_String:
+    return v + 1;
+  case MDRef_Constant:
+    return md_nstrings + md_llconst(v) + 1;
+  default:
+    return md_nstrings + mdval_for(md_small_int(ref)) + 1;
+  }
+}
+
+/* A string field of a debug info node; empty strings are omitted */
+static unsigned
+md_str(LL_MDRef ref)
+{
+  unsigned v = LL_MDREF_value(ref);
+
+  if (LL_MDREF_kind(ref) != MDRef_String)
+    return 0;
+  if (strcmp(bc_module->mdstrings[v], "!\"\"") == 0)
+    return 0;
+  return v + 1;
+}
+
+static unsigned
+md_node(LL_MDRef ref)
+{
+  if (LL_MDREF_kind(ref) != MDRef_Node)
+    return md_ref_id(ref);
+  return MD_NODE_ID(LL_MDREF_value(ref));
+}
+
+static BIGINT64
+md_int(LL_MDRef ref)
+{
+  const char *data;
+
+  switch (LL_MDREF_kind(ref)) {
+  case MDRef_SmallInt1:
+  case MDRef_SmallInt32:
+  case MDRef_SmallInt64:
+    return LL_MDREF_value(ref);
+  case MDRef_Constant:
+    data = bc_module->constants[LL_MDREF_value(ref)]->data;
+    if (strcmp(data, "true") == 0)
+      return 1;
+    return strtoll(data, NULL, 10);
+  default:
+    return 0;
+  }
+}
+
+/* An unsigned field; negative 32-bit values are written as unsigned like
+   write_mdfield() does. */
+static BIGUINT64
+md_uint(LL_MDRef ref)
+{
+  BIGINT64 v = md_int(ref);
+
+  if (v < 0 && v >= INT_MIN)
+    return (unsigned)(int)v;
+  return (BIGUINT64)v;
+}
+
+static BIGUINT64
+dw_op(LL_MDRef ref)
+{
+  unsigned v = LL_MDREF_value(ref);
+
+  if (!(v & 1))
+    return v >> 1;
+  switch (v >> 1) {
+  case LL_DW_OP_deref:
+    return 0x06;
+  case LL_DW_OP_plus:
+    return 0x22;
+  case LL_DW_OP_LLVM_fragment:
+    return 0x1000;
+  case LL_DW_OP_swap:
+    return 0x16;
+  case LL_DW_OP_xderef:
+    return 0x18;
+  case LL_DW_OP_stack_value:
+    return 0x9f;
+  default:
+    interr("bitcode writer: unsupported DWARF expression operation", v >> 1,
+           ERR_Fatal);
+  }
+  return 0;
+}
+
+static void
+write_md_string(const char *s)
+{
+  /* s is formatted as !"..." with \xx escapes */
+  const char *end = s + strlen(s) - 1;
+
+  for (s += 2; s < end; s++) {
+    if (*s == '\\' && s + 2 < end + 1 && hexval(s[1]) >= 0 &&
+        hexval(s[2]) >= 0) {
+      rec_push(hexval(s[1]) * 16 + hexval(s[2]));
+      s += 2;
+    } else {
+      rec_push((unsigned char)*s);
+    }
+  }
+  rec_emit(MD_STRING_OLD);
+}
+
+/* Write a debug info node; the element numbers are those of the MDTemplates
+   used by ll_write_metadata() for LLVM 4.0. */
+static void
+write_md_node(const LL_MDNode *node)
+{
+  unsigned d = node->is_distinct;
+  unsigned i;
+
+#define E(i) md_elem(node, i)
+  if (md_is_plain(node)) {
+    for (i = 0; i < node->num_elems; i++)
+      rec_push(md_ref_id(node->elem[i]));
+    rec_emit(d ? MD_DISTINCT_NODE : MD_NODE);
+    return;
+  }
+  switch (node->mdclass) {
+  case LL_DICompileUnit:
+    rec_push(1);
+    rec_push(md_uint(E(2)));
+    rec_push(md_node(E(1)));
+    rec_push(md_str(E(3)));
+    rec_push(md_uint(E(4)));
+    rec_push(md_str(E(5)));
+    rec_push(md_uint(E(6)));
+    rec_push(md_str(E(12)));
+    switch (md_uint(E(10))) {
+    case 2:
+      rec_push(0); /* NoDebug */
+      break;
+    case 3:
+      rec_push(2); /* LineTablesOnly */
+      break;
+    default:
+      rec_push(1); /* FullDebug */
+      break;
+    }
+    rec_push(md_node(E(7)));
+    rec_push(md_node(E(8)));
+    rec_push(0);
+    rec_push(md_node(E(9)));
+    rec_push(md_node(E(11)));
+    rec_push(0);
+    rec_push(0);
+    rec_push(1);
+    rec_emit(MD_COMPILE_UNIT);
+    break;
+  case LL_DIFile:
+    rec_push(d);
+    rec_push(md_str(E(0)));
+    rec_push(md_str(E(1)));
+    rec_emit(MD_FILE);
+    break;
+  case LL_DIBasicType:
+    rec_push(d);
+    rec_push(md_uint(E(0)) & 0xffff);
+    rec_push(md_str(E(3)));
+    rec_push(md_uint(E(5)));
+    rec_push(md_uint(E(6)));
+    rec_push(md_uint(E(9)));
+    rec_emit(MD_BASIC_TYPE);
+    break;
+  case LL_DISubroutineType:
+    rec_push(2 | d);
+    rec_push(0);
+    rec_push(md_node(E(10)));
+    rec_push(0);
+    rec_emit(MD_SUBROUTINE_TYPE);
+    break;
+  case LL_DIDerivedType:
+  case LL_DICompositeType:
+    rec_push(d);
+    rec_push(md_uint(E(0)) & 0xffff);
+    rec_push(md_str(E(3)));
+    rec_push(md_node(E(1)));
+    rec_push(md_uint(E(4)));
+    rec_push(md_node(E(2)));
+    rec_push(md_node(E(9)));
+    rec_push(md_uint(E(5)));
+    rec_push(md_uint(E(6)));
+    rec_push(md_uint(E(7)));
+    rec_push(md_uint(E(8)));
+    if (node->mdclass == LL_DIDerivedType) {
+      rec_push(0);
+      rec_emit(MD_DERIVED_TYPE);
+      break;
+    }
+    rec_push(md_node(E(10)));
+    rec_push(md_uint(E(11)));
+    rec_push(md_node(E(12)));
+    rec_push(md_node(E(13)));
+    rec_push(md_str(E(14)));
+    rec_emit(MD_COMPOSITE_TYPE);
+    break;
+  case LL_DISubRange:
+    rec_push(d);
+    rec_push((BIGUINT64)md_int(E(2)));
+    rec_push_signed(md_int(E(1)));
+    rec_emit(MD_SUBRANGE);
+    break;
+  case LL_DIEnumerator:
+    rec_push(d);
+    rec_push_signed(md_int(E(2)));
+    rec_push(md_str(E(1)));
+    rec_emit(MD_ENUMERATOR);
+    break;
+  case LL_DINamespace:
+    rec_push(d);
+    rec_push(md_node(E(2)));
+    rec_push(md_node(E(1)));
+    rec_push(md_str(E(3)));
+    rec_push(md_uint(E(4)));
+    rec_emit(MD_NAMESPACE);
+    break;
+  case LL_DIGlobalVariable:
+    rec_push(2 | d);
+    rec_push(md_node(E(2)));
+    rec_push(md_str(E(3)));
+    rec_push(md_str(E(5)));
+    rec_push(md_node(E(6)));
+    rec_push(md_uint(E(7)));
+    rec_push(md_node(E(8)));
+    rec_push(md_uint(E(9)));
+    rec_push(md_uint(E(10)));
+    rec_push(0); /* expression */
+    rec_push(0); /* staticDataMemberDeclaration */
+    rec_push(0); /* alignInBits */
+    rec_emit(MD_GLOBAL_VAR);
+    break;
+  case LL_DISubprogram:
+    rec_push(2 | d);
+    rec_push(md_node(E(2)));
+    rec_push(md_str(E(3)));
+    rec_push(md_str(E(5)));
+    rec_push(md_node(E(1)));
+    rec_push(md_uint(E(6)));
+    rec_push(md_node(E(7)));
+    rec_push(md_uint(E(8)));
+    rec_push(md_uint(E(9)));
+    rec_push(md_uint(E(20)));
+    rec_push(md_node(E(12)));
+    rec_push(md_uint(E(10)));
+    rec_push(md_uint(E(11)));
+    rec_push(md_uint(E(13)));
+    rec_push(md_uint(E(14)));
+    rec_push(md_node(E(18)));
+    rec_push(md_node(E(16)));
+    rec_push(md_node(E(17)));
+    rec_push(md_node(E(19)));
+    rec_push(0);
+    rec_emit(MD_SUBPROGRAM);
+    break;
+  case LL_DILexicalBlock:
+    rec_push(d);
+    rec_push(md_node(E(2)));
+    rec_push(md_node(E(1)));
+    rec_push(md_uint(E(3)));
+    rec_push(md_uint(E(4)));
+    rec_emit(MD_LEXICAL_BLOCK);
+    break;
+  case LL_DILexicalBlockFile:
+    rec_push(d);
+    rec_push(md_node(E(2)));
+    rec_push(md_node(E(1)));
+    rec_push(md_uint(E(3)));
+    rec_emit(MD_LEXICAL_BLOCK_FILE);
+    break;
+  case LL_DILocation:
+    rec_push(d);
+    rec_push(md_uint(E(0)));
+    rec_push(md_uint(E(1)));
+    rec_push(md_node(E(2)) - 1);
+    rec_push(md_node(E(3)));
+    rec_emit(MD_LOCATION);
+    break;
+  case LL_DILocalVariable:
+    rec_push(2 | d);
+    rec_push(md_node(E(0)));
+    rec_push(md_str(E(1)));
+    rec_push(md_node(E(3)));
+    rec_push(md_uint(E(4)));
+    rec_push(md_node(E(5)));
+    rec_push(md_uint(E(2)));
+    rec_push(md_uint(E(6)));
+    rec_push(0);
+    rec_emit(MD_LOCAL_VAR);
+    break;
+  case LL_DIExpression:
+    rec_push(2 | d);
+    for (i = 0; i < node->num_elems; i++)
+      rec_push(dw_op(node->elem[i]));
+    rec_emit(MD_EXPRESSION);
+    break;
+  case LL_DIGlobalVariableExpression:
+    rec_push(d);
+    rec_push(md_node(E(0)));
+    rec_push(md_node(E(1)));
+    rec_emit(MD_GLOBAL_VAR_EXPR);
+    break;
+  default:
+    interr("bitcode writer: unsupported metadata class", node->mdclass,
+           ERR_Fatal);
+  }
+#undef E
+}
+
+static const char *const md_names[MD_NUM_NAMES] = {
+    "llvm.module.flags", "llvm.dbg.cu", "opencl.kernels", "nvvm.annotations",
+    "nvvmir.version"};
+
+static void
+write_md_attachments(const BCAtt *a, int na)
+{
+  int i;
+
+  for (i = 0; i < na; i++) {
+    rec_push(a[i].kind);
+    rec_push(MD_NODE_ID(a[i].node) - 1);
+  }
+}
+
+static void
+write_metadata(void)
+{
+  unsigned i, j;
+  int gi;
+
+  if (md_nstrings + md_nvalues + md_nnodes == 0) {
+    for (gi = 0; gi < nglobals; gi++)
+      if (globals[gi].natt)
+        break;
+    if (gi == nglobals)
+      return;
+  }
+  bs_enter(BLK_METADATA);
+  for (i = 0; i < md_nstrings; i++)
+    write_md_string(bc_module->mdstrings[i]);
+  for (i = 0; i < md_nvalues; i++) {
+    rec_push(types[mdvals[i].ty].id);
+    rec_push(mdvals[i].kind == V_GLOBAL ? globals[mdvals[i].idx].id
+                                        : consts[mdvals[i].idx].id);
+    rec_emit(MD_VALUE);
+  }
+  for (i = 0; i < md_nnodes; i++)
+    write_md_node(bc_module->mdnodes[i]);
+  for (i = 0; i < MD_NUM_NAMES; i++) {
+    const LL_MDNode *node = bc_module->named_mdnodes[i];
+    if (!node)
+      continue;
+    rec_push_chars(md_names[i], strlen(md_names[i]));
+    rec_emit(MD_NAME);
+    for (j = 0; j < node->num_elems; j++)
+      rec_push(md_ref_id(node->elem[j]) - 1);
+    rec_emit(MD_NAMED_NODE);
+  }
+  for (gi = 0; gi < nglobals; gi++) {
+    const BCGlobal *g = &globals[gi];
+    if (g->natt && (g->kind == G_VAR || g->body < 0)) {
+      rec_push(g->id);
+      write_md_attachments(&gatts[g->att], g->natt);
+      rec_emit(MD_GLOBAL_DECL_ATTACHMENT);
+    }
+  }
+  bs_exit();
+}
+
+static void
+write_md_kinds(void)
+{
+  int i;
+
+  bs_enter(BLK_METADATA_KIND);
+  for (i = 0; i < nmdkinds; i++) {
+    rec_push(i);
+    rec_push_chars(mdkinds[i], strlen(mdkinds[i]));
+    rec_emit(MD_KIND);
+  }
+  bs_exit();
+}
+
+/*
+ * Types
+ */
+
+/* Number the types so that every type follows its elements, except for the
+   references to named structs, which may be forward references. */
+static void
+number_type(int t)
+{
+  const BCType *ty = &types[t];
+  unsigned i;
+
+  if (ty->id != -1)
+    return;
+  switch (ty->kind) {
+  case BT_PTR:
+  case BT_ARRAY:
+  case BT_VECTOR:
+    number_type(ty->sub);
+    break;
+  case BT_STRUCT:
+    for (i = 0; i < ty->n; i++)
+      number_type(tpool[ty->sub + i]);
+    break;
+  case BT_FUNC:
+    for (i = 0; i <= ty->n; i++)
+      number_type(tpool[ty->sub + i]);
+    break;
+  case BT_NAMED:
+    types[t].id = -2; /* being numbered */
+    if (ty->state == 2) {
+      const BCType *body = &types[ty->sub];
+      for (i = 0; i < body->n; i++)
+        number_type(tpool[body->sub + i]);
+    }
+    break;
+  default:
+    break;
+  }
+  GROW(ntorder + 1, torder, int);
+  types[t].id = ntorder;
+  torder[ntorder++] = t;
+}
+
+/* record codes of the TYPE block */
+#define TY_NUMENTRY 1
+#define TY_VOID 2
+#define TY_FLOAT 3
+#define TY_DOUBLE 4
+#define TY_LABEL 5
+#define TY_OPAQUE 6
+#define TY_INTEGER 7
+#define TY_POINTER 8
+#define TY_HALF 10
+#define TY_ARRAY 11
+#define TY_VECTOR 12
+#define TY_X86_FP80 13
+#define TY_FP128 14
+#define TY_PPC_FP128 15
+#define TY_METADATA 16
+#define TY_STRUCT_ANON 18
+#define TY_STRUCT_NAME 19
+#define TY_STRUCT_NAMED 20
+#define TY_FUNCTION 21
+
+static void
+write_types(void)
+{
+  int i;
+  unsigned j;
+
+  bs_enter(BLK_TYPE);
+  rec_push(ntorder);
+  rec_emit(TY_NUMENTRY);
+  for (i = 0; i < ntorder; i++) {
+    const BCType *t = &types[torder[i]];
+    switch (t->kind) {
+    case BT_VOID:
+      rec_emit(TY_VOID);
+      break;
+    case BT_HALF:
+      rec_emit(TY_HALF);
+      break;
+    case BT_FLOAT:
+      rec_emit(TY_FLOAT);
+      break;
+    case BT_DOUBLE:
+      rec_emit(TY_DOUBLE);
+      break;
+    case BT_X86_FP80:
+      rec_emit(TY_X86_FP80);
+      break;
+    case BT_FP128:
+      rec_emit(TY_FP128);
+      break;
+    case BT_PPC_FP128:
+      rec_emit(TY_PPC_FP128);
+      break;
+    case BT_LABEL:
+      rec_emit(TY_LABEL);
+      break;
+    case BT_METADATA:
+      rec_emit(TY_METADATA);
+      break;
+    case BT_INT:
+      rec_push(t->n);
+      rec_emit(TY_INTEGER);
+      break;
+    case BT_PTR:
+      rec_push(types[t->sub].id);
+      rec_push(t->n);
+      rec_emit(TY_POINTER);
+      break;
+    case BT_ARRAY:
+    case BT_VECTOR:
+      rec_push(t->count);
+      rec_push(types[t->sub].id);
+      rec_emit(t->kind == BT_ARRAY ? TY_ARRAY : TY_VECTOR);
+      break;
+    case BT_STRUCT:
+      rec_push(t->packed);
+      for (j = 0; j < t->n; j++)
+        rec_push(types[tpool[t->sub + j]].id);
+      rec_emit(TY_STRUCT_ANON);
+      break;
+    case BT_FUNC:
+      rec_push(t->vararg);
+      for (j = 0; j <= t->n; j++)
+        rec_push(types[tpool[t->sub + j]].id);
+      rec_emit(TY_FUNCTION);
+      break;
+    case BT_NAMED:
+      rec_push_chars(t->name, strlen(t->name));
+      rec_emit(TY_STRUCT_NAME);
+      if (t->state == 2) {
+        const BCType *body = &types[t->sub];
+        rec_push(body->packed);
+        for (j = 0; j < body->n; j++)
+          rec_push(types[tpool[body->sub + j]].id);
+        rec_emit(TY_STRUCT_NAMED);
+      } else {
+        rec_push(0);
+        rec_emit(TY_OPAQUE);
+      }
+      break;
+    }
+  }
+  bs_exit();
+}
+
+/*
+ * Attributes
+ */
+
+static void
+write_attributes(void)
+{
+  int i, j;
+
+  if (ngrps == 0)
+    return;
+  bs_enter(BLK_PARAMATTR_GROUP);
+  for (i = 0; i < ngrps; i++) {
+    rec_push(i + 1);
+    rec_push(grps[i].idx);
+    for (j = 0; j < grps[i].na; j++) {
+      const BCAttr *a = &sattrs[grps[i].a0 + j];
+      rec_push(a->kind);
+      switch (a->kind) {
+      case AK_ENUM:
+        rec_push(a->id);
+        break;
+      case AK_INT:
+        rec_push(a->id);
+        rec_push(a->val);
+        break;
+      case AK_STRVAL:
+        rec_push_chars(a->key, strlen(a->key) + 1);
+        rec_push_chars(a->value, strlen(a->value) + 1);
+        break;
+      default:
+        rec_push_chars(a->key, strlen(a->key) + 1);
+        break;
+      }
+    }
+    rec_emit(3); /* PARAMATTR_GRP_CODE_ENTRY */
+  }
+  bs_exit();
+
+  bs_enter(BLK_PARAMATTR);
+  for (i = 0; i < nlists; i++) {
+    for (j = 0; j < lists[i].ng; j++)
+      rec_push(lgrps[lists[i].g0 + j] + 1);
+    rec_emit(2); /* PARAMATTR_CODE_ENTRY */
+  }
+  bs_exit();
+}
+
+/*
+ * Module
+ */
+
+/* record codes of the MODULE block */
+#define MOD_VERSION 1
+#define MOD_TRIPLE 2
+#define MOD_DATALAYOUT 3
+#define MOD_SECTIONNAME 5
+#define MOD_GLOBALVAR 7
+#define MOD_FUNCTION 8
+#define MOD_ALIAS 14
+
+/* record codes of the CONSTANTS block */
+#define CST_SETTYPE 1
+#define CST_NULL 2
+#define CST_UNDEF 3
+#define CST_INTEGER 4
+#define CST_WIDE_INTEGER 5
+#define CST_FLOAT 6
+#define CST_AGGREGATE 7
+#define CST_STRING 8
+#define CST_CSTRING 9
+#define CST_CE_BINOP 10
+#define CST_CE_CAST 11
+#define CST_CE_GEP 12
+#define CST_CE_CMP 17
+#define CST_CE_INBOUNDS_GEP 20
+#define CST_BLOCKADDRESS 21
+
+static int nmodvals; /* number of module-level values */
+
+static unsigned
+abs_id(const BCVal *v)
+{
+  switch (v->kind) {
+  case V_GLOBAL:
+    return globals[v->idx].id;
+  case V_CONST:
+    return consts[v->idx].id;
+  case V_LOCAL:
+  case V_BB:
+    return slots[v->idx].id;
+  default:
+    interr("bitcode writer: bad value kind", v->kind, ERR_Fatal);
+  }
+  return 0;
+}
+
+/* Resolve names, attributes and metadata values, and number the types and
+   the module-level values. */
+static void
+finish_module(void)
+{
+  int i, id = 0;
+  BCGlobalKind kind;
+
+  if (cur_func >= 0)
+    bc_error("function not ended", globals[funcs[cur_func].g].name);
+  collect_md_values();
+  md_nstrings = bc_module->mdstrings_count;
+  md_nvalues = nmdvals;
+  md_nnodes = bc_module->mdnodes_count;
+
+  for (i = 0; i < nglobals; i++) {
+    BCGlobal *g = &globals[i];
+    if (g->kind == G_UNDEF) {
+      char buf[200];
+      snprintf(buf, sizeof(buf), "bitcode writer: @%.150s is not defined",
+               g->name);
+      interr(buf, 0, ERR_Fatal);
+    }
+    g->attrs = g->kind == G_FUNC ? resolve_attrs(g->attrs) : 0;
+    g->ptrty = ptr_type(g->type, g->kind == G_FUNC ? 0 : g->addrspace);
+  }
+  for (i = 0; i < ninsts; i++)
+    if (insts[i].op == BC_CALL)
+      insts[i].attrs = resolve_attrs(insts[i].attrs);
+
+  for (i = 0; i < ntypes; i++)
+    number_type(i);
+
+  for (kind = G_VAR; kind <= G_ALIAS; kind++)
+    for (i = 0; i < ngorder; i++)
+      if (globals[gorder[i]].kind == kind)
+        globals[gorder[i]].id = id++;
+  for (i = 0; i < nconsts; i++)
+    consts[i].id = id++;
+  nmodvals = id;
+}
+
+static void
+write_globals(void)
+{
+  int i;
+
+  for (i = 0; i < nsections; i++) {
+    rec_push_chars(sections[i], strlen(sections[i]));
+    rec_emit(MOD_SECTIONNAME);
+  }
+  for (i = 0; i < ngorder; i++) {
+    const BCGlobal *g = &globals[gorder[i]];
+    if (g->kind != G_VAR)
+      continue;
+    rec_push(types[g->type].id);
+    rec_push(g->addrspace << 2 | 2 | g->isconst);
+    rec_push(g->init.kind != V_NONE ? abs_id(&g->init) + 1 : 0);
+    rec_push(g->linkage);
+    rec_push(log2_align(g->align));
+    rec_push(g->section);
+    rec_push(g->visibility);
+    rec_push(g->tls);
+    rec_push(g->unnamed);
+    rec_push(g->extinit);
+    rec_push(g->dll);
+    rec_push(0);
+    rec_emit(MOD_GLOBALVAR);
+  }
+  for (i = 0; i < ngorder; i++) {
+    const BCGlobal *g = &globals[gorder[i]];
+    if (g->kind != G_FUNC)
+      continue;
+    rec_push(types[g->type].id);
+    rec_push(g->cc);
+    rec_push(g->body < 0);
+    rec_push(g->linkage);
+    rec_push(g->attrs);
+    rec_push(log2_align(g->align));
+    rec_push(g->section);
+    rec_push(g->visibility);
+    rec_push(0);
+    rec_push(g->unnamed);
+    rec_push(0);
+    rec_push(g->dll);
+    rec_push(0);
+    rec_push(0);
+    rec_push(0);
+    rec_emit(MOD_FUNCTION);
+  }
+  for (i = 0; i < ngorder; i++) {
+    const BCGlobal *g = &globals[gorder[i]];
+    if (g->kind != G_ALIAS)
+      continue;
+    rec_push(types[g->type].id);
+    rec_push(g->addrspace);
+    rec_push(abs_id(&g->init));
+    rec_push(g->linkage);
+    rec_push(g->visibility);
+    rec_push(g->dll);
+    rec_push(g->tls);
+    rec_push(g->unnamed);
+    rec_emit(MOD_ALIAS);
+  }
+}
+
+/* The number of the basic block label in the function gi */
+static unsigned
+block_number(int gi, const char *label)
+{
+  const BCFunc *f;
+  int i;
+
+  if (globals[gi].body < 0)
+    bc_error("blockaddress of a declaration", globals[gi].name);
+  f = &funcs[globals[gi].body];
+  for (i = 0; i < f->nslots; i++) {
+    const BCSlot *sl = &slots[f->slot0 + i];
+    if (sl->kind == SL_BB && sl->name && strcmp(sl->name, label) == 0)
+      return sl->id;
+  }
+  bc_error("blockaddress of an unknown label", label);
+  return 0;
+}
+
+static void
+write_constants(void)
+{
+  int i, j, curty = -1;
+
+  if (nconsts == 0)
+    return;
+  bs_enter(BLK_CONSTANTS);
+  for (i = 0; i < nconsts; i++) {
+    const BCConst *c = &consts[i];
+    const BCVal *ops = &vpool[c->sub];
+    if (c->type != curty) {
+      curty = c->type;
+      rec_push(types[curty].id);
+      rec_emit(CST_SETTYPE);
+    }
+    switch (c->kind) {
+    case C_INT:
+      rec_push_signed((BIGINT64)c->v[0]);
+      rec_emit(CST_INTEGER);
+      break;
+    case C_WIDE:
+      rec_push_signed((BIGINT64)c->v[0]);
+      rec_push_signed((BIGINT64)c->v[1]);
+      rec_emit(CST_WIDE_INTEGER);
+      break;
+    case C_FP:
+      if (types[c->type].kind == BT_X86_FP80) {
+        rec_push((c->v[1] << 48) | (c->v[0] >> 16));
+        rec_push(c->v[0] & 0xffff);
+      } else if (types[c->type].kind == BT_FP128 ||
+                 types[c->type].kind == BT_PPC_FP128) {
+        rec_push(c->v[0]);
+        rec_push(c->v[1]);
+      } else {
+        rec_push(c->v[0]);
+      }
+      rec_emit(CST_FLOAT);
+      break;
+    case C_NULL:
+      rec_emit(CST_NULL);
+      break;
+    case C_UNDEF:
+      rec_emit(CST_UNDEF);
+      break;
+    case C_AGG:
+      for (j = 0; j < c->n; j++)
+        rec_push(abs_id(&ops[j]));
+      rec_emit(CST_AGGREGATE);
+      break;
+    case C_STR:
+      if (c->n > 0 && c->str[c->n - 1] == '\0' &&
+          memchr(c->str, '\0', c->n - 1) == NULL) {
+        rec_push_chars(c->str, c->n - 1);
+        rec_emit(CST_CSTRING);
+      } else {
+        rec_push_chars(c->str, c->n);
+        rec_emit(CST_STRING);
+      }
+      break;
+    case C_CAST:
+      rec_push(c->opc);
+      rec_push(types[ops[0].ty].id);
+      rec_push(abs_id(&ops[0]));
+      rec_emit(CST_CE_CAST);
+      break;
+    case C_GEP:
+      rec_push(types[c->srcty].id);
+      for (j = 0; j < c->n; j++) {
+        rec_push(types[ops[j].ty].id);
+        rec_push(abs_id(&ops[j]));
+      }
+      rec_emit(c->opc ? CST_CE_INBOUNDS_GEP : CST_CE_GEP);
+      break;
+    case C_BLOCKADDR:
+      rec_push(types[globals[ops[0].idx].ptrty].id);
+      rec_push(abs_id(&ops[0]));
+      rec_push(block_number(ops[0].idx, c->str));
+      rec_emit(CST_BLOCKADDRESS);
+      break;
+    }
+  }
+  bs_exit();
+}
+
+/* record codes of the VALUE_SYMTAB block */
+#define VST_ENTRY 1
+#define VST_BBENTRY 2
+
+static void
+write_module_symtab(void)
+{
+  int i;
+
+  if (nglobals == 0)
+    return;
+  bs_enter(BLK_VALUE_SYMTAB);
+  for (i = 0; i < nglobals; i++) {
+    rec_push(globals[i].id);
+    rec_push_chars(globals[i].name, strlen(globals[i].name));
+    rec_emit(VST_ENTRY);
+  }
+  bs_exit();
+}
+
+/*
+ * Function bodies
+ */
+
+/* record codes of the FUNCTION block */
+#define FN_DECLAREBLOCKS 1
+#define FN_BINOP 2
+#define FN_CAST 3
+#define FN_EXTRACTELT 6
+#define FN_INSERTELT 7
+#define FN_SHUFFLEVEC 8
+#define FN_RET 10
+#define FN_BR 11
+#define FN_SWITCH 12
+#define FN_UNREACHABLE 15
+#define FN_PHI 16
+#define FN_ALLOCA 19
+#define FN_LOAD 20
+#define FN_VAARG 23
+#define FN_EXTRACTVAL 26
+#define FN_INSERTVAL 27
+#define FN_CMP2 28
+#define FN_VSELECT 29
+#define FN_INDIRECTBR 31
+#define FN_DEBUG_LOC_AGAIN 33
+#define FN_CALL 34
+#define FN_DEBUG_LOC 35
+#define FN_FENCE 36
+#define FN_ATOMICRMW 38
+#define FN_LOADATOMIC 41
+#define FN_GEP 43
+#define FN_STORE 44
+#define FN_STOREATOMIC 45
+#define FN_CMPXCHG 46
+
+static unsigned inst_num;  /* value id of the next instruction */
+static unsigned lmd_base;  /* metadata id of the first local metadata */
+static int cur_lmd0;
+
+/* Relative id of an operand */
+static void
+push_val(const BCVal *v)
+{
+  switch (v->kind) {
+  case V_MD:
+    rec_push((unsigned)(inst_num - (MD_NODE_ID(v->idx) - 1)));
+    return;
+  case V_MDVAL:
+    rec_push((unsigned)(inst_num - (md_nstrings + v->idx)));
+    return;
+  case V_LMD:
+    rec_push((unsigned)(inst_num - (lmd_base + v->idx - cur_lmd0)));
+    return;
+  default:
+    rec_push((unsigned)(inst_num - abs_id(v)));
+  }
+}
+
+/* Relative id of an operand, followed by its type if it is a forward
+   reference */
+static void
+push_val_type(const BCVal *v)
+{
+  push_val(v);
+  if (v->kind != V_MD && v->kind != V_MDVAL && v->kind != V_LMD &&
+      abs_id(v) >= inst_num)
+    rec_push(types[v->ty].id);
+}
+
+static void
+write_instruction(const BCInst *in)
+{
+  const BCVal *ops = &opool[in->op0];
+  int i, nparams;
+  unsigned cc;
+
+  switch (in->op) {
+  case BC_RET:
+    if (in->nop)
+      push_val_type(&ops[0]);
+    rec_emit(FN_RET);
+    break;
+  case BC_BR:
+    if (in->nop == 1) {
+      rec_push(abs_id(&ops[0]));
+    } else {
+      rec_push(abs_id(&ops[1]));
+      rec_push(abs_id(&ops[2]));
+      push_val(&ops[0]);
+    }
+    rec_emit(FN_BR);
+    break;
+  case BC_SWITCH:
+    rec_push(types[ops[0].ty].id);
+    push_val(&ops[0]);
+    rec_push(abs_id(&ops[1]));
+    for (i = 2; i < in->nop; i++)
+      rec_push(abs_id(&ops[i]));
+    rec_emit(FN_SWITCH);
+    break;
+  case BC_INDBR:
+    rec_push(types[ops[0].ty].id);
+    push_val(&ops[0]);
+    for (i = 1; i < in->nop; i++)
+      rec_push(abs_id(&ops[i]));
+    rec_emit(FN_INDIRECTBR);
+    break;
+  case BC_UNREACH:
+    rec_emit(FN_UNREACHABLE);
+    break;
+  case BC_BINOP:
+    push_val_type(&ops[0]);
+    push_val(&ops[1]);
+    rec_push(in->sub);
+    if (in->flags | in->fmf)
+      rec_push(in->flags | in->fmf);
+    rec_emit(FN_BINOP);
+    break;
+  case BC_CAST:
+    push_val_type(&ops[0]);
+    rec_push(types[in->ty].id);
+    rec_push(in->sub);
+    rec_emit(FN_CAST);
+    break;
+  case BC_GEP:
+    rec_push((in->flags & BC_INBOUNDS) != 0);
+    rec_push(types[in->ty].id);
+    for (i = 0; i < in->nop; i++)
+      push_val_type(&ops[i]);
+    rec_emit(FN_GEP);
+    break;
+  case BC_SELECT:
+    push_val_type(&ops[1]);
+    push_val(&ops[2]);
+    push_val_type(&ops[0]);
+    rec_emit(FN_VSELECT);
+    break;
+  case BC_EXTELT:
+    push_val_type(&ops[0]);
+    push_val_type(&ops[1]);
+    rec_emit(FN_EXTRACTELT);
+    break;
+  case BC_INSELT:
+    push_val_type(&ops[0]);
+    push_val(&ops[1]);
+    push_val_type(&ops[2]);
+    rec_emit(FN_INSERTELT);
+    break;
+  case BC_SHUFFLE:
+    push_val_type(&ops[0]);
+    push_val(&ops[1]);
+    push_val(&ops[2]);
+    rec_emit(FN_SHUFFLEVEC);
+    break;
+  case BC_CMP:
+    push_val_type(&ops[0]);
+    push_val(&ops[1]);
+    rec_push(in->sub);
+    if (in->fmf)
+      rec_push(in->fmf);
+    rec_emit(FN_CMP2);
+    break;
+  case BC_PHI:
+    rec_push(types[in->ty].id);
+    for (i = 0; i < in->nop; i += 2) {
+      rec_push_signed((int)(inst_num - abs_id(&ops[i])));
+      rec_push(abs_id(&ops[i + 1]));
+    }
+    rec_emit(FN_PHI);
+    break;
+  case BC_ALLOCA:
+    rec_push(types[in->ty].id);
+    rec_push(types[ops[0].ty].id);
+    rec_push(abs_id(&ops[0]));
+    rec_push(in->align | 1 << 6);
+    rec_emit(FN_ALLOCA);
+    break;
+  case BC_LOAD:
+    push_val_type(&ops[0]);
+    rec_push(types[in->ty].id);
+    rec_push(in->align);
+    rec_push((in->flags & BC_VOLATILE) != 0);
+    if (in->flags & BC_ATOMIC) {
+      rec_push(in->ord);
+      rec_push((in->flags & BC_SINGLETHREAD) == 0);
+    }
+    rec_emit(in->flags & BC_ATOMIC ? FN_LOADATOMIC : FN_LOAD);
+    break;
+  case BC_STORE:
+    push_val_type(&ops[1]);
+    push_val_type(&ops[0]);
+    rec_push(in->align);
+    rec_push((in->flags & BC_VOLATILE) != 0);
+    if (in->flags & BC_ATOMIC) {
+      rec_push(in->ord);
+      rec_push((in->flags & BC_SINGLETHREAD) == 0);
+    }
+    rec_emit(in->flags & BC_ATOMIC ? FN_STOREATOMIC : FN_STORE);
+    break;
+  case BC_CMPXCHG:
+    push_val_type(&ops[0]);
+    push_val_type(&ops[1]);
+    push_val(&ops[2]);
+    rec_push((in->flags & BC_VOLATILE) != 0);
+    rec_push(in->ord);
+    rec_push((in->flags & BC_SINGLETHREAD) == 0);
+    rec_push(in->ord2);
+    rec_push((in->flags & BC_WEAK) != 0);
+    rec_emit(FN_CMPXCHG);
+    break;
+  case BC_RMW:
+    push_val_type(&ops[0]);
+    push_val(&ops[1]);
+    rec_push(in->sub);
+    rec_push((in->flags & BC_VOLATILE) != 0);
+    rec_push(in->ord);
+    rec_push((in->flags & BC_SINGLETHREAD) == 0);
+    rec_emit(FN_ATOMICRMW);
+    break;
+  case BC_FENCE:
+    rec_push(in->ord);
+    rec_push((in->flags & BC_SINGLETHREAD) == 0);
+    rec_emit(FN_FENCE);
+    break;
+  case BC_VAARG:
+    rec_push(types[ops[0].ty].id);
+    push_val(&ops[0]);
+    rec_push(types[in->ty].id);
+    rec_emit(FN_VAARG);
+    break;
+  case BC_EXTVAL:
+    push_val_type(&ops[0]);
+    for (i = 1; i < in->nop; i++)
+      rec_push((unsigned)ops[i].idx);
+    rec_emit(FN_EXTRACTVAL);
+    break;
+  case BC_INSVAL:
+    push_val_type(&ops[0]);
+    push_val_type(&ops[1]);
+    for (i = 2; i < in->nop; i++)
+      rec_push((unsigned)ops[i].idx);
+    rec_emit(FN_INSERTVAL);
+    break;
+  case BC_CALL:
+    rec_push(in->attrs);
+    cc = in->cc << 1 | 1 << 15;
+    if (in->flags & BC_TAIL)
+      cc |= 1;
+    if (in->flags & BC_MUSTTAIL)
+      cc |= 1 << 14;
+    if (in->flags & BC_NOTAIL)
+      cc |= 1 << 16;
+    if (in->fmf)
+      cc |= 1 << 17;
+    rec_push(cc);
+    if (in->fmf)
+      rec_push(in->fmf);
+    rec_push(types[in->ty].id);
+    push_val_type(&ops[0]);
+    nparams = types[in->ty].n;
+    for (i = 1; i < in->nop; i++) {
+      if (i <= nparams)
+        push_val(&ops[i]);
+      else
+        push_val_type(&ops[i]);
+    }
+    rec_emit(FN_CALL);
+    break;
+  }
+}
+
+static void
+write_function(const BCFunc *f)
+{
+  int i, j, n, last_dbg = 0;
+  bool names = false;
+
+  /* number the arguments and instruction results */
+  n = nmodvals;
+  for (i = 0; i < f->nargs; i++)
+    slots[f->slot0 + i].id = n++;
+  for (i = 0; i < f->ninst; i++) {
+    const BCInst *in = &insts[f->inst0 + i];
+    if (in->value)
+      slots[in->res].id = n++;
+  }
+  for (i = 0; i < f->nslots; i++) {
+    const BCSlot *sl = &slots[f->slot0 + i];
+    if (sl->kind == SL_USED || sl->kind == SL_BBUSED) {
+      char buf[256];
+      snprintf(buf, sizeof(buf),
+               "bitcode writer: %%%.100s is not defined in @%.100s",
+               sl->name ? sl->name : "<number>", globals[f->g].name);
+      interr(buf, 0, ERR_Fatal);
+    }
+    if (sl->name)
+      names = true;
+  }
+
+  bs_enter(BLK_FUNCTION);
+  rec_push(f->nbb);
+  rec_emit(FN_DECLAREBLOCKS);
+
+  lmd_base = md_nstrings + md_nvalues + md_nnodes;
+  cur_lmd0 = f->lmd0;
+  if (f->nlmd) {
+    bs_enter(BLK_METADATA);
+    for (i = 0; i < f->nlmd; i++) {
+      rec_push(types[lmds[f->lmd0 + i].ty].id);
+      rec_push(abs_id(&lmds[f->lmd0 + i]));
+      rec_emit(MD_VALUE);
+    }
+    bs_exit();
+  }
+
+  inst_num = nmodvals + f->nargs;
+  for (i = 0; i < f->ninst; i++) {
+    const BCInst *in = &insts[f->inst0 + i];
+    write_instruction(in);
+    if (in->value)
+      inst_num++;
+    if (in->dbg) {
+      const LL_MDNode *loc = NULL;
+      if (in->dbg == last_dbg) {
+        rec_emit(FN_DEBUG_LOC_AGAIN);
+        continue;
+      }
+      if ((unsigned)in->dbg <= md_nnodes)
+        loc = bc_module->mdnodes[in->dbg - 1];
+      if (loc == NULL || loc->mdclass != LL_DILocation)
+        interr("bitcode writer: !dbg is not a DILocation", in->dbg,
+               ERR_Fatal);
+      rec_push(md_uint(md_elem(loc, 0)));
+      rec_push(md_uint(md_elem(loc, 1)));
+      rec_push(md_node(md_elem(loc, 2)));
+      rec_push(md_node(md_elem(loc, 3)));
+      rec_emit(FN_DEBUG_LOC);
+      last_dbg = in->dbg;
+    }
+  }
+
+  if (names) {
+    bs_enter(BLK_VALUE_SYMTAB);
+    for (i = 0; i < f->nslots; i++) {
+      const BCSlot *sl = &slots[f->slot0 + i];
+      if (!sl->name)
+        continue;
+      rec_push(sl->id);
+      rec_push_chars(sl->name, strlen(sl->name));
+      rec_emit(sl->kind == SL_BB ? VST_BBENTRY : VST_ENTRY);
+    }
+    bs_exit();
+  }
+
+  if (f->natt || globals[f->g].natt) {
+    bs_enter(BLK_METADATA_ATTACHMENT);
+    if (globals[f->g].natt) {
+      write_md_attachments(&gatts[globals[f->g].att], globals[f->g].natt);
+      rec_emit(MD_ATTACHMENT);
+    }
+    for (i = 0; i < f->natt; i = j) {
+      int inst = atts[f->att0 + i].inst;
+      for (j = i; j < f->natt && atts[f->att0 + j].inst == inst; j++)
+        ;
+      rec_push(inst - f->inst0);
+      write_md_attachments(&atts[f->att0 + i], j - i);
+      rec_emit(MD_ATTACHMENT);
+    }
+    bs_exit();
+  }
+  bs_exit();
+}
+
+static void
+write_module(void)
+{
+  int i;
+
+  /* magic 'BC' 0xC0DE */
+  bs.width = 2;
+  bs_emit('B', 8);
+  bs_emit('C', 8);
+  bs_emit(0x0, 4);
+  bs_emit(0xC, 4);
+  bs_emit(0xE, 4);
+  bs_emit(0xD, 4);
+
+  bs_enter(BLK_IDENTIFICATION);
+  rec_push_chars("LLVM4.0", 7);
+  rec_emit(1); /* IDENTIFICATION_CODE_STRING */
+  rec_push(0);
+  rec_emit(2); /* IDENTIFICATION_CODE_EPOCH */
+  bs_exit();
+
+  bs_enter(BLK_MODULE);
+  rec_push(1);
+  rec_emit(MOD_VERSION);
+  write_attributes();
+  write_types();
+  if (bc_module->target_triple && *bc_module->target_triple) {
+    rec_push_chars(bc_module->target_triple,
+                   strlen(bc_module->target_triple));
+    rec_emit(MOD_TRIPLE);
+  }
+  if (bc_module->datalayout_string && *bc_module->datalayout_string) {
+    rec_push_chars(bc_module->datalayout_string,
+                   strlen(bc_module->datalayout_string));
+    rec_emit(MOD_DATALAYOUT);
+  }
+  write_globals();
+  write_constants();
+  write_md_kinds();
+  write_metadata();
+  write_module_symtab();
+  for (i = 0; i < ngorder; i++)
+    if (globals[gorder[i]].kind == G_FUNC && globals[gorder[i]].body >= 0)
+      write_function(&funcs[globals[gorder[i]].body]);
+  bs_exit();
+}
+
+/*
+ * Driver
+ */
+
+/**
+   \brief Start the bitcode module
+   \param module  the module holding the metadata
+ */
+void
+ll_bc_init(LLVMModuleRef module)
+{
+  int i;
+
+  bc_module = module;
+  type_map = hashmap_alloc(type_hash_functions);
+  tname_map = hashmap_alloc(hash_functions_strings);
+  const_map = hashmap_alloc(const_hash_functions);
+  gname_map = hashmap_alloc(hash_functions_strings);
+  lname_map = hashmap_alloc(hash_functions_strings);
+  mdkind_map = hashmap_alloc(hash_functions_strings);
+  for (i = 0; fixed_md_kinds[i]; i++) {
+    GROW(nmdkinds + 1, mdkinds, const char *);
+    mdkinds[nmdkinds++] = fixed_md_kinds[i];
+    hashmap_insert(mdkind_map, fixed_md_kinds[i], INT2HKEY(nmdkinds));
+  }
+  t_void = simple_type(BT_VOID, 0);
+  t_label = simple_type(BT_LABEL, 0);
+  t_metadata = simple_type(BT_METADATA, 0);
+  t_i1 = simple_type(BT_INT, 1);
+  t_i8 = simple_type(BT_INT, 8);
+  t_i32 = simple_type(BT_INT, 32);
+  t_i64 = simple_type(BT_INT, 64);
+}
+
+#define FREE_ARRAY(name)                                                       \
+  if (name) {                                                                  \
+    FREE(name);                                                                \
+    name = NULL;                                                               \
+  }                                                                            \
+  n##name = name##_size = 0
+
+static void
+bc_fini(void)
+{
+  FREE_ARRAY(types);
+  FREE_ARRAY(tpool);
+  FREE_ARRAY(consts);
+  FREE_ARRAY(vpool);
+  FREE_ARRAY(opool);
+  FREE_ARRAY(globals);
+  FREE_ARRAY(funcs);
+  FREE_ARRAY(slots);
+  FREE_ARRAY(insts);
+  FREE_ARRAY(atts);
+  FREE_ARRAY(gatts);
+  FREE_ARRAY(mdvals);
+  FREE_ARRAY(lmds);
+  FREE_ARRAY(attrs);
+  FREE_ARRAY(specs);
+  FREE_ARRAY(sattrs);
+  FREE_ARRAY(rattrs);
+  FREE_ARRAY(grps);
+  FREE_ARRAY(lgrps);
+  FREE_ARRAY(lists);
+  FREE_ARRAY(tstk);
+  FREE_ARRAY(vstk);
+  FREE_ARRAY(sections);
+  FREE_ARRAY(mdkinds);
+  FREE_ARRAY(numslot);
+  FREE_ARRAY(mdval_of_const);
+  FREE_ARRAY(mdval_of_global);
+  FREE_ARRAY(mdval_of_llconst);
+  FREE_ARRAY(torder);
+  FREE_ARRAY(gorder);
+  FREE_ARRAY(dbytes);
+  hashmap_free(type_map);
+  hashmap_free(tname_map);
+  hashmap_free(const_map);
+  hashmap_free(gname_map);
+  hashmap_free(lname_map);
+  hashmap_free(mdkind_map);
+  while (chunks) {
+    BCChunk *next = chunks->next;
+    free(chunks);
+    chunks = next;
+  }
+  chunk_left = 0;
+  if (rec) {
+    FREE(rec);
+    rec = NULL;
+  }
+  nrec = rec_size = 0;
+  if (bs.buf)
+    FREE(bs.buf);
+  memset(&bs, 0, sizeof(bs));
+  max_numslot = 0;
+  cur_func = -1;
+  bb_open = false;
+  attr_a0 = 0;
+  bc_module = NULL;
+}
+
+/**
+   \brief Write the module built since ll_bc_init() as LLVM bitcode
+ */
+void
+ll_write_bitcode(FILE *out, LLVMModuleRef module)
+{
+  if (module != bc_module)
+    interr("bitcode writer: wrong module", 0, ERR_Fatal);
+  finish_module();
+  write_module();
+  if (fwrite(bs.buf, 1, bs.len, out) != (size_t)bs.len)
+    interr("bitcode writer: write error", bs.len, ERR_Fatal);
+  bc_fini();
+}
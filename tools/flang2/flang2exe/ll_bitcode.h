@@ -0,0 +1,268 @@
+/*
+ * Copyright (c) 2017, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/*
+ * ll_bitcode.h
+ *
+ * Builder for the LLVM bitcode output, see XBIT(216, 0x2).
+ *
+ * In bitcode mode the writers of cgmain.c, llassem.c and friends do not
+ * print the module; each of them has an encode_* counterpart that enters
+ * the same types, globals, constants and instructions through the ll_bc_*
+ * functions below.  ll_write_bitcode() encodes the collected module
+ * together with the metadata of the LL_Module at the end of the file.
+ *
+ * Types are identified by ints.  Values are BCVal handles; a value used
+ * before it is defined (a global, a local or a basic block) is created by
+ * its first reference and must be defined by the end of the module or of
+ * the function.
+ */
+
+#ifndef LL_BITCODE_H_
+#define LL_BITCODE_H_
+
+#include <stdio.h>
+
+#include "ll_structure.h"
+
+/* A value: global, constant, local, basic block or metadata operand */
+typedef struct BCVal {
+  unsigned char kind;
+  int ty;
+  int idx;
+} BCVal;
+
+/* instructions */
+typedef enum BCOp {
+  BC_RET,
+  BC_BR,
+  BC_SWITCH,
+  BC_INDBR,
+  BC_UNREACH,
+  BC_BINOP,
+  BC_CAST,
+  BC_GEP,
+  BC_SELECT,
+  BC_EXTELT,
+  BC_INSELT,
+  BC_SHUFFLE,
+  BC_CMP,
+  BC_PHI,
+  BC_ALLOCA,
+  BC_LOAD,
+  BC_STORE,
+  BC_CALL,
+  BC_EXTVAL,
+  BC_INSVAL,
+  BC_FENCE,
+  BC_RMW,
+  BC_CMPXCHG,
+  BC_VAARG
+} BCOp;
+
+/* BC_BINOP operations; the fp operations are add, sub, ... of fp types */
+enum {
+  BC_ADD,
+  BC_SUB,
+  BC_MUL,
+  BC_UDIV,
+  BC_SDIV,
+  BC_UREM,
+  BC_SREM,
+  BC_SHL,
+  BC_LSHR,
+  BC_ASHR,
+  BC_AND,
+  BC_OR,
+  BC_XOR
+};
+
+/* BC_CAST operations */
+enum {
+  BC_TRUNC,
+  BC_ZEXT,
+  BC_SEXT,
+  BC_FPTOUI,
+  BC_FPTOSI,
+  BC_UITOFP,
+  BC_SITOFP,
+  BC_FPTRUNC,
+  BC_FPEXT,
+  BC_PTRTOINT,
+  BC_INTTOPTR,
+  BC_BITCAST,
+  BC_ADDRSPACECAST
+};
+
+/* BC_RMW operations */
+enum {
+  BC_RMW_XCHG,
+  BC_RMW_ADD,
+  BC_RMW_SUB,
+  BC_RMW_AND,
+  BC_RMW_NAND,
+  BC_RMW_OR,
+  BC_RMW_XOR,
+  BC_RMW_MAX,
+  BC_RMW_MIN,
+  BC_RMW_UMAX,
+  BC_RMW_UMIN
+};
+
+/* atomic orderings */
+enum {
+  BC_NOT_ATOMIC,
+  BC_UNORDERED,
+  BC_MONOTONIC,
+  BC_ACQUIRE,
+  BC_RELEASE,
+  BC_ACQ_REL,
+  BC_SEQ_CST
+};
+
+/* instruction flags; the binary operations take the wrap flags instead */
+#define BC_VOLATILE 0x1
+#define BC_ATOMIC 0x2
+#define BC_WEAK 0x4
+#define BC_SINGLETHREAD 0x8
+#define BC_INBOUNDS 0x10
+#define BC_TAIL 0x20
+#define BC_MUSTTAIL 0x40
+#define BC_NOTAIL 0x80
+
+#define BC_NUW 0x1
+#define BC_NSW 0x2
+#define BC_EXACT 0x1
+
+/* fast-math flags */
+#define BC_FAST 0x1f
+
+/* linkage */
+enum {
+  BC_LINK_EXTERNAL = 0,
+  BC_LINK_APPENDING = 2,
+  BC_LINK_INTERNAL = 3,
+  BC_LINK_EXTERN_WEAK = 7,
+  BC_LINK_COMMON = 8,
+  BC_LINK_PRIVATE = 9,
+  BC_LINK_WEAK = 16,
+  BC_LINK_LINKONCE = 18
+};
+
+/* attribute index of the function; 0 is the return value, i parameter i */
+#define BC_ATTR_FN 0xFFFFFFFFU
+
+bool ll_bitcode_output(void);
+void ll_bc_init(LL_Module *module);
+void ll_write_bitcode(FILE *out, LL_Module *module);
+
+/* Types */
+int ll_bc_type(LL_Type *type);
+int ll_bc_void_type(void);
+int ll_bc_int_type(unsigned bits);
+int ll_bc_ptr_type(int elt);
+int ll_bc_array_type(BIGUINT64 count, int elt);
+int ll_bc_struct_type(const int *elts, int n, bool packed);
+int ll_bc_func_type(int ret, const int *params, int n, bool vararg);
+
+/* A named struct, "%name"; its body is set by ll_bc_type_body(), or it
+   stays opaque. */
+int ll_bc_named_type(const char *name);
+void ll_bc_type_body(int named, int body);
+int ll_bc_elem_type(int ty);
+
+/* Constants */
+BCVal ll_bc_int(int ty, BIGINT64 val);
+BCVal ll_bc_wide_int(int ty, BIGUINT64 lo, BIGUINT64 hi);
+BCVal ll_bc_fp(int ty, BIGUINT64 lo, BIGUINT64 hi);
+BCVal ll_bc_double(int ty, double d);
+BCVal ll_bc_null(int ty);
+BCVal ll_bc_undef(int ty);
+BCVal ll_bc_string(int ty, const char *s, int len);
+BCVal ll_bc_aggregate(int ty, const BCVal *elts, int n);
+BCVal ll_bc_cast_const(unsigned opc, BCVal v, int ty);
+BCVal ll_bc_gep_const(int srcty, BCVal base, const BCVal *idx, int n,
+                      bool inbounds);
+BCVal ll_bc_blockaddress(BCVal fn, const char *label);
+
+/* Build a packed struct constant of byte arrays and pointers, the form of
+   the initialized data written by llassem.c.  The bytes up to the next
+   pointer or ll_bc_data_member() form one [n x i8] member.
+   ll_bc_data_end() gives the constant the named struct type if named is
+   not negative. */
+void ll_bc_data_begin(void);
+void ll_bc_data_member(void);
+void ll_bc_data_byte(unsigned byte);
+void ll_bc_data_bytes(BIGUINT64 val, int n);
+void ll_bc_data_zeros(BIGINT64 n);
+void ll_bc_data_ptr(BCVal ptr);
+BCVal ll_bc_data_end(int named);
+
+/* Globals, named with or without the leading '@' */
+BCVal ll_bc_global(const char *name, int ptrty);
+bool ll_bc_global_defined(const char *name);
+int ll_bc_global_var(const char *name, int ty, int linkage, bool isconst);
+void ll_bc_global_init(int g, BCVal init);
+void ll_bc_global_align(int g, unsigned bytes);
+void ll_bc_global_section(int g, const char *section);
+void ll_bc_global_tls(int g);
+void ll_bc_global_md(int g, const char *kind, LL_MDRef md);
+int ll_bc_alias(const char *name, int ty, BCVal aliasee, int linkage);
+
+/* Functions.  The attributes added since the last declaration, definition
+   or call belong to the next one. */
+void ll_bc_attr(unsigned idx, const char *name);
+void ll_bc_attr_int(unsigned idx, const char *name, BIGUINT64 val);
+void ll_bc_attr_str(unsigned idx, const char *key, const char *value);
+int ll_bc_declare(const char *name, int fty, int linkage);
+int ll_bc_define(const char *name, int fty, int linkage);
+void ll_bc_function_cc(int g, unsigned cc);
+void ll_bc_param(const char *name);
+void ll_bc_end_function(void);
+
+/* Values in the function being defined: locals named "%name" or %n, and
+   basic blocks */
+BCVal ll_bc_local(const char *name, int ty);
+BCVal ll_bc_local_num(int n, int ty);
+BCVal ll_bc_label(const char *name);
+void ll_bc_block(const char *name);
+
+/* Metadata operands */
+BCVal ll_bc_md(LL_MDRef md);
+BCVal ll_bc_md_value(BCVal v);
+unsigned ll_bc_predicate(const char *name, bool fp);
+
+/* Instructions: ll_bc_inst() starts one, the operands and properties
+   follow, ll_bc_end_inst() adds it.  ty is the result type of casts, phi
+   and va_arg, the allocated, loaded or indexed type, and the return type
+   or function type of a call. */
+void ll_bc_inst(BCOp op, int ty);
+void ll_bc_inst_sub(unsigned sub);
+void ll_bc_inst_flags(unsigned flags);
+void ll_bc_inst_fmf(unsigned fmf);
+void ll_bc_inst_align(unsigned bytes);
+void ll_bc_inst_order(unsigned ord, unsigned fail);
+void ll_bc_inst_cc(unsigned cc);
+void ll_bc_inst_md(const char *kind, LL_MDRef md);
+void ll_bc_inst_dbg(LL_MDRef md);
+void ll_bc_operand(BCVal v);
+void ll_bc_imm(unsigned imm);
+void ll_bc_result(const char *name);
+void ll_bc_result_num(int n);
+void ll_bc_end_inst(void);
+
+#endif /* LL_BITCODE_H_ */
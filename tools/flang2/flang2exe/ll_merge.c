@@ -0,0 +1,927 @@
+/*
+ * Copyright (c) 2017, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/** \file
+ * \brief Merge the LLVM IR written by parallel code generation workers
+ *
+ * Each worker (see main.c) writes a complete LLVM module in which only the
+ * routine groups it owns have function bodies.  A line ";@par g" starts
+ * the text written for group g and ";@par end" starts the text written at
+ * the end of the file: the metadata, the declarations and the common
+ * blocks.
+ *
+ * The merged module is the sequence of groups, each taken from its owner
+ * followed by whatever the other workers wrote for it, and then the ends
+ * of the workers' files.  The top-level entities are combined by name:
+ *
+ *   - identical repetitions are dropped;
+ *   - a definition replaces a common, and a common replaces a declaration
+ *     or an external global;
+ *   - common block types "< { [n x i8] } >" of different sizes resolve to
+ *     the largest one, as in a serial compilation;
+ *   - the other named types and the internal definitions are local to the
+ *     module, so when two workers disagree on one, the later is renamed
+ *     with a ".w<worker>" suffix throughout that worker's text;
+ *   - any other disagreement fails.
+ *
+ * Metadata nodes are numbered per worker, so they are renumbered in the
+ * order in which the merged text refers to them, and equal nodes, after
+ * renumbering, are shared.  Distinct and self-referencing nodes are never
+ * shared.
+ *
+ * Nothing is written unless the whole merge succeeds, so that the caller
+ * can compile the file serially instead.
+ */
+
+#include "gbldefs.h"
+#include "error.h"
+#include "global.h"
+#include "ll_structure.h"
+#include "ll_write.h"
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <ctype.h>
+
+/* kinds of top-level entities */
+enum {
+  LM_TEXT,       /* blank line or comment */
+  LM_HEADER,     /* target, source_filename, attributes, ... */
+  LM_TYPE,       /* %name = type ... */
+  LM_GLOBAL,     /* @name = ... */
+  LM_DECLARE,    /* declare ... @name(...) */
+  LM_FUNCTION,   /* define ... @name(...) { ... } */
+  LM_MDNODE,     /* !n = ... */
+  LM_MDNAMED,    /* !name = !{ ... } */
+  LM_MDNAMEDSEC, /* "; Named metadata" */
+  LM_MDSEC       /* "; Metadata" */
+};
+
+/* what rewrite() replaces */
+#define RW_MD 1    /* metadata references !n */
+#define RW_NAMES 2 /* renamed %types and @globals */
+
+#define SEG_END INT_MAX /* segment after ";@par end" */
+#define LM_KEYLEN 1024  /* longest name */
+#define MD_BUSY (-1)
+
+typedef struct {
+  const char *text; /* in the worker's buffer, not terminated */
+  int len;
+  int seg;
+  short part;
+  char kind;
+  char rank; /* LM_GLOBAL etc.: 1 declaration, 2 common, 3 definition */
+  int out;   /* entity written in this place, or -1 */
+  int name;  /* index in names[] */
+} LMEntity;
+
+typedef struct {
+  int first;  /* first entity with this name in output order */
+  int winner; /* entity written in its place */
+  int size;   /* LM_TYPE: bytes of a common block type, or -1 */
+  LOGICAL resized;
+  char *mdtext; /* LM_MDNAMED: operands after renumbering */
+} LMName;
+
+/* per worker: metadata node number -> entity and new number, and the
+ * names that were renamed */
+typedef struct {
+  int *ent;
+  int *map;
+  int size;
+  hashmap_t renames; /* "%name" or "@name" -> new name */
+} LMPart;
+
+static LMEntity *ents;
+static int nents, ents_size;
+static int *order; /* entities in output order */
+static LMName *names;
+static int nnames, names_size;
+static hashmap_t name_map; /* key -> names[] index + 1 */
+static LMPart *parts;
+static int nparts;
+static char **mdnodes; /* merged nodes, 1-based */
+static int nmdnodes, mdnodes_size;
+static hashmap_t mdnode_map; /* node text -> new number */
+static LOGICAL failed;
+
+static int map_md(int part, int id);
+
+static LOGICAL
+starts(const char *p, const char *end, const char *s)
+{
+  size_t n = strlen(s);
+  return (size_t)(end - p) >= n && strncmp(p, s, n) == 0;
+}
+
+static const char *
+line_end(const char *p, const char *end)
+{
+  const char *nl = memchr(p, '\n', end - p);
+  return nl ? nl + 1 : end;
+}
+
+static const char *
+skip_blanks(const char *p, const char *end)
+{
+  while (p < end && (*p == ' ' || *p == '\t'))
+    ++p;
+  return p;
+}
+
+/* The end of the name that follows the sigil at p. */
+static const char *
+name_end(const char *p, const char *end)
+{
+  if (++p < end && *p == '"') {
+    for (++p; p < end && *p != '"'; ++p)
+      ;
+    return p < end ? p + 1 : end;
+  }
+  while (p < end &&
+         (isalnum(*p) || *p == '$' || *p == '.' || *p == '_' || *p == '-'))
+    ++p;
+  return p;
+}
+
+/* Does the line hold just "}" (with white space)? */
+static LOGICAL
+is_close_brace(const char *p, const char *end)
+{
+  p = skip_blanks(p, end);
+  if (p == end || *p != '}')
+    return FALSE;
+  for (++p; p < end; ++p)
+    if (*p != ' ' && *p != '\t' && *p != '\n' && *p != '\r')
+      return FALSE;
+  return TRUE;
+}
+
+/* Can the line at p continue the initializer of a global? */
+static LOGICAL
+is_continuation(const char *p, const char *end)
+{
+  return *p != '\n' && *p != ';' && *p != '@' && *p != '%' && *p != '!' &&
+         *p != '$' && !starts(p, end, "define ") &&
+         !starts(p, end, "declare ") && !starts(p, end, "attributes ") &&
+         !starts(p, end, "target ") && !starts(p, end, "source_filename");
+}
+
+static void
+add_entity(int kind, const char *text, int len, int seg, int part)
+{
+  LMEntity *e;
+
+  NEED(nents + 1, ents, LMEntity, ents_size, ents_size * 2 + 1024);
+  e = ents + nents++;
+  e->text = text;
+  e->len = len;
+  e->seg = seg;
+  e->part = part;
+  e->kind = kind;
+  e->rank = 0;
+  e->out = -1;
+  e->name = -1;
+}
+
+static void
+record_md_node(int part, int ent)
+{
+  LMPart *pp = parts + part;
+  int id = atoi(ents[ent].text + 1);
+  int size = pp->size;
+
+  if (id >= size) {
+    NEED(id + 1, pp->ent, int, pp->size, id * 2 + 64);
+    pp->map = (int *)sccrelal((char *)pp->map, pp->size * sizeof(int));
+    memset(pp->ent + size, -1, (pp->size - size) * sizeof(int));
+    memset(pp->map + size, 0, (pp->size - size) * sizeof(int));
+  }
+  if (pp->ent[id] >= 0)
+    failed = TRUE;
+  pp->ent[id] = ent;
+}
+
+/* Split the text of a worker into entities. */
+static void
+parse_part(int part, const char *p, const char *end)
+{
+  int seg = 0;
+  const char *q;
+  int kind;
+
+  while (p < end) {
+    q = line_end(p, end);
+    if (starts(p, q, ";@par ")) {
+      seg = starts(p, q, ";@par end") ? SEG_END : atoi(p + 6);
+      p = q;
+      continue;
+    }
+    if (starts(p, q, "define ")) {
+      while (q < end && !is_close_brace(q, line_end(q, end)))
+        q = line_end(q, end);
+      q = line_end(q, end);
+      kind = LM_FUNCTION;
+    } else if (starts(p, q, "declare ")) {
+      kind = LM_DECLARE;
+    } else if (*p == '@' || *p == '%') {
+      while (q < end && is_continuation(q, end))
+        q = line_end(q, end);
+      kind = *p == '@' ? LM_GLOBAL : LM_TYPE;
+    } else if (*p == '!') {
+      kind = p + 1 < q && isdigit(p[1]) ? LM_MDNODE : LM_MDNAMED;
+    } else if (starts(p, q, "; Named metadata")) {
+      kind = LM_MDNAMEDSEC;
+    } else if (starts(p, q, "; Metadata")) {
+      kind = LM_MDSEC;
+    } else if (starts(p, q, "; ModuleID") || starts(p, q, "target ") ||
+               starts(p, q, "source_filename") ||
+               starts(p, q, "attributes ") || *p == '$') {
+      kind = LM_HEADER;
+    } else {
+      kind = LM_TEXT;
+    }
+    add_entity(kind, p, q - p, seg, part);
+    if (kind == LM_MDNODE)
+      record_md_node(part, nents - 1);
+    p = q;
+  }
+}
+
+static int
+owner(int seg)
+{
+  return seg == 0 || seg == SEG_END ? 0 : seg % nparts;
+}
+
+/* output order: by segment, the owner first, then by worker */
+static int
+cmp_order(const void *a, const void *b)
+{
+  const LMEntity *x = ents + *(const int *)a;
+  const LMEntity *y = ents + *(const int *)b;
+  int ox, oy;
+
+  if (x->seg != y->seg)
+    return x->seg < y->seg ? -1 : 1;
+  ox = x->part != owner(x->seg);
+  oy = y->part != owner(y->seg);
+  if (ox != oy)
+    return ox - oy;
+  if (x->part != y->part)
+    return x->part - y->part;
+  return *(const int *)a - *(const int *)b;
+}
+
+/* The name that identifies an entity, written to buf; FALSE if none. */
+static LOGICAL
+entity_key(const LMEntity *e, char *buf)
+{
+  const char *p = e->text, *end = e->text + e->len, *s;
+
+  switch (e->kind) {
+  case LM_FUNCTION:
+  case LM_DECLARE:
+    p = memchr(p, '@', line_end(p, end) - p);
+    if (p == NULL)
+      return FALSE;
+    /* fall through */
+  case LM_GLOBAL:
+  case LM_TYPE:
+    s = p;
+    p = name_end(p, end);
+    break;
+  case LM_MDNAMED:
+  case LM_HEADER:
+    s = p;
+    while (p < end && *p != '=' && *p != '\n')
+      ++p;
+    while (p > s && p[-1] == ' ')
+      --p;
+    break;
+  case LM_MDNAMEDSEC:
+  case LM_MDSEC:
+    s = p;
+    p = line_end(p, end);
+    break;
+  default:
+    return FALSE;
+  }
+  if (p - s >= LM_KEYLEN)
+    return FALSE;
+  memcpy(buf, s, p - s);
+  buf[p - s] = '\0';
+  return TRUE;
+}
+
+/* Classify "@name = ..." and declarations: 1 declaration, 2 common, 3
+ * definition. */
+static int
+global_rank(const LMEntity *e)
+{
+  const char *p, *end;
+
+  if (e->kind == LM_DECLARE)
+    return 1;
+  if (e->kind != LM_GLOBAL)
+    return 3;
+  end = line_end(e->text, e->text + e->len);
+  p = memchr(e->text, '=', end - e->text);
+  if (p == NULL)
+    return 3;
+  p = skip_blanks(p + 1, end);
+  if (starts(p, end, "external "))
+    return 1;
+  if (starts(p, end, "common "))
+    return 2;
+  return 3;
+}
+
+/* Does a function defined by a worker refer to the name key?  A worker
+ * that skipped the routines calling a function may declare it with a
+ * default type. */
+static LOGICAL
+is_referenced(int part, const char *key)
+{
+  const LMEntity *e;
+  const char *p, *end, *q;
+  size_t n = strlen(key);
+  int i;
+
+  for (i = 0; i < nents; i++) {
+    e = ents + i;
+    if (e->part != part || e->kind != LM_FUNCTION)
+      continue;
+    end = e->text + e->len;
+    for (p = line_end(e->text, end); p < end; p = q) {
+      p = memchr(p, *key, end - p);
+      if (p == NULL)
+        break;
+      q = name_end(p, end);
+      if ((size_t)(q - p) == n && memcmp(p, key, n) == 0)
+        return TRUE;
+    }
+  }
+  return FALSE;
+}
+
+/* Is the definition local to the module: internal or private linkage? */
+static LOGICAL
+is_internal(const LMEntity *e)
+{
+  const char *p, *end = line_end(e->text, e->text + e->len);
+
+  if (e->kind == LM_FUNCTION) {
+    p = e->text + 6;
+  } else if (e->kind == LM_GLOBAL) {
+    p = memchr(e->text, '=', end - e->text);
+    if (p == NULL)
+      return FALSE;
+    ++p;
+  } else {
+    return FALSE;
+  }
+  p = skip_blanks(p, end);
+  return starts(p, end, "internal ") || starts(p, end, "private ");
+}
+
+/* n in "%T = type < { [n x i8] } >", the type of a common block; else -1 */
+static int
+bytes_type_size(const char *p, const char *end)
+{
+  int n;
+
+  p = memchr(p, '=', end - p);
+  if (p == NULL)
+    return -1;
+  p = skip_blanks(p + 1, end);
+  if (!starts(p, end, "type"))
+    return -1;
+  p = skip_blanks(p + 4, end);
+  if (p == end || *p++ != '<')
+    return -1;
+  p = skip_blanks(p, end);
+  if (p == end || *p++ != '{')
+    return -1;
+  p = skip_blanks(p, end);
+  if (p == end || *p++ != '[' || p == end || !isdigit(*p))
+    return -1;
+  for (n = 0; p < end && isdigit(*p); ++p)
+    n = n * 10 + (*p - '0');
+  if (!starts(p, end, " x i8]"))
+    return -1;
+  p = skip_blanks(p + 6, end);
+  if (p == end || *p++ != '}')
+    return -1;
+  p = skip_blanks(p, end);
+  if (p == end || *p++ != '>')
+    return -1;
+  p = skip_blanks(p, end);
+  return p == end || *p == '\n' ? n : -1;
+}
+
+/* Append n bytes to the string in *buf. */
+static void
+append(char **buf, int *len, int *size, const char *s, int n)
+{
+  NEED(*len + n + 1, *buf, char, *size, *size * 2 + n + 64);
+  memcpy(*buf + *len, s, n);
+  *len += n;
+  (*buf)[*len] = '\0';
+}
+
+/* Replace the metadata references (RW_MD) and the renamed names (RW_NAMES)
+ * in the text of a worker.  Write the result to out, or return it as a new
+ * string if out is NULL.  Strings and quoted names are left alone. */
+static char *
+rewrite(int part, const char *p, const char *end, int what, FILE *out)
+{
+  hashmap_t renames = (what & RW_NAMES) ? parts[part].renames : NULL;
+  const char *s = p, *q, *repl;
+  char num[16], key[LM_KEYLEN];
+  hash_data_t data;
+  char *buf = NULL;
+  int len = 0, size = 0, id;
+
+  while (p < end) {
+    if (*p == '"') {
+      /* skip strings, including metadata strings !"..." */
+      for (++p; p < end && *p != '"'; ++p)
+        ;
+      if (p < end)
+        ++p;
+      continue;
+    }
+    repl = NULL;
+    q = p + 1;
+    if (*p == '!' && (what & RW_MD) && q < end && isdigit(*q)) {
+      id = map_md(part, (int)strtol(q, (char **)&q, 10));
+      if (id <= 0)
+        failed = TRUE;
+      sprintf(num, "!%d", id);
+      repl = num;
+    } else if ((*p == '%' || *p == '@') && renames && q < end &&
+               !isdigit(*q) && *q != '"') {
+      q = name_end(p, end);
+      if (q - p < LM_KEYLEN) {
+        memcpy(key, p, q - p);
+        key[q - p] = '\0';
+        if (hashmap_lookup(renames, key, &data))
+          repl = (const char *)data;
+      }
+    }
+    if (repl == NULL) {
+      p = q;
+      continue;
+    }
+    if (out) {
+      fwrite(s, 1, p - s, out);
+      fputs(repl, out);
+    } else {
+      append(&buf, &len, &size, s, p - s);
+      append(&buf, &len, &size, repl, strlen(repl));
+    }
+    s = p = q;
+  }
+  if (out) {
+    fwrite(s, 1, end - s, out);
+    return NULL;
+  }
+  append(&buf, &len, &size, s, end - s);
+  return buf;
+}
+
+/* Are two entities the same, once renamed? */
+static LOGICAL
+same_entity(int a, int b)
+{
+  const LMEntity *x = ents + a, *y = ents + b;
+  char *s, *t;
+  LOGICAL same;
+
+  if (parts[x->part].renames == NULL && parts[y->part].renames == NULL)
+    return x->len == y->len && memcmp(x->text, y->text, x->len) == 0;
+  s = rewrite(x->part, x->text, x->text + x->len, RW_NAMES, NULL);
+  t = rewrite(y->part, y->text, y->text + y->len, RW_NAMES, NULL);
+  same = strcmp(s, t) == 0;
+  FREE(s);
+  FREE(t);
+  return same;
+}
+
+/* Give entity e, which is local to the module, a name of its own. */
+static void
+rename_entity(int e, const char *key)
+{
+  LMPart *pp = parts + ents[e].part;
+  char *from, *to;
+
+  if (pp->renames == NULL)
+    pp->renames = hashmap_alloc(hash_functions_strings);
+  NEW(from, char, strlen(key) + 1);
+  NEW(to, char, strlen(key) + 16);
+  strcpy(from, key);
+  sprintf(to, "%s.w%d", key, ents[e].part);
+  hashmap_insert(pp->renames, from, to);
+  ents[e].out = e;
+}
+
+/* Combine an entity with the one of the same name seen before. */
+static void
+resolve(LMName *nm, int e, const char *key)
+{
+  LMEntity *w = ents + nm->winner, *x = ents + e;
+  int size;
+
+  if (same_entity(nm->winner, e))
+    return;
+  switch (x->kind) {
+  case LM_TYPE:
+    if (w->kind != LM_TYPE)
+      break;
+    size = bytes_type_size(x->text, x->text + x->len);
+    if (nm->size < 0 || size < 0) {
+      rename_entity(e, key);
+      return;
+    }
+    if (size > nm->size) {
+      nm->winner = e;
+      nm->size = size;
+    }
+    nm->resized = TRUE;
+    return;
+  case LM_GLOBAL:
+  case LM_DECLARE:
+  case LM_FUNCTION:
+    if (w->kind != LM_GLOBAL && w->kind != LM_DECLARE &&
+        w->kind != LM_FUNCTION)
+      break;
+    if (x->rank > w->rank) {
+      nm->winner = e;
+      return;
+    }
+    if (x->rank < w->rank)
+      return;
+    if (x->rank == 1 && !is_referenced(x->part, key))
+      return;
+    if (x->rank == 1 && !is_referenced(w->part, key)) {
+      nm->winner = e;
+      return;
+    }
+    if (x->rank == 3 && is_internal(w) && is_internal(x)) {
+      rename_entity(e, key);
+      return;
+    }
+    break;
+  case LM_MDNAMED:
+    /* compared after renumbering */
+    return;
+  }
+  failed = TRUE;
+}
+
+static void
+resolve_names(void)
+{
+  char key[LM_KEYLEN];
+  hash_data_t data;
+  LMName *nm;
+  char *k;
+  int i, e;
+
+  name_map = hashmap_alloc(hash_functions_strings);
+  for (i = 0; i < nents && !failed; i++) {
+    e = order[i];
+    if (ents[e].kind == LM_MDNODE)
+      continue;
+    if (ents[e].kind == LM_TEXT) {
+      if (ents[e].part == owner(ents[e].seg))
+        ents[e].out = e;
+      continue;
+    }
+    if (!entity_key(ents + e, key)) {
+      failed = TRUE;
+      break;
+    }
+    ents[e].rank = global_rank(ents + e);
+    if (hashmap_lookup(name_map, key, &data)) {
+      ents[e].name = HKEY2INT(data) - 1;
+      resolve(names + ents[e].name, e, key);
+      continue;
+    }
+    ents[e].name = nnames;
+    NEED(nnames + 1, names, LMName, names_size, names_size * 2 + 1024);
+    nm = names + nnames++;
+    nm->first = nm->winner = e;
+    nm->size = ents[e].kind == LM_TYPE
+                   ? bytes_type_size(ents[e].text, ents[e].text + ents[e].len)
+                   : -1;
+    nm->resized = FALSE;
+    nm->mdtext = NULL;
+    NEW(k, char, strlen(key) + 1);
+    hashmap_insert(name_map, strcpy(k, key), INT2HKEY(nnames));
+  }
+  for (i = 0; i < nnames; i++)
+    ents[names[i].first].out = names[i].winner;
+}
+
+/* A repetition that was dropped because it matched the winner must still
+ * match it after the renames made later in the output order. */
+static void
+check_renames(void)
+{
+  const LMEntity *e, *w;
+  int i;
+
+  for (i = 0; i < nents && !failed; i++) {
+    e = ents + i;
+    if (e->name < 0 || e->out >= 0 || e->kind == LM_MDNAMED)
+      continue;
+    w = ents + names[e->name].winner;
+    if (parts[e->part].renames == NULL && parts[w->part].renames == NULL)
+      continue;
+    if (e->kind == w->kind && e->rank == w->rank &&
+        names[e->name].size < 0 && !same_entity(e - ents, w - ents))
+      failed = TRUE;
+  }
+}
+
+/* A definition whose initializer has a common block type that was enlarged
+ * must still match it; "@x = global %T < { [n x i8] ..." */
+static void
+check_resized(void)
+{
+  char key[LM_KEYLEN];
+  hash_data_t data;
+  const char *p, *end, *s;
+  const LMEntity *e;
+  const LMName *nm;
+  int i, n;
+
+  for (i = 0; i < nnames && !failed; i++) {
+    e = ents + names[i].winner;
+    if (e->kind != LM_GLOBAL || e->rank != 3)
+      continue;
+    end = line_end(e->text, e->text + e->len);
+    s = memchr(e->text, '%', end - e->text);
+    if (s == NULL)
+      continue;
+    p = name_end(s, end);
+    if (p - s >= LM_KEYLEN)
+      continue;
+    memcpy(key, s, p - s);
+    key[p - s] = '\0';
+    if (!hashmap_lookup(name_map, key, &data))
+      continue;
+    nm = names + HKEY2INT(data) - 1;
+    if (!nm->resized)
+      continue;
+    p = skip_blanks(p, end);
+    if (p == end || *p++ != '<')
+      continue;
+    p = skip_blanks(p, end);
+    if (p < end && *p == '{')
+      p = skip_blanks(p + 1, end);
+    if (p == end || *p++ != '[')
+      continue;
+    for (n = 0; p < end && isdigit(*p); ++p)
+      n = n * 10 + (*p - '0');
+    if (n != nm->size)
+      failed = TRUE;
+  }
+}
+
+/* The merged number of node id of a worker, 0 if there is none. */
+static int
+map_md(int part, int id)
+{
+  LMPart *pp = parts + part;
+  const LMEntity *e;
+  const char *p, *end, *q;
+  hash_data_t data;
+  LOGICAL unique;
+  char *body;
+  int n;
+
+  if (id >= pp->size || pp->ent[id] < 0)
+    return 0;
+  if (pp->map[id] > 0)
+    return pp->map[id];
+  if (pp->map[id] == MD_BUSY)
+    return 0; /* a cycle through nodes that are not distinct */
+  e = ents + pp->ent[id];
+  end = e->text + e->len;
+  while (end > e->text && (end[-1] == '\n' || end[-1] == ' '))
+    --end;
+  p = memchr(e->text, '=', end - e->text);
+  if (p == NULL)
+    return 0;
+  p = skip_blanks(p + 1, end);
+
+  /* distinct and self-referencing nodes keep their identity */
+  unique = starts(p, end, "distinct ");
+  for (q = p; !unique && q + 1 < end; ++q)
+    if (*q == '!' && isdigit(q[1]))
+      unique = strtol(q + 1, NULL, 10) == id;
+  if (unique) {
+    NEED(nmdnodes + 2, mdnodes, char *, mdnodes_size, mdnodes_size * 2 + 64);
+    n = ++nmdnodes;
+    mdnodes[n] = NULL;
+    pp->map[id] = n;
+    body = rewrite(part, p, end, RW_MD | RW_NAMES, NULL);
+    mdnodes[n] = body;
+    return n;
+  }
+  pp->map[id] = MD_BUSY;
+  body = rewrite(part, p, end, RW_MD | RW_NAMES, NULL);
+  if (hashmap_lookup(mdnode_map, body, &data)) {
+    FREE(body);
+    n = HKEY2INT(data);
+  } else {
+    NEED(nmdnodes + 2, mdnodes, char *, mdnodes_size, mdnodes_size * 2 + 64);
+    n = ++nmdnodes;
+    mdnodes[n] = body;
+    hashmap_insert(mdnode_map, body, INT2HKEY(n));
+  }
+  pp->map[id] = n;
+  return n;
+}
+
+/* Renumber the metadata referenced by the merged text, in output order. */
+static void
+renumber_metadata(void)
+{
+  const LMEntity *e;
+  const char *p;
+  LMName *nm;
+  char *text;
+  int i;
+
+  mdnode_map = hashmap_alloc(hash_functions_strings);
+  for (i = 0; i < nents && !failed; i++) {
+    e = ents + order[i];
+    if (e->kind == LM_MDNAMED) {
+      /* every repetition of named metadata must agree */
+      nm = names + e->name;
+      p = memchr(e->text, '=', e->len);
+      if (p == NULL) {
+        failed = TRUE;
+        break;
+      }
+      text = rewrite(e->part, p + 1, e->text + e->len, RW_MD, NULL);
+      if (nm->mdtext == NULL) {
+        nm->mdtext = text;
+      } else {
+        if (strcmp(nm->mdtext, text) != 0)
+          failed = TRUE;
+        FREE(text);
+      }
+    } else if (e->out >= 0 && e->kind != LM_TEXT) {
+      e = ents + e->out;
+      text = rewrite(e->part, e->text, e->text + e->len, RW_MD, NULL);
+      FREE(text);
+    }
+  }
+}
+
+static void
+write_merged(FILE *out)
+{
+  char key[LM_KEYLEN];
+  const LMEntity *e;
+  int i, j;
+
+  for (i = 0; i < nents; i++) {
+    e = ents + order[i];
+    if (e->out < 0)
+      continue;
+    e = ents + e->out;
+    switch (e->kind) {
+    case LM_MDNAMED:
+      break;
+    case LM_MDNAMEDSEC:
+      fwrite(e->text, 1, e->len, out);
+      for (j = 0; j < nnames; j++) {
+        if (ents[names[j].first].kind != LM_MDNAMED)
+          continue;
+        entity_key(ents + names[j].first, key);
+        fprintf(out, "%s =%s", key, names[j].mdtext);
+      }
+      break;
+    case LM_MDSEC:
+      fwrite(e->text, 1, e->len, out);
+      for (j = 1; j <= nmdnodes; j++)
+        fprintf(out, "!%d = %s\n", j, mdnodes[j]);
+      break;
+    case LM_TEXT:
+      fwrite(e->text, 1, e->len, out);
+      break;
+    default:
+      rewrite(e->part, e->text, e->text + e->len, RW_MD | RW_NAMES, out);
+    }
+  }
+}
+
+static void
+free_key(hash_key_t key, hash_data_t data, void *context)
+{
+  char *k = (char *)key, *d = (char *)data;
+
+  FREE(k);
+  if (context)
+    FREE(d);
+}
+
+/** \brief Write the module merged from the LLVM IR of the workers to out.
+ *
+ * Returns false, with nothing written, if the parts cannot be merged.
+ */
+bool
+ll_merge_modules(FILE *out, FILE *files[], int nfiles)
+{
+  char **bufs;
+  long size;
+  int i;
+
+  failed = FALSE;
+  nents = nnames = nmdnodes = 0;
+  nparts = nfiles;
+  NEW(bufs, char *, nparts);
+  NEW(parts, LMPart, nparts);
+  BZERO(bufs, char *, nparts);
+  BZERO(parts, LMPart, nparts);
+  for (i = 0; i < nparts && !failed; i++) {
+    if (fseek(files[i], 0L, SEEK_END) != 0 || (size = ftell(files[i])) < 0) {
+      failed = TRUE;
+      break;
+    }
+    rewind(files[i]);
+    NEW(bufs[i], char, size + 1);
+    if (fread(bufs[i], 1, size, files[i]) != (size_t)size)
+      failed = TRUE;
+    else
+      parse_part(i, bufs[i], bufs[i] + size);
+  }
+
+  if (!failed) {
+    NEW(order, int, nents + 1);
+    for (i = 0; i < nents; i++)
+      order[i] = i;
+    qsort(order, nents, sizeof(int), cmp_order);
+    resolve_names();
+  }
+  if (!failed)
+    check_renames();
+  if (!failed)
+    check_resized();
+  if (!failed)
+    renumber_metadata();
+  if (!failed)
+    write_merged(out);
+
+  if (name_map) {
+    hashmap_iterate(name_map, free_key, NULL);
+    hashmap_free(name_map);
+    name_map = NULL;
+  }
+  if (mdnode_map) {
+    hashmap_free(mdnode_map);
+    mdnode_map = NULL;
+  }
+  for (i = 1; i <= nmdnodes; i++)
+    FREE(mdnodes[i]);
+  for (i = 0; i < nnames; i++)
+    FREE(names[i].mdtext);
+  for (i = 0; i < nparts; i++) {
+    FREE(bufs[i]);
+    FREE(parts[i].ent);
+    FREE(parts[i].map);
+    if (parts[i].renames) {
+      hashmap_iterate(parts[i].renames, free_key, parts);
+      hashmap_free(parts[i].renames);
+    }
+  }
+  FREE(bufs);
+  FREE(parts);
+  FREE(order);
+  FREE(ents);
+  FREE(names);
+  FREE(mdnodes);
+  ents_size = names_size = mdnodes_size = 0;
+  return !failed;
+}
@@ -107,13 +107,6 @@ ll_destroy_basic_block(struct LL_BasicBlock_ *basic_block)
   free(basic_block);
 }
 
-static void
-free_iterator(hash_key_t key, void *context)
-{
-  (void)context;
-  free((void *)key);
-}
-
 /**
    \brief Deallocate all memory used by function.
 
@@ -139,9 +132,8 @@ ll_destroy_function(struct LL_Function_ *function)
     free(function->arguments);
 
   if (function->used_local_names) {
-    /* Local names were allocated by strdupo in unique_name(). */
-    hashset_iterate(function->used_local_names, free_iterator, NULL);
-    hashset_free(function->used_local_names);
+    /* Local names were interned by unique_name(). */
+    strtab_free(function->used_local_names);
   }
 
   free(function);
@@ -241,12 +233,11 @@ static const hash_functions_t types_hash_functions = {types_hash, types_equal};
  * Create a unique name based on a printf-like template.
  *
  * 1. Pick a name based on format + ap that isn't already in 'names'.
- * 2. Copy the name into malloc'ed memory.
- * 3. Insert new pointer into names.
- * 4. Return malloced pointer.
+ * 2. Intern the name in 'names'.
+ * 3. Return the interned copy, which lives as long as 'names'.
  */
 static const char *
-unique_name(hashset_t names, char prefix, const char *format, va_list ap)
+unique_name(strtab_t names, char prefix, const char *format, va_list ap)
 {
   char buffer[256] = {prefix, 0};
   size_t prefix_length;
@@ -265,19 +256,16 @@ unique_name(hashset_t names, char prefix, const char *format, va_list ap)
     prefix_length = sizeof(buffer) - 12;
 
   /* Search for a not previously used name. */
-  while (hashset_lookup(names, buffer)) {
+  while (!(unique_name = strtab_insert(names, buffer, strlen(buffer)))) {
     /* Try a pretty .1, .2, ... .9 suffix sequence at first, but then
      * switch to a scheme that isn't quadratic time. */
     if (++count == 10 && !reseeded) {
-      count = 10 * hashset_size(names);
+      count = 10 * strtab_size(names);
       reseeded = 1;
     }
     sprintf(buffer + prefix_length, ".%u", count);
   }
 
-  unique_name = strdup(buffer);
-  hashset_insert(names, unique_name);
-
   return unique_name;
 }
 
@@ -521,8 +509,8 @@ ll_destroy_module(LLVMModuleRef module)
   free(module->module_vars.values);
   free(module->user_structs.values);
   hashmap_free(module->user_structs_byid);
-  hashset_free(module->used_type_names);
-  hashset_free(module->used_global_names);
+  strtab_free(module->used_type_names);
+  strtab_free(module->used_global_names);
   hashset_free(module->anon_types);
 
   free(module->constants);
@@ -564,8 +552,8 @@ ll_create_module(const char *module_name, const char *target_triple,
   new_module->num_user_structs = 0;
   new_module->written_user_structs = 0;
   new_module->user_structs_byid = hashmap_alloc(hash_functions_direct);
-  new_module->used_type_names = hashset_alloc(hash_functions_strings);
-  new_module->used_global_names = hashset_alloc(hash_functions_strings);
+  new_module->used_type_names = strtab_alloc();
+  new_module->used_global_names = strtab_alloc();
   new_module->anon_types = hashset_alloc(types_hash_functions);
   new_module->num_refs = 0;
   new_module->extern_func_refs = NULL;
@@ -1521,7 +1509,7 @@ ll_named_struct_type_exists(LL_Module *module, int id, const char *format, ...)
   vsnprintf(buffer + 1, sizeof(buffer) - 1, format, ap);
   va_end(ap);
   buffer[sizeof(buffer) - 1] = '\0';
-  if (hashset_lookup(module->used_type_names, buffer)) {
+  if (strtab_lookup(module->used_type_names, buffer, strlen(buffer))) {
     if (hashmap_lookup(module->user_structs_byid, INT2HKEY(id),
                        (hash_data_t *)&struct_value)) {
       return struct_value;
@@ -2613,7 +2601,7 @@ ll_create_local_name(LL_Function *function, const char *format, ...)
   const char *name;
 
   if (!function->used_local_names)
-    function->used_local_names = hashset_alloc(hash_functions_strings);
+    function->used_local_names = strtab_alloc();
 
   va_start(ap, format);
   name = unique_name(function->used_local_names, '%', format, ap);
@@ -2640,7 +2628,7 @@ ll_create_local_object(LL_Function *function, LL_Type *type,
   va_list ap;
 
   if (!function->used_local_names)
-    function->used_local_names = hashset_alloc(hash_functions_strings);
+    function->used_local_names = strtab_alloc();
 
   object->kind = LLObj_Local;
   object->type = type;
@@ -2741,8 +2729,12 @@ ll_proto_add(const char *fnname, struct LL_ABI_Info_ *abi)
   LL_FnProto *proto;
   const char *key;
 
-  if (hashmap_lookup(_ll_proto_map, fnname, (hash_data_t *)&proto))
+  if (hashmap_lookup(_ll_proto_map, fnname, (hash_data_t *)&proto)) {
+    /* may have been entered without an ABI, e.g. by vmath_declare() */
+    if (!proto->abi)
+      proto->abi = abi;
     return proto;
+  }
 
   if (!(proto = calloc(1, sizeof(LL_FnProto))))
     interr("ll_proto_add: Could not allocate proto instance", 0, 4);
@@ -2874,6 +2866,23 @@ ll_proto_set_intrinsic(const char *fnname, const char *intrinsic_decl_str)
   proto->intrinsic_decl_str = strdup(intrinsic_decl_str);
 }
 
+/**
+   \brief Set the name and function type of a compiler generated intrinsic
+ */
+void
+ll_proto_set_intrinsic_type(const char *fnname, const char *name,
+                            LL_Type *type, LOGICAL is_pure)
+{
+  LL_FnProto *proto = NULL;
+
+  if (!hashmap_lookup(_ll_proto_map, fnname, (hash_data_t *)&proto))
+    interr("ll_proto_set_intrinsic_type: Entry not found", 0, 4);
+
+  proto->intrinsic_name = strdup(name);
+  proto->intrinsic_type = type;
+  proto->intrinsic_is_pure = is_pure;
+}
+
 void
 ll_proto_iterate(LL_FnProto_Handler callback)
 {
@@ -25,6 +25,7 @@
 
 #include "universal.h"
 #include "flang/ADT/hash.h"
+#include "flang/ADT/strtab.h"
 #include <stdio.h>
 
 typedef enum LL_Op {
@@ -173,6 +174,7 @@ typedef enum LL_IRVersion {
   LL_Version_3_8 = 38,
   LL_Version_3_9 = 39,
   LL_Version_4_0 = 40,
+  LL_Version_9_0 = 90,
   LL_Version_trunk = 1023
 } LL_IRVersion;
 
@@ -403,6 +405,32 @@ ll_feature_from_global_to_md(const LL_IRFeatures *feature)
   return feature->version >= LL_Version_4_0;
 }
 
+/**
+   \brief Can calls name vector variants of their callee?
+
+   The "vector-function-abi-variant" call site attribute lists vectorized
+   versions of the called function for the loop vectorizer.
+ */
+INLINE static bool
+ll_feature_vector_function_abi_variant(const LL_IRFeatures *feature)
+{
+  return feature->version >= LL_Version_9_0;
+}
+
+/**
+   \brief Are the memory accesses of parallel loops put in access groups?
+
+   LLVM 8 replaced the llvm.mem.parallel_loop_access metadata, which names
+   the loop, with llvm.access.group on the accesses and
+   llvm.loop.parallel_accesses in the loop's metadata; the first version
+   after it known here is 9.0.
+ */
+INLINE static bool
+ll_feature_access_groups(const LL_IRFeatures *feature)
+{
+  return feature->version >= LL_Version_9_0;
+}
+
 unsigned ll_feature_dwarf_version(const LL_IRFeatures *feature);
 
 struct LL_Module;
@@ -757,7 +785,7 @@ typedef struct LL_Function_ {
 
   /** Set of names used for local values in this function. This does not include
       values which are simply numbered (%1, %2, ...). */
-  hashset_t used_local_names;
+  strtab_t used_local_names;
 } LL_Function;
 
 /* Debug info state associated with a compilation unit. See lldebug.c. */
@@ -782,8 +810,8 @@ typedef struct LL_Module {
   struct LL_Symbols_ module_vars;
   struct LL_Symbols_ user_structs;
   hashmap_t user_structs_byid;
-  hashset_t used_type_names;
-  hashset_t used_global_names;
+  strtab_t used_type_names;
+  strtab_t used_global_names;
   unsigned num_module_vars;
   unsigned num_user_structs;
   unsigned written_user_structs;
@@ -837,10 +865,14 @@ typedef struct LL_Module {
 typedef struct LL_FnProto_ {
   char *fn_name;            /**< Key in map */
   struct LL_ABI_Info_ *abi; /**< This is used to emit the function signature */
-  unsigned has_defined_body : 1; /**< True if this fn has a body */
-  unsigned is_weak : 1;          /**< True if this fn has the attribute weak */
+  unsigned has_defined_body : 1;  /**< True if this fn has a body */
+  unsigned is_weak : 1;           /**< True if this fn has the attribute weak */
+  unsigned intrinsic_is_pure : 1; /**< True if the intrinsic is readnone */
   /** Only set if this is an intrinsic (has a predefined func decl string) */
   char *intrinsic_decl_str;
+  /** Name and function type of the intrinsic, for the bitcode output */
+  char *intrinsic_name;
+  LL_Type *intrinsic_type;
   /** Maintain a list (easier to read/debug ll output) */
   struct LL_FnProto_ *next;
 } LL_FnProto;
@@ -856,6 +888,8 @@ LOGICAL ll_proto_has_defined_body(const char *fnname);
 void ll_proto_set_weak(const char *fnname, LOGICAL is_weak);
 LOGICAL ll_proto_is_weak(const char *fnname);
 void ll_proto_set_intrinsic(const char *fnname, const char *intrinsic_decl_str);
+void ll_proto_set_intrinsic_type(const char *fnname, const char *name,
+                                 LL_Type *type, LOGICAL is_pure);
 
 /**
    \brief Iterate across all entries in the map and callback the handler.
@@ -34,6 +34,86 @@ static struct LL_Function_ *called = NULL;
 static int debug_calls = 0;
 static int text_calls = 0;
 
+/* Size of the stdio buffer given to the IR output file.  A module is
+   written as a long stream of short tokens, so the buffer is made large
+   enough that write(2) is only called every few thousand instructions. */
+#define LL_OUTBUF_SIZE (1 << 20)
+
+/**
+   \brief Give the LLVM IR output file a large, fully buffered stdio buffer
+
+   Must be called before anything has been written to \p out.  The buffer
+   lives as long as the compilation.
+ */
+void
+ll_set_output_buffer(FILE *out)
+{
+  static char *outbuf = NULL;
+
+  if (out == NULL || outbuf != NULL)
+    return;
+  outbuf = (char *)malloc(LL_OUTBUF_SIZE);
+  if (outbuf != NULL && setvbuf(out, outbuf, _IOFBF, LL_OUTBUF_SIZE) != 0) {
+    free(outbuf);
+    outbuf = NULL;
+  }
+}
+
+/**
+   \brief Write the string \p s to \p out
+ */
+void
+ll_puts(FILE *out, const char *s)
+{
+  while (*s)
+    LL_PUTC(*s++, out);
+}
+
+/**
+   \brief Write \p val to \p out in decimal
+ */
+void
+ll_putu(FILE *out, BIGUINT64 val)
+{
+  char buf[24];
+  char *p = buf + sizeof(buf);
+
+  do {
+    *--p = '0' + (int)(val % 10);
+    val /= 10;
+  } while (val);
+  while (p < buf + sizeof(buf))
+    LL_PUTC(*p++, out);
+}
+
+/**
+   \brief Write the signed value \p val to \p out in decimal
+ */
+void
+ll_puti(FILE *out, BIGINT64 val)
+{
+  if (val < 0) {
+    LL_PUTC('-', out);
+    ll_putu(out, -(BIGUINT64)val);
+  } else {
+    ll_putu(out, (BIGUINT64)val);
+  }
+}
+
+/**
+   \brief Write the low \p digits hex digits of \p val to \p out
+
+   Upper case digits, zero padded, no 0x prefix.
+ */
+void
+ll_putx(FILE *out, BIGUINT64 val, int digits)
+{
+  static const char hexdigits[] = "0123456789ABCDEF";
+
+  while (digits-- > 0)
+    LL_PUTC(hexdigits[(val >> (4 * digits)) & 0xf], out);
+}
+
 static const char *
 ll_get_linkage_string(enum LL_LinkageType linkage)
 {
@@ -276,6 +356,35 @@ clear_prototypes(void)
   called = NULL;
 }
 
+/* Write "type value" for an instruction operand */
+static void
+write_typed_operand(FILE *out, LL_Value *val)
+{
+  ll_puts(out, val->type_struct->str);
+  LL_PUTC(' ', out);
+  ll_puts(out, val->data);
+}
+
+/* Write the "  %result = opname " prefix of an instruction */
+static void
+write_inst_head(FILE *out, LL_Value *result, const char *opname)
+{
+  ll_puts(out, SPACES);
+  ll_puts(out, result->data);
+  ll_puts(out, " = ");
+  ll_puts(out, opname);
+  LL_PUTC(' ', out);
+}
+
+static void
+write_align(FILE *out, struct LL_Instruction_ *inst, int opnd)
+{
+  if (inst->num_operands > opnd) {
+    ll_puts(out, ", align ");
+    ll_puts(out, inst->operands[opnd]->data);
+  }
+}
+
 static void
 render_bitcast(FILE *out, struct LL_Instruction_ *inst)
 {
@@ -286,9 +395,12 @@ render_bitcast(FILE *out, struct LL_Instruction_ *inst)
     /* Replace "0" with "null" */
     cast_operand = "null";
   }
-  fprintf(out, "%s%s = bitcast %s %s to %s", SPACES, inst->operands[0]->data,
-          inst->operands[1]->type_struct->str, cast_operand,
-          inst->operands[0]->type_struct->str);
+  write_inst_head(out, inst->operands[0], "bitcast");
+  ll_puts(out, inst->operands[1]->type_struct->str);
+  LL_PUTC(' ', out);
+  ll_puts(out, cast_operand);
+  ll_puts(out, " to ");
+  ll_puts(out, inst->operands[0]->type_struct->str);
 }
 
 static void
@@ -309,12 +421,30 @@ render_store(FILE *out, struct LL_Instruction_ *inst)
       store_operand = "0x7FF8000000000000";
     }
   }
-  fprintf(out, "%sstore%s %s %s, %s %s", SPACES,
-          (inst->flags & INST_VOLATILE) ? " volatile" : "",
-          inst->operands[0]->type_struct->str, store_operand,
-          inst->operands[1]->type_struct->str, inst->operands[1]->data);
-  if (inst->num_operands >= 3)
-    fprintf(out, ", align %s", inst->operands[2]->data);
+  ll_puts(out, SPACES "store");
+  if (inst->flags & INST_VOLATILE)
+    ll_puts(out, " volatile");
+  LL_PUTC(' ', out);
+  ll_puts(out, inst->operands[0]->type_struct->str);
+  LL_PUTC(' ', out);
+  ll_puts(out, store_operand);
+  ll_puts(out, ", ");
+  write_typed_operand(out, inst->operands[1]);
+  write_align(out, inst, 2);
+}
+
+/* Write "call type @callee(" and the result assignment, if any */
+static void
+write_call_head(FILE *out, struct LL_Instruction_ *inst)
+{
+  if (inst->operands[0]->type_struct->data_type != LL_VOID)
+    write_inst_head(out, inst->operands[0], "call");
+  else
+    ll_puts(out, SPACES "call ");
+  ll_puts(out, inst->operands[1]->type_struct->str);
+  ll_puts(out, " @");
+  ll_puts(out, inst->operands[1]->data);
+  LL_PUTC('(', out);
 }
 
 void
@@ -347,19 +477,19 @@ ll_write_instruction(FILE *out, struct LL_Instruction_ *inst)
   case LL_LSHR:
   case LL_SHL:
     /* Group all binary operations */
-    fprintf(out, "%s%s = %s %s %s, %s", SPACES, inst->operands[0]->data, opname,
-            inst->operands[1]->type_struct->str, inst->operands[1]->data,
-            inst->operands[2]->data);
+    write_inst_head(out, inst->operands[0], opname);
+    write_typed_operand(out, inst->operands[1]);
+    ll_puts(out, ", ");
+    ll_puts(out, inst->operands[2]->data);
     break;
   case LL_STORE:
     render_store(out, inst);
     break;
   case LL_LOAD:
-    fprintf(out, "%s%s = load%s %s %s", SPACES, inst->operands[0]->data,
-            (inst->flags & INST_VOLATILE) ? " volatile" : "",
-            inst->operands[1]->type_struct->str, inst->operands[1]->data);
-    if (inst->num_operands >= 3)
-      fprintf(out, ", align %s", inst->operands[2]->data);
+    write_inst_head(out, inst->operands[0],
+                    (inst->flags & INST_VOLATILE) ? "load volatile" : "load");
+    write_typed_operand(out, inst->operands[1]);
+    write_align(out, inst, 2);
     break;
   case LL_SEXT:
   case LL_ZEXT:
@@ -373,102 +503,101 @@ ll_write_instruction(FILE *out, struct LL_Instruction_ *inst)
   case LL_FPTOSI:
   case LL_FPTOUI:
     /* Group all conversion operations */
-    fprintf(out, "%s%s = %s %s %s to %s", SPACES, inst->operands[0]->data,
-            opname, inst->operands[1]->type_struct->str,
-            inst->operands[1]->data, inst->operands[0]->type_struct->str);
+    write_inst_head(out, inst->operands[0], opname);
+    write_typed_operand(out, inst->operands[1]);
+    ll_puts(out, " to ");
+    ll_puts(out, inst->operands[0]->type_struct->str);
     break;
   case LL_BITCAST:
     render_bitcast(out, inst);
     break;
   case LL_RET:
-    fprintf(out, "%sret %s %s", SPACES, inst->operands[0]->type_struct->str,
-            inst->operands[0]->data);
+    ll_puts(out, SPACES "ret ");
+    write_typed_operand(out, inst->operands[0]);
     break;
   case LL_ICMP:
   case LL_FCMP:
-    fprintf(out, "%s%s = %s %s %s %s, %s", SPACES, inst->operands[0]->data,
-            opname, inst->operands[1]->data,
-            inst->operands[2]->type_struct->str, inst->operands[2]->data,
-            inst->operands[3]->data);
+    write_inst_head(out, inst->operands[0], opname);
+    ll_puts(out, inst->operands[1]->data);
+    LL_PUTC(' ', out);
+    write_typed_operand(out, inst->operands[2]);
+    ll_puts(out, ", ");
+    ll_puts(out, inst->operands[3]->data);
     break;
   case LL_SELECT:
-    fprintf(out, "%s%s = select i1 %s, %s %s, %s %s", SPACES,
-            inst->operands[0]->data, inst->operands[1]->data,
-            inst->operands[2]->type_struct->str, inst->operands[2]->data,
-            inst->operands[3]->type_struct->str, inst->operands[3]->data);
+    write_inst_head(out, inst->operands[0], "select i1");
+    ll_puts(out, inst->operands[1]->data);
+    ll_puts(out, ", ");
+    write_typed_operand(out, inst->operands[2]);
+    ll_puts(out, ", ");
+    write_typed_operand(out, inst->operands[3]);
     break;
   case LL_BR:
-    fprintf(out, "%sbr i1 %s, label %%%s, label %%%s", SPACES,
-            inst->operands[0]->data, inst->operands[1]->data,
-            inst->operands[2]->data);
+    ll_puts(out, SPACES "br i1 ");
+    ll_puts(out, inst->operands[0]->data);
+    ll_puts(out, ", label %");
+    ll_puts(out, inst->operands[1]->data);
+    ll_puts(out, ", label %");
+    ll_puts(out, inst->operands[2]->data);
     print_branch_target = 1;
     break;
   case LL_UBR:
-    fprintf(out, "%sbr label %%%s", SPACES, inst->operands[0]->data);
+    ll_puts(out, SPACES "br label %");
+    ll_puts(out, inst->operands[0]->data);
     break;
   case LL_CALL:
     /* TODO: support fancier calls */
-    if (inst->operands[0]->type_struct->data_type != LL_VOID) {
-      fprintf(out, "%s%s = call %s @%s(", SPACES, inst->operands[0]->data,
-              inst->operands[1]->type_struct->str, inst->operands[1]->data);
-    } else {
-      fprintf(out, "%scall %s @%s(", SPACES,
-              inst->operands[1]->type_struct->str, inst->operands[1]->data);
-    }
+    write_call_head(out, inst);
     for (i = 2; i < inst->num_operands; i++) {
-      fprintf(out, "%s %s", inst->operands[i]->type_struct->str,
-              inst->operands[i]->data);
+      write_typed_operand(out, inst->operands[i]);
       if (i + 1 < inst->num_operands) {
-        fprintf(out, ", ");
+        ll_puts(out, ", ");
       }
     }
-    fprintf(out, ")");
+    LL_PUTC(')', out);
     if (!inst->flags & IN_MODULE_CALL) {
       add_prototype(inst);
     }
     break;
   case LL_TEXTCALL:
-    if (inst->operands[0]->type_struct->data_type != LL_VOID) {
-      fprintf(out, "%s%s = call %s @%s(", SPACES, inst->operands[0]->data,
-              inst->operands[1]->type_struct->str, inst->operands[1]->data);
-    } else {
-      fprintf(out, "%scall %s @%s(", SPACES,
-              inst->operands[1]->type_struct->str, inst->operands[1]->data);
-    }
-    fprintf(out, "metadata !{%s %s}, ", inst->operands[2]->type_struct->str,
-            inst->operands[2]->data);
-    fprintf(out, "%s %s", inst->operands[2]->type_struct->str,
-            inst->operands[2]->data);
-    fprintf(out, ")");
+    write_call_head(out, inst);
+    ll_puts(out, "metadata !{");
+    write_typed_operand(out, inst->operands[2]);
+    ll_puts(out, "}, ");
+    write_typed_operand(out, inst->operands[2]);
+    LL_PUTC(')', out);
     text_calls = 1;
     break;
   case LL_GEP:
-    fprintf(out, "%s%s = getelementptr %s %s", SPACES, inst->operands[0]->data,
-            inst->operands[1]->type_struct->str, inst->operands[1]->data);
+    write_inst_head(out, inst->operands[0], "getelementptr");
+    write_typed_operand(out, inst->operands[1]);
     for (i = 2; i < inst->num_operands; i++) {
-      fprintf(out, ", %s %s", inst->operands[i]->type_struct->str,
-              inst->operands[i]->data);
+      ll_puts(out, ", ");
+      write_typed_operand(out, inst->operands[i]);
     }
     break;
   case LL_ALLOCA:
-    fprintf(out, "%s%s = alloca %s", SPACES, inst->operands[0]->data,
-            inst->operands[1]->type_struct->str);
-    if (inst->num_operands >= 3)
-      fprintf(out, ", align %s", inst->operands[2]->data);
+    write_inst_head(out, inst->operands[0], "alloca");
+    ll_puts(out, inst->operands[1]->type_struct->str);
+    write_align(out, inst, 2);
     break;
   case LL_UNREACHABLE:
-    fprintf(out, "%sunreachable", SPACES);
+    ll_puts(out, SPACES "unreachable");
     break;
   case LL_SWITCH:
-    fprintf(out, "%sswitch %s %s, label %%%s [\n", SPACES,
-            inst->operands[0]->type_struct->str, inst->operands[0]->data,
-            inst->operands[1]->data);
+    ll_puts(out, SPACES "switch ");
+    write_typed_operand(out, inst->operands[0]);
+    ll_puts(out, ", label %");
+    ll_puts(out, inst->operands[1]->data);
+    ll_puts(out, " [\n");
     for (i = 2; i < inst->num_operands; i += 2) {
-      fprintf(out, "%s  %s %s, label %%%s\n", SPACES,
-              inst->operands[i + 0]->type_struct->str,
-              inst->operands[i + 0]->data, inst->operands[i + 1]->data);
+      ll_puts(out, SPACES "  ");
+      write_typed_operand(out, inst->operands[i + 0]);
+      ll_puts(out, ", label %");
+      ll_puts(out, inst->operands[i + 1]->data);
+      LL_PUTC('\n', out);
     }
-    fprintf(out, "%s]", SPACES);
+    ll_puts(out, SPACES "]");
     break;
   case LL_NONE:
     break;
@@ -477,17 +606,19 @@ ll_write_instruction(FILE *out, struct LL_Instruction_ *inst)
     break;
   }
   if (!LL_MDREF_IS_NULL(inst->dbg_line_op)) {
-    fprintf(out, ", !dbg !%u", LL_MDREF_value(inst->dbg_line_op));
+    ll_puts(out, ", !dbg !");
+    ll_putu(out, LL_MDREF_value(inst->dbg_line_op));
   }
 #if DEBUG
   if (inst->comment)
     fprintf(out, " ; %s", inst->comment);
 #endif
 
-  fputc('\n', out);
-  if (print_branch_target)
-    fprintf(out, "%s:\n", inst->operands[2]->data);
-  fflush(out);
+  LL_PUTC('\n', out);
+  if (print_branch_target) {
+    ll_puts(out, inst->operands[2]->data);
+    ll_puts(out, ":\n");
+  }
 }
 
 /**
@@ -505,7 +636,8 @@ ll_write_object_dbg_references(FILE *out, LL_Module *m, LL_ObjToDbgList *ods)
     return;
   for (llObjtodbgFirst(ods, &i); !llObjtodbgAtEnd(&i); llObjtodbgNext(&i)) {
     LL_MDRef mdnode = llObjtodbgGet(&i);
-    fprintf(out, ", !dbg !%u", LL_MDREF_value(mdnode));    
+    ll_puts(out, ", !dbg !");
+    ll_putu(out, LL_MDREF_value(mdnode));
   }
   llObjtodbgFree(ods);
 }
@@ -947,36 +1079,41 @@ write_mdref(FILE *out, LL_Module *module, LL_MDRef rmdref,
 
   switch (LL_MDREF_kind(mdref)) {
   case MDRef_Node:
-    if (LL_MDREF_value(mdref))
-      fprintf(out, "%s!%u", tag, LL_MDREF_value(mdref));
-    else
-      fprintf(out, "null");
+    if (LL_MDREF_value(mdref)) {
+      ll_puts(out, tag);
+      LL_PUTC('!', out);
+      ll_putu(out, LL_MDREF_value(mdref));
+    } else {
+      ll_puts(out, "null");
+    }
     break;
 
   case MDRef_String:
     assert(LL_MDREF_value(mdref) < module->mdstrings_count, "Bad string MDRef",
            LL_MDREF_value(mdref), 4);
-    fprintf(out, "%s%s", tag, module->mdstrings[LL_MDREF_value(mdref)]);
+    ll_puts(out, tag);
+    ll_puts(out, module->mdstrings[LL_MDREF_value(mdref)]);
     break;
 
   case MDRef_Constant:
     assert(LL_MDREF_value(mdref) < module->constants_count,
            "Bad constant MDRef", LL_MDREF_value(mdref), 4);
-    fprintf(out, "%s %s",
-            module->constants[LL_MDREF_value(mdref)]->type_struct->str,
-            module->constants[LL_MDREF_value(mdref)]->data);
+    write_typed_operand(out, module->constants[LL_MDREF_value(mdref)]);
     break;
 
   case MDRef_SmallInt1:
-    fprintf(out, "i1 %u", LL_MDREF_value(mdref));
+    ll_puts(out, "i1 ");
+    ll_putu(out, LL_MDREF_value(mdref));
     break;
 
   case MDRef_SmallInt32:
-    fprintf(out, "i32 %u", LL_MDREF_value(mdref));
+    ll_puts(out, "i32 ");
+    ll_putu(out, LL_MDREF_value(mdref));
     break;
 
   case MDRef_SmallInt64:
-    fprintf(out, "i64 %u", LL_MDREF_value(mdref));
+    ll_puts(out, "i64 ");
+    ll_putu(out, LL_MDREF_value(mdref));
     break;
 
   default:
@@ -1014,6 +1151,14 @@ dwarf_emission_name(int value)
    The formatting is guided by the field type from the MDTemplate, and the
    MDRef types are validated. 
  */
+static void
+write_mdfield_label(FILE *out, const char *prefix, const MDTemplate *tmpl)
+{
+  ll_puts(out, prefix);
+  ll_puts(out, tmpl->name);
+  ll_puts(out, ": ");
+}
+
 static int
 write_mdfield(FILE *out, LL_Module *module, int needs_comma, LL_MDRef mdref,
               const MDTemplate *tmpl)
@@ -1030,9 +1175,12 @@ write_mdfield(FILE *out, LL_Module *module, int needs_comma, LL_MDRef mdref,
     if (value) {
       assert(tmpl->type == NodeField, "metadata elem should not be a mdnode",
              tmpl->type, 4);
-      fprintf(out, "%s%s: !%u", prefix, tmpl->name, value);
+      write_mdfield_label(out, prefix, tmpl);
+      LL_PUTC('!', out);
+      ll_putu(out, value);
     } else if (mandatory) {
-      fprintf(out, "%s%s: null", prefix, tmpl->name);
+      write_mdfield_label(out, prefix, tmpl);
+      ll_puts(out, "null");
     } else {
       return FALSE;
     }
@@ -1045,37 +1193,37 @@ write_mdfield(FILE *out, LL_Module *module, int needs_comma, LL_MDRef mdref,
     if (!mandatory && strcmp(module->mdstrings[value], "!\"\"") == 0)
       return FALSE;
     /* The mdstrings[] entry is formatted as !"...". String the leading !. */
-    fprintf(out, "%s%s: %s", prefix, tmpl->name, module->mdstrings[value] + 1);
+    write_mdfield_label(out, prefix, tmpl);
+    ll_puts(out, module->mdstrings[value] + 1);
     break;
 
   case MDRef_Constant:
     assert(value < module->constants_count, "Bad constant MDRef", value, 4);
     switch (tmpl->type) {
     case ValueField:
-      fprintf(out, "%s%s: %s %s", prefix, tmpl->name,
-              module->constants[value]->type_struct->str,
-              module->constants[value]->data);
+      write_mdfield_label(out, prefix, tmpl);
+      write_typed_operand(out, module->constants[value]);
       break;
 
     case UnsignedField:
+      write_mdfield_label(out, prefix, tmpl);
       if (module->constants[value]->data[0] == '-') {
         /* The value stored is negative.  LLVM expects it to be unsigned, so
            convert it to be positive. */
         long long intval = strtoll(module->constants[value]->data, NULL, 10);
         if ((long long)INT_MIN <= intval && intval < 0) {
           /* It was most likely a 32 bit value originally. */
-          fprintf(out, "%s%s: %u", prefix, tmpl->name, (unsigned)(int)intval);
+          ll_putu(out, (unsigned)(int)intval);
         } else {
-          fprintf(out, "%s%s: %llu", prefix, tmpl->name, intval);
+          ll_putu(out, (BIGUINT64)intval);
         }
       } else {
-        fprintf(out, "%s%s: %s", prefix, tmpl->name,
-                module->constants[value]->data);
+        ll_puts(out, module->constants[value]->data);
       }
       break;
     case SignedField:
-      fprintf(out, "%s%s: %s", prefix, tmpl->name,
-              module->constants[value]->data);
+      write_mdfield_label(out, prefix, tmpl);
+      ll_puts(out, module->constants[value]->data);
       break;
 
     default:
@@ -1091,34 +1239,39 @@ write_mdfield(FILE *out, LL_Module *module, int needs_comma, LL_MDRef mdref,
     switch (tmpl->type) {
     case UnsignedField:
     case SignedField:
-      fprintf(out, "%s%s: %u", prefix, tmpl->name, value);
+      write_mdfield_label(out, prefix, tmpl);
+      ll_putu(out, value);
       break;
 
     case BoolField:
       assert(value <= 1, "boolean value expected", value, 4);
-      fprintf(out, "%s%s: %s", prefix, tmpl->name, value ? "true" : "false");
+      write_mdfield_label(out, prefix, tmpl);
+      ll_puts(out, value ? "true" : "false");
       break;
 
     case DWTagField:
-      fprintf(out, "%s%s: %s", prefix, tmpl->name,
-              dwarf_tag_name(value & 0xffff));
+      write_mdfield_label(out, prefix, tmpl);
+      ll_puts(out, dwarf_tag_name(value & 0xffff));
       break;
 
     case DWLangField:
-      fprintf(out, "%s%s: %s", prefix, tmpl->name, dwarf_lang_name(value));
+      write_mdfield_label(out, prefix, tmpl);
+      ll_puts(out, dwarf_lang_name(value));
       break;
 
     case DWVirtualityField:
-      fprintf(out, "%s%s: %s", prefix, tmpl->name,
-              dwarf_virtuality_name(value));
+      write_mdfield_label(out, prefix, tmpl);
+      ll_puts(out, dwarf_virtuality_name(value));
       break;
 
     case DWEncodingField:
-      fprintf(out, "%s%s: %s", prefix, tmpl->name, dwarf_encoding_name(value));
+      write_mdfield_label(out, prefix, tmpl);
+      ll_puts(out, dwarf_encoding_name(value));
       break;
 
     case DWEmissionField:
-      fprintf(out, "%s%s: %s", prefix, tmpl->name, dwarf_emission_name(value));
+      write_mdfield_label(out, prefix, tmpl);
+      ll_puts(out, dwarf_emission_name(value));
       break;
 
     default:
@@ -1146,20 +1299,20 @@ write_mdnode_plain(FILE *out, LL_Module *module, const LL_MDNode *node,
   unsigned i;
 
   if (!omit_metadata_type)
-    fprintf(out, "metadata ");
+    ll_puts(out, "metadata ");
 
   if (ll_feature_use_distinct_metadata(&module->ir) && node->is_distinct)
-    fprintf(out, "distinct ");
+    ll_puts(out, "distinct ");
 
-  fprintf(out, "!{ ");
+  ll_puts(out, "!{ ");
   for (i = 0; i < node->num_elems; i++) {
     LL_MDRef mdref = LL_MDREF_INITIALIZER(0, 0);
     mdref = node->elem[i];
     if (i > 0)
-      fprintf(out, ", ");
+      ll_puts(out, ", ");
     write_mdref(out, module, mdref, omit_metadata_type);
   }
-  fprintf(out, " }\n");
+  ll_puts(out, " }\n");
 }
 
 /*
@@ -1177,16 +1330,18 @@ write_mdnode_spec(FILE *out, LL_Module *module, const LL_MDNode *node,
   int needs_comma = FALSE;
 
   if (ll_feature_use_distinct_metadata(&module->ir) && node->is_distinct)
-    fprintf(out, "distinct ");
+    ll_puts(out, "distinct ");
 
   assert(node->num_elems <= num_fields, "metadata node has too many fields.",
          node->num_elems, ERR_Fatal);
 
-  fprintf(out, "!%s(", tmpl->name);
+  LL_PUTC('!', out);
+  ll_puts(out, tmpl->name);
+  LL_PUTC('(', out);
   for (i = 0; i < node->num_elems; i++)
     if (write_mdfield(out, module, needs_comma, node->elem[i], &tmpl[i + 1]))
       needs_comma = TRUE;
-  fprintf(out, ")\n");
+  ll_puts(out, ")\n");
 }
 
 /**
@@ -1269,7 +1424,9 @@ static MDDispatch mdDispTable[LL_MDClass_MAX] = {
 INLINE static void
 emitRegularPrefix(FILE *out, unsigned mdi)
 {
-  fprintf(out, "!%u = ", mdi);
+  LL_PUTC('!', out);
+  ll_putu(out, mdi);
+  ll_puts(out, " = ");
 }
 
 /** Simple helper function */
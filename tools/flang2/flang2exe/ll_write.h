@@ -35,6 +35,21 @@ void ll_write_llvm_used(FILE *out, LLVMModuleRef module);
 void ll_write_global_objects(FILE *out, LLVMModuleRef module);
 void ll_write_local_objects(FILE *out, struct LL_Function_ *function);
 void ll_write_metadata(FILE *out, LLVMModuleRef module);
+bool ll_merge_modules(FILE *out, FILE *parts[], int nparts);
 void ll_write_object_dbg_references(FILE *, LL_Module *, LL_ObjToDbgList *);
 
+/*
+ * Output layer for the LLVM IR text.  The IR file is given a large stdio
+ * buffer by ll_set_output_buffer() and the writers below append to it
+ * without going through the printf format interpreter or the stream lock.
+ */
+
+#define LL_PUTC(c, out) putc_unlocked((c), (out))
+
+void ll_set_output_buffer(FILE *out);
+void ll_puts(FILE *out, const char *s);
+void ll_putu(FILE *out, BIGUINT64 val);
+void ll_puti(FILE *out, BIGINT64 val);
+void ll_putx(FILE *out, BIGUINT64 val, int digits);
+
 #endif
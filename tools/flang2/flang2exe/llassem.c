@@ -46,14 +46,12 @@
 /* --- AGB local --- */
 static AGB_t agb_local;
 #define AGL_SYMLK(s) agb_local.s_base[s].symlk
-#define AGL_HASHLK(s) agb_local.s_base[s].hashlk
-#define AGL_NMPTR(s) agb_local.s_base[s].nmptr
 #define AGL_TYPENMPTR(s) agb_local.s_base[s].type_nmptr
 #define AGL_ARGNMPTR(s) agb_local.s_base[s].farg_nmptr
 #define AGL_DTYPE(s) agb_local.s_base[s].dtype
 #define AGL_REF(s) agb_local.s_base[s].ref
 #define AGL_NEEDMOD(s) agb_local.s_base[s].needmod
-#define AGL_NAME(s) agb_local.n_base + agb_local.s_base[s].nmptr
+#define AGL_NAME(s) ((char *)agb_local.s_base[s].name)
 #define AGL_TYPENAME(s) agb_local.n_base + agb_local.s_base[s].type_nmptr
 #define AGL_ARGNAME(s) agb_local.n_base + agb_local.s_base[s].farg_nmptr
 #define AGL_ARGDTLIST(s) agb_local.s_base.argdtlist
@@ -193,55 +191,67 @@ static struct {
 
 /* *********************************************************/
 
-static int
-name_to_hash(const char *ag_name, int len)
+/* The names of the entries of the AG tables are interned, so that each is
+ * hashed once when it is entered or looked up; the map from a name to its
+ * entry then works on the interned pointer. */
+static void
+init_ag_names(AGNAMES *names)
 {
-  int hashval = ag_name[len - 1] | (ag_name[0] << 16) | (ag_name[1] << 8);
-  return hashval % AG_HASHSZ;
+  names->strs = strtab_alloc();
+  names->map = hashmap_alloc(hash_functions_interned);
 }
 
-static int
-add_ag_name(char *ag_name)
+static void
+free_ag_names(AGNAMES *names)
 {
-  int i, nptr, len, needed;
-  char *np;
+  if (names->strs) {
+    hashmap_free(names->map);
+    strtab_free(names->strs);
+    names->map = NULL;
+    names->strs = NULL;
+  }
+}
 
-  len = strlen(ag_name);
-  nptr = agb.n_avl;
-  agb.n_avl += (len + 1);
+/* Return the entry named ag_name, or 0 */
+static int
+find_ag_name(AGNAMES *names, const char *ag_name)
+{
+  const char *key = strtab_lookup(names->strs, ag_name, strlen(ag_name));
+  hash_data_t entry;
 
-  if ((len + 1) >= (32 * 16))
-    needed = len + 1;
-  else
-    needed = 32 * 16;
+  if (key && hashmap_lookup(names->map, key, &entry))
+    return HKEY2INT(entry);
+  return 0;
+}
 
-  NEED(agb.n_avl, agb.n_base, char, agb.n_size, agb.n_size + needed);
-  np = agb.n_base + nptr;
-  for (i = 0; i < len; i++)
-    *np++ = *ag_name++;
-  *np = '\0';
+/* Make entry the one named ag_name and return the interned name */
+static const char *
+enter_ag_name(AGNAMES *names, const char *ag_name, int entry)
+{
+  const char *key = strtab_intern(names->strs, ag_name, strlen(ag_name));
+  hash_data_t data = INT2HKEY(entry);
 
-  return nptr;
+  hashmap_replace(names->map, key, &data);
+  return key;
 }
 
 static int
-add_ag_local_name(char *ag_name)
+add_ag_name(char *ag_name)
 {
   int i, nptr, len, needed;
   char *np;
 
   len = strlen(ag_name);
-  nptr = agb_local.n_avl;
-  agb_local.n_avl += (len + 1);
+  nptr = agb.n_avl;
+  agb.n_avl += (len + 1);
 
   if ((len + 1) >= (32 * 16))
     needed = len + 1;
   else
     needed = 32 * 16;
 
-  NEED(agb_local.n_avl, agb_local.n_base, char, agb_local.n_size,
-       agb_local.n_size + needed);
-  np = agb_local.n_base + nptr;
+  NEED(agb.n_avl, agb.n_base, char, agb.n_size, agb.n_size + needed);
+  np = agb.n_base + nptr;
   for (i = 0; i < len; i++)
     *np++ = *ag_name++;
   *np = '\0';
@@ -258,20 +268,15 @@ count_skip(ISZ_T old, ISZ_T new)
 static int
 make_gblsym(int sptr, char *ag_name)
 {
-  int nptr, hashval, gblsym, dtype;
+  int gblsym, dtype;
 
   gblsym = agb.s_avl++;
   NEED(agb.s_avl, agb.s_base, AG, agb.s_size, agb.s_size + 32);
   BZERO(&agb.s_base[gblsym], AG, 1);
 
-  nptr = add_ag_name(ag_name);
-  AG_NMPTR(gblsym) = nptr;
+  agb.s_base[gblsym].name = enter_ag_name(&agb.names, ag_name, gblsym);
   AG_DLL(gblsym) = DLL_NONE;
 
-  hashval = name_to_hash(ag_name, strlen(ag_name));
-  AG_HASHLK(gblsym) = agb.hashtb[hashval];
-  agb.hashtb[hashval] = gblsym;
-
   if (sptr) {
     AG_SC(gblsym) = SCG(sptr);
     AG_STYPE(gblsym) = STYPEG(sptr);
@@ -322,13 +327,7 @@ get_typedef_ag(char *ag_name, char *typename)
 int
 find_ag(const char *ag_name)
 {
-  int gblsym, hashval = name_to_hash(ag_name, strlen(ag_name));
-
-  for (gblsym = agb.hashtb[hashval]; gblsym; gblsym = AG_HASHLK(gblsym))
-    if (!strcmp(ag_name, AG_NAME(gblsym)))
-      return gblsym;
-
-  return 0;
+  return find_ag_name(&agb.names, ag_name);
 }
 
 /*
@@ -393,6 +392,7 @@ assemble_init(int argc, char *argv[], char *cmdline)
   agb.n_avl = 0;
   NEW(agb.s_base, AG, agb.s_size);
   NEW(agb.n_base, char, agb.n_size);
+  init_ag_names(&agb.names);
 
   /* Set the inital entry to a canary */
   add_ag_typename(0, "BADTYPE");
@@ -835,7 +835,7 @@ assem_init(void)
   agb_local.n_avl = 0;
   NEW(agb_local.s_base, AG, agb_local.s_size);
   NEW(agb_local.n_base, char, agb_local.n_size);
-  BZERO(agb_local.hashtb, int, AG_HASHSZ);
+  init_ag_names(&agb_local.names);
 
   /* ptr_local - store name for function pointer per routine */
   ptr_local = 0;
@@ -845,7 +845,7 @@ assem_init(void)
   fptr_local.n_avl = 0;
   NEW(fptr_local.s_base, FPTRSYM, fptr_local.s_size);
   NEW(fptr_local.n_base, char, fptr_local.n_size);
-  BZERO(fptr_local.hashtb, int, AG_HASHSZ);
+  init_ag_names(&fptr_local.names);
 
 } /* endroutine assem_init */
 
@@ -919,6 +919,7 @@ assem_end(void)
   ag_local = 0;
   FREE(agb_local.s_base);
   FREE(agb_local.n_base);
+  free_ag_names(&agb_local.names);
   agb_local.s_base = NULL;
   agb_local.n_base = NULL;
   agb_local.s_avl = 0;
@@ -929,6 +930,7 @@ assem_end(void)
   ptr_local = 0;
   FREE(fptr_local.s_base);
   FREE(fptr_local.n_base);
+  free_ag_names(&fptr_local.names);
   fptr_local.s_base = NULL;
   fptr_local.n_base = NULL;
   fptr_local.n_avl = 0;
@@ -1039,6 +1041,7 @@ assemble_end(void)
 
   FREE(agb.s_base);
   FREE(agb.n_base);
+  free_ag_names(&agb.names);
 } /* endroutine assemble_end */
 
 static void
@@ -2759,7 +2762,7 @@ dump_ag(void)
 {
   int i;
   for (i = 0; i < agb.s_avl; ++i)
-    if (AG_HASHLK(i))
+    if (agb.s_base[i].name)
       dump_gblsym(i);
 }
 
@@ -3046,12 +3049,7 @@ get_ag_return_lltype(int gblsym)
 static int
 find_local_ag(char *ag_name)
 {
-  int gsym, hashval = name_to_hash(ag_name, strlen(ag_name));
-
-  for (gsym = agb_local.hashtb[hashval]; gsym; gsym = AGL_HASHLK(gsym))
-    if (!strcmp(ag_name, AGL_NAME(gsym)))
-      return gsym;
-  return 0;
+  return find_ag_name(&agb_local.names, ag_name);
 }
 
 static int
@@ -5008,11 +5006,10 @@ Found:
 int
 get_dummy_ag(int sptr)
 {
-  int gblsym, nptr, hashval;
+  int gblsym;
   char *ag_name;
 
   ag_name = get_llvm_name(sptr);
-  hashval = name_to_hash(ag_name, strlen(ag_name));
   gblsym = find_local_ag(ag_name);
 
   if (gblsym)
@@ -5023,12 +5020,9 @@ get_dummy_ag(int sptr)
   NEED(agb_local.s_avl + 1, agb_local.s_base, AG, agb_local.s_size,
        agb_local.s_size + 32);
 
-  nptr = add_ag_local_name(ag_name);
-
   BZERO(&agb_local.s_base[gblsym], AG, 1);
-  AGL_NMPTR(gblsym) = nptr;
-  AGL_HASHLK(gblsym) = agb_local.hashtb[hashval];
-  agb_local.hashtb[hashval] = gblsym;
+  agb_local.s_base[gblsym].name =
+      enter_ag_name(&agb_local.names, ag_name, gblsym);
   AGL_SYMLK(gblsym) = ag_local;
   ag_local = gblsym;
   if (MIDNUMG(sptr))
@@ -5254,33 +5248,11 @@ write_module_as_subroutine(void)
 int
 find_funcptr_name(int sptr)
 {
-  int gblsym, hashval, len;
-  char *np, *sp, sptrnm[MXIDLN];
+  char sptrnm[MXIDLN];
 
   /* Key */
   sprintf(sptrnm, "%s_%d", get_llvm_name(sptr), sptr); /* Local name */
-  len = strlen(sptrnm);
-  hashval = name_to_hash(sptrnm, len);
-
-  for (gblsym = fptr_local.hashtb[hashval]; gblsym;
-       gblsym = FPTR_HASHLK(gblsym)) {
-    np = sptrnm;
-    sp = FPTR_NAME(gblsym);
-    do {
-      if (*np++ != *sp++)
-        goto Continue;
-    } while (*sp);
-    if (np - sptrnm != len)
-      continue;
-    goto Found;
-  Continue:
-    if (gblsym == FPTR_HASHLK(gblsym))
-      return 0;
-  }
-  return 0;
-
-Found:
-  return gblsym;
+  return find_ag_name(&fptr_local.names, sptrnm);
 }
 
 /* Return the AG number associated to the local sptr value:
@@ -5321,7 +5293,7 @@ set_llvm_iface_oldname(int gblsym, char *nm)
 void
 llvm_funcptr_store(int sptr, char *ag_name)
 {
-  int hashval, gblsym;
+  int gblsym;
   char sptrnm[MXIDLN];
   INT nmptr;
 
@@ -5336,12 +5308,10 @@ llvm_funcptr_store(int sptr, char *ag_name)
   BZERO(&fptr_local.s_base[gblsym], FPTRSYM, 1);
 
   sprintf(sptrnm, "%s_%d", get_llvm_name(sptr), sptr);
-  hashval = name_to_hash(sptrnm, strlen(sptrnm));
-  fptr_local.hashtb[hashval] = gblsym;
-  FPTR_HASHLK(gblsym) = fptr_local.hashtb[hashval];
   FPTR_SYMLK(gblsym) = ptr_local;
-  nmptr = add_ag_fptr_name(sptrnm); /* fnptr_local key */
-  FPTR_NMPTR(gblsym) = nmptr;
+  /* fnptr_local key */
+  fptr_local.s_base[gblsym].name =
+      enter_ag_name(&fptr_local.names, sptrnm, gblsym);
   nmptr = add_ag_fptr_name(ag_name); /* gblsym key      */
   FPTR_IFACENMPTR(gblsym) = nmptr;
   ptr_local = gblsym;
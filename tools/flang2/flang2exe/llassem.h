@@ -19,6 +19,7 @@
 #define LLASSEM_H_
 
 #include "llutil.h"
+#include "flang/ADT/strtab.h"
 
 typedef struct argdtlist DTLIST;
 
@@ -105,13 +106,10 @@ void hostsym_is_refd(int sptr);
 
 /* structures and routines to process assembler globals for the entire file */
 
-#define AG_HASHSZ 19
 #define AG_SIZE(s) agb.s_base[s].size
 #define AG_ALIGN(s) agb.s_base[s].align
 #define AG_DSIZE(s) agb.s_base[s].dsize
 #define AG_SYMLK(s) agb.s_base[s].symlk
-#define AG_HASHLK(s) agb.s_base[s].hashlk
-#define AG_NMPTR(s) agb.s_base[s].nmptr
 #define AG_TYPENMPTR(s) agb.s_base[s].type_nmptr
 #define AG_OLDNMPTR(s) agb.s_base[s].old_nmptr
 #define AG_TYPEDESC(s) agb.s_base[s].typedesc /* Boolean */
@@ -138,18 +136,16 @@ void hostsym_is_refd(int sptr);
 #define AG_UPLEVEL_NEW(s, i) agb.s_base[s].uplist[i].newsptr
 #define AG_UPLEVEL_MEM(s, i) agb.s_base[s].uplist[i].newmem
 #define AG_DLL(s) agb.s_base[s].dll
-#define AG_NAME(s) agb.n_base + agb.s_base[s].nmptr
+#define AG_NAME(s) ((char *)agb.s_base[s].name)
 #define AG_TYPENAME(s) agb.n_base + agb.s_base[s].type_nmptr
 #define AG_OLDNAME(s) agb.n_base + agb.s_base[s].old_nmptr
 #define AG_ARGDTLIST(s) agb.s_base[s].argdtlist
 #define AG_ARGDTLIST_LENGTH(s) agb.s_base[s].n_argdtlist
 #define AG_ARGDTLIST_IS_VALID(s) agb.s_base[s].argdtlist_is_set
 
-#define FPTR_HASHLK(s) fptr_local.s_base[s].hashlk
 #define FPTR_IFACENMPTR(s) fptr_local.s_base[s].ifacenmptr
 #define FPTR_IFACENM(s) fptr_local.n_base + fptr_local.s_base[s].ifacenmptr
-#define FPTR_NMPTR(s) fptr_local.s_base[s].nmptr
-#define FPTR_NAME(s) fptr_local.n_base + fptr_local.s_base[s].nmptr
+#define FPTR_NAME(s) ((char *)fptr_local.s_base[s].name)
 #define FPTR_SYMLK(s) fptr_local.s_base[s].symlk
 
 #define DEFINE_STRUCT
@@ -160,7 +156,7 @@ typedef struct {/* assem's global st entries */
   ISZ_T size;   /* max size of common block in file */
   /* if entry/proc, 1 => defd, 0 => proc */
   ISZ_T dsize; /* size of common block when init'd */
-  INT nmptr;
+  const char *name; /* interned in the table's names */
   INT type_nmptr;  /* Used for external function */
   INT farg_nmptr;  /* make all function that is not defined in
                       same file vararg with first argument
@@ -168,7 +164,6 @@ typedef struct {/* assem's global st entries */
   INT old_nmptr;   /* Used for interface to keep original function name */
   INT align;       /* alignment for BIND(C) variables */
   int symlk;       /* used to link ST_CMBLK and ST_PROC */
-  int hashlk;      /* hash collision field */
   int dtype;       /* used for keep track dtype which is
                       created for static/bss area (only
                       for AGL ag-local) */
@@ -197,6 +192,14 @@ typedef struct {/* assem's global st entries */
   unsigned istls : 1;    /* set if this is TLS */
 } AG;
 
+/**
+   \brief names of the entries of one of assem's symbol tables
+ */
+typedef struct AGNAMES {
+  strtab_t strs; /* the names, interned */
+  hashmap_t map; /* interned name -> entry */
+} AGNAMES;
+
 /**
    \brief storage allocation structure for assem's symtab
  */
@@ -204,10 +207,10 @@ typedef struct AGB_t {
   AG *s_base;   /* pointer to table of common block nodes */
   int s_size;   /* size of CM table */
   int s_avl;    /* currently available entry */
-  char *n_base; /* pointer to names space */
+  char *n_base; /* pointer to names space for the other strings */
   int n_size;
   int n_avl;
-  int hashtb[AG_HASHSZ];
+  AGNAMES names;
 } AGB_t;
 
 DEFINE_STRUCT AGB_t agb;
@@ -218,9 +221,8 @@ void set_ag_lltype(int gblsym, LL_Type *llt);
 
 /** similar to AG struct but smaller */
 typedef struct {
-  INT nmptr;
+  const char *name; /* interned in fptr_local.names */
   INT ifacenmptr;
-  int hashlk;
   int symlk;
 } FPTRSYM;
 
@@ -229,10 +231,10 @@ DEFINE_STRUCT struct {
   FPTRSYM *s_base;
   int s_size;
   int s_avl;
-  char *n_base; /* pointer to names space */
+  char *n_base; /* pointer to names space for interface names */
   int n_size;
   int n_avl;
-  int hashtb[AG_HASHSZ];
+  AGNAMES names;
 } fptr_local;
 
 DEFINE_STRUCT DSRT *lcl_inits;     /* head list of DSRT's for local variables */
@@ -34,6 +34,7 @@
 #include "cgllvm.h"
 #include "cg.h"
 #include "ll_structure.h"
+#include "ll_write.h"
 
 #define LLASSEM_DEFINE_STRUCTS
 #include "llassem.h"
@@ -65,10 +66,10 @@ put_next_member(char *ptr)
   if (*ptr == ',')
     ptr++;
   while (*ptr != ',' && *ptr != '\0') {
-    fprintf(ASMFIL, "%c", *ptr);
+    LL_PUTC(*ptr, ASMFIL);
     ptr++;
   }
-  fprintf(ASMFIL, " ");
+  LL_PUTC(' ', ASMFIL);
   return ptr;
 }
 
@@ -81,20 +82,20 @@ put_skip(ISZ_T old, ISZ_T new)
     INT i;
     i = amt;
     while (i > 32) {
-      fprintf(ASMFIL, "i8 0,i8 0,i8 0,i8 0,i8 0,i8 0,i8 0,i8 0,i8 0,i8 0,i8 "
+      ll_puts(ASMFIL, "i8 0,i8 0,i8 0,i8 0,i8 0,i8 0,i8 0,i8 0,i8 0,i8 0,i8 "
                       "0,i8 0,i8 0,i8 0,i8 0,i8 0,i8 0,i8 0,i8 0,i8 0,i8 0,i8 "
                       "0,i8 0,i8 0,i8 0,i8 0,i8 0,i8 0,i8 0,i8 0,i8 0,i8 0");
       i -= 32;
       if (i)
-        fprintf(ASMFIL, ",");
+        LL_PUTC(',', ASMFIL);
     }
     if (i) {
       while (1) {
-        fprintf(ASMFIL, "i8 0");
+        ll_puts(ASMFIL, "i8 0");
         i--;
         if (i == 0)
           break;
-        fprintf(ASMFIL, ",");
+        LL_PUTC(',', ASMFIL);
       }
     }
   } else {
@@ -136,18 +137,18 @@ emit_init(int tdtype, ISZ_T tconval, ISZ_T *addr, ISZ_T *repeat_cnt,
     }
     if (*ptrcnt) {
       if (!first_data)
-        fprintf(ASMFIL, ", ");
+        ll_puts(ASMFIL, ", ");
       *cptr = put_next_member(*cptr);
-      fprintf(ASMFIL, "[" /*]*/);
+      ll_puts(ASMFIL, "[" /*]*/);
       *ptrcnt = 0;
     } else if (!(*i8cnt)) {
       if (!first_data)
-        fprintf(ASMFIL, ", ");
+        ll_puts(ASMFIL, ", ");
       *cptr = put_next_member(*cptr);
-      fprintf(ASMFIL, "[" /*]*/);
+      ll_puts(ASMFIL, "[" /*]*/);
     } else if (*i8cnt) {
       if (!first_data)
-        fprintf(ASMFIL, ", ");
+        ll_puts(ASMFIL, ", ");
     }
     *i8cnt = *i8cnt + put_skip(*addr, ALIGN(*addr, tconval));
     *addr = ALIGN(*addr, tconval);
@@ -165,18 +166,18 @@ emit_init(int tdtype, ISZ_T tconval, ISZ_T *addr, ISZ_T *repeat_cnt,
     }
     if (*ptrcnt) {
       if (!first_data)
-        fprintf(ASMFIL, ", ");
+        ll_puts(ASMFIL, ", ");
       *cptr = put_next_member(*cptr);
-      fprintf(ASMFIL, "[" /*]*/);
+      ll_puts(ASMFIL, "[" /*]*/);
       *ptrcnt = 0;
     } else if (!(*i8cnt)) {
       if (!first_data)
-        fprintf(ASMFIL, ", ");
+        ll_puts(ASMFIL, ", ");
       *cptr = put_next_member(*cptr);
-      fprintf(ASMFIL, "[" /*]*/);
+      ll_puts(ASMFIL, "[" /*]*/);
     } else if (*i8cnt) {
       if (!first_data)
-        fprintf(ASMFIL, ", ");
+        ll_puts(ASMFIL, ", ");
     }
     put_zeroes((int)tconval);
     *i8cnt = *i8cnt + ((int)tconval);
@@ -195,22 +196,22 @@ emit_init(int tdtype, ISZ_T tconval, ISZ_T *addr, ISZ_T *repeat_cnt,
 
     if (skip_size) { /* if *i8cnt - just add to the end */
       if (!first_data)
-        fprintf(ASMFIL, ", ");
+        ll_puts(ASMFIL, ", ");
       if (*i8cnt) {
         *i8cnt = put_skip(*addr, ALIGN(*addr, al));
         *i8cnt = 0;
-        fprintf(ASMFIL, /*[*/ "], ");
+        ll_puts(ASMFIL, /*[*/ "], ");
       } else if (*ptrcnt || !(*i8cnt)) {
         *cptr = put_next_member(*cptr);
-        fprintf(ASMFIL, "[" /*]*/);
+        ll_puts(ASMFIL, "[" /*]*/);
         *i8cnt = put_skip(*addr, ALIGN(*addr, al));
-        fprintf(ASMFIL, /*[*/ "], ");
+        ll_puts(ASMFIL, /*[*/ "], ");
       }
     } else if (*i8cnt) {
-      fprintf(ASMFIL, /*[*/ "], ");
+      ll_puts(ASMFIL, /*[*/ "], ");
       *i8cnt = 0;
     } else if (!first_data)
-      fprintf(ASMFIL, ", ");
+      ll_puts(ASMFIL, ", ");
 
     *cptr = put_next_member(*cptr);
     *addr = ALIGN(*addr, al);
@@ -242,18 +243,18 @@ emit_init(int tdtype, ISZ_T tconval, ISZ_T *addr, ISZ_T *repeat_cnt,
     }
     if (*ptrcnt) {
       if (!first_data)
-        fprintf(ASMFIL, ", ");
+        ll_puts(ASMFIL, ", ");
       *cptr = put_next_member(*cptr);
-      fprintf(ASMFIL, "[" /*]*/);
+      ll_puts(ASMFIL, "[" /*]*/);
       *ptrcnt = 0;
     } else if (!(*i8cnt)) {
       if (!first_data)
-        fprintf(ASMFIL, ", ");
+        ll_puts(ASMFIL, ", ");
       *cptr = put_next_member(*cptr);
-      fprintf(ASMFIL, "[" /*]*/);
+      ll_puts(ASMFIL, "[" /*]*/);
     } else if (*i8cnt) {
       if (!first_data)
-        fprintf(ASMFIL, ", ");
+        ll_puts(ASMFIL, ", ");
     }
     *i8cnt = *i8cnt + put_skip(*addr, tconval + loc_base);
     *addr = tconval + loc_base;
@@ -279,25 +280,25 @@ emit_init(int tdtype, ISZ_T tconval, ISZ_T *addr, ISZ_T *repeat_cnt,
     }
     if (*ptrcnt) {
       if (!first_data)
-        fprintf(ASMFIL, ", ");
+        ll_puts(ASMFIL, ", ");
       *cptr = put_next_member(*cptr);
-      fprintf(ASMFIL, "[" /*]*/);
+      ll_puts(ASMFIL, "[" /*]*/);
       *ptrcnt = 0;
     } else if (!(*i8cnt)) {
       if (!first_data)
-        fprintf(ASMFIL, ", ");
+        ll_puts(ASMFIL, ", ");
       *cptr = put_next_member(*cptr);
-      fprintf(ASMFIL, "[" /*]*/);
+      ll_puts(ASMFIL, "[" /*]*/);
     } else if (*i8cnt) {
       if (!first_data)
-        fprintf(ASMFIL, ", ");
+        ll_puts(ASMFIL, ", ");
     }
 
     /* Output the data */
     *i8cnt += tconval;
     while (tconval > 0) {
       if (tconval != orig_tconval)
-        fprintf(ASMFIL, ", ");
+        ll_puts(ASMFIL, ", ");
       if (tconval > 32) {
         dinit_read_string(32, str);
         put_string_n(str, 32, 0);
@@ -365,18 +366,18 @@ emit_init(int tdtype, ISZ_T tconval, ISZ_T *addr, ISZ_T *repeat_cnt,
       if (DTY(tdtype) != TY_PTR && DTY(tdtype) != TY_STRUCT) {
         if (*ptrcnt) {
           if (!first_data)
-            fprintf(ASMFIL, ", ");
+            ll_puts(ASMFIL, ", ");
           *cptr = put_next_member(*cptr);
-          fprintf(ASMFIL, " [" /*]*/);
+          ll_puts(ASMFIL, " [" /*]*/);
           *ptrcnt = 0;
         } else if (!(*i8cnt)) {
           if (!first_data)
-            fprintf(ASMFIL, ", ");
+            ll_puts(ASMFIL, ", ");
           *cptr = put_next_member(*cptr);
-          fprintf(ASMFIL, " [" /*]*/);
+          ll_puts(ASMFIL, " [" /*]*/);
         } else if (*i8cnt) {
           if (!first_data)
-            fprintf(ASMFIL, ", ");
+            ll_puts(ASMFIL, ", ");
         }
       }
       switch (DTY(tdtype)) {
@@ -389,7 +390,7 @@ emit_init(int tdtype, ISZ_T tconval, ISZ_T *addr, ISZ_T *repeat_cnt,
                   first_data, *i8cnt, *ptrcnt);
         }
         put_i32(CONVAL2G(tconval));
-        fprintf(ASMFIL, ", ");
+        ll_puts(ASMFIL, ", ");
         if (DBGBIT(5, 32)) {
           fprintf(gbl.dbgfil,
                   "emit_init:put_i32 first_data:%d i8cnt:%ld ptrcnt:%d\n",
@@ -470,9 +471,9 @@ emit_init(int tdtype, ISZ_T tconval, ISZ_T *addr, ISZ_T *repeat_cnt,
 
       case TY_PTR:
         if (*i8cnt) {
-          fprintf(ASMFIL, /*[*/ "], ");
+          ll_puts(ASMFIL, /*[*/ "], ");
         } else if (!first_data)
-          fprintf(ASMFIL, ", ");
+          ll_puts(ASMFIL, ", ");
         *ptrcnt = *ptrcnt + 1;
         *i8cnt = 0;
         *cptr = put_next_member(*cptr);
@@ -525,18 +526,18 @@ emit_init(int tdtype, ISZ_T tconval, ISZ_T *addr, ISZ_T *repeat_cnt,
   do_zeroes:
     if (*ptrcnt) {
       if (!first_data)
-        fprintf(ASMFIL, ", ");
+        ll_puts(ASMFIL, ", ");
       *cptr = put_next_member(*cptr);
-      fprintf(ASMFIL, " [" /*]*/);
+      ll_puts(ASMFIL, " [" /*]*/);
       *ptrcnt = 0;
     } else if (!(*i8cnt)) {
       if (!first_data)
-        fprintf(ASMFIL, ", ");
+        ll_puts(ASMFIL, ", ");
       *cptr = put_next_member(*cptr);
-      fprintf(ASMFIL, " [" /*]*/);
+      ll_puts(ASMFIL, " [" /*]*/);
     } else if (*i8cnt) {
       if (!first_data)
-        fprintf(ASMFIL, ", ");
+        ll_puts(ASMFIL, ", ");
     }
     if (DBGBIT(5, 32)) {
       fprintf(gbl.dbgfil,
@@ -573,9 +574,11 @@ put_string_n(char *p, ISZ_T len, int size)
   n = 0;
   while (len--) {
     ch = *p;
-    fprintf(ASMFIL, "%s %u", ptrch, ch & 0xff);
+    ll_puts(ASMFIL, ptrch);
+    LL_PUTC(' ', ASMFIL);
+    ll_putu(ASMFIL, ch & 0xff);
     if (len)
-      fprintf(ASMFIL, ",");
+      LL_PUTC(',', ASMFIL);
     ++p;
     ++n;
   }
@@ -608,7 +611,7 @@ put_ncharstring_n(char *p, ISZ_T len, int size_of_char)
     fprintf(ASMFIL, "%s %u, ", ptrch, chtmp.a[0] & 0xff);
     fprintf(ASMFIL, "%s %u", ptrch, chtmp.a[1] & 0xff);
     if (len)
-      fprintf(ASMFIL, ",");
+      LL_PUTC(',', ASMFIL);
   }
 
 } /* put_string_n */
@@ -619,20 +622,20 @@ put_zeroes(ISZ_T len)
   ISZ_T i;
   i = len;
   while (i > 32) {
-    fprintf(ASMFIL, "i8 0,i8 0,i8 0,i8 0,i8 0,i8 0,i8 0,i8 0,i8 0,i8 0,i8 0,i8 "
+    ll_puts(ASMFIL, "i8 0,i8 0,i8 0,i8 0,i8 0,i8 0,i8 0,i8 0,i8 0,i8 0,i8 0,i8 "
                     "0,i8 0,i8 0,i8 0,i8 0,i8 0,i8 0,i8 0,i8 0,i8 0,i8 0,i8 "
                     "0,i8 0,i8 0,i8 0,i8 0,i8 0,i8 0,i8 0,i8 0,i8 0");
     i -= 32;
     if (i)
-      fprintf(ASMFIL, ",");
+      LL_PUTC(',', ASMFIL);
   }
   if (i) {
     while (1) {
-      fprintf(ASMFIL, "i8 0");
+      ll_puts(ASMFIL, "i8 0");
       i--;
       if (i == 0)
         break;
-      fprintf(ASMFIL, ",");
+      LL_PUTC(',', ASMFIL);
     }
   }
 }
@@ -644,11 +647,13 @@ put_zeroes_bytype(ISZ_T len, char *ttype, char *initval)
   i = len;
   if (i) {
     while (1) {
-      fprintf(ASMFIL, "%s %s", ttype, initval);
+      ll_puts(ASMFIL, ttype);
+      LL_PUTC(' ', ASMFIL);
+      ll_puts(ASMFIL, initval);
       i--;
       if (i == 0)
         break;
-      fprintf(ASMFIL, ",");
+      LL_PUTC(',', ASMFIL);
     }
   }
 }
@@ -658,7 +663,8 @@ put_i8(int val)
 {
   int i;
   i8bit.i8 = (short)val;
-  fprintf(ASMFIL, "i8 %u", i8bit.byte[0] & 0xff);
+  ll_puts(ASMFIL, "i8 ");
+  ll_putu(ASMFIL, i8bit.byte[0] & 0xff);
 
 }
 
@@ -669,9 +675,10 @@ put_i16(int val)
   int i;
   i16bit.i16 = val;
   for (i = 0; i < 2; i++) {
-    fprintf(ASMFIL, "i8 %u", i16bit.byte[i] & 0xff);
+    ll_puts(ASMFIL, "i8 ");
+    ll_putu(ASMFIL, i16bit.byte[i] & 0xff);
     if (i < 1)
-      fprintf(ASMFIL, ",");
+      LL_PUTC(',', ASMFIL);
   }
 
 }
@@ -683,9 +690,10 @@ put_i32(int val)
   int i;
   i32bit.i32 = val;
   for (i = 0; i < 4; i++) {
-    fprintf(ASMFIL, "i8 %u", i32bit.byte[i] & 0xff);
+    ll_puts(ASMFIL, "i8 ");
+    ll_putu(ASMFIL, i32bit.byte[i] & 0xff);
     if (i < 3)
-      fprintf(ASMFIL, ", ");
+      ll_puts(ASMFIL, ", ");
   }
 
 }
@@ -693,25 +701,31 @@ put_i32(int val)
 void
 put_short(int val)
 {
-  fprintf(ASMFIL, "i16 %u", val);
+  ll_puts(ASMFIL, "i16 ");
+  ll_putu(ASMFIL, (UINT)val);
 }
 
 static void
 put_int(INT val)
 {
-  fprintf(ASMFIL, "i%d %u", DIR_LONG_SIZE, val);
+  LL_PUTC('i', ASMFIL);
+  ll_putu(ASMFIL, DIR_LONG_SIZE);
+  LL_PUTC(' ', ASMFIL);
+  ll_putu(ASMFIL, (UINT)val);
 }
 
 void
 put_int4(int val)
 {
-  fprintf(ASMFIL, "i32 %u", val);
+  ll_puts(ASMFIL, "i32 ");
+  ll_putu(ASMFIL, (UINT)val);
 }
 
 static void
 put_int8(INT val)
 {
-  fprintf(ASMFIL, "i64 %lu", (unsigned long)val);
+  ll_puts(ASMFIL, "i64 ");
+  ll_putu(ASMFIL, (unsigned long)val);
 }
 
 /* write:  i8 0x?, i8 0x?, i8 0x?, i8 0x? */
@@ -721,9 +735,10 @@ put_r4(INT val)
   int i;
   i32bit.i32 = val;
   for (i = 0; i < 4; i++) {
-    fprintf(ASMFIL, "i8 %u", i32bit.byte[i] & 0xff);
+    ll_puts(ASMFIL, "i8 ");
+    ll_putu(ASMFIL, i32bit.byte[i] & 0xff);
     if (i < 3)
-      fprintf(ASMFIL, ",");
+      LL_PUTC(',', ASMFIL);
   }
 }
 
@@ -736,21 +751,15 @@ put_float(INT val)
     INT tmp[2];
   } dtmp, dtmp2;
   xx.ww = val;
-  fprintf(ASMFIL, "float ");
+  ll_puts(ASMFIL, "float 0x");
   xdble(xx.ww, dtmp2.tmp);
   xdtomd(dtmp2.tmp, &dtmp.d);
 
   if (dtmp.tmp[0] == -1) /* pick up the quiet nan */
-    fprintf(ASMFIL, "0x7FF80000");
-  else if (!dtmp.tmp[1])
-    fprintf(ASMFIL, "0x00000000");
+    ll_puts(ASMFIL, "7FF8000000000000");
   else
-    fprintf(ASMFIL, "0x%X", dtmp.tmp[1]);
-
-  if (!dtmp.tmp[0] || dtmp.tmp[0] == -1)
-    fprintf(ASMFIL, "00000000");
-  else
-    fprintf(ASMFIL, "%X", dtmp.tmp[0]);
+    ll_putx(ASMFIL, ((BIGUINT64)(UINT)dtmp.tmp[1] << 32) | (UINT)dtmp.tmp[0],
+            16);
 }
 
 static void
@@ -759,12 +768,12 @@ put_double(int sptr)
   INT num[2];
   num[0] = CONVAL1G(sptr);
   num[1] = CONVAL2G(sptr);
-  fprintf(ASMFIL, "double ");
+  ll_puts(ASMFIL, "double 0x");
 
   if ((num[0] & 0x7ff00000) == 0x7ff00000) /* exponent == 2047 */
-    fprintf(ASMFIL, "0x%08x00000000", num[0]);
+    ll_putx(ASMFIL, (BIGUINT64)(UINT)num[0] << 32, 16);
   else {
-    fprintf(ASMFIL, "0x%.8X%.8X", num[0], num[1]);
+    ll_putx(ASMFIL, ((BIGUINT64)(UINT)num[0] << 32) | (UINT)num[1], 16);
   }
 }
 
@@ -777,11 +786,11 @@ put_r8(int sptr, int putval)
   num[1] = CONVAL2G(sptr);
   if (flg.endian) {
     put_r4(num[0]);
-    fprintf(ASMFIL, ",");
+    LL_PUTC(',', ASMFIL);
     put_r4(num[1]);
   } else {
     put_r4(num[1]);
-    fprintf(ASMFIL, ",");
+    LL_PUTC(',', ASMFIL);
     put_r4(num[0]);
   }
 }
@@ -790,35 +799,35 @@ static void
 put_cmplx_n(int sptr, int putval)
 {
   put_r4(CONVAL1G(sptr));
-  fprintf(ASMFIL, ",");
+  LL_PUTC(',', ASMFIL);
   put_r4(CONVAL2G(sptr));
 }
 
 static void
 put_float_cmplx(int sptr, int putval)
 {
-  fprintf(ASMFIL, " {float, float} {");
+  ll_puts(ASMFIL, " {float, float} {");
   put_float(CONVAL1G(sptr));
-  fprintf(ASMFIL, ",");
+  LL_PUTC(',', ASMFIL);
   put_float(CONVAL2G(sptr));
-  fprintf(ASMFIL, "}");
+  LL_PUTC('}', ASMFIL);
 }
 
 static void
 put_double_cmplx(int sptr, int putval)
 {
-  fprintf(ASMFIL, " {double, double} {");
+  ll_puts(ASMFIL, " {double, double} {");
   put_double(CONVAL1G(sptr));
-  fprintf(ASMFIL, ",");
+  LL_PUTC(',', ASMFIL);
   put_double(CONVAL2G(sptr));
-  fprintf(ASMFIL, "}");
+  LL_PUTC('}', ASMFIL);
 }
 
 static void
 put_dcmplx_n(int sptr, int putval)
 {
   put_r8((int)CONVAL1G(sptr), putval);
-  fprintf(ASMFIL, ",");
+  LL_PUTC(',', ASMFIL);
   put_r8((int)CONVAL2G(sptr), putval);
 }
 
@@ -922,9 +931,9 @@ put_addr(int sptr, ISZ_T off, int dtype)
         fprintf(ASMFIL, "%s", ll_offset->data);
       }
     } else
-      fprintf(ASMFIL, "null");
+      ll_puts(ASMFIL, "null");
   } else if (off == 0)
-    fprintf(ASMFIL, "null");
+    ll_puts(ASMFIL, "null");
   else
     fprintf(ASMFIL, "%ld", (long)off);
 }
@@ -1013,4 +1022,8 @@ add_ctor(char *constructor)
   llvm_ctor_add(constructor);
   ll_proto_add(fn->name, NULL);
   ll_proto_set_intrinsic(fn->name, buff);
+  snprintf(buff, sizeof(buff), "@%s", constructor);
+  ll_proto_set_intrinsic_type(
+      fn->name, buff, ll_create_function_type(cpu_llvm_module, &ret, 0, FALSE),
+      FALSE);
 }
@@ -36,10 +36,11 @@ static void
 replace_by_call_to_llvm_instrinsic(INSTR_LIST *instr, char *fname,
                                    OPERAND *params)
 {
-  OPERAND *call_op;
+  OPERAND *call_op, *p;
   char *intrinsic_name;
-  static char buf[MAXIDLEN];
+  LL_Type **args;
   LL_Type *return_ll_type = NULL;
+  int nargs;
 
   DBGXTRACEIN1(DBGBIT(12, 0x20), 1, "ilix %d", instr->ilix);
 
@@ -56,19 +57,20 @@ replace_by_call_to_llvm_instrinsic(INSTR_LIST *instr, char *fname,
   instr->operands = call_op;
   call_op->next = params;
   /* add global define of llvm.xxx to external function list, if needed */
-  sprintf(buf, "declare %s %s(", return_ll_type->str, intrinsic_name);
-  if (params) {
-    sprintf(buf, "%s%s", buf, params->ll_type->str);
-    params = params->next;
-  }
-  while (params) {
-    sprintf(buf, "%s, %s", buf, params->ll_type->str);
-    params = params->next;
-  }
-  strcat(buf, ")");
-  update_external_function_declarations(buf, EXF_INTRINSIC);
+  nargs = 0;
+  for (p = params; p; p = p->next)
+    ++nargs;
+  args = (LL_Type **)malloc((nargs + 1) * sizeof(LL_Type *));
+  args[0] = return_ll_type;
+  for (p = params, nargs = 0; p; p = p->next)
+    args[++nargs] = p->ll_type;
+  update_external_function_declarations(
+      intrinsic_name,
+      ll_create_function_type(cpu_llvm_module, args, nargs, FALSE),
+      EXF_INTRINSIC);
+  free(args);
 
-  DBGXTRACEOUT1(DBGBIT(12, 0x20), 1, " %s", buf)
+  DBGXTRACEOUT1(DBGBIT(12, 0x20), 1, " %s", intrinsic_name)
 }
 
 static void
@@ -34,6 +34,7 @@
 #include "cgllvm.h"
 
 #include "x86.h"
+#include <stdarg.h>
 
 #if DEBUG
 static const char *ot_names[OT_LAST] = {
@@ -151,6 +152,14 @@ llutil_alloc(INT size)
   return p;
 }
 
+static char *
+llutil_alloc_routine(INT size)
+{
+  char *p = (char *)getitem(LLVM_ROUTINE_AREA, size);
+  memset(p, 0, size);
+  return p;
+}
+
 const char *
 llutil_strdup(const char *str)
 {
@@ -164,7 +173,7 @@ llutil_strdup(const char *str)
 TMPS *
 make_tmps(void)
 {
-  return (TMPS *)llutil_alloc(sizeof(TMPS));
+  return (TMPS *)llutil_alloc_routine(sizeof(TMPS));
 }
 
 /**
@@ -1347,6 +1356,7 @@ make_conststring_op(int sptr)
   op = make_operand();
   op->ot_type = OT_CONSTSTRING;
   op->ll_type = make_lltype_from_dtype(DTYPEG(sptr));
+  op->val.sptr = sptr;
 
   if (sptr && DTY(DTYPEG(sptr)) == TY_CHAR) {
     const int length = ll_type_bytes(op->ll_type);
@@ -1571,7 +1581,7 @@ make_label_op(int sptr)
 OPERAND *
 make_operand(void)
 {
-  return (OPERAND *)llutil_alloc(sizeof(OPERAND));
+  return (OPERAND *)llutil_alloc_routine(sizeof(OPERAND));
 }
 
 static void
@@ -1587,6 +1597,10 @@ init_output_file(void)
     return;
   FTN_HAS_INIT() = 1;
   set_llasm_output_file(gbl.asmfil);
+  if (ll_bitcode_output()) {
+    ll_bc_init(cpu_llvm_module);
+    return;
+  }
   ll_write_module_header(gbl.asmfil, cpu_llvm_module);
 }
 
@@ -1597,7 +1611,7 @@ void
 print_llsize(LL_Type *llt)
 {
   assert(llt, "print_llsize(): missing llt", 0, 4);
-  fprintf(LLVMFIL, "%" BIGIPFSZ "d", ll_type_bytes(llt) * 8);
+  ll_puti(LLVMFIL, ll_type_bytes(llt) * 8);
 }
 
 void
@@ -1617,7 +1631,7 @@ print_space(int num)
   int i;
 
   for (i = 0; i < num; i++)
-    fprintf(LLVMFIL, " ");
+    LL_PUTC(' ', LLVMFIL);
 }
 
 void
@@ -1636,9 +1650,8 @@ void
 print_line(char *ln)
 {
   if (ln != NULL)
-    fprintf(LLVMFIL, "%s\n", ln);
-  else
-    fprintf(LLVMFIL, "\n");
+    ll_puts(LLVMFIL, ln);
+  LL_PUTC('\n', LLVMFIL);
 }
 
 /**
@@ -1666,7 +1679,7 @@ void
 print_token(const char *tk)
 {
   assert(tk, "print_token(): missing token", 0, 4);
-  fprintf(LLVMFIL, "%s", tk);
+  ll_puts(LLVMFIL, tk);
 }
 
 /**
@@ -1685,7 +1698,7 @@ print_token_tobuf(char *tk, char *buf)
 void
 print_nl(void)
 {
-  fprintf(LLVMFIL, "\n");
+  LL_PUTC('\n', LLVMFIL);
 }
 
 void
@@ -1694,6 +1707,61 @@ print_nl_tobuf(char *buf)
   sprintf(buf, "\n");
 }
 
+/**
+   \brief Intern the name \p s
+
+   Intrinsic and runtime routine names are requested for every call that
+   is generated, and symbol names are set again in every routine that
+   refers to the symbol.  Interning them costs one allocation per distinct
+   name, and equal names share one pointer, so they can be used directly as
+   hash keys.  The copies live in LLVM_LONGTERM_AREA and must not be
+   modified.
+ */
+char *
+ll_intern_name(const char *s)
+{
+  static hashset_t names;
+  hash_key_t existing;
+  char *copy;
+
+  if (!names)
+    names = hashset_alloc(hash_functions_strings);
+  existing = hashset_lookup(names, s);
+  if (existing)
+    return (char *)existing;
+  copy = (char *)getitem(LLVM_LONGTERM_AREA, strlen(s) + 1);
+  strcpy(copy, s);
+  hashset_insert(names, copy);
+  return copy;
+}
+
+/**
+   \brief Intern the name produced by the printf-like \p format
+ */
+char *
+ll_intern_namef(const char *format, ...)
+{
+  char buf[256];
+  char *name = buf;
+  char *interned;
+  va_list ap;
+  int len;
+
+  va_start(ap, format);
+  len = vsnprintf(buf, sizeof(buf), format, ap);
+  va_end(ap);
+  if (len >= (int)sizeof(buf)) {
+    name = (char *)malloc(len + 1);
+    va_start(ap, format);
+    vsnprintf(name, len + 1, format, ap);
+    va_end(ap);
+  }
+  interned = ll_intern_name(name);
+  if (name != buf)
+    free(name);
+  return interned;
+}
+
 /**
    \brief Compare two types to make sure something isn't already sideways
 
@@ -1719,11 +1787,11 @@ write_vconstant_value(int sptr, LL_Type *type)
 
   edtype = CONVAL1G(sptr);
 
-  fprintf(LLVMFIL, "<");
+  LL_PUTC('<', LLVMFIL);
 
   for (i = 0; i < vsize; i++) {
     if (i)
-      fprintf(LLVMFIL, ", ");
+      ll_puts(LLVMFIL, ", ");
     write_type(vtype);
     print_space(1);
     switch (vtype->data_type) {
@@ -1744,7 +1812,7 @@ write_vconstant_value(int sptr, LL_Type *type)
       write_constant_value(0, vtype, VCON_CONVAL(edtype + i), 0, FALSE);
     }
   }
-  fprintf(LLVMFIL, ">");
+  LL_PUTC('>', LLVMFIL);
 }
 
 /**
@@ -1761,10 +1829,7 @@ write_constant_value(int sptr, LL_Type *type, INT conval0, INT conval1,
     double d;
     INT tmp[2];
   } dtmp, dtmp2;
-  char constant1[9], constant2[9];
-
-  static char d[256];
-  static char b[100];
+  BIGUINT64 bits;
 
   assert((sptr || type), "write_constant_value(): missing arguments", sptr, 4);
   if (sptr && !type)
@@ -1780,39 +1845,40 @@ write_constant_value(int sptr, LL_Type *type, INT conval0, INT conval1,
     if (sptr && DTY(DTYPEG(sptr)) == TY_CHAR) {
       int len = type->sub_elements;
       char *p;
-      fprintf(LLVMFIL, "c\"");
+      ll_puts(LLVMFIL, "c\"");
 
       p = stb.n_base + CONVAL1G(sptr);
       ;
       while (len--)
-        fprintf(LLVMFIL, "%c", *p++);
-      fprintf(LLVMFIL, "\"");
+        LL_PUTC(*p++, LLVMFIL);
+      LL_PUTC('"', LLVMFIL);
       return;
     }
 
     if (conval0 == 0 && conval1 == 0) {
-      fprintf(LLVMFIL, "zeroinitializer");
+      ll_puts(LLVMFIL, "zeroinitializer");
     } else {
       unsigned elems = type->sub_elements;
 
       if (sptr && DTY(DTYPEG(sptr)) == TY_NCHAR) {
         ctype = llvm_fc_type(DTYPEG(sptr));
-        fprintf(LLVMFIL, "[");
+        LL_PUTC('[', LLVMFIL);
       } else
-        fprintf(LLVMFIL, "{");
+        LL_PUTC('{', LLVMFIL);
       while (elems > 0) {
         if (sptr && DTY(DTYPEG(sptr)) == TY_NCHAR) {
-          fprintf(LLVMFIL, "%s ", ctype);
+          ll_puts(LLVMFIL, ctype);
+          LL_PUTC(' ', LLVMFIL);
         }
         write_constant_value(0, type->sub_types[0], conval0, conval1, uns);
         elems--;
         if (elems > 0)
-          fprintf(LLVMFIL, ", ");
+          ll_puts(LLVMFIL, ", ");
       }
       if (sptr && DTY(DTYPEG(sptr)) == TY_NCHAR) {
-        fprintf(LLVMFIL, "]");
+        LL_PUTC(']', LLVMFIL);
       } else
-        fprintf(LLVMFIL, "}");
+        LL_PUTC('}', LLVMFIL);
     }
     return;
 
@@ -1822,23 +1888,31 @@ write_constant_value(int sptr, LL_Type *type, INT conval0, INT conval1,
       if (DTY(DTYPEG(sptr)) == TY_CMPLX) {
         LL_Type *float_type = make_lltype_from_dtype(DT_FLOAT);
         ctype = llvm_fc_type(DT_FLOAT);
-        fprintf(LLVMFIL, "<{ %s ", ctype);
+        ll_puts(LLVMFIL, "<{ ");
+        ll_puts(LLVMFIL, ctype);
+        LL_PUTC(' ', LLVMFIL);
         write_constant_value(0, float_type, CONVAL1G(sptr), 0, uns);
-        fprintf(LLVMFIL, ", %s ", ctype);
+        ll_puts(LLVMFIL, ", ");
+        ll_puts(LLVMFIL, ctype);
+        LL_PUTC(' ', LLVMFIL);
         write_constant_value(0, float_type, CONVAL2G(sptr), 0, uns);
-        fprintf(LLVMFIL, "}>");
+        ll_puts(LLVMFIL, "}>");
       } else {
         ctype = llvm_fc_type(DTYPEG(CONVAL1G(sptr)));
-        fprintf(LLVMFIL, "<{ %s ", ctype);
+        ll_puts(LLVMFIL, "<{ ");
+        ll_puts(LLVMFIL, ctype);
+        LL_PUTC(' ', LLVMFIL);
         write_constant_value(CONVAL1G(sptr), 0, 0, 0, uns);
-        fprintf(LLVMFIL, ", %s ", ctype);
+        ll_puts(LLVMFIL, ", ");
+        ll_puts(LLVMFIL, ctype);
+        LL_PUTC(' ', LLVMFIL);
         write_constant_value(CONVAL2G(sptr), 0, 0, 0, uns);
-        fprintf(LLVMFIL, "}>");
+        ll_puts(LLVMFIL, "}>");
       }
     } else {
       assert(conval0 == 0 && conval1 == 0,
              "write_constant_value(): non zero struct", 0, 4);
-      fprintf(LLVMFIL, "zeroinitializer");
+      ll_puts(LLVMFIL, "zeroinitializer");
     }
     return;
 
@@ -1861,10 +1935,16 @@ write_constant_value(int sptr, LL_Type *type, INT conval0, INT conval1,
       num[0] = conval1;
     }
     if (ll_type_bytes(type) <= 4) {
-      fprintf(LLVMFIL, uns ? "%lu" : "%ld", (long)num[1]);
+      if (uns)
+        ll_putu(LLVMFIL, (unsigned long)(long)num[1]);
+      else
+        ll_puti(LLVMFIL, num[1]);
     } else {
-      ui64toax(num, b, 22, uns, 10);
-      fprintf(LLVMFIL, "%s", b);
+      bits = ((BIGUINT64)(UINT)num[0] << 32) | (UINT)num[1];
+      if (uns)
+        ll_putu(LLVMFIL, bits);
+      else
+        ll_puti(LLVMFIL, (BIGINT64)bits);
     }
     return;
 
@@ -1877,15 +1957,15 @@ write_constant_value(int sptr, LL_Type *type, INT conval0, INT conval1,
       num[1] = conval1;
     }
 
-    cprintf(d, "%.17le", num);
-    /* Check for  `+/-Infinity` and 'NaN' based on the IEEE bit patterns */
-    if ((num[0] & 0x7ff00000) == 0x7ff00000) /* exponent == 2047 */
-      sprintf(d, "0x%08x00000000", num[0]);
-    /* also check for -0 */
-    else if (num[0] == 0x80000000 && num[1] == 0x00000000)
-      sprintf(d, "-0.00000000e+00");
-    /* remember to make room for /0 */
-    fprintf(LLVMFIL, "%s", d);
+    /* Write the IEEE bit pattern in hex: exact, and no decimal conversion.
+     * For `+/-Infinity` and 'NaN' (exponent == 2047) only the high word is
+     * kept, as before.
+     */
+    bits = (BIGUINT64)(UINT)num[0] << 32;
+    if ((num[0] & 0x7ff00000) != 0x7ff00000)
+      bits |= (UINT)num[1];
+    ll_puts(LLVMFIL, "0x");
+    ll_putx(LLVMFIL, bits, 16);
     return;
 
   case LL_FLOAT:
@@ -1900,24 +1980,17 @@ write_constant_value(int sptr, LL_Type *type, INT conval0, INT conval1,
       xx.ww = conval0;
     xdble(xx.ww, dtmp2.tmp);
     xdtomd(dtmp2.tmp, &dtmp.d);
-    snprintf(d, 200, "%.8e", dtmp.d);
-    if (dtmp.tmp[0] == -1) /* pick up the quiet nan */
-      sprintf(constant1, "7FF80000");
-    else if (!dtmp.tmp[1])
-      sprintf(constant1, "00000000");
-    else
-      sprintf(constant1, "%X", dtmp.tmp[1]);
-    if (!dtmp.tmp[0] || dtmp.tmp[0] == -1)
-      sprintf(constant2, "00000000");
-    else
-      sprintf(constant2, "%X", dtmp.tmp[0]);
-
     /* check for negative zero */
-    if (dtmp.tmp[1] == 0x80000000 && !dtmp.tmp[0])
-      fprintf(LLVMFIL, "-0.000000e+00");
+    if (dtmp.tmp[1] == 0x80000000 && !dtmp.tmp[0]) {
+      ll_puts(LLVMFIL, "-0.000000e+00");
+      break;
+    }
+    if (dtmp.tmp[0] == -1) /* pick up the quiet nan */
+      bits = (BIGUINT64)0x7FF80000 << 32;
     else
-      fprintf(LLVMFIL, "0x%s%s", constant1, constant2);
-
+      bits = ((BIGUINT64)(UINT)dtmp.tmp[1] << 32) | (UINT)dtmp.tmp[0];
+    ll_puts(LLVMFIL, "0x");
+    ll_putx(LLVMFIL, bits, 16);
     break;
 
   case LL_X86_FP80:
@@ -1940,6 +2013,172 @@ write_constant_value(int sptr, LL_Type *type, INT conval0, INT conval1,
   }
 } /* write_constant_value */
 
+static BCVal
+encode_vconstant_value(int sptr, LL_Type *type)
+{
+  LL_Type *vtype = type->sub_types[0];
+  int vsize = type->sub_elements;
+  int i, edtype = CONVAL1G(sptr);
+  BCVal *elts = (BCVal *)malloc(vsize * sizeof(BCVal));
+  BCVal v;
+
+  for (i = 0; i < vsize; i++) {
+    switch (vtype->data_type) {
+    case LL_DOUBLE:
+    case LL_I40:
+    case LL_I48:
+    case LL_I56:
+    case LL_I64:
+    case LL_I128:
+    case LL_I256:
+      elts[i] = encode_constant_value(VCON_CONVAL(edtype + i), 0, 0, 0, FALSE);
+      break;
+    default:
+      elts[i] =
+          encode_constant_value(0, vtype, VCON_CONVAL(edtype + i), 0, FALSE);
+    }
+  }
+  v = ll_bc_aggregate(ll_bc_type(type), elts, vsize);
+  free(elts);
+  return v;
+}
+
+/**
+   \brief Encode a constant value for the bitcode output, the counterpart of
+   write_constant_value()
+ */
+BCVal
+encode_constant_value(int sptr, LL_Type *type, INT conval0, INT conval1,
+                      LOGICAL uns)
+{
+  INT num[2] = {0, 0};
+  union xx_u xx;
+  union {
+    double d;
+    INT tmp[2];
+  } dtmp, dtmp2;
+  BIGUINT64 bits;
+  BCVal elts[2], v, *pv;
+  unsigned i;
+  int ty;
+
+  assert((sptr || type), "encode_constant_value(): missing arguments", sptr, 4);
+  if (sptr && !type)
+    type = make_lltype_from_dtype(DTYPEG(sptr));
+  ty = ll_bc_type(type);
+
+  switch (type->data_type) {
+  case LL_VECTOR:
+    return encode_vconstant_value(sptr, type);
+
+  case LL_ARRAY:
+    if (sptr && DTY(DTYPEG(sptr)) == TY_CHAR)
+      return ll_bc_string(ty, stb.n_base + CONVAL1G(sptr), type->sub_elements);
+    if (conval0 == 0 && conval1 == 0)
+      return ll_bc_null(ty);
+    pv = (BCVal *)malloc(type->sub_elements * sizeof(BCVal));
+    for (i = 0; i < type->sub_elements; i++)
+      pv[i] = encode_constant_value(0, type->sub_types[0], conval0, conval1,
+                                    uns);
+    v = ll_bc_aggregate(ty, pv, type->sub_elements);
+    free(pv);
+    return v;
+
+  case LL_STRUCT:
+    /* Complex data types are represented as LLVM structs. */
+    if (sptr && DT_ISCMPLX(DTYPEG(sptr))) {
+      if (DTY(DTYPEG(sptr)) == TY_CMPLX) {
+        LL_Type *float_type = make_lltype_from_dtype(DT_FLOAT);
+        elts[0] = encode_constant_value(0, float_type, CONVAL1G(sptr), 0, uns);
+        elts[1] = encode_constant_value(0, float_type, CONVAL2G(sptr), 0, uns);
+      } else {
+        elts[0] = encode_constant_value(CONVAL1G(sptr), 0, 0, 0, uns);
+        elts[1] = encode_constant_value(CONVAL2G(sptr), 0, 0, 0, uns);
+      }
+      return ll_bc_aggregate(ty, elts, 2);
+    }
+    assert(conval0 == 0 && conval1 == 0,
+           "encode_constant_value(): non zero struct", 0, 4);
+    return ll_bc_null(ty);
+
+  case LL_I1:
+  case LL_I8:
+  case LL_I16:
+  case LL_I24:
+  case LL_I32:
+  case LL_I40:
+  case LL_I48:
+  case LL_I56:
+  case LL_I64:
+  case LL_I128:
+  case LL_I256:
+    if (sptr) {
+      num[1] = CONVAL2G(sptr);
+      num[0] = CONVAL1G(sptr);
+    } else {
+      num[1] = conval0;
+      num[0] = conval1;
+    }
+    if (ll_type_bytes(type) <= 4)
+      return ll_bc_int(ty, num[1]);
+    bits = ((BIGUINT64)(UINT)num[0] << 32) | (UINT)num[1];
+    if (uns)
+      return ll_bc_wide_int(ty, bits, 0);
+    return ll_bc_int(ty, (BIGINT64)bits);
+
+  case LL_DOUBLE:
+    if (sptr) {
+      num[0] = CONVAL1G(sptr);
+      num[1] = CONVAL2G(sptr);
+    } else {
+      num[0] = conval0;
+      num[1] = conval1;
+    }
+    bits = (BIGUINT64)(UINT)num[0] << 32;
+    if ((num[0] & 0x7ff00000) != 0x7ff00000)
+      bits |= (UINT)num[1];
+    return ll_bc_fp(ty, bits, 0);
+
+  case LL_FLOAT:
+    if (sptr)
+      xx.ww = CONVAL2G(sptr);
+    else
+      xx.ww = conval0;
+    xdble(xx.ww, dtmp2.tmp);
+    xdtomd(dtmp2.tmp, &dtmp.d);
+    if (dtmp.tmp[1] == 0x80000000 && !dtmp.tmp[0])
+      return ll_bc_double(ty, -0.0);
+    if (dtmp.tmp[0] == -1) /* pick up the quiet nan */
+      bits = (BIGUINT64)0x7FF80000 << 32;
+    else
+      bits = ((BIGUINT64)(UINT)dtmp.tmp[1] << 32) | (UINT)dtmp.tmp[0];
+    memcpy(&dtmp.d, &bits, sizeof(dtmp.d));
+    return ll_bc_double(ty, dtmp.d);
+
+  case LL_X86_FP80:
+    assert(sptr, "encode_constant_value(): x87 constant without sptr", 0, 4);
+    bits = ((BIGUINT64)(CONVAL1G(sptr) & 0xffff) << 48) |
+           ((BIGUINT64)(UINT)CONVAL2G(sptr) << 16) |
+           (((UINT)CONVAL3G(sptr) >> 16) & 0xffff);
+    return ll_bc_fp(ty, bits, ((UINT)CONVAL1G(sptr) >> 16) & 0xffff);
+
+  case LL_PPC_FP128:
+    assert(sptr, "encode_constant_value(): double-double constant without sptr",
+           0, 4);
+    return ll_bc_fp(
+        ty,
+        ((BIGUINT64)(UINT)CONVAL1G(CONVAL1G(sptr)) << 32) |
+            (UINT)CONVAL2G(CONVAL1G(sptr)),
+        ((BIGUINT64)(UINT)CONVAL1G(CONVAL2G(sptr)) << 32) |
+            (UINT)CONVAL2G(CONVAL2G(sptr)));
+
+  default:
+    assert(0, "encode_constant_value(): unexpected constant ll_type",
+           type->data_type, 4);
+  }
+  return ll_bc_undef(ty);
+} /* encode_constant_value */
+
 /**
    \brief Write LL_Type to llvm file
  */
@@ -2167,6 +2406,112 @@ write_operands(OPERAND *operand, int flags)
   DBGTRACEOUT("")
 }
 
+/**
+   \brief Encode the value of an operand for the bitcode output, the
+   counterpart of write_operand()
+   \param flags  FLG_AS_UNSIGNED and FLG_FIXUP_RETURN_TYPE as for
+   write_operand()
+ */
+BCVal
+encode_operand(OPERAND *p, int flags)
+{
+  const bool uns = (flags & FLG_AS_UNSIGNED) != 0;
+  int sptr = p->val.sptr;
+  OPERAND *new_op;
+  LL_Type *pllt;
+  char label[256];
+  BCVal v;
+
+  switch (p->ot_type) {
+  case OT_CONSTVAL:
+    if (p->flags & OPF_NULL_TYPE)
+      return ll_bc_null(ll_bc_type(p->ll_type));
+    assert(p->ll_type, "encode_operand(): no type when expected", 0, 4);
+    return encode_constant_value(0, p->ll_type, p->val.conval[0],
+                                 p->val.conval[1], uns);
+  case OT_UNDEF:
+    return ll_bc_undef(ll_bc_type(p->ll_type));
+  case OT_CONSTSTRING:
+    if (p->flags & OPF_NULL_TYPE)
+      return ll_bc_null(ll_bc_type(p->ll_type));
+    assert(sptr, "encode_operand(): no sptr when expected", 0, 4);
+    return ll_bc_string(ll_bc_type(p->ll_type), stb.n_base + CONVAL1G(sptr),
+                        ll_type_bytes(p->ll_type));
+  case OT_CONSTSPTR:
+    assert(sptr, "encode_operand(): no sptr when expected", 0, 4);
+    if (p->flags & OPF_NULL_TYPE)
+      return ll_bc_null(ll_bc_type(p->ll_type));
+    return encode_constant_value(sptr, make_lltype_from_dtype(DTYPEG(sptr)), 0,
+                                 0, uns);
+  case OT_TARGET:
+    assert(sptr, "encode_operand(): no sptr when expected", 0, 4);
+    snprintf(label, sizeof(label), "L%s", p->string);
+    return ll_bc_label(label);
+  case OT_VAR:
+    assert(sptr, "encode_operand(): no sptr when expected", 0, 4);
+    pllt = p->ll_type;
+    if (pllt->data_type == LL_FUNCTION)
+      pllt = make_ptr_lltype(pllt);
+#if defined(PGFTN) && defined(TARGET_LLVM_X8664)
+    if ((flags & FLG_FIXUP_RETURN_TYPE) && (pllt->data_type == LL_PTR))
+      pllt = maybe_fixup_x86_abi_return(pllt);
+#endif
+    if (*p->string == '@')
+      return ll_bc_global(p->string, ll_bc_type(pllt));
+    return ll_bc_local(p->string, ll_bc_type(pllt));
+  case OT_TMP:
+    assert(p->ll_type, "encode_operand(): missing type information", 0, 4);
+    assert(p->tmps, "encode_operand(): missing temporary value", 0, 4);
+    return ll_bc_local_num(tmp_number(p->tmps), ll_bc_type(p->ll_type));
+  case OT_MDNODE:
+    if (p->tmps) {
+      if (p->flags & OPF_WRAPPED_MD) {
+        if (p->tmps->id)
+          v = ll_bc_local_num(tmp_number(p->tmps), ll_bc_type(p->ll_type));
+        else
+          v = ll_bc_undef(ll_bc_type(p->ll_type));
+        return ll_bc_md_value(v);
+      }
+      if (p->tmps->id <= 0)
+        interr("encode_operand(): metadata operand is not a node", 0,
+               ERR_Fatal);
+      return ll_bc_md(LL_MDREF_ctor(MDRef_Node, p->tmps->id - 1));
+    }
+    if (p->val.sptr) {
+      if (metadata_args_need_struct())
+        interr("bitcode output: metadata argument structs are not supported",
+               p->val.sptr, ERR_Fatal);
+      new_op = make_var_op(p->val.sptr);
+      if (p->ll_type)
+        new_op->ll_type = ll_get_pointer_type(p->ll_type);
+      new_op->flags = p->flags;
+      return ll_bc_md_value(encode_operand(new_op, 0));
+    }
+    interr("encode_operand(): null metadata operand", 0, ERR_Fatal);
+    break;
+  default:
+    assert(0, "encode_operand(): operand has no value", p->ot_type, 4);
+  }
+  return ll_bc_undef(ll_bc_void_type());
+}
+
+/**
+   \brief Encode the predicate of an \c OT_CC operand for the bitcode output
+ */
+unsigned
+encode_cc_operand(OPERAND *p)
+{
+  LL_Type *ty = p->ll_type;
+
+  assert(p->val.cc, "encode_cc_operand(): expecting condition code", 0, 4);
+  assert(ty, "encode_cc_operand(): missing type", 0, 4);
+  if (ty->data_type == LL_VECTOR)
+    ty = ty->sub_types[0];
+  if (ll_type_is_fp(ty))
+    return ll_bc_predicate(llvm_ccfp_names[p->val.cc], true);
+  return ll_bc_predicate(llvm_cc_names[p->val.cc], false);
+}
+
 static int metadata_id = 0;
 
 /**
@@ -2772,11 +3117,8 @@ static char *
 def_name(DTYPE dtype, int tag)
 {
   char *tag_name;
-  char *d_name;
   char buf[200];
-  char idbuf[MAXIDLEN];
   static int count = 0;
-  int tag_len = 0;
 
   if (tag) {
     tag_name = getprint(tag);
@@ -2789,17 +3131,9 @@ def_name(DTYPE dtype, int tag)
       tag_name = buf;
     }
   }
-  if (tag) {
-    sprintf(idbuf, "%d_%d", dtype, tag);
-    tag_len = strlen(idbuf) + 1;
-  }
-  tag_len += strlen(tag_name) + 10;
-  d_name = (char *)llutil_alloc(tag_len * sizeof(char));
   if (tag)
-    sprintf(d_name, "%%struct.%s.%s", tag_name, idbuf);
-  else
-    sprintf(d_name, "%%struct.%s", tag_name);
-  return d_name;
+    return ll_intern_namef("%%struct.%s.%d_%d", tag_name, dtype, tag);
+  return ll_intern_namef("%%struct.%s", tag_name);
 }
 
 OPERAND *
@@ -2945,15 +3279,13 @@ process_ftn_dtype_struct(DTYPE dtype, char *tname, LOGICAL printed)
 
   DBGTRACEIN1(" called with dtype %d\n", dtype)
 
-  d_name = (char *)llutil_alloc(strlen(tname) + 10);
-  sprintf(d_name, "%s%s", "%", tname);
-
   /* if already computed, just return */
   if (def != NULL) {
     DBGTRACEOUT1(" returns %s", def->name)
     return def->name;
   }
 
+  d_name = ll_intern_namef("%%%s", tname);
   if (ZSIZEOF(dtype) == 0)
     def = make_def(dtype, 0, 0, d_name,
                    LLDEF_IS_TYPE | LLDEF_IS_EMPTY | LLDEF_IS_STRUCT);
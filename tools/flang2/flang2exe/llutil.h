@@ -19,10 +19,15 @@
 #define LLUTIL_H__ 1
 
 #include "ll_structure.h"
+#include "ll_bitcode.h"
 
 /** \brief need a getitem() area that can persist across routine compilation */
 #define LLVM_LONGTERM_AREA 25
 
+/** \brief getitem() area for the instructions, operands and temporaries of
+    one routine; freed when the routine has been written out */
+#define LLVM_ROUTINE_AREA 26
+
 /** \brief OPERAND flag values */
 typedef enum OperandFlag_t {
   OPF_WRAPPED_MD = (1 << 0),
@@ -144,11 +149,13 @@ typedef struct GBL_TAG {
 
 /** \brief Extern function list node */
 typedef struct EXFUNC_TAG {
-  int sptr;           /**< sptr of the variable */
-  int ha_sptr;        /**< sptr of hidden structure argument, if present */
-  char *func_def;     /**< external function definition */
-  unsigned int flags; /**< details about the external function */
-  int use_dtype;      /**< the dtype to use when generating prototypes */
+  int sptr;              /**< sptr of the variable */
+  int ha_sptr;           /**< sptr of hidden structure argument, if present */
+  char *func_def;        /**< external function definition */
+  const char *func_name; /**< name of an intrinsic */
+  LL_Type *func_type;    /**< function type of an intrinsic */
+  unsigned int flags;    /**< details about the external function */
+  int use_dtype;         /**< the dtype to use when generating prototypes */
   struct EXFUNC_TAG *next;
 } EXFUNC_LIST;
 
@@ -279,6 +286,7 @@ typedef enum LL_InstrListFlags {
   ARM_AAPCS_VFP           = (1 << 9),
   CANCEL_CALL_DBG_VALUE   = (1 << 10),
   NOSIGNEDWRAP            = (1 << 11),
+  NONTEMPORAL_FLAG        = (1 << 11), /**< I_STORE only */
   NOUNSIGNEDWRAP          = (1 << 12),
   FUNC_RETURN_IS_FUNC_PTR = (1 << 13),
   
@@ -358,6 +366,8 @@ typedef struct INSTR_TAG {
   LL_Type *ll_type;     /**< type of intermediate results */
   OPERAND *operands;    /**< list of instruction operands */
   LL_MDRef dbg_line_op; /**< line info for debug */
+  LL_MDRef loop_md;     /**< !llvm.loop of a latch branch; the parallel loop
+                             or access group of a load or store */
   const char *traceComment;
   struct INSTR_TAG *prev;
   struct INSTR_TAG *next;
@@ -498,9 +508,16 @@ void print_instr(char *, char *, char *);
 void print_line(char *);
 void print_token(const char *);
 void print_nl(void);
+/* Return the shared, permanent copy of a symbol name such as @llvm.x.y */
+char *ll_intern_name(const char *);
+char *ll_intern_namef(const char *, ...);
 void write_constant_value(int sptr, LL_Type *, INT, INT, LOGICAL);
 void write_operand(OPERAND *, const char *, int);
 void write_operands(OPERAND *, int flags);
+/* Bitcode counterparts of write_constant_value() and write_operand() */
+BCVal encode_constant_value(int sptr, LL_Type *, INT, INT, LOGICAL);
+BCVal encode_operand(OPERAND *, int flags);
+unsigned encode_cc_operand(OPERAND *);
 void print_metadata_name(TMPS *);
 void set_metadata_string(TMPS *, char *string);
 void init_metadata_index(TMPS *t);
@@ -528,6 +545,7 @@ int need_ptr(int, int, int);
 void dump_type_for_debug(LL_Type *);
 char *get_label_name(int);
 void print_tmp_name(TMPS *);
+int tmp_number(TMPS *);
 char *dtype_struct_name(int);
 void append_llvm_used(OPERAND *op);
 LOGICAL is_function(int sptr);
@@ -39,6 +39,7 @@
 #include "outliner.h"
 #if !defined(TARGET_WIN)
 #include <unistd.h>
+#include <sys/wait.h>
 #endif
 #include <time.h>
 #include "ilm.h"
@@ -49,6 +50,9 @@
 #include "dwarf2.h"
 #include "direct.h"
 #include "expand.h"
+#include "ll_structure.h"
+#include "ll_write.h"
+#include "ll_bitcode.h"
 #include "scope.h"
 #include <stdbool.h>
 #include "flang/ArgParser/arg_parser.h"
@@ -86,6 +90,9 @@ static int savevectflag;
 static int savex8flag;
 static int saverecursive;
 static char *objectfile;
+static void fork_workers(void);
+static LOGICAL merge_workers(void);
+static void end_worker(void);
 static void process_stb_file(void);
 #define STB_UPPER() (gbl.stbfil != NULL)
 #define IS_PARFILE (gbl.ilmfil == par_file1 || gbl.ilmfil == par_file2)
@@ -95,8 +102,8 @@ static action_map_t *phase_dump_map;
 /*
  * for reporting time
  */
-static char *who[] = {"init", "import",   "expand", "", "",
-                      "",     "assemble", "xref",   ""};
+static char *who[] = {"init",     "import",   "expand", "",      "",
+                      "schedule", "assemble", "xref",   "finish"};
 #define _N_WHO (sizeof(who) / sizeof(char *))
 static INT xtimes[_N_WHO];
 static char *cmdline = NULL;
@@ -122,6 +129,35 @@ static int dodebug = 0;
 
 static int ipa_import_mode = 0;
 
+/*
+ * Parallel code generation.  With -x 217 n, n > 1, flang2 forks n worker
+ * processes once the command line is read.  Every worker reads the whole
+ * ILM file and runs upper() for each program unit, so its symbol table
+ * stays as it is in a serial compilation, but it expands, schedules and
+ * assembles only the routine groups it owns.
+ * A group is a program unit together with its internal procedures and
+ * outlined parallel regions; group g belongs to worker g % n.  A worker
+ * writes its LLVM IR to a temporary file, starting the text of each group
+ * with a ";@par g" line, and the parent combines the files into a single
+ * module with ll_merge_modules().  When a worker fails or its output
+ * cannot be merged, the parent compiles the file serially.
+ *
+ * The outlined routines are counted only by the worker that generates
+ * them, so the routine counters of worker w step by n from w; the names
+ * made from them (.BSS<n>, .STATICS<n>, labels) are then its own.
+ */
+#define MAX_WORKERS 64
+static int par_nworkers;    /* number of workers, 0 if serial */
+static int par_worker = -1; /* this worker, -1 in the parent */
+static int par_group;       /* group of the current routine */
+static LOGICAL par_skip;    /* another worker generates this routine */
+static LOGICAL par_merged;  /* the parent wrote the merged module */
+static FILE *par_out[MAX_WORKERS]; /* LLVM IR of each worker */
+static FILE *par_err[MAX_WORKERS]; /* messages of each worker */
+static int par_pid[MAX_WORKERS];
+#define FIRST_COUNT (par_worker >= 0 ? par_worker : 0)
+#define NEXT_COUNT(c) ((c) += par_worker >= 0 ? par_nworkers : 1)
+
 /* I860, I386, SPARC */
 #define OUTPUT_IS_OBJECT FALSE
 
@@ -244,18 +280,27 @@ llvm_restart:
   if (flg.smp && IS_PARFILE) {
     ll_set_outlined_currsub();
   }
-  gbl.func_count++;
+  NEXT_COUNT(gbl.func_count);
 
   if (gbl.multiversion <= 1) {
     TR("F90 ILM INPUT begins\n")
     if (!IS_PARFILE)
     {
+      /* every worker reads every routine; the first one reports */
+      if (par_worker >= 0)
+        erremit(par_worker == 0);
       upper(0);
       if (gbl.eof_flag)
         return FALSE;
       upper_assign_addresses();
     }
   }
+  if (par_worker >= 0 && !IS_PARFILE) {
+    if (gbl.internal <= 1)
+      fprintf(gbl.asmfil, ";@par %d\n", ++par_group);
+    par_skip = par_group % par_nworkers != par_worker;
+    erremit(!par_skip);
+  }
 
   is_constructor = gbl.cuda_constructor;
   xtimes[1] += getcpu();
@@ -272,9 +317,9 @@ llvm_restart:
 
   if (gbl.maxsev < 3 && (flg.object || flg.code) && !DBGBIT(2, 4)) {
 
-    gbl.multi_func_count++;
+    NEXT_COUNT(gbl.multi_func_count);
     gbl.nofperror = TRUE;
-    if (gbl.rutype == RU_BDATA) {
+    if (gbl.rutype == RU_BDATA || par_skip) {
     } else {
       if (gbl.cuda_constructor) {
       } else {
@@ -315,6 +360,7 @@ llvm_restart:
         TR("F90 EXPANDER begins\n");
 
         expand(); /* expand ILM's into ILI  */
+        xtimes[2] += getcpu();
         DUMP("expand");
 #if DEBUG
         check_lineno("expand");
@@ -347,9 +393,11 @@ llvm_restart:
         DUMP("schedule");
       } /* CUDAG(GBL_CURRFUNC) & CUDA_HOST */
     }
-    TR("F90 ASSEMBLER begins\n");
-    assemble();
-    xtimes[6] += getcpu();
+    if (!par_skip) {
+      TR("F90 ASSEMBLER begins\n");
+      assemble();
+      xtimes[6] += getcpu();
+    }
     upper_save_syminfo();
   }
   if (DBGBIT(5, 4))
@@ -376,7 +424,8 @@ llvm_restart:
     xref(); /* write cross reference map */
     xtimes[7] += getcpu();
   }
-  (void)summary(FALSE, 0);
+  if (!par_skip)
+    (void)summary(FALSE, 0);
   cg_llvm_fnend();
   if (ll_has_outlined_parfile()) {
     if (ll_reset_parfile())
@@ -397,6 +446,8 @@ main(int argc, char *argv[])
 
   getcpu();
   init(argc, argv);
+  if (par_nworkers && par_worker < 0 && merge_workers())
+    finish();
 
   saveoptflag = flg.opt;
   savevectflag = flg.vect;
@@ -431,11 +482,15 @@ main(int argc, char *argv[])
 
   } while (!gbl.eof_flag);
 
+  if (par_worker >= 0)
+    fprintf(gbl.asmfil, ";@par end\n");
   cg_llvm_end();
 
   if (flg.smp) {
     ll_unlink_parfiles();
   }
+  if (par_worker >= 0)
+    end_worker(); /* does not return */
 
   finish(); /* finish does not return */
   return 0; /* never reached */
@@ -450,6 +505,7 @@ reptime()
   int prct;
   int tmp;
 
+  xtimes[8] += getcpu();
   total = 0;
   for (i = 0; i < _N_WHO; i++)
     total += xtimes[i];
@@ -480,6 +536,8 @@ reptime()
     list_line(buf);
   } else if (gbl.dbgfil)
     fprintf(gbl.dbgfil, "%s\n", buf);
+  if (gbl.dbgfil)
+    area_report(gbl.dbgfil);
 
 xbitcheck:
   if (!XBIT(0, 1))
@@ -497,6 +555,7 @@ xbitcheck:
   }
   sprintf(buf, "    Total time %15d millisecs", total);
   fprintf(stderr, "%s\n", buf);
+  area_report(stderr);
 }
 
 /** \brief Dump symbols
@@ -756,6 +815,9 @@ init(int argc, char *argv[])
     fprintf(stderr, "%s-I-Beta Release Optimizations Activated\n", version.lang);
   }
 
+  if (sourcefile != NULL)
+    fork_workers();
+
 empty_cl:
   if (sourcefile == NULL) {
     gbl.src_file = sourcefile = "STDIN.f";
@@ -824,7 +886,9 @@ do_curr_file:
     list_init(fd);
   }
   /* process assembly output file */
-  if (flg.asmcode) {
+  if (par_worker >= 0) {
+    gbl.asmfil = par_out[par_worker];
+  } else if (flg.asmcode) {
     if (asmfile == NULL) {
       /* make assembly filename from sourcefile name */
       asmfile = mkfname(sourcefile, file_suffix, ASMFILE);
@@ -834,6 +898,15 @@ do_curr_file:
   } else /* do this for compilers which write asm code to stdout */
     gbl.asmfil = stdout;
 
+  /* for bitcode output, the module is built in memory and written by
+   * finish() */
+  if (XBIT(216, 0x2) && get_llvm_version() < LL_Version_4_0) {
+    interr("bitcode output requires LLVM 4.0 or later", get_llvm_version(),
+           ERR_Warning);
+    flg.x[216] &= ~0x2;
+  }
+  ll_set_output_buffer(gbl.asmfil);
+
   if (stboutfile) {
     if ((gbl.stbfil = fopen(stboutfile, "r")) == NULL)
       error(2, 4, 0, stboutfile, "");
@@ -846,8 +919,8 @@ do_curr_file:
 #endif
   assemble_init(argc, argv, cmdline);
 
-  gbl.func_count = 0;
-  gbl.multi_func_count = 0;
+  gbl.func_count = FIRST_COUNT;
+  gbl.multi_func_count = FIRST_COUNT;
   direct_init();
 
   if (XBIT(125, 0x8))
@@ -933,8 +1006,14 @@ finish()
   } else {
     if (gbl.objfil != NULL)
       fclose(gbl.objfil);
-    if (!flg.es)
+    if (!flg.es && !par_merged)
       assemble_end();
+    if (ll_bitcode_output() && !flg.es) {
+      fflush(gbl.asmfil);
+      if (ftell(gbl.asmfil) > 0)
+        interr("LLVM assembly written in bitcode mode", 0, ERR_Fatal);
+      ll_write_bitcode(gbl.asmfil, cpu_llvm_module);
+    }
   }
   if (gbl.asmfil != NULL && gbl.asmfil != stdout)
     fclose(gbl.asmfil);
@@ -965,6 +1044,102 @@ finish()
     exit(0);
 }
 
+/** \brief Start the code generation workers, see par_nworkers.
+ *
+ * Called by init() before the input and output files are opened; returns
+ * in the parent and in each worker.
+ */
+static void
+fork_workers(void)
+{
+#if !defined(TARGET_WIN)
+  int n, i;
+
+  n = flg.x[217];
+  if (n > MAX_WORKERS)
+    n = MAX_WORKERS;
+  /* debug information, bitcode, listings and dumps are written serially */
+  if (n <= 1 || flg.debug || XBIT(120, 0x1000) || XBIT(216, 0x2) ||
+      flg.list || flg.xref || flg.code || gbl.dbgfil != NULL || ccff_filename)
+    return;
+  for (i = 0; i < n; i++) {
+    if ((par_out[i] = tmpf("b")) == NULL || (par_err[i] = tmpf("b")) == NULL)
+      break;
+  }
+  if (i < n) {
+    /* compile serially; closing a tmpf file also removes it */
+    for (; i >= 0; i--) {
+      if (par_out[i] != NULL)
+        fclose(par_out[i]);
+      if (par_err[i] != NULL)
+        fclose(par_err[i]);
+      par_out[i] = par_err[i] = NULL;
+    }
+    return;
+  }
+  fflush(NULL);
+  par_nworkers = n;
+  for (i = 0; i < n; i++) {
+    par_pid[i] = fork();
+    if (par_pid[i] == 0) {
+      par_worker = i;
+      dup2(fileno(par_err[i]), 2);
+      return;
+    }
+  }
+#endif
+}
+
+/** \brief Wait for the workers and write the merged module.
+ *
+ * Returns FALSE, without having written anything, if the file has to be
+ * compiled serially.
+ */
+static LOGICAL
+merge_workers(void)
+{
+#if !defined(TARGET_WIN)
+  int i, c, status;
+  LOGICAL ok = TRUE;
+
+  for (i = 0; i < par_nworkers; i++) {
+    if (par_pid[i] < 0 || waitpid(par_pid[i], &status, 0) != par_pid[i] ||
+        !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+      ok = FALSE;
+  }
+  if (ok)
+    ok = ll_merge_modules(gbl.asmfil, par_out, par_nworkers);
+  for (i = 0; i < par_nworkers; i++) {
+    if (ok) {
+      rewind(par_err[i]);
+      while ((c = getc(par_err[i])) != EOF)
+        putc(c, stderr);
+    }
+    fclose(par_out[i]);
+    fclose(par_err[i]);
+  }
+  par_merged = ok;
+  return ok;
+#else
+  return FALSE;
+#endif
+}
+
+/** \brief Finish a worker: write the end of its module and exit.
+ *
+ * A worker that saw severe errors makes the parent compile serially, which
+ * reports them.
+ */
+static void
+end_worker(void)
+{
+  int sev = error_max_severity();
+
+  if (sev < 3)
+    assemble_end();
+  exit(sev >= 3);
+}
+
 static void
 process_stb_file()
 {
@@ -1005,7 +1180,7 @@ process_stb_file()
   }
 
   gbl.eof_flag = FALSE;
-  gbl.func_count = 0;
+  gbl.func_count = FIRST_COUNT;
 
   if (gbl.stbfil != NULL)
     fclose(gbl.stbfil);
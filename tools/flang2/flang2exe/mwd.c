@@ -5218,7 +5218,6 @@ _dumpnme(int n, LOGICAL dumpdefsuses)
   putnzint("cnst", NME_CNST(n));
   putnzint("cnt", NME_CNT(n));
   if (full & 1)
-    putnzint("hashlink", NME_HSHLNK(n));
   putnzint("inlarr", NME_INLARR(n));
   putnzint("rat/rfptr", NME_RAT(n));
   putnzint("stl", NME_STL(n));
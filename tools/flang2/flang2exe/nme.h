@@ -27,7 +27,6 @@ typedef struct {
   char pd1;
   char pd2;
   int stl;       /* STL item pointer: rsvd for invariant */
-  int hshlnk;    /* link of names w/ identical hash val */
   int nm;        /* Dependent on type. */
   int sym;       /* Dependent on type. */
   int rfptr;     /* Dependent on type. */
@@ -69,7 +68,6 @@ typedef struct {
   int type;   /* pointer target type */
   int sym;    /* type-specific value */
   int val;    /* type-specific value */
-  int hshlnk; /* link of PTE with name hash val */
 } PTE;
 
 /* RPCT (runtime pointer conflict test) struct:
@@ -83,7 +81,6 @@ typedef struct {
 typedef struct {
   int nme1;
   int nme2;
-  int hshlnk;
 } RPCT;
 
 typedef struct {
@@ -107,7 +104,6 @@ typedef struct {
 #define NME_INLARR(i) nmeb.stg_base[NMECHECK(i)].inlarr
 #define NME_SYM(i) nmeb.stg_base[NMECHECK(i)].sym
 #define NME_NM(i) nmeb.stg_base[NMECHECK(i)].nm
-#define NME_HSHLNK(i) nmeb.stg_base[NMECHECK(i)].hshlnk
 #define NME_RFPTR(i) nmeb.stg_base[NMECHECK(i)].rfptr
 #define NME_ELOOP(i) nmeb.stg_base[NMECHECK(i)].exp_loop
 #define NME_RAT(i) nmeb.stg_base[NMECHECK(i)].rfptr
@@ -184,7 +180,6 @@ typedef enum NT_KIND {
 #define PTE_TYPE(i) nmeb.pte.stg_base[PTECHECK(i)].type
 #define PTE_SPTR(i) nmeb.pte.stg_base[PTECHECK(i)].sym
 #define PTE_VAL(i) nmeb.pte.stg_base[PTECHECK(i)].val
-#define PTE_HSHLNK(i) nmeb.pte.stg_base[PTECHECK(i)].hshlnk
 
 #if DEBUG
 #define RPCT_CHECK(i)                        \
@@ -196,7 +191,6 @@ typedef enum NT_KIND {
 #endif
 #define RPCT_NME1(i) nmeb.rpct.stg_base[RPCT_CHECK(i)].nme1
 #define RPCT_NME2(i) nmeb.rpct.stg_base[RPCT_CHECK(i)].nme2
-#define RPCT_HSHLNK(i) nmeb.rpct.stg_base[RPCT_CHECK(i)].hshlnk
 
 /***** External Functions *****/
 
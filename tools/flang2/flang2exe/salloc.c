@@ -23,10 +23,29 @@
 #include "gbldefs.h"
 #include "global.h"
 #include "error.h"
+#include <string.h>
+#if !defined(TARGET_WIN)
+#include <sys/mman.h>
+#include <sys/resource.h>
+#endif
 
-#define SIZE                                             \
-  2000          /* size in bytes of each block of memory \
-                 * obtained from malloc (NEW). */
+/*
+ * Each area is a list of chunks obtained from malloc (or mmap), newest
+ * first.  Items are carved from the newest chunk; when it is full a new
+ * chunk as large as the whole area is added, from SIZE up to MAXSIZE
+ * bytes, so an area that holds a lot of data is made of a few large
+ * chunks.  An item larger than that gets a chunk of its own.
+ *
+ * area_mark() and area_release() give an area reset points: everything
+ * allocated after the mark is freed, so a phase can use a long-lived area
+ * for its temporaries.  freearea() releases all of an area.
+ *
+ * With -x 218 0x1, chunks of HUGESIZE bytes are mapped directly and
+ * marked for transparent huge pages, and the areas grow to that size.
+ */
+#define SIZE 2000             /* first chunk of an area */
+#define MAXSIZE (1024 * 1024) /* largest chunk, unless huge pages */
+#define HUGESIZE (2 * 1024 * 1024)
 #define ANUM 30 /* number of different areas supported, 0...ANUM-1 */
 
 typedef char *PTR;
@@ -35,10 +54,91 @@ typedef char *PTR;
 #define PTRSZ sizeof(PTR)
 #define ALIGN(o) (((o) + (PTRSZ - 1)) & (~(PTRSZ - 1)))
 
-static char *areap[ANUM] = {NULL, NULL, NULL, NULL, NULL, NULL, NULL,
-                            NULL, NULL, NULL, NULL, NULL, NULL, NULL,
-                            NULL, NULL, NULL, NULL, NULL, NULL, NULL};
-static int avail[ANUM];
+typedef struct CHUNK {
+  struct CHUNK *next;
+  size_t size;    /* in bytes, with this header */
+  LOGICAL mapped; /* from mmap, not malloc */
+} CHUNK;
+
+#define HDRSZ ALIGN(sizeof(CHUNK))
+
+static struct {
+  CHUNK *head;    /* newest chunk */
+  size_t avail;   /* offset of the free space in head */
+  size_t current; /* bytes held in chunks */
+  size_t peak;    /* largest value of current */
+  size_t used;    /* bytes handed out, ever */
+} areas[ANUM];
+
+static size_t all_current, all_peak;
+
+static CHUNK *
+alloc_chunk(size_t size)
+{
+  CHUNK *c;
+
+#if !defined(TARGET_WIN) && defined(MAP_ANONYMOUS)
+  if (XBIT(218, 0x1) && size >= HUGESIZE) {
+    void *p;
+    size = (size + HUGESIZE - 1) & ~(size_t)(HUGESIZE - 1);
+    p = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS,
+             -1, 0);
+    if (p != MAP_FAILED) {
+#ifdef MADV_HUGEPAGE
+      madvise(p, size, MADV_HUGEPAGE);
+#endif
+      c = (CHUNK *)p;
+      c->size = size;
+      c->mapped = TRUE;
+      return c;
+    }
+  }
+#endif
+  c = (CHUNK *)sccalloc((UINT)size);
+  if (c == NULL)
+    interr("getitem: no mem avail", (int)(size >> 10), 4);
+  c->size = size;
+  c->mapped = FALSE;
+  return c;
+}
+
+static void
+free_chunk(CHUNK *c)
+{
+#if !defined(TARGET_WIN) && defined(MAP_ANONYMOUS)
+  if (c->mapped) {
+    munmap(c, c->size);
+    return;
+  }
+#endif
+  FREE(c);
+}
+
+/* Add a chunk with room for size bytes to the area. */
+static void
+new_chunk(int area, size_t size)
+{
+  size_t maxsize = XBIT(218, 0x1) ? HUGESIZE : MAXSIZE;
+  size_t sz = areas[area].current;
+  CHUNK *c;
+
+  if (sz < SIZE)
+    sz = SIZE;
+  else if (sz > maxsize)
+    sz = maxsize;
+  if (HDRSZ + size > sz)
+    sz = HDRSZ + size;
+  c = alloc_chunk(sz);
+  c->next = areas[area].head;
+  areas[area].head = c;
+  areas[area].avail = HDRSZ;
+  areas[area].current += c->size;
+  if (areas[area].current > areas[area].peak)
+    areas[area].peak = areas[area].current;
+  all_current += c->size;
+  if (all_current > all_peak)
+    all_peak = all_current;
+}
 
 /**
    \param area is an area
@@ -52,29 +152,12 @@ getitem(int area, int size)
   assert(area >= 0 && area < ANUM, "getitem: bad area", area, 4);
   size = ALIGN(size); /* round up to multiple of PTRSZ */
 
-  if (areap[area] == NULL) {
-    int sz = SIZE;
-    if (size + PTRSZ > SIZE)
-      sz = size + PTRSZ;
-    NEW(p, char, sz);
-    areap[area] = p;
-    if (p == NULL)
-      interr("getitem: no mem avail", area, 4);
-    *((PTR *)p) = NULL;
-    avail[area] = PTRSZ;
-  } else if (avail[area] + size > SIZE) {
-    int sz = SIZE;
-    if (size + PTRSZ > SIZE)
-      sz = size + PTRSZ;
-    NEW(p, char, sz);
-    if (p == NULL)
-      interr("getitem: no mem avail", area, 4);
-    *((PTR *)p) = areap[area];
-    areap[area] = p;
-    avail[area] = PTRSZ;
-  }
-  p = areap[area] + avail[area];
-  avail[area] += size;
+  if (areas[area].head == NULL ||
+      areas[area].avail + size > areas[area].head->size)
+    new_chunk(area, size);
+  p = (char *)areas[area].head + areas[area].avail;
+  areas[area].avail += size;
+  areas[area].used += size;
 #if DEBUG
   if (DBGBIT(0, 0x20000)) {
     char *q, cc;
@@ -90,17 +173,78 @@ getitem(int area, int size)
   return p;
 }
 
+/**
+   \brief Return a reset point for an area; see area_release().
+ */
+AREA_MARK
+area_mark(int area)
+{
+  AREA_MARK mark;
+
+  assert(area >= 0 && area < ANUM, "area_mark: bad area", area, 4);
+  mark.chunk = areas[area].head;
+  mark.avail = areas[area].avail;
+  return mark;
+}
+
+/**
+   \brief Free everything allocated in an area since area_mark() returned
+   mark.
+ */
+void
+area_release(int area, AREA_MARK mark)
+{
+  CHUNK *c;
+
+  assert(area >= 0 && area < ANUM, "area_release: bad area", area, 4);
+  while ((c = areas[area].head) != NULL && c != mark.chunk) {
+    areas[area].head = c->next; /* get next before free!!! */
+    areas[area].current -= c->size;
+    all_current -= c->size;
+#if DEBUG
+    if (DBGBIT(0, 0x20000))
+      memset((char *)c + HDRSZ, 0xa6, c->size - HDRSZ);
+#endif
+    free_chunk(c);
+  }
+  assert(c == mark.chunk, "area_release: bad mark", area, 4);
+  areas[area].avail = c ? mark.avail : 0;
+}
+
 void
 freearea(int area)
 {
-  char *p, *q;
+  AREA_MARK empty = {NULL, 0};
+
+  area_release(area, empty);
+}
 
-  assert(area >= 0 && area < ANUM, "freearea: bad area", area, 4);
-  for (p = areap[area]; p != NULL; p = q) {
-    q = *((PTR *)p); /* get next before free!!! */
-    FREE(p);
+/**
+   \brief Write the current and peak sizes of the areas to out, for the
+   -time report.
+ */
+void
+area_report(FILE *out)
+{
+  int area;
+#if !defined(TARGET_WIN)
+  struct rusage ru;
+#endif
+
+  fprintf(out, "  Memory stats:\n");
+  for (area = 0; area < ANUM; ++area) {
+    if (areas[area].peak)
+      fprintf(out, "    area %-5d %12lu KB peak %12lu KB now %12lu KB used\n",
+              area, (unsigned long)(areas[area].peak >> 10),
+              (unsigned long)(areas[area].current >> 10),
+              (unsigned long)(areas[area].used >> 10));
   }
-  areap[area] = NULL;
+  fprintf(out, "    All areas  %12lu KB peak %12lu KB now\n",
+          (unsigned long)(all_peak >> 10), (unsigned long)(all_current >> 10));
+#if !defined(TARGET_WIN)
+  if (getrusage(RUSAGE_SELF, &ru) == 0)
+    fprintf(out, "    Peak RSS   %12ld KB\n", (long)ru.ru_maxrss);
+#endif
 }
 
 #if DEBUG
@@ -109,18 +253,13 @@ reportarea(int full)
 {
   int area;
   for (area = 0; area < ANUM; ++area) {
-    if (areap[area] == NULL) {
+    if (areas[area].head == NULL) {
       if (full)
         fprintf(gbl.dbgfil, "area[%2d] is empty\n", area);
     } else {
-      char *p, *q;
-      int total = 0;
-      for (p = areap[area]; p != NULL; p = q) {
-        q = *((PTR *)p); /* get next before free!!! */
-        total += SIZE;
-      }
-      fprintf(gbl.dbgfil, "area[%2d] >= %d bytes with %d free\n", area, total,
-              avail[area]);
+      fprintf(gbl.dbgfil, "area[%2d] >= %lu bytes with %lu free\n", area,
+              (unsigned long)areas[area].current,
+              (unsigned long)(areas[area].head->size - areas[area].avail));
     }
   }
 }
@@ -1913,9 +1913,9 @@ read_symbol(void)
       returnval, routx = 0, save, sdscs1, sdsccontig, contigattr, sdscsafe, seq,
                  shared, startlab, startline, stdcall, decorate, cref,
                  nomixedstrlen, sym, target, param, thread, task, tqaln, typed,
-                 uplevel, vararg, Volatile, fromMod, modcmn, parent, internref,
-                 class, denorm, Scope, vtable, iface, vtoff, tbplnk, invobj,
-                 invobjinc, reref, libm, libc, tls, etls;
+                 uplevel, vararg, Volatile, async, fromMod, modcmn, parent,
+                 internref, class, denorm, Scope, vtable, iface, vtoff, tbplnk,
+                 invobj, invobjinc, reref, libm, libc, tls, etls;
   int reflected, mirrored, create, copyin, resident, acclink, devicecopy,
       devicesd, devcopy;
   int unlpoly, allocattr, f90pointer, final, finalized, kindparm;
@@ -1992,6 +1992,7 @@ read_symbol(void)
     tls = getbit("tls");
     task = getbit("task");
     Volatile = getbit("volatile");
+    async = getbit("asynchronous");
     address = getval("address");
     clen = getval("clen");
     common = getval("common");
@@ -2118,6 +2119,7 @@ read_symbol(void)
     TASKP(newsptr, task);
 #endif
     VOLP(newsptr, Volatile);
+    ASYNCP(newsptr, async);
     ASSNP(newsptr, assigned);
 #ifdef PDALNP
     if (pdaln > 0)